@@ -30,6 +30,13 @@ android {
         versionName = flutter.versionName
     }
 
+    // Native crypto library (libargon2.so), loaded from Dart via DynamicLibrary.open.
+    externalNativeBuild {
+        cmake {
+            path = file("../../native_libs/CMakeLists.txt")
+        }
+    }
+
     buildTypes {
         release {
             // TODO: Add your own signing config for the release build.
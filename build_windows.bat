@@ -24,6 +24,7 @@ if %errorlevel% neq 0 (
 echo.
 echo ✅ Build successful!
 echo 📁 Library: build/Release/steganography.dll
-echo 📁 Copy this file to your Flutter project root
+echo 📁 Library: build/native_libs/Release/argon2.dll
+echo 📁 Copy these files to your Flutter project root
 
 pause
\ No newline at end of file
@@ -2,6 +2,8 @@
 import 'package:flutter/foundation.dart';
 import 'package:flutter/material.dart';
 import 'package:supabase_flutter/supabase_flutter.dart';
+import '../services/chat_page_cache_ffi.dart';
+import '../services/chat_warm_sync.dart';
 import '../services/crypto_auth_ffi.dart';
 import '../services/supabase_service.dart';
 import '../services/crypto_auth.dart';
@@ -39,6 +41,10 @@ class AuthProvider with ChangeNotifier {
   String? get userId => _user?.id;
   bool get useArgon2 => _useArgon2;
 
+  // Auth data yang diambil saat spekulasi login, dipakai ulang oleh login()
+  final Map<String, Future<Map<String, dynamic>?>> _authDataRequests = {};
+  int _speculationToken = 0;
+
   Future<void> initialize() async {
     if (_isInitialized) return;
 
@@ -278,6 +284,43 @@ class AuthProvider with ChangeNotifier {
     }
   }
 
+  /// Dipanggil LoginScreen saat field password kehilangan fokus / setelah debounce:
+  /// ambil salt akun lalu mulai Argon2id native di background, sehingga login() dengan
+  /// password yang sama tidak menunggu KDF.
+  Future<void> speculateLogin(String email, String password) async {
+    if (!_useArgon2) return;
+    final crypto = _cryptoService;
+    if (crypto is! CryptoAuthFFI || !crypto.supportsSpeculation) return;
+    if (email.isEmpty || password.isEmpty || !SupabaseConfig.isAvailable) return;
+
+    final token = ++_speculationToken;
+    final request = _authDataRequests[email] ??= SupabaseService().getUserAuthData(email);
+    final authData = await request;
+    if (authData == null) _authDataRequests.remove(email);
+    // Password sudah diubah/dibatalkan selama menunggu salt
+    if (token != _speculationToken) return;
+    final salt = authData?['salt']?.toString();
+    if (salt == null || authData?['password_hash'] == null) return;
+    crypto.speculate(password, storedSalt: salt);
+  }
+
+  /// Spekulasi untuk registrasi: salt baru dibuat sekarang dan dipakai register().
+  void speculateRegistration(String password) {
+    if (!_useArgon2) return;
+    final crypto = _cryptoService;
+    if (crypto is! CryptoAuthFFI || !crypto.supportsSpeculation) return;
+    if (!_validatePasswordStrength(password).isValid) return;
+    crypto.speculate(password);
+  }
+
+  /// Password berubah atau layar ditutup: hapus input dan hasil spekulasi.
+  void cancelSpeculation() {
+    _speculationToken++;
+    if (!_useArgon2) return;
+    final crypto = _cryptoService;
+    if (crypto is CryptoAuthFFI) crypto.cancelSpeculation();
+  }
+
   Future<Map<String, dynamic>> login(String email, String password) async {
     _setLoading(true);
     _error = null;
@@ -300,7 +343,7 @@ class AuthProvider with ChangeNotifier {
         throw Exception('Please verify your email first. Check your email for OTP code.');
       }
 
-      final userAuthData = await supabaseService.getUserAuthData(email);
+      final userAuthData = await (_authDataRequests.remove(email) ?? supabaseService.getUserAuthData(email));
       
       if (userAuthData == null) {
         throw Exception('User not found or invalid credentials');
@@ -499,6 +542,11 @@ class AuthProvider with ChangeNotifier {
         await supabaseService.signOut();
       }
 
+      // Plaintext hasil warm sync tidak boleh tersisa untuk akun berikutnya, begitu juga
+      // file halaman terenkripsinya
+      ChatPageCacheFFI().clear();
+      await ChatWarmSync.deletePageFiles();
+
       // Reset state
       _user = null;
       _userPin = null;
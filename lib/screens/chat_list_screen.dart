@@ -1,6 +1,8 @@
 import 'package:flutter/material.dart';
 import 'package:provider/provider.dart';
 import '../providers/auth_provider.dart';
+import '../services/chat_warm_sync.dart';
+import '../services/encryption_service.dart';
 import '../services/supabase_service.dart';
 import 'chat_screen.dart';
 
@@ -34,6 +36,7 @@ class _ChatListScreenState extends State<ChatListScreen> {
           _isLoading = false;
         });
       }
+      _warmChats(authProvider.userPin, chats);
     } catch (e) {
       if (mounted) {
         ScaffoldMessenger.of(context).showSnackBar(
@@ -46,6 +49,33 @@ class _ChatListScreenState extends State<ChatListScreen> {
     }
   }
 
+  // Halaman terbaru semua chat diambil paralel di latar belakang dan disimpan terdecrypt
+  // di cache native, supaya ChatScreen bisa langsung tampil saat dibuka. Halaman dari sesi
+  // sebelumnya (file terenkripsi) dimuat dulu sehingga tampil sebelum jaringan selesai.
+  Future<void> _warmChats(String? userPin, List<dynamic> chats) async {
+    if (userPin == null || chats.isEmpty || !_supabaseService.isAvailable) return;
+
+    final warmChats = <WarmChat>[];
+    for (final chat in chats) {
+      final chatId = chat['chat_id'] as String?;
+      final otherPin = chat['other_user_pin'] as String?;
+      if (chatId == null || otherPin == null) continue;
+      warmChats.add(WarmChat(chatId, EncryptionService.generateChatKey(userPin, otherPin)));
+    }
+
+    String? pageDirectory;
+    try {
+      pageDirectory = await ChatWarmSync.defaultPageDirectory();
+    } catch (e) {
+      pageDirectory = null;
+    }
+
+    final source = _supabaseService.chatPageSource();
+    final sync = ChatWarmSync(source, pageDirectory: pageDirectory);
+    await sync.restore(warmChats);
+    await sync.warm(warmChats).whenComplete(source.close);
+  }
+
   Future<void> _searchAndStartChat() async {
     final pin = _searchController.text.trim();
     if (pin.isEmpty) return;
@@ -10,8 +10,12 @@ import 'package:provider/provider.dart';
 import 'package:file_picker/file_picker.dart';
 import '../providers/auth_provider.dart';
 import '../services/supabase_service.dart';
+import '../services/chat_page_cache_ffi.dart';
 import '../services/encryption_service.dart';
 import '../services/file_encryption_service.dart';
+import '../services/lazy_decrypt_ffi.dart';
+import '../services/message_record_ffi.dart';
+import '../services/realtime_client_ffi.dart';
 import 'file_location_modal.dart';
 import 'file_decryption_modal.dart';
 import 'steganography_modal.dart';
@@ -35,7 +39,9 @@ class ChatScreen extends StatefulWidget {
 class _ChatScreenState extends State<ChatScreen> {
   final _messageController = TextEditingController();
   final _scrollController = ScrollController();
+  // Urut created_at; _messageIds mencerminkan id di _messages (lihat _setMessages)
   List<Map<String, dynamic>> _messages = [];
+  final Set<Object?> _messageIds = {};
   List<Map<String, dynamic>> _fileMessages = [];
   bool _isLoading = true;
   bool _isSending = false;
@@ -47,6 +53,12 @@ class _ChatScreenState extends State<ChatScreen> {
   String _errorMessage = '';
   StreamSubscription<List<Map<String, dynamic>>>? _messageSubscription;
   StreamSubscription<List<Map<String, dynamic>>>? _fileMessageSubscription;
+  // History didecrypt lazy per viewport jika library native tersedia
+  LazyMessageDecryptor? _lazyDecryptor;
+  NativeRealtimeClient? _nativeRealtime;
+  int? _visibleLazyFirst;
+  int? _visibleLazyLast;
+  bool _viewportReportScheduled = false;
 
   @override
   void initState() {
@@ -72,6 +84,7 @@ class _ChatScreenState extends State<ChatScreen> {
   Future<void> _initializeChat() async {
     try {
       _generateEncryptionKey();
+      _showCachedPage();
       await _loadMessages();
       await _loadFileMessages();
       _setupRealtimeSubscription();
@@ -113,6 +126,22 @@ class _ChatScreenState extends State<ChatScreen> {
     }
   }
 
+  // Halaman dari warm sync ChatListScreen tampil langsung; _loadMessages lalu mengganti
+  // dengan daftar lengkap dari server
+  void _showCachedPage() {
+    final cached = ChatPageCacheFFI().page(widget.chatId);
+    if (cached == null || cached.isEmpty || !mounted) return;
+
+    setState(() {
+      _setMessages(cached);
+      _isLoading = false;
+    });
+
+    if (kDebugMode) {
+      debugPrint('⚡ Showing ${cached.length} cached messages while loading');
+    }
+  }
+
   Future<void> _loadMessages() async {
     try {
       if (kDebugMode) {
@@ -123,42 +152,64 @@ class _ChatScreenState extends State<ChatScreen> {
       final encryptedMessages =
           await supabaseService.getEncryptedMessages(widget.chatId);
 
+      _lazyDecryptor?.dispose();
+      _lazyDecryptor = null;
+      // Baris server dikonversi sekali ke record biner; native memilih xor_with_iv atau
+      // AEAD per record dari header-nya
+      final records = encryptedMessages.isEmpty ? null : MessageRecordBuffer.fromRows(encryptedMessages);
+      if (records != null) {
+        try {
+          if (_registerLazyRecords(records, encryptedMessages.length)) return;
+        } finally {
+          records.dispose();
+        }
+      }
+
       if (kDebugMode) {
         debugPrint('🔓 Decrypting ${encryptedMessages.length} messages...');
       }
 
+      // Satu call batch per algoritma (native SIMD jika tersedia) untuk seluruh history
+      final encryptionService = EncryptionService();
+      final plaintexts = await encryptionService.decryptStoredMessagesBatch(
+        [
+          for (final msg in encryptedMessages)
+            {
+              'encrypted_message': msg['encrypted_message'] as String? ?? '',
+              'iv': msg['iv'] as String? ?? '',
+              if (msg['algorithm'] != null) 'algorithm': msg['algorithm'] as String,
+            }
+        ],
+        _encryptionKey,
+      );
+
       final List<Map<String, dynamic>> decryptedMessages = [];
       int successCount = 0;
       int failCount = 0;
 
-      final encryptionService = EncryptionService();
-
-      for (final msg in encryptedMessages) {
-        try {
-          final decryptedContent = await encryptionService.decryptMessage(
-            msg['encrypted_message'] as String,
-            msg['iv'] as String,
-            _encryptionKey,
-          );
-
-          decryptedMessages.add({
-            'id': msg['id'],
-            'sender_id': msg['sender_id'],
-            'message': decryptedContent,
-            'created_at': msg['created_at'],
-          });
-          successCount++;
-        } catch (e) {
+      for (int i = 0; i < encryptedMessages.length; i++) {
+        final msg = encryptedMessages[i];
+        final decryptedContent = plaintexts[i];
+        if (decryptedContent == null) {
           if (kDebugMode) {
-            debugPrint('⚠️ Failed to decrypt message ${msg['id']}: $e');
+            debugPrint('⚠️ Failed to decrypt message ${msg['id']}');
           }
           failCount++;
+          continue;
         }
+
+        decryptedMessages.add({
+          'id': msg['id'],
+          'sender_id': msg['sender_id'],
+          'message': decryptedContent,
+          'created_at': msg['created_at'],
+        });
+        successCount++;
       }
 
       if (mounted) {
         setState(() {
-          _messages = decryptedMessages;
+          _setMessages(decryptedMessages);
         });
       }
 
@@ -173,6 +224,96 @@ class _ChatScreenState extends State<ChatScreen> {
     }
   }
 
+  // Semua record didaftarkan ke native tanpa didecrypt; list langsung tampil dan isi
+  // pesan diambil saat row di-build (lihat _resolveLazyMessage). Return false jika lazy
+  // decrypt tidak tersedia, caller lalu decrypt seluruh history sekaligus.
+  bool _registerLazyRecords(MessageRecordBuffer records, int rowCount) {
+    final chatKey = base64.decode(_encryptionKey);
+    final aeadKey = EncryptionService().messageAeadKey(_encryptionKey);
+    final decryptor = LazyMessageDecryptor.create(chatKey, aeadKey: aeadKey, onReady: _onLazyRowsReady);
+    chatKey.fillRange(0, chatKey.length, 0);
+    aeadKey.fillRange(0, aeadKey.length, 0);
+    if (decryptor == null) return false;
+
+    final int first;
+    try {
+      first = decryptor.registerRecords(records);
+    } catch (e) {
+      if (kDebugMode) {
+        debugPrint('⚠️ Failed to register messages for lazy decryption: $e');
+      }
+      decryptor.dispose();
+      return false;
+    }
+    _lazyDecryptor = decryptor;
+
+    final entries = records.entries();
+    final List<Map<String, dynamic>> lazyMessages = [
+      for (int i = 0; i < entries.length; i++)
+        {
+          'id': entries[i].id,
+          'sender_id': entries[i].senderId,
+          'message': null,
+          'lazy_index': first + i,
+          'created_at': entries[i].createdAt,
+        }
+    ];
+
+    if (mounted) {
+      setState(() {
+        _setMessages(lazyMessages);
+      });
+    }
+
+    if (kDebugMode) {
+      debugPrint('✅ Registered ${lazyMessages.length} messages for lazy decryption '
+          '(failed: ${rowCount - records.count})');
+    }
+    return true;
+  }
+
+  // Row yang belum siap tidak ditunggu di itemBuilder: bubble memakai placeholder dan
+  // di-build ulang lewat _onLazyRowsReady saat worker native mengantarnya lewat ring.
+  // Plaintext hanya ada di salinan untuk build ini; _messages tidak pernah menyimpannya,
+  // jadi cache native (budget dan wipe saat evict) tetap satu-satunya tempat plaintext.
+  Map<String, dynamic> _resolveLazyMessage(Map<String, dynamic> message) {
+    final index = message['lazy_index'] as int?;
+    final decryptor = _lazyDecryptor;
+    if (index == null || message['message'] != null || decryptor == null) return message;
+
+    _visibleLazyFirst = _visibleLazyFirst == null || index < _visibleLazyFirst! ? index : _visibleLazyFirst;
+    _visibleLazyLast = _visibleLazyLast == null || index > _visibleLazyLast! ? index : _visibleLazyLast;
+    if (!_viewportReportScheduled) {
+      _viewportReportScheduled = true;
+      WidgetsBinding.instance.addPostFrameCallback((_) => _reportLazyViewport());
+    }
+
+    // Tanpa ring tidak ada notifikasi saat row siap, jadi row didecrypt langsung
+    final async = decryptor.deliversAsync;
+    final text = decryptor.messageAt(index, wait: !async);
+    if (text != null) return {...message, 'message': text};
+    if (!async || decryptor.isFailed(index)) {
+      return {...message, 'message': '🔒 Unable to decrypt message'};
+    }
+    return {...message, 'message': '🔓 Decrypting...'};
+  }
+
+  void _onLazyRowsReady() {
+    if (mounted) setState(() {});
+  }
+
+  // Range row yang di-build selama satu frame dikirim ke native sebagai viewport,
+  // sehingga prefetch berjalan ke arah scroll
+  void _reportLazyViewport() {
+    _viewportReportScheduled = false;
+    final first = _visibleLazyFirst;
+    final last = _visibleLazyLast;
+    _visibleLazyFirst = null;
+    _visibleLazyLast = null;
+    if (first == null || last == null) return;
+    _lazyDecryptor?.requestRange(first, last);
+  }
+
   Future<void> _loadFileMessages() async {
     try {
       if (kDebugMode) {
@@ -182,6 +323,8 @@ class _ChatScreenState extends State<ChatScreen> {
       final supabaseService = SupabaseService();
       final fileMessages = await supabaseService.getFileMessages(widget.chatId);
 
+      fileMessages.sort((a, b) =>
+          (a['created_at'] as String).compareTo(b['created_at'] as String));
       if (mounted) {
         setState(() {
           _fileMessages = fileMessages;
@@ -199,7 +342,169 @@ class _ChatScreenState extends State<ChatScreen> {
     }
   }
 
-  void _setupRealtimeSubscription() {
+  Future<void> _setupRealtimeSubscription() async {
+    // Client native hanya menerima INSERT baru yang sudah didecrypt di thread native;
+    // stream Supabase (snapshot seluruh chat per event) tetap jadi fallback
+    if (await _setupNativeRealtime()) return;
+    if (mounted) _setupStreamSubscription();
+  }
+
+  Future<bool> _setupNativeRealtime() async {
+    _nativeRealtime?.dispose();
+    _nativeRealtime = null;
+    if (!NativeRealtimeClient.isSupported) return false;
+
+    final encryptionService = EncryptionService();
+    final chatKey = base64.decode(_encryptionKey);
+    final aeadKey = encryptionService.messageAeadKey(_encryptionKey);
+    try {
+      final realtime = SupabaseService().realtimeEndpoint();
+      NativeRealtimeClient? client;
+      var closed = false;
+      client = await NativeRealtimeClient.connect(
+        endpoint: realtime.endpoint,
+        topic: 'realtime:chat-${widget.chatId}',
+        filter: 'chat_id=eq.${widget.chatId}',
+        accessToken: realtime.accessToken,
+        chatKey: chatKey,
+        aeadKey: aeadKey,
+        onMessage: _handleNativeRealtimeMessage,
+        onState: (state, detail) {
+          if (closed) return;
+          if (state == realtimeStateJoined) {
+            _fetchMissedMessages();
+            return;
+          }
+          closed = true;
+          if (kDebugMode) {
+            debugPrint('❌ Native realtime closed: $detail');
+          }
+          if (identical(_nativeRealtime, client)) _nativeRealtime = null;
+          client?.dispose();
+          if (mounted) _retrySubscription();
+        },
+      );
+      if (client == null) return false;
+      if (!mounted || closed) {
+        client.dispose();
+        return true;
+      }
+      _nativeRealtime = client;
+      _messageSubscription?.cancel();
+      _messageSubscription = null;
+      if (kDebugMode) {
+        debugPrint('📡 Native real-time client connected');
+      }
+      return true;
+    } catch (e) {
+      if (kDebugMode) {
+        debugPrint('⚠️ Native realtime unavailable: $e');
+      }
+      return false;
+    } finally {
+      chatKey.fillRange(0, chatKey.length, 0);
+      aeadKey.fillRange(0, aeadKey.length, 0);
+    }
+  }
+
+  void _handleNativeRealtimeMessage(RealtimeMessage message) {
+    if (!mounted) return;
+    if (message.text == null) {
+      if (kDebugMode) {
+        debugPrint('⚠️ Failed to decrypt message ${message.id}');
+      }
+      return;
+    }
+    if (_messageIds.contains(message.id)) return;
+
+    setState(() {
+      _insertMessage({
+        'id': message.id,
+        'sender_id': message.senderId,
+        'message': message.text,
+        'created_at': message.createdAt,
+      });
+    });
+    _scrollToBottom();
+  }
+
+  // Client native hanya mengantar INSERT sesudah join. Row yang masuk di antara
+  // _loadMessages (atau selama reconnect) dan join diambil dari server setiap kali join.
+  Future<void> _fetchMissedMessages() async {
+    try {
+      final since = _messages.isEmpty ? null : _messages.last['created_at'] as String?;
+      final supabaseService = SupabaseService();
+      final rows = since == null
+          ? await supabaseService.getEncryptedMessages(widget.chatId)
+          : await supabaseService.getEncryptedMessagesSince(widget.chatId, since);
+      final missed = rows.where((row) => !_messageIds.contains(row['id'])).toList();
+      if (missed.isEmpty || !mounted) return;
+
+      final plaintexts = await EncryptionService().decryptStoredMessagesBatch(
+        [
+          for (final msg in missed)
+            {
+              'encrypted_message': msg['encrypted_message'] as String? ?? '',
+              'iv': msg['iv'] as String? ?? '',
+              if (msg['algorithm'] != null) 'algorithm': msg['algorithm'] as String,
+            }
+        ],
+        _encryptionKey,
+      );
+      if (!mounted) return;
+
+      var added = 0;
+      setState(() {
+        for (int i = 0; i < missed.length; i++) {
+          final text = plaintexts[i];
+          if (text == null) continue;
+          if (_insertMessage({
+            'id': missed[i]['id'],
+            'sender_id': missed[i]['sender_id'],
+            'message': text,
+            'created_at': missed[i]['created_at'],
+          })) {
+            added++;
+          }
+        }
+      });
+      if (added > 0) _scrollToBottom();
+
+      if (kDebugMode) {
+        debugPrint('✅ Caught up $added messages missed before realtime join');
+      }
+    } catch (e) {
+      if (kDebugMode) {
+        debugPrint('⚠️ Failed to fetch messages missed before realtime join: $e');
+      }
+    }
+  }
+
+  void _setMessages(List<Map<String, dynamic>> messages) {
+    messages.sort((a, b) =>
+        (a['created_at'] as String).compareTo(b['created_at'] as String));
+    _messages = messages;
+    _messageIds
+      ..clear()
+      ..addAll(messages.map((message) => message['id']));
+  }
+
+  // Pesan realtime hampir selalu yang terbaru, jadi posisi dicari dari belakang dan
+  // normalnya berakhir sebagai append. Return false jika id sudah ada.
+  bool _insertMessage(Map<String, dynamic> message) {
+    if (!_messageIds.add(message['id'])) return false;
+
+    final createdAt = message['created_at'] as String;
+    var index = _messages.length;
+    while (index > 0 &&
+        (_messages[index - 1]['created_at'] as String).compareTo(createdAt) > 0) {
+      index--;
+    }
+    _messages.insert(index, message);
+    return true;
+  }
+
+  void _setupStreamSubscription() {
     try {
       if (kDebugMode) {
         debugPrint('📡 Setting up real-time message subscription...');
@@ -311,15 +616,13 @@ class _ChatScreenState extends State<ChatScreen> {
 
       for (final msg in encryptedMessages) {
         // Cek apakah message sudah ada
-        final messageExists =
-            _messages.any((existing) => existing['id'] == msg['id']);
-
-        if (!messageExists) {
+        if (!_messageIds.contains(msg['id'])) {
           try {
-            final decryptedContent = await encryptionService.decryptMessage(
+            final decryptedContent = await encryptionService.decryptStoredMessage(
               msg['encrypted_message'] as String,
               msg['iv'] as String,
               _encryptionKey,
+              algorithm: msg['algorithm'] as String?,
             );
 
             newDecryptedMessages.add({
@@ -343,9 +646,7 @@ class _ChatScreenState extends State<ChatScreen> {
 
       if (hasNewMessages && mounted) {
         setState(() {
-          _messages.addAll(newDecryptedMessages);
-          _messages.sort((a, b) =>
-              (a['created_at'] as String).compareTo(b['created_at'] as String));
+          newDecryptedMessages.forEach(_insertMessage);
         });
 
         _scrollToBottom();
@@ -1481,27 +1782,62 @@ File Information:
 
       final tempFile = await supabaseService.saveFileToLocation(
         data: processedFile.data,
-        fileName: 'temp_$fileName',
+        fileName: 'temp_${processedFile.fileName}',
         locationType: 'temp',
       );
 
-      final encryptionResult = await fileEncryption.encryptFile(
-        file: tempFile,
-        encryptionKey: _encryptionKey,
-        chatId: widget.chatId,
-        fileName: fileName,
-      );
+      String? uploadedFilePath;
+      Uint8List? nonce;
+      Uint8List? authTag;
 
-      if (kDebugMode) {
-        debugPrint('📤 Uploading encrypted file...');
+      // Encrypt sambil upload (resumable); fallback ke encrypt penuh + uploadBinary
+      try {
+        final target = supabaseService.resumableUploadTarget(processedFile.fileName);
+        try {
+          final streamed = await fileEncryption.encryptAndUploadFile(
+            file: tempFile,
+            encryptionKey: _encryptionKey,
+            chatId: widget.chatId,
+            fileName: processedFile.fileName,
+            transport: target.transport,
+            metadata: target.metadata,
+            cacheName: target.filePath,
+          );
+          if (streamed != null) {
+            uploadedFilePath = target.filePath;
+            nonce = streamed.nonce;
+            authTag = streamed.authTag;
+          }
+        } finally {
+          target.transport.close();
+        }
+      } catch (e) {
+        if (kDebugMode) {
+          debugPrint('⚠️ Resumable upload failed, falling back: $e');
+        }
       }
 
-      final uploadedFilePath = await supabaseService.uploadEncryptedFile(
-        fileData: encryptionResult.encryptedData,
-        fileName: fileName,
-        chatId: widget.chatId,
-        mimeType: processedFile.mimeType,
-      );
+      if (uploadedFilePath == null || nonce == null || authTag == null) {
+        final encryptionResult = await fileEncryption.encryptFile(
+          file: tempFile,
+          encryptionKey: _encryptionKey,
+          chatId: widget.chatId,
+          fileName: processedFile.fileName,
+        );
+
+        if (kDebugMode) {
+          debugPrint('📤 Uploading encrypted file...');
+        }
+
+        uploadedFilePath = await supabaseService.uploadEncryptedFile(
+          fileData: encryptionResult.encryptedData,
+          fileName: processedFile.fileName,
+          chatId: widget.chatId,
+          mimeType: processedFile.mimeType,
+        );
+        nonce = encryptionResult.nonce;
+        authTag = encryptionResult.authTag;
+      }
 
       if (kDebugMode) {
         debugPrint('💾 Saving file message to database...');
@@ -1511,11 +1847,11 @@ File Information:
         chatId: widget.chatId,
         senderId: authProvider.user!.id,
         filePath: uploadedFilePath,
-        fileName: fileName,
+        fileName: processedFile.fileName,
         fileSize: processedFile.data.length,
         mimeType: processedFile.mimeType,
-        nonce: base64.encode(encryptionResult.nonce),
-        authTag: base64.encode(encryptionResult.authTag),
+        nonce: base64.encode(nonce),
+        authTag: base64.encode(authTag),
       );
 
       await tempFile.delete();
@@ -2499,13 +2835,7 @@ File Information:
 
   Widget _buildMessageList() {
     final authProvider = Provider.of<AuthProvider>(context);
-    final allMessages = [..._messages, ..._fileMessages];
-
-    allMessages.sort((a, b) {
-      final timeA = DateTime.parse(a['created_at'] ?? '2000-01-01');
-      final timeB = DateTime.parse(b['created_at'] ?? '2000-01-01');
-      return timeA.compareTo(timeB);
-    });
+    final allMessages = _mergeByCreatedAt(_messages, _fileMessages);
 
     return RefreshIndicator(
       onRefresh: _manualRefresh,
@@ -2521,13 +2851,34 @@ File Information:
             return _buildEnhancedFileMessage(message, isMe);
           } else {
             final isMe = message['sender_id'] == authProvider.user!.id;
-            return _buildMessageBubble(message, isMe);
+            return _buildMessageBubble(_resolveLazyMessage(message), isMe);
           }
         },
       ),
     );
   }
 
+  // _messages dan _fileMessages sama-sama sudah urut, jadi cukup merge linear
+  List<Map<String, dynamic>> _mergeByCreatedAt(
+      List<Map<String, dynamic>> a, List<Map<String, dynamic>> b) {
+    DateTime timeOf(Map<String, dynamic> m) =>
+        DateTime.parse(m['created_at'] ?? '2000-01-01');
+
+    final merged = <Map<String, dynamic>>[];
+    int i = 0, j = 0;
+    while (i < a.length && j < b.length) {
+      if (timeOf(b[j]).isBefore(timeOf(a[i]))) {
+        merged.add(b[j++]);
+      } else {
+        merged.add(a[i++]);
+      }
+    }
+    merged
+      ..addAll(a.skip(i))
+      ..addAll(b.skip(j));
+    return merged;
+  }
+
   Widget _buildLoading() {
     return const Center(
       child: Column(
@@ -2568,6 +2919,10 @@ File Information:
     _scrollController.dispose();
     _messageSubscription?.cancel();
     _fileMessageSubscription?.cancel();
+    _lazyDecryptor?.dispose();
+    _lazyDecryptor = null;
+    _nativeRealtime?.dispose();
+    _nativeRealtime = null;
     super.dispose();
   }
 
@@ -1,3 +1,4 @@
+import 'dart:async';
 import 'package:flutter/material.dart';
 import 'package:provider/provider.dart';
 import '../providers/auth_provider.dart';
@@ -12,15 +13,36 @@ class LoginScreenState extends State<LoginScreen> {
   final _formKey = GlobalKey<FormState>();
   final _emailController = TextEditingController();
   final _passwordController = TextEditingController();
+  final _passwordFocus = FocusNode();
   bool _isPasswordVisible = false;
+  Timer? _speculationTimer;
+  late final AuthProvider _authProvider;
 
   @override
   void initState() {
     super.initState();
     print('🔓 LoginScreen initialized');
+    _authProvider = Provider.of<AuthProvider>(context, listen: false);
+    _passwordFocus.addListener(() {
+      if (!_passwordFocus.hasFocus) _speculateLogin();
+    });
     _initializeScreen();
   }
 
+  // Argon2id mulai di background sebelum tombol Sign In ditekan
+  void _speculateLogin() {
+    _speculationTimer?.cancel();
+    final password = _passwordController.text;
+    if (_validateEmail(_emailController.text) != null || _validatePassword(password) != null) return;
+    _authProvider.speculateLogin(_emailController.text.trim(), password);
+  }
+
+  void _onCredentialsChanged(String _) {
+    _authProvider.cancelSpeculation();
+    _speculationTimer?.cancel();
+    _speculationTimer = Timer(const Duration(milliseconds: 700), _speculateLogin);
+  }
+
   Future<void> _initializeScreen() async {
     await Future.delayed(Duration(milliseconds: 100));
     
@@ -118,6 +140,9 @@ class LoginScreenState extends State<LoginScreen> {
 
   @override
   void dispose() {
+    _speculationTimer?.cancel();
+    _authProvider.cancelSpeculation();
+    _passwordFocus.dispose();
     _emailController.dispose();
     _passwordController.dispose();
     super.dispose();
@@ -186,6 +211,7 @@ class LoginScreenState extends State<LoginScreen> {
                 keyboardType: TextInputType.emailAddress,
                 textInputAction: TextInputAction.next,
                 validator: _validateEmail,
+                onChanged: _onCredentialsChanged,
                 onFieldSubmitted: (_) {
                   FocusScope.of(context).nextFocus();
                 },
@@ -194,6 +220,7 @@ class LoginScreenState extends State<LoginScreen> {
 
               TextFormField(
                 controller: _passwordController,
+                focusNode: _passwordFocus,
                 decoration: InputDecoration(
                   labelText: 'Password',
                   border: OutlineInputBorder(),
@@ -213,6 +240,7 @@ class LoginScreenState extends State<LoginScreen> {
                 obscureText: !_isPasswordVisible,
                 textInputAction: TextInputAction.done,
                 validator: _validatePassword,
+                onChanged: _onCredentialsChanged,
                 onFieldSubmitted: (_) => _login(),
               ),
               SizedBox(height: 30),
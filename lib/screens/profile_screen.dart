@@ -1,6 +1,9 @@
+import 'package:flutter/foundation.dart';
 import 'package:flutter/material.dart';
+import 'package:flutter/services.dart';
 import 'package:provider/provider.dart';
 import '../providers/auth_provider.dart';
+import '../services/native_metrics_ffi.dart';
 
 class ProfileScreen extends StatelessWidget {
   const ProfileScreen({super.key});
@@ -43,6 +46,11 @@ class ProfileScreen extends StatelessWidget {
                 ),
               ),
             ),
+            // Diagnostics latency native hanya di build debug
+            if (kDebugMode && NativeMetricsFFI().isAvailable) ...[
+              SizedBox(height: 16),
+              _NativeMetricsCard(),
+            ],
             SizedBox(height: 24),
             Center(
               child: ElevatedButton(
@@ -64,4 +72,67 @@ class ProfileScreen extends StatelessWidget {
       ),
     );
   }
-}
\ No newline at end of file
+}
+
+class _NativeMetricsCard extends StatefulWidget {
+  @override
+  State<_NativeMetricsCard> createState() => _NativeMetricsCardState();
+}
+
+class _NativeMetricsCardState extends State<_NativeMetricsCard> {
+  List<NativeSubsystemMetrics> _metrics = NativeMetricsFFI().snapshot();
+
+  String _formatUs(double us) =>
+      us >= 1000 ? '${(us / 1000).toStringAsFixed(1)} ms' : '${us.toStringAsFixed(0)} µs';
+
+  @override
+  Widget build(BuildContext context) {
+    return Card(
+      child: Padding(
+        padding: EdgeInsets.all(16.0),
+        child: Column(
+          crossAxisAlignment: CrossAxisAlignment.start,
+          children: [
+            Row(
+              children: [
+                Expanded(
+                  child: Text(
+                    'Native latency',
+                    style: TextStyle(fontSize: 16, fontWeight: FontWeight.bold),
+                  ),
+                ),
+                IconButton(
+                  icon: Icon(Icons.refresh),
+                  tooltip: 'Refresh',
+                  onPressed: () => setState(() => _metrics = NativeMetricsFFI().snapshot()),
+                ),
+                IconButton(
+                  icon: Icon(Icons.copy),
+                  tooltip: 'Copy Prometheus text',
+                  onPressed: () {
+                    final text = NativeMetricsFFI().formatPrometheus();
+                    if (text == null) return;
+                    Clipboard.setData(ClipboardData(text: text));
+                    ScaffoldMessenger.of(context).showSnackBar(
+                      SnackBar(content: Text('Native metrics copied')),
+                    );
+                  },
+                ),
+              ],
+            ),
+            if (_metrics.isEmpty) Text('No native operations recorded yet'),
+            for (final m in _metrics)
+              Padding(
+                padding: EdgeInsets.only(top: 4.0),
+                child: Text(
+                  '${m.name}: ${m.operations} ops (${m.errors} err), '
+                  'p50 ${_formatUs(m.p50Us)}, p99 ${_formatUs(m.p99Us)}, max ${_formatUs(m.maxUs)}',
+                  style: TextStyle(fontSize: 13, fontFamily: 'monospace'),
+                ),
+              ),
+          ],
+        ),
+      ),
+    );
+  }
+}
@@ -1,3 +1,4 @@
+import 'dart:async';
 import 'package:flutter/foundation.dart';
 import 'package:flutter/material.dart';
 import 'package:provider/provider.dart';
@@ -17,8 +18,34 @@ class _RegisterScreenState extends State<RegisterScreen> {
   final _displayNameController = TextEditingController();
   final _confirmPasswordController = TextEditingController();
 
+  final _passwordFocus = FocusNode();
+
   bool _isPasswordVisible = false;
   bool _isConfirmPasswordVisible = false;
+  Timer? _speculationTimer;
+  late final AuthProvider _authProvider;
+
+  @override
+  void initState() {
+    super.initState();
+    _authProvider = Provider.of<AuthProvider>(context, listen: false);
+    _passwordFocus.addListener(() {
+      if (!_passwordFocus.hasFocus) _speculateRegistration();
+    });
+  }
+
+  // Argon2id password baru mulai di background selagi user mengisi konfirmasi
+  void _speculateRegistration() {
+    _speculationTimer?.cancel();
+    if (_validatePassword(_passwordController.text) != null) return;
+    _authProvider.speculateRegistration(_passwordController.text);
+  }
+
+  void _onPasswordChanged(String _) {
+    _authProvider.cancelSpeculation();
+    _speculationTimer?.cancel();
+    _speculationTimer = Timer(const Duration(milliseconds: 700), _speculateRegistration);
+  }
 
   Future<void> _register() async {
     if (!_formKey.currentState!.validate()) {
@@ -146,6 +173,9 @@ class _RegisterScreenState extends State<RegisterScreen> {
 
   @override
   void dispose() {
+    _speculationTimer?.cancel();
+    _authProvider.cancelSpeculation();
+    _passwordFocus.dispose();
     _emailController.dispose();
     _passwordController.dispose();
     _displayNameController.dispose();
@@ -229,6 +259,7 @@ class _RegisterScreenState extends State<RegisterScreen> {
 
               TextFormField(
                 controller: _passwordController,
+                focusNode: _passwordFocus,
                 decoration: InputDecoration(
                   labelText: 'Password',
                   border: const OutlineInputBorder(),
@@ -250,6 +281,7 @@ class _RegisterScreenState extends State<RegisterScreen> {
                 obscureText: !_isPasswordVisible,
                 textInputAction: TextInputAction.next,
                 validator: _validatePassword,
+                onChanged: _onPasswordChanged,
               ),
               const SizedBox(height: 16),
 
@@ -0,0 +1,243 @@
+// lib/services/blob_store_ffi.dart
+import 'dart:ffi';
+import 'dart:io';
+import 'dart:isolate';
+import 'dart:typed_data';
+import 'package:ffi/ffi.dart';
+import 'package:flutter/foundation.dart';
+import 'package:path_provider/path_provider.dart';
+import 'native_library_loader.dart';
+
+// Status dari native_libs/blob_store.h
+const int _blobStoreOk = 0;
+const int _blobStoreHashHexBytes = 65;
+const int _blobStoreEvictLru = 0;
+
+/// Mirror dari BlobStoreConfig di native_libs/blob_store.h
+final class BlobStoreConfig extends Struct {
+  external Pointer<Utf8> root;
+
+  @Uint64()
+  external int byteBudget;
+
+  @Int32()
+  external int policy;
+}
+
+/// Mirror dari BlobData di native_libs/blob_store.h
+final class BlobData extends Struct {
+  external Pointer<Uint8> data;
+
+  @Size()
+  external int length;
+}
+
+typedef _OpenNative = Pointer<Void> Function(Pointer<BlobStoreConfig>, Pointer<Int32>);
+typedef _OpenDart = Pointer<Void> Function(Pointer<BlobStoreConfig>, Pointer<Int32>);
+typedef _PutNative = Int32 Function(Pointer<Void>, Pointer<Uint8>, Size, Pointer<Utf8>, Int32, Pointer<Utf8>);
+typedef _PutDart = int Function(Pointer<Void>, Pointer<Uint8>, int, Pointer<Utf8>, int, Pointer<Utf8>);
+typedef _PutFileNative = Int32 Function(Pointer<Void>, Pointer<Utf8>, Pointer<Utf8>, Int32, Pointer<Utf8>);
+typedef _PutFileDart = int Function(Pointer<Void>, Pointer<Utf8>, Pointer<Utf8>, int, Pointer<Utf8>);
+typedef _LookupNative = Int32 Function(Pointer<Void>, Pointer<Utf8>, Pointer<Utf8>);
+typedef _LookupDart = int Function(Pointer<Void>, Pointer<Utf8>, Pointer<Utf8>);
+typedef _GetNative = Int32 Function(Pointer<Void>, Pointer<Utf8>, Pointer<BlobData>);
+typedef _GetDart = int Function(Pointer<Void>, Pointer<Utf8>, Pointer<BlobData>);
+typedef _FreeNative = Void Function(Pointer<BlobData>);
+typedef _FreeDart = void Function(Pointer<BlobData>);
+typedef _HashOpNative = Int32 Function(Pointer<Void>, Pointer<Utf8>);
+typedef _HashOpDart = int Function(Pointer<Void>, Pointer<Utf8>);
+
+class _BlobStoreBindings {
+  final _OpenDart open;
+  final _PutDart put;
+  final _PutFileDart putFile;
+  final _LookupDart lookup;
+  final _GetDart get;
+  final _FreeDart free;
+  final _HashOpDart release;
+
+  _BlobStoreBindings(DynamicLibrary lib)
+      : open = lib.lookupFunction<_OpenNative, _OpenDart>('blob_store_open'),
+        put = lib.lookupFunction<_PutNative, _PutDart>('blob_store_put'),
+        putFile = lib.lookupFunction<_PutFileNative, _PutFileDart>('blob_store_put_file'),
+        lookup = lib.lookupFunction<_LookupNative, _LookupDart>('blob_store_lookup'),
+        get = lib.lookupFunction<_GetNative, _GetDart>('blob_store_get'),
+        free = lib.lookupFunction<_FreeNative, _FreeDart>('blob_store_free'),
+        release = lib.lookupFunction<_HashOpNative, _HashOpDart>('blob_store_release');
+
+  // Per isolate: worker Isolate.run memuat ulang binding dari library yang sama
+  static _BlobStoreBindings? _cached;
+  static bool _loaded = false;
+
+  static _BlobStoreBindings? load({String? label}) {
+    if (_loaded) return _cached;
+    _loaded = true;
+    final lib = loadNativeCryptoLibrary('blob_store_open', label: label);
+    if (lib == null) return null;
+
+    try {
+      _cached = _BlobStoreBindings(lib);
+      return _cached;
+    } catch (e) {
+      return null;
+    }
+  }
+}
+
+/// Cache attachment terenkripsi di disk, dialamatkan oleh hash ciphertext.
+/// Nama (path storage Supabase) menjadi alias, jadi attachment yang dibuka ulang
+/// dibaca dari disk tanpa download ulang; total ukuran dibatasi [byteBudget].
+///
+/// Open, put, putFile, get dan release menyentuh disk (SHA-512, fsync, re-hash blob yatim dan
+/// compaction journal saat open), jadi dijalankan lewat Isolate.run dengan handle store
+/// yang sama. Hanya [lookup] (map alias di memory) yang dipanggil langsung.
+class BlobStoreFFI {
+  static final BlobStoreFFI _instance = BlobStoreFFI._internal();
+  factory BlobStoreFFI() => _instance;
+
+  static const int byteBudget = 256 * 1024 * 1024;
+
+  final _BlobStoreBindings? _bindings = _BlobStoreBindings.load(label: 'Native blob store');
+
+  int _store = 0;
+  Future<bool>? _opening;
+
+  BlobStoreFFI._internal();
+
+  bool get isAvailable => _bindings != null;
+
+  /// Buka store di direktori support aplikasi (sekali per proses).
+  Future<bool> ensureOpen() {
+    if (_store != 0) return Future.value(true);
+    return _opening ??= _openStore();
+  }
+
+  Future<bool> _openStore() async {
+    if (_bindings == null) return false;
+
+    try {
+      final supportDir = await getApplicationSupportDirectory();
+      final root = '${supportDir.path}${Platform.pathSeparator}blob_store';
+      final (address, status) = await Isolate.run(() {
+        final bindings = _BlobStoreBindings.load();
+        if (bindings == null) return (0, -1);
+        return using((arena) {
+          final config = arena<BlobStoreConfig>();
+          config.ref
+            ..root = root.toNativeUtf8(allocator: arena)
+            ..byteBudget = byteBudget
+            ..policy = _blobStoreEvictLru;
+          final status = arena<Int32>();
+          return (bindings.open(config, status).address, status.value);
+        });
+      });
+      if (address == 0 && kDebugMode) {
+        debugPrint('⚠️ Blob store open failed: $status');
+      }
+      _store = address;
+      return address != 0;
+    } catch (e) {
+      if (kDebugMode) {
+        debugPrint('⚠️ Blob store unavailable: $e');
+      }
+      return false;
+    }
+  }
+
+  /// Simpan ciphertext, kembalikan hash. [pin] = jangan pernah dievict sampai [release].
+  Future<String?> put(Uint8List data, {String? name, bool pin = false}) async {
+    if (!await ensureOpen()) return null;
+
+    final store = _store;
+    return Isolate.run(() {
+      final bindings = _BlobStoreBindings.load();
+      if (bindings == null) return null;
+      return using((arena) {
+        final buffer = arena<Uint8>(data.isEmpty ? 1 : data.length);
+        buffer.asTypedList(data.length).setAll(0, data);
+        final hash = arena<Uint8>(_blobStoreHashHexBytes).cast<Utf8>();
+        final status = bindings.put(
+          Pointer<Void>.fromAddress(store),
+          buffer,
+          data.length,
+          name == null ? nullptr : name.toNativeUtf8(allocator: arena),
+          pin ? 1 : 0,
+          hash,
+        );
+        return status == _blobStoreOk ? hash.toDartString() : null;
+      });
+    });
+  }
+
+  /// Pindahkan file ciphertext di [path] ke store tanpa memuatnya ke memory (mis. salinan
+  /// dari upload pipeline). Setelah berhasil [path] sudah tidak ada.
+  Future<String?> putFile(String path, {String? name, bool pin = false}) async {
+    if (!await ensureOpen()) return null;
+
+    final store = _store;
+    return Isolate.run(() {
+      final bindings = _BlobStoreBindings.load();
+      if (bindings == null) return null;
+      return using((arena) {
+        final hash = arena<Uint8>(_blobStoreHashHexBytes).cast<Utf8>();
+        final status = bindings.putFile(
+          Pointer<Void>.fromAddress(store),
+          path.toNativeUtf8(allocator: arena),
+          name == null ? nullptr : name.toNativeUtf8(allocator: arena),
+          pin ? 1 : 0,
+          hash,
+        );
+        return status == _blobStoreOk ? hash.toDartString() : null;
+      });
+    });
+  }
+
+  /// Hash untuk alias [name], atau null jika belum ada / sudah dievict.
+  Future<String?> lookup(String name) async {
+    if (!await ensureOpen()) return null;
+
+    return using((arena) {
+      final hash = arena<Uint8>(_blobStoreHashHexBytes).cast<Utf8>();
+      final status =
+          _bindings!.lookup(Pointer<Void>.fromAddress(_store), name.toNativeUtf8(allocator: arena), hash);
+      return status == _blobStoreOk ? hash.toDartString() : null;
+    });
+  }
+
+  Future<Uint8List?> get(String hash) async {
+    if (!await ensureOpen()) return null;
+
+    final store = _store;
+    // Hasil Isolate.run dipindah ke isolate pemanggil tanpa disalin ulang
+    return Isolate.run(() {
+      final bindings = _BlobStoreBindings.load();
+      if (bindings == null) return null;
+      return using((arena) {
+        final out = arena<BlobData>();
+        final status = bindings.get(Pointer<Void>.fromAddress(store), hash.toNativeUtf8(allocator: arena), out);
+        if (status != _blobStoreOk) return null;
+        try {
+          return Uint8List.fromList(out.ref.data.asTypedList(out.ref.length));
+        } finally {
+          bindings.free(out);
+        }
+      });
+    });
+  }
+
+  Future<Uint8List?> getByName(String name) async {
+    final hash = await lookup(name);
+    return hash == null ? null : get(hash);
+  }
+
+  Future<void> release(String hash) async {
+    if (!await ensureOpen()) return;
+
+    final store = _store;
+    await Isolate.run(() {
+      final bindings = _BlobStoreBindings.load();
+      if (bindings == null) return;
+      using((arena) => bindings.release(Pointer<Void>.fromAddress(store), hash.toNativeUtf8(allocator: arena)));
+    });
+  }
+}
@@ -0,0 +1,277 @@
+// lib/services/chat_page_cache_ffi.dart
+import 'dart:convert';
+import 'dart:ffi';
+import 'dart:isolate';
+import 'dart:typed_data';
+import 'package:ffi/ffi.dart';
+import 'native_library_loader.dart';
+
+// Dari native_libs/chat_cache.h
+const int _chatCacheOk = 0;
+const int _chatCacheDecryptFailed = 0xFFFFFFFF;
+const int _chatCacheRecordHeaderBytes = 8;
+
+/// Mirror dari ChatCacheMessage di native_libs/chat_cache.h
+final class ChatCacheMessage extends Struct {
+  external Pointer<Uint8> meta;
+
+  @Uint32()
+  external int metaLen;
+
+  external Pointer<Uint8> ciphertext;
+
+  @Uint32()
+  external int ciphertextLen;
+
+  external Pointer<Uint8> iv;
+
+  @Uint32()
+  external int ivLen;
+}
+
+/// Mirror dari ChatCachePage di native_libs/chat_cache.h
+final class ChatCachePage extends Struct {
+  external Pointer<Uint8> data;
+
+  @Size()
+  external int length;
+
+  @Uint32()
+  external int count;
+}
+
+/// Mirror dari ChatCacheStats di native_libs/chat_cache.h
+final class ChatCacheStats extends Struct {
+  @Uint64()
+  external int entries;
+
+  @Uint64()
+  external int totalBytes;
+
+  @Uint64()
+  external int byteBudget;
+
+  @Uint64()
+  external int hits;
+
+  @Uint64()
+  external int misses;
+
+  @Uint64()
+  external int evictions;
+
+  @Uint64()
+  external int evictedBytes;
+
+  @Uint64()
+  external int messagesDecrypted;
+
+  @Uint64()
+  external int decryptFailures;
+}
+
+typedef _CreateNative = Pointer<Void> Function(Uint64);
+typedef _CreateDart = Pointer<Void> Function(int);
+typedef _PutNative = Int32 Function(Pointer<Void>, Pointer<Utf8>, Pointer<ChatCacheMessage>, Uint32, Pointer<Uint8>, Size);
+typedef _PutDart = int Function(Pointer<Void>, Pointer<Utf8>, Pointer<ChatCacheMessage>, int, Pointer<Uint8>, int);
+typedef _GetNative = Int32 Function(Pointer<Void>, Pointer<Utf8>, Pointer<ChatCachePage>);
+typedef _GetDart = int Function(Pointer<Void>, Pointer<Utf8>, Pointer<ChatCachePage>);
+typedef _FreeNative = Void Function(Pointer<ChatCachePage>);
+typedef _FreeDart = void Function(Pointer<ChatCachePage>);
+typedef _RemoveNative = Int32 Function(Pointer<Void>, Pointer<Utf8>);
+typedef _RemoveDart = int Function(Pointer<Void>, Pointer<Utf8>);
+typedef _ClearNative = Void Function(Pointer<Void>);
+typedef _ClearDart = void Function(Pointer<Void>);
+typedef _StatsNative = Void Function(Pointer<Void>, Pointer<ChatCacheStats>);
+typedef _StatsDart = void Function(Pointer<Void>, Pointer<ChatCacheStats>);
+typedef _FileNative = Int32 Function(Pointer<Void>, Pointer<Utf8>, Pointer<Utf8>, Pointer<Uint8>, Size);
+typedef _FileDart = int Function(Pointer<Void>, Pointer<Utf8>, Pointer<Utf8>, Pointer<Uint8>, int);
+
+/// Cache native halaman pesan terbaru yang sudah didecrypt, per chat.
+/// Diisi [ChatWarmSync] setelah login; ChatScreen membaca [page] untuk tampil langsung
+/// sebelum fetch jaringan selesai. Total dibatasi [byteBudget]. Ke disk hanya lewat
+/// [saveFile] (Adiantum, key turunan chat key), plaintext tidak pernah ditulis.
+class ChatPageCacheFFI {
+  static final ChatPageCacheFFI _instance = ChatPageCacheFFI._internal();
+  factory ChatPageCacheFFI() => _instance;
+
+  static const int byteBudget = 8 * 1024 * 1024;
+
+  _PutDart? _put;
+  late final _GetDart _get;
+  late final _FreeDart _free;
+  late final _RemoveDart _remove;
+  late final _ClearDart _clear;
+  late final _StatsDart _stats;
+  Pointer<Void> _cache = nullptr;
+
+  ChatPageCacheFFI._internal() {
+    _initialize();
+  }
+
+  bool get isAvailable => _put != null;
+
+  void _initialize() {
+    final lib = loadNativeCryptoLibrary('chat_cache_create', label: 'Native chat page cache');
+    if (lib == null) return;
+
+    try {
+      _get = lib.lookupFunction<_GetNative, _GetDart>('chat_cache_get', isLeaf: true);
+      _free = lib.lookupFunction<_FreeNative, _FreeDart>('chat_cache_free', isLeaf: true);
+      _remove = lib.lookupFunction<_RemoveNative, _RemoveDart>('chat_cache_remove', isLeaf: true);
+      _clear = lib.lookupFunction<_ClearNative, _ClearDart>('chat_cache_clear');
+      _stats = lib.lookupFunction<_StatsNative, _StatsDart>('chat_cache_get_stats', isLeaf: true);
+      _cache = lib.lookupFunction<_CreateNative, _CreateDart>('chat_cache_create')(byteBudget);
+      _put = lib.lookupFunction<_PutNative, _PutDart>('chat_cache_put_xor_page');
+    } catch (e) {
+      return;
+    }
+  }
+
+  /// Decrypt [messages] (baris tabel messages, format xor_with_iv) dalam satu batch native
+  /// dan simpan sebagai halaman [chatId]. Return jumlah pesan yang berhasil didecrypt,
+  /// atau < 0 jika gagal disimpan.
+  int putXorPage(String chatId, Uint8List keyBytes, List<Map<String, dynamic>> messages) {
+    final put = _put;
+    if (put == null || keyBytes.isEmpty) return -1;
+
+    return using((arena) {
+      final records = arena<ChatCacheMessage>(messages.isEmpty ? 1 : messages.length);
+      for (int i = 0; i < messages.length; i++) {
+        final message = messages[i];
+        final meta = utf8.encode(jsonEncode({
+          'id': message['id'],
+          'sender_id': message['sender_id'],
+          'created_at': message['created_at'],
+        }));
+        Uint8List ciphertext;
+        Uint8List iv;
+        try {
+          ciphertext = base64.decode(message['encrypted_message'] as String? ?? '');
+          iv = base64.decode(message['iv'] as String? ?? '');
+        } catch (e) {
+          ciphertext = Uint8List(0);
+          iv = Uint8List(0);
+        }
+
+        final record = records[i];
+        record.meta = arena<Uint8>(meta.length);
+        record.meta.asTypedList(meta.length).setAll(0, meta);
+        record.metaLen = meta.length;
+        record.ciphertext = arena<Uint8>(ciphertext.isEmpty ? 1 : ciphertext.length);
+        record.ciphertext.asTypedList(ciphertext.length).setAll(0, ciphertext);
+        record.ciphertextLen = ciphertext.length;
+        record.iv = arena<Uint8>(iv.isEmpty ? 1 : iv.length);
+        record.iv.asTypedList(iv.length).setAll(0, iv);
+        record.ivLen = iv.length;
+      }
+
+      final keyPtr = arena<Uint8>(keyBytes.length);
+      keyPtr.asTypedList(keyBytes.length).setAll(0, keyBytes);
+      final idPtr = chatId.toNativeUtf8(allocator: arena);
+      final result = put(_cache, idPtr, records, messages.length, keyPtr, keyBytes.length);
+      keyPtr.asTypedList(keyBytes.length).fillRange(0, keyBytes.length, 0);
+      return result;
+    });
+  }
+
+  /// Halaman yang sudah didecrypt dalam bentuk yang sama dengan _messages di ChatScreen
+  /// (id, sender_id, message, created_at). Pesan yang gagal didecrypt dilewati.
+  List<Map<String, dynamic>>? page(String chatId) {
+    if (_put == null) return null;
+
+    return using((arena) {
+      final out = arena<ChatCachePage>();
+      if (_get(_cache, chatId.toNativeUtf8(allocator: arena), out) != _chatCacheOk) return null;
+
+      try {
+        final data = out.ref.data.asTypedList(out.ref.length);
+        final view = ByteData.sublistView(data);
+        final messages = <Map<String, dynamic>>[];
+        int offset = 0;
+        while (offset + _chatCacheRecordHeaderBytes <= data.length) {
+          final metaLen = view.getUint32(offset, Endian.little);
+          final textLen = view.getUint32(offset + 4, Endian.little);
+          offset += _chatCacheRecordHeaderBytes;
+          final meta = jsonDecode(utf8.decode(Uint8List.sublistView(data, offset, offset + metaLen)))
+              as Map<String, dynamic>;
+          offset += metaLen;
+          if (textLen == _chatCacheDecryptFailed) continue;
+          meta['message'] = utf8.decode(Uint8List.sublistView(data, offset, offset + textLen));
+          offset += textLen;
+          messages.add(meta);
+        }
+        return messages;
+      } finally {
+        _free(out);
+      }
+    });
+  }
+
+  void remove(String chatId) {
+    if (_put == null) return;
+    using((arena) => _remove(_cache, chatId.toNativeUtf8(allocator: arena)));
+  }
+
+  /// Dipanggil saat logout
+  void clear() {
+    if (_put == null) return;
+    _clear(_cache);
+  }
+
+  /// Simpan halaman [chatId] ke [path] terenkripsi. Enkripsi dan fsync berjalan di
+  /// Isolate.run dengan handle cache yang sama.
+  Future<bool> saveFile(String chatId, Uint8List keyBytes, String path) async {
+    final status = await _fileOp('chat_cache_save_file', chatId, keyBytes, path);
+    return status == _chatCacheOk;
+  }
+
+  /// Muat file dari [saveFile] sebagai halaman [chatId] jika belum ada di memori.
+  /// Return jumlah pesan, atau < 0 jika file tidak ada, rusak, atau key tidak cocok.
+  Future<int> loadFile(String chatId, Uint8List keyBytes, String path) =>
+      _fileOp('chat_cache_load_file', chatId, keyBytes, path);
+
+  Future<int> _fileOp(String symbol, String chatId, Uint8List keyBytes, String path) {
+    if (_put == null || keyBytes.isEmpty) return Future.value(-1);
+
+    final cache = _cache.address;
+    return Isolate.run(() {
+      final lib = loadNativeCryptoLibrary(symbol);
+      if (lib == null) return -1;
+      final op = lib.lookupFunction<_FileNative, _FileDart>(symbol);
+      return using((arena) {
+        final keyPtr = arena<Uint8>(keyBytes.length);
+        keyPtr.asTypedList(keyBytes.length).setAll(0, keyBytes);
+        final result = op(
+          Pointer<Void>.fromAddress(cache),
+          chatId.toNativeUtf8(allocator: arena),
+          path.toNativeUtf8(allocator: arena),
+          keyPtr,
+          keyBytes.length,
+        );
+        keyPtr.asTypedList(keyBytes.length).fillRange(0, keyBytes.length, 0);
+        return result;
+      });
+    });
+  }
+
+  Map<String, int> stats() {
+    if (_put == null) return {};
+    return using((arena) {
+      final out = arena<ChatCacheStats>();
+      _stats(_cache, out);
+      final s = out.ref;
+      return {
+        'entries': s.entries,
+        'total_bytes': s.totalBytes,
+        'byte_budget': s.byteBudget,
+        'hits': s.hits,
+        'misses': s.misses,
+        'evictions': s.evictions,
+        'evicted_bytes': s.evictedBytes,
+        'messages_decrypted': s.messagesDecrypted,
+        'decrypt_failures': s.decryptFailures,
+      };
+    });
+  }
+}
@@ -0,0 +1,203 @@
+// lib/services/chat_warm_sync.dart
+import 'dart:async';
+import 'dart:convert';
+import 'dart:io';
+import 'dart:typed_data';
+import 'package:crypto/crypto.dart';
+import 'package:flutter/foundation.dart';
+import 'package:path_provider/path_provider.dart';
+import 'chat_page_cache_ffi.dart';
+
+/// Sumber halaman pesan terbaru per chat. Dibuat abstrak supaya backend lokal di test
+/// bisa dipakai tanpa mengubah coordinator.
+abstract class ChatPageSource {
+  /// [limit] pesan terbaru [chatId], urut created_at naik (sama dengan ChatScreen).
+  Future<List<Map<String, dynamic>>> latestPage(String chatId, int limit);
+}
+
+/// Halaman terbaru lewat PostgREST (GET /rest/v1/messages) di atas dart:io HttpClient.
+/// Satu HttpClient dipakai bersama sehingga request paralel berbagi koneksi keep-alive.
+class PostgrestChatPageSource implements ChatPageSource {
+  final Uri restEndpoint;
+  final Map<String, String> headers;
+  final HttpClient _client;
+
+  PostgrestChatPageSource(this.restEndpoint, {this.headers = const {}, HttpClient? client})
+      : _client = client ?? HttpClient();
+
+  @override
+  Future<List<Map<String, dynamic>>> latestPage(String chatId, int limit) async {
+    final uri = restEndpoint.resolve('messages').replace(queryParameters: {
+      'select': 'id,sender_id,encrypted_message,iv,created_at',
+      'chat_id': 'eq.$chatId',
+      'order': 'created_at.desc',
+      'limit': '$limit',
+    });
+    final request = await _client.getUrl(uri);
+    request.headers.set(HttpHeaders.acceptHeader, 'application/json');
+    headers.forEach(request.headers.set);
+    final response = await request.close();
+    final body = await response.transform(utf8.decoder).join();
+    if (response.statusCode != HttpStatus.ok) {
+      throw HttpException('messages fetch failed: ${response.statusCode}', uri: uri);
+    }
+
+    final rows = (jsonDecode(body) as List).cast<Map<String, dynamic>>();
+    return rows.reversed.toList();
+  }
+
+  void close() => _client.close();
+}
+
+class WarmChat {
+  final String chatId;
+
+  /// Chat key base64 dari EncryptionService.generateChatKey
+  final String encryptionKey;
+
+  const WarmChat(this.chatId, this.encryptionKey);
+}
+
+class ChatWarmSyncResult {
+  final int warmed;
+  final int failed;
+  final int messages;
+  final Duration elapsed;
+
+  const ChatWarmSyncResult({
+    required this.warmed,
+    required this.failed,
+    required this.messages,
+    required this.elapsed,
+  });
+
+  @override
+  String toString() =>
+      'ChatWarmSyncResult(warmed: $warmed, failed: $failed, messages: $messages, ${elapsed.inMilliseconds}ms)';
+}
+
+/// Setelah login, ambil halaman terbaru semua chat secara paralel (maksimal [parallelism]
+/// request sekaligus), decrypt per halaman dalam satu batch native, dan simpan di
+/// [ChatPageCacheFFI] supaya ChatScreen langsung tampil saat dibuka.
+///
+/// Jika [pageDirectory] diisi, halaman juga disimpan di sana terenkripsi Adiantum (satu
+/// file per chat) dan [restore] memuatnya saat aplikasi dibuka lagi, sebelum jaringan.
+class ChatWarmSync {
+  final ChatPageSource source;
+  final ChatPageCacheFFI cache;
+  final int parallelism;
+  final int pageSize;
+  final String? pageDirectory;
+
+  ChatWarmSync(
+    this.source, {
+    ChatPageCacheFFI? cache,
+    this.parallelism = 4,
+    this.pageSize = 50,
+    this.pageDirectory,
+  }) : cache = cache ?? ChatPageCacheFFI();
+
+  /// Direktori file halaman di support directory aplikasi
+  static Future<String> defaultPageDirectory() async {
+    final supportDir = await getApplicationSupportDirectory();
+    final dir = Directory('${supportDir.path}${Platform.pathSeparator}chat_pages');
+    await dir.create(recursive: true);
+    return dir.path;
+  }
+
+  /// Hapus semua file halaman (logout), pasangan dari ChatPageCacheFFI.clear()
+  static Future<void> deletePageFiles() async {
+    try {
+      final dir = Directory(await defaultPageDirectory());
+      await dir.delete(recursive: true);
+    } catch (e) {
+      if (kDebugMode) {
+        debugPrint('⚠️ Failed to delete chat page files: $e');
+      }
+    }
+  }
+
+  // Nama file dari hash chat_id, supaya id chat tidak terlihat di listing direktori
+  String? _pagePath(String chatId) {
+    final dir = pageDirectory;
+    if (dir == null) return null;
+    return '$dir${Platform.pathSeparator}${sha256.convert(utf8.encode(chatId))}.page';
+  }
+
+  /// Muat halaman dari disk untuk chat yang belum ada di cache. Return jumlah chat yang
+  /// dimuat; file rusak atau dari key lain dilewati dan nanti ditimpa [warm].
+  Future<int> restore(List<WarmChat> chats) async {
+    if (!cache.isAvailable || pageDirectory == null) return 0;
+
+    int restored = 0;
+    for (final chat in chats) {
+      final path = _pagePath(chat.chatId)!;
+      if (!await File(path).exists()) continue;
+      if (await cache.loadFile(chat.chatId, _keyBytes(chat.encryptionKey), path) >= 0) restored++;
+    }
+    if (kDebugMode) {
+      debugPrint('💾 Restored $restored/${chats.length} chat pages from disk');
+    }
+    return restored;
+  }
+
+  Future<ChatWarmSyncResult> warm(List<WarmChat> chats) async {
+    final stopwatch = Stopwatch()..start();
+    if (!cache.isAvailable || chats.isEmpty) {
+      return ChatWarmSyncResult(warmed: 0, failed: 0, messages: 0, elapsed: stopwatch.elapsed);
+    }
+
+    int next = 0;
+    int warmed = 0;
+    int failed = 0;
+    int messages = 0;
+
+    // Worker mengambil chat berikutnya dari index bersama; event loop tunggal jadi
+    // next++ tidak perlu dikunci
+    Future<void> worker() async {
+      while (next < chats.length) {
+        final chat = chats[next++];
+        try {
+          final page = await source.latestPage(chat.chatId, pageSize);
+          final decrypted = cache.putXorPage(chat.chatId, _keyBytes(chat.encryptionKey), page);
+          if (decrypted < 0) {
+            failed++;
+            continue;
+          }
+          warmed++;
+          messages += decrypted;
+          final path = _pagePath(chat.chatId);
+          if (path != null) await cache.saveFile(chat.chatId, _keyBytes(chat.encryptionKey), path);
+        } catch (e) {
+          if (kDebugMode) {
+            debugPrint('⚠️ Warm sync failed for chat ${chat.chatId}: $e');
+          }
+          failed++;
+        }
+      }
+    }
+
+    final workers = parallelism < chats.length ? parallelism : chats.length;
+    await Future.wait(List.generate(workers < 1 ? 1 : workers, (_) => worker()));
+
+    stopwatch.stop();
+    final result = ChatWarmSyncResult(
+      warmed: warmed,
+      failed: failed,
+      messages: messages,
+      elapsed: stopwatch.elapsed,
+    );
+    if (kDebugMode) {
+      debugPrint('🔥 Chat warm sync: $result');
+    }
+    return result;
+  }
+
+  static Uint8List _keyBytes(String encryptionKey) {
+    try {
+      return base64.decode(encryptionKey);
+    } catch (e) {
+      return Uint8List(0);
+    }
+  }
+}
@@ -1,12 +1,107 @@
 // lib/services/crypto_auth_ffi.dart
 import 'dart:ffi';
 import 'dart:io';
+import 'dart:isolate';
 import 'dart:typed_data';
 import 'dart:convert';
 import 'dart:math';
 import 'package:ffi/ffi.dart';
 import 'package:flutter/foundation.dart';
 import '../generated/crypto_bindings.dart';
+import 'native_library_loader.dart';
+
+// Dari native_libs/auth_engine.h
+const int _authOk = 0;
+const int _authErrorMismatch = -2;
+const int _authPasswordHashBytes = 32;
+
+// Dari native_libs/kdf_executor.h: dua Argon2id 64 MiB bersamaan, antrian pendek
+const int _kdfMemoryBudget = 128 * 1024 * 1024;
+const int _kdfWorkerThreads = 2;
+const int _kdfMaxQueue = 8;
+const int _kdfWaitForever = -1;
+
+/// Mirror dari AuthResponse di native_libs/auth_engine.h (128 byte)
+final class AuthResponse extends Struct {
+  @Array(32)
+  external Array<Uint8> passwordHash;
+
+  @Array(64)
+  external Array<Uint8> challengeHash;
+
+  @Array(32)
+  external Array<Uint8> combined;
+}
+
+/// Mirror dari KdfParams di native_libs/kdf_executor.h
+final class AuthKdfParams extends Struct {
+  @Uint32()
+  external int tCost;
+
+  @Uint32()
+  external int mCost;
+
+  @Uint32()
+  external int parallelism;
+}
+
+typedef _AuthRespondNative = Int32 Function(Pointer<Uint8>, Size, Pointer<Uint8>, Size, Pointer<AuthKdfParams>,
+    Pointer<Uint8>, Size, Pointer<Uint8>, Pointer<AuthResponse>);
+typedef _AuthRespondDart = int Function(Pointer<Uint8>, int, Pointer<Uint8>, int, Pointer<AuthKdfParams>,
+    Pointer<Uint8>, int, Pointer<Uint8>, Pointer<AuthResponse>);
+
+typedef _SpecCreateNative = Pointer<Void> Function();
+typedef _SpecCreateDart = Pointer<Void> Function();
+typedef _SpecBeginNative = Int32 Function(
+    Pointer<Void>, Pointer<AuthKdfParams>, Pointer<Uint8>, Size, Pointer<Uint8>, Size, Size);
+typedef _SpecBeginDart = int Function(Pointer<Void>, Pointer<AuthKdfParams>, Pointer<Uint8>, int, Pointer<Uint8>, int, int);
+typedef _SpecClearNative = Void Function(Pointer<Void>);
+typedef _SpecClearDart = void Function(Pointer<Void>);
+typedef _AuthRespondSpeculativeNative = Int32 Function(Pointer<Void>, Pointer<Uint8>, Size, Pointer<Uint8>, Size,
+    Pointer<AuthKdfParams>, Pointer<Uint8>, Size, Pointer<Uint8>, Pointer<AuthResponse>);
+typedef _AuthRespondSpeculativeDart = int Function(Pointer<Void>, Pointer<Uint8>, int, Pointer<Uint8>, int,
+    Pointer<AuthKdfParams>, Pointer<Uint8>, int, Pointer<Uint8>, Pointer<AuthResponse>);
+
+typedef _KdfExecutorCreateNative = Pointer<Void> Function(Uint64, Uint32, Uint32);
+typedef _KdfExecutorCreateDart = Pointer<Void> Function(int, int, int);
+typedef _AuthSubmitNative = Int64 Function(Pointer<Void>, Pointer<AuthKdfParams>, Pointer<Uint8>, Size, Pointer<Uint8>, Size);
+typedef _AuthSubmitDart = int Function(Pointer<Void>, Pointer<AuthKdfParams>, Pointer<Uint8>, int, Pointer<Uint8>, int);
+typedef _AuthCollectNative = Int32 Function(
+    Pointer<Void>, Int64, Pointer<Uint8>, Size, Pointer<Uint8>, Pointer<AuthResponse>, Int32);
+typedef _AuthCollectDart = int Function(Pointer<Void>, int, Pointer<Uint8>, int, Pointer<Uint8>, Pointer<AuthResponse>, int);
+typedef _KdfExecutorReleaseNative = Int32 Function(Pointer<Void>, Int64);
+typedef _KdfExecutorReleaseDart = int Function(Pointer<Void>, int);
+
+// Parameter dan panjang password sama dengan hashPasswordArgon2id supaya hash lama tetap cocok
+void _setAuthKdfParams(Pointer<AuthKdfParams> params) {
+  params.ref
+    ..tCost = 3
+    ..mCost = 65536
+    ..parallelism = 4;
+}
+
+// Dijalankan di Isolate.run: [respond] memanggil native dengan buffer challenge/expected
+// dan AuthResponse, lalu response 128 byte disalin keluar dan buffer native dinolkan.
+(int, Uint8List?) _respondInWorker(Uint8List challenge, Uint8List? expected,
+    int Function(Pointer<Uint8>, int, Pointer<Uint8>, Pointer<AuthResponse>) respond) {
+  return using((arena) {
+    final challengePtr = arena<Uint8>(challenge.isEmpty ? 1 : challenge.length);
+    challengePtr.asTypedList(challenge.length).setAll(0, challenge);
+    Pointer<Uint8> expectedPtr = nullptr;
+    if (expected != null) {
+      expectedPtr = arena<Uint8>(expected.length);
+      expectedPtr.asTypedList(expected.length).setAll(0, expected);
+    }
+    final out = arena<AuthResponse>();
+    final bytes = out.cast<Uint8>().asTypedList(sizeOf<AuthResponse>());
+    try {
+      final status = respond(challengePtr, challenge.length, expectedPtr, out);
+      return (status, status == _authOk ? Uint8List.fromList(bytes) : null);
+    } finally {
+      bytes.fillRange(0, bytes.length, 0);
+    }
+  });
+}
 
 class CryptoAuthFFI {
   static final CryptoAuthFFI _instance = CryptoAuthFFI._internal();
@@ -15,6 +110,20 @@ class CryptoAuthFFI {
   late DynamicLibrary _nativeLib;
   late CryptoBindings _bindings;
   bool _isInitialized = false;
+  _AuthRespondDart? _authRespond;
+
+  // Argon2id spekulatif (native_libs/speculative_kdf.h)
+  _AuthRespondSpeculativeDart? _authRespondSpeculative;
+  late final _SpecBeginDart _specBegin;
+  late final _SpecClearDart _specClear;
+  Pointer<Void> _speculative = nullptr;
+  Uint8List? _speculativeRegisterSalt;
+  bool _speculating = false;
+
+  // Argon2id async lewat kdf_executor (auth_submit / auth_collect)
+  _AuthSubmitDart? _authSubmit;
+  late final _KdfExecutorReleaseDart _kdfRelease;
+  Pointer<Void> _kdfExecutor = nullptr;
 
   CryptoAuthFFI._internal() {
     _initialize();
@@ -105,6 +214,26 @@ class CryptoAuthFFI {
       }
       _isInitialized = false;
     }
+
+    if (_isInitialized && _nativeLib.providesSymbol('auth_respond')) {
+      _authRespond = _nativeLib.lookupFunction<_AuthRespondNative, _AuthRespondDart>('auth_respond');
+    }
+    if (_authRespond != null && _nativeLib.providesSymbol('auth_submit')) {
+      _kdfExecutor = _nativeLib.lookupFunction<_KdfExecutorCreateNative, _KdfExecutorCreateDart>('kdf_executor_create')(
+          _kdfMemoryBudget, _kdfWorkerThreads, _kdfMaxQueue);
+      if (_kdfExecutor != nullptr) {
+        _authSubmit = _nativeLib.lookupFunction<_AuthSubmitNative, _AuthSubmitDart>('auth_submit');
+        _kdfRelease = _nativeLib.lookupFunction<_KdfExecutorReleaseNative, _KdfExecutorReleaseDart>(
+            'kdf_executor_release', isLeaf: true);
+      }
+    }
+    if (_authRespond != null && _nativeLib.providesSymbol('auth_respond_speculative')) {
+      _specBegin = _nativeLib.lookupFunction<_SpecBeginNative, _SpecBeginDart>('speculative_kdf_begin');
+      _specClear = _nativeLib.lookupFunction<_SpecClearNative, _SpecClearDart>('speculative_kdf_clear', isLeaf: true);
+      _speculative = _nativeLib.lookupFunction<_SpecCreateNative, _SpecCreateDart>('speculative_kdf_create')();
+      _authRespondSpeculative = _nativeLib
+          .lookupFunction<_AuthRespondSpeculativeNative, _AuthRespondSpeculativeDart>('auth_respond_speculative');
+    }
   }
 
   bool _testBindings() {
@@ -266,6 +395,41 @@ class CryptoAuthFFI {
   }
 
 
+  bool get supportsSpeculation => _speculative != nullptr;
+
+  /// Mulai Argon2id di background saat user masih di form (field password kehilangan
+  /// fokus / debounce). [storedSalt] = salt akun untuk login; null = registrasi, salt baru
+  /// disimpan dan dipakai [hybridAuthenticate] berikutnya. Login/register dengan password
+  /// yang sama lalu langsung memakai hasilnya; password berbeda dihitung ulang seperti biasa.
+  void speculate(String password, {String? storedSalt}) {
+    if (_speculative == nullptr || password.isEmpty) return;
+
+    final salt = storedSalt != null ? base64.decode(storedSalt) : _generateSalt(16);
+    if (storedSalt == null) _speculativeRegisterSalt = salt;
+
+    using((arena) {
+      final passwordBytes = utf8.encode(password);
+      final passwordPtr = arena<Uint8>(passwordBytes.length);
+      passwordPtr.asTypedList(passwordBytes.length).setAll(0, passwordBytes);
+      final saltPtr = arena<Uint8>(salt.length);
+      saltPtr.asTypedList(salt.length).setAll(0, salt);
+      final params = arena<AuthKdfParams>();
+      _setAuthKdfParams(params);
+      // Panjang password sama dengan _hybridAuthenticateNative agar input identik
+      _specBegin(_speculative, params, passwordPtr, password.length, saltPtr, salt.length, _authPasswordHashBytes);
+      _speculating = true;
+      passwordPtr.asTypedList(passwordBytes.length).fillRange(0, passwordBytes.length, 0);
+    });
+  }
+
+  /// Hapus spekulasi (password diubah, layar ditutup)
+  void cancelSpeculation() {
+    if (_speculative == nullptr) return;
+    _specClear(_speculative);
+    _speculativeRegisterSalt = null;
+    _speculating = false;
+  }
+
   Future<HybridAuthResult> hybridAuthenticate({
     required String password,
     required String challenge,
@@ -276,6 +440,10 @@ class CryptoAuthFFI {
       throw Exception('FFI not initialized - Hybrid auth unavailable');
     }
 
+    if (_authRespond != null) {
+      return await _hybridAuthenticateNative(password, challenge, storedHash, storedSalt);
+    }
+
     try {
       if (kDebugMode) {
         debugPrint('🛡️ Starting REAL Argon2id + SHA3-512 hybrid auth...');
@@ -337,6 +505,137 @@ class CryptoAuthFFI {
   }
 
 
+  /// Seluruh rantai Argon2id → verifikasi → SHA3-512 → kombinasi di native; hanya response
+  /// 128 byte yang kembali ke Dart. Isolate UI tidak menjalankan maupun menunggu Argon2id:
+  /// job masuk kdf_executor lewat auth_submit (prioritas interaktif, password langsung
+  /// disalin native), lalu auth_collect menunggu di Isolate.run. Jika spekulasi sudah
+  /// dimulai, auth_respond_speculative (bisa menunggu spekulasi selesai) juga di Isolate.run.
+  Future<HybridAuthResult> _hybridAuthenticateNative(
+    String password,
+    String challenge,
+    String? storedHash,
+    String? storedSalt,
+  ) async {
+    final verifying = storedHash != null && storedSalt != null;
+    final salt = verifying ? base64.decode(storedSalt) : (_speculativeRegisterSalt ?? _generateSalt(16));
+    _speculativeRegisterSalt = null;
+    final expected = verifying ? base64.decode(storedHash) : null;
+    if (expected != null && expected.length != _authPasswordHashBytes) {
+      throw Exception('Stored Argon2id hash has unexpected length: ${expected.length}');
+    }
+    final challengeBytes = utf8.encode(challenge);
+
+    final useSpeculation = _speculating && _authRespondSpeculative != null && _speculative != nullptr;
+    _speculating = false;
+    final submit = _authSubmit;
+    final (status, response) = useSpeculation || submit == null
+        ? await _respondDirect(password, salt, challengeBytes, expected, useSpeculation)
+        : await _respondQueued(submit, password, salt, challengeBytes, expected);
+
+    if (status == _authErrorMismatch) {
+      throw Exception('Argon2id password verification failed');
+    }
+    if (status != _authOk || response == null) {
+      throw Exception('auth_respond failed with code: $status');
+    }
+
+    final result = HybridAuthResult(
+      success: true,
+      passwordHash: base64.encode(response.sublist(0, 32)),
+      salt: base64.encode(salt),
+      challengeHash: base64.encode(response.sublist(32, 96)),
+      combinedHash: base64.encode(response.sublist(96, 128)),
+      timestamp: DateTime.now(),
+    );
+    response.fillRange(0, response.length, 0);
+
+    if (kDebugMode) {
+      debugPrint('✅ Native auth completed (${verifying ? 'verify' : 'register'}, '
+          '${useSpeculation ? 'speculative' : submit != null ? 'kdf_executor' : 'direct'})');
+    }
+    return result;
+  }
+
+  // auth_submit di isolate ini hanya menyalin input dan mengantri; hasilnya diambil worker
+  Future<(int, Uint8List?)> _respondQueued(
+      _AuthSubmitDart submit, String password, Uint8List salt, Uint8List challenge, Uint8List? expected) async {
+    final job = using((arena) {
+      final passwordBytes = utf8.encode(password);
+      final passwordPtr = arena<Uint8>(passwordBytes.isEmpty ? 1 : passwordBytes.length);
+      passwordPtr.asTypedList(passwordBytes.length).setAll(0, passwordBytes);
+      final saltPtr = arena<Uint8>(salt.length);
+      saltPtr.asTypedList(salt.length).setAll(0, salt);
+      final params = arena<AuthKdfParams>();
+      _setAuthKdfParams(params);
+      final job = submit(_kdfExecutor, params, passwordPtr, password.length, saltPtr, salt.length);
+      passwordPtr.asTypedList(passwordBytes.length).fillRange(0, passwordBytes.length, 0);
+      passwordBytes.fillRange(0, passwordBytes.length, 0);
+      return job;
+    });
+    if (job <= 0) return (job, null);
+    try {
+      return await _collectQueued(_kdfExecutor.address, job, challenge, expected);
+    } catch (_) {
+      // Worker gagal sebelum auth_collect mengambil hasil: jangan biarkan hash tertahan di executor
+      _kdfRelease(_kdfExecutor, job);
+      rethrow;
+    }
+  }
+
+  // Method statis supaya closure Isolate.run tidak ikut membawa `this` (DynamicLibrary)
+  static Future<(int, Uint8List?)> _collectQueued(int executor, int job, Uint8List challenge, Uint8List? expected) {
+    return Isolate.run(() {
+      final lib = loadNativeCryptoLibrary('auth_collect');
+      if (lib == null) throw StateError('auth_collect unavailable in worker isolate');
+      final collect = lib.lookupFunction<_AuthCollectNative, _AuthCollectDart>('auth_collect');
+      return _respondInWorker(
+          challenge,
+          expected,
+          (challengePtr, challengeLen, expectedPtr, out) => collect(Pointer<Void>.fromAddress(executor), job,
+              challengePtr, challengeLen, expectedPtr, out, _kdfWaitForever));
+    });
+  }
+
+  // auth_respond(_speculative) menjalankan/menunggu Argon2id sendiri, jadi seluruhnya di worker
+  Future<(int, Uint8List?)> _respondDirect(
+          String password, Uint8List salt, Uint8List challenge, Uint8List? expected, bool speculative) =>
+      _respondInIsolate(utf8.encode(password), password.length, salt, challenge, expected,
+          speculative ? _speculative.address : 0);
+
+  static Future<(int, Uint8List?)> _respondInIsolate(Uint8List passwordBytes, int passwordLength, Uint8List salt,
+      Uint8List challenge, Uint8List? expected, int spec) {
+    final speculative = spec != 0;
+    return Isolate.run(() {
+      final lib = loadNativeCryptoLibrary('auth_respond');
+      if (lib == null) return (-1, null);
+      final respond = lib.lookupFunction<_AuthRespondNative, _AuthRespondDart>('auth_respond');
+      final respondSpeculative = speculative
+          ? lib.lookupFunction<_AuthRespondSpeculativeNative, _AuthRespondSpeculativeDart>('auth_respond_speculative')
+          : null;
+      return using((arena) {
+        final passwordPtr = arena<Uint8>(passwordBytes.isEmpty ? 1 : passwordBytes.length);
+        passwordPtr.asTypedList(passwordBytes.length).setAll(0, passwordBytes);
+        passwordBytes.fillRange(0, passwordBytes.length, 0);
+        final saltPtr = arena<Uint8>(salt.length);
+        saltPtr.asTypedList(salt.length).setAll(0, salt);
+        final params = arena<AuthKdfParams>();
+        _setAuthKdfParams(params);
+        try {
+          return _respondInWorker(challenge, expected, (challengePtr, challengeLen, expectedPtr, out) {
+            // Hash dari spekulasi jika password/salt sama, selain itu Argon2id dihitung langsung
+            return respondSpeculative != null
+                ? respondSpeculative(Pointer<Void>.fromAddress(spec), passwordPtr, passwordLength, saltPtr,
+                    salt.length, params, challengePtr, challengeLen, expectedPtr, out)
+                : respond(passwordPtr, passwordLength, saltPtr, salt.length, params, challengePtr, challengeLen,
+                    expectedPtr, out);
+          });
+        } finally {
+          passwordPtr.asTypedList(passwordBytes.length).fillRange(0, passwordBytes.length, 0);
+        }
+      });
+    });
+  }
+
   Uint8List _generateSalt(int length) {
     final random = Random.secure();
     final salt = Uint8List(length);
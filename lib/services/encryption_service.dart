@@ -2,9 +2,13 @@
 import 'dart:convert';
 import 'dart:math';
 import 'dart:typed_data';
+import 'package:crypto/crypto.dart';
 import 'package:flutter/foundation.dart';
 import 'camellia_encryption.dart';
 import 'hybrid_encryption_service.dart';
+import 'keystream_pool_ffi.dart';
+import 'legacy_decoder_ffi.dart';
+import 'message_aead_ffi.dart';
 
 class EncryptionService {
   static final EncryptionService _instance = EncryptionService._internal();
@@ -200,9 +204,7 @@ class EncryptionService {
       final ivBytes = base64.decode(iv);
       final encryptedBytes = base64.decode(encryptedMessage);
       
-      final decryptedBytes = _xorDecrypt(encryptedBytes, keyBytes, ivBytes);
-      
-      final decryptedMessage = utf8.decode(decryptedBytes);
+      final decryptedMessage = _decryptXorWithIv(encryptedBytes, keyBytes, ivBytes);
       
       if (kDebugMode) {
         debugPrint('✅ Message decrypted successfully');
@@ -221,6 +223,211 @@ class EncryptionService {
     }
   }
   
+  /// Enkripsi AEAD (ChaCha20-Poly1305 atau Ascon-128a, dipilih native per device).
+  /// Return null jika library native tidak tersedia; caller fallback ke [encryptMessage].
+  /// ChatScreen masih mengirim xor_with_iv: client web (build wasm tanpa export AEAD) dan
+  /// client lama belum bisa membaca row AEAD, dan schema messages.algorithm belum dimigrasi.
+  Map<String, dynamic>? aeadEncryptMessage(String message, String encryptionKey) {
+    final aead = MessageAeadFFI();
+    if (!aead.isAvailable || message.isEmpty || encryptionKey.isEmpty) return null;
+
+    final plaintext = Uint8List.fromList(utf8.encode(message));
+    final pool = KeystreamPoolFFI();
+    MessageAeadBox? box;
+    if (aead.algorithm == messageAeadChaCha20Poly1305) {
+      // Keystream sudah disiapkan saat idle: tanpa derivasi key dan nonce di jalur kirim
+      box = pool.seal(encryptionKey, plaintext);
+    }
+    if (box == null) {
+      final key = _deriveAeadKey(encryptionKey);
+      box = aead.seal(plaintext, key);
+      if (aead.algorithm == messageAeadChaCha20Poly1305 && !pool.contains(encryptionKey)) {
+        pool.warm(encryptionKey, key);
+      }
+      key.fillRange(0, key.length, 0);
+    }
+    if (box == null) return null;
+
+    return {
+      'encrypted_message': base64.encode(box.ciphertext),
+      'iv': base64.encode(box.nonce),
+      'algorithm': MessageAeadFFI.algorithmName(box.algorithm),
+      'security_level': 'aead',
+    };
+  }
+
+  /// Siapkan keystream kirim untuk chat ini saat idle (mis. saat ChatScreen dibuka),
+  /// supaya [aeadEncryptMessage] pertama pun tidak membayar setup key.
+  void warmAeadKey(String encryptionKey) {
+    final pool = KeystreamPoolFFI();
+    if (!pool.isAvailable || encryptionKey.isEmpty) return;
+    if (MessageAeadFFI().algorithm != messageAeadChaCha20Poly1305) return;
+    final key = _deriveAeadKey(encryptionKey);
+    pool.warm(encryptionKey, key);
+    key.fillRange(0, key.length, 0);
+  }
+
+  /// Pasangan [aeadEncryptMessage]; [algorithm] adalah field 'algorithm' pesan.
+  String aeadDecryptMessage(String encryptedMessage, String iv, String encryptionKey, String algorithm) {
+    final aead = MessageAeadFFI();
+    final algorithmId = MessageAeadFFI.algorithmFromName(algorithm);
+    if (!aead.isAvailable || algorithmId == null) {
+      throw Exception('AEAD algorithm not available: $algorithm');
+    }
+
+    final key = _deriveAeadKey(encryptionKey);
+    final plaintext = aead.open(algorithmId, base64.decode(iv), base64.decode(encryptedMessage), key);
+    key.fillRange(0, key.length, 0);
+    if (plaintext == null) {
+      throw Exception('AEAD authentication failed');
+    }
+    return utf8.decode(plaintext);
+  }
+
+  /// Decrypt banyak pesan AEAD dari chat yang sama sekaligus (mis. satu halaman history).
+  /// Pesan ChaCha20-Poly1305 dibuka dalam satu call native multi-buffer, algoritma lain
+  /// per pesan. Hasil null untuk pesan yang gagal diautentikasi.
+  List<String?> aeadDecryptMessagesBatch(List<Map<String, String>> messages, String encryptionKey) {
+    final aead = MessageAeadFFI();
+    final results = List<String?>.filled(messages.length, null);
+    if (!aead.isAvailable || encryptionKey.isEmpty) return results;
+
+    final key = _deriveAeadKey(encryptionKey);
+    final chachaIndexes = <int>[];
+    final chachaInputs = <MessageAeadBatchInput>[];
+    for (int i = 0; i < messages.length; i++) {
+      final message = messages[i];
+      final algorithmId = MessageAeadFFI.algorithmFromName(message['algorithm'] ?? '');
+      if (algorithmId == null) continue;
+      try {
+        final nonce = base64.decode(message['iv'] ?? '');
+        final ciphertext = base64.decode(message['encrypted_message'] ?? '');
+        if (algorithmId == messageAeadChaCha20Poly1305) {
+          chachaIndexes.add(i);
+          chachaInputs.add(MessageAeadBatchInput(nonce, ciphertext));
+        } else {
+          final plaintext = aead.open(algorithmId, nonce, ciphertext, key);
+          if (plaintext != null) results[i] = _tryDecode(() => utf8.decode(plaintext));
+        }
+      } catch (e) {
+        continue;
+      }
+    }
+
+    final opened = aead.openBatch(chachaInputs, key);
+    for (int i = 0; i < opened.length; i++) {
+      final plaintext = opened[i];
+      if (plaintext != null) results[chachaIndexes[i]] = _tryDecode(() => utf8.decode(plaintext));
+    }
+    key.fillRange(0, key.length, 0);
+    return results;
+  }
+
+  /// Key AEAD pesan untuk decrypt di native (NativeRealtimeClient, LazyMessageDecryptor).
+  /// Pemanggil wipe hasilnya setelah dipakai.
+  Uint8List messageAeadKey(String encryptionKey) => _deriveAeadKey(encryptionKey);
+
+  // Chat key (32 byte ASCII) tidak langsung dipakai sebagai key AEAD
+  Uint8List _deriveAeadKey(String encryptionKey) {
+    final keyBytes = base64.decode(encryptionKey);
+    final digest = sha256.convert([...keyBytes, ...utf8.encode('::message_aead_2024')]);
+    return Uint8List.fromList(digest.bytes);
+  }
+
+  /// Decrypt banyak pesan xor_with_iv dari chat yang sama sekaligus (mis. saat membuka history).
+  /// Hasil null untuk pesan yang gagal didecrypt.
+  Future<List<String?>> decryptMessagesBatch(List<Map<String, String>> messages, String encryptionKey) async {
+    final keyBytes = base64.decode(encryptionKey);
+    final inputs = <LegacyXorInput?>[];
+    for (final message in messages) {
+      try {
+        inputs.add(LegacyXorInput(
+          base64.decode(message['encrypted_message'] ?? ''),
+          base64.decode(message['iv'] ?? ''),
+        ));
+      } catch (e) {
+        inputs.add(null);
+      }
+    }
+
+    final native = LegacyDecoderFFI();
+    if (native.isAvailable) {
+      final valid = inputs.whereType<LegacyXorInput>().toList();
+      final decoded = native.decryptXorWithIvBatch(keyBytes, valid);
+      int next = 0;
+      return [for (final input in inputs) input == null ? null : decoded[next++]];
+    }
+
+    return [
+      for (final input in inputs)
+        if (input == null || input.iv.isEmpty)
+          null
+        else
+          _tryDecode(() => utf8.decode(_xorDecrypt(input.ciphertext, keyBytes, input.iv)))
+    ];
+  }
+
+  /// Decrypt satu pesan sesuai field 'algorithm'-nya: null atau xor_with_iv lewat
+  /// [decryptMessage], nama AEAD lewat [aeadDecryptMessage].
+  Future<String> decryptStoredMessage(String encryptedMessage, String iv, String encryptionKey,
+      {String? algorithm}) async {
+    if (isAeadAlgorithm(algorithm)) {
+      return aeadDecryptMessage(encryptedMessage, iv, encryptionKey, algorithm!);
+    }
+    return decryptMessage(encryptedMessage, iv, encryptionKey);
+  }
+
+  /// Versi batch [decryptStoredMessage] untuk history campuran: pesan dikelompokkan per
+  /// algoritma lalu masing-masing kelompok dibuka dalam satu call batch. Urutan hasil sama
+  /// dengan [messages]; null untuk pesan yang gagal didecrypt.
+  Future<List<String?>> decryptStoredMessagesBatch(
+      List<Map<String, String>> messages, String encryptionKey) async {
+    final xorIndexes = <int>[];
+    final aeadIndexes = <int>[];
+    for (int i = 0; i < messages.length; i++) {
+      (isAeadAlgorithm(messages[i]['algorithm']) ? aeadIndexes : xorIndexes).add(i);
+    }
+    if (aeadIndexes.isEmpty) return decryptMessagesBatch(messages, encryptionKey);
+
+    final results = List<String?>.filled(messages.length, null);
+    final aead = aeadDecryptMessagesBatch([for (final i in aeadIndexes) messages[i]], encryptionKey);
+    for (int j = 0; j < aeadIndexes.length; j++) {
+      results[aeadIndexes[j]] = aead[j];
+    }
+    if (xorIndexes.isNotEmpty) {
+      final xor = await decryptMessagesBatch([for (final i in xorIndexes) messages[i]], encryptionKey);
+      for (int j = 0; j < xorIndexes.length; j++) {
+        results[xorIndexes[j]] = xor[j];
+      }
+    }
+    return results;
+  }
+
+  /// True jika [algorithm] (kolom messages.algorithm) adalah salah satu algoritma AEAD
+  static bool isAeadAlgorithm(String? algorithm) =>
+      algorithm != null && MessageAeadFFI.algorithmFromName(algorithm) != null;
+
+  String? _tryDecode(String Function() decode) {
+    try {
+      return decode();
+    } catch (e) {
+      return null;
+    }
+  }
+
+  // Pakai decoder native (SIMD) jika tersedia, fallback ke implementasi Dart
+  String _decryptXorWithIv(Uint8List encryptedBytes, Uint8List keyBytes, Uint8List ivBytes) {
+    final native = LegacyDecoderFFI();
+    if (native.isAvailable) {
+      final decrypted = native.decryptXorWithIv(keyBytes, encryptedBytes, ivBytes);
+      if (decrypted == null) {
+        throw const FormatException('Invalid UTF-8 after xor_with_iv decryption');
+      }
+      return decrypted;
+    }
+    return utf8.decode(_xorDecrypt(encryptedBytes, keyBytes, ivBytes));
+  }
+
   List<int> _xorEncrypt(List<int> data, List<int> key, List<int> iv) {
     final result = List<int>.filled(data.length, 0);
     
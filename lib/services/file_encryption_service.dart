@@ -5,6 +5,9 @@ import 'dart:math';
 import 'package:crypto/crypto.dart';
 import 'package:flutter/foundation.dart';
 import 'package:path_provider/path_provider.dart';
+import 'blob_store_ffi.dart';
+import 'resumable_upload_service.dart';
+import 'upload_pipeline_ffi.dart';
 
 class FileEncryptionService {
   static final FileEncryptionService _instance = FileEncryptionService._internal();
@@ -106,6 +109,79 @@ class FileEncryptionService {
     }
   }
 
+  /// Encrypt sambil upload: worker native mengenkripsi segmen berikutnya selama segmen
+  /// sebelumnya dikirim lewat [transport], dan upload yang putus dilanjutkan dari offset
+  /// server. Format ciphertext/tag sama dengan [encryptFile]. Null jika native pipeline
+  /// tidak tersedia (pemanggil fallback ke encryptFile + upload biasa).
+  ///
+  /// Jika [cacheName] diisi (path storage), worker juga menulis ciphertext ke file
+  /// sementara yang setelah upload dipindah ke [BlobStoreFFI] dengan alias itu, sama
+  /// seperti upload biasa, jadi pengirim membuka attachment tanpa download ulang.
+  Future<StreamedFileUploadResult?> encryptAndUploadFile({
+    required File file,
+    required String encryptionKey,
+    required String chatId,
+    required String fileName,
+    required ChunkUploadTransport transport,
+    Map<String, String> metadata = const {},
+    int segmentSize = 6 * 1024 * 1024,
+    String? cacheName,
+    void Function(int sent, int total)? onProgress,
+  }) async {
+    final pipeline = UploadPipelineFFI();
+    if (!pipeline.isAvailable) return null;
+
+    String? cipherPath;
+    if (cacheName != null && BlobStoreFFI().isAvailable) {
+      final tempDir = await getTemporaryDirectory();
+      cipherPath = '${tempDir.path}/upload_${DateTime.now().microsecondsSinceEpoch}.enc';
+    }
+
+    final keys = _deriveKeysStandard(encryptionKey, chatId);
+    final nonce = _generateNonce();
+    final source = pipeline.open(
+      file: file,
+      chachaKey: keys['chacha_key']!,
+      nonce: nonce,
+      hmacKey: keys['hmac_key']!,
+      segmentSize: segmentSize,
+      cipherPath: cipherPath,
+    );
+
+    try {
+      final upload = await ResumableUploader(transport).upload(
+        source,
+        metadata: metadata,
+        onProgress: onProgress,
+      );
+
+      if (kDebugMode) {
+        debugPrint('✅ Streamed encrypted upload: ${upload.totalBytes} bytes, ${upload.resumes} resume(s)');
+      }
+
+      // Tag sudah selesai, jadi file ciphertext lengkap; tutup dulu sebelum dipindah
+      source.close();
+      if (cipherPath != null) {
+        await BlobStoreFFI().putFile(cipherPath, name: cacheName);
+      }
+
+      return StreamedFileUploadResult(
+        uploadUrl: upload.uploadUrl,
+        nonce: nonce,
+        authTag: upload.authTag,
+        fileName: fileName,
+        fileSize: upload.totalBytes,
+        mimeType: _getMimeType(fileName),
+      );
+    } finally {
+      source.close();
+      if (cipherPath != null) {
+        final leftover = File(cipherPath);
+        if (await leftover.exists()) await leftover.delete();
+      }
+    }
+  }
+
   /// Decrypt file dengan ChaCha20-Poly1305 + HMAC-SHA512 - FIXED
   Future<Uint8List> decryptFile({
     required Uint8List encryptedData,
@@ -484,6 +560,7 @@ class FileEncryptionService {
       'jpeg': 'image/jpeg',
       'png': 'image/png',
       'gif': 'image/gif',
+      'webp': 'image/webp',
       'pdf': 'application/pdf',
       'doc': 'application/msword',
       'docx': 'application/vnd.openxmlformats-officedocument.wordprocessingml.document',
@@ -702,6 +779,25 @@ Security Features:
   }
 }
 
+// Hasil encryptAndUploadFile: ciphertext sudah di server, hanya metadata yang tersisa
+class StreamedFileUploadResult {
+  final Uri uploadUrl;
+  final Uint8List nonce;
+  final Uint8List authTag;
+  final String fileName;
+  final int fileSize;
+  final String mimeType;
+
+  StreamedFileUploadResult({
+    required this.uploadUrl,
+    required this.nonce,
+    required this.authTag,
+    required this.fileName,
+    required this.fileSize,
+    required this.mimeType,
+  });
+}
+
 // Data model untuk encrypted file result
 class FileEncryptionResult {
   final Uint8List encryptedData;
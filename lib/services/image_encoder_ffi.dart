@@ -0,0 +1,114 @@
+// lib/services/image_encoder_ffi.dart
+import 'dart:ffi';
+import 'dart:typed_data';
+import 'package:ffi/ffi.dart';
+import 'native_library_loader.dart';
+
+// Konstanta dari native_libs/image_encoder.h
+const int _imageEncoderOk = 0;
+const int _imageContentGraphic = 1;
+const int _imageFormatAuto = 0;
+const int _imageFormatWebpLossless = 1;
+const int _imageFormatWebpLossy = 2;
+
+/// Mirror dari ImageEncodeResult di native_libs/image_encoder.h
+final class ImageEncodeResult extends Struct {
+  external Pointer<Uint8> data;
+
+  @Size()
+  external int length;
+
+  @Int32()
+  external int format;
+
+  @Int32()
+  external int content;
+}
+
+typedef _ImageEncodeNative = Int32 Function(
+    Pointer<Uint8>, Uint32, Uint32, Uint32, Int32, Int32, Pointer<ImageEncodeResult>);
+typedef _ImageEncodeDart = int Function(
+    Pointer<Uint8>, int, int, int, int, int, Pointer<ImageEncodeResult>);
+typedef _ImageEncodeFreeNative = Void Function(Pointer<ImageEncodeResult>);
+typedef _ImageEncodeFreeDart = void Function(Pointer<ImageEncodeResult>);
+typedef _SupportsLossyNative = Int32 Function();
+typedef _SupportsLossyDart = int Function();
+
+class NativeImageEncoding {
+  /// null jika format yang dipilih tidak didukung build native ini (foto tanpa libwebp).
+  final Uint8List? bytes;
+  final bool isGraphic;
+  final bool lossless;
+
+  NativeImageEncoding({required this.bytes, required this.isGraphic, required this.lossless});
+}
+
+/// Encoder WebP native untuk attachment gambar. Classifier native memilih lossless untuk
+/// screenshot/grafik dan lossy untuk foto.
+class ImageEncoderFFI {
+  static final ImageEncoderFFI _instance = ImageEncoderFFI._internal();
+  factory ImageEncoderFFI() => _instance;
+
+  _ImageEncodeDart? _encode;
+  _ImageEncodeFreeDart? _free;
+  bool _supportsLossy = false;
+
+  ImageEncoderFFI._internal() {
+    _initialize();
+  }
+
+  bool get isAvailable => _encode != null;
+
+  /// Foto bisa dikodekan WebP lossy (build native dengan libwebp). Jika false, foto
+  /// berakhir sebagai JPEG dan pemanggil bisa melewati konversi RGBA untuk sumber foto.
+  bool get supportsLossy => _supportsLossy;
+
+  void _initialize() {
+    final lib = loadNativeCryptoLibrary('image_encode', label: 'Native WebP image encoder');
+    if (lib == null) return;
+
+    try {
+      _encode = lib.lookupFunction<_ImageEncodeNative, _ImageEncodeDart>('image_encode');
+      _free = lib.lookupFunction<_ImageEncodeFreeNative, _ImageEncodeFreeDart>('image_encode_free');
+      _supportsLossy =
+          lib.lookupFunction<_SupportsLossyNative, _SupportsLossyDart>('image_encoder_supports_lossy')() != 0;
+    } catch (e) {
+      return;
+    }
+  }
+
+  /// Encode pixel RGBA (4 byte per pixel). [lossless] null = pilih otomatis dari isi gambar.
+  NativeImageEncoding? encodeRgba(Uint8List rgba, int width, int height,
+      {int quality = 80, bool? lossless}) {
+    final encode = _encode;
+    final free = _free;
+    if (encode == null || free == null) return null;
+    if (rgba.length < width * height * 4) {
+      throw ArgumentError('RGBA buffer too small for ${width}x$height');
+    }
+
+    final format = lossless == null ? _imageFormatAuto : (lossless ? _imageFormatWebpLossless : _imageFormatWebpLossy);
+
+    return using((arena) {
+      final pixels = arena<Uint8>(rgba.length);
+      pixels.asTypedList(rgba.length).setAll(0, rgba);
+      final result = arena<ImageEncodeResult>();
+
+      final status = encode(pixels, width, height, width * 4, format, quality, result);
+      final isGraphic = result.ref.content == _imageContentGraphic;
+      if (status != _imageEncoderOk) {
+        return NativeImageEncoding(bytes: null, isGraphic: isGraphic, lossless: false);
+      }
+
+      try {
+        return NativeImageEncoding(
+          bytes: Uint8List.fromList(result.ref.data.asTypedList(result.ref.length)),
+          isGraphic: isGraphic,
+          lossless: result.ref.format == _imageFormatWebpLossless,
+        );
+      } finally {
+        free(result);
+      }
+    });
+  }
+}
@@ -0,0 +1,194 @@
+// lib/services/keystream_pool_ffi.dart
+import 'dart:collection';
+import 'dart:ffi';
+import 'dart:math';
+import 'dart:typed_data';
+import 'package:ffi/ffi.dart';
+import 'package:flutter/scheduler.dart';
+import 'message_aead_ffi.dart';
+import 'native_library_loader.dart';
+
+// Dari native_libs/keystream_pool.h
+const int _poolNonceBytes = 12;
+const int _poolTagBytes = 16;
+const int _poolOk = 0;
+
+typedef _CreateNative = Pointer<Void> Function(Pointer<Uint8>, Uint32, Uint32);
+typedef _CreateDart = Pointer<Void> Function(Pointer<Uint8>, int, int);
+typedef _DestroyNative = Void Function(Pointer<Void>);
+typedef _DestroyDart = void Function(Pointer<Void>);
+typedef _RefillNative = Uint32 Function(Pointer<Void>, Pointer<Uint8>, Uint32);
+typedef _RefillDart = int Function(Pointer<Void>, Pointer<Uint8>, int);
+typedef _ReadyNative = Uint32 Function(Pointer<Void>);
+typedef _ReadyDart = int Function(Pointer<Void>);
+typedef _SealNative = Int32 Function(
+    Pointer<Void>, Pointer<Uint8>, Pointer<Uint8>, Pointer<Uint8>, Pointer<Uint8>, Size, Pointer<Uint8>, Size);
+typedef _SealDart = int Function(
+    Pointer<Void>, Pointer<Uint8>, Pointer<Uint8>, Pointer<Uint8>, Pointer<Uint8>, int, Pointer<Uint8>, int);
+
+/// Keystream ChaCha20-Poly1305 yang disiapkan saat idle untuk key chat aktif.
+/// Seal dari pool hanya XOR + Poly1305; hasilnya [MessageAeadBox] chacha20_poly1305 biasa
+/// sehingga penerima membuka lewat [MessageAeadFFI.open]. Slot sekali pakai dan diisi
+/// ulang lewat task scheduler berprioritas idle, bukan di jalur kirim.
+class KeystreamPoolFFI {
+  static final KeystreamPoolFFI _instance = KeystreamPoolFFI._internal();
+  factory KeystreamPoolFFI() => _instance;
+
+  static const int slotsPerKey = 8;
+  static const int slotBytes = 512;
+  static const int maxPools = 4;
+
+  _CreateDart? _create;
+  late final _DestroyDart _destroy;
+  late final _RefillDart _refill;
+  late final _ReadyDart _ready;
+  late final _SealDart _seal;
+
+  // Urutan = LRU, pool paling lama dibuang saat melebihi maxPools
+  final LinkedHashMap<String, Pointer<Void>> _pools = LinkedHashMap();
+  final Random _random = Random.secure();
+  bool _refillScheduled = false;
+
+  Pointer<Uint8> _scratch = nullptr;
+  int _scratchSize = 0;
+
+  KeystreamPoolFFI._internal() {
+    _initialize();
+  }
+
+  bool get isAvailable => _create != null;
+
+  void _initialize() {
+    final lib = loadNativeCryptoLibrary('keystream_pool_create', label: 'Native keystream pool');
+    if (lib == null) return;
+
+    try {
+      _destroy = lib.lookupFunction<_DestroyNative, _DestroyDart>('keystream_pool_destroy');
+      _refill = lib.lookupFunction<_RefillNative, _RefillDart>('keystream_pool_refill');
+      _ready = lib.lookupFunction<_ReadyNative, _ReadyDart>('keystream_pool_ready', isLeaf: true);
+      _seal = lib.lookupFunction<_SealNative, _SealDart>('keystream_pool_seal', isLeaf: true);
+      _create = lib.lookupFunction<_CreateNative, _CreateDart>('keystream_pool_create');
+    } catch (e) {
+      return;
+    }
+  }
+
+  bool contains(String id) => _pools.containsKey(id);
+
+  /// Siapkan pool untuk [id] dengan [key] 32 byte (key AEAD, bukan chat key mentah).
+  /// Pengisian slot dijadwalkan saat idle.
+  bool warm(String id, Uint8List key) {
+    final create = _create;
+    if (create == null || key.length != messageAeadKeyBytes) return false;
+
+    final existing = _pools.remove(id);
+    if (existing != null) {
+      _pools[id] = existing;
+      _scheduleRefill();
+      return true;
+    }
+
+    final pool = using((arena) {
+      final keyPtr = arena<Uint8>(messageAeadKeyBytes);
+      keyPtr.asTypedList(messageAeadKeyBytes).setAll(0, key);
+      final handle = create(keyPtr, slotsPerKey, slotBytes);
+      keyPtr.asTypedList(messageAeadKeyBytes).fillRange(0, messageAeadKeyBytes, 0);
+      return handle;
+    });
+    if (pool == nullptr) return false;
+
+    _pools[id] = pool;
+    while (_pools.length > maxPools) {
+      final oldest = _pools.keys.first;
+      _destroy(_pools.remove(oldest)!);
+    }
+    _scheduleRefill();
+    return true;
+  }
+
+  /// Seal memakai slot siap pakai. Null jika pool belum ada, kosong, atau pesan lebih
+  /// panjang dari [slotBytes]; caller fallback ke [MessageAeadFFI.seal].
+  MessageAeadBox? seal(String id, Uint8List plaintext, {Uint8List? aad}) {
+    final pool = _pools[id];
+    if (pool == null || plaintext.length > slotBytes) return null;
+
+    final length = plaintext.length;
+    final aadLength = aad?.length ?? 0;
+    final base = _ensureScratch(length + aadLength);
+    final noncePtr = base;
+    final tagPtr = noncePtr + _poolNonceBytes;
+    final inputPtr = tagPtr + _poolTagBytes;
+    final outputPtr = inputPtr + length;
+    final aadPtr = outputPtr + length;
+    inputPtr.asTypedList(length).setAll(0, plaintext);
+    if (aadLength > 0) aadPtr.asTypedList(aadLength).setAll(0, aad!);
+
+    try {
+      final status = _seal(pool, outputPtr, tagPtr, noncePtr, inputPtr, length, aadLength > 0 ? aadPtr : nullptr,
+          aadLength);
+      _scheduleRefill();
+      if (status != _poolOk) return null;
+
+      final ciphertext = Uint8List(length + _poolTagBytes)
+        ..setAll(0, outputPtr.asTypedList(length))
+        ..setAll(length, tagPtr.asTypedList(_poolTagBytes));
+      final nonce = Uint8List.fromList(noncePtr.asTypedList(_poolNonceBytes));
+      return MessageAeadBox(messageAeadChaCha20Poly1305, nonce, ciphertext);
+    } finally {
+      final used = _poolNonceBytes + _poolTagBytes + length * 2 + aadLength;
+      base.asTypedList(used).fillRange(0, used, 0);
+    }
+  }
+
+  // Layout scratch: nonce | tag | input | output | aad
+  Pointer<Uint8> _ensureScratch(int payloadLength) {
+    final needed = _poolNonceBytes + _poolTagBytes + payloadLength * 2;
+    if (needed > _scratchSize) {
+      if (_scratch != nullptr) calloc.free(_scratch);
+      _scratchSize = needed < 2048 ? 2048 : needed;
+      _scratch = calloc<Uint8>(_scratchSize);
+    }
+    return _scratch;
+  }
+
+  void _scheduleRefill() {
+    if (_refillScheduled || _pools.isEmpty) return;
+    _refillScheduled = true;
+    SchedulerBinding.instance.scheduleTask(_refillAll, Priority.idle);
+  }
+
+  void _refillAll() {
+    _refillScheduled = false;
+    if (_pools.isEmpty) return;
+
+    using((arena) {
+      final nonces = arena<Uint8>(slotsPerKey * _poolNonceBytes);
+      final view = nonces.asTypedList(slotsPerKey * _poolNonceBytes);
+      for (final pool in _pools.values) {
+        final missing = slotsPerKey - _ready(pool);
+        if (missing <= 0) continue;
+        for (int i = 0; i < missing * _poolNonceBytes; i++) {
+          view[i] = _random.nextInt(256);
+        }
+        _refill(pool, nonces, missing);
+      }
+    });
+  }
+
+  void drop(String id) {
+    final pool = _pools.remove(id);
+    if (pool != null) _destroy(pool);
+  }
+
+  void dispose() {
+    for (final pool in _pools.values) {
+      _destroy(pool);
+    }
+    _pools.clear();
+    if (_scratch != nullptr) {
+      calloc.free(_scratch);
+      _scratch = nullptr;
+      _scratchSize = 0;
+    }
+  }
+}
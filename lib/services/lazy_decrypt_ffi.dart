@@ -0,0 +1,239 @@
+// lib/services/lazy_decrypt_ffi.dart
+import 'dart:async';
+import 'dart:collection';
+import 'dart:convert';
+import 'dart:ffi';
+import 'dart:typed_data';
+import 'package:ffi/ffi.dart';
+import 'message_record_ffi.dart';
+import 'native_result_ring.dart';
+import 'native_library_loader.dart';
+
+// Status dari native_libs/lazy_decrypt.h
+const int _lazyReady = 0;
+const int _lazyErrorDecrypt = -2;
+const int _lazyBufferTooSmall = -3;
+const int _lazyRingFailedTag = 0x80000000;
+
+typedef _CreateNative = Pointer<Void> Function(Pointer<Uint8>, Size, Uint32, Uint32, Uint64);
+typedef _CreateDart = Pointer<Void> Function(Pointer<Uint8>, int, int, int, int);
+typedef _DestroyNative = Void Function(Pointer<Void>);
+typedef _DestroyDart = void Function(Pointer<Void>);
+typedef _RegisterRecordsNative = Int64 Function(Pointer<Void>, Pointer<Uint8>, Size);
+typedef _RegisterRecordsDart = int Function(Pointer<Void>, Pointer<Uint8>, int);
+typedef _SetAeadKeyNative = Int32 Function(Pointer<Void>, Pointer<Uint8>, Size);
+typedef _SetAeadKeyDart = int Function(Pointer<Void>, Pointer<Uint8>, int);
+typedef _RangeNative = Int32 Function(Pointer<Void>, Uint32, Uint32);
+typedef _RangeDart = int Function(Pointer<Void>, int, int);
+typedef _GetNative = Int32 Function(Pointer<Void>, Uint32, Pointer<Uint8>, Size, Pointer<Size>, Int32);
+typedef _GetDart = int Function(Pointer<Void>, int, Pointer<Uint8>, int, Pointer<Size>, int);
+typedef _AttachRingNative = Int32 Function(Pointer<Void>, Pointer<Void>);
+typedef _AttachRingDart = int Function(Pointer<Void>, Pointer<Void>);
+
+class _LazyDecryptBindings {
+  final _CreateDart create;
+  final _DestroyDart destroy;
+  final _RegisterRecordsDart registerRecords;
+  final _SetAeadKeyDart setAeadKey;
+  final _RangeDart requestRange;
+  final _GetDart get;
+  final _AttachRingDart? attachRing;
+
+  _LazyDecryptBindings(DynamicLibrary lib)
+      : create = lib.lookupFunction<_CreateNative, _CreateDart>('lazy_decrypt_create'),
+        destroy = lib.lookupFunction<_DestroyNative, _DestroyDart>('lazy_decrypt_destroy'),
+        registerRecords =
+            lib.lookupFunction<_RegisterRecordsNative, _RegisterRecordsDart>('lazy_decrypt_register_records'),
+        setAeadKey = lib.lookupFunction<_SetAeadKeyNative, _SetAeadKeyDart>('lazy_decrypt_set_aead_key'),
+        requestRange = lib.lookupFunction<_RangeNative, _RangeDart>('lazy_decrypt_request_range'),
+        get = lib.lookupFunction<_GetNative, _GetDart>('lazy_decrypt_get'),
+        attachRing = lib.providesSymbol('lazy_decrypt_attach_ring')
+            ? lib.lookupFunction<_AttachRingNative, _AttachRingDart>('lazy_decrypt_attach_ring')
+            : null;
+
+  static _LazyDecryptBindings? _cached;
+  static bool _loaded = false;
+
+  static _LazyDecryptBindings? load() {
+    if (_loaded) return _cached;
+    _loaded = true;
+    final lib = loadNativeCryptoLibrary('lazy_decrypt_create');
+    if (lib == null) return null;
+
+    try {
+      _cached = _LazyDecryptBindings(lib);
+      return _cached;
+    } catch (e) {
+      return null;
+    }
+  }
+}
+
+/// Decryptor lazy untuk satu chat. Row didaftarkan sebagai record [MessageRecordBuffer]
+/// (xor_with_iv atau AEAD, dipilih dari header record) tanpa didecrypt;
+/// ListView melaporkan range yang terlihat dan hanya row itu (plus prefetch) yang didecrypt.
+/// Hasil prefetch dialirkan lewat NativeResultRing, jadi row yang sudah siap tidak perlu
+/// satu panggilan lazy_decrypt_get per row. Jika [deliversAsync], [onReady] dipanggil sekali
+/// per batch ring (row siap atau gagal) supaya UI bisa memakai `messageAt(wait: false)`.
+class LazyMessageDecryptor {
+  final _LazyDecryptBindings _bindings;
+  Pointer<Void> _session;
+  Pointer<Uint8> _buffer;
+  int _bufferSize = 4096;
+  final Pointer<Size> _length = calloc<Size>();
+
+  NativeResultRing? _ring;
+  final LinkedHashMap<int, String> _delivered = LinkedHashMap<int, String>();
+  final Set<int> _failed = <int>{};
+  final int _deliveredLimit;
+  final void Function()? _onReady;
+  bool _readyScheduled = false;
+
+  LazyMessageDecryptor._(this._bindings, this._session, int prefetchRows, this._onReady)
+      : _buffer = calloc<Uint8>(4096),
+        _deliveredLimit = prefetchRows * 4 > 256 ? prefetchRows * 4 : 256;
+
+  static bool get isSupported => _LazyDecryptBindings.load() != null;
+
+  /// [key] = chat key (xor_with_iv), [aeadKey] = EncryptionService.messageAeadKey untuk
+  /// record AEAD. Return null jika library native tidak tersedia.
+  static LazyMessageDecryptor? create(Uint8List key,
+      {Uint8List? aeadKey, int prefetchRows = 64, int cacheBudgetBytes = 0, void Function()? onReady}) {
+    final bindings = _LazyDecryptBindings.load();
+    if (bindings == null) return null;
+
+    return using((arena) {
+      final keyPtr = arena<Uint8>(key.length);
+      final aeadKeyPtr = aeadKey == null ? nullptr : arena<Uint8>(aeadKey.length);
+      try {
+        keyPtr.asTypedList(key.length).setAll(0, key);
+        final session = bindings.create(keyPtr, key.length, 0, prefetchRows, cacheBudgetBytes);
+        if (session == nullptr) return null;
+        if (aeadKey != null) {
+          aeadKeyPtr.asTypedList(aeadKey.length).setAll(0, aeadKey);
+          if (bindings.setAeadKey(session, aeadKeyPtr, aeadKey.length) != _lazyReady) {
+            bindings.destroy(session);
+            return null;
+          }
+        }
+        return LazyMessageDecryptor._(bindings, session, prefetchRows, onReady).._attachRing();
+      } finally {
+        keyPtr.asTypedList(key.length).fillRange(0, key.length, 0);
+        if (aeadKey != null) aeadKeyPtr.asTypedList(aeadKey.length).fillRange(0, aeadKey.length, 0);
+      }
+    });
+  }
+
+  void _attachRing() {
+    final attach = _bindings.attachRing;
+    if (attach == null) return;
+
+    final ring = NativeResultRing.create(onRecord: _onPrefetched, wipeAfterRead: true);
+    if (ring == null) return;
+    if (attach(_session, ring.handle) != _lazyReady) {
+      ring.dispose();
+      return;
+    }
+    _ring = ring;
+  }
+
+  /// Row yang didecrypt worker akan sampai lewat ring (lalu [onReady]); tanpa ring
+  /// pemanggil harus memakai `messageAt(wait: true)`.
+  bool get deliversAsync => _ring != null;
+
+  void _onPrefetched(int tag, Uint8List plaintext) {
+    final index = tag & ~_lazyRingFailedTag;
+    final text = tag & _lazyRingFailedTag != 0 ? null : _decodeUtf8(plaintext);
+    if (text == null) {
+      _failed.add(index);
+    } else {
+      _delivered.remove(index);
+      _delivered[index] = text;
+      while (_delivered.length > _deliveredLimit) {
+        _delivered.remove(_delivered.keys.first);
+      }
+    }
+
+    // Satu notifikasi untuk semua record yang diantar satu doorbell
+    if (_onReady == null || _readyScheduled) return;
+    _readyScheduled = true;
+    scheduleMicrotask(() {
+      _readyScheduled = false;
+      if (_session != nullptr) _onReady!();
+    });
+  }
+
+  /// True jika row [index] sudah pasti gagal didecrypt (bukan sekadar belum siap).
+  bool isFailed(int index) => _failed.contains(index);
+
+  /// Daftarkan semua record di [records]; return index row record pertama
+  /// (record ke-i = index + i, sejajar dengan [MessageRecordBuffer.entries]).
+  int registerRecords(MessageRecordBuffer records) {
+    return using((arena) {
+      final length = records.lengthInBytes;
+      final data = arena<Uint8>(length == 0 ? 1 : length);
+      data.asTypedList(length).setAll(0, records.bytes);
+      final first = _bindings.registerRecords(_session, data, length);
+      if (first < 0) {
+        throw Exception('lazy_decrypt_register_records failed: $first');
+      }
+      return first;
+    });
+  }
+
+  void requestRange(int first, int last) {
+    if (_session == nullptr || first > last) return;
+    _bindings.requestRange(_session, first, last);
+  }
+
+  /// Plaintext row [index]. Dengan [wait] row yang belum siap langsung didecrypt.
+  /// Return null jika gagal didecrypt ([isFailed]) atau (tanpa wait) belum siap.
+  /// Hasil tidak disimpan di sini: pemanggil memanggil ulang setiap build, plaintext
+  /// dibaca dari cache native yang dibatasi budget.
+  String? messageAt(int index, {bool wait = true}) {
+    if (_session == nullptr || _failed.contains(index)) return null;
+
+    final delivered = _delivered.remove(index);
+    if (delivered != null) return delivered;
+
+    var status = _bindings.get(_session, index, _buffer, _bufferSize, _length, wait ? 1 : 0);
+    if (status == _lazyBufferTooSmall) {
+      calloc.free(_buffer);
+      _bufferSize = _length.value;
+      _buffer = calloc<Uint8>(_bufferSize);
+      status = _bindings.get(_session, index, _buffer, _bufferSize, _length, wait ? 1 : 0);
+    }
+    if (status == _lazyErrorDecrypt) _failed.add(index);
+    if (status != _lazyReady) return null;
+
+    final length = _length.value;
+    final text = _decodeUtf8(_buffer.asTypedList(length));
+    _buffer.asTypedList(length).fillRange(0, length, 0);
+    if (text == null) _failed.add(index);
+    return text;
+  }
+
+  // Native sudah menolak plaintext non-UTF-8 (ERROR_DECRYPT); ring dan get memakai
+  // decode strict yang sama, dan hasil yang tetap rusak dihitung sebagai row gagal
+  static String? _decodeUtf8(Uint8List bytes) {
+    try {
+      return utf8.decode(bytes);
+    } on FormatException {
+      return null;
+    }
+  }
+
+  void dispose() {
+    if (_session == nullptr) return;
+    // Session dulu: worker prefetch berhenti menulis sebelum ring dilepas
+    _bindings.destroy(_session);
+    _session = nullptr;
+    _ring?.dispose();
+    _ring = null;
+    _delivered.clear();
+    _failed.clear();
+    _buffer.asTypedList(_bufferSize).fillRange(0, _bufferSize, 0);
+    calloc.free(_buffer);
+    calloc.free(_length);
+  }
+}
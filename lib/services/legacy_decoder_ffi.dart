@@ -0,0 +1,122 @@
+// lib/services/legacy_decoder_ffi.dart
+import 'dart:convert';
+import 'dart:ffi';
+import 'dart:typed_data';
+import 'package:ffi/ffi.dart';
+import 'native_library_loader.dart';
+
+/// Mirror dari LegacyXorMessage di native_libs/legacy_formats.h
+final class LegacyXorMessage extends Struct {
+  external Pointer<Uint8> input;
+
+  external Pointer<Uint8> output;
+
+  @Size()
+  external int length;
+
+  external Pointer<Uint8> iv;
+
+  @Size()
+  external int ivLength;
+
+  @Int32()
+  external int status;
+}
+
+typedef _DecryptBatchNative = Size Function(Pointer<LegacyXorMessage>, Size, Pointer<Uint8>, Size);
+typedef _DecryptBatchDart = int Function(Pointer<LegacyXorMessage>, int, Pointer<Uint8>, int);
+
+class LegacyXorInput {
+  final Uint8List ciphertext;
+  final Uint8List iv;
+
+  LegacyXorInput(this.ciphertext, this.iv);
+}
+
+/// Decoder native untuk format pesan lama xor_with_iv (EncryptionService.encryptMessage).
+/// Keystream dibuat dengan SIMD dan banyak pesan didecrypt dalam satu call FFI.
+class LegacyDecoderFFI {
+  static final LegacyDecoderFFI _instance = LegacyDecoderFFI._internal();
+  factory LegacyDecoderFFI() => _instance;
+
+  _DecryptBatchDart? _decryptBatch;
+
+  LegacyDecoderFFI._internal() {
+    _initialize();
+  }
+
+  bool get isAvailable => _decryptBatch != null;
+
+  void _initialize() {
+    final lib = loadNativeCryptoLibrary('legacy_xor_with_iv_decrypt_batch', label: 'Native legacy xor_with_iv decoder');
+    if (lib == null) return;
+
+    try {
+      _decryptBatch = lib.lookupFunction<_DecryptBatchNative, _DecryptBatchDart>('legacy_xor_with_iv_decrypt_batch');
+    } catch (e) {
+      return;
+    }
+  }
+
+  /// Decrypt satu pesan. Return null jika hasil bukan UTF-8 valid (key atau IV salah).
+  String? decryptXorWithIv(Uint8List key, Uint8List ciphertext, Uint8List iv) {
+    return decryptXorWithIvBatch(key, [LegacyXorInput(ciphertext, iv)]).first;
+  }
+
+  /// Decrypt banyak pesan dengan chat key yang sama dalam satu call native.
+  /// Semua buffer ditaruh di satu arena sehingga tidak ada alokasi per pesan.
+  List<String?> decryptXorWithIvBatch(Uint8List key, List<LegacyXorInput> messages) {
+    final decryptBatch = _decryptBatch;
+    if (decryptBatch == null) {
+      throw Exception('Native legacy decoder unavailable');
+    }
+    if (messages.isEmpty) return const [];
+
+    return using((arena) {
+      int totalBytes = 0;
+      for (final message in messages) {
+        totalBytes += message.ciphertext.length + message.iv.length;
+      }
+
+      final keyPtr = arena<Uint8>(key.length);
+      keyPtr.asTypedList(key.length).setAll(0, key);
+      final data = arena<Uint8>(totalBytes == 0 ? 1 : totalBytes);
+      final structs = arena<LegacyXorMessage>(messages.length);
+
+      int offset = 0;
+      for (int i = 0; i < messages.length; i++) {
+        final message = messages[i];
+        final entry = (structs + i).ref;
+
+        final ivPtr = data + offset;
+        ivPtr.asTypedList(message.iv.length).setAll(0, message.iv);
+        offset += message.iv.length;
+
+        final textPtr = data + offset;
+        textPtr.asTypedList(message.ciphertext.length).setAll(0, message.ciphertext);
+        offset += message.ciphertext.length;
+
+        // Decrypt in-place: output menimpa ciphertext di arena
+        entry.input = textPtr;
+        entry.output = textPtr;
+        entry.length = message.ciphertext.length;
+        entry.iv = ivPtr;
+        entry.ivLength = message.iv.length;
+        entry.status = 0;
+      }
+
+      decryptBatch(structs, messages.length, keyPtr, key.length);
+
+      final results = List<String?>.filled(messages.length, null);
+      for (int i = 0; i < messages.length; i++) {
+        final entry = (structs + i).ref;
+        if (entry.status == 0) {
+          results[i] = utf8.decode(entry.output.asTypedList(entry.length));
+        }
+      }
+      keyPtr.asTypedList(key.length).fillRange(0, key.length, 0);
+      data.asTypedList(totalBytes == 0 ? 1 : totalBytes).fillRange(0, totalBytes == 0 ? 1 : totalBytes, 0);
+      return results;
+    });
+  }
+}
@@ -0,0 +1,321 @@
+// lib/services/message_aead_ffi.dart
+import 'dart:ffi';
+import 'dart:math';
+import 'dart:typed_data';
+import 'package:ffi/ffi.dart';
+import 'package:flutter/foundation.dart';
+import 'native_library_loader.dart';
+
+// Dari native_libs/message_aead.h
+const int messageAeadChaCha20Poly1305 = 1;
+const int messageAeadAscon128a = 2;
+const int messageAeadAes256Gcm = 3;
+const int messageAeadKeyBytes = 32;
+const int messageAeadTagBytes = 16;
+const int _messageAeadOk = 0;
+
+typedef _SelectNative = Int32 Function();
+typedef _SelectDart = int Function();
+typedef _NonceBytesNative = Uint32 Function(Int32);
+typedef _NonceBytesDart = int Function(int);
+typedef _SealNative = Int32 Function(Int32, Pointer<Uint8>, Pointer<Uint8>, Pointer<Uint8>, Size, Pointer<Uint8>,
+    Size, Pointer<Uint8>, Pointer<Uint8>, Size);
+typedef _SealDart = int Function(
+    int, Pointer<Uint8>, Pointer<Uint8>, Pointer<Uint8>, int, Pointer<Uint8>, int, Pointer<Uint8>, Pointer<Uint8>, int);
+typedef _OpenNative = Int32 Function(Int32, Pointer<Uint8>, Pointer<Uint8>, Size, Pointer<Uint8>, Pointer<Uint8>,
+    Size, Pointer<Uint8>, Pointer<Uint8>, Size);
+typedef _OpenDart = int Function(
+    int, Pointer<Uint8>, Pointer<Uint8>, int, Pointer<Uint8>, Pointer<Uint8>, int, Pointer<Uint8>, Pointer<Uint8>, int);
+typedef _OpenBatchNative = Size Function(Pointer<AeadBatchItem>, Size);
+typedef _OpenBatchDart = int Function(Pointer<AeadBatchItem>, int);
+
+/// Mirror dari AeadBatchItem di native_libs/aead_batch.h
+final class AeadBatchItem extends Struct {
+  external Pointer<Uint8> out;
+
+  external Pointer<Uint8> input;
+
+  @Uint32()
+  external int len;
+
+  external Pointer<Uint8> aad;
+
+  @Uint32()
+  external int aadLen;
+
+  external Pointer<Uint8> key;
+
+  external Pointer<Uint8> nonce;
+
+  external Pointer<Uint8> tag;
+
+  @Int32()
+  external int status;
+}
+
+/// Satu pesan ChaCha20-Poly1305 untuk [MessageAeadFFI.openBatch]; ciphertext termasuk tag.
+class MessageAeadBatchInput {
+  final Uint8List nonce;
+  final Uint8List ciphertext;
+
+  const MessageAeadBatchInput(this.nonce, this.ciphertext);
+}
+
+/// Hasil seal: ciphertext sudah termasuk tag 16 byte di akhir.
+class MessageAeadBox {
+  final int algorithm;
+  final Uint8List nonce;
+  final Uint8List ciphertext;
+
+  const MessageAeadBox(this.algorithm, this.nonce, this.ciphertext);
+}
+
+/// AEAD pesan pendek dengan algoritma dipilih native per device (cpu_features):
+/// ChaCha20-Poly1305 default, Ascon-128a di device low-end tanpa AES/SIMD.
+/// Seal/open adalah leaf call ke buffer scratch yang dipakai ulang, jadi pesan pendek
+/// tidak membayar alokasi native per panggilan.
+class MessageAeadFFI {
+  static final MessageAeadFFI _instance = MessageAeadFFI._internal();
+  factory MessageAeadFFI() => _instance;
+
+  _SealDart? _seal;
+  late final _OpenDart _open;
+  late final _NonceBytesDart _nonceBytes;
+  _OpenBatchDart? _openBatch;
+  int _algorithm = messageAeadChaCha20Poly1305;
+
+  final Random _random = Random.secure();
+  Pointer<Uint8> _scratch = nullptr;
+  int _scratchSize = 0;
+
+  MessageAeadFFI._internal() {
+    _initialize();
+  }
+
+  bool get isAvailable => _seal != null;
+
+  /// Algoritma yang dipakai device ini untuk pesan keluar
+  int get algorithm => _algorithm;
+
+  static String algorithmName(int algorithm) {
+    switch (algorithm) {
+      case messageAeadAscon128a:
+        return 'ascon128a';
+      case messageAeadAes256Gcm:
+        return 'aes256_gcm';
+    }
+    return 'chacha20_poly1305';
+  }
+
+  static int? algorithmFromName(String name) {
+    switch (name) {
+      case 'ascon128a':
+        return messageAeadAscon128a;
+      case 'chacha20_poly1305':
+        return messageAeadChaCha20Poly1305;
+      case 'aes256_gcm':
+        return messageAeadAes256Gcm;
+    }
+    return null;
+  }
+
+  void _initialize() {
+    final lib = loadNativeCryptoLibrary('message_aead_seal', label: 'Native message AEAD');
+    if (lib == null) return;
+
+    try {
+      _nonceBytes = lib.lookupFunction<_NonceBytesNative, _NonceBytesDart>('message_aead_nonce_bytes');
+      _open = lib.lookupFunction<_OpenNative, _OpenDart>('message_aead_open', isLeaf: true);
+      _algorithm = lib.lookupFunction<_SelectNative, _SelectDart>('message_aead_select')();
+      _seal = lib.lookupFunction<_SealNative, _SealDart>('message_aead_seal', isLeaf: true);
+      if (lib.providesSymbol('chacha20_poly1305_open_batch')) {
+        _openBatch =
+            lib.lookupFunction<_OpenBatchNative, _OpenBatchDart>('chacha20_poly1305_open_batch', isLeaf: true);
+      }
+      if (kDebugMode) {
+        debugPrint('   Message AEAD algorithm: ${algorithmName(_algorithm)}');
+      }
+    } catch (e) {
+      return;
+    }
+  }
+
+  // Layout scratch: key | nonce | tag | input | output
+  Pointer<Uint8> _ensureScratch(int payloadLength) {
+    final needed = messageAeadKeyBytes + 16 + messageAeadTagBytes + payloadLength * 2;
+    if (needed > _scratchSize) {
+      if (_scratch != nullptr) {
+        _scratch.asTypedList(_scratchSize).fillRange(0, _scratchSize, 0);
+        calloc.free(_scratch);
+      }
+      _scratchSize = needed < 4096 ? 4096 : needed;
+      _scratch = calloc<Uint8>(_scratchSize);
+    }
+    return _scratch;
+  }
+
+  void _wipeScratch(int payloadLength) {
+    final used = messageAeadKeyBytes + 16 + messageAeadTagBytes + payloadLength * 2;
+    _scratch.asTypedList(used).fillRange(0, used, 0);
+  }
+
+  /// [key] harus 32 byte. Return null jika native tidak tersedia atau gagal.
+  MessageAeadBox? seal(Uint8List plaintext, Uint8List key, {Uint8List? aad, int? algorithm}) {
+    final seal = _seal;
+    if (seal == null || key.length != messageAeadKeyBytes) return null;
+
+    final alg = algorithm ?? _algorithm;
+    final nonceLength = _nonceBytes(alg);
+    if (nonceLength == 0) return null;
+    final nonce = Uint8List(nonceLength);
+    for (int i = 0; i < nonceLength; i++) {
+      nonce[i] = _random.nextInt(256);
+    }
+
+    final length = plaintext.length;
+    final base = _ensureScratch(length);
+    final keyPtr = base;
+    final noncePtr = base + messageAeadKeyBytes;
+    final tagPtr = noncePtr + 16;
+    final inputPtr = tagPtr + messageAeadTagBytes;
+    final outputPtr = inputPtr + length;
+    keyPtr.asTypedList(messageAeadKeyBytes).setAll(0, key);
+    noncePtr.asTypedList(nonceLength).setAll(0, nonce);
+    inputPtr.asTypedList(length).setAll(0, plaintext);
+
+    try {
+      return using((arena) {
+        Pointer<Uint8> aadPtr = nullptr;
+        if (aad != null && aad.isNotEmpty) {
+          aadPtr = arena<Uint8>(aad.length);
+          aadPtr.asTypedList(aad.length).setAll(0, aad);
+        }
+        final status =
+            seal(alg, outputPtr, tagPtr, inputPtr, length, aadPtr, aad?.length ?? 0, keyPtr, noncePtr, nonceLength);
+        if (status != _messageAeadOk) return null;
+
+        final ciphertext = Uint8List(length + messageAeadTagBytes)
+          ..setAll(0, outputPtr.asTypedList(length))
+          ..setAll(length, tagPtr.asTypedList(messageAeadTagBytes));
+        return MessageAeadBox(alg, nonce, ciphertext);
+      });
+    } finally {
+      _wipeScratch(length);
+    }
+  }
+
+  /// [ciphertext] termasuk tag di akhir. Return null jika tag tidak valid.
+  Uint8List? open(int algorithm, Uint8List nonce, Uint8List ciphertext, Uint8List key, {Uint8List? aad}) {
+    if (_seal == null || key.length != messageAeadKeyBytes) return null;
+    if (ciphertext.length < messageAeadTagBytes || nonce.length > 16) return null;
+
+    final length = ciphertext.length - messageAeadTagBytes;
+    final base = _ensureScratch(length);
+    final keyPtr = base;
+    final noncePtr = base + messageAeadKeyBytes;
+    final tagPtr = noncePtr + 16;
+    final inputPtr = tagPtr + messageAeadTagBytes;
+    final outputPtr = inputPtr + length;
+    keyPtr.asTypedList(messageAeadKeyBytes).setAll(0, key);
+    noncePtr.asTypedList(nonce.length).setAll(0, nonce);
+    tagPtr.asTypedList(messageAeadTagBytes).setAll(0, Uint8List.sublistView(ciphertext, length));
+    inputPtr.asTypedList(length).setAll(0, Uint8List.sublistView(ciphertext, 0, length));
+
+    try {
+      return using((arena) {
+        Pointer<Uint8> aadPtr = nullptr;
+        if (aad != null && aad.isNotEmpty) {
+          aadPtr = arena<Uint8>(aad.length);
+          aadPtr.asTypedList(aad.length).setAll(0, aad);
+        }
+        final status = _open(
+            algorithm, outputPtr, inputPtr, length, tagPtr, aadPtr, aad?.length ?? 0, keyPtr, noncePtr, nonce.length);
+        if (status != _messageAeadOk) return null;
+        return Uint8List.fromList(outputPtr.asTypedList(length));
+      });
+    } finally {
+      _wipeScratch(length);
+    }
+  }
+
+  /// Open banyak pesan ChaCha20-Poly1305 dengan key yang sama dalam satu call native
+  /// multi-buffer (satu lane SIMD per pesan). Hasil null untuk pesan yang tag-nya tidak
+  /// valid; tanpa kernel batch, fallback ke [open] per pesan.
+  List<Uint8List?> openBatch(List<MessageAeadBatchInput> inputs, Uint8List key, {Uint8List? aad}) {
+    if (_seal == null || key.length != messageAeadKeyBytes || inputs.isEmpty) {
+      return List<Uint8List?>.filled(inputs.length, null);
+    }
+    final openBatch = _openBatch;
+    if (openBatch == null) {
+      return [
+        for (final input in inputs) open(messageAeadChaCha20Poly1305, input.nonce, input.ciphertext, key, aad: aad)
+      ];
+    }
+
+    return using((arena) {
+      int totalBytes = 0;
+      for (final input in inputs) {
+        totalBytes += input.ciphertext.length * 2 + 12;
+      }
+      final keyPtr = arena<Uint8>(messageAeadKeyBytes);
+      keyPtr.asTypedList(messageAeadKeyBytes).setAll(0, key);
+      Pointer<Uint8> aadPtr = nullptr;
+      if (aad != null && aad.isNotEmpty) {
+        aadPtr = arena<Uint8>(aad.length);
+        aadPtr.asTypedList(aad.length).setAll(0, aad);
+      }
+      final data = arena<Uint8>(totalBytes == 0 ? 1 : totalBytes);
+      final items = arena<AeadBatchItem>(inputs.length);
+
+      // Layout per pesan: nonce | ciphertext | tag | plaintext
+      int offset = 0;
+      final valid = List<bool>.filled(inputs.length, false);
+      for (int i = 0; i < inputs.length; i++) {
+        final input = inputs[i];
+        final item = (items + i).ref;
+        final length = input.ciphertext.length - messageAeadTagBytes;
+        if (length < 0 || input.nonce.length != 12) {
+          // Pointer null membuat native menandai item ini INVALID_INPUT
+          item
+            ..key = nullptr
+            ..len = 0
+            ..aadLen = 0
+            ..status = 0;
+          continue;
+        }
+        valid[i] = true;
+
+        final noncePtr = data + offset;
+        noncePtr.asTypedList(12).setAll(0, input.nonce);
+        final inputPtr = noncePtr + 12;
+        inputPtr.asTypedList(input.ciphertext.length).setAll(0, input.ciphertext);
+        final outputPtr = inputPtr + input.ciphertext.length;
+        offset += 12 + input.ciphertext.length * 2;
+
+        item
+          ..out = outputPtr
+          ..input = inputPtr
+          ..len = length
+          ..aad = aadPtr
+          ..aadLen = aad?.length ?? 0
+          ..key = keyPtr
+          ..nonce = noncePtr
+          ..tag = inputPtr + length
+          ..status = 0;
+      }
+
+      openBatch(items, inputs.length);
+
+      final results = List<Uint8List?>.filled(inputs.length, null);
+      for (int i = 0; i < inputs.length; i++) {
+        final item = (items + i).ref;
+        if (valid[i] && item.status == _messageAeadOk) {
+          results[i] = Uint8List.fromList(item.out.asTypedList(item.len));
+        }
+      }
+      keyPtr.asTypedList(messageAeadKeyBytes).fillRange(0, messageAeadKeyBytes, 0);
+      data.asTypedList(totalBytes == 0 ? 1 : totalBytes).fillRange(0, totalBytes == 0 ? 1 : totalBytes, 0);
+      return results;
+    });
+  }
+}
@@ -0,0 +1,345 @@
+// lib/services/message_record_ffi.dart
+import 'dart:convert';
+import 'dart:ffi';
+import 'dart:typed_data';
+import 'package:ffi/ffi.dart';
+import 'package:flutter/foundation.dart';
+import 'message_aead_ffi.dart';
+import 'native_library_loader.dart';
+
+// Dari native_libs/message_record.h
+const int messageRecordAlgXorWithIv = 0;
+const int _messageRecordFlagTextId = 0x01;
+const int _messageRecordFlagTextSender = 0x02;
+const int _messageRecordUuidBytes = 16;
+const int _messageRecordMaxNonceBytes = 24;
+
+/// Mirror dari MessageRecordHeader di native_libs/message_record.h (80 byte)
+final class MessageRecordHeader extends Struct {
+  @Uint32()
+  external int magic;
+
+  @Uint32()
+  external int recordLen;
+
+  @Uint8()
+  external int version;
+
+  @Uint8()
+  external int algorithm;
+
+  @Uint8()
+  external int nonceLen;
+
+  @Uint8()
+  external int flags;
+
+  @Uint32()
+  external int reserved;
+
+  @Int64()
+  external int createdAtUs;
+
+  @Array(16)
+  external Array<Uint8> id;
+
+  @Array(16)
+  external Array<Uint8> sender;
+
+  @Array(24)
+  external Array<Uint8> nonce;
+}
+
+final class MessageRecordView extends Struct {
+  external Pointer<MessageRecordHeader> header;
+
+  external Pointer<Uint8> idText;
+
+  @Uint32()
+  external int idTextLen;
+
+  external Pointer<Uint8> senderText;
+
+  @Uint32()
+  external int senderTextLen;
+
+  external Pointer<Uint8> ciphertext;
+
+  @Uint32()
+  external int ciphertextLen;
+}
+
+typedef _SizeNative = Uint32 Function(Uint8, Uint32, Uint32, Uint32);
+typedef _SizeDart = int Function(int, int, int, int);
+typedef _WriteNative = Uint32 Function(Pointer<Uint8>, Size, Pointer<MessageRecordHeader>, Pointer<Uint8>, Uint32,
+    Pointer<Uint8>, Uint32, Pointer<Uint8>, Uint32);
+typedef _WriteDart = int Function(
+    Pointer<Uint8>, int, Pointer<MessageRecordHeader>, Pointer<Uint8>, int, Pointer<Uint8>, int, Pointer<Uint8>, int);
+typedef _IndexNative = Int32 Function(Pointer<Uint8>, Size, Pointer<MessageRecordView>, Uint32);
+typedef _IndexDart = int Function(Pointer<Uint8>, int, Pointer<MessageRecordView>, int);
+
+class _MessageRecordBindings {
+  final _SizeDart size;
+  final _WriteDart write;
+  final _IndexDart index;
+
+  _MessageRecordBindings(DynamicLibrary lib)
+      : size = lib.lookupFunction<_SizeNative, _SizeDart>('message_record_size', isLeaf: true),
+        write = lib.lookupFunction<_WriteNative, _WriteDart>('message_record_write', isLeaf: true),
+        index = lib.lookupFunction<_IndexNative, _IndexDart>('message_record_index', isLeaf: true);
+
+  static _MessageRecordBindings? _cached;
+  static bool _loaded = false;
+
+  static _MessageRecordBindings? load() {
+    if (_loaded) return _cached;
+    _loaded = true;
+    final lib = loadNativeCryptoLibrary('message_record_write', label: 'Native message records');
+    if (lib == null) return null;
+
+    try {
+      _cached = _MessageRecordBindings(lib);
+      return _cached;
+    } catch (e) {
+      return null;
+    }
+  }
+}
+
+/// Satu record di dalam [MessageRecordBuffer]. Field dibaca langsung dari memori native
+/// lewat struct view; hanya valid selama buffer belum di-append/dispose.
+class MessageRecordEntry {
+  final MessageRecordView _view;
+
+  MessageRecordEntry._(this._view);
+
+  MessageRecordHeader get header => _view.header.ref;
+
+  int get algorithm => header.algorithm;
+
+  String get id => _view.idText == nullptr
+      ? _formatUuid(header.id)
+      : utf8.decode(_view.idText.asTypedList(_view.idTextLen));
+
+  String get senderId => _view.senderText == nullptr
+      ? _formatUuid(header.sender)
+      : utf8.decode(_view.senderText.asTypedList(_view.senderTextLen));
+
+  /// Format sama dengan timestamptz dari PostgREST, supaya bisa dibandingkan sebagai string
+  /// dengan created_at pesan realtime
+  String get createdAt => formatRecordTimestamp(header.createdAtUs);
+
+  /// View tanpa salinan ke ciphertext (AEAD: termasuk tag)
+  Uint8List get ciphertext => _view.ciphertext.asTypedList(_view.ciphertextLen);
+}
+
+/// Buffer record pesan terenkripsi dalam format biner native_libs/message_record.h.
+/// Baris dari server di-decode (base64, UUID, timestamp) sekali saat [appendRow]; setelah
+/// itu lazy decrypt, store lokal dan IPC memakai byte yang sama ([bytes]) tanpa Map.
+class MessageRecordBuffer {
+  final _MessageRecordBindings _bindings;
+  Pointer<Uint8> _data;
+  int _capacity;
+  int _length = 0;
+  int _count = 0;
+  Pointer<MessageRecordView> _views = nullptr;
+  int _viewsCount = -1;
+
+  MessageRecordBuffer._(this._bindings, this._data, this._capacity);
+
+  /// Return null jika library native tidak tersedia
+  static MessageRecordBuffer? create({int initialCapacity = 64 * 1024}) {
+    final bindings = _MessageRecordBindings.load();
+    if (bindings == null) return null;
+    final capacity = initialCapacity < 256 ? 256 : initialCapacity;
+    return MessageRecordBuffer._(bindings, calloc<Uint8>(capacity), capacity);
+  }
+
+  /// Konversi baris messages dari server sekali di batas jaringan. Baris yang tidak bisa
+  /// di-decode dilewati (id record tetap ikut, jadi tidak perlu sejajar dengan [rows]).
+  static MessageRecordBuffer? fromRows(List<Map<String, dynamic>> rows) {
+    final buffer = create();
+    if (buffer == null) return null;
+    for (final row in rows) {
+      if (!buffer.appendRow(row) && kDebugMode) {
+        debugPrint('⚠️ Skipping undecodable message row: ${row['id']}');
+      }
+    }
+    return buffer;
+  }
+
+  /// Salin byte record dari store lokal/IPC ke memori native dan validasi.
+  /// Return null jika native tidak tersedia atau [bytes] bukan rangkaian record yang valid.
+  static MessageRecordBuffer? adopt(Uint8List bytes) {
+    final buffer = create(initialCapacity: bytes.length);
+    if (buffer == null) return null;
+    buffer._data.asTypedList(bytes.length).setAll(0, bytes);
+    final count = buffer._bindings.index(buffer._data, bytes.length, nullptr, 0);
+    if (count < 0) {
+      buffer.dispose();
+      return null;
+    }
+    buffer._length = bytes.length;
+    buffer._count = count;
+    return buffer;
+  }
+
+  int get count => _count;
+
+  int get lengthInBytes => _length;
+
+  /// View tanpa salinan ke seluruh record, untuk ditulis ke store lokal atau dikirim lewat IPC
+  Uint8List get bytes => _data.asTypedList(_length);
+
+  void _ensureCapacity(int needed) {
+    if (_length + needed <= _capacity) return;
+    int capacity = _capacity * 2;
+    while (capacity < _length + needed) {
+      capacity *= 2;
+    }
+    final data = calloc<Uint8>(capacity);
+    data.asTypedList(_length).setAll(0, _data.asTypedList(_length));
+    _data.asTypedList(_capacity).fillRange(0, _capacity, 0);
+    calloc.free(_data);
+    _data = data;
+    _capacity = capacity;
+  }
+
+  /// Tambah satu record. [algorithm] = [messageRecordAlgXorWithIv] atau id MESSAGE_AEAD_*.
+  bool append({
+    required String id,
+    required String senderId,
+    required int createdAtUs,
+    required int algorithm,
+    required Uint8List nonce,
+    required Uint8List ciphertext,
+  }) {
+    if (nonce.length > _messageRecordMaxNonceBytes) return false;
+    final idUuid = _parseUuid(id);
+    final senderUuid = _parseUuid(senderId);
+    final idText = idUuid == null ? utf8.encode(id) : null;
+    final senderText = senderUuid == null ? utf8.encode(senderId) : null;
+    final flags = (idText != null ? _messageRecordFlagTextId : 0) | (senderText != null ? _messageRecordFlagTextSender : 0);
+
+    final size = _bindings.size(flags, idText?.length ?? 0, senderText?.length ?? 0, ciphertext.length);
+    if (size == 0) return false;
+    _ensureCapacity(size);
+
+    return using((arena) {
+      // Header diisi langsung di posisi record; write melengkapi magic/version/panjang
+      final headerPtr = (_data + _length).cast<MessageRecordHeader>();
+      final header = headerPtr.ref
+        ..algorithm = algorithm
+        ..nonceLen = nonce.length
+        ..flags = flags
+        ..reserved = 0
+        ..createdAtUs = createdAtUs;
+      for (int i = 0; i < _messageRecordUuidBytes; i++) {
+        header.id[i] = idUuid?[i] ?? 0;
+        header.sender[i] = senderUuid?[i] ?? 0;
+      }
+      for (int i = 0; i < _messageRecordMaxNonceBytes; i++) {
+        header.nonce[i] = i < nonce.length ? nonce[i] : 0;
+      }
+
+      Pointer<Uint8> copy(List<int>? bytes) {
+        if (bytes == null || bytes.isEmpty) return nullptr;
+        final ptr = arena<Uint8>(bytes.length);
+        ptr.asTypedList(bytes.length).setAll(0, bytes);
+        return ptr;
+      }
+
+      final written = _bindings.write(_data + _length, _capacity - _length, headerPtr, copy(idText),
+          idText?.length ?? 0, copy(senderText), senderText?.length ?? 0, copy(ciphertext), ciphertext.length);
+      if (written == 0) return false;
+      _length += written;
+      _count++;
+      _viewsCount = -1;
+      return true;
+    });
+  }
+
+  /// Baris tabel messages (encrypted_message/iv base64, created_at ISO-8601). Return false
+  /// jika baris tidak bisa di-decode; baris itu dilewati.
+  bool appendRow(Map<String, dynamic> row) {
+    try {
+      final algorithmName = row['algorithm'] as String?;
+      final algorithm = algorithmName == null
+          ? messageRecordAlgXorWithIv
+          : MessageAeadFFI.algorithmFromName(algorithmName) ?? messageRecordAlgXorWithIv;
+      return append(
+        id: row['id'].toString(),
+        senderId: row['sender_id'].toString(),
+        createdAtUs: DateTime.parse(row['created_at'] as String).microsecondsSinceEpoch,
+        algorithm: algorithm,
+        nonce: base64.decode(row['iv'] as String),
+        ciphertext: base64.decode(row['encrypted_message'] as String),
+      );
+    } catch (e) {
+      return false;
+    }
+  }
+
+  /// Record sebagai struct view di atas buffer native (tanpa salinan)
+  List<MessageRecordEntry> entries() {
+    if (_viewsCount != _count) {
+      if (_views != nullptr) calloc.free(_views);
+      _views = calloc<MessageRecordView>(_count == 0 ? 1 : _count);
+      _bindings.index(_data, _length, _views, _count);
+      _viewsCount = _count;
+    }
+    return [for (int i = 0; i < _count; i++) MessageRecordEntry._(_views[i])];
+  }
+
+  void dispose() {
+    if (_data != nullptr) {
+      _data.asTypedList(_capacity).fillRange(0, _capacity, 0);
+      calloc.free(_data);
+      _data = nullptr;
+    }
+    if (_views != nullptr) {
+      calloc.free(_views);
+      _views = nullptr;
+    }
+    _length = 0;
+    _count = 0;
+  }
+}
+
+/// UUID kanonik (huruf kecil, dengan tanda hubung) saja yang disimpan biner, supaya
+/// [MessageRecordEntry.id] mengembalikan string yang persis sama.
+Uint8List? _parseUuid(String value) {
+  if (value.length != 36) return null;
+  final hex = value.replaceAll('-', '');
+  if (hex.length != 32) return null;
+  final bytes = Uint8List(_messageRecordUuidBytes);
+  for (int i = 0; i < _messageRecordUuidBytes; i++) {
+    final byte = int.tryParse(hex.substring(2 * i, 2 * i + 2), radix: 16);
+    if (byte == null) return null;
+    bytes[i] = byte;
+  }
+  return _formatUuidBytes(bytes) == value ? bytes : null;
+}
+
+String _formatUuidBytes(List<int> bytes) {
+  final hex = StringBuffer();
+  for (int i = 0; i < bytes.length; i++) {
+    if (i == 4 || i == 6 || i == 8 || i == 10) hex.write('-');
+    hex.write(bytes[i].toRadixString(16).padLeft(2, '0'));
+  }
+  return hex.toString();
+}
+
+String _formatUuid(Array<Uint8> bytes) =>
+    _formatUuidBytes([for (int i = 0; i < _messageRecordUuidBytes; i++) bytes[i]]);
+
+/// created_at (mikrodetik UTC) ke format timestamptz PostgREST, mis.
+/// 2024-05-01T10:00:00.12345+00:00 (pecahan detik tanpa nol di belakang)
+String formatRecordTimestamp(int createdAtUs) {
+  final time = DateTime.fromMicrosecondsSinceEpoch(createdAtUs, isUtc: true);
+  String two(int v) => v.toString().padLeft(2, '0');
+  final base = '${time.year.toString().padLeft(4, '0')}-${two(time.month)}-${two(time.day)}'
+      'T${two(time.hour)}:${two(time.minute)}:${two(time.second)}';
+  final fraction = (createdAtUs % 1000000).toString().padLeft(6, '0').replaceFirst(RegExp(r'0+$'), '');
+  return fraction.isEmpty ? '$base+00:00' : '$base.$fraction+00:00';
+}
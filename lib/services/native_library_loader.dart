@@ -0,0 +1,35 @@
+// lib/services/native_library_loader.dart
+import 'dart:ffi';
+import 'dart:io';
+import 'package:flutter/foundation.dart';
+
+/// Nama file library crypto native (target `argon2` di native_libs/CMakeLists.txt)
+/// per platform, urut sesuai prioritas. Kosong di web dan platform tanpa build native.
+List<String> nativeCryptoLibraryCandidates() {
+  if (kIsWeb) return const [];
+  if (Platform.isWindows) {
+    return const ['argon2.dll', 'libargon2.dll', 'native/argon2.dll', 'windows/argon2.dll', '../argon2.dll'];
+  }
+  if (Platform.isMacOS) return const ['libargon2.dylib'];
+  if (Platform.isLinux || Platform.isAndroid) return const ['libargon2.so'];
+  return const [];
+}
+
+/// Buka library crypto native pertama yang menyediakan [requiredSymbol].
+/// Return null jika tidak ada (web, platform lain, atau build lama tanpa simbol itu);
+/// pemanggil lalu memakai fallback Dart. [label] dicetak di debug log saat berhasil.
+DynamicLibrary? loadNativeCryptoLibrary(String requiredSymbol, {String? label}) {
+  for (final path in nativeCryptoLibraryCandidates()) {
+    try {
+      final lib = DynamicLibrary.open(path);
+      if (!lib.providesSymbol(requiredSymbol)) continue;
+      if (kDebugMode && label != null) {
+        debugPrint('🚀 $label loaded from: $path');
+      }
+      return lib;
+    } catch (e) {
+      continue;
+    }
+  }
+  return null;
+}
@@ -0,0 +1,137 @@
+// lib/services/native_metrics_ffi.dart
+import 'dart:ffi';
+import 'package:ffi/ffi.dart';
+import 'native_library_loader.dart';
+
+// Dari native_libs/native_metrics.h
+const int _subsystemCount = 5;
+const List<String> nativeMetricsSubsystems = ['kdf', 'cipher', 'stego', 'file_io', 'cache'];
+
+/// Mirror dari NativeMetricsSubsystemSnapshot di native_libs/native_metrics.h
+final class _SubsystemSnapshot extends Struct {
+  @Uint64()
+  external int operations;
+
+  @Uint64()
+  external int errors;
+
+  @Uint64()
+  external int bytes;
+
+  @Uint64()
+  external int totalNs;
+
+  @Uint64()
+  external int maxNs;
+
+  @Uint64()
+  external int p50Ns;
+
+  @Uint64()
+  external int p90Ns;
+
+  @Uint64()
+  external int p99Ns;
+
+  @Uint64()
+  external int p999Ns;
+}
+
+/// Mirror dari NativeMetricsSnapshot di native_libs/native_metrics.h
+final class _Snapshot extends Struct {
+  @Array(_subsystemCount)
+  external Array<_SubsystemSnapshot> subsystems;
+
+  @Uint32()
+  external int threadCount;
+
+  @Uint32()
+  external int enabled;
+}
+
+typedef _SnapshotNative = Int32 Function(Pointer<_Snapshot>);
+typedef _SnapshotDart = int Function(Pointer<_Snapshot>);
+typedef _FormatNative = Size Function(Pointer<Utf8>, Size);
+typedef _FormatDart = int Function(Pointer<Utf8>, int);
+
+/// Latency satu subsystem native; durasi dalam mikrodetik supaya mudah ditampilkan
+class NativeSubsystemMetrics {
+  final String name;
+  final int operations;
+  final int errors;
+  final int bytes;
+  final double meanUs;
+  final double p50Us;
+  final double p99Us;
+  final double maxUs;
+
+  NativeSubsystemMetrics._(this.name, _SubsystemSnapshot s)
+      : operations = s.operations,
+        errors = s.errors,
+        bytes = s.bytes,
+        meanUs = s.operations == 0 ? 0 : s.totalNs / s.operations / 1000,
+        p50Us = s.p50Ns / 1000,
+        p99Us = s.p99Ns / 1000,
+        maxUs = s.maxNs / 1000;
+}
+
+/// Read-out histogram latency native_metrics dari library crypto (KDF, cipher, file I/O,
+/// cache). Library steganography native di-link ke library ini, jadi latency stego
+/// tercatat di instance yang sama (STEGANOGRAPHY_NATIVE_METRICS, default ON).
+class NativeMetricsFFI {
+  static final NativeMetricsFFI _instance = NativeMetricsFFI._internal();
+  factory NativeMetricsFFI() => _instance;
+
+  _SnapshotDart? _snapshot;
+  _FormatDart? _formatPrometheus;
+
+  NativeMetricsFFI._internal() {
+    _initialize();
+  }
+
+  bool get isAvailable => _snapshot != null;
+
+  void _initialize() {
+    final lib = loadNativeCryptoLibrary('native_metrics_snapshot', label: 'Native metrics');
+    if (lib == null) return;
+
+    try {
+      _snapshot = lib.lookupFunction<_SnapshotNative, _SnapshotDart>('native_metrics_snapshot');
+      _formatPrometheus = lib.lookupFunction<_FormatNative, _FormatDart>('native_metrics_format_prometheus');
+    } catch (e) {
+      _snapshot = null;
+      return;
+    }
+  }
+
+  /// Gabungan semua thread saat ini; subsystem tanpa operasi dilewati.
+  /// Kosong jika library native tidak tersedia.
+  List<NativeSubsystemMetrics> snapshot() {
+    final snapshot = _snapshot;
+    if (snapshot == null) return const [];
+
+    return using((arena) {
+      final out = arena<_Snapshot>();
+      if (snapshot(out) != 0) return const <NativeSubsystemMetrics>[];
+      return [
+        for (int i = 0; i < _subsystemCount; i++)
+          if (out.ref.subsystems[i].operations > 0)
+            NativeSubsystemMetrics._(nativeMetricsSubsystems[i], out.ref.subsystems[i])
+      ];
+    });
+  }
+
+  /// Teks Prometheus exposition, mis. untuk disalin dari layar diagnostics
+  String? formatPrometheus() {
+    final format = _formatPrometheus;
+    if (format == null) return null;
+
+    // Counter bisa bertambah digit di antara dua call: beri ruang lebih, sisanya terpotong
+    final capacity = format(nullptr, 0) + 256;
+    return using((arena) {
+      final buffer = arena<Uint8>(capacity);
+      final needed = format(buffer.cast<Utf8>(), capacity);
+      return buffer.cast<Utf8>().toDartString(length: needed < capacity ? needed : capacity - 1);
+    });
+  }
+}
@@ -0,0 +1,178 @@
+// lib/services/native_result_ring.dart
+import 'dart:ffi';
+import 'dart:typed_data';
+import 'package:ffi/ffi.dart';
+import 'package:flutter/foundation.dart';
+import 'native_library_loader.dart';
+
+// Konstanta dari native_libs/spsc_ring.h
+const int _ringHeaderBytes = 8;
+const int _ringWrap = 0xFFFFFFFF;
+
+typedef _CreateNative = Pointer<Void> Function(Uint32, Uint32);
+typedef _CreateDart = Pointer<Void> Function(int, int);
+typedef _HandleNative = Void Function(Pointer<Void>);
+typedef _HandleDart = void Function(Pointer<Void>);
+typedef _DoorbellNative = Void Function(Int64);
+typedef _SetDoorbellNative = Void Function(Pointer<Void>, Pointer<NativeFunction<_DoorbellNative>>, Int64);
+typedef _SetDoorbellDart = void Function(Pointer<Void>, Pointer<NativeFunction<_DoorbellNative>>, int);
+typedef _DataNative = Pointer<Uint8> Function(Pointer<Void>);
+typedef _CapacityNative = Uint32 Function(Pointer<Void>);
+typedef _CapacityDart = int Function(Pointer<Void>);
+typedef _AcquireNative = Uint32 Function(Pointer<Void>, Pointer<Uint32>);
+typedef _AcquireDart = int Function(Pointer<Void>, Pointer<Uint32>);
+typedef _ReleaseNative = Void Function(Pointer<Void>, Uint32);
+typedef _ReleaseDart = void Function(Pointer<Void>, int);
+typedef _FlagNative = Int32 Function(Pointer<Void>);
+typedef _FlagDart = int Function(Pointer<Void>);
+
+/// Dipanggil sekali per record. [payload] adalah view ke memory ring dan hanya valid
+/// selama callback berjalan (copy jika perlu disimpan).
+typedef RingRecordHandler = void Function(int tag, Uint8List payload);
+
+class _RingBindings {
+  final _CreateDart create;
+  final _HandleDart destroy;
+  final _SetDoorbellDart setDoorbell;
+  final Pointer<Uint8> Function(Pointer<Void>) data;
+  final _CapacityDart capacity;
+  final _AcquireDart acquire;
+  final _ReleaseDart release;
+  final _FlagDart arm;
+  final _FlagDart isClosed;
+
+  _RingBindings(DynamicLibrary lib)
+      : create = lib.lookupFunction<_CreateNative, _CreateDart>('spsc_ring_create'),
+        destroy = lib.lookupFunction<_HandleNative, _HandleDart>('spsc_ring_destroy'),
+        setDoorbell = lib.lookupFunction<_SetDoorbellNative, _SetDoorbellDart>('spsc_ring_set_doorbell'),
+        data = lib.lookupFunction<_DataNative, _DataNative>('spsc_ring_data'),
+        capacity = lib.lookupFunction<_CapacityNative, _CapacityDart>('spsc_ring_capacity'),
+        // Dipanggil sekali per batch dan tidak pernah blok: leaf call tanpa transisi isolate
+        acquire = lib.lookupFunction<_AcquireNative, _AcquireDart>('spsc_ring_acquire', isLeaf: true),
+        release = lib.lookupFunction<_ReleaseNative, _ReleaseDart>('spsc_ring_release', isLeaf: true),
+        arm = lib.lookupFunction<_FlagNative, _FlagDart>('spsc_ring_arm', isLeaf: true),
+        isClosed = lib.lookupFunction<_FlagNative, _FlagDart>('spsc_ring_is_closed', isLeaf: true);
+
+  static _RingBindings? _cached;
+  static bool _loaded = false;
+
+  static _RingBindings? load() {
+    if (_loaded) return _cached;
+    _loaded = true;
+    final lib = loadNativeCryptoLibrary('spsc_ring_create', label: 'Native SPSC result ring');
+    if (lib == null) return null;
+
+    try {
+      _cached = _RingBindings(lib);
+      return _cached;
+    } catch (e) {
+      return null;
+    }
+  }
+}
+
+/// Consumer Dart untuk SpscRing (native_libs/spsc_ring.h). Job native menulis hasil ke
+/// ring; doorbell NativeCallable.listener hanya berbunyi di batas batch saat reader idle,
+/// lalu seluruh batch dibaca langsung dari memory native tanpa alokasi per item.
+class NativeResultRing {
+  final _RingBindings _bindings;
+  Pointer<Void> _ring;
+  final RingRecordHandler _onRecord;
+  final VoidCallback? _onClosed;
+  final bool _wipe;
+  late final NativeCallable<_DoorbellNative> _doorbell;
+  late final Uint8List _view;
+  late final ByteData _headers;
+  final Pointer<Uint32> _offset;
+
+  int _records = 0;
+  int _wakeups = 0;
+
+  NativeResultRing._(this._bindings, this._ring, this._onRecord, this._onClosed, this._wipe, this._offset) {
+    final capacity = _bindings.capacity(_ring);
+    _view = _bindings.data(_ring).asTypedList(capacity);
+    _headers = ByteData.sublistView(_view);
+    _doorbell = NativeCallable<_DoorbellNative>.listener(_onDoorbell);
+    _bindings.setDoorbell(_ring, _doorbell.nativeFunction, 0);
+    _armOrDrain();
+  }
+
+  static bool get isSupported => _RingBindings.load() != null;
+
+  /// [wipeAfterRead] mengenolkan payload sebelum dikembalikan ke producer (untuk plaintext).
+  /// Return null jika library native tidak tersedia.
+  static NativeResultRing? create({
+    required RingRecordHandler onRecord,
+    VoidCallback? onClosed,
+    int capacityBytes = 0,
+    int batchRecords = 0,
+    bool wipeAfterRead = false,
+  }) {
+    final bindings = _RingBindings.load();
+    if (bindings == null) return null;
+    final ring = bindings.create(capacityBytes, batchRecords);
+    if (ring == nullptr) return null;
+    return NativeResultRing._(bindings, ring, onRecord, onClosed, wipeAfterRead, malloc<Uint32>());
+  }
+
+  /// Handle untuk diteruskan ke producer native (mis. lazy_decrypt_attach_ring).
+  Pointer<Void> get handle => _ring;
+
+  int get recordsRead => _records;
+  int get wakeups => _wakeups;
+
+  void _onDoorbell(int token) {
+    if (_ring == nullptr) return;
+    _wakeups++;
+    _armOrDrain();
+  }
+
+  // Baca sampai kosong lalu arm; jika producer sempat publish di antaranya, baca lagi
+  void _armOrDrain() {
+    for (;;) {
+      _drain();
+      if (_ring == nullptr) return;
+      if (_bindings.arm(_ring) == 0) return;
+      if (_bindings.isClosed(_ring) != 0 && _bindings.acquire(_ring, _offset) == 0) {
+        _onClosed?.call();
+        return;
+      }
+    }
+  }
+
+  void _drain() {
+    for (;;) {
+      final available = _bindings.acquire(_ring, _offset);
+      if (available == 0) return;
+      final start = _offset.value;
+      final end = start + available;
+
+      var pos = start;
+      while (pos < end) {
+        final length = _headers.getUint32(pos, Endian.host);
+        if (length == _ringWrap) {
+          pos = end;
+          break;
+        }
+        final tag = _headers.getUint32(pos + 4, Endian.host);
+        final payloadStart = pos + _ringHeaderBytes;
+        final payload = Uint8List.sublistView(_view, payloadStart, payloadStart + length);
+        _onRecord(tag, payload);
+        if (_wipe) payload.fillRange(0, length, 0);
+        _records++;
+        pos = payloadStart + ((length + 7) & ~7);
+      }
+      _bindings.release(_ring, pos - start);
+    }
+  }
+
+  /// Producer harus sudah berhenti menulis (mis. session native sudah di-destroy).
+  void dispose() {
+    if (_ring == nullptr) return;
+    _bindings.setDoorbell(_ring, nullptr, 0);
+    _doorbell.close();
+    _bindings.destroy(_ring);
+    _ring = nullptr;
+    malloc.free(_offset);
+  }
+}
@@ -0,0 +1,359 @@
+// lib/services/realtime_client_ffi.dart
+import 'dart:async';
+import 'dart:convert';
+import 'dart:ffi';
+import 'dart:io';
+import 'dart:isolate';
+import 'dart:typed_data';
+import 'package:ffi/ffi.dart';
+import 'package:flutter/foundation.dart';
+import 'message_record_ffi.dart';
+import 'native_result_ring.dart';
+import 'native_library_loader.dart';
+
+// Dari native_libs/realtime_client.h
+const int _realtimeOk = 0;
+const int _realtimeTagMessage = 1;
+const int _realtimeTagOutbound = 2;
+const int _realtimeTagState = 3;
+const int _realtimeMessageHeaderBytes = 32;
+const int _messageRecordOk = 0;
+
+const int realtimeStateJoined = 1;
+const int realtimeStateJoinFailed = 2;
+const int realtimeStateClosed = 3;
+
+final class RealtimeClientConfig extends Struct {
+  external Pointer<Utf8> topic;
+
+  external Pointer<Utf8> schema;
+
+  external Pointer<Utf8> table;
+
+  external Pointer<Utf8> filter;
+
+  external Pointer<Utf8> accessToken;
+
+  external Pointer<Uint8> chatKey;
+
+  @Size()
+  external int chatKeyLen;
+
+  external Pointer<Uint8> aeadKey;
+
+  @Uint32()
+  external int heartbeatMs;
+}
+
+final class RealtimeClientStats extends Struct {
+  @Uint64()
+  external int frames;
+
+  @Uint64()
+  external int frameBytes;
+
+  @Uint64()
+  external int parseErrors;
+
+  @Uint64()
+  external int ignoredEvents;
+
+  @Uint64()
+  external int inserts;
+
+  @Uint64()
+  external int decrypted;
+
+  @Uint64()
+  external int decryptFailures;
+
+  @Uint64()
+  external int batches;
+
+  @Uint64()
+  external int heartbeats;
+
+  @Uint64()
+  external int dropped;
+}
+
+typedef _CreateNative = Pointer<Void> Function(Pointer<RealtimeClientConfig>, Pointer<Void>);
+typedef _CreateDart = Pointer<Void> Function(Pointer<RealtimeClientConfig>, Pointer<Void>);
+typedef _HandleNative = Void Function(Pointer<Void>);
+typedef _HandleDart = void Function(Pointer<Void>);
+typedef _ConnectNative = Int32 Function(Pointer<Void>, Pointer<Utf8>, Uint16, Pointer<Utf8>, Int32);
+typedef _ConnectDart = int Function(Pointer<Void>, Pointer<Utf8>, int, Pointer<Utf8>, int);
+typedef _StartNative = Int32 Function(Pointer<Void>);
+typedef _StartDart = int Function(Pointer<Void>);
+typedef _FeedNative = Int32 Function(Pointer<Void>, Pointer<Uint8>, Size);
+typedef _FeedDart = int Function(Pointer<Void>, Pointer<Uint8>, int);
+typedef _StatsNative = Void Function(Pointer<Void>, Pointer<RealtimeClientStats>);
+typedef _StatsDart = void Function(Pointer<Void>, Pointer<RealtimeClientStats>);
+
+class _RealtimeBindings {
+  final _CreateDart create;
+  final _HandleDart destroy;
+  final _ConnectDart connect;
+  final _StartDart startExternal;
+  final _FeedDart feed;
+  final _StatsDart stats;
+
+  _RealtimeBindings(DynamicLibrary lib)
+      : create = lib.lookupFunction<_CreateNative, _CreateDart>('realtime_client_create'),
+        destroy = lib.lookupFunction<_HandleNative, _HandleDart>('realtime_client_destroy'),
+        connect = lib.lookupFunction<_ConnectNative, _ConnectDart>('realtime_client_connect'),
+        startExternal = lib.lookupFunction<_StartNative, _StartDart>('realtime_client_start_external'),
+        // Hanya copy frame ke antrian native, tidak pernah blok
+        feed = lib.lookupFunction<_FeedNative, _FeedDart>('realtime_client_feed', isLeaf: true),
+        stats = lib.lookupFunction<_StatsNative, _StatsDart>('realtime_client_get_stats', isLeaf: true);
+
+  static _RealtimeBindings? _cached;
+  static bool _loaded = false;
+
+  static _RealtimeBindings? load() {
+    if (_loaded) return _cached;
+    _loaded = true;
+    final lib = loadNativeCryptoLibrary('realtime_client_create', label: 'Native realtime client');
+    if (lib == null) return null;
+
+    try {
+      _cached = _RealtimeBindings(lib);
+      return _cached;
+    } catch (e) {
+      return null;
+    }
+  }
+}
+
+/// Pesan baru dari realtime yang sudah didecrypt di native. [text] null jika gagal
+/// didecrypt atau baris tidak valid.
+class RealtimeMessage {
+  final String id;
+  final String senderId;
+  final int createdAtUs;
+  final String? text;
+
+  RealtimeMessage(this.id, this.senderId, this.createdAtUs, this.text);
+
+  /// Format sama dengan created_at dari PostgREST (lihat [formatRecordTimestamp])
+  String get createdAt => formatRecordTimestamp(createdAtUs);
+}
+
+/// Client realtime native untuk satu chat (native_libs/realtime_client.h). Hanya INSERT
+/// baru yang sampai ke Dart, sudah didecrypt, lewat [NativeResultRing]; tidak ada snapshot
+/// tabel dan tidak ada decrypt di UI isolate. Endpoint ws:// ditangani socket native
+/// (mis. stack Supabase lokal), wss:// memakai WebSocket Dart sebagai transport.
+class NativeRealtimeClient {
+  final _RealtimeBindings _bindings;
+  Pointer<Void> _client;
+  final NativeResultRing _ring;
+  final void Function(RealtimeMessage message) _onMessage;
+  final void Function(int state, String detail)? _onState;
+  WebSocket? _socket;
+  StreamSubscription? _socketSubscription;
+  bool _dispatching = false;
+
+  NativeRealtimeClient._(this._bindings, this._client, this._ring, this._onMessage, this._onState);
+
+  static bool get isSupported => _RealtimeBindings.load() != null && NativeResultRing.isSupported;
+
+  /// [endpoint] mis. wss://<project>.supabase.co/realtime/v1/websocket?apikey=...&vsn=1.0.0.
+  /// Return null jika library native tidak tersedia atau koneksi gagal.
+  static Future<NativeRealtimeClient?> connect({
+    required Uri endpoint,
+    required String topic,
+    String? filter,
+    String? accessToken,
+    required Uint8List chatKey,
+    Uint8List? aeadKey,
+    required void Function(RealtimeMessage message) onMessage,
+    void Function(int state, String detail)? onState,
+    Duration heartbeat = const Duration(seconds: 25),
+  }) async {
+    final bindings = _RealtimeBindings.load();
+    if (bindings == null || chatKey.isEmpty || (aeadKey != null && aeadKey.length != 32)) return null;
+    if (endpoint.scheme != 'ws' && endpoint.scheme != 'wss') return null;
+
+    late final NativeRealtimeClient client;
+    final ring = NativeResultRing.create(
+      onRecord: (tag, payload) => client._onRecord(tag, payload),
+      wipeAfterRead: true,
+    );
+    if (ring == null) return null;
+
+    final handle = using((arena) {
+      final keyPtr = arena<Uint8>(chatKey.length);
+      keyPtr.asTypedList(chatKey.length).setAll(0, chatKey);
+      Pointer<Uint8> aeadPtr = nullptr;
+      if (aeadKey != null) {
+        aeadPtr = arena<Uint8>(aeadKey.length);
+        aeadPtr.asTypedList(aeadKey.length).setAll(0, aeadKey);
+      }
+      final config = arena<RealtimeClientConfig>();
+      config.ref
+        ..topic = topic.toNativeUtf8(allocator: arena)
+        ..schema = nullptr
+        ..table = nullptr
+        ..filter = filter == null ? nullptr : filter.toNativeUtf8(allocator: arena)
+        ..accessToken = accessToken == null ? nullptr : accessToken.toNativeUtf8(allocator: arena)
+        ..chatKey = keyPtr
+        ..chatKeyLen = chatKey.length
+        ..aeadKey = aeadPtr
+        ..heartbeatMs = heartbeat.inMilliseconds;
+      final created = bindings.create(config, ring.handle);
+      keyPtr.asTypedList(chatKey.length).fillRange(0, chatKey.length, 0);
+      if (aeadPtr != nullptr) aeadPtr.asTypedList(aeadKey!.length).fillRange(0, aeadKey.length, 0);
+      return created;
+    });
+    if (handle == nullptr) {
+      ring.dispose();
+      return null;
+    }
+    client = NativeRealtimeClient._(bindings, handle, ring, onMessage, onState);
+
+    final started = endpoint.scheme == 'ws'
+        ? await client._connectNative(endpoint)
+        : await client._connectExternal(endpoint);
+    if (!started) {
+      client.dispose();
+      return null;
+    }
+    return client;
+  }
+
+  // Handshake native blok sampai timeout, jadi dijalankan di isolate lain
+  Future<bool> _connectNative(Uri endpoint) async {
+    final handleAddress = _client.address;
+    final host = endpoint.host;
+    final port = endpoint.hasPort ? endpoint.port : 80;
+    final path = endpoint.hasQuery ? '${endpoint.path}?${endpoint.query}' : endpoint.path;
+    final rc = await Isolate.run(() {
+      final bindings = _RealtimeBindings.load();
+      if (bindings == null) return -1;
+      return using((arena) => bindings.connect(Pointer<Void>.fromAddress(handleAddress),
+          host.toNativeUtf8(allocator: arena), port, path.toNativeUtf8(allocator: arena), 0));
+    });
+    if (rc != _realtimeOk && kDebugMode) {
+      debugPrint('❌ Native realtime connect failed: $rc');
+    }
+    return rc == _realtimeOk;
+  }
+
+  Future<bool> _connectExternal(Uri endpoint) async {
+    try {
+      final socket = await WebSocket.connect(endpoint.toString());
+      _socket = socket;
+      _socketSubscription = socket.listen(
+        (data) {
+          if (data is String) _feed(data);
+        },
+        onDone: () => _onState?.call(realtimeStateClosed, 'socket closed'),
+        onError: (error) => _onState?.call(realtimeStateClosed, error.toString()),
+        cancelOnError: true,
+      );
+    } catch (e) {
+      if (kDebugMode) {
+        debugPrint('❌ Realtime WebSocket connect failed: $e');
+      }
+      return false;
+    }
+    // Join dikirim worker native lewat ring (REALTIME_TAG_OUTBOUND)
+    return _bindings.startExternal(_client) == _realtimeOk;
+  }
+
+  void _feed(String frame) {
+    if (_client == nullptr) return;
+    final bytes = utf8.encode(frame);
+    if (bytes.isEmpty) return;
+    using((arena) {
+      final ptr = arena<Uint8>(bytes.length);
+      ptr.asTypedList(bytes.length).setAll(0, bytes);
+      _bindings.feed(_client, ptr, bytes.length);
+    });
+  }
+
+  void _onRecord(int tag, Uint8List payload) {
+    _dispatching = true;
+    try {
+      _dispatch(tag, payload);
+    } finally {
+      _dispatching = false;
+    }
+  }
+
+  void _dispatch(int tag, Uint8List payload) {
+    switch (tag) {
+      case _realtimeTagMessage:
+        _onMessage(_decodeMessage(payload));
+        break;
+      case _realtimeTagOutbound:
+        _socket?.add(utf8.decode(payload));
+        break;
+      case _realtimeTagState:
+        final state = ByteData.sublistView(payload, 0, 4).getInt32(0, Endian.host);
+        final detail = utf8.decode(payload.sublist(4), allowMalformed: true);
+        if (kDebugMode) {
+          debugPrint('📡 Realtime state: $state $detail');
+        }
+        _onState?.call(state, detail);
+        break;
+    }
+  }
+
+  // RealtimeMessageHeader (32 byte) lalu id, sender, text
+  RealtimeMessage _decodeMessage(Uint8List payload) {
+    final header = ByteData.sublistView(payload, 0, _realtimeMessageHeaderBytes);
+    final createdAtUs = header.getInt64(0, Endian.host);
+    final status = header.getInt32(8, Endian.host);
+    final idLen = header.getUint32(12, Endian.host);
+    final senderLen = header.getUint32(16, Endian.host);
+    final textLen = header.getUint32(20, Endian.host);
+
+    var offset = _realtimeMessageHeaderBytes;
+    final id = utf8.decode(Uint8List.sublistView(payload, offset, offset + idLen));
+    offset += idLen;
+    final sender = utf8.decode(Uint8List.sublistView(payload, offset, offset + senderLen));
+    offset += senderLen;
+    final text = status == _messageRecordOk
+        ? utf8.decode(Uint8List.sublistView(payload, offset, offset + textLen))
+        : null;
+    return RealtimeMessage(id, sender, createdAtUs, text);
+  }
+
+  Map<String, int> get stats {
+    if (_client == nullptr) return const {};
+    return using((arena) {
+      final out = arena<RealtimeClientStats>();
+      _bindings.stats(_client, out);
+      final s = out.ref;
+      return {
+        'frames': s.frames,
+        'frame_bytes': s.frameBytes,
+        'parse_errors': s.parseErrors,
+        'ignored_events': s.ignoredEvents,
+        'inserts': s.inserts,
+        'decrypted': s.decrypted,
+        'decrypt_failures': s.decryptFailures,
+        'batches': s.batches,
+        'heartbeats': s.heartbeats,
+        'dropped': s.dropped,
+      };
+    });
+  }
+
+  void dispose() {
+    if (_client == nullptr) return;
+    // Dipanggil dari callback (mis. onState CLOSED): ring masih dibaca, lepas sesudahnya
+    if (_dispatching) {
+      scheduleMicrotask(dispose);
+      return;
+    }
+    _socketSubscription?.cancel();
+    _socket?.close();
+    _socket = null;
+    // Client dulu: thread native berhenti menulis sebelum ring dilepas
+    _bindings.destroy(_client);
+    _client = nullptr;
+    _ring.dispose();
+  }
+}
@@ -0,0 +1,166 @@
+// lib/services/resumable_upload_service.dart
+import 'dart:async';
+import 'dart:convert';
+import 'dart:io';
+import 'dart:typed_data';
+import 'package:flutter/foundation.dart';
+import 'upload_pipeline_ffi.dart';
+
+/// Endpoint upload bertahap (offset bergaya tus). Dibuat abstrak supaya storage lain
+/// atau server lokal di test bisa dipakai tanpa mengubah pipeline.
+abstract class ChunkUploadTransport {
+  /// Buat sesi upload baru, kembalikan URL sesi.
+  Future<Uri> create(int length, Map<String, String> metadata);
+
+  /// Offset yang sudah diterima server untuk sesi ini.
+  Future<int> queryOffset(Uri upload);
+
+  /// Kirim [data] mulai dari [offset], kembalikan offset baru dari server.
+  Future<int> patch(Uri upload, int offset, Uint8List data);
+}
+
+/// Transport tus 1.0 (create + HEAD + PATCH) di atas dart:io HttpClient.
+class TusHttpTransport implements ChunkUploadTransport {
+  final Uri endpoint;
+  final Map<String, String> headers;
+  final HttpClient _client;
+
+  TusHttpTransport(this.endpoint, {this.headers = const {}, HttpClient? client})
+      : _client = client ?? HttpClient();
+
+  void _applyHeaders(HttpClientRequest request) {
+    request.headers.set('Tus-Resumable', '1.0.0');
+    headers.forEach(request.headers.set);
+  }
+
+  @override
+  Future<Uri> create(int length, Map<String, String> metadata) async {
+    final request = await _client.postUrl(endpoint);
+    _applyHeaders(request);
+    request.headers.set('Upload-Length', '$length');
+    if (metadata.isNotEmpty) {
+      request.headers.set(
+        'Upload-Metadata',
+        metadata.entries.map((e) => '${e.key} ${base64.encode(utf8.encode(e.value))}').join(','),
+      );
+    }
+    request.contentLength = 0;
+    final response = await request.close();
+    await response.drain<void>();
+
+    final location = response.headers.value(HttpHeaders.locationHeader);
+    if (response.statusCode != HttpStatus.created || location == null) {
+      throw HttpException('tus create failed: ${response.statusCode}', uri: endpoint);
+    }
+    return endpoint.resolve(location);
+  }
+
+  @override
+  Future<int> queryOffset(Uri upload) async {
+    final request = await _client.headUrl(upload);
+    _applyHeaders(request);
+    final response = await request.close();
+    await response.drain<void>();
+    return _offsetFrom(response, upload);
+  }
+
+  @override
+  Future<int> patch(Uri upload, int offset, Uint8List data) async {
+    final request = await _client.openUrl('PATCH', upload);
+    _applyHeaders(request);
+    request.headers.set('Upload-Offset', '$offset');
+    request.headers.contentType = ContentType('application', 'offset+octet-stream');
+    request.contentLength = data.length;
+    request.add(data);
+    final response = await request.close();
+    await response.drain<void>();
+    return _offsetFrom(response, upload);
+  }
+
+  int _offsetFrom(HttpClientResponse response, Uri upload) {
+    final value = response.headers.value('upload-offset');
+    final offset = value == null ? null : int.tryParse(value);
+    if (response.statusCode >= 300 || offset == null) {
+      throw HttpException('tus request failed: ${response.statusCode}', uri: upload);
+    }
+    return offset;
+  }
+
+  void close() => _client.close(force: true);
+}
+
+class ResumableUploadResult {
+  final Uri uploadUrl;
+  final Uint8List authTag;
+  final int totalBytes;
+  final int resumes;
+
+  ResumableUploadResult({
+    required this.uploadUrl,
+    required this.authTag,
+    required this.totalBytes,
+    required this.resumes,
+  });
+}
+
+/// Mengalirkan segmen dari [EncryptingFileSource] ke [ChunkUploadTransport].
+/// Worker native sudah mengenkripsi segmen berikutnya selama PATCH berjalan; setelah
+/// error jaringan, offset diambil dari server (HEAD) dan pipeline di-rewind ke sana.
+class ResumableUploader {
+  final ChunkUploadTransport transport;
+  final int maxRetries;
+  final Duration retryDelay;
+
+  ResumableUploader(this.transport, {this.maxRetries = 5, this.retryDelay = const Duration(milliseconds: 500)});
+
+  Future<ResumableUploadResult> upload(
+    EncryptingFileSource source, {
+    Map<String, String> metadata = const {},
+    Uri? resumeUrl,
+    void Function(int sent, int total)? onProgress,
+  }) async {
+    final total = source.totalBytes;
+    final uploadUrl = resumeUrl ?? await transport.create(total, metadata);
+    var offset = resumeUrl == null ? 0 : await transport.queryOffset(uploadUrl);
+    if (offset > 0) source.rewind(offset);
+
+    var failures = 0;
+    var resumes = 0;
+    while (offset < total) {
+      try {
+        final segment = await source.next();
+        if (segment == null) break;
+        if (segment.offset != offset) {
+          source.rewind(offset);
+          continue;
+        }
+
+        offset = await transport.patch(uploadUrl, offset, segment.data);
+        source.release(offset);
+        failures = 0;
+        onProgress?.call(offset, total);
+      } on IOException catch (e) {
+        if (++failures > maxRetries) rethrow;
+        if (kDebugMode) {
+          debugPrint('⚠️ Upload interrupted at $offset/$total: $e');
+        }
+        await Future.delayed(retryDelay * failures);
+
+        try {
+          offset = await transport.queryOffset(uploadUrl);
+        } on IOException {
+          continue;
+        }
+        source.rewind(offset);
+        resumes++;
+      }
+    }
+
+    return ResumableUploadResult(
+      uploadUrl: uploadUrl,
+      authTag: await source.finish(),
+      totalBytes: total,
+      resumes: resumes,
+    );
+  }
+}
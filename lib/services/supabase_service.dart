@@ -7,7 +7,12 @@ import 'package:file_picker/file_picker.dart';
 import 'package:path_provider/path_provider.dart';
 import 'package:image/image.dart' as img;
 import 'package:archive/archive.dart';
+import '../config/app_constants.dart';
 import '../config/supabase_config.dart';
+import 'blob_store_ffi.dart';
+import 'chat_warm_sync.dart';
+import 'image_encoder_ffi.dart';
+import 'resumable_upload_service.dart';
 
 class SupabaseService {
   static final SupabaseService _instance = SupabaseService._internal();
@@ -19,6 +24,9 @@ class SupabaseService {
 
   SupabaseClient get client => SupabaseConfig.client;
 
+  // Path attachment yang hanya ada di blob store lokal (hash ciphertext)
+  static const String _blobPathPrefix = 'blob://';
+
   Future<void> initialize() async {
     try {
       await SupabaseConfig.initialize();
@@ -292,8 +300,9 @@ class SupabaseService {
   // FILE COMPRESSION & PROCESSING
   // ===============================
 
-  /// Compress image dengan quality adjustment
-  Future<Uint8List> compressImage(Uint8List imageData,
+  /// Compress image dengan quality adjustment. [mimeType] hasil mengikuti format yang
+  /// benar-benar ditulis (image/webp atau image/jpeg), null jika data asli dikembalikan.
+  Future<({Uint8List data, String? mimeType})> compressImage(Uint8List imageData,
       {int quality = 80}) async {
     try {
       if (kDebugMode) {
@@ -309,6 +318,27 @@ class SupabaseService {
       final resizedImage =
           image.width > 1200 ? img.copyResize(image, width: 1200) : image;
 
+      // WebP native: lossless untuk screenshot/grafik, lossy untuk foto (jika didukung build).
+      // Sumber JPEG adalah foto; tanpa libwebp hasilnya tetap JPEG, jadi konversi RGBA dilewati
+      final nativeEncoder = ImageEncoderFFI();
+      final isJpegSource = imageData.length > 2 && imageData[0] == 0xFF && imageData[1] == 0xD8;
+      if (nativeEncoder.isAvailable && (nativeEncoder.supportsLossy || !isJpegSource)) {
+        final rgba = resizedImage
+            .convert(format: img.Format.uint8, numChannels: 4)
+            .getBytes(order: img.ChannelOrder.rgba);
+        final encoded = nativeEncoder.encodeRgba(
+            rgba, resizedImage.width, resizedImage.height,
+            quality: quality);
+        final webpData = encoded?.bytes;
+        if (webpData != null) {
+          if (kDebugMode) {
+            debugPrint(
+                '✅ Image encoded as WebP ${encoded!.lossless ? 'lossless' : 'lossy'} (${encoded.isGraphic ? 'graphic' : 'photo'}): ${imageData.length} → ${webpData.length} bytes');
+          }
+          return (data: webpData, mimeType: 'image/webp');
+        }
+      }
+
       // Encode dengan quality setting
       final compressedData = img.encodeJpg(resizedImage, quality: quality);
 
@@ -321,12 +351,12 @@ class SupabaseService {
             '✅ Image compressed: $originalSize → $compressedSize bytes ($compressionRatio% reduction)');
       }
 
-      return Uint8List.fromList(compressedData);
+      return (data: Uint8List.fromList(compressedData), mimeType: 'image/jpeg');
     } catch (e) {
       if (kDebugMode) {
         debugPrint('❌ Image compression error: $e');
       }
-      return imageData;
+      return (data: imageData, mimeType: null);
     }
   }
 
@@ -394,6 +424,11 @@ class SupabaseService {
     }
   }
 
+  String _replaceExtension(String fileName, String extension) {
+    final dot = fileName.lastIndexOf('.');
+    return '${dot > 0 ? fileName.substring(0, dot) : fileName}.$extension';
+  }
+
   /// Process file berdasarkan type (compression, resize, dll)
   Future<FileProcessingResult> processFile({
     required Uint8List fileData,
@@ -406,6 +441,8 @@ class SupabaseService {
       }
 
       Uint8List processedData = fileData;
+      String processedMimeType = mimeType;
+      String processedFileName = fileName;
       bool isCompressed = false;
       String compressionInfo = '';
 
@@ -413,9 +450,17 @@ class SupabaseService {
       if (mimeType.startsWith('image/')) {
         // Compress image
         final originalSize = fileData.length;
-        processedData = await compressImage(fileData);
+        final compressed = await compressImage(fileData);
+        processedData = compressed.data;
         final compressedSize = processedData.length;
 
+        // Nama dan MIME mengikuti format hasil encode (WebP/JPEG), bukan format sumber
+        final encodedMimeType = compressed.mimeType;
+        if (encodedMimeType != null && encodedMimeType != mimeType) {
+          processedMimeType = encodedMimeType;
+          processedFileName = _replaceExtension(fileName, encodedMimeType == 'image/webp' ? 'webp' : 'jpg');
+        }
+
         if (compressedSize < originalSize) {
           isCompressed = true;
           compressionInfo =
@@ -449,8 +494,8 @@ class SupabaseService {
 
       return FileProcessingResult(
         data: processedData,
-        mimeType: mimeType,
-        fileName: fileName,
+        mimeType: processedMimeType,
+        fileName: processedFileName,
         isCompressed: isCompressed,
         compressionInfo: compressionInfo,
         originalSize: fileData.length,
@@ -556,12 +601,21 @@ class SupabaseService {
         debugPrint('✅ File uploaded successfully: $filePath');
       }
 
+      // Pengirim membuka file sendiri tanpa download ulang
+      await BlobStoreFFI().put(fileData, name: filePath);
+
       return filePath;
     } catch (e) {
       if (kDebugMode) {
         debugPrint('❌ File upload error: $e');
       }
 
+      // Fallback ke blob store: satu-satunya salinan, jadi di-pin (tidak dievict)
+      final hash = await BlobStoreFFI().put(fileData, pin: true);
+      if (hash != null) {
+        return '$_blobPathPrefix$hash';
+      }
+
       // Fallback ke local storage
       final localFile = await saveFileToLocation(
         data: fileData,
@@ -573,6 +627,35 @@ class SupabaseService {
     }
   }
 
+  /// Target resumable upload (tus) ke bucket 'encrypted_files'. Supabase Storage menuntut
+  /// chunk 6 MiB, jadi segmen pipeline dipakai dengan ukuran yang sama.
+  ResumableUploadTarget resumableUploadTarget(String fileName) {
+    if (!isAvailable) {
+      throw Exception('Supabase not available');
+    }
+
+    final accessToken =
+        client.auth.currentSession?.accessToken ?? AppConstants.supabaseAnonKey;
+    final filePath = '${DateTime.now().millisecondsSinceEpoch}_$fileName';
+
+    return ResumableUploadTarget(
+      filePath: filePath,
+      transport: TusHttpTransport(
+        Uri.parse('${AppConstants.supabaseUrl}/storage/v1/upload/resumable'),
+        headers: {
+          'authorization': 'Bearer $accessToken',
+          'apikey': AppConstants.supabaseAnonKey,
+          'x-upsert': 'false',
+        },
+      ),
+      metadata: {
+        'bucketName': 'encrypted_files',
+        'objectName': filePath,
+        'contentType': 'application/octet-stream',
+      },
+    );
+  }
+
   /// Download encrypted file - PERBAIKAN
   Future<Uint8List> downloadEncryptedFile(String filePath) async {
     try {
@@ -599,6 +682,25 @@ class SupabaseService {
         }
       }
 
+      // Attachment lokal di blob store (upload gagal)
+      if (filePath.startsWith(_blobPathPrefix)) {
+        final data =
+            await BlobStoreFFI().get(filePath.substring(_blobPathPrefix.length));
+        if (data == null) {
+          throw Exception('Local blob not found: $filePath');
+        }
+        return data;
+      }
+
+      // Sudah pernah dibuka: baca dari disk
+      final cached = await BlobStoreFFI().getByName(filePath);
+      if (cached != null) {
+        if (kDebugMode) {
+          debugPrint('✅ Served from blob store: ${cached.length} bytes');
+        }
+        return cached;
+      }
+
       // Handle Supabase storage paths
       if (!isAvailable) {
         throw Exception('Supabase not available');
@@ -611,6 +713,8 @@ class SupabaseService {
         debugPrint('✅ Supabase file downloaded: ${response.length} bytes');
       }
 
+      await BlobStoreFFI().put(response, name: filePath);
+
       return response;
     } catch (e) {
       if (kDebugMode) {
@@ -672,6 +776,11 @@ class SupabaseService {
 
   /// Delete file message
   Future<void> deleteFileMessage(String messageId, String filePath) async {
+    // Lepas pin attachment lokal supaya bisa dievict
+    if (filePath.startsWith(_blobPathPrefix)) {
+      await BlobStoreFFI().release(filePath.substring(_blobPathPrefix.length));
+    }
+
     if (!isAvailable) {
       return;
     }
@@ -1236,6 +1345,63 @@ class SupabaseService {
     return await fetchData('messages', filters: {'chat_id': chatId});
   }
 
+  /// Pesan dengan created_at >= [createdAt], urut naik. Dipakai untuk mengejar row yang
+  /// masuk sebelum client realtime join; batas inklusif, caller membuang id yang sudah ada.
+  Future<List<Map<String, dynamic>>> getEncryptedMessagesSince(
+    String chatId,
+    String createdAt,
+  ) async {
+    if (!isAvailable) {
+      return [];
+    }
+
+    final response = await client
+        .from('messages')
+        .select()
+        .eq('chat_id', chatId)
+        .gte('created_at', createdAt)
+        .order('created_at', ascending: true);
+    return List<Map<String, dynamic>>.from(response);
+  }
+
+  /// Sumber halaman terbaru untuk ChatWarmSync, memakai token sesi aktif (RLS messages).
+  PostgrestChatPageSource chatPageSource() {
+    if (!isAvailable) {
+      throw Exception('Supabase not available');
+    }
+
+    final accessToken =
+        client.auth.currentSession?.accessToken ?? AppConstants.supabaseAnonKey;
+    return PostgrestChatPageSource(
+      Uri.parse('${AppConstants.supabaseUrl}/rest/v1/'),
+      headers: {
+        'authorization': 'Bearer $accessToken',
+        'apikey': AppConstants.supabaseAnonKey,
+      },
+    );
+  }
+
+  /// Endpoint WebSocket Realtime (ws:// untuk stack lokal http://) dan token sesi aktif
+  /// untuk NativeRealtimeClient.
+  ({Uri endpoint, String accessToken}) realtimeEndpoint() {
+    if (!isAvailable) {
+      throw Exception('Supabase not available');
+    }
+
+    final base = Uri.parse(AppConstants.supabaseUrl);
+    final accessToken =
+        client.auth.currentSession?.accessToken ?? AppConstants.supabaseAnonKey;
+    final endpoint = base.replace(
+      scheme: base.scheme == 'http' ? 'ws' : 'wss',
+      path: '/realtime/v1/websocket',
+      queryParameters: {
+        'apikey': AppConstants.supabaseAnonKey,
+        'vsn': '1.0.0',
+      },
+    );
+    return (endpoint: endpoint, accessToken: accessToken);
+  }
+
   Stream<List<Map<String, dynamic>>> subscribeToMessages(String chatId) {
     if (!isAvailable) {
       return const Stream.empty();
@@ -1348,3 +1514,16 @@ class FileProcessingResult {
   double get compressionRatio =>
       originalSize > 0 ? (sizeSaved / originalSize * 100) : 0;
 }
+
+// Sesi resumable upload: path object di bucket + transport tus yang sudah ber-auth
+class ResumableUploadTarget {
+  final String filePath;
+  final TusHttpTransport transport;
+  final Map<String, String> metadata;
+
+  ResumableUploadTarget({
+    required this.filePath,
+    required this.transport,
+    required this.metadata,
+  });
+}
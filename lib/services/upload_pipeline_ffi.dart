@@ -0,0 +1,261 @@
+// lib/services/upload_pipeline_ffi.dart
+import 'dart:async';
+import 'dart:ffi';
+import 'dart:io';
+import 'dart:typed_data';
+import 'package:ffi/ffi.dart';
+import 'native_library_loader.dart';
+
+// Status dari native_libs/upload_pipeline.h
+const int _pipelineOk = 0;
+const int _pipelineDone = 1;
+const int _pipelinePending = 2;
+
+/// Mirror dari UploadPipelineConfig di native_libs/upload_pipeline.h
+final class UploadPipelineConfig extends Struct {
+  external Pointer<Utf8> sourcePath;
+
+  external Pointer<Uint8> key;
+
+  external Pointer<Uint8> nonce;
+
+  external Pointer<Uint8> hmacKey;
+
+  @Size()
+  external int hmacKeyLength;
+
+  @Uint32()
+  external int segmentSize;
+
+  @Uint32()
+  external int readAhead;
+
+  @Uint64()
+  external int resumeOffset;
+
+  external Pointer<Utf8> cipherPath;
+}
+
+/// Mirror dari UploadSegment di native_libs/upload_pipeline.h
+final class UploadSegment extends Struct {
+  @Uint64()
+  external int offset;
+
+  external Pointer<Uint8> data;
+
+  @Size()
+  external int length;
+
+  @Int32()
+  external int last;
+}
+
+typedef _OpenNative = Pointer<Void> Function(Pointer<UploadPipelineConfig>, Pointer<Int32>);
+typedef _OpenDart = Pointer<Void> Function(Pointer<UploadPipelineConfig>, Pointer<Int32>);
+typedef _CloseNative = Void Function(Pointer<Void>);
+typedef _CloseDart = void Function(Pointer<Void>);
+typedef _NextNative = Int32 Function(Pointer<Void>, Pointer<UploadSegment>, Int32);
+typedef _NextDart = int Function(Pointer<Void>, Pointer<UploadSegment>, int);
+typedef _ReleaseNative = Void Function(Pointer<Void>, Uint64);
+typedef _ReleaseDart = void Function(Pointer<Void>, int);
+typedef _RewindNative = Int32 Function(Pointer<Void>, Uint64);
+typedef _RewindDart = int Function(Pointer<Void>, int);
+typedef _TotalNative = Uint64 Function(Pointer<Void>);
+typedef _TotalDart = int Function(Pointer<Void>);
+typedef _FinishNative = Int32 Function(Pointer<Void>, Pointer<Uint8>);
+typedef _FinishDart = int Function(Pointer<Void>, Pointer<Uint8>);
+typedef _DoorbellNative = Void Function(Int64);
+typedef _SetDoorbellNative = Void Function(Pointer<Void>, Pointer<NativeFunction<_DoorbellNative>>, Int64);
+typedef _SetDoorbellDart = void Function(Pointer<Void>, Pointer<NativeFunction<_DoorbellNative>>, int);
+typedef _ArmNative = Int32 Function(Pointer<Void>, Int32);
+typedef _ArmDart = int Function(Pointer<Void>, int);
+
+class EncryptedSegment {
+  final int offset;
+
+  /// View ke buffer native; hanya valid sampai [EncryptingFileSource.release] atau rewind.
+  final Uint8List data;
+  final bool isLast;
+
+  EncryptedSegment(this.offset, this.data, this.isLast);
+}
+
+/// Binding untuk native upload pipeline (encrypt segmen di worker native sementara
+/// Dart mengirim segmen sebelumnya). Isolate UI tidak pernah menunggu condvar native:
+/// next/finish memakai varian non-blocking dan doorbell seperti [NativeResultRing].
+class UploadPipelineFFI {
+  static final UploadPipelineFFI _instance = UploadPipelineFFI._internal();
+  factory UploadPipelineFFI() => _instance;
+
+  _OpenDart? _open;
+  late final _CloseDart _close;
+  late final _NextDart _next;
+  late final _ReleaseDart _release;
+  late final _RewindDart _rewind;
+  late final _TotalDart _total;
+  late final _FinishDart _tryFinish;
+  late final _SetDoorbellDart _setDoorbell;
+  late final _ArmDart _arm;
+
+  UploadPipelineFFI._internal() {
+    _initialize();
+  }
+
+  bool get isAvailable => _open != null;
+
+  void _initialize() {
+    final lib = loadNativeCryptoLibrary('upload_pipeline_open', label: 'Native upload pipeline');
+    if (lib == null) return;
+
+    try {
+      _close = lib.lookupFunction<_CloseNative, _CloseDart>('upload_pipeline_close');
+      _next = lib.lookupFunction<_NextNative, _NextDart>('upload_pipeline_next');
+      _release = lib.lookupFunction<_ReleaseNative, _ReleaseDart>('upload_pipeline_release');
+      _rewind = lib.lookupFunction<_RewindNative, _RewindDart>('upload_pipeline_rewind');
+      _total = lib.lookupFunction<_TotalNative, _TotalDart>('upload_pipeline_total_bytes');
+      _tryFinish = lib.lookupFunction<_FinishNative, _FinishDart>('upload_pipeline_try_finish');
+      _setDoorbell = lib.lookupFunction<_SetDoorbellNative, _SetDoorbellDart>('upload_pipeline_set_doorbell');
+      _arm = lib.lookupFunction<_ArmNative, _ArmDart>('upload_pipeline_arm');
+      _open = lib.lookupFunction<_OpenNative, _OpenDart>('upload_pipeline_open');
+    } catch (e) {
+      return;
+    }
+  }
+
+  /// Buka pipeline untuk [file]. [segmentSize] harus kelipatan 64. Jika [cipherPath]
+  /// diisi, worker juga menyimpan seluruh ciphertext ke sana (lengkap setelah [finish]).
+  EncryptingFileSource open({
+    required File file,
+    required Uint8List chachaKey,
+    required Uint8List nonce,
+    required Uint8List hmacKey,
+    required int segmentSize,
+    int readAhead = 3,
+    int resumeOffset = 0,
+    String? cipherPath,
+  }) {
+    final open = _open;
+    if (open == null) {
+      throw Exception('Native upload pipeline unavailable');
+    }
+
+    return using((arena) {
+      final config = arena<UploadPipelineConfig>();
+      final keyPtr = arena<Uint8>(chachaKey.length);
+      final noncePtr = arena<Uint8>(nonce.length);
+      final hmacKeyPtr = arena<Uint8>(hmacKey.length);
+      keyPtr.asTypedList(chachaKey.length).setAll(0, chachaKey);
+      noncePtr.asTypedList(nonce.length).setAll(0, nonce);
+      hmacKeyPtr.asTypedList(hmacKey.length).setAll(0, hmacKey);
+
+      config.ref
+        ..sourcePath = file.path.toNativeUtf8(allocator: arena)
+        ..key = keyPtr
+        ..nonce = noncePtr
+        ..hmacKey = hmacKeyPtr
+        ..hmacKeyLength = hmacKey.length
+        ..segmentSize = segmentSize
+        ..readAhead = readAhead
+        ..resumeOffset = resumeOffset
+        ..cipherPath = cipherPath == null ? nullptr : cipherPath.toNativeUtf8(allocator: arena);
+
+      final status = arena<Int32>();
+      final handle = open(config, status);
+
+      keyPtr.asTypedList(chachaKey.length).fillRange(0, chachaKey.length, 0);
+      hmacKeyPtr.asTypedList(hmacKey.length).fillRange(0, hmacKey.length, 0);
+      if (handle == nullptr) {
+        throw Exception('upload_pipeline_open failed: ${status.value}');
+      }
+      return EncryptingFileSource._(this, handle);
+    });
+  }
+}
+
+/// Sumber ciphertext berurutan untuk satu upload.
+class EncryptingFileSource {
+  final UploadPipelineFFI _ffi;
+  Pointer<Void> _handle;
+  final Pointer<UploadSegment> _segment = calloc<UploadSegment>();
+  late final NativeCallable<_DoorbellNative> _doorbell;
+  Completer<void>? _wake;
+
+  EncryptingFileSource._(this._ffi, this._handle) {
+    _doorbell = NativeCallable<_DoorbellNative>.listener(_onDoorbell);
+    _ffi._setDoorbell(_handle, _doorbell.nativeFunction, 0);
+  }
+
+  int get totalBytes => _ffi._total(_handle);
+
+  void _onDoorbell(int token) {
+    final wake = _wake;
+    _wake = null;
+    wake?.complete();
+  }
+
+  // Arm lalu tunggu doorbell; langsung kembali jika worker sudah maju di antaranya
+  Future<void> _waitForWorker(int forFinish) {
+    if (_ffi._arm(_handle, forFinish) != 0) return Future.value();
+    return (_wake = Completer<void>()).future;
+  }
+
+  /// Segmen berikutnya, atau null jika seluruh file sudah keluar. Jika worker belum selesai,
+  /// menunggu doorbell secara async supaya isolate UI tidak ter-block.
+  Future<EncryptedSegment?> next() async {
+    for (;;) {
+      _checkOpen();
+      final status = _ffi._next(_handle, _segment, 0);
+      if (status == _pipelineOk) {
+        final segment = _segment.ref;
+        return EncryptedSegment(segment.offset, segment.data.asTypedList(segment.length), segment.last != 0);
+      }
+      if (status == _pipelineDone) return null;
+      if (status != _pipelinePending) {
+        throw Exception('upload_pipeline_next failed: $status');
+      }
+      await _waitForWorker(0);
+    }
+  }
+
+  void release(int ackedOffset) => _ffi._release(_handle, ackedOffset);
+
+  void rewind(int offset) {
+    final status = _ffi._rewind(_handle, offset);
+    if (status != _pipelineOk) {
+      throw Exception('upload_pipeline_rewind failed: $status');
+    }
+  }
+
+  /// HMAC-SHA512 tag atas seluruh ciphertext (sama dengan FileEncryptionService). Sisa
+  /// hash ditunggu lewat doorbell, bukan condvar native di isolate UI.
+  Future<Uint8List> finish() async {
+    final tag = calloc<Uint8>(64);
+    try {
+      for (;;) {
+        _checkOpen();
+        final status = _ffi._tryFinish(_handle, tag);
+        if (status == _pipelineOk) return Uint8List.fromList(tag.asTypedList(64));
+        if (status != _pipelinePending) {
+          throw Exception('upload_pipeline_finish failed: $status');
+        }
+        await _waitForWorker(1);
+      }
+    } finally {
+      calloc.free(tag);
+    }
+  }
+
+  void _checkOpen() {
+    if (_handle == nullptr) throw StateError('EncryptingFileSource sudah ditutup');
+  }
+
+  void close() {
+    if (_handle == nullptr) return;
+    _ffi._setDoorbell(_handle, nullptr, 0);
+    _doorbell.close();
+    _ffi._close(_handle);
+    _handle = nullptr;
+    calloc.free(_segment);
+    _onDoorbell(0);
+  }
+}
@@ -0,0 +1,73 @@
+// secret_app/lib/steganography/png_filter.c
+#include "png_filter.h"
+
+#include <stdlib.h>
+
+void png_cost_table_init(PngCostTable* table) {
+    for (int r = 0; r < 256; r++) {
+        int magnitude = r < 128 ? r : 256 - r;
+        uint8_t bits = 1;  // residual 0 tetap makan simbol literal
+        while (magnitude) {
+            bits++;
+            magnitude >>= 1;
+        }
+        table->bits[r] = bits;
+    }
+}
+
+static inline uint8_t paeth_predictor(int a, int b, int c) {
+    const int p = a + b - c;
+    const int pa = abs(p - a);
+    const int pb = abs(p - b);
+    const int pc = abs(p - c);
+    if (pa <= pb && pa <= pc) return (uint8_t)a;
+    if (pb <= pc) return (uint8_t)b;
+    return (uint8_t)c;
+}
+
+// a = kiri, b = atas, c = kiri atas (0 di luar gambar)
+static inline uint8_t predict(const uint8_t* row, const uint8_t* prev, size_t i, size_t bpp,
+                              int filter, uint8_t mask) {
+    const uint8_t a = i >= bpp ? (uint8_t)(row[i - bpp] & mask) : 0;
+    const uint8_t b = prev ? (uint8_t)(prev[i] & mask) : 0;
+    const uint8_t c = prev && i >= bpp ? (uint8_t)(prev[i - bpp] & mask) : 0;
+    switch (filter) {
+        case PNG_FILTER_SUB: return a;
+        case PNG_FILTER_UP: return b;
+        case PNG_FILTER_AVERAGE: return (uint8_t)((a + b) >> 1);
+        case PNG_FILTER_PAETH: return paeth_predictor(a, b, c);
+        default: return 0;
+    }
+}
+
+uint64_t png_row_cost(const PngCostTable* table, const uint8_t* row, const uint8_t* prev,
+                      size_t begin, size_t end, size_t bpp, int filter, uint8_t mask) {
+    uint64_t cost = 0;
+    for (size_t i = begin; i < end; i++) {
+        const uint8_t residual = (uint8_t)((row[i] & mask) - predict(row, prev, i, bpp, filter, mask));
+        cost += table->bits[residual];
+    }
+    return cost;
+}
+
+int png_best_filter(const PngCostTable* table, const uint8_t* row, const uint8_t* prev,
+                    size_t begin, size_t end, size_t bpp, uint8_t mask, uint64_t* cost) {
+    int best = PNG_FILTER_NONE;
+    uint64_t best_cost = UINT64_MAX;
+    for (int filter = PNG_FILTER_NONE; filter < PNG_FILTER_COUNT; filter++) {
+        const uint64_t c = png_row_cost(table, row, prev, begin, end, bpp, filter, mask);
+        if (c < best_cost) {
+            best_cost = c;
+            best = filter;
+        }
+    }
+    if (cost) *cost = best_cost;
+    return best;
+}
+
+void png_apply_filter(uint8_t* out, const uint8_t* row, const uint8_t* prev,
+                      size_t len, size_t bpp, int filter) {
+    for (size_t i = 0; i < len; i++) {
+        out[i] = (uint8_t)(row[i] - predict(row, prev, i, bpp, filter, 0xFF));
+    }
+}
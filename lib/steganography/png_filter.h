@@ -0,0 +1,43 @@
+// secret_app/lib/steganography/png_filter.h
+#ifndef PNG_FILTER_H
+#define PNG_FILTER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Filter scanline PNG (RFC 2083 bagian 6) dan estimator biaya deflate per baris.
+// Estimator menjumlahkan panjang bit magnitudo residual (signed byte) setelah filter:
+// residual kecil dan seragam dikompres deflate jauh lebih baik daripada residual acak,
+// sehingga jumlah ini mendekati entropi residual tanpa histogram atau floating point
+// (hasilnya identik di semua platform, dipakai juga untuk urutan embedding).
+
+#define PNG_FILTER_NONE 0
+#define PNG_FILTER_SUB 1
+#define PNG_FILTER_UP 2
+#define PNG_FILTER_AVERAGE 3
+#define PNG_FILTER_PAETH 4
+#define PNG_FILTER_COUNT 5
+
+// Biaya per nilai residual, diisi png_cost_table_init
+typedef struct {
+    uint8_t bits[256];
+} PngCostTable;
+
+void png_cost_table_init(PngCostTable* table);
+
+// Biaya sample [begin, end) dari satu baris dengan filter tertentu. prev = baris
+// sebelumnya atau NULL (baris pertama). bpp = byte per pixel. mask diterapkan ke setiap
+// sample sebelum prediksi (0xFE = abaikan LSB, supaya hasilnya sama sebelum dan sesudah
+// embedding).
+uint64_t png_row_cost(const PngCostTable* table, const uint8_t* row, const uint8_t* prev,
+                      size_t begin, size_t end, size_t bpp, int filter, uint8_t mask);
+
+// Filter dengan biaya terkecil untuk sample [begin, end); cost boleh NULL
+int png_best_filter(const PngCostTable* table, const uint8_t* row, const uint8_t* prev,
+                    size_t begin, size_t end, size_t bpp, uint8_t mask, uint64_t* cost);
+
+// Tulis residual filter ke out (len byte, tanpa byte tipe filter)
+void png_apply_filter(uint8_t* out, const uint8_t* row, const uint8_t* prev,
+                      size_t len, size_t bpp, int filter);
+
+#endif // PNG_FILTER_H
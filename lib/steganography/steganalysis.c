@@ -0,0 +1,378 @@
+// secret_app/lib/steganography/steganalysis.c
+#include "steganalysis.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// Lebar 8 lane int16: SSE2 di x86, NEON di ARM (Android/iOS)
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define STEGO_SIMD 1
+typedef __m128i v16;
+#define V16_LOAD(p) _mm_loadu_si128((const __m128i*)(p))
+#define V16_STORE(p, v) _mm_storeu_si128((__m128i*)(p), v)
+#define V16_SET1(x) _mm_set1_epi16(x)
+#define V16_ZERO() _mm_setzero_si128()
+#define V16_ADD(a, b) _mm_add_epi16(a, b)
+#define V16_SUB(a, b) _mm_sub_epi16(a, b)
+#define V16_MAX(a, b) _mm_max_epi16(a, b)
+#define V16_XOR(a, b) _mm_xor_si128(a, b)
+#define V16_AND(a, b) _mm_and_si128(a, b)
+#define V16_OR(a, b) _mm_or_si128(a, b)
+#define V16_GT(a, b) _mm_cmpgt_epi16(a, b)
+#define V16_EQ(a, b) _mm_cmpeq_epi16(a, b)
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define STEGO_SIMD 1
+typedef int16x8_t v16;
+#define V16_LOAD(p) vld1q_s16(p)
+#define V16_STORE(p, v) vst1q_s16(p, v)
+#define V16_SET1(x) vdupq_n_s16(x)
+#define V16_ZERO() vdupq_n_s16(0)
+#define V16_ADD(a, b) vaddq_s16(a, b)
+#define V16_SUB(a, b) vsubq_s16(a, b)
+#define V16_MAX(a, b) vmaxq_s16(a, b)
+#define V16_XOR(a, b) veorq_s16(a, b)
+#define V16_AND(a, b) vandq_s16(a, b)
+#define V16_OR(a, b) vorrq_s16(a, b)
+#define V16_GT(a, b) vreinterpretq_s16_u16(vcgtq_s16(a, b))
+#define V16_EQ(a, b) vreinterpretq_s16_u16(vceqq_s16(a, b))
+#endif
+
+#define CHANNEL_STRIDE 3       // RGB interleaved, pasangan = pixel bertetangga di channel sama
+#define RS_BLOCK 12            // 4 pixel RGB = 3 grup RS (satu per channel)
+#define LANES 8
+#define FLUSH_INTERVAL 4096    // counter int16 per lane di-flush sebelum overflow
+
+void steganalysis_reset(SteganalysisAccumulator* acc) {
+    memset(acc, 0, sizeof(*acc));
+}
+
+// Histogram dengan 4 sub-histogram untuk memutus dependensi store-to-load
+static void accumulate_histogram(SteganalysisAccumulator* acc, const uint8_t* data,
+                                 size_t begin, size_t end) {
+    uint32_t h[4][256];
+    memset(h, 0, sizeof(h));
+
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        h[0][data[i]]++;
+        h[1][data[i + 1]]++;
+        h[2][data[i + 2]]++;
+        h[3][data[i + 3]]++;
+    }
+    for (; i < end; i++) {
+        h[0][data[i]]++;
+    }
+    for (int v = 0; v < 256; v++) {
+        acc->histogram[v] += (uint64_t)h[0][v] + h[1][v] + h[2][v] + h[3][v];
+    }
+}
+
+// ==================== SAMPLE PAIR ANALYSIS ====================
+
+static void spa_classify_scalar(SteganalysisAccumulator* acc, const uint8_t* data,
+                                size_t first, size_t last) {
+    for (size_t i = first; i < last; i++) {
+        const int u = data[i];
+        const int v = data[i + CHANNEL_STRIDE];
+        const int even = (v & 1) == 0;
+        if ((even && u < v) || (!even && u > v)) acc->spa_x++;
+        if ((even && u > v) || (!even && u < v)) acc->spa_y++;
+        if (u == v) acc->spa_z++;
+        if ((u ^ v) == 1) acc->spa_w++;
+    }
+}
+
+static void accumulate_spa(SteganalysisAccumulator* acc, const uint8_t* data,
+                           size_t begin, size_t end) {
+    // Pasangan (i, i+3) dihitung saat sample kedua masuk chunk ini
+    if (end < CHANNEL_STRIDE) return;
+    size_t first = begin >= CHANNEL_STRIDE ? begin - CHANNEL_STRIDE : 0;
+    const size_t last = end - CHANNEL_STRIDE;
+    if (first >= last) return;
+    acc->spa_pairs += last - first;
+
+#ifdef STEGO_SIMD
+    const v16 one = V16_SET1(1);
+    v16 cx = V16_ZERO(), cy = V16_ZERO(), cz = V16_ZERO(), cw = V16_ZERO();
+    int16_t u16[LANES], v16s[LANES], lanes[LANES];
+    size_t iterations = 0;
+
+    for (; first + LANES <= last; first += LANES) {
+        for (int k = 0; k < LANES; k++) {
+            u16[k] = data[first + k];
+            v16s[k] = data[first + k + CHANNEL_STRIDE];
+        }
+        const v16 u = V16_LOAD(u16);
+        const v16 v = V16_LOAD(v16s);
+        const v16 odd = V16_EQ(V16_AND(v, one), one);
+        const v16 lt = V16_GT(v, u);
+        const v16 gt = V16_GT(u, v);
+
+        // Mask compare bernilai -1, jadi dikurangkan untuk menghitung
+        cx = V16_SUB(cx, V16_OR(V16_AND(lt, V16_XOR(odd, V16_SET1(-1))), V16_AND(gt, odd)));
+        cy = V16_SUB(cy, V16_OR(V16_AND(gt, V16_XOR(odd, V16_SET1(-1))), V16_AND(lt, odd)));
+        cz = V16_SUB(cz, V16_EQ(u, v));
+        cw = V16_SUB(cw, V16_EQ(V16_XOR(u, v), one));
+
+        if (++iterations == FLUSH_INTERVAL) {
+            iterations = 0;
+            V16_STORE(lanes, cx); for (int k = 0; k < LANES; k++) acc->spa_x += (uint16_t)lanes[k];
+            V16_STORE(lanes, cy); for (int k = 0; k < LANES; k++) acc->spa_y += (uint16_t)lanes[k];
+            V16_STORE(lanes, cz); for (int k = 0; k < LANES; k++) acc->spa_z += (uint16_t)lanes[k];
+            V16_STORE(lanes, cw); for (int k = 0; k < LANES; k++) acc->spa_w += (uint16_t)lanes[k];
+            cx = cy = cz = cw = V16_ZERO();
+        }
+    }
+    V16_STORE(lanes, cx); for (int k = 0; k < LANES; k++) acc->spa_x += (uint16_t)lanes[k];
+    V16_STORE(lanes, cy); for (int k = 0; k < LANES; k++) acc->spa_y += (uint16_t)lanes[k];
+    V16_STORE(lanes, cz); for (int k = 0; k < LANES; k++) acc->spa_z += (uint16_t)lanes[k];
+    V16_STORE(lanes, cw); for (int k = 0; k < LANES; k++) acc->spa_w += (uint16_t)lanes[k];
+#endif
+
+    spa_classify_scalar(acc, data, first, last);
+}
+
+// ==================== RS ANALYSIS ====================
+
+// F1: 2k <-> 2k+1, F-1: 2k-1 <-> 2k
+static inline int flip_pos(int x) { return x ^ 1; }
+static inline int flip_neg(int x) { return ((x + 1) ^ 1) - 1; }
+
+static inline int discrimination(int a, int b, int c, int d) {
+    return abs(b - a) + abs(c - b) + abs(d - c);
+}
+
+static void rs_group_scalar(SteganalysisAccumulator* acc, int a, int b, int c, int d) {
+    // Mask M = [0, 1, 1, 0]
+    const int f0 = discrimination(a, b, c, d);
+    const int fm = discrimination(a, flip_pos(b), flip_pos(c), d);
+    const int fn = discrimination(a, flip_neg(b), flip_neg(c), d);
+
+    const int a1 = a ^ 1, b1 = b ^ 1, c1 = c ^ 1, d1 = d ^ 1;
+    const int g0 = discrimination(a1, b1, c1, d1);
+    const int gm = discrimination(a1, b, c, d1);
+    const int gn = discrimination(a1, flip_neg(b1), flip_neg(c1), d1);
+
+    acc->rs[0] += fm > f0;
+    acc->rs[1] += fm < f0;
+    acc->rs[2] += fn > f0;
+    acc->rs[3] += fn < f0;
+    acc->rs[4] += gm > g0;
+    acc->rs[5] += gm < g0;
+    acc->rs[6] += gn > g0;
+    acc->rs[7] += gn < g0;
+}
+
+#ifdef STEGO_SIMD
+static inline v16 v16_abs_diff(v16 x, v16 y) {
+    return V16_MAX(V16_SUB(x, y), V16_SUB(y, x));
+}
+
+static inline v16 v16_discrimination(v16 a, v16 b, v16 c, v16 d) {
+    return V16_ADD(V16_ADD(v16_abs_diff(b, a), v16_abs_diff(c, b)), v16_abs_diff(d, c));
+}
+
+static inline v16 v16_flip_neg(v16 x, v16 one) {
+    return V16_SUB(V16_XOR(V16_ADD(x, one), one), one);
+}
+#endif
+
+static void accumulate_rs(SteganalysisAccumulator* acc, const uint8_t* data,
+                          size_t begin, size_t end) {
+    // Blok 12 byte dihitung di chunk tempat byte terakhirnya berada
+    size_t block = begin / RS_BLOCK;
+    const size_t block_end = end / RS_BLOCK;
+    if (block >= block_end) return;
+    acc->rs_groups += (block_end - block) * CHANNEL_STRIDE;
+
+#ifdef STEGO_SIMD
+    // 8 blok per iterasi: tiap blok 12 byte berisi 3 grup, jadi 24 grup = 3 vektor
+    const v16 one = V16_SET1(1);
+    v16 counters[8];
+    for (int k = 0; k < 8; k++) counters[k] = V16_ZERO();
+    int16_t ga[24], gb[24], gc[24], gd[24], lanes[LANES];
+    size_t iterations = 0;
+
+    for (; block + 8 <= block_end; block += 8) {
+        for (int k = 0; k < 24; k++) {
+            const uint8_t* g = data + (block + k / CHANNEL_STRIDE) * RS_BLOCK + k % CHANNEL_STRIDE;
+            ga[k] = g[0];
+            gb[k] = g[3];
+            gc[k] = g[6];
+            gd[k] = g[9];
+        }
+        for (int part = 0; part < 3; part++) {
+            const v16 a = V16_LOAD(ga + part * LANES);
+            const v16 b = V16_LOAD(gb + part * LANES);
+            const v16 c = V16_LOAD(gc + part * LANES);
+            const v16 d = V16_LOAD(gd + part * LANES);
+
+            const v16 f0 = v16_discrimination(a, b, c, d);
+            const v16 fm = v16_discrimination(a, V16_XOR(b, one), V16_XOR(c, one), d);
+            const v16 fn = v16_discrimination(a, v16_flip_neg(b, one), v16_flip_neg(c, one), d);
+
+            const v16 a1 = V16_XOR(a, one), b1 = V16_XOR(b, one);
+            const v16 c1 = V16_XOR(c, one), d1 = V16_XOR(d, one);
+            const v16 g0 = v16_discrimination(a1, b1, c1, d1);
+            const v16 gm = v16_discrimination(a1, b, c, d1);
+            const v16 gn = v16_discrimination(a1, v16_flip_neg(b1, one), v16_flip_neg(c1, one), d1);
+
+            counters[0] = V16_SUB(counters[0], V16_GT(fm, f0));
+            counters[1] = V16_SUB(counters[1], V16_GT(f0, fm));
+            counters[2] = V16_SUB(counters[2], V16_GT(fn, f0));
+            counters[3] = V16_SUB(counters[3], V16_GT(f0, fn));
+            counters[4] = V16_SUB(counters[4], V16_GT(gm, g0));
+            counters[5] = V16_SUB(counters[5], V16_GT(g0, gm));
+            counters[6] = V16_SUB(counters[6], V16_GT(gn, g0));
+            counters[7] = V16_SUB(counters[7], V16_GT(g0, gn));
+        }
+
+        if (++iterations == FLUSH_INTERVAL) {
+            iterations = 0;
+            for (int k = 0; k < 8; k++) {
+                V16_STORE(lanes, counters[k]);
+                for (int l = 0; l < LANES; l++) acc->rs[k] += (uint16_t)lanes[l];
+                counters[k] = V16_ZERO();
+            }
+        }
+    }
+    for (int k = 0; k < 8; k++) {
+        V16_STORE(lanes, counters[k]);
+        for (int l = 0; l < LANES; l++) acc->rs[k] += (uint16_t)lanes[l];
+    }
+#endif
+
+    for (; block < block_end; block++) {
+        for (int channel = 0; channel < CHANNEL_STRIDE; channel++) {
+            const uint8_t* g = data + block * RS_BLOCK + channel;
+            rs_group_scalar(acc, g[0], g[3], g[6], g[9]);
+        }
+    }
+}
+
+void steganalysis_accumulate(SteganalysisAccumulator* acc, const uint8_t* data,
+                             size_t begin, size_t end) {
+    if (!acc || !data || begin >= end) return;
+    accumulate_histogram(acc, data, begin, end);
+    accumulate_spa(acc, data, begin, end);
+    accumulate_rs(acc, data, begin, end);
+}
+
+// ==================== ESTIMATOR ====================
+
+// Regularized lower incomplete gamma P(a, x) (series / continued fraction)
+static double gamma_p(double a, double x) {
+    if (x <= 0.0) return 0.0;
+    const double log_prefix = -x + a * log(x) - lgamma(a);
+
+    if (x < a + 1.0) {
+        double ap = a, sum = 1.0 / a, del = sum;
+        for (int n = 0; n < 1000; n++) {
+            ap += 1.0;
+            del *= x / ap;
+            sum += del;
+            if (fabs(del) < fabs(sum) * 1e-12) break;
+        }
+        return sum * exp(log_prefix);
+    }
+
+    double b = x + 1.0 - a, c = 1.0 / 1e-300, d = 1.0 / b, h = d;
+    for (int i = 1; i < 1000; i++) {
+        const double an = -i * (i - a);
+        b += 2.0;
+        d = an * d + b;
+        if (fabs(d) < 1e-300) d = 1e-300;
+        c = b + an / c;
+        if (fabs(c) < 1e-300) c = 1e-300;
+        d = 1.0 / d;
+        const double del = d * c;
+        h *= del;
+        if (fabs(del - 1.0) < 1e-12) break;
+    }
+    return 1.0 - exp(log_prefix) * h;
+}
+
+static double clamp01(double v) {
+    if (!(v > 0.0)) return 0.0;
+    return v > 1.0 ? 1.0 : v;
+}
+
+// Westfeld-Pfitzmann: pasangan nilai (2k, 2k+1) yang seimbang menandakan embedding
+static void finish_chi_square(const SteganalysisAccumulator* acc, SteganalysisReport* report) {
+    double chi = 0.0;
+    int categories = 0;
+    for (int k = 0; k < 128; k++) {
+        const double expected = (acc->histogram[2 * k] + acc->histogram[2 * k + 1]) / 2.0;
+        if (expected < 5.0) continue;
+        const double diff = acc->histogram[2 * k] - expected;
+        chi += diff * diff / expected;
+        categories++;
+    }
+    report->chi_square = chi;
+    report->chi_square_p = categories > 1 ? clamp01(1.0 - gamma_p((categories - 1) / 2.0, chi / 2.0)) : 0.0;
+}
+
+// Akar kuadrat dengan magnitudo terkecil dari a*x^2 + b*x + c = 0
+static double smaller_root(double a, double b, double c) {
+    if (fabs(a) < 1e-12) {
+        return fabs(b) < 1e-12 ? 0.0 : -c / b;
+    }
+    double disc = b * b - 4.0 * a * c;
+    if (disc < 0.0) disc = 0.0;
+    const double r1 = (-b + sqrt(disc)) / (2.0 * a);
+    const double r2 = (-b - sqrt(disc)) / (2.0 * a);
+    return fabs(r1) < fabs(r2) ? r1 : r2;
+}
+
+// Fridrich-Goljan-Du RS estimator
+static void finish_rs(const SteganalysisAccumulator* acc, SteganalysisReport* report) {
+    if (acc->rs_groups == 0) {
+        report->rs_estimate = 0.0;
+        return;
+    }
+    const double n = (double)acc->rs_groups;
+    const double d0 = (acc->rs[0] - (double)acc->rs[1]) / n;
+    const double dn0 = (acc->rs[2] - (double)acc->rs[3]) / n;
+    const double d1 = (acc->rs[4] - (double)acc->rs[5]) / n;
+    const double dn1 = (acc->rs[6] - (double)acc->rs[7]) / n;
+
+    const double x = smaller_root(2.0 * (d1 + d0), dn0 - dn1 - d1 - 3.0 * d0, d0 - dn0);
+    report->rs_estimate = fabs(x - 0.5) < 1e-12 ? 1.0 : clamp01(x / (x - 0.5));
+}
+
+// Dumitrescu-Wu-Wang SPA estimator
+static void finish_spa(const SteganalysisAccumulator* acc, SteganalysisReport* report) {
+    if (acc->spa_pairs == 0) {
+        report->spa_estimate = 0.0;
+        return;
+    }
+    const double a = 0.5 * ((double)acc->spa_w + (double)acc->spa_z);
+    const double b = 2.0 * (double)acc->spa_x - (double)acc->spa_pairs;
+    const double c = (double)acc->spa_y - (double)acc->spa_x;
+    report->spa_estimate = clamp01(smaller_root(a, b, c));
+}
+
+void steganalysis_finish(const SteganalysisAccumulator* acc, SteganalysisReport* report) {
+    memset(report, 0, sizeof(*report));
+    finish_chi_square(acc, report);
+    finish_rs(acc, report);
+    finish_spa(acc, report);
+
+    // Chi-square hanya dihitung jika sangat yakin, RS/SPA sudah berupa estimasi rasio
+    double score = report->rs_estimate > report->spa_estimate ? report->rs_estimate : report->spa_estimate;
+    if (report->chi_square_p > 0.95 && report->chi_square_p > score) {
+        score = report->chi_square_p;
+    }
+    report->detection_score = score;
+}
+
+SteganalysisReport analyze_steganalysis(const uint8_t* image_data, size_t image_size) {
+    SteganalysisReport report;
+    SteganalysisAccumulator acc;
+    steganalysis_reset(&acc);
+    steganalysis_accumulate(&acc, image_data, 0, image_size);
+    steganalysis_finish(&acc, &report);
+    return report;
+}
@@ -0,0 +1,34 @@
+// secret_app/lib/steganography/steganalysis.h
+#ifndef STEGANALYSIS_H
+#define STEGANALYSIS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "steganography.h"
+
+// Akumulator statistik steganalisis, bisa diisi per chunk saat embed (fused pass)
+typedef struct {
+    uint64_t histogram[256];
+
+    // Sample pair analysis: pasangan (u, v) sample bertetangga di channel yang sama
+    uint64_t spa_x;
+    uint64_t spa_y;
+    uint64_t spa_z;
+    uint64_t spa_w;
+    uint64_t spa_pairs;
+
+    // RS analysis: R_M, S_M, R_-M, S_-M untuk gambar asli lalu gambar dengan LSB dibalik
+    uint64_t rs[8];
+    uint64_t rs_groups;
+} SteganalysisAccumulator;
+
+void steganalysis_reset(SteganalysisAccumulator* acc);
+
+// Proses data[begin, end). data[0, end) harus sudah final; pasangan dan grup yang
+// melewati batas chunk dihitung pada chunk berikutnya.
+void steganalysis_accumulate(SteganalysisAccumulator* acc, const uint8_t* data,
+                             size_t begin, size_t end);
+
+void steganalysis_finish(const SteganalysisAccumulator* acc, SteganalysisReport* report);
+
+#endif // STEGANALYSIS_H
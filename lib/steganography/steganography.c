@@ -1,10 +1,30 @@
 // secret_app/lib/steganography/steganography.c
 #include "steganography.h"
+#include "steganalysis.h"
+#include "png_filter.h"
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
 #include <stdio.h>
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+// Latency histogram stego ikut native_metrics jika library dibangun dengan
+// -DSTEGANOGRAPHY_NATIVE_METRICS (di-link ke libargon2, jadi satu instance dengan crypto)
+#ifdef STEGANOGRAPHY_NATIVE_METRICS
+#include "native_metrics.h"
+#define STEGO_METRICS_START() native_metrics_now_ns()
+#define STEGO_METRICS_RECORD(start, bytes, ok) native_metrics_record(NATIVE_METRICS_STEGO, (start), (bytes), (ok))
+#else
+#define STEGO_METRICS_START() 0
+#define STEGO_METRICS_RECORD(start, bytes, ok) ((void)(start))
+#endif
+
 #define BLOCK_SIZE 8
 #define MAX_CAPACITY_FACTOR 0.3  // 30% dari total pixels
 
@@ -73,83 +93,789 @@ void xor_encrypt(uint8_t* data, size_t length, const char* password) {
     }
 }
 
-SteganographyResult encode_lsb_dct(const uint8_t* image_data, size_t image_size,
+// Pesan error selalu di-copy karena free_steganography_result memanggil free()
+static void set_error(SteganographyResult* result, const char* message) {
+    result->success = false;
+    result->error_message = malloc(strlen(message) + 1);
+    if (result->error_message) {
+        strcpy(result->error_message, message);
+    }
+}
+
+// Urutan embedding: sample ke-j ada di posisi (start + j * step) mod n,
+// step coprime dengan n sehingga semua posisi dikunjungi tepat sekali
+typedef struct {
+    uint64_t n;
+    uint64_t start;
+    uint64_t step;
+    uint64_t step_inv;
+    uint64_t seed;
+} StegoKey;
+
+static uint64_t splitmix64(uint64_t* state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static uint64_t gcd_u64(uint64_t a, uint64_t b) {
+    while (b) {
+        uint64_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+static uint64_t mod_inverse(uint64_t a, uint64_t n) {
+    int64_t t = 0, new_t = 1;
+    int64_t r = (int64_t)n, new_r = (int64_t)a;
+    while (new_r != 0) {
+        int64_t q = r / new_r;
+        int64_t tmp = t - q * new_t; t = new_t; new_t = tmp;
+        tmp = r - q * new_r; r = new_r; new_r = tmp;
+    }
+    if (t < 0) t += (int64_t)n;
+    return (uint64_t)t;
+}
+
+// FNV-1a dari password
+static uint64_t password_seed(const char* password) {
+    uint64_t seed = 0xCBF29CE484222325ULL;
+    for (const char* p = password; *p; p++) {
+        seed ^= (uint8_t)*p;
+        seed *= 0x100000001B3ULL;
+    }
+    return seed;
+}
+
+static void stego_key_from_seed(StegoKey* key, uint64_t seed, size_t n) {
+    key->n = n;
+    key->seed = seed;
+    key->start = splitmix64(&seed) % n;
+    key->step = n > 1 ? 1 + splitmix64(&seed) % (n - 1) : 1;
+    while (gcd_u64(key->step, n) != 1) {
+        key->step = key->step + 1 < n ? key->step + 1 : 1;
+    }
+    key->step_inv = n > 1 ? mod_inverse(key->step, n) : 0;
+}
+
+static void stego_key_init(StegoKey* key, const char* password, size_t n) {
+    stego_key_from_seed(key, password_seed(password) ^ (uint64_t)n, n);
+}
+
+static inline int payload_bit(const uint8_t* payload, uint64_t j) {
+    return (payload[j >> 3] >> (7 - (j & 7))) & 1;
+}
+
+// Satu pass berurutan: tulis sample output lalu langsung analisis chunk yang masih hangat di cache
+#define EMBED_CHUNK (12 * 1024)
+
+static void embed_pass(uint8_t* out, const uint8_t* in, const StegoKey* key,
+                       const uint8_t* payload, uint64_t total_bits, bool matching,
+                       SteganalysisAccumulator* acc) {
+    const uint64_t n = key->n;
+    // Indeks urutan j untuk sample i: j = (i - start) * step^-1 mod n, naik step^-1 per sample
+    uint64_t j = ((n - key->start) % n) * key->step_inv % n;
+
+    for (uint64_t begin = 0; begin < n; begin += EMBED_CHUNK) {
+        const uint64_t end = begin + EMBED_CHUNK < n ? begin + EMBED_CHUNK : n;
+        for (uint64_t i = begin; i < end; i++) {
+            uint8_t v = in[i];
+            if (j < total_bits && (v & 1) != payload_bit(payload, j)) {
+                if (!matching) {
+                    v ^= 1;
+                } else if (v == 0) {
+                    v = 1;
+                } else if (v == 255) {
+                    v = 254;
+                } else {
+                    // Arah +-1 ditentukan dari key supaya histogram tetap halus
+                    uint64_t coin = key->seed ^ (j * 0x9E3779B97F4A7C15ULL);
+                    v = (uint8_t)(((coin >> 63) & 1) ? v + 1 : v - 1);
+                }
+            }
+            out[i] = v;
+            j += key->step_inv;
+            if (j >= n) j -= n;
+        }
+        if (acc) {
+            steganalysis_accumulate(acc, out, (size_t)begin, (size_t)end);
+        }
+    }
+}
+
+// Payload = panjang pesan (4 byte LE) + pesan, semuanya di-XOR dengan password
+static uint8_t* build_payload(const uint8_t* message, size_t message_length,
+                              const char* password, size_t* payload_length) {
+    *payload_length = message_length + 4;
+    uint8_t* payload = malloc(*payload_length);
+    if (!payload) return NULL;
+
+    payload[0] = (uint8_t)message_length;
+    payload[1] = (uint8_t)(message_length >> 8);
+    payload[2] = (uint8_t)(message_length >> 16);
+    payload[3] = (uint8_t)(message_length >> 24);
+    memcpy(payload + 4, message, message_length);
+    xor_encrypt(payload, *payload_length, password);
+    return payload;
+}
+
+static bool validate_encode_input(SteganographyResult* result,
+                                  const uint8_t* image_data, size_t image_size,
                                   const uint8_t* message, size_t message_length,
                                   const char* password) {
-    SteganographyResult result = {0};
-    
-    if (!image_data || !message) {
-        result.success = false;
-        result.error_message = "Invalid input data";
-        return result;
+    if (!image_data || !message || !password) {
+        set_error(result, "Invalid input data");
+        return false;
     }
-    
-    // Enkripsi pesan dengan password
-    uint8_t* encrypted_message = malloc(message_length);
-    if (!encrypted_message) {
-        result.success = false;
-        result.error_message = "Memory allocation failed";
-        return result;
+    if ((uint64_t)image_size >= 0xFFFFFFFFULL) {
+        set_error(result, "Image too large");
+        return false;
     }
-    
-    memcpy(encrypted_message, message, message_length);
-    xor_encrypt(encrypted_message, message_length, password);
-    
+
     // Hitung kapasitas maksimal
     size_t max_capacity = get_max_capacity(image_data, image_size);
     if (message_length + 8 > max_capacity) { // +8 untuk header
-        free(encrypted_message);
-        result.success = false;
-        result.error_message = "Message too large for image capacity";
+        set_error(result, "Message too large for image capacity");
+        return false;
+    }
+    return true;
+}
+
+static SteganographyResult encode_internal(const uint8_t* image_data, size_t image_size,
+                                           const uint8_t* message, size_t message_length,
+                                           const char* password, double max_detection,
+                                           SteganalysisReport* report) {
+    SteganographyResult result = {0};
+    if (!validate_encode_input(&result, image_data, image_size, message, message_length, password)) {
         return result;
     }
-    
-    // TODO: Implementasi lengkap LSB + DCT
-    // Untuk sekarang return dummy result
-    result.success = true;
+
+    // Enkripsi pesan dengan password
+    size_t payload_length = 0;
+    uint8_t* payload = build_payload(message, message_length, password, &payload_length);
     result.data = malloc(image_size);
-    memcpy(result.data, image_data, image_size);
+    if (!payload || !result.data) {
+        free(payload);
+        free(result.data);
+        result.data = NULL;
+        set_error(&result, "Memory allocation failed");
+        return result;
+    }
+
+    StegoKey key;
+    stego_key_init(&key, password, image_size);
+    const uint64_t total_bits = (uint64_t)payload_length * 8;
+
+    if (!report) {
+        embed_pass(result.data, image_data, &key, payload, total_bits, false, NULL);
+    } else {
+        SteganalysisAccumulator acc;
+        steganalysis_reset(&acc);
+        embed_pass(result.data, image_data, &key, payload, total_bits, false, &acc);
+        steganalysis_finish(&acc, report);
+
+        if (report->detection_score > max_detection) {
+            // LSB replacement terdeteksi: ulangi dengan LSB matching yang tidak meninggalkan
+            // asimetri pasangan (2k, 2k+1) yang diukur chi-square, RS dan SPA
+            steganalysis_reset(&acc);
+            embed_pass(result.data, image_data, &key, payload, total_bits, true, &acc);
+            steganalysis_finish(&acc, report);
+            report->lsb_matching_used = true;
+        }
+
+        if (report->detection_score > max_detection) {
+            memset(payload, 0, payload_length);
+            free(payload);
+            free(result.data);
+            result.data = NULL;
+            set_error(&result, "Payload too detectable for this image");
+            return result;
+        }
+    }
+
+    memset(payload, 0, payload_length);
+    free(payload);
+
+    result.success = true;
     result.data_length = image_size;
     result.width = 0; // Set default values
     result.height = 0;
-    
-    free(encrypted_message);
     return result;
 }
 
-SteganographyResult decode_lsb_dct(const uint8_t* image_data, size_t image_size,
+SteganographyResult encode_lsb_dct(const uint8_t* image_data, size_t image_size,
+                                  const uint8_t* message, size_t message_length,
                                   const char* password) {
+    const uint64_t started_ns = STEGO_METRICS_START();
+    SteganographyResult result = encode_internal(image_data, image_size, message, message_length,
+                                                 password, 1.0, NULL);
+    STEGO_METRICS_RECORD(started_ns, image_size, result.success);
+    return result;
+}
+
+SteganographyResult encode_lsb_dct_checked(const uint8_t* image_data, size_t image_size,
+                                          const uint8_t* message, size_t message_length,
+                                          const char* password, double max_detection,
+                                          SteganalysisReport* report) {
+    const uint64_t started_ns = STEGO_METRICS_START();
+    SteganalysisReport local_report;
+    SteganographyResult result = encode_internal(image_data, image_size, message, message_length, password,
+                                                 max_detection, report ? report : &local_report);
+    STEGO_METRICS_RECORD(started_ns, image_size, result.success);
+    return result;
+}
+
+static SteganographyResult decode_internal(const uint8_t* image_data, size_t image_size,
+                                           const char* password) {
     SteganographyResult result = {0};
-    
-    if (!image_data) {
-        result.success = false;
-        result.error_message = "Invalid image data";
+
+    if (!image_data || !password) {
+        set_error(&result, "Invalid image data");
         return result;
     }
-    
-    // TODO: Implementasi decode LSB + DCT
-    // Untuk sekarang return dummy result
-    const char* demo_message = "Decoded secret message";
-    size_t message_length = strlen(demo_message);
-    
-    uint8_t* decoded_message = malloc(message_length + 1);
-    if (!decoded_message) {
-        result.success = false;
-        result.error_message = "Memory allocation failed";
+
+    const size_t max_capacity = get_max_capacity(image_data, image_size);
+    if (max_capacity < 8 || (uint64_t)image_size >= 0xFFFFFFFFULL) {
+        set_error(&result, "Image too small");
         return result;
     }
-    
-    strcpy((char*)decoded_message, demo_message);
-    
+
+    StegoKey key;
+    stego_key_init(&key, password, image_size);
+
+    // Baca header panjang pesan (32 bit pertama)
+    uint8_t header[4] = {0};
+    uint64_t position = key.start;
+    for (int j = 0; j < 32; j++) {
+        header[j >> 3] |= (uint8_t)((image_data[position] & 1) << (7 - (j & 7)));
+        position += key.step;
+        if (position >= key.n) position -= key.n;
+    }
+    uint8_t length_bytes[4];
+    memcpy(length_bytes, header, sizeof(header));
+    xor_encrypt(length_bytes, sizeof(length_bytes), password);
+    const size_t message_length = (size_t)length_bytes[0] | ((size_t)length_bytes[1] << 8) |
+                                  ((size_t)length_bytes[2] << 16) | ((size_t)length_bytes[3] << 24);
+    if (message_length + 8 > max_capacity) {
+        set_error(&result, "No hidden message or wrong password");
+        return result;
+    }
+
+    // Payload lengkap di-decode agar keystream XOR password tetap sejajar dengan header
+    const size_t payload_length = message_length + 4;
+    uint8_t* payload = calloc(payload_length + 1, 1);
+    if (!payload) {
+        set_error(&result, "Memory allocation failed");
+        return result;
+    }
+    memcpy(payload, header, sizeof(header));
+    for (uint64_t j = 32; j < (uint64_t)payload_length * 8; j++) {
+        payload[j >> 3] |= (uint8_t)((image_data[position] & 1) << (7 - (j & 7)));
+        position += key.step;
+        if (position >= key.n) position -= key.n;
+    }
+
     // Dekripsi dengan password
-    xor_encrypt(decoded_message, message_length, password);
-    
+    xor_encrypt(payload, payload_length, password);
+    memmove(payload, payload + 4, message_length);
+    payload[message_length] = 0;
+
     result.success = true;
-    result.data = decoded_message;
+    result.data = payload;
     result.data_length = message_length;
     result.width = 0;
     result.height = 0;
-    
+
+    return result;
+}
+
+SteganographyResult decode_lsb_dct(const uint8_t* image_data, size_t image_size,
+                                  const char* password) {
+    const uint64_t started_ns = STEGO_METRICS_START();
+    SteganographyResult result = decode_internal(image_data, image_size, password);
+    STEGO_METRICS_RECORD(started_ns, image_size, result.success);
+    return result;
+}
+
+// ==================== PNG-AWARE EMBEDDING ====================
+
+// Carrier dibagi menjadi region (potongan baris REGION_SAMPLES sample) dan bit dititipkan
+// mulai dari region dengan residual filter terbaik (tanpa LSB) paling tinggi. Region yang
+// sudah ramai hampir tidak bertambah ukurannya setelah deflate jika LSB-nya diacak, region
+// datar (langit, latar polos) bisa membengkak beberapa kali lipat. Biaya dihitung dari
+// bit 7..1 sehingga decoder mendapat urutan yang sama dari gambar stego.
+#define PNG_REGION_SAMPLES 256
+
+typedef struct {
+    size_t row_len;
+    uint32_t regions_per_row;
+    uint32_t region_count;
+} PngRegions;
+
+typedef struct {
+    uint64_t cost;
+    uint64_t tie;
+    uint32_t region;
+} RegionRank;
+
+static int compare_region_rank(const void* a, const void* b) {
+    const RegionRank* x = (const RegionRank*)a;
+    const RegionRank* y = (const RegionRank*)b;
+    if (x->cost != y->cost) return x->cost > y->cost ? -1 : 1;
+    if (x->tie != y->tie) return x->tie < y->tie ? -1 : 1;
+    return x->region < y->region ? -1 : (x->region > y->region ? 1 : 0);
+}
+
+static void png_regions_init(PngRegions* regions, uint32_t width, uint32_t height, uint32_t channels) {
+    regions->row_len = (size_t)width * channels;
+    regions->regions_per_row = (uint32_t)((regions->row_len + PNG_REGION_SAMPLES - 1) / PNG_REGION_SAMPLES);
+    regions->region_count = regions->regions_per_row * height;
+}
+
+// Sample [begin, end) di dalam baris untuk region
+static void png_region_span(const PngRegions* regions, uint32_t region, size_t* row, size_t* begin, size_t* end) {
+    *row = region / regions->regions_per_row;
+    *begin = (size_t)(region % regions->regions_per_row) * PNG_REGION_SAMPLES;
+    *end = *begin + PNG_REGION_SAMPLES < regions->row_len ? *begin + PNG_REGION_SAMPLES : regions->row_len;
+}
+
+// Analisis carrier yang tidak bergantung pada password: biaya per region. Dipakai
+// bersama oleh semua output encode_lsb_png_multi.
+typedef struct {
+    const uint8_t* pixels;
+    size_t pixels_size;
+    uint32_t width;
+    uint32_t height;
+    PngRegions regions;
+    uint64_t* costs;
+} PngCarrier;
+
+static bool png_carrier_analyze(PngCarrier* carrier, const uint8_t* pixels, size_t pixels_size,
+                                uint32_t width, uint32_t height, uint32_t channels) {
+    carrier->pixels = pixels;
+    carrier->pixels_size = pixels_size;
+    carrier->width = width;
+    carrier->height = height;
+    png_regions_init(&carrier->regions, width, height, channels);
+    const PngRegions* regions = &carrier->regions;
+    carrier->costs = malloc((size_t)regions->region_count * sizeof(uint64_t));
+    if (!carrier->costs) return false;
+
+    PngCostTable table;
+    png_cost_table_init(&table);
+    for (uint32_t r = 0; r < regions->region_count; r++) {
+        size_t y, begin, end;
+        png_region_span(regions, r, &y, &begin, &end);
+        const uint8_t* row = pixels + y * regions->row_len;
+        const uint8_t* prev = y ? row - regions->row_len : NULL;
+        uint64_t cost;
+        png_best_filter(&table, row, prev, begin, end, channels, 0xFE, &cost);
+        // Region pendek di ujung baris dinormalisasi ke panjang penuh
+        carrier->costs[r] = cost * PNG_REGION_SAMPLES / (end - begin);
+    }
+    return true;
+}
+
+static void png_carrier_release(PngCarrier* carrier) {
+    free(carrier->costs);
+    carrier->costs = NULL;
+}
+
+static uint32_t* png_carrier_order(const PngCarrier* carrier, uint64_t seed) {
+    const uint32_t count = carrier->regions.region_count;
+    RegionRank* ranks = malloc((size_t)count * sizeof(RegionRank));
+    uint32_t* order = malloc((size_t)count * sizeof(uint32_t));
+    if (!ranks || !order) {
+        free(ranks);
+        free(order);
+        return NULL;
+    }
+
+    for (uint32_t r = 0; r < count; r++) {
+        ranks[r].cost = carrier->costs[r];
+        // Region dengan biaya sama (mis. area datar) diurutkan dengan key, bukan posisi
+        uint64_t tie_state = seed ^ ((uint64_t)r * 0xD1B54A32D192ED03ULL);
+        ranks[r].tie = splitmix64(&tie_state);
+        ranks[r].region = r;
+    }
+    qsort(ranks, count, sizeof(RegionRank), compare_region_rank);
+    for (uint32_t i = 0; i < count; i++) {
+        order[i] = ranks[i].region;
+    }
+    free(ranks);
+    return order;
+}
+
+// Urutan sample: region sesuai rank, di dalam region walk affine dengan key per region
+typedef struct {
+    const PngRegions* regions;
+    const uint32_t* order;
+    uint64_t seed;
+    uint32_t rank;
+    size_t base;
+    uint64_t taken;
+    uint64_t position;
+    StegoKey key;
+} PngWalk;
+
+static void png_walk_enter_region(PngWalk* walk) {
+    const uint32_t region = walk->order[walk->rank];
+    size_t y, begin, end;
+    png_region_span(walk->regions, region, &y, &begin, &end);
+    walk->base = y * walk->regions->row_len + begin;
+    stego_key_from_seed(&walk->key, walk->seed ^ ((uint64_t)region * 0x9E3779B97F4A7C15ULL), end - begin);
+    walk->position = walk->key.start;
+    walk->taken = 0;
+}
+
+static void png_walk_init(PngWalk* walk, const PngRegions* regions, const uint32_t* order, uint64_t seed) {
+    walk->regions = regions;
+    walk->order = order;
+    walk->seed = seed;
+    walk->rank = 0;
+    png_walk_enter_region(walk);
+}
+
+// Pemanggil menjamin jumlah sample yang diminta tidak melebihi gambar
+static size_t png_walk_next(PngWalk* walk) {
+    if (walk->taken == walk->key.n) {
+        walk->rank++;
+        png_walk_enter_region(walk);
+    }
+    const size_t index = walk->base + (size_t)walk->position;
+    walk->position += walk->key.step;
+    if (walk->position >= walk->key.n) walk->position -= walk->key.n;
+    walk->taken++;
+    return index;
+}
+
+static bool validate_png_geometry(SteganographyResult* result, size_t pixels_size,
+                                  uint32_t width, uint32_t height, uint32_t channels) {
+    if (width == 0 || height == 0 || channels == 0 || channels > 4 ||
+        (uint64_t)width * height * channels != (uint64_t)pixels_size) {
+        set_error(result, "Invalid image geometry");
+        return false;
+    }
+    return true;
+}
+
+// Bagian per password: urutan region, payload, salinan carrier dan tulis LSB
+static SteganographyResult png_carrier_embed(const PngCarrier* carrier,
+                                             const uint8_t* message, size_t message_length,
+                                             const char* password) {
+    SteganographyResult result = {0};
+    if (!validate_encode_input(&result, carrier->pixels, carrier->pixels_size, message, message_length,
+                               password)) {
+        return result;
+    }
+
+    const uint64_t seed = password_seed(password) ^ (uint64_t)carrier->pixels_size;
+    size_t payload_length = 0;
+    uint8_t* payload = build_payload(message, message_length, password, &payload_length);
+    uint32_t* order = png_carrier_order(carrier, seed);
+    result.data = malloc(carrier->pixels_size);
+    if (!payload || !order || !result.data) {
+        free(payload);
+        free(order);
+        free(result.data);
+        result.data = NULL;
+        set_error(&result, "Memory allocation failed");
+        return result;
+    }
+
+    // Selalu LSB replacement: +-1 mengubah bit 7..1 dan merusak urutan region saat decode
+    memcpy(result.data, carrier->pixels, carrier->pixels_size);
+    PngWalk walk;
+    png_walk_init(&walk, &carrier->regions, order, seed);
+    const uint64_t total_bits = (uint64_t)payload_length * 8;
+    for (uint64_t j = 0; j < total_bits; j++) {
+        const size_t index = png_walk_next(&walk);
+        result.data[index] = (uint8_t)((result.data[index] & 0xFE) | payload_bit(payload, j));
+    }
+
+    memset(payload, 0, payload_length);
+    free(payload);
+    free(order);
+
+    result.success = true;
+    result.data_length = carrier->pixels_size;
+    result.width = (int)carrier->width;
+    result.height = (int)carrier->height;
+    return result;
+}
+
+static SteganographyResult encode_png_internal(const uint8_t* pixels, size_t pixels_size,
+                                               uint32_t width, uint32_t height, uint32_t channels,
+                                               const uint8_t* message, size_t message_length,
+                                               const char* password) {
+    SteganographyResult result = {0};
+    if (!pixels) {
+        set_error(&result, "Invalid input data");
+        return result;
+    }
+    if (!validate_png_geometry(&result, pixels_size, width, height, channels)) {
+        return result;
+    }
+
+    PngCarrier carrier;
+    if (!png_carrier_analyze(&carrier, pixels, pixels_size, width, height, channels)) {
+        png_carrier_release(&carrier);
+        set_error(&result, "Memory allocation failed");
+        return result;
+    }
+    result = png_carrier_embed(&carrier, message, message_length, password);
+    png_carrier_release(&carrier);
+    return result;
+}
+
+SteganographyResult encode_lsb_png(const uint8_t* pixels, size_t pixels_size,
+                                  uint32_t width, uint32_t height, uint32_t channels,
+                                  const uint8_t* message, size_t message_length,
+                                  const char* password) {
+    const uint64_t started_ns = STEGO_METRICS_START();
+    SteganographyResult result = encode_png_internal(pixels, pixels_size, width, height, channels,
+                                                     message, message_length, password);
+    STEGO_METRICS_RECORD(started_ns, pixels_size, result.success);
+    return result;
+}
+
+// ==================== MULTI-RECIPIENT ====================
+
+#define STEGO_MAX_THREADS 16
+
+// Worker ke-first mengerjakan penerima first, first + stride, ...
+typedef struct {
+    const PngCarrier* carrier;
+    const SteganographyRecipient* recipients;
+    SteganographyResult* results;
+    size_t count;
+    size_t first;
+    size_t stride;
+} MultiEmbedJob;
+
+static void run_multi_embed(MultiEmbedJob* job) {
+    for (size_t i = job->first; i < job->count; i += job->stride) {
+        const SteganographyRecipient* recipient = &job->recipients[i];
+        job->results[i] = png_carrier_embed(job->carrier, recipient->message, recipient->message_length,
+                                            recipient->password);
+    }
+}
+
+static uint32_t stego_hardware_threads(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors ? (uint32_t)info.dwNumberOfProcessors : 1;
+#else
+    const long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    return cores > 0 ? (uint32_t)cores : 1;
+#endif
+}
+
+#ifdef _WIN32
+static DWORD WINAPI multi_embed_thread(LPVOID arg) {
+    run_multi_embed((MultiEmbedJob*)arg);
+    return 0;
+}
+#else
+static void* multi_embed_thread(void* arg) {
+    run_multi_embed((MultiEmbedJob*)arg);
+    return NULL;
+}
+#endif
+
+size_t encode_lsb_png_multi(const uint8_t* pixels, size_t pixels_size,
+                            uint32_t width, uint32_t height, uint32_t channels,
+                            const SteganographyRecipient* recipients, size_t count,
+                            uint32_t max_threads, SteganographyResult* results) {
+    if (!results || count == 0) return 0;
+    const uint64_t started_ns = STEGO_METRICS_START();
+    memset(results, 0, count * sizeof(SteganographyResult));
+
+    SteganographyResult failure = {0};
+    PngCarrier carrier = {0};
+    if (!pixels || !recipients) {
+        set_error(&failure, "Invalid input data");
+    } else if (validate_png_geometry(&failure, pixels_size, width, height, channels) &&
+               !png_carrier_analyze(&carrier, pixels, pixels_size, width, height, channels)) {
+        set_error(&failure, "Memory allocation failed");
+    }
+    if (failure.error_message) {
+        png_carrier_release(&carrier);
+        for (size_t i = 0; i < count; i++) {
+            set_error(&results[i], failure.error_message);
+        }
+        free_steganography_result(&failure);
+        STEGO_METRICS_RECORD(started_ns, pixels_size, false);
+        return 0;
+    }
+
+    uint32_t threads = max_threads ? max_threads : stego_hardware_threads();
+    if (threads > STEGO_MAX_THREADS) threads = STEGO_MAX_THREADS;
+    if (threads > count) threads = (uint32_t)count;
+
+    MultiEmbedJob jobs[STEGO_MAX_THREADS];
+#ifdef _WIN32
+    HANDLE handles[STEGO_MAX_THREADS];
+#else
+    pthread_t handles[STEGO_MAX_THREADS];
+#endif
+    bool started[STEGO_MAX_THREADS] = {false};
+    for (uint32_t t = 0; t < threads; t++) {
+        jobs[t] = (MultiEmbedJob){&carrier, recipients, results, count, t, threads};
+    }
+    // Worker 0 jalan di thread pemanggil; worker yang gagal dibuat juga jalan di sini
+    for (uint32_t t = 1; t < threads; t++) {
+#ifdef _WIN32
+        handles[t] = CreateThread(NULL, 0, multi_embed_thread, &jobs[t], 0, NULL);
+        started[t] = handles[t] != NULL;
+#else
+        started[t] = pthread_create(&handles[t], NULL, multi_embed_thread, &jobs[t]) == 0;
+#endif
+    }
+    run_multi_embed(&jobs[0]);
+    for (uint32_t t = 1; t < threads; t++) {
+        if (!started[t]) {
+            run_multi_embed(&jobs[t]);
+            continue;
+        }
+#ifdef _WIN32
+        WaitForSingleObject(handles[t], INFINITE);
+        CloseHandle(handles[t]);
+#else
+        pthread_join(handles[t], NULL);
+#endif
+    }
+    png_carrier_release(&carrier);
+
+    size_t succeeded = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (results[i].success) succeeded++;
+    }
+    STEGO_METRICS_RECORD(started_ns, (uint64_t)pixels_size * count, succeeded == count);
+    return succeeded;
+}
+
+static SteganographyResult decode_png_internal(const uint8_t* pixels, size_t pixels_size,
+                                               uint32_t width, uint32_t height, uint32_t channels,
+                                               const char* password) {
+    SteganographyResult result = {0};
+    if (!pixels || !password) {
+        set_error(&result, "Invalid image data");
+        return result;
+    }
+    if (!validate_png_geometry(&result, pixels_size, width, height, channels)) {
+        return result;
+    }
+
+    const size_t max_capacity = get_max_capacity(pixels, pixels_size);
+    if (max_capacity < 8) {
+        set_error(&result, "Image too small");
+        return result;
+    }
+
+    PngCarrier carrier;
+    const uint64_t seed = password_seed(password) ^ (uint64_t)pixels_size;
+    uint32_t* order = png_carrier_analyze(&carrier, pixels, pixels_size, width, height, channels)
+                          ? png_carrier_order(&carrier, seed)
+                          : NULL;
+    png_carrier_release(&carrier);
+    if (!order) {
+        set_error(&result, "Memory allocation failed");
+        return result;
+    }
+
+    PngWalk walk;
+    png_walk_init(&walk, &carrier.regions, order, seed);
+    uint8_t header[4] = {0};
+    for (int j = 0; j < 32; j++) {
+        header[j >> 3] |= (uint8_t)((pixels[png_walk_next(&walk)] & 1) << (7 - (j & 7)));
+    }
+    uint8_t length_bytes[4];
+    memcpy(length_bytes, header, sizeof(header));
+    xor_encrypt(length_bytes, sizeof(length_bytes), password);
+    const size_t message_length = (size_t)length_bytes[0] | ((size_t)length_bytes[1] << 8) |
+                                  ((size_t)length_bytes[2] << 16) | ((size_t)length_bytes[3] << 24);
+    if (message_length + 8 > max_capacity) {
+        free(order);
+        set_error(&result, "No hidden message or wrong password");
+        return result;
+    }
+
+    const size_t payload_length = message_length + 4;
+    uint8_t* payload = calloc(payload_length + 1, 1);
+    if (!payload) {
+        free(order);
+        set_error(&result, "Memory allocation failed");
+        return result;
+    }
+    memcpy(payload, header, sizeof(header));
+    for (uint64_t j = 32; j < (uint64_t)payload_length * 8; j++) {
+        payload[j >> 3] |= (uint8_t)((pixels[png_walk_next(&walk)] & 1) << (7 - (j & 7)));
+    }
+    free(order);
+
+    xor_encrypt(payload, payload_length, password);
+    memmove(payload, payload + 4, message_length);
+    payload[message_length] = 0;
+
+    result.success = true;
+    result.data = payload;
+    result.data_length = message_length;
+    result.width = (int)width;
+    result.height = (int)height;
+    return result;
+}
+
+SteganographyResult decode_lsb_png(const uint8_t* pixels, size_t pixels_size,
+                                  uint32_t width, uint32_t height, uint32_t channels,
+                                  const char* password) {
+    const uint64_t started_ns = STEGO_METRICS_START();
+    SteganographyResult result = decode_png_internal(pixels, pixels_size, width, height, channels, password);
+    STEGO_METRICS_RECORD(started_ns, pixels_size, result.success);
+    return result;
+}
+
+SteganographyResult png_filter_scanlines(const uint8_t* pixels, size_t pixels_size,
+                                        uint32_t width, uint32_t height, uint32_t channels) {
+    SteganographyResult result = {0};
+    if (!pixels) {
+        set_error(&result, "Invalid image data");
+        return result;
+    }
+    if (!validate_png_geometry(&result, pixels_size, width, height, channels)) {
+        return result;
+    }
+
+    const size_t row_len = (size_t)width * channels;
+    result.data_length = (size_t)height * (row_len + 1);
+    result.data = malloc(result.data_length);
+    if (!result.data) {
+        result.data_length = 0;
+        set_error(&result, "Memory allocation failed");
+        return result;
+    }
+
+    // Filter dipilih ulang per baris setelah embedding: filter terbaik carrier asli belum
+    // tentu terbaik setelah LSB berubah
+    PngCostTable table;
+    png_cost_table_init(&table);
+    uint8_t* out = result.data;
+    for (uint32_t y = 0; y < height; y++) {
+        const uint8_t* row = pixels + (size_t)y * row_len;
+        const uint8_t* prev = y ? row - row_len : NULL;
+        const int filter = png_best_filter(&table, row, prev, 0, row_len, channels, 0xFF, NULL);
+        out[0] = (uint8_t)filter;
+        png_apply_filter(out + 1, row, prev, row_len, channels, filter);
+        out += row_len + 1;
+    }
+
+    result.success = true;
+    result.width = (int)width;
+    result.height = (int)height;
     return result;
 }
 
@@ -4,6 +4,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 // Struktur untuk hasil steganografi
 typedef struct {
@@ -15,15 +16,74 @@ typedef struct {
     int height;
 } SteganographyResult;
 
+// Hasil steganalisis (chi-square, RS, SPA) untuk self-check sebelum gambar dikirim
+typedef struct {
+    double chi_square;        // statistik chi-square pasangan nilai (2k, 2k+1)
+    double chi_square_p;      // probabilitas embedding menurut chi-square (0..1)
+    double rs_estimate;       // estimasi rasio embedding RS analysis (0..1)
+    double spa_estimate;      // estimasi rasio embedding sample pair analysis (0..1)
+    double detection_score;   // skor gabungan yang dibandingkan dengan threshold
+    bool lsb_matching_used;   // encoder beralih ke LSB matching (+-1)
+} SteganalysisReport;
+
 // Fungsi untuk encode pesan ke dalam gambar
 SteganographyResult encode_lsb_dct(const uint8_t* image_data, size_t image_size,
                                   const uint8_t* message, size_t message_length,
                                   const char* password);
 
+// Encode dengan self-check steganalisis yang dihitung di pass embed yang sama.
+// Jika detection_score > max_detection, encoder beralih ke LSB matching (+-1);
+// jika masih terdeteksi, encode gagal. report boleh NULL.
+SteganographyResult encode_lsb_dct_checked(const uint8_t* image_data, size_t image_size,
+                                          const uint8_t* message, size_t message_length,
+                                          const char* password, double max_detection,
+                                          SteganalysisReport* report);
+
+// Analisis gambar dengan chi-square, RS dan SPA dalam satu pass
+SteganalysisReport analyze_steganalysis(const uint8_t* image_data, size_t image_size);
+
 // Fungsi untuk decode pesan dari gambar
 SteganographyResult decode_lsb_dct(const uint8_t* image_data, size_t image_size,
                                   const char* password);
 
+// Encode untuk carrier yang akan disimpan sebagai PNG. pixels = sample 8 bit mentah
+// (width * height * channels, tanpa padding baris, channels 1..4). Bit dititipkan mulai
+// dari baris dengan residual filter tertinggi (diukur tanpa LSB) karena perubahan LSB di
+// area ramai hampir tidak menambah ukuran deflate. Selalu LSB replacement supaya decoder
+// bisa menghitung ulang urutan baris dari gambar stego.
+SteganographyResult encode_lsb_png(const uint8_t* pixels, size_t pixels_size,
+                                  uint32_t width, uint32_t height, uint32_t channels,
+                                  const uint8_t* message, size_t message_length,
+                                  const char* password);
+
+// Satu penerima untuk encode_lsb_png_multi
+typedef struct {
+    const uint8_t* message;
+    size_t message_length;
+    const char* password;
+} SteganographyRecipient;
+
+// Satu carrier untuk banyak penerima (pesan/password berbeda). Analisis carrier (biaya
+// region dan kapasitas) dihitung sekali; setiap output hanya menambah urutan region
+// ber-key, salinan carrier dan tulis LSB. Output dikerjakan paralel di max_threads thread
+// (0 = jumlah core, maksimal 16) dan identik dengan encode_lsb_png per penerima.
+// results[count] selalu diisi dan dibebaskan dengan free_steganography_result.
+// Return jumlah output yang berhasil.
+size_t encode_lsb_png_multi(const uint8_t* pixels, size_t pixels_size,
+                            uint32_t width, uint32_t height, uint32_t channels,
+                            const SteganographyRecipient* recipients, size_t count,
+                            uint32_t max_threads, SteganographyResult* results);
+
+SteganographyResult decode_lsb_png(const uint8_t* pixels, size_t pixels_size,
+                                  uint32_t width, uint32_t height, uint32_t channels,
+                                  const char* password);
+
+// Scanline terfilter siap di-deflate ke IDAT: per baris 1 byte tipe filter + residual,
+// filter dipilih per baris dengan estimator biaya di png_filter.h.
+// data_length = height * (1 + width * channels).
+SteganographyResult png_filter_scanlines(const uint8_t* pixels, size_t pixels_size,
+                                        uint32_t width, uint32_t height, uint32_t channels);
+
 // Fungsi untuk membersihkan memory
 void free_steganography_result(SteganographyResult* result);
 
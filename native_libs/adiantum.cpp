@@ -0,0 +1,270 @@
+#include "adiantum.h"
+#include "aes.h"
+#include "chacha20_poly1305.h"
+#include "native_metrics.h"
+
+#include <cstring>
+
+namespace {
+
+constexpr size_t kNhMessageBytes = 1024;
+constexpr size_t kNhUnitBytes = 16;
+constexpr size_t kNhKeyWords = 268;   // (1024 + 48) / 4
+constexpr size_t kNhHashBytes = 32;
+constexpr size_t kPolyKeyBytes = 16;
+constexpr size_t kDerivedBytes = AES256_KEY_BYTES + kPolyKeyBytes + kPolyKeyBytes + kNhKeyWords * 4;
+
+inline uint32_t load32_le(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+inline uint64_t load64_le(const uint8_t *p) {
+    return (uint64_t)load32_le(p) | ((uint64_t)load32_le(p + 4) << 32);
+}
+
+inline void store64_le(uint8_t *p, uint64_t v) {
+    for (int i = 0; i < 8; i++) {
+        p[i] = (uint8_t)(v >> (8 * i));
+    }
+}
+
+void secure_wipe(void *p, size_t len) {
+    volatile uint8_t *v = static_cast<volatile uint8_t *>(p);
+    for (size_t i = 0; i < len; i++) {
+        v[i] = 0;
+    }
+}
+
+// Bilangan 128-bit little-endian (le128 di Adiantum)
+void le128_add(uint8_t r[16], const uint8_t a[16], const uint8_t b[16]) {
+    const uint64_t lo = load64_le(a) + load64_le(b);
+    const uint64_t hi = load64_le(a + 8) + load64_le(b + 8) + (lo < load64_le(a) ? 1 : 0);
+    store64_le(r, lo);
+    store64_le(r + 8, hi);
+}
+
+void le128_sub(uint8_t r[16], const uint8_t a[16], const uint8_t b[16]) {
+    const uint64_t a_lo = load64_le(a);
+    const uint64_t lo = a_lo - load64_le(b);
+    const uint64_t hi = load64_le(a + 8) - load64_le(b + 8) - (lo > a_lo ? 1 : 0);
+    store64_le(r, lo);
+    store64_le(r + 8, hi);
+}
+
+}  // namespace
+
+struct AdiantumKey {
+    uint8_t stream_key[ADIANTUM_KEY_BYTES];
+    AES256_CTX aes;
+    // Poly1305 tanpa s (key = r || 0^16): final menghasilkan h mod 2^128
+    uint8_t header_poly_key[32];
+    uint8_t nh_poly_key[32];
+    uint32_t nh_key[kNhKeyWords];
+
+    void nh(const uint8_t *message, size_t len, uint8_t out[kNhHashBytes]) const;
+    void hash_message(const uint8_t *message, size_t len, uint8_t out[16]) const;
+    void hash_header(const uint8_t tweak[ADIANTUM_TWEAK_BYTES], size_t bulk_len, uint8_t out[16]) const;
+};
+
+// NH: len kelipatan 16, maksimal 1024
+void AdiantumKey::nh(const uint8_t *message, size_t len, uint8_t out[kNhHashBytes]) const {
+    uint64_t sums[4] = {0, 0, 0, 0};
+    const uint32_t *key = nh_key;
+    while (len > 0) {
+        const uint32_t m0 = load32_le(message + 0);
+        const uint32_t m1 = load32_le(message + 4);
+        const uint32_t m2 = load32_le(message + 8);
+        const uint32_t m3 = load32_le(message + 12);
+        sums[0] += (uint64_t)(uint32_t)(m0 + key[0]) * (uint32_t)(m2 + key[2]);
+        sums[1] += (uint64_t)(uint32_t)(m0 + key[4]) * (uint32_t)(m2 + key[6]);
+        sums[2] += (uint64_t)(uint32_t)(m0 + key[8]) * (uint32_t)(m2 + key[10]);
+        sums[3] += (uint64_t)(uint32_t)(m0 + key[12]) * (uint32_t)(m2 + key[14]);
+        sums[0] += (uint64_t)(uint32_t)(m1 + key[1]) * (uint32_t)(m3 + key[3]);
+        sums[1] += (uint64_t)(uint32_t)(m1 + key[5]) * (uint32_t)(m3 + key[7]);
+        sums[2] += (uint64_t)(uint32_t)(m1 + key[9]) * (uint32_t)(m3 + key[11]);
+        sums[3] += (uint64_t)(uint32_t)(m1 + key[13]) * (uint32_t)(m3 + key[15]);
+        key += kNhUnitBytes / 4;
+        message += kNhUnitBytes;
+        len -= kNhUnitBytes;
+    }
+    for (int i = 0; i < 4; i++) {
+        store64_le(out + 8 * i, sums[i]);
+    }
+}
+
+// NHPoly1305: Poly1305 atas hash NH setiap chunk 1024 byte (unit terakhir di-pad nol)
+void AdiantumKey::hash_message(const uint8_t *message, size_t len, uint8_t out[16]) const {
+    POLY1305_CTX poly;
+    poly1305_init(&poly, nh_poly_key);
+    uint8_t nh_hash[kNhHashBytes];
+
+    while (len >= kNhUnitBytes) {
+        const size_t full = len & ~(kNhUnitBytes - 1);
+        const size_t chunk = full < kNhMessageBytes ? full : kNhMessageBytes;
+        if (chunk < kNhMessageBytes && len > chunk) {
+            // Chunk terakhir dengan unit parsial: gabungkan di bawah
+            break;
+        }
+        nh(message, chunk, nh_hash);
+        poly1305_update(&poly, nh_hash, kNhHashBytes);
+        message += chunk;
+        len -= chunk;
+    }
+    if (len > 0) {
+        uint8_t tail[kNhMessageBytes];
+        memcpy(tail, message, len);
+        const size_t padded = (len + kNhUnitBytes - 1) & ~(kNhUnitBytes - 1);
+        memset(tail + len, 0, padded - len);
+        nh(tail, padded, nh_hash);
+        poly1305_update(&poly, nh_hash, kNhHashBytes);
+        secure_wipe(tail, padded);
+    }
+
+    poly1305_final(&poly, out);
+    secure_wipe(nh_hash, sizeof(nh_hash));
+}
+
+void AdiantumKey::hash_header(const uint8_t tweak[ADIANTUM_TWEAK_BYTES], size_t bulk_len, uint8_t out[16]) const {
+    uint8_t header[16] = {0};
+    store64_le(header, (uint64_t)bulk_len * 8);
+
+    POLY1305_CTX poly;
+    poly1305_init(&poly, header_poly_key);
+    poly1305_update(&poly, header, sizeof(header));
+    poly1305_update(&poly, tweak, ADIANTUM_TWEAK_BYTES);
+    poly1305_final(&poly, out);
+}
+
+namespace {
+
+// Enkripsi/dekripsi satu pesan, mengikuti adiantum_crypt + adiantum_finish
+void adiantum_crypt(const AdiantumKey *key, uint8_t *data, size_t len,
+                    const uint8_t tweak[ADIANTUM_TWEAK_BYTES], bool encrypt) {
+    const size_t bulk_len = len - AES_BLOCK_BYTES;
+    uint8_t *right = data + bulk_len;
+
+    uint8_t header_hash[16];
+    uint8_t digest[16];
+    uint8_t block[16];
+    key->hash_header(tweak, bulk_len, header_hash);
+
+    // P_M = P_R + H(T, P_L)   /   C_M = C_R + H(T, C_L)
+    key->hash_message(data, bulk_len, digest);
+    le128_add(digest, digest, header_hash);
+    le128_add(block, right, digest);
+
+    uint8_t c_m[16];
+    if (encrypt) {
+        aes256_encrypt_block(&key->aes, c_m, block);
+    } else {
+        memcpy(c_m, block, 16);
+    }
+
+    // Bulk: XOR keystream XChaCha12 dengan nonce C_M || 1 || 0^7
+    uint8_t nonce[XCHACHA_NONCE_BYTES] = {0};
+    memcpy(nonce, c_m, 16);
+    nonce[16] = 1;
+    xchacha12_xor(data, data, bulk_len, key->stream_key, nonce);
+
+    // C_R = C_M - H(T, C_L)   /   P_R = D(C_M) - H(T, P_L)
+    if (encrypt) {
+        memcpy(block, c_m, 16);
+    } else {
+        aes256_decrypt_block(&key->aes, block, c_m);
+    }
+    key->hash_message(data, bulk_len, digest);
+    le128_add(digest, digest, header_hash);
+    le128_sub(right, block, digest);
+
+    secure_wipe(header_hash, sizeof(header_hash));
+    secure_wipe(digest, sizeof(digest));
+    secure_wipe(block, sizeof(block));
+    secure_wipe(c_m, sizeof(c_m));
+    secure_wipe(nonce, sizeof(nonce));
+}
+
+int crypt_pages(const AdiantumKey *key, uint8_t *data, size_t len,
+                const uint8_t file_id[ADIANTUM_FILE_ID_BYTES], uint64_t first_page, bool encrypt) {
+    if (!key || !file_id || (!data && len)) return ADIANTUM_ERROR_INVALID_INPUT;
+    if (len < ADIANTUM_MIN_BYTES) return ADIANTUM_ERROR_TOO_SHORT;
+
+    const uint64_t started_ns = native_metrics_now_ns();
+    uint8_t tweak[ADIANTUM_TWEAK_BYTES] = {0};
+    memcpy(tweak, file_id, ADIANTUM_FILE_ID_BYTES);
+
+    uint64_t page = first_page;
+    size_t remaining = len;
+    while (remaining > 0) {
+        size_t page_len = remaining < ADIANTUM_PAGE_BYTES ? remaining : ADIANTUM_PAGE_BYTES;
+        // Sisa akhir file yang lebih pendek dari satu blok ikut halaman ini
+        if (remaining - page_len < ADIANTUM_MIN_BYTES) page_len = remaining;
+
+        store64_le(tweak + ADIANTUM_FILE_ID_BYTES, page);
+        adiantum_crypt(key, data, page_len, tweak, encrypt);
+        data += page_len;
+        remaining -= page_len;
+        page++;
+    }
+    native_metrics_record(NATIVE_METRICS_CACHE, started_ns, len, 1);
+    return ADIANTUM_OK;
+}
+
+}  // namespace
+
+extern "C" AdiantumKey *adiantum_create(const uint8_t key[ADIANTUM_KEY_BYTES]) {
+    if (!key) return nullptr;
+
+    auto *k = new AdiantumKey();
+    memcpy(k->stream_key, key, ADIANTUM_KEY_BYTES);
+
+    // Subkey = XChaCha12(K, 1 || 0^23) atas buffer nol
+    uint8_t derived[kDerivedBytes] = {0};
+    uint8_t nonce[XCHACHA_NONCE_BYTES] = {0};
+    nonce[0] = 1;
+    xchacha12_xor(derived, derived, sizeof(derived), key, nonce);
+
+    const uint8_t *p = derived;
+    aes256_init(&k->aes, p);
+    p += AES256_KEY_BYTES;
+    memcpy(k->header_poly_key, p, kPolyKeyBytes);
+    p += kPolyKeyBytes;
+    memcpy(k->nh_poly_key, p, kPolyKeyBytes);
+    p += kPolyKeyBytes;
+    for (size_t i = 0; i < kNhKeyWords; i++) {
+        k->nh_key[i] = load32_le(p + 4 * i);
+    }
+    secure_wipe(derived, sizeof(derived));
+    return k;
+}
+
+extern "C" void adiantum_destroy(AdiantumKey *key) {
+    if (!key) return;
+    secure_wipe(key, sizeof(*key));
+    delete key;
+}
+
+extern "C" int adiantum_encrypt(const AdiantumKey *key, uint8_t *data, size_t len,
+                                const uint8_t tweak[ADIANTUM_TWEAK_BYTES]) {
+    if (!key || !tweak || !data) return ADIANTUM_ERROR_INVALID_INPUT;
+    if (len < ADIANTUM_MIN_BYTES) return ADIANTUM_ERROR_TOO_SHORT;
+    adiantum_crypt(key, data, len, tweak, true);
+    return ADIANTUM_OK;
+}
+
+extern "C" int adiantum_decrypt(const AdiantumKey *key, uint8_t *data, size_t len,
+                                const uint8_t tweak[ADIANTUM_TWEAK_BYTES]) {
+    if (!key || !tweak || !data) return ADIANTUM_ERROR_INVALID_INPUT;
+    if (len < ADIANTUM_MIN_BYTES) return ADIANTUM_ERROR_TOO_SHORT;
+    adiantum_crypt(key, data, len, tweak, false);
+    return ADIANTUM_OK;
+}
+
+extern "C" int adiantum_encrypt_pages(const AdiantumKey *key, uint8_t *data, size_t len,
+                                      const uint8_t file_id[ADIANTUM_FILE_ID_BYTES], uint64_t first_page) {
+    return crypt_pages(key, data, len, file_id, first_page, true);
+}
+
+extern "C" int adiantum_decrypt_pages(const AdiantumKey *key, uint8_t *data, size_t len,
+                                      const uint8_t file_id[ADIANTUM_FILE_ID_BYTES], uint64_t first_page) {
+    return crypt_pages(key, data, len, file_id, first_page, false);
+}
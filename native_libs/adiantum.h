@@ -0,0 +1,51 @@
+#ifndef ADIANTUM_H
+#define ADIANTUM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Adiantum (Crowley & Biggers 2018): cipher wide-block tweakable yang length-preserving,
+// XChaCha12 + AES-256 (satu blok) + NH + Poly1305, dengan layout key seperti
+// crypto/adiantum.c di Linux. Dipakai file halaman chat_cache: setiap halaman 4 KiB dienkripsi
+// in-place tanpa nonce/tag tambahan, sehingga file cache bisa dibaca/ditulis acak per halaman.
+//
+// Tidak ada autentikasi: perubahan satu bit mengacak seluruh halaman (bukan hanya bit itu),
+// tapi tidak terdeteksi. Cocok untuk data turunan yang bisa dibuang, bukan pengganti AEAD.
+
+#define ADIANTUM_KEY_BYTES 32
+#define ADIANTUM_TWEAK_BYTES 32
+#define ADIANTUM_MIN_BYTES 16
+#define ADIANTUM_PAGE_BYTES 4096
+#define ADIANTUM_FILE_ID_BYTES 16
+
+#define ADIANTUM_OK 0
+#define ADIANTUM_ERROR_INVALID_INPUT -1
+#define ADIANTUM_ERROR_TOO_SHORT -2
+
+typedef struct AdiantumKey AdiantumKey;
+
+// Turunkan subkey (AES, Poly1305, NH) dari key 32 byte
+AdiantumKey *adiantum_create(const uint8_t key[ADIANTUM_KEY_BYTES]);
+void adiantum_destroy(AdiantumKey *key);
+
+// Satu pesan (len >= 16) in-place
+int adiantum_encrypt(const AdiantumKey *key, uint8_t *data, size_t len, const uint8_t tweak[ADIANTUM_TWEAK_BYTES]);
+int adiantum_decrypt(const AdiantumKey *key, uint8_t *data, size_t len, const uint8_t tweak[ADIANTUM_TWEAK_BYTES]);
+
+// Range halaman file mulai first_page, in-place. Tweak halaman = file_id || LE64(index) || 0^8.
+// len harus kelipatan ADIANTUM_PAGE_BYTES kecuali range berakhir di akhir file; sisa akhir
+// file < 16 byte digabung ke halaman sebelumnya (halaman terakhir boleh s/d 4111 byte).
+int adiantum_encrypt_pages(const AdiantumKey *key, uint8_t *data, size_t len,
+                           const uint8_t file_id[ADIANTUM_FILE_ID_BYTES], uint64_t first_page);
+int adiantum_decrypt_pages(const AdiantumKey *key, uint8_t *data, size_t len,
+                           const uint8_t file_id[ADIANTUM_FILE_ID_BYTES], uint64_t first_page);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
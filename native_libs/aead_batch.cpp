@@ -0,0 +1,504 @@
+#include "aead_batch.h"
+#include "cpu_features.h"
+#include "native_metrics.h"
+
+#include <cstring>
+#include <vector>
+
+// Kernel blok ChaCha20 multi-lane: setiap lane vektor = state pesan yang berbeda
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#define AEAD_BATCH_HAVE_AVX2 1
+#define AEAD_BATCH_HAVE_VEC4 1
+typedef __m128i vec4;
+#define V_LOAD(p) _mm_loadu_si128((const __m128i *)(p))
+#define V_STORE(p, v) _mm_storeu_si128((__m128i *)(p), v)
+#define V_ADD(a, b) _mm_add_epi32(a, b)
+#define V_XOR(a, b) _mm_xor_si128(a, b)
+#define V_ROTL(a, n) _mm_or_si128(_mm_slli_epi32(a, n), _mm_srli_epi32(a, 32 - (n)))
+#if defined(__GNUC__) || defined(__clang__)
+#define AVX2_TARGET __attribute__((target("avx2")))
+#else
+#define AVX2_TARGET
+#endif
+#elif defined(__ARM_NEON) || defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define AEAD_BATCH_HAVE_VEC4 1
+typedef uint32x4_t vec4;
+#define V_LOAD(p) vld1q_u32(p)
+#define V_STORE(p, v) vst1q_u32(p, v)
+#define V_ADD(a, b) vaddq_u32(a, b)
+#define V_XOR(a, b) veorq_u32(a, b)
+#define V_ROTL(a, n) vorrq_u32(vshlq_n_u32(a, n), vshrq_n_u32(a, 32 - (n)))
+#elif defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#define AEAD_BATCH_HAVE_VEC4 1
+typedef v128_t vec4;
+#define V_LOAD(p) wasm_v128_load(p)
+#define V_STORE(p, v) wasm_v128_store(p, v)
+#define V_ADD(a, b) wasm_i32x4_add(a, b)
+#define V_XOR(a, b) wasm_v128_xor(a, b)
+#define V_ROTL(a, n) wasm_v128_or(wasm_i32x4_shl(a, n), wasm_u32x4_shr(a, 32 - (n)))
+#endif
+
+namespace {
+
+constexpr uint32_t kSigma[4] = {0x61707865, 0x3320646e, 0x79622d32, 0x6b206574};
+constexpr uint8_t kZeroPad[16] = {0};
+
+// Word state ke-i untuk lane l ada di words[i][l]
+typedef uint32_t LaneWords[16][AEAD_BATCH_MAX_LANES];
+typedef void (*BlockKernel)(LaneWords out, LaneWords in);
+struct PolyLanes;
+typedef void (*PolyKernel)(PolyLanes &p, uint32_t lanes);
+
+struct Kernel {
+    BlockKernel block;
+    PolyKernel poly;
+    uint32_t lanes;
+};
+
+inline uint32_t load32_le(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+inline void store32_le(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+void secure_wipe(void *p, size_t len) {
+    volatile uint8_t *v = static_cast<volatile uint8_t *>(p);
+    for (size_t i = 0; i < len; i++) {
+        v[i] = 0;
+    }
+}
+
+inline uint32_t rotl32(uint32_t v, int n) {
+    return (v << n) | (v >> (32 - n));
+}
+
+#define QUARTER_ROUND(a, b, c, d) \
+    a += b; d ^= a; d = rotl32(d, 16); \
+    c += d; b ^= c; b = rotl32(b, 12); \
+    a += b; d ^= a; d = rotl32(d, 8);  \
+    c += d; b ^= c; b = rotl32(b, 7);
+
+void block_x1(LaneWords out, LaneWords in) {
+    uint32_t x[16];
+    for (int i = 0; i < 16; i++) x[i] = in[i][0];
+    for (int i = 0; i < 10; i++) {
+        QUARTER_ROUND(x[0], x[4], x[8], x[12]);
+        QUARTER_ROUND(x[1], x[5], x[9], x[13]);
+        QUARTER_ROUND(x[2], x[6], x[10], x[14]);
+        QUARTER_ROUND(x[3], x[7], x[11], x[15]);
+        QUARTER_ROUND(x[0], x[5], x[10], x[15]);
+        QUARTER_ROUND(x[1], x[6], x[11], x[12]);
+        QUARTER_ROUND(x[2], x[7], x[8], x[13]);
+        QUARTER_ROUND(x[3], x[4], x[9], x[14]);
+    }
+    for (int i = 0; i < 16; i++) out[i][0] = x[i] + in[i][0];
+    secure_wipe(x, sizeof(x));
+}
+
+#ifdef AEAD_BATCH_HAVE_VEC4
+#define V_QUARTER_ROUND(a, b, c, d) \
+    a = V_ADD(a, b); d = V_XOR(d, a); d = V_ROTL(d, 16); \
+    c = V_ADD(c, d); b = V_XOR(b, c); b = V_ROTL(b, 12); \
+    a = V_ADD(a, b); d = V_XOR(d, a); d = V_ROTL(d, 8);  \
+    c = V_ADD(c, d); b = V_XOR(b, c); b = V_ROTL(b, 7);
+
+void block_x4(LaneWords out, LaneWords in) {
+    vec4 x[16];
+    for (int i = 0; i < 16; i++) x[i] = V_LOAD(in[i]);
+    for (int i = 0; i < 10; i++) {
+        V_QUARTER_ROUND(x[0], x[4], x[8], x[12]);
+        V_QUARTER_ROUND(x[1], x[5], x[9], x[13]);
+        V_QUARTER_ROUND(x[2], x[6], x[10], x[14]);
+        V_QUARTER_ROUND(x[3], x[7], x[11], x[15]);
+        V_QUARTER_ROUND(x[0], x[5], x[10], x[15]);
+        V_QUARTER_ROUND(x[1], x[6], x[11], x[12]);
+        V_QUARTER_ROUND(x[2], x[7], x[8], x[13]);
+        V_QUARTER_ROUND(x[3], x[4], x[9], x[14]);
+    }
+    for (int i = 0; i < 16; i++) V_STORE(out[i], V_ADD(x[i], V_LOAD(in[i])));
+}
+#endif
+
+#ifdef AEAD_BATCH_HAVE_AVX2
+#define W_ADD(a, b) _mm256_add_epi32(a, b)
+#define W_XOR(a, b) _mm256_xor_si256(a, b)
+#define W_ROTL(a, n) _mm256_or_si256(_mm256_slli_epi32(a, n), _mm256_srli_epi32(a, 32 - (n)))
+#define W_QUARTER_ROUND(a, b, c, d) \
+    a = W_ADD(a, b); d = W_XOR(d, a); d = W_ROTL(d, 16); \
+    c = W_ADD(c, d); b = W_XOR(b, c); b = W_ROTL(b, 12); \
+    a = W_ADD(a, b); d = W_XOR(d, a); d = W_ROTL(d, 8);  \
+    c = W_ADD(c, d); b = W_XOR(b, c); b = W_ROTL(b, 7);
+
+AVX2_TARGET void block_x8(LaneWords out, LaneWords in) {
+    __m256i x[16];
+    for (int i = 0; i < 16; i++) x[i] = _mm256_loadu_si256((const __m256i *)in[i]);
+    for (int i = 0; i < 10; i++) {
+        W_QUARTER_ROUND(x[0], x[4], x[8], x[12]);
+        W_QUARTER_ROUND(x[1], x[5], x[9], x[13]);
+        W_QUARTER_ROUND(x[2], x[6], x[10], x[14]);
+        W_QUARTER_ROUND(x[3], x[7], x[11], x[15]);
+        W_QUARTER_ROUND(x[0], x[5], x[10], x[15]);
+        W_QUARTER_ROUND(x[1], x[6], x[11], x[12]);
+        W_QUARTER_ROUND(x[2], x[7], x[8], x[13]);
+        W_QUARTER_ROUND(x[3], x[4], x[9], x[14]);
+    }
+    for (int i = 0; i < 16; i++) {
+        _mm256_storeu_si256((__m256i *)out[i], W_ADD(x[i], _mm256_loadu_si256((const __m256i *)in[i])));
+    }
+    _mm256_zeroupper();
+}
+#endif
+
+bool item_valid(const AeadBatchItem &item) {
+    return item.key && item.nonce && item.tag && (!item.len || (item.in && item.out)) &&
+           (!item.aad_len || item.aad);
+}
+
+// Jalankan blok counter [first, last] untuk setiap item dengan status OK. Blok 0 adalah
+// one-time key Poly1305 (ditulis ke otks), blok >= 1 di-XOR ke data item. Lane yang
+// pesannya selesai langsung diisi item berikutnya.
+void chacha_lanes(const Kernel &kernel, AeadBatchItem *items, size_t count, uint8_t *otks,
+                  bool with_otk, bool with_data) {
+    LaneWords in;
+    LaneWords out;
+    size_t lane_item[AEAD_BATCH_MAX_LANES];
+    uint32_t lane_end[AEAD_BATCH_MAX_LANES];
+    bool lane_active[AEAD_BATCH_MAX_LANES] = {false};
+    const uint32_t lanes = kernel.lanes;
+    for (int i = 0; i < 4; i++) {
+        for (uint32_t l = 0; l < lanes; l++) in[i][l] = kSigma[i];
+    }
+
+    size_t next = 0;
+    while (true) {
+        uint32_t active = 0;
+        for (uint32_t l = 0; l < lanes; l++) {
+            while (!lane_active[l] && next < count) {
+                const size_t index = next++;
+                const AeadBatchItem &item = items[index];
+                const uint32_t blocks = (item.len + 63) / 64;
+                if (item.status != AEAD_OK || (!with_otk && blocks == 0)) continue;
+
+                lane_item[l] = index;
+                lane_end[l] = with_data ? blocks : 0;
+                lane_active[l] = true;
+                for (int i = 0; i < 8; i++) in[4 + i][l] = load32_le(item.key + 4 * i);
+                in[12][l] = with_otk ? 0 : 1;
+                for (int i = 0; i < 3; i++) in[13 + i][l] = load32_le(item.nonce + 4 * i);
+            }
+            if (lane_active[l]) {
+                active++;
+            } else {
+                // Lane kosong tetap dihitung kernel; isi nol supaya tidak ada key basi
+                for (int i = 4; i < 16; i++) in[i][l] = 0;
+            }
+        }
+        if (active == 0) break;
+
+        kernel.block(out, in);
+
+        for (uint32_t l = 0; l < lanes; l++) {
+            if (!lane_active[l]) continue;
+            AeadBatchItem &item = items[lane_item[l]];
+            const uint32_t counter = in[12][l];
+            if (counter == 0) {
+                uint8_t *otk = otks + lane_item[l] * POLY1305_KEY_BYTES;
+                for (int i = 0; i < 8; i++) store32_le(otk + 4 * i, out[i][l]);
+            } else {
+                const size_t offset = (size_t)(counter - 1) * 64;
+                const uint8_t *src = item.in + offset;
+                uint8_t *dst = item.out + offset;
+                if (item.len - offset >= 64) {
+                    for (int i = 0; i < 16; i++) {
+                        store32_le(dst + 4 * i, load32_le(src + 4 * i) ^ out[i][l]);
+                    }
+                } else {
+                    uint8_t stream[64];
+                    for (int i = 0; i < 16; i++) store32_le(stream + 4 * i, out[i][l]);
+                    for (size_t i = 0; i < item.len - offset; i++) dst[i] = src[i] ^ stream[i];
+                    secure_wipe(stream, sizeof(stream));
+                }
+            }
+
+            if (counter >= lane_end[l]) {
+                lane_active[l] = false;
+            } else {
+                in[12][l] = counter + 1;
+            }
+        }
+    }
+    secure_wipe(in, sizeof(in));
+    secure_wipe(out, sizeof(out));
+}
+
+// Input Poly1305 AEAD per item: aad | pad | ciphertext | pad | panjang. Semua blok
+// 16 byte penuh, jadi hibit selalu 1 dan tidak ada blok parsial.
+struct PolyStream {
+    const uint8_t *aad;
+    size_t aad_len;
+    const uint8_t *ct;
+    size_t ct_len;
+    size_t aad_blocks;
+    size_t ct_blocks;
+    size_t position;
+    uint8_t lengths[16];
+
+    void init(const uint8_t *a, size_t alen, const uint8_t *c, size_t clen) {
+        aad = a;
+        aad_len = alen;
+        ct = c;
+        ct_len = clen;
+        aad_blocks = (alen + 15) / 16;
+        ct_blocks = (clen + 15) / 16;
+        position = 0;
+        for (int i = 0; i < 8; i++) {
+            lengths[i] = (uint8_t)((uint64_t)alen >> (8 * i));
+            lengths[8 + i] = (uint8_t)((uint64_t)clen >> (8 * i));
+        }
+    }
+
+    bool done() const { return position > aad_blocks + ct_blocks; }
+
+    // Blok berikutnya; buffer dipakai jika blok perlu padding
+    const uint8_t *next(uint8_t buffer[16]) {
+        const size_t p = position++;
+        const uint8_t *src;
+        size_t avail;
+        if (p < aad_blocks) {
+            src = aad + p * 16;
+            avail = aad_len - p * 16;
+        } else if (p < aad_blocks + ct_blocks) {
+            src = ct + (p - aad_blocks) * 16;
+            avail = ct_len - (p - aad_blocks) * 16;
+        } else {
+            return lengths;
+        }
+        if (avail >= 16) return src;
+        memcpy(buffer, src, avail);
+        memcpy(buffer + avail, kZeroPad, 16 - avail);
+        return buffer;
+    }
+};
+
+// Poly1305 multi-lane (limb 26 bit, struct-of-arrays): setiap lane satu pesan, satu blok
+// per lane per langkah. Loop per lane tanpa cabang sehingga bisa divektorisasi compiler.
+struct PolyLanes {
+    uint32_t r[5][AEAD_BATCH_MAX_LANES];
+    uint32_t s[5][AEAD_BATCH_MAX_LANES];
+    uint32_t h[5][AEAD_BATCH_MAX_LANES];
+    uint32_t m[5][AEAD_BATCH_MAX_LANES];
+    uint32_t keep[AEAD_BATCH_MAX_LANES];   // 0xFFFFFFFF = lane tidak aktif, h tidak berubah
+};
+
+#define POLY_LANES_BLOCK_BODY \
+    for (uint32_t l = 0; l < lanes; l++) { \
+        const uint32_t h0 = p.h[0][l] + p.m[0][l], h1 = p.h[1][l] + p.m[1][l], h2 = p.h[2][l] + p.m[2][l]; \
+        const uint32_t h3 = p.h[3][l] + p.m[3][l], h4 = p.h[4][l] + p.m[4][l]; \
+        const uint32_t r0 = p.r[0][l], r1 = p.r[1][l], r2 = p.r[2][l], r3 = p.r[3][l], r4 = p.r[4][l]; \
+        const uint32_t s1 = p.s[1][l], s2 = p.s[2][l], s3 = p.s[3][l], s4 = p.s[4][l]; \
+ \
+        uint64_t d0 = (uint64_t)h0 * r0 + (uint64_t)h1 * s4 + (uint64_t)h2 * s3 + (uint64_t)h3 * s2 + (uint64_t)h4 * s1; \
+        uint64_t d1 = (uint64_t)h0 * r1 + (uint64_t)h1 * r0 + (uint64_t)h2 * s4 + (uint64_t)h3 * s3 + (uint64_t)h4 * s2; \
+        uint64_t d2 = (uint64_t)h0 * r2 + (uint64_t)h1 * r1 + (uint64_t)h2 * r0 + (uint64_t)h3 * s4 + (uint64_t)h4 * s3; \
+        uint64_t d3 = (uint64_t)h0 * r3 + (uint64_t)h1 * r2 + (uint64_t)h2 * r1 + (uint64_t)h3 * r0 + (uint64_t)h4 * s4; \
+        uint64_t d4 = (uint64_t)h0 * r4 + (uint64_t)h1 * r3 + (uint64_t)h2 * r2 + (uint64_t)h3 * r1 + (uint64_t)h4 * r0; \
+ \
+        uint32_t c = (uint32_t)(d0 >> 26); uint32_t n0 = (uint32_t)d0 & 0x3ffffff; \
+        d1 += c; c = (uint32_t)(d1 >> 26); uint32_t n1 = (uint32_t)d1 & 0x3ffffff; \
+        d2 += c; c = (uint32_t)(d2 >> 26); const uint32_t n2 = (uint32_t)d2 & 0x3ffffff; \
+        d3 += c; c = (uint32_t)(d3 >> 26); const uint32_t n3 = (uint32_t)d3 & 0x3ffffff; \
+        d4 += c; c = (uint32_t)(d4 >> 26); const uint32_t n4 = (uint32_t)d4 & 0x3ffffff; \
+        n0 += c * 5; c = n0 >> 26; n0 &= 0x3ffffff; \
+        n1 += c; \
+ \
+        const uint32_t keep = p.keep[l]; \
+        p.h[0][l] = (p.h[0][l] & keep) | (n0 & ~keep); \
+        p.h[1][l] = (p.h[1][l] & keep) | (n1 & ~keep); \
+        p.h[2][l] = (p.h[2][l] & keep) | (n2 & ~keep); \
+        p.h[3][l] = (p.h[3][l] & keep) | (n3 & ~keep); \
+        p.h[4][l] = (p.h[4][l] & keep) | (n4 & ~keep); \
+    }
+
+void poly_lanes_block(PolyLanes &p, uint32_t lanes) {
+    POLY_LANES_BLOCK_BODY
+}
+
+#ifdef AEAD_BATCH_HAVE_AVX2
+// Body sama, dikompilasi dengan AVX2 supaya 8 lane di-vektorisasi (vpmuludq)
+AVX2_TARGET void poly_lanes_block_avx2(PolyLanes &p, uint32_t) {
+    const uint32_t lanes = 8;
+    POLY_LANES_BLOCK_BODY
+}
+#endif
+
+
+Kernel select_kernel() {
+    const uint32_t features = cpu_features_get();
+#ifdef AEAD_BATCH_HAVE_AVX2
+    if (features & CPU_FEATURE_AVX2) return {block_x8, poly_lanes_block_avx2, 8};
+#endif
+#ifdef AEAD_BATCH_HAVE_VEC4
+    if (features & (CPU_FEATURE_SSE2 | CPU_FEATURE_NEON | CPU_FEATURE_SIMD128)) return {block_x4, poly_lanes_block, 4};
+#endif
+    (void)features;
+    return {block_x1, poly_lanes_block, 1};
+}
+
+// Hitung tag setiap item dengan status OK. Untuk open, tag dibandingkan constant-time
+// dan item yang gagal diberi AEAD_ERROR_AUTH_FAILED.
+void poly_lanes(const Kernel &kernel, AeadBatchItem *items, size_t count, const uint8_t *otks,
+                const uint8_t *const *ciphertexts, bool verify) {
+    PolyLanes p;
+    memset(&p, 0, sizeof(p));
+    PolyStream streams[AEAD_BATCH_MAX_LANES];
+    POLY1305_CTX ctx[AEAD_BATCH_MAX_LANES];
+    size_t lane_item[AEAD_BATCH_MAX_LANES];
+    bool lane_active[AEAD_BATCH_MAX_LANES] = {false};
+    uint8_t buffer[16];
+    const uint32_t lanes = kernel.lanes;
+
+    size_t next = 0;
+    while (true) {
+        uint32_t active = 0;
+        for (uint32_t l = 0; l < lanes; l++) {
+            while (!lane_active[l] && next < count) {
+                const size_t index = next++;
+                const AeadBatchItem &item = items[index];
+                if (item.status != AEAD_OK) continue;
+
+                lane_item[l] = index;
+                lane_active[l] = true;
+                // r dan pad di-clamp persis seperti poly1305_init
+                poly1305_init(&ctx[l], otks + index * POLY1305_KEY_BYTES);
+                for (int i = 0; i < 5; i++) {
+                    p.r[i][l] = ctx[l].r[i];
+                    p.s[i][l] = ctx[l].r[i] * 5;
+                    p.h[i][l] = 0;
+                }
+                streams[l].init(item.aad, item.aad_len, ciphertexts[index], item.len);
+            }
+
+            if (!lane_active[l]) {
+                p.keep[l] = 0xFFFFFFFFu;
+                for (int i = 0; i < 5; i++) p.m[i][l] = 0;
+                continue;
+            }
+            active++;
+            const uint8_t *block = streams[l].next(buffer);
+            p.keep[l] = 0;
+            p.m[0][l] = (load32_le(block + 0)) & 0x3ffffff;
+            p.m[1][l] = (load32_le(block + 3) >> 2) & 0x3ffffff;
+            p.m[2][l] = (load32_le(block + 6) >> 4) & 0x3ffffff;
+            p.m[3][l] = (load32_le(block + 9) >> 6) & 0x3ffffff;
+            p.m[4][l] = (load32_le(block + 12) >> 8) | (1u << 24);
+        }
+        if (active == 0) break;
+
+        kernel.poly(p, lanes);
+
+        for (uint32_t l = 0; l < lanes; l++) {
+            if (!lane_active[l] || !streams[l].done()) continue;
+            lane_active[l] = false;
+
+            AeadBatchItem &item = items[lane_item[l]];
+            for (int i = 0; i < 5; i++) ctx[l].h[i] = p.h[i][l];
+            ctx[l].leftover = 0;
+            uint8_t tag[POLY1305_TAG_BYTES];
+            poly1305_final(&ctx[l], tag);
+            if (!verify) {
+                memcpy(item.tag, tag, sizeof(tag));
+                continue;
+            }
+            uint8_t diff = 0;
+            for (int i = 0; i < POLY1305_TAG_BYTES; i++) {
+                diff |= tag[i] ^ item.tag[i];
+            }
+            if (diff != 0) item.status = AEAD_ERROR_AUTH_FAILED;
+        }
+    }
+    secure_wipe(&p, sizeof(p));
+    secure_wipe(ctx, sizeof(ctx));
+    secure_wipe(buffer, sizeof(buffer));
+}
+
+size_t prepare(AeadBatchItem *items, size_t count, uint64_t &bytes) {
+    size_t valid = 0;
+    bytes = 0;
+    for (size_t i = 0; i < count; i++) {
+        items[i].status = item_valid(items[i]) ? AEAD_OK : AEAD_ERROR_INVALID_INPUT;
+        if (items[i].status == AEAD_OK) {
+            valid++;
+            bytes += items[i].len;
+        }
+    }
+    return valid;
+}
+
+size_t count_ok(const AeadBatchItem *items, size_t count) {
+    size_t ok = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (items[i].status == AEAD_OK) ok++;
+    }
+    return ok;
+}
+
+}  // namespace
+
+extern "C" uint32_t aead_batch_lanes(void) {
+    return select_kernel().lanes;
+}
+
+extern "C" size_t chacha20_poly1305_seal_batch(AeadBatchItem *items, size_t count) {
+    if (!items || count == 0) return 0;
+    const uint64_t started_ns = native_metrics_now_ns();
+    uint64_t bytes = 0;
+    if (prepare(items, count, bytes) == 0) return 0;
+
+    const Kernel kernel = select_kernel();
+    std::vector<uint8_t> otks(count * POLY1305_KEY_BYTES);
+    std::vector<const uint8_t *> ciphertexts(count);
+    for (size_t i = 0; i < count; i++) {
+        ciphertexts[i] = items[i].out;
+    }
+
+    // OTK dan ciphertext dalam satu lintasan lane, lalu tag dari ciphertext
+    chacha_lanes(kernel, items, count, otks.data(), true, true);
+    poly_lanes(kernel, items, count, otks.data(), ciphertexts.data(), false);
+    secure_wipe(otks.data(), otks.size());
+
+    const size_t ok = count_ok(items, count);
+    native_metrics_record(NATIVE_METRICS_CIPHER, started_ns, bytes, ok == count);
+    return ok;
+}
+
+extern "C" size_t chacha20_poly1305_open_batch(AeadBatchItem *items, size_t count) {
+    if (!items || count == 0) return 0;
+    const uint64_t started_ns = native_metrics_now_ns();
+    uint64_t bytes = 0;
+    if (prepare(items, count, bytes) == 0) return 0;
+
+    const Kernel kernel = select_kernel();
+    std::vector<uint8_t> otks(count * POLY1305_KEY_BYTES);
+    std::vector<const uint8_t *> ciphertexts(count);
+    for (size_t i = 0; i < count; i++) {
+        ciphertexts[i] = items[i].in;
+    }
+
+    // OTK saja, verifikasi tag, baru decrypt item yang lolos
+    chacha_lanes(kernel, items, count, otks.data(), true, false);
+    poly_lanes(kernel, items, count, otks.data(), ciphertexts.data(), true);
+    secure_wipe(otks.data(), otks.size());
+    chacha_lanes(kernel, items, count, nullptr, false, true);
+
+    const size_t ok = count_ok(items, count);
+    native_metrics_record(NATIVE_METRICS_CIPHER, started_ns, bytes, ok == count);
+    return ok;
+}
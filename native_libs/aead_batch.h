@@ -0,0 +1,49 @@
+#ifndef AEAD_BATCH_H
+#define AEAD_BATCH_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "chacha20_poly1305.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ChaCha20-Poly1305 (RFC 8439) multi-buffer untuk banyak pesan pendek sekaligus, mis.
+// satu halaman history chat. Setiap lane SIMD memproses pesan berbeda dengan key, nonce
+// dan counter sendiri (lane diisi ulang begitu pesannya selesai), dan setiap pesan punya
+// lane Poly1305 sendiri. Pesan puluhan byte tidak lagi menyia-nyiakan batch SIMD
+// 4 blok untuk padding. Output identik dengan chacha20_poly1305_encrypt/decrypt.
+
+#define AEAD_BATCH_MAX_LANES 8
+
+// Status per item memakai AEAD_* dari chacha20_poly1305.h
+typedef struct {
+    uint8_t *out;               // seal: ciphertext, open: plaintext (len byte)
+    const uint8_t *in;          // seal: plaintext, open: ciphertext
+    uint32_t len;
+    const uint8_t *aad;
+    uint32_t aad_len;
+    const uint8_t *key;         // CHACHA20_KEY_BYTES
+    const uint8_t *nonce;       // CHACHA20_NONCE_BYTES
+    uint8_t *tag;               // seal: ditulis, open: dibaca (POLY1305_TAG_BYTES)
+    int32_t status;
+} AeadBatchItem;
+
+// Jumlah lane yang dipakai di device ini: 8 (AVX2), 4 (SSE2/NEON/SIMD128) atau 1
+uint32_t aead_batch_lanes(void);
+
+// Return jumlah item dengan status AEAD_OK. Item tidak valid diberi status
+// AEAD_ERROR_INVALID_INPUT tanpa menghentikan item lain.
+size_t chacha20_poly1305_seal_batch(AeadBatchItem *items, size_t count);
+
+// Tag diverifikasi sebelum decrypt; item dengan tag salah diberi AEAD_ERROR_AUTH_FAILED
+// dan out-nya tidak ditulis.
+size_t chacha20_poly1305_open_batch(AeadBatchItem *items, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef AES_H
+#define AES_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// AES-256 blok tunggal (FIPS-197), portable tanpa instruksi AES. Dipakai Adiantum
+// yang hanya mengenkripsi satu blok 16 byte per halaman.
+
+#define AES_BLOCK_BYTES 16
+#define AES256_KEY_BYTES 32
+#define AES256_ROUNDS 14
+
+typedef struct {
+    uint8_t round_keys[(AES256_ROUNDS + 1) * AES_BLOCK_BYTES];
+} AES256_CTX;
+
+void aes256_init(AES256_CTX *ctx, const uint8_t key[AES256_KEY_BYTES]);
+void aes256_encrypt_block(const AES256_CTX *ctx, uint8_t out[AES_BLOCK_BYTES], const uint8_t in[AES_BLOCK_BYTES]);
+void aes256_decrypt_block(const AES256_CTX *ctx, uint8_t out[AES_BLOCK_BYTES], const uint8_t in[AES_BLOCK_BYTES]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,815 @@
+#include "aes_gcm.h"
+#include "cpu_features.h"
+#include "native_metrics.h"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define AES_GCM_HAVE_VEC 1
+#define AES_GCM_VEC_SSE2 1
+#endif
+#include <tmmintrin.h>
+#include <wmmintrin.h>
+#define AES_GCM_HAVE_AESNI 1
+#if defined(__GNUC__) || defined(__clang__)
+#define AESNI_TARGET __attribute__((target("aes,pclmul,ssse3")))
+#else
+#define AESNI_TARGET
+#endif
+#elif defined(__ARM_NEON) || defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define AES_GCM_HAVE_VEC 1
+#define AES_GCM_VEC_NEON 1
+#elif defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#define AES_GCM_HAVE_VEC 1
+#define AES_GCM_VEC_WASM 1
+#endif
+
+namespace {
+
+inline uint32_t load32_le(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+inline void store32_le(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+inline uint64_t load64_be(const uint8_t *p) {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++) v = (v << 8) | p[i];
+    return v;
+}
+
+inline void store64_be(uint8_t *p, uint64_t v) {
+    for (int i = 7; i >= 0; i--) {
+        p[i] = (uint8_t)v;
+        v >>= 8;
+    }
+}
+
+void secure_wipe(void *p, size_t len) {
+    volatile uint8_t *v = static_cast<volatile uint8_t *>(p);
+    for (size_t i = 0; i < len; i++) {
+        v[i] = 0;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// AES bitsliced. Layout "ct64": 8 word 64-bit menampung 4 blok, word q[i] berisi bit ke-i
+// setiap byte state. Semua operasi round hanya AND/XOR/NOT/shift konstan, jadi waktu
+// eksekusi dan pola akses memori tidak bergantung pada key maupun data. Kode round ditulis
+// sebagai template supaya word yang sama bisa berupa uint64_t (4 blok) atau vektor
+// 2 x 64-bit (8 blok: lane 0 = blok 0..3, lane 1 = blok 4..7).
+// ---------------------------------------------------------------------------
+
+template <typename W> inline W splat(uint64_t x);
+template <> inline uint64_t splat<uint64_t>(uint64_t x) { return x; }
+template <int N> inline uint64_t shl(uint64_t x) { return x << N; }
+template <int N> inline uint64_t shr(uint64_t x) { return x >> N; }
+
+#ifdef AES_GCM_HAVE_VEC
+struct U64x2 {
+#if defined(AES_GCM_VEC_SSE2)
+    __m128i v;
+#elif defined(AES_GCM_VEC_NEON)
+    uint64x2_t v;
+#else
+    v128_t v;
+#endif
+};
+
+#if defined(AES_GCM_VEC_SSE2)
+inline U64x2 operator^(U64x2 a, U64x2 b) { return {_mm_xor_si128(a.v, b.v)}; }
+inline U64x2 operator&(U64x2 a, U64x2 b) { return {_mm_and_si128(a.v, b.v)}; }
+inline U64x2 operator|(U64x2 a, U64x2 b) { return {_mm_or_si128(a.v, b.v)}; }
+inline U64x2 operator~(U64x2 a) { return {_mm_xor_si128(a.v, _mm_set1_epi32(-1))}; }
+template <int N> inline U64x2 shl(U64x2 a) { return {_mm_slli_epi64(a.v, N)}; }
+template <int N> inline U64x2 shr(U64x2 a) { return {_mm_srli_epi64(a.v, N)}; }
+template <> inline U64x2 splat<U64x2>(uint64_t x) { return {_mm_set1_epi64x((long long)x)}; }
+inline U64x2 make_u64x2(uint64_t lo, uint64_t hi) { return {_mm_set_epi64x((long long)hi, (long long)lo)}; }
+inline void store_u64x2(uint64_t out[2], U64x2 a) { _mm_storeu_si128((__m128i *)out, a.v); }
+#elif defined(AES_GCM_VEC_NEON)
+inline U64x2 operator^(U64x2 a, U64x2 b) { return {veorq_u64(a.v, b.v)}; }
+inline U64x2 operator&(U64x2 a, U64x2 b) { return {vandq_u64(a.v, b.v)}; }
+inline U64x2 operator|(U64x2 a, U64x2 b) { return {vorrq_u64(a.v, b.v)}; }
+inline U64x2 operator~(U64x2 a) { return {veorq_u64(a.v, vdupq_n_u64(~(uint64_t)0))}; }
+template <int N> inline U64x2 shl(U64x2 a) { return {vshlq_n_u64(a.v, N)}; }
+template <int N> inline U64x2 shr(U64x2 a) { return {vshrq_n_u64(a.v, N)}; }
+template <> inline U64x2 splat<U64x2>(uint64_t x) { return {vdupq_n_u64(x)}; }
+inline U64x2 make_u64x2(uint64_t lo, uint64_t hi) { return {vcombine_u64(vcreate_u64(lo), vcreate_u64(hi))}; }
+inline void store_u64x2(uint64_t out[2], U64x2 a) { vst1q_u64(out, a.v); }
+#else
+inline U64x2 operator^(U64x2 a, U64x2 b) { return {wasm_v128_xor(a.v, b.v)}; }
+inline U64x2 operator&(U64x2 a, U64x2 b) { return {wasm_v128_and(a.v, b.v)}; }
+inline U64x2 operator|(U64x2 a, U64x2 b) { return {wasm_v128_or(a.v, b.v)}; }
+inline U64x2 operator~(U64x2 a) { return {wasm_v128_not(a.v)}; }
+template <int N> inline U64x2 shl(U64x2 a) { return {wasm_i64x2_shl(a.v, N)}; }
+template <int N> inline U64x2 shr(U64x2 a) { return {wasm_u64x2_shr(a.v, N)}; }
+template <> inline U64x2 splat<U64x2>(uint64_t x) { return {wasm_i64x2_splat((int64_t)x)}; }
+inline U64x2 make_u64x2(uint64_t lo, uint64_t hi) { return {wasm_i64x2_make((int64_t)lo, (int64_t)hi)}; }
+inline void store_u64x2(uint64_t out[2], U64x2 a) { wasm_v128_store(out, a.v); }
+#endif
+#endif
+
+// S-box AES sebagai sirkuit 113 gerbang (Boyar-Peralta)
+template <typename W>
+void bitslice_sbox(W q[8]) {
+    const W x0 = q[7], x1 = q[6], x2 = q[5], x3 = q[4];
+    const W x4 = q[3], x5 = q[2], x6 = q[1], x7 = q[0];
+
+    // Transformasi linear atas
+    const W y14 = x3 ^ x5;
+    const W y13 = x0 ^ x6;
+    const W y9 = x0 ^ x3;
+    const W y8 = x0 ^ x5;
+    const W t0 = x1 ^ x2;
+    const W y1 = t0 ^ x7;
+    const W y4 = y1 ^ x3;
+    const W y12 = y13 ^ y14;
+    const W y2 = y1 ^ x0;
+    const W y5 = y1 ^ x6;
+    const W y3 = y5 ^ y8;
+    const W t1 = x4 ^ y12;
+    const W y15 = t1 ^ x5;
+    const W y20 = t1 ^ x1;
+    const W y6 = y15 ^ x7;
+    const W y10 = y15 ^ t0;
+    const W y11 = y20 ^ y9;
+    const W y7 = x7 ^ y11;
+    const W y17 = y10 ^ y11;
+    const W y19 = y10 ^ y8;
+    const W y16 = t0 ^ y11;
+    const W y21 = y13 ^ y16;
+    const W y18 = x0 ^ y16;
+
+    // Bagian non-linear (inversi GF(2^8) lewat GF(2^4))
+    const W t2 = y12 & y15;
+    const W t3 = y3 & y6;
+    const W t4 = t3 ^ t2;
+    const W t5 = y4 & x7;
+    const W t6 = t5 ^ t2;
+    const W t7 = y13 & y16;
+    const W t8 = y5 & y1;
+    const W t9 = t8 ^ t7;
+    const W t10 = y2 & y7;
+    const W t11 = t10 ^ t7;
+    const W t12 = y9 & y11;
+    const W t13 = y14 & y17;
+    const W t14 = t13 ^ t12;
+    const W t15 = y8 & y10;
+    const W t16 = t15 ^ t12;
+    const W t17 = t4 ^ t14;
+    const W t18 = t6 ^ t16;
+    const W t19 = t9 ^ t14;
+    const W t20 = t11 ^ t16;
+    const W t21 = t17 ^ y20;
+    const W t22 = t18 ^ y19;
+    const W t23 = t19 ^ y21;
+    const W t24 = t20 ^ y18;
+
+    const W t25 = t21 ^ t22;
+    const W t26 = t21 & t23;
+    const W t27 = t24 ^ t26;
+    const W t28 = t25 & t27;
+    const W t29 = t28 ^ t22;
+    const W t30 = t23 ^ t24;
+    const W t31 = t22 ^ t26;
+    const W t32 = t31 & t30;
+    const W t33 = t32 ^ t24;
+    const W t34 = t23 ^ t33;
+    const W t35 = t27 ^ t33;
+    const W t36 = t24 & t35;
+    const W t37 = t36 ^ t34;
+    const W t38 = t27 ^ t36;
+    const W t39 = t29 & t38;
+    const W t40 = t25 ^ t39;
+
+    const W t41 = t40 ^ t37;
+    const W t42 = t29 ^ t33;
+    const W t43 = t29 ^ t40;
+    const W t44 = t33 ^ t37;
+    const W t45 = t42 ^ t41;
+    const W z0 = t44 & y15;
+    const W z1 = t37 & y6;
+    const W z2 = t33 & x7;
+    const W z3 = t43 & y16;
+    const W z4 = t40 & y1;
+    const W z5 = t29 & y7;
+    const W z6 = t42 & y11;
+    const W z7 = t45 & y17;
+    const W z8 = t41 & y10;
+    const W z9 = t44 & y12;
+    const W z10 = t37 & y3;
+    const W z11 = t33 & y4;
+    const W z12 = t43 & y13;
+    const W z13 = t40 & y5;
+    const W z14 = t29 & y2;
+    const W z15 = t42 & y9;
+    const W z16 = t45 & y14;
+    const W z17 = t41 & y8;
+
+    // Transformasi linear bawah
+    const W t46 = z15 ^ z16;
+    const W t47 = z10 ^ z11;
+    const W t48 = z5 ^ z13;
+    const W t49 = z9 ^ z10;
+    const W t50 = z2 ^ z12;
+    const W t51 = z2 ^ z5;
+    const W t52 = z7 ^ z8;
+    const W t53 = z0 ^ z3;
+    const W t54 = z6 ^ z7;
+    const W t55 = z16 ^ z17;
+    const W t56 = z12 ^ t48;
+    const W t57 = t50 ^ t53;
+    const W t58 = z4 ^ t46;
+    const W t59 = z3 ^ t54;
+    const W t60 = t46 ^ t57;
+    const W t61 = z14 ^ t57;
+    const W t62 = t52 ^ t58;
+    const W t63 = t49 ^ t58;
+    const W t64 = z4 ^ t59;
+    const W t65 = t61 ^ t62;
+    const W t66 = z1 ^ t63;
+    const W s0 = t59 ^ t63;
+    const W s6 = t56 ^ ~t62;
+    const W s7 = t48 ^ ~t60;
+    const W t67 = t64 ^ t65;
+    const W s3 = t53 ^ t66;
+    const W s4 = t51 ^ t66;
+    const W s5 = t47 ^ t65;
+    const W s1 = t64 ^ ~s3;
+    const W s2 = t55 ^ ~t67;
+
+    q[7] = s0;
+    q[6] = s1;
+    q[5] = s2;
+    q[4] = s3;
+    q[3] = s4;
+    q[2] = s5;
+    q[1] = s6;
+    q[0] = s7;
+}
+
+template <typename W>
+inline void shift_rows(W q[8]) {
+    for (int i = 0; i < 8; i++) {
+        const W x = q[i];
+        q[i] = (x & splat<W>(0x000000000000FFFF))
+             | shr<4>(x & splat<W>(0x00000000FFF00000))
+             | shl<12>(x & splat<W>(0x00000000000F0000))
+             | shr<8>(x & splat<W>(0x0000FF0000000000))
+             | shl<8>(x & splat<W>(0x000000FF00000000))
+             | shr<12>(x & splat<W>(0xF000000000000000))
+             | shl<4>(x & splat<W>(0x0FFF000000000000));
+    }
+}
+
+template <typename W>
+inline W rotr32(W x) {
+    return shl<32>(x) | shr<32>(x);
+}
+
+template <typename W>
+inline void mix_columns(W q[8]) {
+    W r[8];
+    for (int i = 0; i < 8; i++) r[i] = shr<16>(q[i]) | shl<48>(q[i]);
+    const W q0 = q[0], q1 = q[1], q2 = q[2], q3 = q[3], q4 = q[4], q5 = q[5], q6 = q[6], q7 = q[7];
+    q[0] = q7 ^ r[7] ^ r[0] ^ rotr32(q0 ^ r[0]);
+    q[1] = q0 ^ r[0] ^ q7 ^ r[7] ^ r[1] ^ rotr32(q1 ^ r[1]);
+    q[2] = q1 ^ r[1] ^ r[2] ^ rotr32(q2 ^ r[2]);
+    q[3] = q2 ^ r[2] ^ q7 ^ r[7] ^ r[3] ^ rotr32(q3 ^ r[3]);
+    q[4] = q3 ^ r[3] ^ q7 ^ r[7] ^ r[4] ^ rotr32(q4 ^ r[4]);
+    q[5] = q4 ^ r[4] ^ r[5] ^ rotr32(q5 ^ r[5]);
+    q[6] = q5 ^ r[5] ^ r[6] ^ rotr32(q6 ^ r[6]);
+    q[7] = q6 ^ r[6] ^ r[7] ^ rotr32(q7 ^ r[7]);
+}
+
+template <typename W>
+void bitslice_encrypt(W q[8], const W *skey) {
+    for (int i = 0; i < 8; i++) q[i] = q[i] ^ skey[i];
+    for (int round = 1; round < AES256_ROUNDS; round++) {
+        bitslice_sbox(q);
+        shift_rows(q);
+        mix_columns(q);
+        for (int i = 0; i < 8; i++) q[i] = q[i] ^ skey[8 * round + i];
+    }
+    bitslice_sbox(q);
+    shift_rows(q);
+    for (int i = 0; i < 8; i++) q[i] = q[i] ^ skey[8 * AES256_ROUNDS + i];
+}
+
+// Transpose bit antara representasi blok dan bitsliced (involusi)
+void ortho(uint64_t q[8]) {
+#define AES_GCM_SWAPN(cl, ch, s, x, y) do { \
+        const uint64_t a = (x), b = (y); \
+        (x) = (a & (uint64_t)(cl)) | ((b & (uint64_t)(cl)) << (s)); \
+        (y) = ((a & (uint64_t)(ch)) >> (s)) | (b & (uint64_t)(ch)); \
+    } while (0)
+#define AES_GCM_SWAP2(x, y) AES_GCM_SWAPN(0x5555555555555555, 0xAAAAAAAAAAAAAAAA, 1, x, y)
+#define AES_GCM_SWAP4(x, y) AES_GCM_SWAPN(0x3333333333333333, 0xCCCCCCCCCCCCCCCC, 2, x, y)
+#define AES_GCM_SWAP8(x, y) AES_GCM_SWAPN(0x0F0F0F0F0F0F0F0F, 0xF0F0F0F0F0F0F0F0, 4, x, y)
+    AES_GCM_SWAP2(q[0], q[1]);
+    AES_GCM_SWAP2(q[2], q[3]);
+    AES_GCM_SWAP2(q[4], q[5]);
+    AES_GCM_SWAP2(q[6], q[7]);
+    AES_GCM_SWAP4(q[0], q[2]);
+    AES_GCM_SWAP4(q[1], q[3]);
+    AES_GCM_SWAP4(q[4], q[6]);
+    AES_GCM_SWAP4(q[5], q[7]);
+    AES_GCM_SWAP8(q[0], q[4]);
+    AES_GCM_SWAP8(q[1], q[5]);
+    AES_GCM_SWAP8(q[2], q[6]);
+    AES_GCM_SWAP8(q[3], q[7]);
+#undef AES_GCM_SWAP8
+#undef AES_GCM_SWAP4
+#undef AES_GCM_SWAP2
+#undef AES_GCM_SWAPN
+}
+
+void interleave_in(uint64_t *q0, uint64_t *q1, const uint32_t w[4]) {
+    uint64_t x0 = w[0], x1 = w[1], x2 = w[2], x3 = w[3];
+    x0 |= x0 << 16;
+    x1 |= x1 << 16;
+    x2 |= x2 << 16;
+    x3 |= x3 << 16;
+    x0 &= 0x0000FFFF0000FFFF;
+    x1 &= 0x0000FFFF0000FFFF;
+    x2 &= 0x0000FFFF0000FFFF;
+    x3 &= 0x0000FFFF0000FFFF;
+    x0 |= x0 << 8;
+    x1 |= x1 << 8;
+    x2 |= x2 << 8;
+    x3 |= x3 << 8;
+    x0 &= 0x00FF00FF00FF00FF;
+    x1 &= 0x00FF00FF00FF00FF;
+    x2 &= 0x00FF00FF00FF00FF;
+    x3 &= 0x00FF00FF00FF00FF;
+    *q0 = x0 | (x2 << 8);
+    *q1 = x1 | (x3 << 8);
+}
+
+void interleave_out(uint32_t w[4], uint64_t q0, uint64_t q1) {
+    uint64_t x0 = q0 & 0x00FF00FF00FF00FF;
+    uint64_t x1 = q1 & 0x00FF00FF00FF00FF;
+    uint64_t x2 = (q0 >> 8) & 0x00FF00FF00FF00FF;
+    uint64_t x3 = (q1 >> 8) & 0x00FF00FF00FF00FF;
+    x0 |= x0 >> 8;
+    x1 |= x1 >> 8;
+    x2 |= x2 >> 8;
+    x3 |= x3 >> 8;
+    x0 &= 0x0000FFFF0000FFFF;
+    x1 &= 0x0000FFFF0000FFFF;
+    x2 &= 0x0000FFFF0000FFFF;
+    x3 &= 0x0000FFFF0000FFFF;
+    w[0] = (uint32_t)x0 | (uint32_t)(x0 >> 16);
+    w[1] = (uint32_t)x1 | (uint32_t)(x1 >> 16);
+    w[2] = (uint32_t)x2 | (uint32_t)(x2 >> 16);
+    w[3] = (uint32_t)x3 | (uint32_t)(x3 >> 16);
+}
+
+// 64 byte (4 blok) -> state bitsliced
+void load_blocks4(uint64_t q[8], const uint8_t *in) {
+    uint32_t w[16];
+    for (int i = 0; i < 16; i++) w[i] = load32_le(in + 4 * i);
+    for (int i = 0; i < 4; i++) interleave_in(&q[i], &q[i + 4], w + 4 * i);
+    ortho(q);
+}
+
+void store_blocks4(uint8_t *out, uint64_t q[8]) {
+    uint32_t w[16];
+    ortho(q);
+    for (int i = 0; i < 4; i++) interleave_out(w + 4 * i, q[i], q[i + 4]);
+    for (int i = 0; i < 16; i++) store32_le(out + 4 * i, w[i]);
+}
+
+// S-box untuk key schedule juga lewat sirkuit bitsliced, bukan tabel
+uint32_t sub_word(uint32_t x) {
+    uint64_t q[8] = {0};
+    q[0] = x;
+    ortho(q);
+    bitslice_sbox(q);
+    ortho(q);
+    const uint32_t result = (uint32_t)q[0];
+    secure_wipe(q, sizeof(q));
+    return result;
+}
+
+constexpr int kRoundKeyWords = 4 * (AES256_ROUNDS + 1);
+constexpr int kBitslicedKeyWords = 8 * (AES256_ROUNDS + 1);
+constexpr int kMaxBatchBlocks = 8;
+
+struct GcmKey {
+    int impl;
+    int batch_blocks;
+    uint8_t round_keys[(AES256_ROUNDS + 1) * AES_BLOCK_BYTES];   // urutan FIPS-197, untuk AES-NI
+    uint64_t skey[kBitslicedKeyWords];
+#ifdef AES_GCM_HAVE_VEC
+    U64x2 vskey[kBitslicedKeyWords];
+#endif
+    uint8_t h[16];
+};
+
+void key_schedule(GcmKey &k, const uint8_t key[AES256_KEY_BYTES]) {
+    static const uint8_t kRcon[7] = {0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40};
+    uint32_t words[kRoundKeyWords];
+    for (int i = 0; i < 8; i++) words[i] = load32_le(key + 4 * i);
+    uint32_t tmp = words[7];
+    for (int i = 8; i < kRoundKeyWords; i++) {
+        if (i % 8 == 0) {
+            tmp = (tmp << 24) | (tmp >> 8);
+            tmp = sub_word(tmp) ^ kRcon[i / 8 - 1];
+        } else if (i % 8 == 4) {
+            tmp = sub_word(tmp);
+        }
+        tmp ^= words[i - 8];
+        words[i] = tmp;
+    }
+    for (int i = 0; i < kRoundKeyWords; i++) store32_le(k.round_keys + 4 * i, words[i]);
+
+    // Round key bitsliced: setiap bit key diulang untuk keempat blok
+    for (int round = 0; round <= AES256_ROUNDS; round++) {
+        uint64_t q[8];
+        interleave_in(&q[0], &q[4], words + 4 * round);
+        q[1] = q[2] = q[3] = q[0];
+        q[5] = q[6] = q[7] = q[4];
+        ortho(q);
+        const uint64_t lo = (q[0] & 0x1111111111111111) | (q[1] & 0x2222222222222222)
+                          | (q[2] & 0x4444444444444444) | (q[3] & 0x8888888888888888);
+        const uint64_t hi = (q[4] & 0x1111111111111111) | (q[5] & 0x2222222222222222)
+                          | (q[6] & 0x4444444444444444) | (q[7] & 0x8888888888888888);
+        const uint64_t comp[2] = {lo, hi};
+        for (int half = 0; half < 2; half++) {
+            for (int bit = 0; bit < 4; bit++) {
+                const uint64_t x = (comp[half] >> bit) & 0x1111111111111111;
+                k.skey[8 * round + 4 * half + bit] = (x << 4) - x;
+            }
+        }
+        secure_wipe(q, sizeof(q));
+    }
+#ifdef AES_GCM_HAVE_VEC
+    for (int i = 0; i < kBitslicedKeyWords; i++) k.vskey[i] = splat<U64x2>(k.skey[i]);
+#endif
+    secure_wipe(words, sizeof(words));
+    secure_wipe(&tmp, sizeof(tmp));
+}
+
+void encrypt_batch_x4(const GcmKey &k, uint8_t *out, const uint8_t *in) {
+    uint64_t q[8];
+    load_blocks4(q, in);
+    bitslice_encrypt(q, k.skey);
+    store_blocks4(out, q);
+    secure_wipe(q, sizeof(q));
+}
+
+#ifdef AES_GCM_HAVE_VEC
+void encrypt_batch_x8(const GcmKey &k, uint8_t *out, const uint8_t *in) {
+    uint64_t a[8], b[8];
+    load_blocks4(a, in);
+    load_blocks4(b, in + 64);
+    U64x2 q[8];
+    for (int i = 0; i < 8; i++) q[i] = make_u64x2(a[i], b[i]);
+    bitslice_encrypt(q, k.vskey);
+    for (int i = 0; i < 8; i++) {
+        uint64_t lanes[2];
+        store_u64x2(lanes, q[i]);
+        a[i] = lanes[0];
+        b[i] = lanes[1];
+    }
+    store_blocks4(out, a);
+    store_blocks4(out + 64, b);
+    secure_wipe(a, sizeof(a));
+    secure_wipe(b, sizeof(b));
+    secure_wipe(q, sizeof(q));
+}
+#endif
+
+// ---------------------------------------------------------------------------
+// GHASH constant-time: perkalian carry-less 64x64 diemulasikan dengan perkalian integer
+// yang bit-bitnya dijarangkan (setiap 4 bit), sehingga carry tidak pernah mengenai bit
+// hasil. Tanpa tabel yang diindeks H maupun data.
+// ---------------------------------------------------------------------------
+
+uint64_t bmul64(uint64_t x, uint64_t y) {
+    const uint64_t x0 = x & 0x1111111111111111, x1 = x & 0x2222222222222222;
+    const uint64_t x2 = x & 0x4444444444444444, x3 = x & 0x8888888888888888;
+    const uint64_t y0 = y & 0x1111111111111111, y1 = y & 0x2222222222222222;
+    const uint64_t y2 = y & 0x4444444444444444, y3 = y & 0x8888888888888888;
+    uint64_t z0 = (x0 * y0) ^ (x1 * y3) ^ (x2 * y2) ^ (x3 * y1);
+    uint64_t z1 = (x0 * y1) ^ (x1 * y0) ^ (x2 * y3) ^ (x3 * y2);
+    uint64_t z2 = (x0 * y2) ^ (x1 * y1) ^ (x2 * y0) ^ (x3 * y3);
+    uint64_t z3 = (x0 * y3) ^ (x1 * y2) ^ (x2 * y1) ^ (x3 * y0);
+    z0 &= 0x1111111111111111;
+    z1 &= 0x2222222222222222;
+    z2 &= 0x4444444444444444;
+    z3 &= 0x8888888888888888;
+    return z0 | z1 | z2 | z3;
+}
+
+uint64_t rev64(uint64_t x) {
+    x = ((x & 0x5555555555555555) << 1) | ((x >> 1) & 0x5555555555555555);
+    x = ((x & 0x3333333333333333) << 2) | ((x >> 2) & 0x3333333333333333);
+    x = ((x & 0x0F0F0F0F0F0F0F0F) << 4) | ((x >> 4) & 0x0F0F0F0F0F0F0F0F);
+    x = ((x & 0x00FF00FF00FF00FF) << 8) | ((x >> 8) & 0x00FF00FF00FF00FF);
+    x = ((x & 0x0000FFFF0000FFFF) << 16) | ((x >> 16) & 0x0000FFFF0000FFFF);
+    return (x << 32) | (x >> 32);
+}
+
+// y = (y ^ blok) * H untuk setiap blok; blok terakhir yang parsial di-pad nol
+void ghash_ctmul64(uint8_t y[16], const uint8_t h[16], const uint8_t *data, size_t len) {
+    uint64_t y1 = load64_be(y), y0 = load64_be(y + 8);
+    const uint64_t h1 = load64_be(h), h0 = load64_be(h + 8);
+    const uint64_t h0r = rev64(h0), h1r = rev64(h1);
+    const uint64_t h2 = h0 ^ h1, h2r = h0r ^ h1r;
+    uint8_t tmp[16];
+
+    while (len > 0) {
+        const uint8_t *src;
+        if (len >= 16) {
+            src = data;
+            data += 16;
+            len -= 16;
+        } else {
+            memcpy(tmp, data, len);
+            memset(tmp + len, 0, sizeof(tmp) - len);
+            src = tmp;
+            len = 0;
+        }
+        y1 ^= load64_be(src);
+        y0 ^= load64_be(src + 8);
+        const uint64_t y0r = rev64(y0), y1r = rev64(y1);
+        const uint64_t y2 = y0 ^ y1, y2r = y0r ^ y1r;
+
+        // Karatsuba; bagian atas hasil dihitung dari operand yang dibalik bitnya
+        const uint64_t z0 = bmul64(y0, h0);
+        const uint64_t z1 = bmul64(y1, h1);
+        uint64_t z2 = bmul64(y2, h2);
+        uint64_t z0h = bmul64(y0r, h0r);
+        uint64_t z1h = bmul64(y1r, h1r);
+        uint64_t z2h = bmul64(y2r, h2r);
+        z2 ^= z0 ^ z1;
+        z2h ^= z0h ^ z1h;
+        z0h = rev64(z0h) >> 1;
+        z1h = rev64(z1h) >> 1;
+        z2h = rev64(z2h) >> 1;
+
+        uint64_t v0 = z0;
+        uint64_t v1 = z0h ^ z2;
+        uint64_t v2 = z1 ^ z2h;
+        uint64_t v3 = z1h;
+
+        v3 = (v3 << 1) | (v2 >> 63);
+        v2 = (v2 << 1) | (v1 >> 63);
+        v1 = (v1 << 1) | (v0 >> 63);
+        v0 = v0 << 1;
+
+        // Reduksi modulo x^128 + x^7 + x^2 + x + 1
+        v2 ^= v0 ^ (v0 >> 1) ^ (v0 >> 2) ^ (v0 >> 7);
+        v1 ^= (v0 << 63) ^ (v0 << 62) ^ (v0 << 57);
+        v3 ^= v1 ^ (v1 >> 1) ^ (v1 >> 2) ^ (v1 >> 7);
+        v2 ^= (v1 << 63) ^ (v1 << 62) ^ (v1 << 57);
+
+        y0 = v2;
+        y1 = v3;
+    }
+    store64_be(y, y1);
+    store64_be(y + 8, y0);
+    secure_wipe(tmp, sizeof(tmp));
+}
+
+#ifdef AES_GCM_HAVE_AESNI
+AESNI_TARGET void encrypt_batch_aesni(const GcmKey &k, uint8_t *out, const uint8_t *in) {
+    __m128i rk[AES256_ROUNDS + 1];
+    for (int r = 0; r <= AES256_ROUNDS; r++) {
+        rk[r] = _mm_loadu_si128((const __m128i *)(k.round_keys + 16 * r));
+    }
+    __m128i b[kMaxBatchBlocks];
+    for (int j = 0; j < kMaxBatchBlocks; j++) {
+        b[j] = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(in + 16 * j)), rk[0]);
+    }
+    for (int r = 1; r < AES256_ROUNDS; r++) {
+        for (int j = 0; j < kMaxBatchBlocks; j++) b[j] = _mm_aesenc_si128(b[j], rk[r]);
+    }
+    for (int j = 0; j < kMaxBatchBlocks; j++) {
+        _mm_storeu_si128((__m128i *)(out + 16 * j), _mm_aesenclast_si128(b[j], rk[AES256_ROUNDS]));
+    }
+}
+
+// Perkalian GF(2^128) dengan operand yang sudah dibalik urutan bytenya
+AESNI_TARGET inline __m128i gfmul_clmul(__m128i a, __m128i b) {
+    __m128i lo = _mm_clmulepi64_si128(a, b, 0x00);
+    __m128i mid = _mm_xor_si128(_mm_clmulepi64_si128(a, b, 0x10), _mm_clmulepi64_si128(a, b, 0x01));
+    __m128i hi = _mm_clmulepi64_si128(a, b, 0x11);
+    lo = _mm_xor_si128(lo, _mm_slli_si128(mid, 8));
+    hi = _mm_xor_si128(hi, _mm_srli_si128(mid, 8));
+
+    // Geser hasil 256 bit ke kiri 1 bit (konvensi bit GCM yang terbalik)
+    __m128i carry_lo = _mm_srli_epi32(lo, 31);
+    __m128i carry_hi = _mm_srli_epi32(hi, 31);
+    lo = _mm_slli_epi32(lo, 1);
+    hi = _mm_slli_epi32(hi, 1);
+    const __m128i cross = _mm_srli_si128(carry_lo, 12);
+    carry_hi = _mm_slli_si128(carry_hi, 4);
+    carry_lo = _mm_slli_si128(carry_lo, 4);
+    lo = _mm_or_si128(lo, carry_lo);
+    hi = _mm_or_si128(_mm_or_si128(hi, carry_hi), cross);
+
+    // Reduksi modulo x^128 + x^7 + x^2 + x + 1
+    __m128i t = _mm_xor_si128(_mm_xor_si128(_mm_slli_epi32(lo, 31), _mm_slli_epi32(lo, 30)), _mm_slli_epi32(lo, 25));
+    const __m128i t_hi = _mm_srli_si128(t, 4);
+    t = _mm_slli_si128(t, 12);
+    lo = _mm_xor_si128(lo, t);
+    __m128i r = _mm_xor_si128(_mm_xor_si128(_mm_srli_epi32(lo, 1), _mm_srli_epi32(lo, 2)), _mm_srli_epi32(lo, 7));
+    r = _mm_xor_si128(_mm_xor_si128(r, t_hi), lo);
+    return _mm_xor_si128(hi, r);
+}
+
+AESNI_TARGET void ghash_clmul(uint8_t y[16], const uint8_t h[16], const uint8_t *data, size_t len) {
+    const __m128i bswap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    const __m128i hv = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)h), bswap);
+    __m128i acc = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)y), bswap);
+    uint8_t tmp[16];
+    while (len > 0) {
+        __m128i block;
+        if (len >= 16) {
+            block = _mm_loadu_si128((const __m128i *)data);
+            data += 16;
+            len -= 16;
+        } else {
+            memcpy(tmp, data, len);
+            memset(tmp + len, 0, sizeof(tmp) - len);
+            block = _mm_loadu_si128((const __m128i *)tmp);
+            len = 0;
+        }
+        acc = gfmul_clmul(_mm_xor_si128(acc, _mm_shuffle_epi8(block, bswap)), hv);
+    }
+    _mm_storeu_si128((__m128i *)y, _mm_shuffle_epi8(acc, bswap));
+    secure_wipe(tmp, sizeof(tmp));
+}
+#endif
+
+typedef void (*EncryptBatchFn)(const GcmKey &k, uint8_t *out, const uint8_t *in);
+typedef void (*GhashFn)(uint8_t y[16], const uint8_t h[16], const uint8_t *data, size_t len);
+
+struct GcmImpl {
+    int id;
+    int batch_blocks;
+    EncryptBatchFn encrypt;
+    GhashFn ghash;
+};
+
+GcmImpl select_impl() {
+    const uint32_t features = cpu_features_get();
+#ifdef AES_GCM_HAVE_AESNI
+    const uint32_t aesni = CPU_FEATURE_AES | CPU_FEATURE_PMULL | CPU_FEATURE_SSSE3;
+    if ((features & aesni) == aesni) {
+        return {AES_GCM_IMPL_AESNI, kMaxBatchBlocks, encrypt_batch_aesni, ghash_clmul};
+    }
+#endif
+#ifdef AES_GCM_HAVE_VEC
+    if (features & (CPU_FEATURE_SSE2 | CPU_FEATURE_NEON | CPU_FEATURE_SIMD128)) {
+        return {AES_GCM_IMPL_BITSLICED_X8, 8, encrypt_batch_x8, ghash_ctmul64};
+    }
+#endif
+    (void)features;
+    return {AES_GCM_IMPL_BITSLICED_X4, 4, encrypt_batch_x4, ghash_ctmul64};
+}
+
+struct Gcm {
+    GcmImpl impl;
+    GcmKey key;
+    uint8_t iv[AES_GCM_IV_BYTES];
+    uint32_t next_counter;
+    // Batch keystream pertama: blok 0 = E(K, J0) untuk tag, sisanya untuk data
+    uint8_t first[kMaxBatchBlocks * AES_BLOCK_BYTES];
+
+    void keystream(uint8_t *out, uint32_t counter) {
+        uint8_t blocks[kMaxBatchBlocks * AES_BLOCK_BYTES];
+        for (int j = 0; j < impl.batch_blocks; j++) {
+            uint8_t *block = blocks + 16 * j;
+            memcpy(block, iv, AES_GCM_IV_BYTES);
+            const uint32_t c = counter + (uint32_t)j;
+            block[12] = (uint8_t)(c >> 24);
+            block[13] = (uint8_t)(c >> 16);
+            block[14] = (uint8_t)(c >> 8);
+            block[15] = (uint8_t)c;
+        }
+        impl.encrypt(key, out, blocks);
+    }
+
+    void init(const uint8_t k[AES256_KEY_BYTES], const uint8_t nonce[AES_GCM_IV_BYTES]) {
+        impl = select_impl();
+        key_schedule(key, k);
+        uint8_t zeros[kMaxBatchBlocks * AES_BLOCK_BYTES] = {0};
+        uint8_t hs[kMaxBatchBlocks * AES_BLOCK_BYTES];
+        impl.encrypt(key, hs, zeros);
+        memcpy(key.h, hs, 16);
+        secure_wipe(hs, sizeof(hs));
+
+        memcpy(iv, nonce, AES_GCM_IV_BYTES);
+        keystream(first, 1);
+        next_counter = 1 + (uint32_t)impl.batch_blocks;
+    }
+
+    void ctr_xor(uint8_t *out, const uint8_t *in, size_t len) {
+        const size_t first_bytes = (size_t)(impl.batch_blocks - 1) * AES_BLOCK_BYTES;
+        size_t n = len < first_bytes ? len : first_bytes;
+        for (size_t i = 0; i < n; i++) out[i] = in[i] ^ first[16 + i];
+
+        uint8_t stream[kMaxBatchBlocks * AES_BLOCK_BYTES];
+        const size_t batch_bytes = (size_t)impl.batch_blocks * AES_BLOCK_BYTES;
+        for (size_t offset = n; offset < len; offset += batch_bytes) {
+            keystream(stream, next_counter);
+            next_counter += (uint32_t)impl.batch_blocks;
+            n = len - offset < batch_bytes ? len - offset : batch_bytes;
+            for (size_t i = 0; i < n; i++) out[offset + i] = in[offset + i] ^ stream[i];
+        }
+        secure_wipe(stream, sizeof(stream));
+    }
+
+    void tag(uint8_t out[AES_GCM_TAG_BYTES], const uint8_t *aad, size_t aad_len,
+             const uint8_t *ciphertext, size_t ciphertext_len) {
+        uint8_t y[16] = {0};
+        impl.ghash(y, key.h, aad, aad_len);
+        impl.ghash(y, key.h, ciphertext, ciphertext_len);
+        uint8_t lengths[16];
+        store64_be(lengths, (uint64_t)aad_len * 8);
+        store64_be(lengths + 8, (uint64_t)ciphertext_len * 8);
+        impl.ghash(y, key.h, lengths, sizeof(lengths));
+        for (int i = 0; i < AES_GCM_TAG_BYTES; i++) out[i] = y[i] ^ first[i];
+        secure_wipe(y, sizeof(y));
+    }
+
+    void wipe() { secure_wipe(this, sizeof(*this)); }
+};
+
+bool valid_lengths(size_t len, size_t aad_len) {
+    // Counter 32 bit: maksimal 2^32 - 2 blok per IV (SP 800-38D)
+    return (uint64_t)len <= ((1ull << 32) - 2) * AES_BLOCK_BYTES && (uint64_t)aad_len < (1ull << 61);
+}
+
+}  // namespace
+
+extern "C" int aes256_gcm_impl(void) {
+    return select_impl().id;
+}
+
+extern "C" int aes256_gcm_encrypt(uint8_t *ciphertext, uint8_t tag[AES_GCM_TAG_BYTES],
+                                  const uint8_t *plaintext, size_t plaintext_len,
+                                  const uint8_t *aad, size_t aad_len,
+                                  const uint8_t key[AES256_KEY_BYTES],
+                                  const uint8_t iv[AES_GCM_IV_BYTES]) {
+    if (!tag || !key || !iv || (plaintext_len && (!ciphertext || !plaintext)) || (aad_len && !aad) ||
+        !valid_lengths(plaintext_len, aad_len)) {
+        return AES_GCM_ERROR_INVALID_INPUT;
+    }
+    const uint64_t started_ns = native_metrics_now_ns();
+
+    Gcm gcm;
+    gcm.init(key, iv);
+    gcm.ctr_xor(ciphertext, plaintext, plaintext_len);
+    gcm.tag(tag, aad, aad_len, ciphertext, plaintext_len);
+    gcm.wipe();
+
+    native_metrics_record(NATIVE_METRICS_CIPHER, started_ns, plaintext_len, 1);
+    return AES_GCM_OK;
+}
+
+extern "C" int aes256_gcm_decrypt(uint8_t *plaintext,
+                                  const uint8_t *ciphertext, size_t ciphertext_len,
+                                  const uint8_t tag[AES_GCM_TAG_BYTES],
+                                  const uint8_t *aad, size_t aad_len,
+                                  const uint8_t key[AES256_KEY_BYTES],
+                                  const uint8_t iv[AES_GCM_IV_BYTES]) {
+    if (!tag || !key || !iv || (ciphertext_len && (!ciphertext || !plaintext)) || (aad_len && !aad) ||
+        !valid_lengths(ciphertext_len, aad_len)) {
+        return AES_GCM_ERROR_INVALID_INPUT;
+    }
+    const uint64_t started_ns = native_metrics_now_ns();
+
+    Gcm gcm;
+    gcm.init(key, iv);
+    uint8_t expected[AES_GCM_TAG_BYTES];
+    gcm.tag(expected, aad, aad_len, ciphertext, ciphertext_len);
+    uint8_t diff = 0;
+    for (int i = 0; i < AES_GCM_TAG_BYTES; i++) {
+        diff |= expected[i] ^ tag[i];
+    }
+    secure_wipe(expected, sizeof(expected));
+    if (diff != 0) {
+        gcm.wipe();
+        native_metrics_record(NATIVE_METRICS_CIPHER, started_ns, ciphertext_len, 0);
+        return AES_GCM_ERROR_AUTH_FAILED;
+    }
+
+    gcm.ctr_xor(plaintext, ciphertext, ciphertext_len);
+    gcm.wipe();
+    native_metrics_record(NATIVE_METRICS_CIPHER, started_ns, ciphertext_len, 1);
+    return AES_GCM_OK;
+}
@@ -0,0 +1,53 @@
+#ifndef AES_GCM_H
+#define AES_GCM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "aes.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// AES-256-GCM (NIST SP 800-38D) constant-time dengan dispatch runtime lewat cpu_features:
+// AES-NI + PCLMULQDQ jika ada, selain itu AES bitsliced (tanpa tabel S-box yang diindeks
+// data rahasia) dan GHASH perkalian carry-less yang diemulasikan tanpa cabang/tabel.
+// Jalur bitsliced memproses 8 blok paralel di register 128-bit (SSE2/NEON/SIMD128) atau
+// 4 blok di register 64-bit biasa.
+
+#define AES_GCM_IV_BYTES 12
+#define AES_GCM_TAG_BYTES 16
+
+// Status sama dengan AEAD_* di chacha20_poly1305.h
+#define AES_GCM_OK 0
+#define AES_GCM_ERROR_INVALID_INPUT -1
+#define AES_GCM_ERROR_AUTH_FAILED -2
+
+// Implementasi yang dipilih untuk device ini
+#define AES_GCM_IMPL_BITSLICED_X4 1     // 64-bit scalar, 4 blok per batch
+#define AES_GCM_IMPL_BITSLICED_X8 2     // SIMD 128-bit, 8 blok per batch
+#define AES_GCM_IMPL_AESNI 3            // AES-NI + PCLMULQDQ
+
+int aes256_gcm_impl(void);
+
+// ciphertext = plaintext_len byte, tag 16 byte terpisah
+int aes256_gcm_encrypt(uint8_t *ciphertext, uint8_t tag[AES_GCM_TAG_BYTES],
+                       const uint8_t *plaintext, size_t plaintext_len,
+                       const uint8_t *aad, size_t aad_len,
+                       const uint8_t key[AES256_KEY_BYTES],
+                       const uint8_t iv[AES_GCM_IV_BYTES]);
+
+// Tag diverifikasi sebelum decrypt; plaintext tidak ditulis jika tag salah
+int aes256_gcm_decrypt(uint8_t *plaintext,
+                       const uint8_t *ciphertext, size_t ciphertext_len,
+                       const uint8_t tag[AES_GCM_TAG_BYTES],
+                       const uint8_t *aad, size_t aad_len,
+                       const uint8_t key[AES256_KEY_BYTES],
+                       const uint8_t iv[AES_GCM_IV_BYTES]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -8,14 +8,65 @@
 extern "C" {
 #endif
 
+#if defined(_WIN32) && !defined(ARGON2_STATIC)
+#define ARGON2_IMPORT __declspec(dllimport)
+#else
+#define ARGON2_IMPORT
+#endif
+
+#define ARGON2_VERSION_13 0x13
+#define ARGON2_DEFAULT_FLAGS 0
+
+// Callback alokasi memory Argon2 (dipakai executor untuk recycle arena)
+typedef int (*allocate_fptr)(uint8_t **memory, size_t bytes_to_allocate);
+typedef void (*deallocate_fptr)(uint8_t *memory, size_t bytes_to_allocate);
+
+// Layout harus sama dengan argon2_context di library asli
+typedef struct Argon2_Context {
+    uint8_t *out;
+    uint32_t outlen;
+
+    uint8_t *pwd;
+    uint32_t pwdlen;
+
+    uint8_t *salt;
+    uint32_t saltlen;
+
+    uint8_t *secret;
+    uint32_t secretlen;
+
+    uint8_t *ad;
+    uint32_t adlen;
+
+    uint32_t t_cost;
+    uint32_t m_cost;
+    uint32_t lanes;
+    uint32_t threads;
+
+    uint32_t version;
+
+    allocate_fptr allocate_cbk;
+    deallocate_fptr free_cbk;
+
+    uint32_t flags;
+} argon2_context;
+
+typedef enum Argon2_type {
+    Argon2_d = 0,
+    Argon2_i = 1,
+    Argon2_id = 2
+} argon2_type;
+
 // Hanya export function yang kita butuhkan
-__declspec(dllimport) int argon2id_hash_raw(uint32_t t_cost, uint32_t m_cost, uint32_t parallelism,
-                                           const void *pwd, size_t pwdlen,
-                                           const void *salt, size_t saltlen, 
-                                           void *hash, size_t hashlen);
+ARGON2_IMPORT int argon2id_hash_raw(uint32_t t_cost, uint32_t m_cost, uint32_t parallelism,
+                                    const void *pwd, size_t pwdlen,
+                                    const void *salt, size_t saltlen,
+                                    void *hash, size_t hashlen);
+
+ARGON2_IMPORT int argon2_ctx(argon2_context *context, argon2_type type);
 
 #if defined(__cplusplus)
 }
 #endif
 
-#endif
\ No newline at end of file
+#endif
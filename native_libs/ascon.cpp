@@ -0,0 +1,258 @@
+#include "ascon.h"
+#include "native_metrics.h"
+
+#include <cstring>
+
+namespace {
+
+constexpr uint64_t kAscon128aIv = 0x80800c0800000000ULL;
+
+struct AsconState {
+    uint64_t x0, x1, x2, x3, x4;
+};
+
+inline uint64_t load64_be(const uint8_t *p) {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++) v = (v << 8) | p[i];
+    return v;
+}
+
+inline void store64_be(uint8_t *p, uint64_t v) {
+    for (int i = 7; i >= 0; i--) {
+        p[i] = (uint8_t)v;
+        v >>= 8;
+    }
+}
+
+// Load/store sebagian (len < 8) ke byte teratas word, sesuai urutan big-endian Ascon
+inline uint64_t load_partial(const uint8_t *p, size_t len) {
+    uint64_t v = 0;
+    for (size_t i = 0; i < len; i++) v |= (uint64_t)p[i] << (56 - 8 * i);
+    return v;
+}
+
+inline void store_partial(uint8_t *p, uint64_t v, size_t len) {
+    for (size_t i = 0; i < len; i++) p[i] = (uint8_t)(v >> (56 - 8 * i));
+}
+
+inline uint64_t clear_bytes(uint64_t w, size_t len) {
+    return len == 0 ? w : len >= 8 ? 0 : w & (~0ULL >> (8 * len));
+}
+
+inline uint64_t pad(size_t i) {
+    return 0x80ULL << (56 - 8 * i);
+}
+
+inline uint64_t ror64(uint64_t x, int n) {
+    return (x >> n) | (x << (64 - n));
+}
+
+inline void ascon_round(AsconState &s, uint64_t c) {
+    uint64_t x0 = s.x0, x1 = s.x1, x2 = s.x2 ^ c, x3 = s.x3, x4 = s.x4;
+
+    // Substitution layer: S-box 5-bit dievaluasi paralel di 64 kolom
+    x0 ^= x4;
+    x4 ^= x3;
+    x2 ^= x1;
+    uint64_t t0 = ~x0 & x1;
+    uint64_t t1 = ~x1 & x2;
+    uint64_t t2 = ~x2 & x3;
+    uint64_t t3 = ~x3 & x4;
+    uint64_t t4 = ~x4 & x0;
+    x0 ^= t1;
+    x1 ^= t2;
+    x2 ^= t3;
+    x3 ^= t4;
+    x4 ^= t0;
+    x1 ^= x0;
+    x0 ^= x4;
+    x3 ^= x2;
+    x2 = ~x2;
+
+    // Linear diffusion layer
+    s.x0 = x0 ^ ror64(x0, 19) ^ ror64(x0, 28);
+    s.x1 = x1 ^ ror64(x1, 61) ^ ror64(x1, 39);
+    s.x2 = x2 ^ ror64(x2, 1) ^ ror64(x2, 6);
+    s.x3 = x3 ^ ror64(x3, 10) ^ ror64(x3, 17);
+    s.x4 = x4 ^ ror64(x4, 7) ^ ror64(x4, 41);
+}
+
+// p^12 dan p^8 di-unroll supaya konstanta menjadi immediate
+inline void p12(AsconState &s) {
+    ascon_round(s, 0xf0);
+    ascon_round(s, 0xe1);
+    ascon_round(s, 0xd2);
+    ascon_round(s, 0xc3);
+    ascon_round(s, 0xb4);
+    ascon_round(s, 0xa5);
+    ascon_round(s, 0x96);
+    ascon_round(s, 0x87);
+    ascon_round(s, 0x78);
+    ascon_round(s, 0x69);
+    ascon_round(s, 0x5a);
+    ascon_round(s, 0x4b);
+}
+
+inline void p8(AsconState &s) {
+    ascon_round(s, 0xb4);
+    ascon_round(s, 0xa5);
+    ascon_round(s, 0x96);
+    ascon_round(s, 0x87);
+    ascon_round(s, 0x78);
+    ascon_round(s, 0x69);
+    ascon_round(s, 0x5a);
+    ascon_round(s, 0x4b);
+}
+
+void initialize(AsconState &s, uint64_t k0, uint64_t k1, const uint8_t *nonce,
+                const uint8_t *aad, size_t aad_len) {
+    s.x0 = kAscon128aIv;
+    s.x1 = k0;
+    s.x2 = k1;
+    s.x3 = load64_be(nonce);
+    s.x4 = load64_be(nonce + 8);
+    p12(s);
+    s.x3 ^= k0;
+    s.x4 ^= k1;
+
+    if (aad_len > 0) {
+        while (aad_len >= ASCON128A_RATE_BYTES) {
+            s.x0 ^= load64_be(aad);
+            s.x1 ^= load64_be(aad + 8);
+            p8(s);
+            aad += ASCON128A_RATE_BYTES;
+            aad_len -= ASCON128A_RATE_BYTES;
+        }
+        if (aad_len >= 8) {
+            s.x0 ^= load64_be(aad);
+            s.x1 ^= load_partial(aad + 8, aad_len - 8) ^ pad(aad_len - 8);
+        } else {
+            s.x0 ^= load_partial(aad, aad_len) ^ pad(aad_len);
+        }
+        p8(s);
+    }
+    // Domain separation AD / pesan
+    s.x4 ^= 1;
+}
+
+void finalize(AsconState &s, uint64_t k0, uint64_t k1, uint8_t tag[ASCON128A_TAG_BYTES]) {
+    s.x2 ^= k0;
+    s.x3 ^= k1;
+    p12(s);
+    store64_be(tag, s.x3 ^ k0);
+    store64_be(tag + 8, s.x4 ^ k1);
+}
+
+void secure_wipe(void *p, size_t len) {
+    volatile uint8_t *v = static_cast<volatile uint8_t *>(p);
+    for (size_t i = 0; i < len; i++) {
+        v[i] = 0;
+    }
+}
+
+}  // namespace
+
+extern "C" int ascon128a_encrypt(uint8_t *ciphertext, uint8_t tag[ASCON128A_TAG_BYTES],
+                                 const uint8_t *plaintext, size_t plaintext_len,
+                                 const uint8_t *aad, size_t aad_len,
+                                 const uint8_t key[ASCON128A_KEY_BYTES],
+                                 const uint8_t nonce[ASCON128A_NONCE_BYTES]) {
+    if (!tag || !key || !nonce || (plaintext_len && (!plaintext || !ciphertext)) || (aad_len && !aad)) {
+        return ASCON_ERROR_INVALID_INPUT;
+    }
+
+    const uint64_t started_ns = native_metrics_now_ns();
+    const uint64_t k0 = load64_be(key);
+    const uint64_t k1 = load64_be(key + 8);
+    AsconState s;
+    initialize(s, k0, k1, nonce, aad, aad_len);
+
+    size_t len = plaintext_len;
+    while (len >= ASCON128A_RATE_BYTES) {
+        s.x0 ^= load64_be(plaintext);
+        s.x1 ^= load64_be(plaintext + 8);
+        store64_be(ciphertext, s.x0);
+        store64_be(ciphertext + 8, s.x1);
+        p8(s);
+        plaintext += ASCON128A_RATE_BYTES;
+        ciphertext += ASCON128A_RATE_BYTES;
+        len -= ASCON128A_RATE_BYTES;
+    }
+    if (len >= 8) {
+        s.x0 ^= load64_be(plaintext);
+        s.x1 ^= load_partial(plaintext + 8, len - 8);
+        store64_be(ciphertext, s.x0);
+        store_partial(ciphertext + 8, s.x1, len - 8);
+        s.x1 ^= pad(len - 8);
+    } else {
+        s.x0 ^= load_partial(plaintext, len);
+        store_partial(ciphertext, s.x0, len);
+        s.x0 ^= pad(len);
+    }
+
+    finalize(s, k0, k1, tag);
+    secure_wipe(&s, sizeof(s));
+    native_metrics_record(NATIVE_METRICS_CIPHER, started_ns, plaintext_len, 1);
+    return ASCON_OK;
+}
+
+extern "C" int ascon128a_decrypt(uint8_t *plaintext,
+                                 const uint8_t *ciphertext, size_t ciphertext_len,
+                                 const uint8_t tag[ASCON128A_TAG_BYTES],
+                                 const uint8_t *aad, size_t aad_len,
+                                 const uint8_t key[ASCON128A_KEY_BYTES],
+                                 const uint8_t nonce[ASCON128A_NONCE_BYTES]) {
+    if (!tag || !key || !nonce || (ciphertext_len && (!plaintext || !ciphertext)) || (aad_len && !aad)) {
+        return ASCON_ERROR_INVALID_INPUT;
+    }
+
+    const uint64_t started_ns = native_metrics_now_ns();
+    const uint64_t k0 = load64_be(key);
+    const uint64_t k1 = load64_be(key + 8);
+    AsconState s;
+    initialize(s, k0, k1, nonce, aad, aad_len);
+
+    uint8_t *out = plaintext;
+    size_t len = ciphertext_len;
+    while (len >= ASCON128A_RATE_BYTES) {
+        const uint64_t c0 = load64_be(ciphertext);
+        const uint64_t c1 = load64_be(ciphertext + 8);
+        store64_be(out, s.x0 ^ c0);
+        store64_be(out + 8, s.x1 ^ c1);
+        s.x0 = c0;
+        s.x1 = c1;
+        p8(s);
+        ciphertext += ASCON128A_RATE_BYTES;
+        out += ASCON128A_RATE_BYTES;
+        len -= ASCON128A_RATE_BYTES;
+    }
+    if (len >= 8) {
+        const uint64_t c0 = load64_be(ciphertext);
+        const uint64_t c1 = load_partial(ciphertext + 8, len - 8);
+        store64_be(out, s.x0 ^ c0);
+        store_partial(out + 8, s.x1 ^ c1, len - 8);
+        s.x0 = c0;
+        s.x1 = clear_bytes(s.x1, len - 8) ^ c1 ^ pad(len - 8);
+    } else {
+        const uint64_t c0 = load_partial(ciphertext, len);
+        store_partial(out, s.x0 ^ c0, len);
+        s.x0 = clear_bytes(s.x0, len) ^ c0 ^ pad(len);
+    }
+
+    uint8_t expected[ASCON128A_TAG_BYTES];
+    finalize(s, k0, k1, expected);
+    secure_wipe(&s, sizeof(s));
+
+    uint8_t diff = 0;
+    for (int i = 0; i < ASCON128A_TAG_BYTES; i++) {
+        diff |= expected[i] ^ tag[i];
+    }
+    secure_wipe(expected, sizeof(expected));
+    if (diff != 0) {
+        if (ciphertext_len) secure_wipe(plaintext, ciphertext_len);
+        native_metrics_record(NATIVE_METRICS_CIPHER, started_ns, ciphertext_len, 0);
+        return ASCON_ERROR_AUTH_FAILED;
+    }
+    native_metrics_record(NATIVE_METRICS_CIPHER, started_ns, ciphertext_len, 1);
+    return ASCON_OK;
+}
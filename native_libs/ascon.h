@@ -0,0 +1,44 @@
+#ifndef ASCON_H
+#define ASCON_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Ascon-128a (v1.2, pemenang NIST Lightweight Cryptography). State 5 x 64-bit dengan
+// S-box bitsliced: hanya AND/XOR/NOT/rotate pada register 64-bit, tanpa tabel dan tanpa
+// instruksi AES, jadi cepat dan constant-time di core in-order low-end.
+
+#define ASCON128A_KEY_BYTES 16
+#define ASCON128A_NONCE_BYTES 16
+#define ASCON128A_TAG_BYTES 16
+#define ASCON128A_RATE_BYTES 16
+
+// Status sama dengan AEAD_* di chacha20_poly1305.h
+#define ASCON_OK 0
+#define ASCON_ERROR_INVALID_INPUT -1
+#define ASCON_ERROR_AUTH_FAILED -2
+
+// Ciphertext sama panjang dengan plaintext + tag 16 byte terpisah (in-place diperbolehkan)
+int ascon128a_encrypt(uint8_t *ciphertext, uint8_t tag[ASCON128A_TAG_BYTES],
+                      const uint8_t *plaintext, size_t plaintext_len,
+                      const uint8_t *aad, size_t aad_len,
+                      const uint8_t key[ASCON128A_KEY_BYTES],
+                      const uint8_t nonce[ASCON128A_NONCE_BYTES]);
+
+// Tag dicek constant-time; jika gagal plaintext dinolkan
+int ascon128a_decrypt(uint8_t *plaintext,
+                      const uint8_t *ciphertext, size_t ciphertext_len,
+                      const uint8_t tag[ASCON128A_TAG_BYTES],
+                      const uint8_t *aad, size_t aad_len,
+                      const uint8_t key[ASCON128A_KEY_BYTES],
+                      const uint8_t nonce[ASCON128A_NONCE_BYTES]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,123 @@
+#include "auth_engine.h"
+#include "argon2.h"
+#include "native_metrics.h"
+#include "sha3.h"
+
+#include <cstring>
+
+namespace {
+
+void secure_wipe(void *p, size_t len) {
+    volatile uint8_t *v = static_cast<volatile uint8_t *>(p);
+    for (size_t i = 0; i < len; i++) {
+        v[i] = 0;
+    }
+}
+
+bool valid_params(const KdfParams *params) {
+    return params && params->t_cost > 0 && params->parallelism > 0;
+}
+
+// Sisa rantai setelah Argon2id: verifikasi, SHA3-512 challenge, kombinasi.
+// password_hash sudah ada di out->password_hash.
+int finish_response(const uint8_t *challenge, size_t challengelen,
+                    const uint8_t *expected_hash, AuthResponse *out) {
+    if (expected_hash) {
+        uint8_t diff = 0;
+        for (size_t i = 0; i < AUTH_PASSWORD_HASH_BYTES; i++) {
+            diff |= out->password_hash[i] ^ expected_hash[i];
+        }
+        if (diff != 0) {
+            secure_wipe(out, sizeof(*out));
+            return AUTH_ERROR_MISMATCH;
+        }
+    }
+
+    SHA3_CTX ctx;
+    sha3_512_init(&ctx);
+    sha3_512_update(&ctx, challenge, challengelen);
+    sha3_512_final(out->challenge_hash, &ctx);
+    secure_wipe(&ctx, sizeof(ctx));
+
+    // Sama dengan _combineHashesSecure: key = challenge_hash || password_hash[0..16]
+    uint8_t key[AUTH_CHALLENGE_HASH_BYTES + 16];
+    memcpy(key, out->challenge_hash, AUTH_CHALLENGE_HASH_BYTES);
+    memcpy(key + AUTH_CHALLENGE_HASH_BYTES, out->password_hash, 16);
+    for (size_t i = 0; i < AUTH_PASSWORD_HASH_BYTES; i++) {
+        out->combined[i] = out->password_hash[i] ^ key[i % sizeof(key)] ^ static_cast<uint8_t>(i & 0xFF);
+    }
+    secure_wipe(key, sizeof(key));
+    return AUTH_OK;
+}
+
+}  // namespace
+
+extern "C" int auth_respond(const uint8_t *pwd, size_t pwdlen,
+                            const uint8_t *salt, size_t saltlen,
+                            const KdfParams *params,
+                            const uint8_t *challenge, size_t challengelen,
+                            const uint8_t *expected_hash,
+                            AuthResponse *out) {
+    if (!out || (!pwd && pwdlen) || !salt || saltlen == 0 || (!challenge && challengelen) ||
+        !valid_params(params)) {
+        return AUTH_ERROR_INVALID_INPUT;
+    }
+    memset(out, 0, sizeof(*out));
+
+    const uint64_t started_ns = native_metrics_now_ns();
+    const int rc = argon2id_hash_raw(params->t_cost, params->m_cost, params->parallelism,
+                                     pwd, pwdlen, salt, saltlen,
+                                     out->password_hash, AUTH_PASSWORD_HASH_BYTES);
+    native_metrics_record(NATIVE_METRICS_KDF, started_ns, static_cast<uint64_t>(params->m_cost) * 1024, rc == 0);
+    if (rc != 0) {
+        secure_wipe(out, sizeof(*out));
+        return AUTH_ERROR_ARGON2;
+    }
+    return finish_response(challenge, challengelen, expected_hash, out);
+}
+
+extern "C" int auth_respond_speculative(SpeculativeKdf *spec,
+                                        const uint8_t *pwd, size_t pwdlen,
+                                        const uint8_t *salt, size_t saltlen,
+                                        const KdfParams *params,
+                                        const uint8_t *challenge, size_t challengelen,
+                                        const uint8_t *expected_hash,
+                                        AuthResponse *out) {
+    if (!spec) {
+        return auth_respond(pwd, pwdlen, salt, saltlen, params, challenge, challengelen, expected_hash, out);
+    }
+    if (!out || (!pwd && pwdlen) || !salt || saltlen == 0 || (!challenge && challengelen) ||
+        !valid_params(params)) {
+        return AUTH_ERROR_INVALID_INPUT;
+    }
+    memset(out, 0, sizeof(*out));
+
+    const int rc = speculative_kdf_take(spec, params, pwd, pwdlen, salt, saltlen,
+                                        out->password_hash, AUTH_PASSWORD_HASH_BYTES, -1);
+    if (rc == SPECULATIVE_KDF_OK) {
+        return finish_response(challenge, challengelen, expected_hash, out);
+    }
+    if (rc == SPECULATIVE_KDF_ERROR_ARGON2) return AUTH_ERROR_ARGON2;
+    return auth_respond(pwd, pwdlen, salt, saltlen, params, challenge, challengelen, expected_hash, out);
+}
+
+extern "C" int64_t auth_submit(KdfExecutor *executor, const KdfParams *params,
+                               const uint8_t *pwd, size_t pwdlen,
+                               const uint8_t *salt, size_t saltlen) {
+    return kdf_executor_submit(executor, params, pwd, pwdlen, salt, saltlen,
+                               AUTH_PASSWORD_HASH_BYTES, KDF_PRIORITY_INTERACTIVE);
+}
+
+extern "C" int auth_collect(KdfExecutor *executor, int64_t job_id,
+                            const uint8_t *challenge, size_t challengelen,
+                            const uint8_t *expected_hash,
+                            AuthResponse *out, int32_t timeout_ms) {
+    if (!executor || !out || (!challenge && challengelen)) return AUTH_ERROR_INVALID_INPUT;
+    memset(out, 0, sizeof(*out));
+
+    const int rc = kdf_executor_wait(executor, job_id, out->password_hash, AUTH_PASSWORD_HASH_BYTES, timeout_ms);
+    if (rc == KDF_PENDING) return AUTH_PENDING;
+    if (rc == KDF_ERROR_ARGON2) return AUTH_ERROR_ARGON2;
+    if (rc != KDF_OK) return AUTH_ERROR_INVALID_INPUT;
+    return finish_response(challenge, challengelen, expected_hash, out);
+}
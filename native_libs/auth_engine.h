@@ -0,0 +1,72 @@
+#ifndef AUTH_ENGINE_H
+#define AUTH_ENGINE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "kdf_executor.h"
+#include "speculative_kdf.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Challenge-response login dalam satu panggilan native: Argon2id(password, salt),
+// verifikasi constant-time terhadap hash tersimpan, SHA3-512(challenge), lalu kombinasi
+// yang sama dengan CryptoAuthFFI._combineHashesSecure. Password dan hash antara tidak
+// pernah menjadi String Dart dan dihapus sebelum fungsi kembali.
+
+#define AUTH_OK 0
+#define AUTH_ERROR_INVALID_INPUT -1
+#define AUTH_ERROR_MISMATCH -2
+#define AUTH_ERROR_ARGON2 -3
+#define AUTH_PENDING 1
+
+#define AUTH_PASSWORD_HASH_BYTES 32
+#define AUTH_CHALLENGE_HASH_BYTES 64
+
+// Response biner ukuran tetap (128 byte)
+typedef struct {
+    uint8_t password_hash[AUTH_PASSWORD_HASH_BYTES];
+    uint8_t challenge_hash[AUTH_CHALLENGE_HASH_BYTES];
+    uint8_t combined[AUTH_PASSWORD_HASH_BYTES];
+} AuthResponse;
+
+// expected_hash = hash Argon2id tersimpan (AUTH_PASSWORD_HASH_BYTES) atau NULL untuk
+// registrasi. Return AUTH_ERROR_MISMATCH jika password salah; out tetap dinolkan.
+int auth_respond(const uint8_t *pwd, size_t pwdlen,
+                 const uint8_t *salt, size_t saltlen,
+                 const KdfParams *params,
+                 const uint8_t *challenge, size_t challengelen,
+                 const uint8_t *expected_hash,
+                 AuthResponse *out);
+
+// Sama dengan auth_respond, tapi hash Argon2id diambil dari spekulasi aktif jika input
+// identik (menunggu jika masih berjalan). Input berbeda atau tanpa spekulasi = hitung
+// langsung seperti auth_respond. spec boleh NULL.
+int auth_respond_speculative(SpeculativeKdf *spec,
+                             const uint8_t *pwd, size_t pwdlen,
+                             const uint8_t *salt, size_t saltlen,
+                             const KdfParams *params,
+                             const uint8_t *challenge, size_t challengelen,
+                             const uint8_t *expected_hash,
+                             AuthResponse *out);
+
+// Varian async di atas KdfExecutor: Argon2id berjalan di antrian executor (prioritas
+// interaktif), auth_collect menunggu job lalu menyelesaikan SHA3 + kombinasi.
+// Return job id (> 0) atau status KDF_ERROR_*.
+int64_t auth_submit(KdfExecutor *executor, const KdfParams *params,
+                    const uint8_t *pwd, size_t pwdlen,
+                    const uint8_t *salt, size_t saltlen);
+
+// timeout_ms seperti kdf_executor_wait. Return AUTH_PENDING jika job belum selesai.
+int auth_collect(KdfExecutor *executor, int64_t job_id,
+                 const uint8_t *challenge, size_t challengelen,
+                 const uint8_t *expected_hash,
+                 AuthResponse *out, int32_t timeout_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
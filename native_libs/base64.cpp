@@ -0,0 +1,110 @@
+#include "base64.h"
+
+static const char kEncodeTable[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// 0xFF = karakter tidak valid
+static const uint8_t kDecodeTable[256] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 62,   0xFF, 0xFF, 0xFF, 63,
+    52,   53,   54,   55,   56,   57,   58,   59,   60,   61,   0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0,    1,    2,    3,    4,    5,    6,    7,    8,    9,    10,   11,   12,   13,   14,
+    15,   16,   17,   18,   19,   20,   21,   22,   23,   24,   25,   0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 26,   27,   28,   29,   30,   31,   32,   33,   34,   35,   36,   37,   38,   39,   40,
+    41,   42,   43,   44,   45,   46,   47,   48,   49,   50,   51,   0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+};
+
+extern "C" size_t base64_encoded_length(size_t input_len) {
+    return ((input_len + 2) / 3) * 4;
+}
+
+extern "C" size_t base64_decoded_max_length(size_t input_len) {
+    return (input_len / 4) * 3 + 3;
+}
+
+extern "C" size_t base64_encode(char *out, const uint8_t *in, size_t len) {
+    char *p = out;
+    size_t i = 0;
+
+    // 12 byte input -> 16 karakter per iterasi, loop ini di-vectorize oleh compiler (SIMD128/SSE)
+    for (; i + 12 <= len; i += 12) {
+        for (int j = 0; j < 4; j++) {
+            const uint32_t v = ((uint32_t)in[i + 3 * j] << 16) | ((uint32_t)in[i + 3 * j + 1] << 8) | in[i + 3 * j + 2];
+            p[4 * j + 0] = kEncodeTable[(v >> 18) & 0x3F];
+            p[4 * j + 1] = kEncodeTable[(v >> 12) & 0x3F];
+            p[4 * j + 2] = kEncodeTable[(v >> 6) & 0x3F];
+            p[4 * j + 3] = kEncodeTable[v & 0x3F];
+        }
+        p += 16;
+    }
+    for (; i + 3 <= len; i += 3) {
+        const uint32_t v = ((uint32_t)in[i] << 16) | ((uint32_t)in[i + 1] << 8) | in[i + 2];
+        *p++ = kEncodeTable[(v >> 18) & 0x3F];
+        *p++ = kEncodeTable[(v >> 12) & 0x3F];
+        *p++ = kEncodeTable[(v >> 6) & 0x3F];
+        *p++ = kEncodeTable[v & 0x3F];
+    }
+
+    const size_t rest = len - i;
+    if (rest == 1) {
+        const uint32_t v = (uint32_t)in[i] << 16;
+        *p++ = kEncodeTable[(v >> 18) & 0x3F];
+        *p++ = kEncodeTable[(v >> 12) & 0x3F];
+        *p++ = '=';
+        *p++ = '=';
+    } else if (rest == 2) {
+        const uint32_t v = ((uint32_t)in[i] << 16) | ((uint32_t)in[i + 1] << 8);
+        *p++ = kEncodeTable[(v >> 18) & 0x3F];
+        *p++ = kEncodeTable[(v >> 12) & 0x3F];
+        *p++ = kEncodeTable[(v >> 6) & 0x3F];
+        *p++ = '=';
+    }
+
+    return (size_t)(p - out);
+}
+
+extern "C" int64_t base64_decode(uint8_t *out, const char *in, size_t len) {
+    if (len % 4 != 0) return -1;
+    if (len == 0) return 0;
+
+    size_t padding = 0;
+    if (in[len - 1] == '=') padding++;
+    if (in[len - 2] == '=') padding++;
+
+    uint8_t *p = out;
+    const size_t full = len - (padding ? 4 : 0);
+
+    for (size_t i = 0; i < full; i += 4) {
+        const uint8_t a = kDecodeTable[(uint8_t)in[i]];
+        const uint8_t b = kDecodeTable[(uint8_t)in[i + 1]];
+        const uint8_t c = kDecodeTable[(uint8_t)in[i + 2]];
+        const uint8_t d = kDecodeTable[(uint8_t)in[i + 3]];
+        if ((a | b | c | d) & 0x80) return -1;
+        const uint32_t v = ((uint32_t)a << 18) | ((uint32_t)b << 12) | ((uint32_t)c << 6) | d;
+        *p++ = (uint8_t)(v >> 16);
+        *p++ = (uint8_t)(v >> 8);
+        *p++ = (uint8_t)v;
+    }
+
+    if (padding) {
+        const char *q = in + len - 4;
+        const uint8_t a = kDecodeTable[(uint8_t)q[0]];
+        const uint8_t b = kDecodeTable[(uint8_t)q[1]];
+        const uint8_t c = padding == 2 ? 0 : kDecodeTable[(uint8_t)q[2]];
+        if ((a | b | c) & 0x80) return -1;
+        const uint32_t v = ((uint32_t)a << 18) | ((uint32_t)b << 12) | ((uint32_t)c << 6);
+        *p++ = (uint8_t)(v >> 16);
+        if (padding == 1) *p++ = (uint8_t)(v >> 8);
+    }
+
+    return (int64_t)(p - out);
+}
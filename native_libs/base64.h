@@ -0,0 +1,27 @@
+#ifndef BASE64_H
+#define BASE64_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Panjang output base64 (standard alphabet, dengan padding '=')
+size_t base64_encoded_length(size_t input_len);
+
+// Panjang maksimum hasil decode untuk input base64 sepanjang input_len
+size_t base64_decoded_max_length(size_t input_len);
+
+// Encode ke alphabet standar (sama dengan dart:convert base64), return panjang output
+size_t base64_encode(char *out, const uint8_t *in, size_t len);
+
+// Decode base64 standar; return jumlah byte hasil decode, atau -1 jika input tidak valid
+int64_t base64_decode(uint8_t *out, const char *in, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
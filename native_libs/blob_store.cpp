@@ -0,0 +1,695 @@
+#include "blob_store.h"
+#include "native_metrics.h"
+#include "sha512.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <string>
+#include <system_error>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr uint64_t kDefaultBudget = 256ull << 20;
+constexpr size_t kHashHexLen = BLOB_STORE_HASH_HEX_BYTES - 1;
+constexpr size_t kMaxNameLen = 1024;
+// Journal dipadatkan jika record melebihi 2x entri + slack ini
+constexpr uint64_t kCompactSlack = 256;
+
+struct BlobEntry {
+    uint64_t size = 0;
+    uint32_t refs = 0;
+    uint64_t hits = 0;
+    uint64_t tick = 0;              // jam logis akses terakhir
+    std::vector<std::string> names;
+};
+
+// Urutan eviction: LRU (tick, 0, hash), LFU (hits, tick, hash)
+using EvictKey = std::tuple<uint64_t, uint64_t, std::string>;
+
+bool valid_hash(const char *hash) {
+    if (!hash) return false;
+    for (size_t i = 0; i < kHashHexLen; i++) {
+        const char c = hash[i];
+        if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f'))) return false;
+    }
+    return hash[kHashHexLen] == '\0';
+}
+
+bool valid_name(const char *name) {
+    if (!name || !*name) return false;
+    const size_t len = strnlen(name, kMaxNameLen + 1);
+    return len <= kMaxNameLen && !memchr(name, '\n', len) && !memchr(name, '\r', len);
+}
+
+std::string digest_hex(const uint8_t digest[SHA512_DIGEST_BYTES]) {
+    static const char kHex[] = "0123456789abcdef";
+    std::string out(kHashHexLen, '0');
+    for (size_t i = 0; i < kHashHexLen / 2; i++) {
+        out[2 * i] = kHex[digest[i] >> 4];
+        out[2 * i + 1] = kHex[digest[i] & 0x0F];
+    }
+    return out;
+}
+
+std::string hash_hex(const uint8_t *data, size_t len) {
+    SHA512_CTX ctx;
+    uint8_t digest[SHA512_DIGEST_BYTES];
+    sha512_init(&ctx);
+    sha512_update(&ctx, data, len);
+    sha512_final(digest, &ctx);
+    return digest_hex(digest);
+}
+
+int sync_file(FILE *file) {
+    if (fflush(file) != 0) return -1;
+#if defined(_WIN32)
+    return _commit(_fileno(file));
+#else
+    return fsync(fileno(file));
+#endif
+}
+
+// Path store berasal dari UTF-8 (u8path); Windows butuh API wide-char agar nama non-ASCII tetap benar
+FILE *open_file(const fs::path &path, const char *mode) {
+#if defined(_WIN32)
+    wchar_t wide_mode[8] = {0};
+    for (size_t i = 0; i < 7 && mode[i]; i++) wide_mode[i] = static_cast<wchar_t>(mode[i]);
+    return _wfopen(path.c_str(), wide_mode);
+#else
+    return fopen(path.c_str(), mode);
+#endif
+}
+
+bool read_file(const fs::path &path, std::vector<uint8_t> &out) {
+    FILE *file = open_file(path, "rb");
+    if (!file) return false;
+    out.clear();
+    uint8_t buffer[64 * 1024];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        out.insert(out.end(), buffer, buffer + n);
+    }
+    const bool ok = !ferror(file);
+    fclose(file);
+    return ok;
+}
+
+}  // namespace
+
+struct BlobStore {
+    std::mutex mutex;
+    fs::path root;
+    fs::path objects;
+    fs::path tmp;
+    fs::path journal_path;
+    FILE *journal = nullptr;
+    uint64_t budget = kDefaultBudget;
+    int policy = BLOB_STORE_EVICT_LRU;
+
+    std::unordered_map<std::string, BlobEntry> entries;
+    std::unordered_map<std::string, std::string> names;
+    std::set<EvictKey> evictable;   // hanya entri dengan refs == 0
+    std::atomic<uint64_t> tmp_counter{0};
+
+    uint64_t clock = 0;
+    uint64_t total_hits = 0;        // jumlah hits semua entri, untuk seed_hits
+    uint64_t total_bytes = 0;
+    uint64_t pinned_bytes = 0;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t dedup_hits = 0;
+    uint64_t evictions = 0;
+    uint64_t evicted_bytes = 0;
+    uint64_t journal_records = 0;
+    uint64_t recovered_orphans = 0;
+
+    fs::path object_path(const std::string &hash) const {
+        return objects / hash.substr(0, 2) / hash;
+    }
+
+    EvictKey evict_key(const std::string &hash, const BlobEntry &entry) const {
+        if (policy == BLOB_STORE_EVICT_LFU) return EvictKey(entry.hits, entry.tick, hash);
+        return EvictKey(entry.tick, 0, hash);
+    }
+
+    uint64_t seed_hits() const;
+    bool append(const std::string &line, bool durable);
+    void insert_entry(const std::string &hash, uint64_t size, uint32_t refs, uint64_t hits);
+    void touch(const std::string &hash, BlobEntry &entry);
+    void add_name(const std::string &hash, BlobEntry &entry, const std::string &name);
+    void drop_entry(const std::string &hash);
+    void pin_locked(const std::string &hash, BlobEntry &entry);
+    void unpin_locked(const std::string &hash, BlobEntry &entry);
+    void evict_to_budget();
+    void replay(const std::string &journal);
+    void recover_objects();
+    int compact_locked();
+    void maybe_compact();
+};
+
+// Blob baru mulai dari rata-rata hits, bukan 1: dengan LFU blob yang baru di-put tidak
+// langsung jadi korban pertama sebelum sempat dibaca
+uint64_t BlobStore::seed_hits() const {
+    if (entries.empty()) return 1;
+    return std::max<uint64_t>(1, total_hits / entries.size());
+}
+
+bool BlobStore::append(const std::string &line, bool durable) {
+    if (!journal) return false;
+    journal_records++;
+    if (fwrite(line.data(), 1, line.size(), journal) != line.size()) return false;
+    return durable ? sync_file(journal) == 0 : fflush(journal) == 0;
+}
+
+void BlobStore::insert_entry(const std::string &hash, uint64_t size, uint32_t refs, uint64_t hit_count) {
+    BlobEntry &entry = entries[hash];
+    entry.size = size;
+    entry.refs = refs;
+    entry.hits = hit_count;
+    entry.tick = ++clock;
+    total_hits += hit_count;
+    total_bytes += size;
+    if (refs > 0) pinned_bytes += size;
+    else evictable.insert(evict_key(hash, entry));
+}
+
+void BlobStore::touch(const std::string &hash, BlobEntry &entry) {
+    if (entry.refs == 0) evictable.erase(evict_key(hash, entry));
+    entry.tick = ++clock;
+    entry.hits++;
+    total_hits++;
+    if (entry.refs == 0) evictable.insert(evict_key(hash, entry));
+}
+
+void BlobStore::add_name(const std::string &hash, BlobEntry &entry, const std::string &name) {
+    auto it = names.find(name);
+    if (it != names.end()) {
+        if (it->second == hash) return;
+        // Nama dipakai ulang untuk ciphertext lain: lepas dari blob lama
+        auto old = entries.find(it->second);
+        if (old != entries.end()) {
+            auto &old_names = old->second.names;
+            for (size_t i = 0; i < old_names.size(); i++) {
+                if (old_names[i] == name) {
+                    old_names.erase(old_names.begin() + static_cast<std::ptrdiff_t>(i));
+                    break;
+                }
+            }
+        }
+    }
+    names[name] = hash;
+    entry.names.push_back(name);
+}
+
+void BlobStore::drop_entry(const std::string &hash) {
+    auto it = entries.find(hash);
+    if (it == entries.end()) return;
+    BlobEntry &entry = it->second;
+    if (entry.refs == 0) evictable.erase(evict_key(hash, entry));
+    else pinned_bytes -= entry.size;
+    total_bytes -= entry.size;
+    total_hits -= entry.hits;
+    for (const auto &name : entry.names) {
+        auto n = names.find(name);
+        if (n != names.end() && n->second == hash) names.erase(n);
+    }
+    entries.erase(it);
+}
+
+void BlobStore::pin_locked(const std::string &hash, BlobEntry &entry) {
+    if (entry.refs == 0) {
+        evictable.erase(evict_key(hash, entry));
+        pinned_bytes += entry.size;
+    }
+    entry.refs++;
+}
+
+void BlobStore::unpin_locked(const std::string &hash, BlobEntry &entry) {
+    if (entry.refs == 0) return;
+    if (--entry.refs == 0) {
+        pinned_bytes -= entry.size;
+        evictable.insert(evict_key(hash, entry));
+    }
+}
+
+void BlobStore::evict_to_budget() {
+    while (total_bytes > budget && !evictable.empty()) {
+        const std::string hash = std::get<2>(*evictable.begin());
+        const uint64_t size = entries[hash].size;
+
+        // Hapus file dulu: crash sebelum record D hanya menyisakan entri tanpa file,
+        // yang dibuang saat open berikutnya
+        std::error_code ec;
+        fs::remove(object_path(hash), ec);
+        drop_entry(hash);
+        append("D " + hash + "\n", false);
+        evictions++;
+        evicted_bytes += size;
+    }
+}
+
+void BlobStore::replay(const std::string &text) {
+    size_t pos = 0;
+    while (pos < text.size()) {
+        const size_t end = text.find('\n', pos);
+        // Baris terakhir tanpa newline = append yang terpotong crash, abaikan
+        if (end == std::string::npos) break;
+        const std::string line = text.substr(pos, end - pos);
+        pos = end + 1;
+        journal_records++;
+
+        if (line.size() < 2 + kHashHexLen || line[1] != ' ') continue;
+        const std::string hash = line.substr(2, kHashHexLen);
+        if (!valid_hash(hash.c_str())) continue;
+        const char *rest = line.c_str() + 2 + kHashHexLen;
+        auto it = entries.find(hash);
+
+        switch (line[0]) {
+        case 'S': {
+            // Snapshot: S <hash> <size> <refs> <hits>
+            unsigned long long size = 0, refs = 0, hit_count = 0;
+            if (it == entries.end() && sscanf(rest, " %llu %llu %llu", &size, &refs, &hit_count) == 3) {
+                insert_entry(hash, size, static_cast<uint32_t>(refs), hit_count);
+            }
+            break;
+        }
+        case 'P': {
+            // P <hash> <size> [<hits awal>]; journal lama tanpa hits awal memakai 1
+            unsigned long long size = 0, hit_count = 1;
+            if (it == entries.end() && sscanf(rest, " %llu %llu", &size, &hit_count) >= 1) {
+                insert_entry(hash, size, 0, hit_count);
+            }
+            break;
+        }
+        case 'N':
+            if (it != entries.end() && rest[0] == ' ' && valid_name(rest + 1)) add_name(hash, it->second, rest + 1);
+            break;
+        case 'T':
+            if (it != entries.end()) touch(hash, it->second);
+            break;
+        case '+':
+            if (it != entries.end()) pin_locked(hash, it->second);
+            break;
+        case '-':
+            if (it != entries.end()) unpin_locked(hash, it->second);
+            break;
+        case 'D':
+            drop_entry(hash);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+void BlobStore::recover_objects() {
+    std::error_code ec;
+
+    // Entri journal yang file-nya hilang / tidak utuh
+    std::vector<std::string> missing;
+    for (const auto &kv : entries) {
+        const auto size = fs::file_size(object_path(kv.first), ec);
+        if (ec || size != kv.second.size) missing.push_back(kv.first);
+    }
+    for (const auto &hash : missing) drop_entry(hash);
+
+    // Sisa put yang belum selesai
+    for (const auto &item : fs::directory_iterator(tmp, ec)) {
+        std::error_code ignored;
+        fs::remove(item.path(), ignored);
+    }
+
+    // Blob yang sudah di-rename tapi record P belum sempat ditulis
+    for (const auto &shard : fs::directory_iterator(objects, ec)) {
+        std::error_code shard_ec;
+        for (const auto &item : fs::directory_iterator(shard.path(), shard_ec)) {
+            const std::string hash = item.path().filename().string();
+            if (valid_hash(hash.c_str()) && entries.count(hash)) continue;
+
+            std::vector<uint8_t> data;
+            std::error_code ignored;
+            if (valid_hash(hash.c_str()) && read_file(item.path(), data) &&
+                hash.compare(0, 2, shard.path().filename().string()) == 0 &&
+                hash_hex(data.data(), data.size()) == hash) {
+                insert_entry(hash, data.size(), 0, 0);
+                recovered_orphans++;
+            } else {
+                fs::remove(item.path(), ignored);
+            }
+        }
+    }
+}
+
+int BlobStore::compact_locked() {
+    const fs::path next = root / "journal.tmp";
+    FILE *out = open_file(next, "wb");
+    if (!out) return BLOB_STORE_ERROR_IO;
+
+    // Urut dari akses terlama supaya tick hasil replay mempertahankan urutan LRU
+    std::vector<std::pair<uint64_t, const std::string *>> order;
+    order.reserve(entries.size());
+    for (const auto &kv : entries) order.emplace_back(kv.second.tick, &kv.first);
+    std::sort(order.begin(), order.end());
+
+    uint64_t records = 0;
+    bool ok = true;
+    for (const auto &item : order) {
+        const BlobEntry &entry = entries[*item.second];
+        // LFU aging: hit lama dibagi dua setiap compaction supaya blob populer lama bisa keluar
+        ok = ok && fprintf(out, "S %s %llu %u %llu\n", item.second->c_str(),
+                           static_cast<unsigned long long>(entry.size), entry.refs,
+                           static_cast<unsigned long long>(entry.hits / 2)) > 0;
+        records++;
+        for (const auto &name : entry.names) {
+            ok = ok && fprintf(out, "N %s %s\n", item.second->c_str(), name.c_str()) > 0;
+            records++;
+        }
+    }
+    ok = ok && sync_file(out) == 0;
+    ok = (fclose(out) == 0) && ok;
+
+    std::error_code ec;
+    if (ok) {
+        if (journal) fclose(journal);
+        journal = nullptr;
+        fs::rename(next, journal_path, ec);
+    }
+    if (!journal) journal = open_file(journal_path, "ab");
+    if (!ok || ec || !journal) {
+        fs::remove(next, ec);
+        return BLOB_STORE_ERROR_IO;
+    }
+
+    total_hits = 0;
+    for (auto &kv : entries) {
+        if (kv.second.refs == 0) evictable.erase(evict_key(kv.first, kv.second));
+        kv.second.hits /= 2;
+        total_hits += kv.second.hits;
+        if (kv.second.refs == 0) evictable.insert(evict_key(kv.first, kv.second));
+    }
+    journal_records = records;
+    return BLOB_STORE_OK;
+}
+
+void BlobStore::maybe_compact() {
+    if (journal_records > 2 * entries.size() + kCompactSlack) compact_locked();
+}
+
+extern "C" BlobStore *blob_store_open(const BlobStoreConfig *config, int *status) {
+    auto fail = [status](int code) -> BlobStore * {
+        if (status) *status = code;
+        return nullptr;
+    };
+    if (!config || !config->root || !*config->root) return fail(BLOB_STORE_ERROR_INVALID_INPUT);
+    if (config->policy != BLOB_STORE_EVICT_LRU && config->policy != BLOB_STORE_EVICT_LFU) {
+        return fail(BLOB_STORE_ERROR_INVALID_INPUT);
+    }
+
+    auto *store = new BlobStore();
+    store->root = fs::u8path(config->root);
+    store->objects = store->root / "objects";
+    store->tmp = store->root / "tmp";
+    store->journal_path = store->root / "journal.log";
+    store->budget = config->byte_budget ? config->byte_budget : kDefaultBudget;
+    store->policy = config->policy;
+
+    std::error_code ec;
+    fs::create_directories(store->objects, ec);
+    fs::create_directories(store->tmp, ec);
+    if (ec) {
+        delete store;
+        return fail(BLOB_STORE_ERROR_IO);
+    }
+
+    std::vector<uint8_t> journal;
+    if (fs::exists(store->journal_path, ec)) read_file(store->journal_path, journal);
+    store->replay(std::string(journal.begin(), journal.end()));
+    store->recover_objects();
+
+    // Selalu mulai dari snapshot bersih: membuang baris terpotong dan record basi
+    if (store->compact_locked() != BLOB_STORE_OK) {
+        blob_store_close(store);
+        return fail(BLOB_STORE_ERROR_IO);
+    }
+    store->evict_to_budget();
+
+    if (status) *status = BLOB_STORE_OK;
+    return store;
+}
+
+extern "C" void blob_store_close(BlobStore *store) {
+    if (!store) return;
+    if (store->journal) {
+        sync_file(store->journal);
+        fclose(store->journal);
+    }
+    delete store;
+}
+
+namespace {
+
+// Bagian bersama put dan put_file. write_part menulis ciphertext ke file tmp (write + fsync)
+// tanpa lock dan return false jika gagal; hanya dipanggil jika hash belum ada di store.
+int put_entry(BlobStore *store, const std::string &hash, uint64_t len, const char *name, int pin,
+              uint64_t started_ns, const std::function<bool(const fs::path &)> &write_part) {
+    std::unique_lock<std::mutex> lock(store->mutex);
+    auto it = store->entries.find(hash);
+    if (it == store->entries.end()) {
+        if (!pin && len > store->budget) return BLOB_STORE_ERROR_TOO_LARGE;
+        lock.unlock();
+
+        // Tulis ke tmp/ tanpa lock, lalu rename: object path tidak pernah berisi file
+        // setengah jadi
+        const fs::path part = store->tmp / (hash + "." + std::to_string(store->tmp_counter++));
+        const fs::path target = store->object_path(hash);
+        std::error_code ec;
+        fs::create_directories(target.parent_path(), ec);
+        const bool ok = write_part(part);
+
+        // Rename dan record P di bawah lock yang sama: eviction dari put lain tidak bisa
+        // menghapus target di antara rename dan insert_entry
+        lock.lock();
+        it = store->entries.find(hash);
+        const bool exists = it != store->entries.end();
+        if (ok && !exists) fs::rename(part, target, ec);
+        if (!ok || ec || exists) {
+            std::error_code ignored;
+            fs::remove(part, ignored);
+        }
+        if (!ok || ec) {
+            native_metrics_record(NATIVE_METRICS_FILE_IO, started_ns, len, 0);
+            return BLOB_STORE_ERROR_IO;
+        }
+        native_metrics_record(NATIVE_METRICS_FILE_IO, started_ns, len, 1);
+
+        if (!exists) {
+            const uint64_t seed = store->seed_hits();
+            store->insert_entry(hash, len, 0, seed);
+            store->append("P " + hash + " " + std::to_string(len) + " " + std::to_string(seed) + "\n", pin != 0);
+            it = store->entries.find(hash);
+        } else {
+            store->dedup_hits++;
+        }
+    } else {
+        store->dedup_hits++;
+        store->touch(hash, it->second);
+        store->append("T " + hash + "\n", false);
+    }
+
+    if (name && (store->names.count(name) == 0 || store->names[name] != hash)) {
+        store->add_name(hash, it->second, name);
+        store->append("N " + hash + " " + name + "\n", false);
+    }
+    if (pin) {
+        store->pin_locked(hash, it->second);
+        store->append("+ " + hash + "\n", true);
+    }
+
+    store->evict_to_budget();
+    store->maybe_compact();
+    return BLOB_STORE_OK;
+}
+
+}  // namespace
+
+extern "C" int blob_store_put(BlobStore *store, const uint8_t *data, size_t len, const char *name, int pin,
+                              char out_hash[BLOB_STORE_HASH_HEX_BYTES]) {
+    if (!store || (!data && len > 0) || !out_hash) return BLOB_STORE_ERROR_INVALID_INPUT;
+    if (name && !valid_name(name)) return BLOB_STORE_ERROR_INVALID_INPUT;
+
+    const uint64_t started_ns = native_metrics_now_ns();
+    const std::string hash = hash_hex(data, len);
+    memcpy(out_hash, hash.c_str(), BLOB_STORE_HASH_HEX_BYTES);
+
+    return put_entry(store, hash, len, name, pin, started_ns, [data, len](const fs::path &part) {
+        FILE *file = open_file(part, "wb");
+        bool ok = file && fwrite(data, 1, len, file) == len;
+        if (file) ok = (sync_file(file) == 0) && (fclose(file) == 0) && ok;
+        return ok;
+    });
+}
+
+extern "C" int blob_store_put_file(BlobStore *store, const char *path, const char *name, int pin,
+                                   char out_hash[BLOB_STORE_HASH_HEX_BYTES]) {
+    if (!store || !path || !*path || !out_hash) return BLOB_STORE_ERROR_INVALID_INPUT;
+    if (name && !valid_name(name)) return BLOB_STORE_ERROR_INVALID_INPUT;
+
+    const uint64_t started_ns = native_metrics_now_ns();
+    const fs::path source = fs::u8path(path);
+    FILE *file = open_file(source, "rb");
+    if (!file) return BLOB_STORE_ERROR_NOT_FOUND;
+
+    SHA512_CTX ctx;
+    sha512_init(&ctx);
+    std::vector<uint8_t> buffer(64 * 1024);
+    uint64_t len = 0;
+    size_t n;
+    while ((n = fread(buffer.data(), 1, buffer.size(), file)) > 0) {
+        sha512_update(&ctx, buffer.data(), n);
+        len += n;
+    }
+    const bool read_ok = !ferror(file);
+    fclose(file);
+    if (!read_ok) return BLOB_STORE_ERROR_IO;
+
+    uint8_t digest[SHA512_DIGEST_BYTES];
+    sha512_final(digest, &ctx);
+    const std::string hash = digest_hex(digest);
+    memcpy(out_hash, hash.c_str(), BLOB_STORE_HASH_HEX_BYTES);
+
+    const int status = put_entry(store, hash, len, name, pin, started_ns, [&source](const fs::path &part) {
+        std::error_code ec;
+        fs::rename(source, part, ec);
+        if (!ec) return true;
+        // Beda filesystem (mis. temp directory di volume lain): salin lalu fsync
+        if (!fs::copy_file(source, part, fs::copy_options::overwrite_existing, ec) || ec) return false;
+        FILE *copy = open_file(part, "rb+");
+        bool ok = copy && sync_file(copy) == 0;
+        if (copy) ok = (fclose(copy) == 0) && ok;
+        return ok;
+    });
+    if (status == BLOB_STORE_OK) {
+        std::error_code ignored;
+        fs::remove(source, ignored);
+    }
+    return status;
+}
+
+extern "C" int blob_store_lookup(BlobStore *store, const char *name, char out_hash[BLOB_STORE_HASH_HEX_BYTES]) {
+    if (!store || !valid_name(name) || !out_hash) return BLOB_STORE_ERROR_INVALID_INPUT;
+    std::lock_guard<std::mutex> lock(store->mutex);
+    auto it = store->names.find(name);
+    if (it == store->names.end()) return BLOB_STORE_ERROR_NOT_FOUND;
+    memcpy(out_hash, it->second.c_str(), BLOB_STORE_HASH_HEX_BYTES);
+    return BLOB_STORE_OK;
+}
+
+extern "C" int blob_store_get(BlobStore *store, const char *hash, BlobData *out) {
+    if (!store || !valid_hash(hash) || !out) return BLOB_STORE_ERROR_INVALID_INPUT;
+    out->data = nullptr;
+    out->len = 0;
+
+    const uint64_t started_ns = native_metrics_now_ns();
+    FILE *file = nullptr;
+    size_t size = 0;
+    {
+        std::lock_guard<std::mutex> lock(store->mutex);
+        auto it = store->entries.find(hash);
+        if (it == store->entries.end()) {
+            store->misses++;
+            return BLOB_STORE_ERROR_NOT_FOUND;
+        }
+        // Buka di bawah lock: eviction sesudahnya tidak memutus pembacaan (POSIX)
+        file = open_file(store->object_path(hash), "rb");
+        if (!file) {
+            store->misses++;
+            return BLOB_STORE_ERROR_NOT_FOUND;
+        }
+        size = static_cast<size_t>(it->second.size);
+        store->hits++;
+        store->touch(hash, it->second);
+        store->append("T " + std::string(hash) + "\n", false);
+        store->maybe_compact();
+    }
+
+    auto *data = static_cast<uint8_t *>(malloc(size ? size : 1));
+    const bool ok = data && fread(data, 1, size, file) == size;
+    fclose(file);
+    native_metrics_record(NATIVE_METRICS_FILE_IO, started_ns, size, ok ? 1 : 0);
+    if (!ok) {
+        free(data);
+        return BLOB_STORE_ERROR_IO;
+    }
+    out->data = data;
+    out->len = size;
+    return BLOB_STORE_OK;
+}
+
+extern "C" void blob_store_free(BlobData *data) {
+    if (!data) return;
+    free(data->data);
+    data->data = nullptr;
+    data->len = 0;
+}
+
+extern "C" int blob_store_pin(BlobStore *store, const char *hash) {
+    if (!store || !valid_hash(hash)) return BLOB_STORE_ERROR_INVALID_INPUT;
+    std::lock_guard<std::mutex> lock(store->mutex);
+    auto it = store->entries.find(hash);
+    if (it == store->entries.end()) return BLOB_STORE_ERROR_NOT_FOUND;
+    store->pin_locked(hash, it->second);
+    return store->append("+ " + std::string(hash) + "\n", true) ? BLOB_STORE_OK : BLOB_STORE_ERROR_IO;
+}
+
+extern "C" int blob_store_release(BlobStore *store, const char *hash) {
+    if (!store || !valid_hash(hash)) return BLOB_STORE_ERROR_INVALID_INPUT;
+    std::lock_guard<std::mutex> lock(store->mutex);
+    auto it = store->entries.find(hash);
+    if (it == store->entries.end()) return BLOB_STORE_ERROR_NOT_FOUND;
+    if (it->second.refs == 0) return BLOB_STORE_OK;
+    store->unpin_locked(hash, it->second);
+    const bool ok = store->append("- " + std::string(hash) + "\n", true);
+    store->evict_to_budget();
+    store->maybe_compact();
+    return ok ? BLOB_STORE_OK : BLOB_STORE_ERROR_IO;
+}
+
+extern "C" int blob_store_compact(BlobStore *store) {
+    if (!store) return BLOB_STORE_ERROR_INVALID_INPUT;
+    std::lock_guard<std::mutex> lock(store->mutex);
+    return store->compact_locked();
+}
+
+extern "C" void blob_store_get_stats(BlobStore *store, BlobStoreStats *out) {
+    if (!store || !out) return;
+    std::lock_guard<std::mutex> lock(store->mutex);
+    out->blob_count = store->entries.size();
+    out->total_bytes = store->total_bytes;
+    out->pinned_bytes = store->pinned_bytes;
+    out->byte_budget = store->budget;
+    out->hits = store->hits;
+    out->misses = store->misses;
+    out->dedup_hits = store->dedup_hits;
+    out->evictions = store->evictions;
+    out->evicted_bytes = store->evicted_bytes;
+    out->journal_records = store->journal_records;
+    out->recovered_orphans = store->recovered_orphans;
+}
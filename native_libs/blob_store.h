@@ -0,0 +1,93 @@
+#ifndef BLOB_STORE_H
+#define BLOB_STORE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Penyimpanan lokal attachment terenkripsi, dialamatkan oleh hash ciphertext.
+// Layout: <root>/objects/<2 hex pertama>/<hash>, <root>/journal.log, <root>/tmp/.
+// Ciphertext yang sama hanya disimpan sekali; nama (path storage Supabase) menjadi alias
+// ke hash. Blob tanpa pin dievict (LRU atau LFU) jika total melewati byte budget. Blob
+// yang di-pin (misalnya attachment yang gagal di-upload, satu-satunya salinan) tidak
+// pernah dievict sampai di-release.
+//
+// Journal hanya append (satu record per baris) dan dipadatkan menjadi snapshot lewat
+// file sementara + rename. Blob ditulis ke tmp/ lalu di-rename sebelum dicatat, jadi
+// crash di titik mana pun hanya meninggalkan file yatim yang diverifikasi ulang saat open.
+
+#define BLOB_STORE_OK 0
+#define BLOB_STORE_ERROR_INVALID_INPUT -1
+#define BLOB_STORE_ERROR_IO -2
+#define BLOB_STORE_ERROR_NOT_FOUND -3
+#define BLOB_STORE_ERROR_TOO_LARGE -4
+
+#define BLOB_STORE_HASH_HEX_BYTES 65    // 64 hex (256 bit pertama SHA-512) + NUL
+
+#define BLOB_STORE_EVICT_LRU 0
+#define BLOB_STORE_EVICT_LFU 1
+
+typedef struct BlobStore BlobStore;
+
+typedef struct {
+    const char *root;               // direktori store (UTF-8), dibuat jika belum ada
+    uint64_t byte_budget;           // 0 = 256 MiB
+    int32_t policy;                 // BLOB_STORE_EVICT_*
+} BlobStoreConfig;
+
+typedef struct {
+    uint8_t *data;
+    size_t len;
+} BlobData;
+
+typedef struct {
+    uint64_t blob_count;
+    uint64_t total_bytes;
+    uint64_t pinned_bytes;
+    uint64_t byte_budget;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t dedup_hits;            // put() untuk ciphertext yang sudah ada
+    uint64_t evictions;
+    uint64_t evicted_bytes;
+    uint64_t journal_records;
+    uint64_t recovered_orphans;     // blob tanpa record journal yang diadopsi saat open
+} BlobStoreStats;
+
+BlobStore *blob_store_open(const BlobStoreConfig *config, int *status);
+void blob_store_close(BlobStore *store);
+
+// Simpan ciphertext (dedup berdasarkan hash). name boleh NULL; pin != 0 menambah refcount.
+// hash_hex selalu diisi. TOO_LARGE jika blob tanpa pin lebih besar dari budget.
+int blob_store_put(BlobStore *store, const uint8_t *data, size_t len, const char *name, int pin,
+                   char hash_hex[BLOB_STORE_HASH_HEX_BYTES]);
+
+// Sama dengan put, tapi ciphertext sudah ada di file path (mis. hasil upload_pipeline
+// cipher_path). File di-hash bertahap tanpa dimuat ke memory lalu dipindahkan ke store
+// (rename, atau salin jika beda filesystem); setelah OK path tidak ada lagi.
+int blob_store_put_file(BlobStore *store, const char *path, const char *name, int pin,
+                        char hash_hex[BLOB_STORE_HASH_HEX_BYTES]);
+
+// Alias -> hash. NOT_FOUND jika nama belum pernah disimpan atau blob-nya sudah dievict.
+int blob_store_lookup(BlobStore *store, const char *name, char hash_hex[BLOB_STORE_HASH_HEX_BYTES]);
+
+// Baca blob (mencatat akses untuk LRU/LFU). out->data dibebaskan dengan blob_store_free.
+int blob_store_get(BlobStore *store, const char *hash_hex, BlobData *out);
+void blob_store_free(BlobData *data);
+
+int blob_store_pin(BlobStore *store, const char *hash_hex);
+int blob_store_release(BlobStore *store, const char *hash_hex);
+
+// Padatkan journal menjadi snapshot sekarang (dipanggil otomatis saat journal membengkak).
+int blob_store_compact(BlobStore *store);
+
+void blob_store_get_stats(BlobStore *store, BlobStoreStats *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
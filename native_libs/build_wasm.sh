@@ -0,0 +1,80 @@
+#!/usr/bin/env bash
+# Build native crypto library (SHA3, Argon2, ChaCha20-Poly1305, base64) ke WebAssembly
+# untuk web fallback. Butuh Emscripten (emcc) dan source Argon2 reference.
+#
+#   ARGON2_DIR=path/ke/phc-winner-argon2 ./build_wasm.sh           # SIMD128, single thread
+#   WASM_THREADS=1 ARGON2_DIR=... ./build_wasm.sh                   # + wasm threads (Argon2 lanes paralel)
+#   ARGON2_DIR=... ./build_wasm.sh --test                           # build lalu smoke test di Node
+set -euo pipefail
+
+SCRIPT_DIR="$(cd "$(dirname "$0")" && pwd)"
+ARGON2_DIR="${ARGON2_DIR:-$SCRIPT_DIR/third_party/argon2}"
+OUT_DIR="${OUT_DIR:-$SCRIPT_DIR/../web/native}"
+WASM_THREADS="${WASM_THREADS:-0}"
+
+if ! command -v emcc >/dev/null 2>&1; then
+    echo "❌ emcc tidak ditemukan - aktifkan emsdk terlebih dahulu"
+    exit 1
+fi
+
+if [ ! -f "$ARGON2_DIR/src/argon2.c" ]; then
+    echo "❌ Source Argon2 tidak ditemukan di $ARGON2_DIR"
+    echo "💡 git clone https://github.com/P-H-C/phc-winner-argon2 $ARGON2_DIR"
+    exit 1
+fi
+
+mkdir -p "$OUT_DIR"
+
+SOURCES=(
+    "$SCRIPT_DIR/native_crypto.cpp"
+    "$SCRIPT_DIR/chacha20_poly1305.cpp"
+    "$SCRIPT_DIR/base64.cpp"
+    "$SCRIPT_DIR/native_metrics.cpp"
+    "$ARGON2_DIR/src/argon2.c"
+    "$ARGON2_DIR/src/core.c"
+    "$ARGON2_DIR/src/encoding.c"
+    "$ARGON2_DIR/src/thread.c"
+    "$ARGON2_DIR/src/ref.c"
+    "$ARGON2_DIR/src/blake2/blake2b.c"
+)
+
+EXPORTS='[
+    "_malloc", "_free",
+    "_sha3_512_ctx_size", "_sha3_512_init", "_sha3_512_update", "_sha3_512_final",
+    "_argon2id_hash_raw", "_argon2id_hash_raw_wrapper",
+    "_chacha20_xor", "_chacha20_poly1305_encrypt", "_chacha20_poly1305_decrypt",
+    "_base64_encoded_length", "_base64_decoded_max_length", "_base64_encode", "_base64_decode"
+]'
+
+FLAGS=(
+    -O3
+    -msimd128
+    -I"$SCRIPT_DIR"
+    -I"$ARGON2_DIR/include"
+    -sMODULARIZE=1
+    -sEXPORT_ES6=1
+    -sEXPORT_NAME=createNativeCrypto
+    -sENVIRONMENT=web,worker,node
+    -sALLOW_MEMORY_GROWTH=1
+    -sMAXIMUM_MEMORY=1gb
+    -sEXPORTED_FUNCTIONS="$(echo "$EXPORTS" | tr -d ' \n')"
+    -sEXPORTED_RUNTIME_METHODS='["HEAPU8"]'
+)
+
+if [ "$WASM_THREADS" = "1" ]; then
+    # Argon2 memakai pthread untuk lanes; browser butuh COOP/COEP agar SharedArrayBuffer aktif
+    FLAGS+=(-pthread -sPTHREAD_POOL_SIZE=4)
+    echo "🧵 Building with wasm threads"
+else
+    FLAGS+=(-DARGON2_NO_THREADS)
+fi
+
+echo "Building native_crypto.wasm (SIMD128)..."
+emcc "${SOURCES[@]}" "${FLAGS[@]}" -o "$OUT_DIR/native_crypto.mjs"
+
+echo "✅ Build successful!"
+echo "📁 Module: $OUT_DIR/native_crypto.mjs + native_crypto.wasm"
+
+if [ "${1:-}" = "--test" ]; then
+    node "$SCRIPT_DIR/wasm_smoke.mjs" "$OUT_DIR/native_crypto.mjs"
+fi
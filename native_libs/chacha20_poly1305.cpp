@@ -0,0 +1,426 @@
+#include "chacha20_poly1305.h"
+#include "native_metrics.h"
+
+#include <cstring>
+
+// Jalur SIMD 4 blok paralel: WASM SIMD128 untuk build web, SSE2 untuk x86 desktop
+#if defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#define CHACHA_HAVE_VEC4 1
+typedef v128_t vec4;
+#define V_ADD(a, b) wasm_i32x4_add(a, b)
+#define V_XOR(a, b) wasm_v128_xor(a, b)
+#define V_ROTL(a, n) wasm_v128_or(wasm_i32x4_shl(a, n), wasm_u32x4_shr(a, 32 - (n)))
+#define V_SPLAT(x) wasm_i32x4_splat((int32_t)(x))
+#define V_SET(a, b, c, d) wasm_i32x4_make((int32_t)(a), (int32_t)(b), (int32_t)(c), (int32_t)(d))
+#define V_STORE(p, v) wasm_v128_store(p, v)
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define CHACHA_HAVE_VEC4 1
+typedef __m128i vec4;
+#define V_ADD(a, b) _mm_add_epi32(a, b)
+#define V_XOR(a, b) _mm_xor_si128(a, b)
+#define V_ROTL(a, n) _mm_or_si128(_mm_slli_epi32(a, n), _mm_srli_epi32(a, 32 - (n)))
+#define V_SPLAT(x) _mm_set1_epi32((int32_t)(x))
+#define V_SET(a, b, c, d) _mm_set_epi32((int32_t)(d), (int32_t)(c), (int32_t)(b), (int32_t)(a))
+#define V_STORE(p, v) _mm_storeu_si128((__m128i *)(p), v)
+#endif
+
+static inline uint32_t load32_le(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline void store32_le(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static inline uint32_t rotl32(uint32_t v, int n) {
+    return (v << n) | (v >> (32 - n));
+}
+
+#define QUARTER_ROUND(a, b, c, d) \
+    a += b; d ^= a; d = rotl32(d, 16); \
+    c += d; b ^= c; b = rotl32(b, 12); \
+    a += b; d ^= a; d = rotl32(d, 8);  \
+    c += d; b ^= c; b = rotl32(b, 7);
+
+static void chacha20_init_state(uint32_t state[16], const uint8_t key[32], const uint8_t nonce[12], uint32_t counter) {
+    state[0] = 0x61707865;
+    state[1] = 0x3320646e;
+    state[2] = 0x79622d32;
+    state[3] = 0x6b206574;
+    for (int i = 0; i < 8; i++) {
+        state[4 + i] = load32_le(key + 4 * i);
+    }
+    state[12] = counter;
+    state[13] = load32_le(nonce);
+    state[14] = load32_le(nonce + 4);
+    state[15] = load32_le(nonce + 8);
+}
+
+// double_rounds: 10 untuk ChaCha20, 6 untuk ChaCha12 (Adiantum)
+static void chacha_block(uint8_t out[64], const uint32_t state[16], int double_rounds) {
+    uint32_t x[16];
+    memcpy(x, state, sizeof(x));
+    for (int i = 0; i < double_rounds; i++) {
+        QUARTER_ROUND(x[0], x[4], x[8], x[12]);
+        QUARTER_ROUND(x[1], x[5], x[9], x[13]);
+        QUARTER_ROUND(x[2], x[6], x[10], x[14]);
+        QUARTER_ROUND(x[3], x[7], x[11], x[15]);
+        QUARTER_ROUND(x[0], x[5], x[10], x[15]);
+        QUARTER_ROUND(x[1], x[6], x[11], x[12]);
+        QUARTER_ROUND(x[2], x[7], x[8], x[13]);
+        QUARTER_ROUND(x[3], x[4], x[9], x[14]);
+    }
+    for (int i = 0; i < 16; i++) {
+        store32_le(out + 4 * i, x[i] + state[i]);
+    }
+}
+
+static void chacha20_block(uint8_t out[64], const uint32_t state[16]) {
+    chacha_block(out, state, 10);
+}
+
+#ifdef CHACHA_HAVE_VEC4
+#define V_QUARTER_ROUND(a, b, c, d) \
+    a = V_ADD(a, b); d = V_XOR(d, a); d = V_ROTL(d, 16); \
+    c = V_ADD(c, d); b = V_XOR(b, c); b = V_ROTL(b, 12); \
+    a = V_ADD(a, b); d = V_XOR(d, a); d = V_ROTL(d, 8);  \
+    c = V_ADD(c, d); b = V_XOR(b, c); b = V_ROTL(b, 7);
+
+// 4 blok keystream sekaligus, tiap lane vektor = satu blok (counter, counter+1, ...)
+static void chacha_block_x4(uint8_t out[256], const uint32_t state[16], int double_rounds) {
+    vec4 x[16];
+    vec4 orig[16];
+    for (int i = 0; i < 16; i++) {
+        orig[i] = V_SPLAT(state[i]);
+    }
+    orig[12] = V_SET(state[12], state[12] + 1, state[12] + 2, state[12] + 3);
+    memcpy(x, orig, sizeof(x));
+
+    for (int i = 0; i < double_rounds; i++) {
+        V_QUARTER_ROUND(x[0], x[4], x[8], x[12]);
+        V_QUARTER_ROUND(x[1], x[5], x[9], x[13]);
+        V_QUARTER_ROUND(x[2], x[6], x[10], x[14]);
+        V_QUARTER_ROUND(x[3], x[7], x[11], x[15]);
+        V_QUARTER_ROUND(x[0], x[5], x[10], x[15]);
+        V_QUARTER_ROUND(x[1], x[6], x[11], x[12]);
+        V_QUARTER_ROUND(x[2], x[7], x[8], x[13]);
+        V_QUARTER_ROUND(x[3], x[4], x[9], x[14]);
+    }
+
+    uint32_t words[16][4];
+    for (int i = 0; i < 16; i++) {
+        V_STORE(words[i], V_ADD(x[i], orig[i]));
+    }
+    for (int block = 0; block < 4; block++) {
+        for (int i = 0; i < 16; i++) {
+            store32_le(out + block * 64 + 4 * i, words[i][block]);
+        }
+    }
+}
+#endif
+
+static void chacha_xor_state(uint8_t *out, const uint8_t *in, size_t len, uint32_t state[16], int double_rounds) {
+#ifdef CHACHA_HAVE_VEC4
+    uint8_t stream4[256];
+    while (len >= 256) {
+        chacha_block_x4(stream4, state, double_rounds);
+        for (size_t i = 0; i < 256; i++) {
+            out[i] = in[i] ^ stream4[i];
+        }
+        state[12] += 4;
+        in += 256;
+        out += 256;
+        len -= 256;
+    }
+    memset(stream4, 0, sizeof(stream4));
+#endif
+
+    uint8_t stream[64];
+    while (len > 0) {
+        chacha_block(stream, state, double_rounds);
+        size_t n = len < 64 ? len : 64;
+        for (size_t i = 0; i < n; i++) {
+            out[i] = in[i] ^ stream[i];
+        }
+        state[12]++;
+        in += n;
+        out += n;
+        len -= n;
+    }
+    memset(stream, 0, sizeof(stream));
+    memset(state, 0, 16 * sizeof(uint32_t));
+}
+
+extern "C" void chacha20_xor(uint8_t *out, const uint8_t *in, size_t len,
+                             const uint8_t key[32], const uint8_t nonce[12], uint32_t counter) {
+    uint32_t state[16];
+    chacha20_init_state(state, key, nonce, counter);
+    chacha_xor_state(out, in, len, state, 10);
+}
+
+extern "C" void hchacha12(uint8_t out[CHACHA20_KEY_BYTES], const uint8_t key[CHACHA20_KEY_BYTES],
+                          const uint8_t nonce[16]) {
+    uint32_t x[16];
+    x[0] = 0x61707865;
+    x[1] = 0x3320646e;
+    x[2] = 0x79622d32;
+    x[3] = 0x6b206574;
+    for (int i = 0; i < 8; i++) {
+        x[4 + i] = load32_le(key + 4 * i);
+    }
+    for (int i = 0; i < 4; i++) {
+        x[12 + i] = load32_le(nonce + 4 * i);
+    }
+    for (int i = 0; i < 6; i++) {
+        QUARTER_ROUND(x[0], x[4], x[8], x[12]);
+        QUARTER_ROUND(x[1], x[5], x[9], x[13]);
+        QUARTER_ROUND(x[2], x[6], x[10], x[14]);
+        QUARTER_ROUND(x[3], x[7], x[11], x[15]);
+        QUARTER_ROUND(x[0], x[5], x[10], x[15]);
+        QUARTER_ROUND(x[1], x[6], x[11], x[12]);
+        QUARTER_ROUND(x[2], x[7], x[8], x[13]);
+        QUARTER_ROUND(x[3], x[4], x[9], x[14]);
+    }
+    // Tanpa feed-forward: subkey = baris pertama dan terakhir state
+    for (int i = 0; i < 4; i++) {
+        store32_le(out + 4 * i, x[i]);
+        store32_le(out + 16 + 4 * i, x[12 + i]);
+    }
+    memset(x, 0, sizeof(x));
+}
+
+extern "C" void xchacha12_xor(uint8_t *out, const uint8_t *in, size_t len,
+                              const uint8_t key[CHACHA20_KEY_BYTES],
+                              const uint8_t nonce[XCHACHA_NONCE_BYTES]) {
+    uint8_t subkey[CHACHA20_KEY_BYTES];
+    hchacha12(subkey, key, nonce);
+
+    uint32_t state[16];
+    state[0] = 0x61707865;
+    state[1] = 0x3320646e;
+    state[2] = 0x79622d32;
+    state[3] = 0x6b206574;
+    for (int i = 0; i < 8; i++) {
+        state[4 + i] = load32_le(subkey + 4 * i);
+    }
+    state[12] = 0;
+    state[13] = 0;
+    state[14] = load32_le(nonce + 16);
+    state[15] = load32_le(nonce + 20);
+    memset(subkey, 0, sizeof(subkey));
+    chacha_xor_state(out, in, len, state, 6);
+}
+
+// ===============================
+// POLY1305 (poly1305-donna 32-bit)
+// ===============================
+
+static void poly1305_blocks(POLY1305_CTX *ctx, const uint8_t *m, size_t bytes, uint32_t hibit) {
+    const uint32_t r0 = ctx->r[0], r1 = ctx->r[1], r2 = ctx->r[2], r3 = ctx->r[3], r4 = ctx->r[4];
+    const uint32_t s1 = r1 * 5, s2 = r2 * 5, s3 = r3 * 5, s4 = r4 * 5;
+    uint32_t h0 = ctx->h[0], h1 = ctx->h[1], h2 = ctx->h[2], h3 = ctx->h[3], h4 = ctx->h[4];
+
+    while (bytes >= 16) {
+        h0 += (load32_le(m + 0)) & 0x3ffffff;
+        h1 += (load32_le(m + 3) >> 2) & 0x3ffffff;
+        h2 += (load32_le(m + 6) >> 4) & 0x3ffffff;
+        h3 += (load32_le(m + 9) >> 6) & 0x3ffffff;
+        h4 += (load32_le(m + 12) >> 8) | hibit;
+
+        uint64_t d0 = (uint64_t)h0 * r0 + (uint64_t)h1 * s4 + (uint64_t)h2 * s3 + (uint64_t)h3 * s2 + (uint64_t)h4 * s1;
+        uint64_t d1 = (uint64_t)h0 * r1 + (uint64_t)h1 * r0 + (uint64_t)h2 * s4 + (uint64_t)h3 * s3 + (uint64_t)h4 * s2;
+        uint64_t d2 = (uint64_t)h0 * r2 + (uint64_t)h1 * r1 + (uint64_t)h2 * r0 + (uint64_t)h3 * s4 + (uint64_t)h4 * s3;
+        uint64_t d3 = (uint64_t)h0 * r3 + (uint64_t)h1 * r2 + (uint64_t)h2 * r1 + (uint64_t)h3 * r0 + (uint64_t)h4 * s4;
+        uint64_t d4 = (uint64_t)h0 * r4 + (uint64_t)h1 * r3 + (uint64_t)h2 * r2 + (uint64_t)h3 * r1 + (uint64_t)h4 * r0;
+
+        uint32_t c = (uint32_t)(d0 >> 26); h0 = (uint32_t)d0 & 0x3ffffff;
+        d1 += c; c = (uint32_t)(d1 >> 26); h1 = (uint32_t)d1 & 0x3ffffff;
+        d2 += c; c = (uint32_t)(d2 >> 26); h2 = (uint32_t)d2 & 0x3ffffff;
+        d3 += c; c = (uint32_t)(d3 >> 26); h3 = (uint32_t)d3 & 0x3ffffff;
+        d4 += c; c = (uint32_t)(d4 >> 26); h4 = (uint32_t)d4 & 0x3ffffff;
+        h0 += c * 5; c = h0 >> 26; h0 &= 0x3ffffff;
+        h1 += c;
+
+        m += 16;
+        bytes -= 16;
+    }
+
+    ctx->h[0] = h0; ctx->h[1] = h1; ctx->h[2] = h2; ctx->h[3] = h3; ctx->h[4] = h4;
+}
+
+extern "C" void poly1305_init(POLY1305_CTX *ctx, const uint8_t key[32]) {
+    ctx->r[0] = (load32_le(key + 0)) & 0x3ffffff;
+    ctx->r[1] = (load32_le(key + 3) >> 2) & 0x3ffff03;
+    ctx->r[2] = (load32_le(key + 6) >> 4) & 0x3ffc0ff;
+    ctx->r[3] = (load32_le(key + 9) >> 6) & 0x3f03fff;
+    ctx->r[4] = (load32_le(key + 12) >> 8) & 0x00fffff;
+    memset(ctx->h, 0, sizeof(ctx->h));
+    for (int i = 0; i < 4; i++) {
+        ctx->pad[i] = load32_le(key + 16 + 4 * i);
+    }
+    ctx->leftover = 0;
+}
+
+extern "C" void poly1305_update(POLY1305_CTX *ctx, const uint8_t *data, size_t len) {
+    if (ctx->leftover) {
+        size_t want = 16 - ctx->leftover;
+        if (want > len) want = len;
+        memcpy(ctx->buffer + ctx->leftover, data, want);
+        len -= want;
+        data += want;
+        ctx->leftover += want;
+        if (ctx->leftover < 16) return;
+        poly1305_blocks(ctx, ctx->buffer, 16, 1u << 24);
+        ctx->leftover = 0;
+    }
+    if (len >= 16) {
+        size_t want = len & ~(size_t)15;
+        poly1305_blocks(ctx, data, want, 1u << 24);
+        data += want;
+        len -= want;
+    }
+    if (len) {
+        memcpy(ctx->buffer, data, len);
+        ctx->leftover = len;
+    }
+}
+
+extern "C" void poly1305_final(POLY1305_CTX *ctx, uint8_t tag[16]) {
+    if (ctx->leftover) {
+        size_t i = ctx->leftover;
+        ctx->buffer[i++] = 1;
+        for (; i < 16; i++) ctx->buffer[i] = 0;
+        poly1305_blocks(ctx, ctx->buffer, 16, 0);
+    }
+
+    uint32_t h0 = ctx->h[0], h1 = ctx->h[1], h2 = ctx->h[2], h3 = ctx->h[3], h4 = ctx->h[4];
+    uint32_t c;
+    c = h1 >> 26; h1 &= 0x3ffffff;
+    h2 += c; c = h2 >> 26; h2 &= 0x3ffffff;
+    h3 += c; c = h3 >> 26; h3 &= 0x3ffffff;
+    h4 += c; c = h4 >> 26; h4 &= 0x3ffffff;
+    h0 += c * 5; c = h0 >> 26; h0 &= 0x3ffffff;
+    h1 += c;
+
+    // Hitung h + -p, pilih hasil secara constant-time
+    uint32_t g0 = h0 + 5; c = g0 >> 26; g0 &= 0x3ffffff;
+    uint32_t g1 = h1 + c; c = g1 >> 26; g1 &= 0x3ffffff;
+    uint32_t g2 = h2 + c; c = g2 >> 26; g2 &= 0x3ffffff;
+    uint32_t g3 = h3 + c; c = g3 >> 26; g3 &= 0x3ffffff;
+    uint32_t g4 = h4 + c - (1u << 26);
+
+    uint32_t mask = (g4 >> 31) - 1;
+    g0 &= mask; g1 &= mask; g2 &= mask; g3 &= mask; g4 &= mask;
+    mask = ~mask;
+    h0 = (h0 & mask) | g0;
+    h1 = (h1 & mask) | g1;
+    h2 = (h2 & mask) | g2;
+    h3 = (h3 & mask) | g3;
+    h4 = (h4 & mask) | g4;
+
+    h0 = (h0 | (h1 << 26));
+    h1 = ((h1 >> 6) | (h2 << 20));
+    h2 = ((h2 >> 12) | (h3 << 14));
+    h3 = ((h3 >> 18) | (h4 << 8));
+
+    uint64_t f;
+    f = (uint64_t)h0 + ctx->pad[0]; h0 = (uint32_t)f;
+    f = (uint64_t)h1 + ctx->pad[1] + (f >> 32); h1 = (uint32_t)f;
+    f = (uint64_t)h2 + ctx->pad[2] + (f >> 32); h2 = (uint32_t)f;
+    f = (uint64_t)h3 + ctx->pad[3] + (f >> 32); h3 = (uint32_t)f;
+
+    store32_le(tag + 0, h0);
+    store32_le(tag + 4, h1);
+    store32_le(tag + 8, h2);
+    store32_le(tag + 12, h3);
+
+    memset(ctx, 0, sizeof(*ctx));
+}
+
+// ===============================
+// CHACHA20-POLY1305 AEAD (RFC 8439)
+// ===============================
+
+static const uint8_t kZeroPad[16] = {0};
+
+extern "C" void chacha20_poly1305_tag(uint8_t tag[16], const uint8_t otk[32],
+                                      const uint8_t *aad, size_t aad_len,
+                                      const uint8_t *ciphertext, size_t ciphertext_len) {
+    POLY1305_CTX poly;
+    poly1305_init(&poly, otk);
+    poly1305_update(&poly, aad, aad_len);
+    if (aad_len % 16) poly1305_update(&poly, kZeroPad, 16 - aad_len % 16);
+    poly1305_update(&poly, ciphertext, ciphertext_len);
+    if (ciphertext_len % 16) poly1305_update(&poly, kZeroPad, 16 - ciphertext_len % 16);
+
+    uint8_t lengths[16];
+    for (int i = 0; i < 8; i++) {
+        lengths[i] = (uint8_t)((uint64_t)aad_len >> (8 * i));
+        lengths[8 + i] = (uint8_t)((uint64_t)ciphertext_len >> (8 * i));
+    }
+    poly1305_update(&poly, lengths, sizeof(lengths));
+    poly1305_final(&poly, tag);
+}
+
+static void aead_one_time_key(uint8_t otk[32], const uint8_t key[32], const uint8_t nonce[12]) {
+    uint32_t state[16];
+    uint8_t block[64];
+    chacha20_init_state(state, key, nonce, 0);
+    chacha20_block(block, state);
+    memcpy(otk, block, 32);
+    memset(block, 0, sizeof(block));
+    memset(state, 0, sizeof(state));
+}
+
+extern "C" int chacha20_poly1305_encrypt(uint8_t *ciphertext, uint8_t tag[16],
+                                         const uint8_t *plaintext, size_t plaintext_len,
+                                         const uint8_t *aad, size_t aad_len,
+                                         const uint8_t key[32], const uint8_t nonce[12]) {
+    if (!key || !nonce || !tag || (plaintext_len && (!plaintext || !ciphertext)) || (aad_len && !aad)) {
+        return AEAD_ERROR_INVALID_INPUT;
+    }
+
+    const uint64_t started_ns = native_metrics_now_ns();
+    uint8_t otk[32];
+    aead_one_time_key(otk, key, nonce);
+    chacha20_xor(ciphertext, plaintext, plaintext_len, key, nonce, 1);
+    chacha20_poly1305_tag(tag, otk, aad, aad_len, ciphertext, plaintext_len);
+    memset(otk, 0, sizeof(otk));
+    native_metrics_record(NATIVE_METRICS_CIPHER, started_ns, plaintext_len, 1);
+    return AEAD_OK;
+}
+
+extern "C" int chacha20_poly1305_decrypt(uint8_t *plaintext,
+                                         const uint8_t *ciphertext, size_t ciphertext_len,
+                                         const uint8_t tag[16],
+                                         const uint8_t *aad, size_t aad_len,
+                                         const uint8_t key[32], const uint8_t nonce[12]) {
+    if (!key || !nonce || !tag || (ciphertext_len && (!plaintext || !ciphertext)) || (aad_len && !aad)) {
+        return AEAD_ERROR_INVALID_INPUT;
+    }
+
+    const uint64_t started_ns = native_metrics_now_ns();
+    uint8_t otk[32];
+    uint8_t expected[16];
+    aead_one_time_key(otk, key, nonce);
+    chacha20_poly1305_tag(expected, otk, aad, aad_len, ciphertext, ciphertext_len);
+    memset(otk, 0, sizeof(otk));
+
+    uint8_t diff = 0;
+    for (int i = 0; i < 16; i++) {
+        diff |= expected[i] ^ tag[i];
+    }
+    if (diff != 0) {
+        native_metrics_record(NATIVE_METRICS_CIPHER, started_ns, ciphertext_len, 0);
+        return AEAD_ERROR_AUTH_FAILED;
+    }
+
+    chacha20_xor(plaintext, ciphertext, ciphertext_len, key, nonce, 1);
+    native_metrics_record(NATIVE_METRICS_CIPHER, started_ns, ciphertext_len, 1);
+    return AEAD_OK;
+}
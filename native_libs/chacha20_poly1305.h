@@ -0,0 +1,71 @@
+#ifndef CHACHA20_POLY1305_H
+#define CHACHA20_POLY1305_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CHACHA20_KEY_BYTES 32
+#define CHACHA20_NONCE_BYTES 12
+#define CHACHA20_BLOCK_BYTES 64
+#define XCHACHA_NONCE_BYTES 24
+#define POLY1305_KEY_BYTES 32
+#define POLY1305_TAG_BYTES 16
+
+// Status code untuk AEAD
+#define AEAD_OK 0
+#define AEAD_ERROR_INVALID_INPUT -1
+#define AEAD_ERROR_AUTH_FAILED -2
+
+// State Poly1305 incremental (26-bit limbs, portable tanpa __int128)
+typedef struct {
+    uint32_t r[5];
+    uint32_t h[5];
+    uint32_t pad[4];
+    uint8_t buffer[16];
+    size_t leftover;
+} POLY1305_CTX;
+
+void poly1305_init(POLY1305_CTX *ctx, const uint8_t key[POLY1305_KEY_BYTES]);
+void poly1305_update(POLY1305_CTX *ctx, const uint8_t *data, size_t len);
+void poly1305_final(POLY1305_CTX *ctx, uint8_t tag[POLY1305_TAG_BYTES]);
+
+// ChaCha20 (RFC 8439): XOR keystream ke input, counter awal bisa diatur
+void chacha20_xor(uint8_t *out, const uint8_t *in, size_t len,
+                  const uint8_t key[CHACHA20_KEY_BYTES],
+                  const uint8_t nonce[CHACHA20_NONCE_BYTES],
+                  uint32_t counter);
+
+// HChaCha12 dan XChaCha12 (nonce 24 byte, counter mulai 0) untuk Adiantum
+void hchacha12(uint8_t out[CHACHA20_KEY_BYTES], const uint8_t key[CHACHA20_KEY_BYTES], const uint8_t nonce[16]);
+void xchacha12_xor(uint8_t *out, const uint8_t *in, size_t len,
+                   const uint8_t key[CHACHA20_KEY_BYTES],
+                   const uint8_t nonce[XCHACHA_NONCE_BYTES]);
+
+// Tag AEAD RFC 8439 dari one-time key (blok keystream counter 0) yang sudah dihitung
+void chacha20_poly1305_tag(uint8_t tag[POLY1305_TAG_BYTES], const uint8_t otk[POLY1305_KEY_BYTES],
+                           const uint8_t *aad, size_t aad_len,
+                           const uint8_t *ciphertext, size_t ciphertext_len);
+
+// ChaCha20-Poly1305 AEAD, ciphertext sama panjang dengan plaintext + tag 16 byte terpisah
+int chacha20_poly1305_encrypt(uint8_t *ciphertext, uint8_t tag[POLY1305_TAG_BYTES],
+                              const uint8_t *plaintext, size_t plaintext_len,
+                              const uint8_t *aad, size_t aad_len,
+                              const uint8_t key[CHACHA20_KEY_BYTES],
+                              const uint8_t nonce[CHACHA20_NONCE_BYTES]);
+
+int chacha20_poly1305_decrypt(uint8_t *plaintext,
+                              const uint8_t *ciphertext, size_t ciphertext_len,
+                              const uint8_t tag[POLY1305_TAG_BYTES],
+                              const uint8_t *aad, size_t aad_len,
+                              const uint8_t key[CHACHA20_KEY_BYTES],
+                              const uint8_t nonce[CHACHA20_NONCE_BYTES]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
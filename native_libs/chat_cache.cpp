@@ -0,0 +1,424 @@
+#include "chat_cache.h"
+#include "adiantum.h"
+#include "legacy_formats.h"
+#include "native_metrics.h"
+#include "sha512.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr uint64_t kDefaultBudget = 8ull * 1024 * 1024;
+
+void secure_wipe(void *p, size_t len) {
+    volatile uint8_t *v = static_cast<volatile uint8_t *>(p);
+    for (size_t i = 0; i < len; i++) {
+        v[i] = 0;
+    }
+}
+
+void secure_wipe(std::vector<uint8_t> &buffer) {
+    secure_wipe(buffer.data(), buffer.size());
+    buffer.clear();
+    buffer.shrink_to_fit();
+}
+
+void append_u32(std::vector<uint8_t> &out, uint32_t v) {
+    for (int i = 0; i < 4; i++) {
+        out.push_back(static_cast<uint8_t>(v >> (8 * i)));
+    }
+}
+
+uint32_t load_u32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+void store_u32(uint8_t *p, uint32_t v) {
+    for (int i = 0; i < 4; i++) {
+        p[i] = static_cast<uint8_t>(v >> (8 * i));
+    }
+}
+
+// Path dari Dart berupa UTF-8; Windows butuh API wide-char (sama dengan blob_store)
+FILE *open_file(const fs::path &path, const char *mode) {
+#if defined(_WIN32)
+    wchar_t wide_mode[8] = {0};
+    for (size_t i = 0; i < 7 && mode[i]; i++) wide_mode[i] = static_cast<wchar_t>(mode[i]);
+    return _wfopen(path.c_str(), wide_mode);
+#else
+    return fopen(path.c_str(), mode);
+#endif
+}
+
+int sync_file(FILE *file) {
+    if (fflush(file) != 0) return -1;
+#if defined(_WIN32)
+    return _commit(_fileno(file));
+#else
+    return fsync(fileno(file));
+#endif
+}
+
+// Key Adiantum dan file_id untuk file halaman chat_id (lihat chat_cache.h)
+AdiantumKey *file_cipher(const char *chat_id, const uint8_t *key, size_t keylen,
+                         uint8_t file_id[ADIANTUM_FILE_ID_BYTES]) {
+    static const char kLabel[] = "chat_cache_file";
+    const size_t id_len = strlen(chat_id);
+    uint8_t digest[SHA512_DIGEST_BYTES];
+
+    HMAC_SHA512_CTX hmac;
+    hmac_sha512_init(&hmac, key, keylen);
+    hmac_sha512_update(&hmac, reinterpret_cast<const uint8_t *>(kLabel), sizeof(kLabel) - 1);
+    hmac_sha512_update(&hmac, reinterpret_cast<const uint8_t *>(chat_id), id_len);
+    hmac_sha512_final(digest, &hmac);
+    AdiantumKey *cipher = adiantum_create(digest);
+
+    SHA512_CTX sha;
+    sha512_init(&sha);
+    sha512_update(&sha, reinterpret_cast<const uint8_t *>(chat_id), id_len);
+    sha512_final(digest, &sha);
+    memcpy(file_id, digest, ADIANTUM_FILE_ID_BYTES);
+
+    secure_wipe(digest, sizeof(digest));
+    secure_wipe(&hmac, sizeof(hmac));
+    return cipher;
+}
+
+// Tepat count record yang memenuhi len byte pertama; sisanya (padding) harus nol
+bool valid_page(const uint8_t *data, size_t padded_len, size_t len, uint32_t count) {
+    size_t offset = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        if (len - offset < CHAT_CACHE_RECORD_HEADER_BYTES) return false;
+        const uint64_t meta_len = load_u32(data + offset);
+        const uint32_t text_len = load_u32(data + offset + 4);
+        offset += CHAT_CACHE_RECORD_HEADER_BYTES;
+        const uint64_t body = meta_len + (text_len == CHAT_CACHE_DECRYPT_FAILED ? 0 : text_len);
+        if (body > len - offset) return false;
+        offset += body;
+    }
+    if (offset != len) return false;
+    for (size_t i = len; i < padded_len; i++) {
+        if (data[i] != 0) return false;
+    }
+    return true;
+}
+
+struct CachedPage {
+    std::vector<uint8_t> data;
+    uint32_t count = 0;
+    std::list<std::string>::iterator lru;
+};
+
+}  // namespace
+
+struct ChatCache {
+    std::mutex mutex;
+    uint64_t byte_budget = kDefaultBudget;
+    uint64_t total_bytes = 0;
+    std::unordered_map<std::string, CachedPage> pages;
+    std::list<std::string> lru;    // depan = paling baru dipakai
+
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    uint64_t evicted_bytes = 0;
+    uint64_t messages_decrypted = 0;
+    uint64_t decrypt_failures = 0;
+
+    // Dipanggil dengan mutex dipegang
+    void erase(std::unordered_map<std::string, CachedPage>::iterator it) {
+        total_bytes -= it->second.data.size();
+        secure_wipe(it->second.data);
+        lru.erase(it->second.lru);
+        pages.erase(it);
+    }
+
+    void evict_to(uint64_t budget) {
+        while (total_bytes > budget && !lru.empty()) {
+            auto it = pages.find(lru.back());
+            evictions++;
+            evicted_bytes += it->second.data.size();
+            erase(it);
+        }
+    }
+
+    // Dipanggil dengan mutex dipegang; page diambil alih (swap)
+    void insert(const char *chat_id, std::vector<uint8_t> &page, uint32_t count) {
+        auto existing = pages.find(chat_id);
+        if (existing != pages.end()) erase(existing);
+
+        // Evict sebelum memasukkan halaman baru supaya halaman ini tidak ikut terbuang
+        evict_to(byte_budget - page.size());
+        lru.emplace_front(chat_id);
+        CachedPage &entry = pages[chat_id];
+        entry.count = count;
+        entry.lru = lru.begin();
+        total_bytes += page.size();
+        entry.data.swap(page);
+    }
+};
+
+extern "C" ChatCache *chat_cache_create(uint64_t byte_budget) {
+    auto *cache = new ChatCache();
+    if (byte_budget) cache->byte_budget = byte_budget;
+    return cache;
+}
+
+extern "C" void chat_cache_destroy(ChatCache *cache) {
+    if (!cache) return;
+    chat_cache_clear(cache);
+    delete cache;
+}
+
+extern "C" int chat_cache_put_xor_page(ChatCache *cache, const char *chat_id,
+                                       const ChatCacheMessage *messages, uint32_t count,
+                                       const uint8_t *key, size_t keylen) {
+    if (!cache || !chat_id || (!messages && count) || !key || keylen == 0) {
+        return CHAT_CACHE_ERROR_INVALID_INPUT;
+    }
+
+    const uint64_t started_ns = native_metrics_now_ns();
+    size_t page_bytes = 0;
+    size_t cipher_bytes = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        const ChatCacheMessage &m = messages[i];
+        if ((!m.meta && m.meta_len) || (!m.ciphertext && m.ciphertext_len) || (!m.iv && m.iv_len)) {
+            return CHAT_CACHE_ERROR_INVALID_INPUT;
+        }
+        page_bytes += CHAT_CACHE_RECORD_HEADER_BYTES + m.meta_len + m.ciphertext_len;
+        cipher_bytes += m.ciphertext_len;
+    }
+    if (page_bytes > cache->byte_budget) return CHAT_CACHE_ERROR_TOO_LARGE;
+
+    // Decrypt satu batch ke buffer sementara (key diulang sekali untuk semua pesan)
+    std::vector<uint8_t> plain(cipher_bytes);
+    std::vector<LegacyXorMessage> batch(count);
+    size_t offset = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        batch[i].in = messages[i].ciphertext;
+        batch[i].out = plain.data() + offset;
+        batch[i].len = messages[i].ciphertext_len;
+        batch[i].iv = messages[i].iv;
+        batch[i].iv_len = messages[i].iv_len;
+        batch[i].status = LEGACY_OK;
+        offset += messages[i].ciphertext_len;
+    }
+    const size_t decrypted = count ? legacy_xor_with_iv_decrypt_batch(batch.data(), count, key, keylen) : 0;
+
+    std::vector<uint8_t> page;
+    page.reserve(page_bytes);
+    for (uint32_t i = 0; i < count; i++) {
+        const bool ok = batch[i].status == LEGACY_OK;
+        append_u32(page, messages[i].meta_len);
+        append_u32(page, ok ? static_cast<uint32_t>(batch[i].len) : CHAT_CACHE_DECRYPT_FAILED);
+        page.insert(page.end(), messages[i].meta, messages[i].meta + messages[i].meta_len);
+        if (ok) page.insert(page.end(), batch[i].out, batch[i].out + batch[i].len);
+    }
+    secure_wipe(plain);
+    native_metrics_record(NATIVE_METRICS_CACHE, started_ns, cipher_bytes, 1);
+
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    cache->messages_decrypted += decrypted;
+    cache->decrypt_failures += count - decrypted;
+    cache->insert(chat_id, page, count);
+    return static_cast<int>(decrypted);
+}
+
+extern "C" int chat_cache_get(ChatCache *cache, const char *chat_id, ChatCachePage *out) {
+    if (!cache || !chat_id || !out) return CHAT_CACHE_ERROR_INVALID_INPUT;
+    out->data = nullptr;
+    out->len = 0;
+    out->count = 0;
+
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    auto it = cache->pages.find(chat_id);
+    if (it == cache->pages.end()) {
+        cache->misses++;
+        return CHAT_CACHE_ERROR_NOT_FOUND;
+    }
+    cache->hits++;
+    cache->lru.splice(cache->lru.begin(), cache->lru, it->second.lru);
+
+    const std::vector<uint8_t> &data = it->second.data;
+    out->data = static_cast<uint8_t *>(malloc(data.empty() ? 1 : data.size()));
+    if (!out->data) return CHAT_CACHE_ERROR_INVALID_INPUT;
+    if (!data.empty()) memcpy(out->data, data.data(), data.size());
+    out->len = data.size();
+    out->count = it->second.count;
+    return CHAT_CACHE_OK;
+}
+
+extern "C" void chat_cache_free(ChatCachePage *page) {
+    if (!page || !page->data) return;
+    secure_wipe(page->data, page->len);
+    free(page->data);
+    page->data = nullptr;
+    page->len = 0;
+    page->count = 0;
+}
+
+extern "C" int chat_cache_remove(ChatCache *cache, const char *chat_id) {
+    if (!cache || !chat_id) return CHAT_CACHE_ERROR_INVALID_INPUT;
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    auto it = cache->pages.find(chat_id);
+    if (it == cache->pages.end()) return CHAT_CACHE_ERROR_NOT_FOUND;
+    cache->erase(it);
+    return CHAT_CACHE_OK;
+}
+
+extern "C" void chat_cache_clear(ChatCache *cache) {
+    if (!cache) return;
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    while (!cache->pages.empty()) {
+        cache->erase(cache->pages.begin());
+    }
+}
+
+extern "C" void chat_cache_get_stats(ChatCache *cache, ChatCacheStats *out) {
+    if (!cache || !out) return;
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    out->entries = cache->pages.size();
+    out->total_bytes = cache->total_bytes;
+    out->byte_budget = cache->byte_budget;
+    out->hits = cache->hits;
+    out->misses = cache->misses;
+    out->evictions = cache->evictions;
+    out->evicted_bytes = cache->evicted_bytes;
+    out->messages_decrypted = cache->messages_decrypted;
+    out->decrypt_failures = cache->decrypt_failures;
+}
+
+extern "C" int chat_cache_save_file(ChatCache *cache, const char *chat_id, const char *path,
+                                    const uint8_t *key, size_t keylen) {
+    if (!cache || !chat_id || !path || !*path || !key || keylen == 0) {
+        return CHAT_CACHE_ERROR_INVALID_INPUT;
+    }
+
+    // Salin halaman lalu lepas lock; enkripsi dan IO tidak menahan put/get lain
+    std::vector<uint8_t> body;
+    uint32_t count = 0;
+    size_t page_len = 0;
+    {
+        std::lock_guard<std::mutex> lock(cache->mutex);
+        auto it = cache->pages.find(chat_id);
+        if (it == cache->pages.end()) return CHAT_CACHE_ERROR_NOT_FOUND;
+        page_len = it->second.data.size();
+        count = it->second.count;
+        body.assign(page_len < ADIANTUM_MIN_BYTES ? ADIANTUM_MIN_BYTES : page_len, 0);
+        if (page_len) memcpy(body.data(), it->second.data.data(), page_len);
+    }
+
+    uint8_t file_id[ADIANTUM_FILE_ID_BYTES];
+    AdiantumKey *cipher = file_cipher(chat_id, key, keylen, file_id);
+    const int status = cipher ? adiantum_encrypt_pages(cipher, body.data(), body.size(), file_id, 0)
+                              : ADIANTUM_ERROR_INVALID_INPUT;
+    adiantum_destroy(cipher);
+    if (status != ADIANTUM_OK) {
+        secure_wipe(body);
+        return CHAT_CACHE_ERROR_INVALID_INPUT;
+    }
+
+    uint8_t header[CHAT_CACHE_FILE_HEADER_BYTES];
+    store_u32(header, CHAT_CACHE_FILE_MAGIC);
+    store_u32(header + 4, count);
+    store_u32(header + 8, static_cast<uint32_t>(page_len));
+    store_u32(header + 12, static_cast<uint32_t>(static_cast<uint64_t>(page_len) >> 32));
+
+    const uint64_t started_ns = native_metrics_now_ns();
+    const fs::path target = fs::u8path(path);
+    fs::path part = target;
+    part += ".tmp";
+    FILE *file = open_file(part, "wb");
+    bool ok = file && fwrite(header, 1, sizeof(header), file) == sizeof(header) &&
+              fwrite(body.data(), 1, body.size(), file) == body.size();
+    if (file) ok = (sync_file(file) == 0) && (fclose(file) == 0) && ok;
+
+    std::error_code ec;
+    if (ok) fs::rename(part, target, ec);
+    if (!ok || ec) {
+        std::error_code ignored;
+        fs::remove(part, ignored);
+    }
+    native_metrics_record(NATIVE_METRICS_FILE_IO, started_ns, sizeof(header) + body.size(), ok && !ec);
+    return ok && !ec ? CHAT_CACHE_OK : CHAT_CACHE_ERROR_IO;
+}
+
+extern "C" int chat_cache_load_file(ChatCache *cache, const char *chat_id, const char *path,
+                                    const uint8_t *key, size_t keylen) {
+    if (!cache || !chat_id || !path || !*path || !key || keylen == 0) {
+        return CHAT_CACHE_ERROR_INVALID_INPUT;
+    }
+    {
+        std::lock_guard<std::mutex> lock(cache->mutex);
+        auto it = cache->pages.find(chat_id);
+        if (it != cache->pages.end()) return static_cast<int>(it->second.count);
+    }
+
+    const uint64_t started_ns = native_metrics_now_ns();
+    FILE *file = open_file(fs::u8path(path), "rb");
+    if (!file) return CHAT_CACHE_ERROR_NOT_FOUND;
+
+    uint8_t header[CHAT_CACHE_FILE_HEADER_BYTES];
+    std::vector<uint8_t> body;
+    int status = CHAT_CACHE_OK;
+    uint32_t count = 0;
+    uint64_t page_len = 0;
+    if (fread(header, 1, sizeof(header), file) != sizeof(header) || load_u32(header) != CHAT_CACHE_FILE_MAGIC) {
+        status = CHAT_CACHE_ERROR_CORRUPT;
+    } else {
+        count = load_u32(header + 4);
+        page_len = load_u32(header + 8) | (static_cast<uint64_t>(load_u32(header + 12)) << 32);
+        if (page_len > cache->byte_budget) {
+            status = CHAT_CACHE_ERROR_TOO_LARGE;
+        } else {
+            // Ukuran body harus persis; sisa byte setelahnya berarti file rusak
+            body.resize(page_len < ADIANTUM_MIN_BYTES ? ADIANTUM_MIN_BYTES : page_len);
+            uint8_t extra;
+            if (fread(body.data(), 1, body.size(), file) != body.size() || fread(&extra, 1, 1, file) != 0) {
+                status = CHAT_CACHE_ERROR_CORRUPT;
+            }
+        }
+    }
+    if (ferror(file)) status = CHAT_CACHE_ERROR_IO;
+    fclose(file);
+    native_metrics_record(NATIVE_METRICS_FILE_IO, started_ns, sizeof(header) + body.size(),
+                          status == CHAT_CACHE_OK);
+    if (status != CHAT_CACHE_OK) return status;
+
+    uint8_t file_id[ADIANTUM_FILE_ID_BYTES];
+    AdiantumKey *cipher = file_cipher(chat_id, key, keylen, file_id);
+    const int crypt = cipher ? adiantum_decrypt_pages(cipher, body.data(), body.size(), file_id, 0)
+                             : ADIANTUM_ERROR_INVALID_INPUT;
+    adiantum_destroy(cipher);
+    if (crypt != ADIANTUM_OK || !valid_page(body.data(), body.size(), page_len, count)) {
+        secure_wipe(body);
+        return CHAT_CACHE_ERROR_CORRUPT;
+    }
+    body.resize(page_len);
+
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    // put dari warm sync bisa masuk selama file dibaca; halaman itu lebih baru
+    auto it = cache->pages.find(chat_id);
+    if (it != cache->pages.end()) {
+        secure_wipe(body);
+        return static_cast<int>(it->second.count);
+    }
+    cache->insert(chat_id, body, count);
+    return static_cast<int>(count);
+}
@@ -0,0 +1,104 @@
+#ifndef CHAT_CACHE_H
+#define CHAT_CACHE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Cache in-memory halaman pesan terbaru per chat yang sudah didecrypt, diisi sync
+// latar belakang setelah login sehingga ChatScreen bisa langsung tampil saat dibuka.
+// Satu halaman per chat (put mengganti halaman lama); halaman paling lama tidak
+// diakses dievict jika total melewati byte budget. Plaintext dihapus (wipe) saat
+// dievict, diganti, atau dihapus. Ke disk hanya lewat chat_cache_save_file, terenkripsi.
+//
+// Layout halaman (little-endian, tanpa padding), satu record per pesan:
+//   uint32 meta_len, uint32 text_len (CHAT_CACHE_DECRYPT_FAILED jika gagal), meta, text
+// meta adalah byte opaque dari pemanggil (id, sender, waktu), disimpan apa adanya.
+
+#define CHAT_CACHE_OK 0
+#define CHAT_CACHE_ERROR_INVALID_INPUT -1
+#define CHAT_CACHE_ERROR_NOT_FOUND -3
+#define CHAT_CACHE_ERROR_TOO_LARGE -4
+#define CHAT_CACHE_ERROR_IO -5
+#define CHAT_CACHE_ERROR_CORRUPT -6
+
+#define CHAT_CACHE_DECRYPT_FAILED 0xFFFFFFFFu
+#define CHAT_CACHE_RECORD_HEADER_BYTES 8
+#define CHAT_CACHE_FILE_MAGIC 0x31464343u   // "CCF1"
+#define CHAT_CACHE_FILE_HEADER_BYTES 16
+
+typedef struct ChatCache ChatCache;
+
+typedef struct {
+    const uint8_t *meta;
+    uint32_t meta_len;
+    const uint8_t *ciphertext;
+    uint32_t ciphertext_len;
+    const uint8_t *iv;
+    uint32_t iv_len;
+} ChatCacheMessage;
+
+typedef struct {
+    uint8_t *data;
+    size_t len;
+    uint32_t count;
+} ChatCachePage;
+
+typedef struct {
+    uint64_t entries;
+    uint64_t total_bytes;
+    uint64_t byte_budget;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    uint64_t evicted_bytes;
+    uint64_t messages_decrypted;
+    uint64_t decrypt_failures;
+} ChatCacheStats;
+
+// byte_budget = batas total plaintext + meta yang disimpan (0 = 8 MiB)
+ChatCache *chat_cache_create(uint64_t byte_budget);
+void chat_cache_destroy(ChatCache *cache);
+
+// Decrypt pesan xor_with_iv (legacy_formats) dalam satu batch dengan chat key yang sama,
+// lalu simpan sebagai halaman chat_id. Return jumlah pesan yang berhasil didecrypt,
+// atau TOO_LARGE jika satu halaman melebihi budget.
+int chat_cache_put_xor_page(ChatCache *cache, const char *chat_id,
+                            const ChatCacheMessage *messages, uint32_t count,
+                            const uint8_t *key, size_t keylen);
+
+// Salin halaman (dan tandai baru dipakai). out->data dibebaskan dengan chat_cache_free.
+int chat_cache_get(ChatCache *cache, const char *chat_id, ChatCachePage *out);
+// Wipe lalu bebaskan salinan dari chat_cache_get
+void chat_cache_free(ChatCachePage *page);
+
+int chat_cache_remove(ChatCache *cache, const char *chat_id);
+// Hapus semua halaman (mis. logout)
+void chat_cache_clear(ChatCache *cache);
+
+void chat_cache_get_stats(ChatCache *cache, ChatCacheStats *out);
+
+// File cache halaman (little-endian) supaya halaman tetap ada setelah aplikasi ditutup:
+//   uint32 magic, uint32 count, uint64 page_len, lalu halaman (di-pad nol s/d 16 byte)
+//   yang dienkripsi Adiantum per 4 KiB (adiantum.h).
+// Key file = HMAC-SHA512(chat key, "chat_cache_file" || chat_id)[0..32], file_id tweak =
+// SHA-512(chat_id)[0..16], jadi file hanya terbaca dengan chat key dan chat_id yang sama.
+// Adiantum tidak mengautentikasi: file rusak atau key salah dikenali dari layout record
+// yang tidak valid (CORRUPT), bukan dari tag. Ditulis ke path.tmp lalu di-rename.
+
+// Simpan halaman chat_id yang ada di cache ke path
+int chat_cache_save_file(ChatCache *cache, const char *chat_id, const char *path,
+                         const uint8_t *key, size_t keylen);
+// Muat file dari chat_cache_save_file sebagai halaman chat_id dan return jumlah pesannya.
+// Halaman chat_id yang sudah ada di memori (lebih baru) tidak ditimpa.
+int chat_cache_load_file(ChatCache *cache, const char *chat_id, const char *path,
+                         const uint8_t *key, size_t keylen);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
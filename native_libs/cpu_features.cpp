@@ -0,0 +1,128 @@
+#include "cpu_features.h"
+
+#include <atomic>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define CPU_FEATURES_X86 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64) || defined(__arm__)
+#define CPU_FEATURES_ARM 1
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__) || defined(__ANDROID__)
+#include <sys/auxv.h>
+#endif
+#endif
+
+namespace {
+
+// Bit tertinggi menandai hasil deteksi sudah di-cache
+constexpr uint32_t kDetected = 1u << 31;
+
+std::atomic<uint32_t> g_detected{0};
+std::atomic<uint32_t> g_mask{0xFFFFFFFFu};
+
+#if defined(CPU_FEATURES_X86)
+void cpuid(uint32_t leaf, uint32_t subleaf, uint32_t regs[4]) {
+#if defined(_MSC_VER)
+    int out[4];
+    __cpuidex(out, (int)leaf, (int)subleaf);
+    for (int i = 0; i < 4; i++) regs[i] = (uint32_t)out[i];
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+uint64_t xgetbv0() {
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    uint32_t eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return ((uint64_t)edx << 32) | eax;
+#endif
+}
+
+uint32_t detect() {
+    uint32_t features = 0;
+    uint32_t regs[4];
+    cpuid(0, 0, regs);
+    const uint32_t max_leaf = regs[0];
+    if (max_leaf < 1) return features;
+
+    cpuid(1, 0, regs);
+    if (regs[3] & (1u << 26)) features |= CPU_FEATURE_SSE2;
+    if (regs[2] & (1u << 9)) features |= CPU_FEATURE_SSSE3;
+    if (regs[2] & (1u << 25)) features |= CPU_FEATURE_AES;
+    if (regs[2] & (1u << 1)) features |= CPU_FEATURE_PMULL;
+
+    // AVX2 hanya boleh dipakai jika OS menyimpan state YMM (OSXSAVE + XCR0)
+    const bool osxsave = (regs[2] & (1u << 27)) != 0;
+    if (osxsave && max_leaf >= 7 && (xgetbv0() & 0x6) == 0x6) {
+        cpuid(7, 0, regs);
+        if (regs[1] & (1u << 5)) features |= CPU_FEATURE_AVX2;
+    }
+#if defined(__x86_64__) || defined(_M_X64)
+    features |= CPU_FEATURE_64BIT;
+#endif
+    return features;
+}
+#elif defined(CPU_FEATURES_ARM)
+uint32_t detect() {
+    uint32_t features = 0;
+#if defined(__aarch64__) || defined(_M_ARM64)
+    features |= CPU_FEATURE_NEON | CPU_FEATURE_64BIT;
+#if defined(__APPLE__)
+    // Semua Apple Silicon / A7+ punya Crypto Extensions
+    features |= CPU_FEATURE_AES | CPU_FEATURE_PMULL;
+#elif defined(_WIN32)
+    if (IsProcessorFeaturePresent(PF_ARM_V8_CRYPTO_INSTRUCTIONS_AVAILABLE)) {
+        features |= CPU_FEATURE_AES | CPU_FEATURE_PMULL;
+    }
+#elif defined(__linux__) || defined(__ANDROID__)
+    // HWCAP_AES = bit 3, HWCAP_PMULL = bit 4 (arm64)
+    const unsigned long hwcap = getauxval(AT_HWCAP);
+    if (hwcap & (1ul << 3)) features |= CPU_FEATURE_AES;
+    if (hwcap & (1ul << 4)) features |= CPU_FEATURE_PMULL;
+#endif
+#elif defined(__linux__) || defined(__ANDROID__)
+    // ARMv7 (userland 32-bit di banyak Android low-end): HWCAP_NEON = bit 12,
+    // HWCAP2_AES = bit 0, HWCAP2_PMULL = bit 1
+    const unsigned long hwcap = getauxval(AT_HWCAP);
+    const unsigned long hwcap2 = getauxval(AT_HWCAP2);
+    if (hwcap & (1ul << 12)) features |= CPU_FEATURE_NEON;
+    if (hwcap2 & (1ul << 0)) features |= CPU_FEATURE_AES;
+    if (hwcap2 & (1ul << 1)) features |= CPU_FEATURE_PMULL;
+#endif
+    return features;
+}
+#else
+uint32_t detect() {
+    uint32_t features = 0;
+#if defined(__wasm_simd128__)
+    features |= CPU_FEATURE_SIMD128;
+#endif
+    if (sizeof(void *) == 8) features |= CPU_FEATURE_64BIT;
+    return features;
+}
+#endif
+
+}  // namespace
+
+extern "C" uint32_t cpu_features_get(void) {
+    uint32_t detected = g_detected.load(std::memory_order_acquire);
+    if (!(detected & kDetected)) {
+        // Deteksi idempotent: race antar thread hanya menghitung ulang nilai yang sama
+        detected = detect() | kDetected;
+        g_detected.store(detected, std::memory_order_release);
+    }
+    return detected & ~kDetected & g_mask.load(std::memory_order_relaxed);
+}
+
+extern "C" void cpu_features_set_mask(uint32_t mask) {
+    g_mask.store(mask, std::memory_order_relaxed);
+}
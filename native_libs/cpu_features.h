@@ -0,0 +1,33 @@
+#ifndef CPU_FEATURES_H
+#define CPU_FEATURES_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Deteksi fitur CPU saat runtime (sekali per proses) untuk memilih jalur crypto per
+// device: AES/PMULL hardware, SIMD yang dipakai ChaCha20, dll.
+
+#define CPU_FEATURE_SSE2 (1u << 0)
+#define CPU_FEATURE_SSSE3 (1u << 1)
+#define CPU_FEATURE_AVX2 (1u << 2)
+#define CPU_FEATURE_NEON (1u << 3)
+#define CPU_FEATURE_SIMD128 (1u << 4)   // WebAssembly SIMD128
+#define CPU_FEATURE_AES (1u << 5)       // AES-NI atau ARMv8 Crypto Extensions AES
+#define CPU_FEATURE_PMULL (1u << 6)     // PCLMULQDQ atau ARMv8 PMULL (GHASH)
+#define CPU_FEATURE_64BIT (1u << 7)
+
+// Bitmask CPU_FEATURE_* yang tersedia (setelah mask dari cpu_features_set_mask)
+uint32_t cpu_features_get(void);
+
+// Batasi fitur yang dilaporkan (mis. 0 untuk memaksa jalur portable di test/benchmark).
+// 0xFFFFFFFF mengembalikan deteksi penuh.
+void cpu_features_set_mask(uint32_t mask);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
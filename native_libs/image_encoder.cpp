@@ -0,0 +1,1096 @@
+#include "image_encoder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <queue>
+#include <vector>
+
+#ifdef HAVE_LIBWEBP
+#include <webp/encode.h>
+#endif
+
+// Prediksi dan biaya residual predictor 16 byte (4 pixel ARGB) per langkah
+#if defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#define IMAGE_SIMD 1
+typedef v128_t vec8;
+#define B_LOAD(p) wasm_v128_load(p)
+#define B_STORE(p, v) wasm_v128_store(p, v)
+#define B_SUB(a, b) wasm_i8x16_sub(a, b)
+#define B_AVG(a, b) wasm_i8x16_sub(wasm_u8x16_avgr(a, b), wasm_v128_and(wasm_v128_xor(a, b), wasm_i8x16_splat(1)))
+#define B_ABS(v) wasm_i8x16_abs(v)
+#define B_SPLAT32(x) wasm_i32x4_splat((int32_t)(x))
+static inline uint32_t b_sum(v128_t v) {
+    const v128_t s = wasm_u32x4_extadd_pairwise_u16x8(wasm_u16x8_extadd_pairwise_u8x16(v));
+    return wasm_u32x4_extract_lane(s, 0) + wasm_u32x4_extract_lane(s, 1) +
+           wasm_u32x4_extract_lane(s, 2) + wasm_u32x4_extract_lane(s, 3);
+}
+#define B_SUM(v) b_sum(v)
+// G di byte 1 setiap pixel, disalin ke byte 0 (B) dan 2 (R)
+#define B_GREEN_SPREAD(v) wasm_v128_or(wasm_u32x4_shr(wasm_v128_and(v, wasm_i32x4_splat(0xFF00)), 8), \
+                                       wasm_i32x4_shl(wasm_v128_and(v, wasm_i32x4_splat(0xFF00)), 8))
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define IMAGE_SIMD 1
+typedef __m128i vec8;
+#define B_LOAD(p) _mm_loadu_si128((const __m128i *)(p))
+#define B_STORE(p, v) _mm_storeu_si128((__m128i *)(p), v)
+#define B_SUB(a, b) _mm_sub_epi8(a, b)
+#define B_AVG(a, b) _mm_sub_epi8(_mm_avg_epu8(a, b), _mm_and_si128(_mm_xor_si128(a, b), _mm_set1_epi8(1)))
+#define B_ABS(v) _mm_min_epu8(v, _mm_sub_epi8(_mm_setzero_si128(), v))
+#define B_SPLAT32(x) _mm_set1_epi32((int)(x))
+static inline uint32_t b_sum(__m128i v) {
+    const __m128i sad = _mm_sad_epu8(v, _mm_setzero_si128());
+    return static_cast<uint32_t>(_mm_cvtsi128_si32(sad) + _mm_extract_epi16(sad, 4));
+}
+#define B_SUM(v) b_sum(v)
+#define B_GREEN_SPREAD(v) _mm_or_si128(_mm_srli_epi32(_mm_and_si128(v, _mm_set1_epi32(0xFF00)), 8), \
+                                       _mm_slli_epi32(_mm_and_si128(v, _mm_set1_epi32(0xFF00)), 8))
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define IMAGE_SIMD 1
+typedef uint8x16_t vec8;
+#define B_LOAD(p) vld1q_u8((const uint8_t *)(p))
+#define B_STORE(p, v) vst1q_u8((uint8_t *)(p), v)
+#define B_SUB(a, b) vsubq_u8(a, b)
+#define B_AVG(a, b) vhaddq_u8(a, b)
+#define B_ABS(v) vreinterpretq_u8_s8(vabsq_s8(vreinterpretq_s8_u8(v)))
+#define B_SPLAT32(x) vreinterpretq_u8_u32(vdupq_n_u32((uint32_t)(x)))
+#define B_SUM(v) ((uint32_t)vaddlvq_u8(v))
+#define B_GREEN_SPREAD(v) vreinterpretq_u8_u32(vorrq_u32( \
+    vshrq_n_u32(vandq_u32(vreinterpretq_u32_u8(v), vdupq_n_u32(0xFF00)), 8), \
+    vshlq_n_u32(vandq_u32(vreinterpretq_u32_u8(v), vdupq_n_u32(0xFF00)), 8)))
+#endif
+
+namespace {
+
+// ===============================
+// Konstanta VP8L
+// ===============================
+
+constexpr int kNumLiteralCodes = 256;
+constexpr int kNumLengthCodes = 24;
+constexpr int kNumDistanceCodes = 40;
+constexpr int kCodeLengthCodes = 19;
+constexpr int kMaxCodeLength = 15;
+constexpr int kMaxCodeLengthCodeLength = 7;
+constexpr int kMaxCopyLength = 4096;
+constexpr uint32_t kMaxCopyDistance = (1u << 20) - 120;
+constexpr int kPredictorBits = 4;
+constexpr int kNumPredictorModes = 14;
+constexpr uint32_t kArgbBlack = 0xFF000000u;
+
+const uint8_t kCodeLengthCodeOrder[kCodeLengthCodes] = {
+    17, 18, 0, 1, 2, 3, 4, 5, 16, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+
+// Tabel distance 2D dari spesifikasi: (dx, dy), jarak = dx + dy * lebar
+const int8_t kCodeToPlane[120][2] = {
+    {0, 1}, {1, 0}, {1, 1}, {-1, 1}, {0, 2}, {2, 0}, {1, 2}, {-1, 2},
+    {2, 1}, {-2, 1}, {2, 2}, {-2, 2}, {0, 3}, {3, 0}, {1, 3}, {-1, 3},
+    {3, 1}, {-3, 1}, {2, 3}, {-2, 3}, {3, 2}, {-3, 2}, {0, 4}, {4, 0},
+    {1, 4}, {-1, 4}, {4, 1}, {-4, 1}, {3, 3}, {-3, 3}, {2, 4}, {-2, 4},
+    {4, 2}, {-4, 2}, {0, 5}, {3, 4}, {-3, 4}, {4, 3}, {-4, 3}, {5, 0},
+    {1, 5}, {-1, 5}, {5, 1}, {-5, 1}, {2, 5}, {-2, 5}, {5, 2}, {-5, 2},
+    {4, 4}, {-4, 4}, {3, 5}, {-3, 5}, {5, 3}, {-5, 3}, {0, 6}, {6, 0},
+    {1, 6}, {-1, 6}, {6, 1}, {-6, 1}, {2, 6}, {-2, 6}, {6, 2}, {-6, 2},
+    {4, 5}, {-4, 5}, {5, 4}, {-5, 4}, {3, 6}, {-3, 6}, {6, 3}, {-6, 3},
+    {0, 7}, {7, 0}, {1, 7}, {-1, 7}, {5, 5}, {-5, 5}, {7, 1}, {-7, 1},
+    {4, 6}, {-4, 6}, {6, 4}, {-6, 4}, {2, 7}, {-2, 7}, {7, 2}, {-7, 2},
+    {3, 7}, {-3, 7}, {7, 3}, {-7, 3}, {5, 6}, {-5, 6}, {6, 5}, {-6, 5},
+    {8, 0}, {4, 7}, {-4, 7}, {7, 4}, {-7, 4}, {8, 1}, {8, 2}, {6, 6},
+    {-6, 6}, {8, 3}, {5, 7}, {-5, 7}, {7, 5}, {-7, 5}, {8, 4}, {6, 7},
+    {-6, 7}, {7, 6}, {-7, 6}, {8, 5}, {7, 7}, {-7, 7}, {8, 6}, {8, 7}};
+
+struct PlaneLut {
+    uint8_t code[8 * 16];
+
+    PlaneLut() {
+        memset(code, 0xFF, sizeof(code));
+        for (int i = 0; i < 120; i++) {
+            code[kCodeToPlane[i][1] * 16 + 8 - kCodeToPlane[i][0]] = static_cast<uint8_t>(i);
+        }
+    }
+};
+
+const PlaneLut &plane_lut() {
+    static const PlaneLut lut;
+    return lut;
+}
+
+uint32_t distance_to_plane_code(uint32_t xsize, uint32_t dist) {
+    const uint32_t yoffset = dist / xsize;
+    const uint32_t xoffset = dist - yoffset * xsize;
+    const PlaneLut &lut = plane_lut();
+    if (xoffset <= 8 && yoffset < 8) {
+        return lut.code[yoffset * 16 + 8 - xoffset] + 1u;
+    }
+    if (xoffset + 8 > xsize && yoffset < 7) {
+        return lut.code[(yoffset + 1) * 16 + 8 + (xsize - xoffset)] + 1u;
+    }
+    return dist + 120;
+}
+
+// Prefix coding untuk panjang copy dan kode jarak (nilai >= 1)
+void prefix_encode(uint32_t value, int *symbol, int *extra_bits, uint32_t *extra_value) {
+    const uint32_t v = value - 1;
+    if (v < 4) {
+        *symbol = static_cast<int>(v);
+        *extra_bits = 0;
+        *extra_value = 0;
+        return;
+    }
+    int highest = 31;
+    while (!(v >> highest)) highest--;
+    const int second = (v >> (highest - 1)) & 1;
+    *extra_bits = highest - 1;
+    *extra_value = v & ((1u << *extra_bits) - 1);
+    *symbol = 2 * highest + second;
+}
+
+// ===============================
+// Bit writer (LSB first)
+// ===============================
+
+class BitWriter {
+public:
+    std::vector<uint8_t> bytes;
+
+    void put(uint32_t bits, int count) {
+        if (count == 0) return;
+        acc_ |= static_cast<uint64_t>(bits & ((count == 32) ? 0xFFFFFFFFu : ((1u << count) - 1))) << used_;
+        used_ += count;
+        while (used_ >= 8) {
+            bytes.push_back(static_cast<uint8_t>(acc_));
+            acc_ >>= 8;
+            used_ -= 8;
+        }
+    }
+
+    void finish() {
+        if (used_ > 0) {
+            bytes.push_back(static_cast<uint8_t>(acc_));
+        }
+        acc_ = 0;
+        used_ = 0;
+    }
+
+private:
+    uint64_t acc_ = 0;
+    int used_ = 0;
+};
+
+// ===============================
+// Prefix code (Huffman)
+// ===============================
+
+// Panjang kode Huffman dibatasi max_length: jika pohon terlalu dalam, count kecil dinaikkan
+// (seperti libwebp) lalu dibangun ulang.
+void build_code_lengths(const std::vector<uint32_t> &counts, int max_length, std::vector<uint8_t> &lengths) {
+    const int n = static_cast<int>(counts.size());
+    lengths.assign(n, 0);
+
+    int used = 0;
+    int last = 0;
+    for (int i = 0; i < n; i++) {
+        if (counts[i]) {
+            used++;
+            last = i;
+        }
+    }
+    if (used == 0) return;
+    if (used == 1) {
+        lengths[last] = 1;
+        return;
+    }
+
+    for (uint32_t floor = 1;; floor *= 2) {
+        struct Node {
+            uint64_t weight;
+            int left;
+            int right;
+        };
+        std::vector<Node> nodes;
+        nodes.reserve(2 * used);
+        typedef std::pair<uint64_t, int> Entry;
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+        std::vector<int> leaf_symbol;
+        for (int i = 0; i < n; i++) {
+            if (!counts[i]) continue;
+            leaf_symbol.push_back(i);
+            nodes.push_back({std::max<uint64_t>(counts[i], floor), -1, -1});
+            heap.push({nodes.back().weight, static_cast<int>(nodes.size() - 1)});
+        }
+        while (heap.size() > 1) {
+            const Entry a = heap.top();
+            heap.pop();
+            const Entry b = heap.top();
+            heap.pop();
+            nodes.push_back({a.first + b.first, a.second, b.second});
+            heap.push({a.first + b.first, static_cast<int>(nodes.size() - 1)});
+        }
+
+        // Kedalaman tiap leaf; node parent selalu di index lebih besar dari anaknya
+        std::vector<int> depth(nodes.size(), 0);
+        int max_depth = 0;
+        for (int i = static_cast<int>(nodes.size()) - 1; i >= 0; i--) {
+            if (nodes[i].left >= 0) {
+                depth[nodes[i].left] = depth[i] + 1;
+                depth[nodes[i].right] = depth[i] + 1;
+            } else {
+                max_depth = std::max(max_depth, depth[i]);
+            }
+        }
+        if (max_depth <= max_length) {
+            for (size_t i = 0; i < leaf_symbol.size(); i++) {
+                lengths[leaf_symbol[i]] = static_cast<uint8_t>(depth[i]);
+            }
+            return;
+        }
+    }
+}
+
+struct PrefixCode {
+    std::vector<uint8_t> lengths;
+    std::vector<uint16_t> codes;
+    int used_symbols = 0;
+
+    // Kode kanonik, bit dibalik karena writer LSB first
+    void build(const std::vector<uint32_t> &counts, int max_length) {
+        build_code_lengths(counts, max_length, lengths);
+        codes.assign(lengths.size(), 0);
+        used_symbols = 0;
+
+        int length_count[kMaxCodeLength + 1] = {0};
+        for (uint8_t length : lengths) {
+            if (length) {
+                length_count[length]++;
+                used_symbols++;
+            }
+        }
+        int next_code[kMaxCodeLength + 2] = {0};
+        int code = 0;
+        for (int bits = 1; bits <= kMaxCodeLength; bits++) {
+            code = (code + length_count[bits - 1]) << 1;
+            next_code[bits] = code;
+        }
+        for (size_t symbol = 0; symbol < lengths.size(); symbol++) {
+            const int length = lengths[symbol];
+            if (!length) continue;
+            int value = next_code[length]++;
+            int reversed = 0;
+            for (int i = 0; i < length; i++) {
+                reversed = (reversed << 1) | (value & 1);
+                value >>= 1;
+            }
+            codes[symbol] = static_cast<uint16_t>(reversed);
+        }
+    }
+
+    // Kode dengan satu simbol dibaca decoder tanpa bit sama sekali
+    void write(BitWriter &bw, int symbol) const {
+        if (used_symbols > 1) {
+            bw.put(codes[symbol], lengths[symbol]);
+        }
+    }
+};
+
+void store_code_lengths(BitWriter &bw, const std::vector<uint8_t> &lengths) {
+    // RLE: 16 = ulang panjang sebelumnya 3..6x, 17 = nol 3..10x, 18 = nol 11..138x
+    struct Token {
+        uint8_t symbol;
+        uint8_t extra;
+    };
+    std::vector<Token> tokens;
+    const size_t n = lengths.size();
+    for (size_t i = 0; i < n;) {
+        const uint8_t value = lengths[i];
+        size_t run = 1;
+        while (i + run < n && lengths[i + run] == value) run++;
+        i += run;
+
+        if (value == 0) {
+            while (run >= 11) {
+                const size_t count = std::min<size_t>(run, 138);
+                tokens.push_back({18, static_cast<uint8_t>(count - 11)});
+                run -= count;
+            }
+            if (run >= 3) {
+                tokens.push_back({17, static_cast<uint8_t>(run - 3)});
+                run = 0;
+            }
+            while (run--) tokens.push_back({0, 0});
+        } else {
+            tokens.push_back({value, 0});
+            run--;
+            while (run >= 3) {
+                const size_t count = std::min<size_t>(run, 6);
+                tokens.push_back({16, static_cast<uint8_t>(count - 3)});
+                run -= count;
+            }
+            while (run--) tokens.push_back({value, 0});
+        }
+    }
+
+    std::vector<uint32_t> histogram(kCodeLengthCodes, 0);
+    for (const Token &token : tokens) histogram[token.symbol]++;
+    PrefixCode code_length_code;
+    code_length_code.build(histogram, kMaxCodeLengthCodeLength);
+
+    int codes_to_store = kCodeLengthCodes;
+    while (codes_to_store > 4 && code_length_code.lengths[kCodeLengthCodeOrder[codes_to_store - 1]] == 0) {
+        codes_to_store--;
+    }
+    bw.put(0, 1);  // normal code
+    bw.put(codes_to_store - 4, 4);
+    for (int i = 0; i < codes_to_store; i++) {
+        bw.put(code_length_code.lengths[kCodeLengthCodeOrder[i]], 3);
+    }
+    bw.put(0, 1);  // max_symbol = ukuran alphabet penuh
+
+    for (const Token &token : tokens) {
+        code_length_code.write(bw, token.symbol);
+        if (token.symbol == 16) bw.put(token.extra, 2);
+        else if (token.symbol == 17) bw.put(token.extra, 3);
+        else if (token.symbol == 18) bw.put(token.extra, 7);
+    }
+}
+
+void store_prefix_code(BitWriter &bw, const PrefixCode &code) {
+    int symbols[2] = {0, 0};
+    int count = 0;
+    for (size_t i = 0; i < code.lengths.size(); i++) {
+        if (!code.lengths[i]) continue;
+        if (count < 2) symbols[count] = static_cast<int>(i);
+        count++;
+    }
+
+    if (count == 0) {
+        // Kode kosong: simple code satu simbol 0
+        bw.put(1, 1);
+        bw.put(0, 1);
+        bw.put(0, 1);
+        bw.put(0, 1);
+        return;
+    }
+    if (count <= 2 && symbols[0] < 256 && symbols[count - 1] < 256) {
+        bw.put(1, 1);
+        bw.put(count - 1, 1);
+        if (symbols[0] <= 1) {
+            bw.put(0, 1);
+            bw.put(symbols[0], 1);
+        } else {
+            bw.put(1, 1);
+            bw.put(symbols[0], 8);
+        }
+        if (count == 2) bw.put(symbols[1], 8);
+        return;
+    }
+    store_code_lengths(bw, code.lengths);
+}
+
+// ===============================
+// LZ77 + color cache
+// ===============================
+
+enum TokenKind : uint8_t { kLiteral, kCacheIndex, kCopy };
+
+struct PixelToken {
+    TokenKind kind;
+    uint32_t value;     // literal ARGB, index cache, atau panjang copy
+    uint32_t distance;  // kode jarak (plane code) untuk copy
+};
+
+inline uint32_t cache_key(uint32_t argb, int cache_bits) {
+    return (0x1E35A7BDu * argb) >> (32 - cache_bits);
+}
+
+inline uint32_t hash_pair(const uint32_t *p) {
+    return ((p[0] * 0x9E3779B1u) ^ (p[1] * 0x85EBCA77u)) >> 14;  // 18 bit
+}
+
+uint32_t match_length(const uint32_t *a, const uint32_t *b, uint32_t max_length) {
+    uint32_t length = 0;
+    while (length < max_length && a[length] == b[length]) length++;
+    return length;
+}
+
+// Greedy LZ77 dengan hash chain. Kandidat jarak 1 (kiri) dan xsize (atas) dicoba lebih dulu
+// karena kode jaraknya paling murah.
+void build_backward_refs(const uint32_t *argb, uint32_t xsize, uint32_t ysize, int max_chain,
+                         std::vector<PixelToken> &tokens) {
+    const uint32_t n = xsize * ysize;
+    tokens.clear();
+    tokens.reserve(n / 2 + 16);
+
+    constexpr uint32_t kHashSize = 1u << 18;
+    std::vector<int32_t> head(kHashSize, -1);
+    std::vector<int32_t> chain(n, -1);
+    auto insert = [&](uint32_t pos) {
+        if (pos + 1 >= n) return;
+        const uint32_t h = hash_pair(argb + pos);
+        chain[pos] = head[h];
+        head[h] = static_cast<int32_t>(pos);
+    };
+
+    for (uint32_t i = 0; i < n;) {
+        const uint32_t max_length = std::min<uint32_t>(kMaxCopyLength, n - i);
+        uint32_t best_length = 0;
+        uint32_t best_distance = 0;
+
+        if (max_length >= 2) {
+            if (i >= 1) {
+                const uint32_t length = match_length(argb + i, argb + i - 1, max_length);
+                if (length > best_length) {
+                    best_length = length;
+                    best_distance = 1;
+                }
+            }
+            if (i >= xsize && xsize > 1) {
+                const uint32_t length = match_length(argb + i, argb + i - xsize, max_length);
+                if (length > best_length) {
+                    best_length = length;
+                    best_distance = xsize;
+                }
+            }
+            int32_t candidate = head[hash_pair(argb + i)];
+            for (int step = 0; candidate >= 0 && step < max_chain && best_length < max_length; step++) {
+                const uint32_t distance = i - static_cast<uint32_t>(candidate);
+                if (distance > kMaxCopyDistance) break;
+                if (argb[candidate + best_length] == argb[i + best_length]) {
+                    const uint32_t length = match_length(argb + i, argb + candidate, max_length);
+                    if (length > best_length) {
+                        best_length = length;
+                        best_distance = distance;
+                    }
+                }
+                candidate = chain[candidate];
+            }
+        }
+
+        if (best_length >= 3) {
+            tokens.push_back({kCopy, best_length, distance_to_plane_code(xsize, best_distance)});
+            for (uint32_t k = 0; k < best_length; k++) insert(i + k);
+            i += best_length;
+        } else {
+            tokens.push_back({kLiteral, argb[i], 0});
+            insert(i);
+            i++;
+        }
+    }
+}
+
+// Ganti literal yang ada di color cache dengan index cache. Cache diisi setiap pixel yang
+// didecode (termasuk hasil copy), sama seperti decoder.
+void apply_color_cache(const uint32_t *argb, const std::vector<PixelToken> &refs, int cache_bits,
+                       std::vector<PixelToken> &tokens) {
+    tokens = refs;
+    if (cache_bits == 0) return;
+    std::vector<uint32_t> cache(1u << cache_bits, 0);
+    uint32_t pos = 0;
+    for (PixelToken &token : tokens) {
+        if (token.kind == kCopy) {
+            for (uint32_t k = 0; k < token.value; k++, pos++) {
+                cache[cache_key(argb[pos], cache_bits)] = argb[pos];
+            }
+            continue;
+        }
+        const uint32_t key = cache_key(argb[pos], cache_bits);
+        if (cache[key] == argb[pos]) {
+            token.kind = kCacheIndex;
+            token.value = key;
+        } else {
+            cache[key] = argb[pos];
+        }
+        pos++;
+    }
+}
+
+struct Histograms {
+    std::vector<uint32_t> green, red, blue, alpha, distance;
+
+    explicit Histograms(int cache_bits)
+        : green(kNumLiteralCodes + kNumLengthCodes + (cache_bits ? (1u << cache_bits) : 0), 0),
+          red(256, 0), blue(256, 0), alpha(256, 0), distance(kNumDistanceCodes, 0) {}
+
+    void add(const std::vector<PixelToken> &tokens) {
+        for (const PixelToken &token : tokens) {
+            int symbol;
+            int extra_bits;
+            uint32_t extra_value;
+            switch (token.kind) {
+            case kLiteral:
+                green[(token.value >> 8) & 0xFF]++;
+                red[(token.value >> 16) & 0xFF]++;
+                blue[token.value & 0xFF]++;
+                alpha[token.value >> 24]++;
+                break;
+            case kCacheIndex:
+                green[kNumLiteralCodes + kNumLengthCodes + token.value]++;
+                break;
+            case kCopy:
+                prefix_encode(token.value, &symbol, &extra_bits, &extra_value);
+                green[kNumLiteralCodes + symbol]++;
+                prefix_encode(token.distance, &symbol, &extra_bits, &extra_value);
+                distance[symbol]++;
+                break;
+            }
+        }
+    }
+};
+
+double entropy_bits(const std::vector<uint32_t> &counts) {
+    uint64_t total = 0;
+    double sum = 0.0;
+    for (uint32_t c : counts) {
+        if (!c) continue;
+        total += c;
+        sum += c * std::log2(static_cast<double>(c));
+    }
+    return total ? total * std::log2(static_cast<double>(total)) - sum : 0.0;
+}
+
+// Estimasi ukuran (bit) untuk memilih ukuran color cache
+double estimate_bits(const std::vector<PixelToken> &tokens, int cache_bits) {
+    Histograms h(cache_bits);
+    h.add(tokens);
+    double bits = entropy_bits(h.green) + entropy_bits(h.red) + entropy_bits(h.blue) +
+                  entropy_bits(h.alpha) + entropy_bits(h.distance);
+    for (const PixelToken &token : tokens) {
+        if (token.kind != kCopy) continue;
+        int symbol;
+        int extra_bits;
+        uint32_t extra_value;
+        prefix_encode(token.value, &symbol, &extra_bits, &extra_value);
+        bits += extra_bits;
+        prefix_encode(token.distance, &symbol, &extra_bits, &extra_value);
+        bits += extra_bits;
+    }
+    return bits;
+}
+
+// Entropy-coded image: color cache info, (meta prefix untuk image utama), 5 prefix code, data
+void write_image_stream(BitWriter &bw, const std::vector<PixelToken> &tokens, int cache_bits, bool is_main) {
+    if (cache_bits) {
+        bw.put(1, 1);
+        bw.put(cache_bits, 4);
+    } else {
+        bw.put(0, 1);
+    }
+    if (is_main) {
+        bw.put(0, 1);  // satu grup prefix code untuk seluruh image
+    }
+
+    Histograms h(cache_bits);
+    h.add(tokens);
+    PrefixCode green, red, blue, alpha, distance;
+    green.build(h.green, kMaxCodeLength);
+    red.build(h.red, kMaxCodeLength);
+    blue.build(h.blue, kMaxCodeLength);
+    alpha.build(h.alpha, kMaxCodeLength);
+    distance.build(h.distance, kMaxCodeLength);
+    store_prefix_code(bw, green);
+    store_prefix_code(bw, red);
+    store_prefix_code(bw, blue);
+    store_prefix_code(bw, alpha);
+    store_prefix_code(bw, distance);
+
+    for (const PixelToken &token : tokens) {
+        int symbol;
+        int extra_bits;
+        uint32_t extra_value;
+        switch (token.kind) {
+        case kLiteral:
+            green.write(bw, (token.value >> 8) & 0xFF);
+            red.write(bw, (token.value >> 16) & 0xFF);
+            blue.write(bw, token.value & 0xFF);
+            alpha.write(bw, token.value >> 24);
+            break;
+        case kCacheIndex:
+            green.write(bw, kNumLiteralCodes + kNumLengthCodes + token.value);
+            break;
+        case kCopy:
+            prefix_encode(token.value, &symbol, &extra_bits, &extra_value);
+            green.write(bw, kNumLiteralCodes + symbol);
+            bw.put(extra_value, extra_bits);
+            prefix_encode(token.distance, &symbol, &extra_bits, &extra_value);
+            distance.write(bw, symbol);
+            bw.put(extra_value, extra_bits);
+            break;
+        }
+    }
+}
+
+// Sub-image kecil (mode predictor, palette): tanpa cache, chain pendek
+void write_sub_image(BitWriter &bw, const std::vector<uint32_t> &argb, uint32_t xsize, uint32_t ysize) {
+    std::vector<PixelToken> tokens;
+    build_backward_refs(argb.data(), xsize, ysize, 8, tokens);
+    write_image_stream(bw, tokens, 0, false);
+}
+
+// ===============================
+// Transform
+// ===============================
+
+inline uint32_t average2(uint32_t a, uint32_t b) {
+    return (((a ^ b) & 0xFEFEFEFEu) >> 1) + (a & b);
+}
+
+inline int clip255(int v) {
+    return v < 0 ? 0 : (v > 255 ? 255 : v);
+}
+
+inline int channel(uint32_t argb, int shift) {
+    return static_cast<int>((argb >> shift) & 0xFF);
+}
+
+uint32_t select_predictor(uint32_t left, uint32_t top, uint32_t top_left) {
+    int p_left = 0;
+    int p_top = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        p_left += std::abs(channel(top, shift) - channel(top_left, shift));
+        p_top += std::abs(channel(left, shift) - channel(top_left, shift));
+    }
+    return p_left < p_top ? left : top;
+}
+
+uint32_t clamp_add_subtract_full(uint32_t a, uint32_t b, uint32_t c) {
+    uint32_t result = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        result |= static_cast<uint32_t>(clip255(channel(a, shift) + channel(b, shift) - channel(c, shift))) << shift;
+    }
+    return result;
+}
+
+uint32_t clamp_add_subtract_half(uint32_t a, uint32_t b) {
+    uint32_t result = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        const int ca = channel(a, shift);
+        result |= static_cast<uint32_t>(clip255(ca + (ca - channel(b, shift)) / 2)) << shift;
+    }
+    return result;
+}
+
+// Prediksi pixel interior (x >= 1, y >= 1); TR di kolom terakhir = pixel pertama baris ini
+uint32_t predict(int mode, const uint32_t *p, uint32_t xsize) {
+    const uint32_t left = p[-1];
+    const uint32_t top = p[-static_cast<ptrdiff_t>(xsize)];
+    const uint32_t top_right = p[1 - static_cast<ptrdiff_t>(xsize)];
+    const uint32_t top_left = p[-1 - static_cast<ptrdiff_t>(xsize)];
+    switch (mode) {
+    case 0: return kArgbBlack;
+    case 1: return left;
+    case 2: return top;
+    case 3: return top_right;
+    case 4: return top_left;
+    case 5: return average2(average2(left, top_right), top);
+    case 6: return average2(left, top_left);
+    case 7: return average2(left, top);
+    case 8: return average2(top_left, top);
+    case 9: return average2(top, top_right);
+    case 10: return average2(average2(left, top_left), average2(top, top_right));
+    case 11: return select_predictor(left, top, top_left);
+    case 12: return clamp_add_subtract_full(left, top, top_left);
+    default: return clamp_add_subtract_half(average2(left, top), top_left);
+    }
+}
+
+inline uint32_t subtract_pixels(uint32_t a, uint32_t b) {
+    const uint32_t alpha_green = 0x00FF00FFu + (a & 0xFF00FF00u) - (b & 0xFF00FF00u);
+    const uint32_t red_blue = 0xFF00FF00u + (a & 0x00FF00FFu) - (b & 0x00FF00FFu);
+    return (alpha_green & 0xFF00FF00u) | (red_blue & 0x00FF00FFu);
+}
+
+inline uint32_t residual_cost(uint32_t residual) {
+    uint32_t cost = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        cost += static_cast<uint32_t>(std::abs(static_cast<int8_t>(residual >> shift)));
+    }
+    return cost;
+}
+
+void subtract_green(uint32_t *argb, size_t n) {
+    size_t i = 0;
+#ifdef IMAGE_SIMD
+    for (; i + 4 <= n; i += 4) {
+        const vec8 v = B_LOAD(argb + i);
+        B_STORE(argb + i, B_SUB(v, B_GREEN_SPREAD(v)));
+    }
+#endif
+    for (; i < n; i++) {
+        const uint32_t green = (argb[i] >> 8) & 0xFF;
+        const uint32_t red_blue = ((argb[i] & 0x00FF00FFu) + 0x01000100u - ((green << 16) | green)) & 0x00FF00FFu;
+        argb[i] = (argb[i] & 0xFF00FF00u) | red_blue;
+    }
+}
+
+#ifdef IMAGE_SIMD
+// Biaya L1 residual 4 pixel untuk mode yang hanya memakai load dan rata-rata
+bool simd_block_cost(int mode, const uint32_t *p, uint32_t xsize, uint32_t *cost) {
+    const vec8 cur = B_LOAD(p);
+    const vec8 left = B_LOAD(p - 1);
+    const vec8 top = B_LOAD(p - xsize);
+    vec8 pred;
+    switch (mode) {
+    case 0: pred = B_SPLAT32(kArgbBlack); break;
+    case 1: pred = left; break;
+    case 2: pred = top; break;
+    case 3: pred = B_LOAD(p - xsize + 1); break;
+    case 4: pred = B_LOAD(p - xsize - 1); break;
+    case 5: pred = B_AVG(B_AVG(left, B_LOAD(p - xsize + 1)), top); break;
+    case 6: pred = B_AVG(left, B_LOAD(p - xsize - 1)); break;
+    case 7: pred = B_AVG(left, top); break;
+    case 8: pred = B_AVG(B_LOAD(p - xsize - 1), top); break;
+    case 9: pred = B_AVG(top, B_LOAD(p - xsize + 1)); break;
+    case 10: pred = B_AVG(B_AVG(left, B_LOAD(p - xsize - 1)), B_AVG(top, B_LOAD(p - xsize + 1))); break;
+    default: return false;
+    }
+    *cost += B_SUM(B_ABS(B_SUB(cur, pred)));
+    return true;
+}
+#endif
+
+// Pilih mode predictor per blok (biaya L1 residual) lalu ganti image dengan residualnya
+void apply_predictor(std::vector<uint32_t> &argb, uint32_t xsize, uint32_t ysize,
+                     std::vector<uint32_t> &modes, uint32_t *tiles_x, uint32_t *tiles_y) {
+    const uint32_t tile = 1u << kPredictorBits;
+    *tiles_x = (xsize + tile - 1) >> kPredictorBits;
+    *tiles_y = (ysize + tile - 1) >> kPredictorBits;
+    modes.assign(static_cast<size_t>(*tiles_x) * *tiles_y, kArgbBlack | (11u << 8));
+    const uint32_t *src = argb.data();
+
+    for (uint32_t ty = 0; ty < *tiles_y; ty++) {
+        for (uint32_t tx = 0; tx < *tiles_x; tx++) {
+            const uint32_t x0 = std::max<uint32_t>(tx * tile, 1);
+            const uint32_t x1 = std::min(tx * tile + tile, xsize);
+            const uint32_t y0 = std::max<uint32_t>(ty * tile, 1);
+            const uint32_t y1 = std::min(ty * tile + tile, ysize);
+            if (x0 >= x1 || y0 >= y1) continue;
+
+            uint32_t best_cost = UINT32_MAX;
+            int best_mode = 11;
+            for (int mode = 0; mode < kNumPredictorModes; mode++) {
+                uint32_t cost = 0;
+                for (uint32_t y = y0; y < y1 && cost < best_cost; y++) {
+                    const uint32_t *row = src + static_cast<size_t>(y) * xsize;
+                    uint32_t x = x0;
+#ifdef IMAGE_SIMD
+                    // x + 4 < xsize: TR tetap di baris atas untuk keempat pixel
+                    while (x + 4 <= x1 && x + 4 < xsize && simd_block_cost(mode, row + x, xsize, &cost)) {
+                        x += 4;
+                    }
+#endif
+                    for (; x < x1; x++) {
+                        cost += residual_cost(subtract_pixels(row[x], predict(mode, row + x, xsize)));
+                    }
+                }
+                if (cost < best_cost) {
+                    best_cost = cost;
+                    best_mode = mode;
+                }
+            }
+            modes[static_cast<size_t>(ty) * *tiles_x + tx] = kArgbBlack | (static_cast<uint32_t>(best_mode) << 8);
+        }
+    }
+
+    // Residual dihitung dari pixel asli (lossless), ditulis ke buffer baru
+    std::vector<uint32_t> residual(argb.size());
+    for (uint32_t y = 0; y < ysize; y++) {
+        const uint32_t *row = src + static_cast<size_t>(y) * xsize;
+        uint32_t *out = residual.data() + static_cast<size_t>(y) * xsize;
+        for (uint32_t x = 0; x < xsize; x++) {
+            uint32_t pred;
+            if (y == 0) {
+                pred = x == 0 ? kArgbBlack : row[x - 1];
+            } else if (x == 0) {
+                pred = row[static_cast<ptrdiff_t>(x) - static_cast<ptrdiff_t>(xsize)];
+            } else {
+                const int mode = (modes[static_cast<size_t>(y >> kPredictorBits) * *tiles_x + (x >> kPredictorBits)] >> 8) & 0xFF;
+                pred = predict(mode, row + x, xsize);
+            }
+            out[x] = subtract_pixels(row[x], pred);
+        }
+    }
+    argb.swap(residual);
+}
+
+struct Palette {
+    std::vector<uint32_t> colors;
+    // open addressing: warna -> index
+    std::vector<uint32_t> keys;
+    std::vector<int16_t> slots;
+
+    static uint32_t slot_of(uint32_t argb) {
+        return (argb * 0x9E3779B1u) >> 22;  // 1024 slot
+    }
+
+    // false jika lebih dari 256 warna
+    bool collect(const uint32_t *argb, size_t n) {
+        keys.assign(1024, 0);
+        slots.assign(1024, -1);
+        colors.clear();
+        for (size_t i = 0; i < n; i++) {
+            if (i > 0 && argb[i] == argb[i - 1]) continue;
+            uint32_t s = slot_of(argb[i]);
+            while (slots[s] >= 0 && keys[s] != argb[i]) s = (s + 1) & 1023;
+            if (slots[s] >= 0) continue;
+            if (colors.size() == 256) return false;
+            keys[s] = argb[i];
+            slots[s] = 0;
+            colors.push_back(argb[i]);
+        }
+        // Urut supaya delta antar entri kecil
+        std::sort(colors.begin(), colors.end());
+        for (size_t i = 0; i < colors.size(); i++) {
+            uint32_t s = slot_of(colors[i]);
+            while (slots[s] < 0 || keys[s] != colors[i]) s = (s + 1) & 1023;
+            slots[s] = static_cast<int16_t>(i);
+        }
+        return true;
+    }
+
+    uint32_t index_of(uint32_t argb) const {
+        uint32_t s = slot_of(argb);
+        while (keys[s] != argb || slots[s] < 0) s = (s + 1) & 1023;
+        return static_cast<uint32_t>(slots[s]);
+    }
+};
+
+// Color indexing transform: index palette dipak ke channel hijau (1, 2, 4 atau 8 bit per pixel)
+void apply_palette(BitWriter &bw, const Palette &palette, std::vector<uint32_t> &argb, uint32_t *xsize, uint32_t ysize) {
+    const uint32_t count = static_cast<uint32_t>(palette.colors.size());
+    bw.put(1, 1);
+    bw.put(3, 2);
+    bw.put(count - 1, 8);
+
+    std::vector<uint32_t> deltas(count);
+    for (uint32_t i = 0; i < count; i++) {
+        deltas[i] = i == 0 ? palette.colors[0] : subtract_pixels(palette.colors[i], palette.colors[i - 1]);
+    }
+    write_sub_image(bw, deltas, count, 1);
+
+    const int xbits = count <= 2 ? 3 : (count <= 4 ? 2 : (count <= 16 ? 1 : 0));
+    const int bits_per_index = 8 >> xbits;
+    const uint32_t packed_width = (*xsize + (1u << xbits) - 1) >> xbits;
+    std::vector<uint32_t> packed(static_cast<size_t>(packed_width) * ysize);
+    for (uint32_t y = 0; y < ysize; y++) {
+        const uint32_t *row = argb.data() + static_cast<size_t>(y) * *xsize;
+        uint32_t *out = packed.data() + static_cast<size_t>(y) * packed_width;
+        for (uint32_t px = 0; px < packed_width; px++) {
+            uint32_t code = 0;
+            for (uint32_t k = 0; k < (1u << xbits); k++) {
+                const uint32_t x = (px << xbits) + k;
+                if (x >= *xsize) break;
+                code |= palette.index_of(row[x]) << (bits_per_index * k);
+            }
+            out[px] = kArgbBlack | (code << 8);
+        }
+    }
+    argb.swap(packed);
+    *xsize = packed_width;
+}
+
+void put_le32(std::vector<uint8_t> &out, uint32_t value) {
+    for (int i = 0; i < 4; i++) out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+}
+
+std::vector<uint8_t> encode_lossless(const uint8_t *rgba, uint32_t width, uint32_t height, uint32_t stride, int quality) {
+    const size_t n = static_cast<size_t>(width) * height;
+    std::vector<uint32_t> argb(n);
+    bool has_alpha = false;
+    for (uint32_t y = 0; y < height; y++) {
+        const uint8_t *row = rgba + static_cast<size_t>(y) * stride;
+        uint32_t *out = argb.data() + static_cast<size_t>(y) * width;
+        for (uint32_t x = 0; x < width; x++) {
+            const uint8_t *p = row + 4 * x;
+            out[x] = (static_cast<uint32_t>(p[3]) << 24) | (static_cast<uint32_t>(p[0]) << 16) |
+                     (static_cast<uint32_t>(p[1]) << 8) | p[2];
+            has_alpha |= p[3] != 0xFF;
+        }
+    }
+
+    BitWriter bw;
+    bw.put(0x2F, 8);
+    bw.put(width - 1, 14);
+    bw.put(height - 1, 14);
+    bw.put(has_alpha ? 1 : 0, 1);
+    bw.put(0, 3);
+
+    uint32_t xsize = width;
+    Palette palette;
+    const bool use_palette = palette.collect(argb.data(), n);
+    if (use_palette) {
+        apply_palette(bw, palette, argb, &xsize, height);
+    } else {
+        bw.put(1, 1);
+        bw.put(2, 2);  // subtract green
+        subtract_green(argb.data(), n);
+
+        std::vector<uint32_t> modes;
+        uint32_t tiles_x = 0;
+        uint32_t tiles_y = 0;
+        apply_predictor(argb, xsize, height, modes, &tiles_x, &tiles_y);
+        bw.put(1, 1);
+        bw.put(0, 2);  // predictor
+        bw.put(kPredictorBits - 2, 3);
+        write_sub_image(bw, modes, tiles_x, tiles_y);
+    }
+    bw.put(0, 1);  // tidak ada transform lagi
+
+    const int quality_clamped = std::max(0, std::min(100, quality));
+    const int max_chain = 8 + quality_clamped / 2;
+    std::vector<PixelToken> refs;
+    build_backward_refs(argb.data(), xsize, height, max_chain, refs);
+
+    // Pilih ukuran color cache dengan estimasi entropy
+    static const int kCacheCandidates[] = {0, 4, 6, 8, 10};
+    int best_bits = 0;
+    double best_cost = estimate_bits(refs, 0);
+    std::vector<PixelToken> tokens;
+    for (int cache_bits : kCacheCandidates) {
+        if (cache_bits == 0) continue;
+        apply_color_cache(argb.data(), refs, cache_bits, tokens);
+        // Alphabet hijau lebih besar menambah ongkos header prefix code
+        const double cost = estimate_bits(tokens, cache_bits) + (1u << cache_bits) * 0.5;
+        if (cost < best_cost) {
+            best_cost = cost;
+            best_bits = cache_bits;
+        }
+    }
+    apply_color_cache(argb.data(), refs, best_bits, tokens);
+    write_image_stream(bw, tokens, best_bits, true);
+    bw.finish();
+
+    const uint32_t chunk_size = static_cast<uint32_t>(bw.bytes.size());
+    const uint32_t padded = chunk_size + (chunk_size & 1);
+    std::vector<uint8_t> out;
+    out.reserve(20 + padded);
+    out.insert(out.end(), {'R', 'I', 'F', 'F'});
+    put_le32(out, 4 + 8 + padded);
+    out.insert(out.end(), {'W', 'E', 'B', 'P', 'V', 'P', '8', 'L'});
+    put_le32(out, chunk_size);
+    out.insert(out.end(), bw.bytes.begin(), bw.bytes.end());
+    if (chunk_size & 1) out.push_back(0);
+    return out;
+}
+
+bool valid_image(const uint8_t *rgba, uint32_t width, uint32_t height, uint32_t stride) {
+    return rgba && width > 0 && height > 0 && width <= IMAGE_ENCODER_MAX_DIMENSION &&
+           height <= IMAGE_ENCODER_MAX_DIMENSION && stride >= width * 4;
+}
+
+}  // namespace
+
+extern "C" int image_classify(const uint8_t *rgba, uint32_t width, uint32_t height, uint32_t stride,
+                              ImageClassification *out) {
+    if (!out || !valid_image(rgba, width, height, stride)) return IMAGE_ENCODER_ERROR_INVALID_INPUT;
+
+    // Sampel maksimal 256 baris x 256 pasangan pixel bertetangga
+    const uint32_t row_step = std::max<uint32_t>(1, height / 256);
+    const uint32_t col_step = std::max<uint32_t>(1, width / 256);
+    constexpr uint32_t kMaxColors = 4096;
+    std::vector<uint32_t> seen(8192, 0);
+    std::vector<uint8_t> occupied(8192, 0);
+    uint32_t colors = 0;
+    uint32_t pairs = 0;
+    uint32_t equal_pairs = 0;
+    bool has_alpha = false;
+
+    for (uint32_t y = 0; y < height; y += row_step) {
+        const uint8_t *row = rgba + static_cast<size_t>(y) * stride;
+        for (uint32_t x = 0; x < width; x += col_step) {
+            uint32_t pixel;
+            memcpy(&pixel, row + 4 * x, 4);
+            has_alpha |= row[4 * x + 3] != 0xFF;
+            if (x + 1 < width) {
+                uint32_t next;
+                memcpy(&next, row + 4 * x + 4, 4);
+                pairs++;
+                equal_pairs += pixel == next;
+            }
+            if (colors < kMaxColors) {
+                uint32_t s = (pixel * 0x9E3779B1u) >> 19;
+                while (occupied[s] && seen[s] != pixel) s = (s + 1) & 8191;
+                if (!occupied[s]) {
+                    occupied[s] = 1;
+                    seen[s] = pixel;
+                    colors++;
+                }
+            }
+        }
+    }
+
+    out->sampled_colors = colors;
+    out->flat_ratio = pairs ? static_cast<float>(equal_pairs) / pairs : 1.0f;
+    out->has_alpha = has_alpha ? 1 : 0;
+    // Foto hampir tidak punya pixel bertetangga yang identik; grafik punya palet kecil
+    // atau area datar yang luas
+    out->content = (colors <= 256 || out->flat_ratio >= 0.6f) ? IMAGE_CONTENT_GRAPHIC : IMAGE_CONTENT_PHOTO;
+    return IMAGE_ENCODER_OK;
+}
+
+extern "C" int image_encode(const uint8_t *rgba, uint32_t width, uint32_t height, uint32_t stride,
+                            int32_t format, int32_t quality, ImageEncodeResult *out) {
+    if (!out) return IMAGE_ENCODER_ERROR_INVALID_INPUT;
+    memset(out, 0, sizeof(*out));
+    if (!valid_image(rgba, width, height, stride)) return IMAGE_ENCODER_ERROR_INVALID_INPUT;
+
+    ImageClassification classification;
+    image_classify(rgba, width, height, stride, &classification);
+    out->content = classification.content;
+    if (format == IMAGE_FORMAT_AUTO) {
+        format = classification.content == IMAGE_CONTENT_GRAPHIC ? IMAGE_FORMAT_WEBP_LOSSLESS : IMAGE_FORMAT_WEBP_LOSSY;
+    }
+
+    if (format == IMAGE_FORMAT_WEBP_LOSSY) {
+#ifdef HAVE_LIBWEBP
+        uint8_t *encoded = nullptr;
+        const size_t size = WebPEncodeRGBA(rgba, static_cast<int>(width), static_cast<int>(height),
+                                           static_cast<int>(stride), static_cast<float>(quality), &encoded);
+        if (size == 0) return IMAGE_ENCODER_ERROR_NO_MEMORY;
+        out->data = static_cast<uint8_t *>(malloc(size));
+        if (!out->data) {
+            WebPFree(encoded);
+            return IMAGE_ENCODER_ERROR_NO_MEMORY;
+        }
+        memcpy(out->data, encoded, size);
+        WebPFree(encoded);
+        out->len = size;
+        out->format = IMAGE_FORMAT_WEBP_LOSSY;
+        return IMAGE_ENCODER_OK;
+#else
+        return IMAGE_ENCODER_ERROR_UNSUPPORTED;
+#endif
+    }
+    if (format != IMAGE_FORMAT_WEBP_LOSSLESS) return IMAGE_ENCODER_ERROR_INVALID_INPUT;
+
+    try {
+        const std::vector<uint8_t> encoded = encode_lossless(rgba, width, height, stride, quality);
+        out->data = static_cast<uint8_t *>(malloc(encoded.size()));
+        if (!out->data) return IMAGE_ENCODER_ERROR_NO_MEMORY;
+        memcpy(out->data, encoded.data(), encoded.size());
+        out->len = encoded.size();
+        out->format = IMAGE_FORMAT_WEBP_LOSSLESS;
+        return IMAGE_ENCODER_OK;
+    } catch (const std::bad_alloc &) {
+        return IMAGE_ENCODER_ERROR_NO_MEMORY;
+    }
+}
+
+extern "C" int image_encoder_supports_lossy(void) {
+#ifdef HAVE_LIBWEBP
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+extern "C" void image_encode_free(ImageEncodeResult *result) {
+    if (!result) return;
+    free(result->data);
+    result->data = nullptr;
+    result->len = 0;
+}
@@ -0,0 +1,64 @@
+#ifndef IMAGE_ENCODER_H
+#define IMAGE_ENCODER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Encoder gambar untuk attachment. Classifier cepat memisahkan foto dari grafik datar
+// (screenshot, diagram, stiker). Grafik dikodekan WebP lossless (VP8L: palette, subtract
+// green, predictor, LZ77 + color cache); foto memakai WebP lossy jika dibangun dengan
+// HAVE_LIBWEBP, selain itu pemanggil kembali ke JPEG.
+
+#define IMAGE_ENCODER_OK 0
+#define IMAGE_ENCODER_ERROR_INVALID_INPUT -1
+#define IMAGE_ENCODER_ERROR_UNSUPPORTED -2
+#define IMAGE_ENCODER_ERROR_NO_MEMORY -3
+
+#define IMAGE_CONTENT_PHOTO 0
+#define IMAGE_CONTENT_GRAPHIC 1
+
+#define IMAGE_FORMAT_AUTO 0
+#define IMAGE_FORMAT_WEBP_LOSSLESS 1
+#define IMAGE_FORMAT_WEBP_LOSSY 2
+
+// Batas dimensi VP8L (14 bit)
+#define IMAGE_ENCODER_MAX_DIMENSION 16384
+
+typedef struct {
+    int32_t content;            // IMAGE_CONTENT_*
+    uint32_t sampled_colors;    // warna unik pada sampel (dibatasi 4096)
+    float flat_ratio;           // porsi pasangan pixel bertetangga yang identik
+    int32_t has_alpha;
+} ImageClassification;
+
+typedef struct {
+    uint8_t *data;              // dialokasikan native, lepas dengan image_encode_free
+    size_t len;
+    int32_t format;             // IMAGE_FORMAT_* yang dipakai
+    int32_t content;            // hasil classifier (juga diisi saat UNSUPPORTED)
+} ImageEncodeResult;
+
+// rgba: 4 byte per pixel (R, G, B, A), stride dalam byte.
+int image_classify(const uint8_t *rgba, uint32_t width, uint32_t height, uint32_t stride,
+                   ImageClassification *out);
+
+// format AUTO: grafik -> lossless, foto -> lossy. quality 0..100 (lossy) atau effort (lossless).
+// UNSUPPORTED jika lossy diminta tanpa HAVE_LIBWEBP; out->content tetap diisi.
+int image_encode(const uint8_t *rgba, uint32_t width, uint32_t height, uint32_t stride,
+                 int32_t format, int32_t quality, ImageEncodeResult *out);
+
+void image_encode_free(ImageEncodeResult *result);
+
+// 1 jika dibangun dengan HAVE_LIBWEBP (foto bisa WebP lossy). Pemanggil yang akan jatuh ke
+// JPEG untuk foto bisa melewati konversi RGBA.
+int image_encoder_supports_lossy(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
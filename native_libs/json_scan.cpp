@@ -0,0 +1,512 @@
+#include "json_scan.h"
+#include "cpu_features.h"
+
+#include <cstring>
+#include <vector>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <emmintrin.h>
+#define JSON_SCAN_HAVE_SSE2 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define JSON_SCAN_HAVE_NEON 1
+#elif defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#define JSON_SCAN_HAVE_SIMD128 1
+#endif
+
+namespace {
+
+constexpr size_t kBlockBytes = 64;
+
+// Bitmask per blok 64 byte, bit i = byte i
+struct BlockMasks {
+    uint64_t quote;
+    uint64_t backslash;
+    uint64_t op;        // { } [ ] : ,
+    uint64_t control;   // < 0x20, tidak boleh ada di dalam string
+};
+
+typedef BlockMasks (*ClassifyFn)(const uint8_t *block);
+
+BlockMasks classify_scalar(const uint8_t *block) {
+    BlockMasks m = {0, 0, 0, 0};
+    for (size_t i = 0; i < kBlockBytes; i++) {
+        const uint8_t c = block[i];
+        const uint64_t bit = 1ull << i;
+        if (c == '"') m.quote |= bit;
+        if (c == '\\') m.backslash |= bit;
+        if (c == '{' || c == '}' || c == '[' || c == ']' || c == ':' || c == ',') m.op |= bit;
+        if (c < 0x20) m.control |= bit;
+    }
+    return m;
+}
+
+#if defined(JSON_SCAN_HAVE_SSE2)
+BlockMasks classify_simd(const uint8_t *block) {
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i open_brace = _mm_set1_epi8('{');
+    const __m128i close_brace = _mm_set1_epi8('}');
+    const __m128i colon = _mm_set1_epi8(':');
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i case_bit = _mm_set1_epi8(0x20);
+    const __m128i max_control = _mm_set1_epi8(0x1F);
+
+    BlockMasks m = {0, 0, 0, 0};
+    for (int i = 0; i < 4; i++) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + 16 * i));
+        // '[' | 0x20 == '{' dan ']' | 0x20 == '}'
+        const __m128i folded = _mm_or_si128(v, case_bit);
+        const __m128i op = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(folded, open_brace), _mm_cmpeq_epi8(folded, close_brace)),
+            _mm_or_si128(_mm_cmpeq_epi8(v, colon), _mm_cmpeq_epi8(v, comma)));
+        const __m128i control = _mm_cmpeq_epi8(_mm_min_epu8(v, max_control), v);
+        const int shift = 16 * i;
+        m.quote |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, quote)) << shift;
+        m.backslash |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, backslash)) << shift;
+        m.op |= (uint64_t)(uint16_t)_mm_movemask_epi8(op) << shift;
+        m.control |= (uint64_t)(uint16_t)_mm_movemask_epi8(control) << shift;
+    }
+    return m;
+}
+#elif defined(JSON_SCAN_HAVE_NEON)
+inline uint64_t neon_movemask(uint8x16_t cmp) {
+    static const uint8_t kBits[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+    const uint8x16_t masked = vandq_u8(cmp, vld1q_u8(kBits));
+    return (uint64_t)vaddv_u8(vget_low_u8(masked)) | ((uint64_t)vaddv_u8(vget_high_u8(masked)) << 8);
+}
+
+BlockMasks classify_simd(const uint8_t *block) {
+    BlockMasks m = {0, 0, 0, 0};
+    for (int i = 0; i < 4; i++) {
+        const uint8x16_t v = vld1q_u8(block + 16 * i);
+        const uint8x16_t folded = vorrq_u8(v, vdupq_n_u8(0x20));
+        const uint8x16_t op = vorrq_u8(vorrq_u8(vceqq_u8(folded, vdupq_n_u8('{')), vceqq_u8(folded, vdupq_n_u8('}'))),
+                                       vorrq_u8(vceqq_u8(v, vdupq_n_u8(':')), vceqq_u8(v, vdupq_n_u8(','))));
+        const int shift = 16 * i;
+        m.quote |= neon_movemask(vceqq_u8(v, vdupq_n_u8('"'))) << shift;
+        m.backslash |= neon_movemask(vceqq_u8(v, vdupq_n_u8('\\'))) << shift;
+        m.op |= neon_movemask(op) << shift;
+        m.control |= neon_movemask(vcltq_u8(v, vdupq_n_u8(0x20))) << shift;
+    }
+    return m;
+}
+#elif defined(JSON_SCAN_HAVE_SIMD128)
+BlockMasks classify_simd(const uint8_t *block) {
+    BlockMasks m = {0, 0, 0, 0};
+    for (int i = 0; i < 4; i++) {
+        const v128_t v = wasm_v128_load(block + 16 * i);
+        const v128_t folded = wasm_v128_or(v, wasm_i8x16_splat(0x20));
+        const v128_t op = wasm_v128_or(
+            wasm_v128_or(wasm_i8x16_eq(folded, wasm_i8x16_splat('{')), wasm_i8x16_eq(folded, wasm_i8x16_splat('}'))),
+            wasm_v128_or(wasm_i8x16_eq(v, wasm_i8x16_splat(':')), wasm_i8x16_eq(v, wasm_i8x16_splat(','))));
+        const int shift = 16 * i;
+        m.quote |= (uint64_t)wasm_i8x16_bitmask(wasm_i8x16_eq(v, wasm_i8x16_splat('"'))) << shift;
+        m.backslash |= (uint64_t)wasm_i8x16_bitmask(wasm_i8x16_eq(v, wasm_i8x16_splat('\\'))) << shift;
+        m.op |= (uint64_t)wasm_i8x16_bitmask(op) << shift;
+        m.control |= (uint64_t)wasm_i8x16_bitmask(wasm_u8x16_lt(v, wasm_i8x16_splat(0x20))) << shift;
+    }
+    return m;
+}
+#endif
+
+ClassifyFn select_classify() {
+#if defined(JSON_SCAN_HAVE_SSE2) || defined(JSON_SCAN_HAVE_NEON) || defined(JSON_SCAN_HAVE_SIMD128)
+    if (cpu_features_get() & (CPU_FEATURE_SSE2 | CPU_FEATURE_NEON | CPU_FEATURE_SIMD128)) return classify_simd;
+#endif
+    return classify_scalar;
+}
+
+inline int ctz64(uint64_t v) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward64(&index, v);
+    return (int)index;
+#else
+    return __builtin_ctzll(v);
+#endif
+}
+
+// Bit i = XOR bit 0..i: 1 untuk byte di dalam string (termasuk quote pembuka)
+inline uint64_t prefix_xor(uint64_t v) {
+    v ^= v << 1;
+    v ^= v << 2;
+    v ^= v << 4;
+    v ^= v << 8;
+    v ^= v << 16;
+    v ^= v << 32;
+    return v;
+}
+
+// Byte yang di-escape: didahului deret backslash berjumlah ganjil. carry = byte pertama
+// blok berikutnya di-escape.
+inline uint64_t find_escaped(uint64_t backslash, uint64_t &carry) {
+    const uint64_t even_bits = 0x5555555555555555ull;
+    backslash &= ~carry;
+    const uint64_t follows_escape = (backslash << 1) | carry;
+    const uint64_t odd_starts = backslash & ~even_bits & ~follows_escape;
+    const uint64_t sum = odd_starts + backslash;
+    carry = sum < odd_starts ? 1 : 0;
+    const uint64_t invert = sum << 1;
+    return (even_bits ^ invert) & follows_escape;
+}
+
+// Tahap 1: posisi semua karakter struktural di luar string plus setiap quote yang tidak
+// di-escape (pembuka dan penutup), diakhiri sentinel len.
+bool build_index(const uint8_t *json, size_t len, ClassifyFn classify, std::vector<uint32_t> &index) {
+    index.clear();
+    index.reserve(len / 4 + 2);
+    uint64_t escape_carry = 0;
+    uint64_t in_string_carry = 0;
+    uint8_t tail[kBlockBytes];
+
+    for (size_t offset = 0; offset < len; offset += kBlockBytes) {
+        const uint8_t *block = json + offset;
+        if (len - offset < kBlockBytes) {
+            memset(tail, ' ', sizeof(tail));
+            memcpy(tail, block, len - offset);
+            block = tail;
+        }
+        const BlockMasks m = classify(block);
+        const uint64_t quotes = m.quote & ~find_escaped(m.backslash, escape_carry);
+        const uint64_t in_string = prefix_xor(quotes) ^ in_string_carry;
+        in_string_carry = (uint64_t)((int64_t)in_string >> 63);
+        if (m.control & in_string) return false;
+
+        uint64_t structural = (m.op & ~in_string) | quotes;
+        while (structural) {
+            index.push_back((uint32_t)(offset + ctz64(structural)));
+            structural &= structural - 1;
+        }
+    }
+    if (in_string_carry) return false;
+    index.push_back((uint32_t)len);
+    return true;
+}
+
+inline bool is_ws(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+inline bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+bool valid_number(const char *p, const char *end) {
+    if (p < end && *p == '-') p++;
+    if (p >= end) return false;
+    if (*p == '0') {
+        p++;
+    } else if (is_digit(*p)) {
+        while (p < end && is_digit(*p)) p++;
+    } else {
+        return false;
+    }
+    if (p < end && *p == '.') {
+        p++;
+        if (p >= end || !is_digit(*p)) return false;
+        while (p < end && is_digit(*p)) p++;
+    }
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        p++;
+        if (p < end && (*p == '+' || *p == '-')) p++;
+        if (p >= end || !is_digit(*p)) return false;
+        while (p < end && is_digit(*p)) p++;
+    }
+    return p == end;
+}
+
+int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+bool read_hex4(const char *p, const char *end, uint32_t &out) {
+    if (end - p < 4) return false;
+    out = 0;
+    for (int i = 0; i < 4; i++) {
+        const int v = hex_value(p[i]);
+        if (v < 0) return false;
+        out = (out << 4) | (uint32_t)v;
+    }
+    return true;
+}
+
+// Escape sesuai RFC 8259; surrogate \uD8xx harus diikuti \uDCxx (tanpa surrogate tunggal)
+bool valid_escapes(const char *p, const char *end) {
+    while (p < end) {
+        const char *slash = static_cast<const char *>(memchr(p, '\\', end - p));
+        if (!slash) return true;
+        p = slash + 1;
+        if (p >= end) return false;
+        const char e = *p++;
+        if (e == '"' || e == '\\' || e == '/' || e == 'b' || e == 'f' || e == 'n' || e == 'r' || e == 't') continue;
+        if (e != 'u') return false;
+        uint32_t cp;
+        if (!read_hex4(p, end, cp)) return false;
+        p += 4;
+        if (cp >= 0xDC00 && cp <= 0xDFFF) return false;
+        if (cp >= 0xD800 && cp <= 0xDBFF) {
+            uint32_t low;
+            if (end - p < 6 || p[0] != '\\' || p[1] != 'u' || !read_hex4(p + 2, end, low) || low < 0xDC00 ||
+                low > 0xDFFF) {
+                return false;
+            }
+            p += 6;
+        }
+    }
+    return true;
+}
+
+// Tahap 2: recursive descent di atas indeks struktural; hanya scalar (angka/literal)
+// yang dibaca byte per byte.
+struct Parser {
+    const char *json;
+    size_t len;
+    const uint32_t *index;
+    size_t structural;   // index[structural] = struktural pertama di posisi >= pos
+    size_t pos;
+    JsonToken *tokens;
+    uint32_t capacity;
+    uint32_t count;
+    int error;
+
+    void skip_ws() {
+        while (pos < len && is_ws(json[pos])) pos++;
+    }
+
+    int32_t add(uint8_t type, uint32_t start, uint32_t length) {
+        if (count >= capacity) {
+            error = JSON_SCAN_ERROR_TOO_MANY_TOKENS;
+            return -1;
+        }
+        JsonToken &t = tokens[count];
+        t.type = type;
+        t.escaped = 0;
+        t.reserved = 0;
+        t.start = start;
+        t.len = length;
+        t.next = count + 1;
+        return (int32_t)count++;
+    }
+
+    // Struktural berikutnya harus tepat di pos (setelah whitespace) dan berupa c
+    bool expect(char c) {
+        skip_ws();
+        if (pos >= len || json[pos] != c || index[structural] != pos) return false;
+        structural++;
+        pos++;
+        return true;
+    }
+
+    bool peek(char c) {
+        skip_ws();
+        return pos < len && json[pos] == c;
+    }
+
+    bool parse_string() {
+        skip_ws();
+        if (pos >= len || json[pos] != '"' || index[structural] != pos) return false;
+        const uint32_t close = index[structural + 1];
+        if (close >= len || json[close] != '"') return false;
+        const int32_t t = add(JSON_TOKEN_STRING, (uint32_t)pos + 1, close - (uint32_t)pos - 1);
+        if (t < 0) return false;
+        const char *content = json + pos + 1;
+        const bool escaped = memchr(content, '\\', close - pos - 1) != nullptr;
+        if (escaped && !valid_escapes(content, json + close)) return false;
+        tokens[t].escaped = escaped;
+        structural += 2;
+        pos = close + 1;
+        return true;
+    }
+
+    bool parse_scalar() {
+        const size_t start = pos;
+        size_t end = index[structural];
+        while (end > start && is_ws(json[end - 1])) end--;
+        if (end == start) return false;
+
+        const char *p = json + start;
+        const size_t n = end - start;
+        uint8_t type;
+        if (n == 4 && memcmp(p, "true", 4) == 0) {
+            type = JSON_TOKEN_TRUE;
+        } else if (n == 5 && memcmp(p, "false", 5) == 0) {
+            type = JSON_TOKEN_FALSE;
+        } else if (n == 4 && memcmp(p, "null", 4) == 0) {
+            type = JSON_TOKEN_NULL;
+        } else if (valid_number(p, p + n)) {
+            type = JSON_TOKEN_NUMBER;
+        } else {
+            return false;
+        }
+        if (add(type, (uint32_t)start, (uint32_t)n) < 0) return false;
+        pos = end;
+        return true;
+    }
+
+    bool parse_value(int depth) {
+        skip_ws();
+        if (pos >= len) return false;
+        const char c = json[pos];
+        if (c == '"') return parse_string();
+        if (c != '{' && c != '[') return parse_scalar();
+        if (depth >= JSON_SCAN_MAX_DEPTH) {
+            error = JSON_SCAN_ERROR_TOO_DEEP;
+            return false;
+        }
+
+        const bool object = c == '{';
+        const char close = object ? '}' : ']';
+        const uint32_t start = (uint32_t)pos;
+        const int32_t t = add(object ? JSON_TOKEN_OBJECT : JSON_TOKEN_ARRAY, start, 0);
+        if (t < 0 || !expect(c)) return false;
+
+        if (!peek(close)) {
+            for (;;) {
+                if (object && (!parse_string() || !expect(':'))) return false;
+                if (!parse_value(depth + 1)) return false;
+                if (peek(',')) {
+                    expect(',');
+                    continue;
+                }
+                break;
+            }
+        }
+        if (!expect(close)) return false;
+        tokens[t].len = (uint32_t)pos - start;
+        tokens[t].next = count;
+        return true;
+    }
+};
+
+}  // namespace
+
+extern "C" int json_scan_impl(void) {
+    return select_classify() == classify_scalar ? JSON_SCAN_IMPL_SCALAR : JSON_SCAN_IMPL_SIMD;
+}
+
+extern "C" int32_t json_scan_parse(const char *json, size_t len, JsonToken *tokens, uint32_t capacity) {
+    if (!json || !tokens || capacity == 0 || len == 0 || len >= 0xFFFFFFFFu) return JSON_SCAN_ERROR_INVALID_INPUT;
+
+    // Dipilih per call (satu atomic load) supaya cpu_features_set_mask ikut berlaku
+    const ClassifyFn classify = select_classify();
+    // Dipakai ulang per thread: frame realtime kecil, alokasi per parse lebih mahal dari scan-nya
+    thread_local std::vector<uint32_t> index;
+    if (!build_index(reinterpret_cast<const uint8_t *>(json), len, classify, index)) return JSON_SCAN_ERROR_MALFORMED;
+
+    Parser parser = {json, len, index.data(), 0, 0, tokens, capacity, 0, JSON_SCAN_OK};
+    int32_t result;
+    if (!parser.parse_value(0)) {
+        result = parser.error != JSON_SCAN_OK ? parser.error : JSON_SCAN_ERROR_MALFORMED;
+    } else {
+        parser.skip_ws();
+        const bool complete = parser.pos == len && parser.structural == index.size() - 1;
+        result = complete ? (int32_t)parser.count : JSON_SCAN_ERROR_MALFORMED;
+    }
+    // Jangan menahan indeks besar dari satu dokumen raksasa selamanya
+    if (index.capacity() > (1u << 20)) {
+        index.clear();
+        index.shrink_to_fit();
+    }
+    return result;
+}
+
+extern "C" int32_t json_scan_find(const char *json, const JsonToken *tokens, uint32_t count,
+                                  uint32_t object, const char *key) {
+    if (!json || !tokens || !key || object >= count || tokens[object].type != JSON_TOKEN_OBJECT) return -1;
+    const size_t key_len = strlen(key);
+    std::vector<char> unescaped;
+
+    uint32_t i = object + 1;
+    while (i + 1 < tokens[object].next) {
+        const JsonToken &k = tokens[i];
+        bool match;
+        if (!k.escaped) {
+            match = k.len == key_len && memcmp(json + k.start, key, key_len) == 0;
+        } else {
+            unescaped.resize(k.len);
+            const int64_t n = json_scan_unescape(unescaped.data(), json, &k);
+            match = n == (int64_t)key_len && memcmp(unescaped.data(), key, key_len) == 0;
+        }
+        if (match) return (int32_t)(i + 1);
+        i = tokens[i + 1].next;
+    }
+    return -1;
+}
+
+extern "C" int64_t json_scan_unescape(char *out, const char *json, const JsonToken *token) {
+    if (!out || !json || !token || token->type != JSON_TOKEN_STRING) return -1;
+    const char *p = json + token->start;
+    const char *end = p + token->len;
+    if (!token->escaped) {
+        memcpy(out, p, token->len);
+        return token->len;
+    }
+
+    char *o = out;
+    while (p < end) {
+        const char *slash = static_cast<const char *>(memchr(p, '\\', end - p));
+        const size_t plain = slash ? (size_t)(slash - p) : (size_t)(end - p);
+        memmove(o, p, plain);
+        o += plain;
+        p += plain;
+        if (p >= end) break;
+
+        if (end - p < 2) return -1;
+        const char e = p[1];
+        p += 2;
+        switch (e) {
+            case '"': *o++ = '"'; break;
+            case '\\': *o++ = '\\'; break;
+            case '/': *o++ = '/'; break;
+            case 'b': *o++ = '\b'; break;
+            case 'f': *o++ = '\f'; break;
+            case 'n': *o++ = '\n'; break;
+            case 'r': *o++ = '\r'; break;
+            case 't': *o++ = '\t'; break;
+            case 'u': {
+                uint32_t cp;
+                if (!read_hex4(p, end, cp)) return -1;
+                p += 4;
+                if (cp >= 0xD800 && cp <= 0xDBFF) {
+                    uint32_t low;
+                    if (end - p < 6 || p[0] != '\\' || p[1] != 'u' || !read_hex4(p + 2, end, low) ||
+                        low < 0xDC00 || low > 0xDFFF) {
+                        return -1;
+                    }
+                    p += 6;
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+                    return -1;
+                }
+                if (cp < 0x80) {
+                    *o++ = (char)cp;
+                } else if (cp < 0x800) {
+                    *o++ = (char)(0xC0 | (cp >> 6));
+                    *o++ = (char)(0x80 | (cp & 0x3F));
+                } else if (cp < 0x10000) {
+                    *o++ = (char)(0xE0 | (cp >> 12));
+                    *o++ = (char)(0x80 | ((cp >> 6) & 0x3F));
+                    *o++ = (char)(0x80 | (cp & 0x3F));
+                } else {
+                    *o++ = (char)(0xF0 | (cp >> 18));
+                    *o++ = (char)(0x80 | ((cp >> 12) & 0x3F));
+                    *o++ = (char)(0x80 | ((cp >> 6) & 0x3F));
+                    *o++ = (char)(0x80 | (cp & 0x3F));
+                }
+                break;
+            }
+            default:
+                return -1;
+        }
+    }
+    return o - out;
+}
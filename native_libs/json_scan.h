@@ -0,0 +1,66 @@
+#ifndef JSON_SCAN_H
+#define JSON_SCAN_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Parser JSON dua tahap untuk frame realtime. Tahap 1 mengklasifikasi 64 byte sekaligus
+// dengan SIMD (SSE2/NEON/SIMD128, fallback scalar): bitmask quote, backslash dan karakter
+// struktural, escape dan region string dihitung dengan operasi bit tanpa cabang per byte.
+// Tahap 2 hanya berjalan di atas indeks struktural itu dan menghasilkan tape token datar,
+// tanpa alokasi per node. Escape string divalidasi tetapi tidak di-unescape saat parsing
+// (lihat json_scan_unescape).
+
+#define JSON_SCAN_OK 0
+#define JSON_SCAN_ERROR_INVALID_INPUT -1
+#define JSON_SCAN_ERROR_MALFORMED -2
+#define JSON_SCAN_ERROR_TOO_MANY_TOKENS -3
+#define JSON_SCAN_ERROR_TOO_DEEP -4
+
+#define JSON_SCAN_MAX_DEPTH 64
+
+#define JSON_SCAN_IMPL_SCALAR 1
+#define JSON_SCAN_IMPL_SIMD 2
+
+#define JSON_TOKEN_OBJECT 1
+#define JSON_TOKEN_ARRAY 2
+#define JSON_TOKEN_STRING 3
+#define JSON_TOKEN_NUMBER 4
+#define JSON_TOKEN_TRUE 5
+#define JSON_TOKEN_FALSE 6
+#define JSON_TOKEN_NULL 7
+
+// Token 0 adalah nilai root. Anak object disusun key (STRING), value, key, value, ...
+typedef struct {
+    uint8_t type;
+    uint8_t escaped;        // string mengandung backslash
+    uint16_t reserved;
+    uint32_t start;         // offset byte; string: isi tanpa tanda kutip
+    uint32_t len;           // string: panjang isi mentah; object/array: span termasuk kurung
+    uint32_t next;          // index token sesudah seluruh subtree token ini
+} JsonToken;
+
+int json_scan_impl(void);
+
+// Return jumlah token, atau error negatif. Dokumen harus satu nilai JSON (RFC 8259)
+// dengan whitespace di sekitarnya. UTF-8 di dalam string tidak divalidasi di sini;
+// pemanggil memvalidasi string yang benar-benar dipakai.
+int32_t json_scan_parse(const char *json, size_t len, JsonToken *tokens, uint32_t capacity);
+
+// Index token value untuk key di object tokens[object], atau -1
+int32_t json_scan_find(const char *json, const JsonToken *tokens, uint32_t count,
+                       uint32_t object, const char *key);
+
+// Unescape string token ke UTF-8 (out minimal tokens[i].len byte). Return panjang, atau -1
+// jika escape tidak valid.
+int64_t json_scan_unescape(char *out, const char *json, const JsonToken *token);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,455 @@
+#include "kdf_executor.h"
+#include "argon2.h"
+#include "native_metrics.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+enum class JobState { Queued, Running, Done };
+
+struct KdfJob {
+    int64_t id = 0;
+    KdfParams params{};
+    std::vector<uint8_t> pwd;
+    std::vector<uint8_t> salt;
+    std::vector<uint8_t> hash;
+    uint64_t reserve = 0;
+    JobState state = JobState::Queued;
+    bool released = false;      // kdf_executor_release saat Running: hash dibuang saat selesai
+    int result = KDF_OK;
+    Clock::time_point enqueued;
+};
+
+// Ukuran memory yang benar-benar dialokasikan Argon2 (lihat core.c: memory_blocks)
+uint64_t argon2_memory_bytes(const KdfParams &params) {
+    const uint64_t lanes = params.parallelism ? params.parallelism : 1;
+    uint64_t blocks = params.m_cost;
+    if (blocks < 8 * lanes) {
+        blocks = 8 * lanes;
+    }
+    const uint64_t segment = blocks / (lanes * 4);
+    return segment * lanes * 4 * 1024;
+}
+
+void secure_wipe(std::vector<uint8_t> &buffer) {
+    volatile uint8_t *p = buffer.data();
+    for (size_t i = 0; i < buffer.size(); i++) {
+        p[i] = 0;
+    }
+    buffer.clear();
+}
+
+}  // namespace
+
+struct KdfExecutor {
+    std::mutex mutex;
+    std::condition_variable work_cv;
+    std::condition_variable done_cv;
+    std::condition_variable idle_cv;
+    std::vector<std::thread> workers;
+    bool stopping = false;
+
+    // Thread yang sedang di dalam kdf_executor_wait; destroy menunggu sampai 0
+    uint32_t waiters = 0;
+
+    // Key (-prioritas, urutan masuk): begin() = prioritas tertinggi, FIFO di dalam prioritas
+    std::map<std::pair<int, uint64_t>, std::shared_ptr<KdfJob>> queue;
+    std::unordered_map<int64_t, std::shared_ptr<KdfJob>> jobs;
+    uint64_t next_seq = 0;
+    int64_t next_id = 1;
+    uint32_t max_queue = 0;
+
+    uint64_t budget = 0;
+    uint64_t reserved = 0;
+    uint32_t running = 0;
+
+    // Arena yang sudah dilepas Argon2, dipakai ulang oleh job dengan ukuran sama
+    std::mutex pool_mutex;
+    std::multimap<size_t, uint8_t *> pool;
+    uint64_t pooled = 0;
+
+    uint64_t completed = 0;
+    uint64_t rejected = 0;
+    uint64_t arena_reuses = 0;
+    uint64_t arena_allocations = 0;
+    double last_wait_ms = 0;
+    double total_wait_ms = 0;
+    double max_wait_ms = 0;
+
+    void claim_arena(uint64_t bytes);
+    void trim_pool(uint64_t reserved_bytes);
+    void worker_loop();
+    void run_job(KdfJob &job);
+};
+
+static thread_local KdfExecutor *t_current_executor = nullptr;
+static thread_local uint8_t *t_claimed_arena = nullptr;
+static thread_local size_t t_claimed_size = 0;
+
+static int executor_allocate(uint8_t **memory, size_t bytes) {
+    if (t_claimed_arena && t_claimed_size == bytes) {
+        *memory = t_claimed_arena;
+        t_claimed_arena = nullptr;
+        t_claimed_size = 0;
+        return 0;
+    }
+    KdfExecutor *executor = t_current_executor;
+    if (executor) {
+        std::lock_guard<std::mutex> lock(executor->pool_mutex);
+        auto it = executor->pool.find(bytes);
+        if (it != executor->pool.end()) {
+            *memory = it->second;
+            executor->pool.erase(it);
+            executor->pooled -= bytes;
+            executor->arena_reuses++;
+            return 0;
+        }
+        executor->arena_allocations++;
+    }
+    *memory = static_cast<uint8_t *>(malloc(bytes));
+    return *memory ? 0 : -22;  // ARGON2_MEMORY_ALLOCATION_ERROR
+}
+
+// Argon2 sudah menghapus isi memory (clear_internal_memory) sebelum callback ini
+static void executor_free(uint8_t *memory, size_t bytes) {
+    KdfExecutor *executor = t_current_executor;
+    if (!executor) {
+        free(memory);
+        return;
+    }
+    std::lock_guard<std::mutex> lock(executor->pool_mutex);
+    executor->pool.emplace(bytes, memory);
+    executor->pooled += bytes;
+}
+
+// Ambil arena dengan ukuran sama dari pool sebelum trim, supaya tidak ikut dibuang
+void KdfExecutor::claim_arena(uint64_t bytes) {
+    std::lock_guard<std::mutex> lock(pool_mutex);
+    auto it = pool.find(bytes);
+    if (it == pool.end()) return;
+    t_claimed_arena = it->second;
+    t_claimed_size = it->first;
+    pooled -= it->first;
+    pool.erase(it);
+    arena_reuses++;
+}
+
+void KdfExecutor::trim_pool(uint64_t reserved_bytes) {
+    std::lock_guard<std::mutex> lock(pool_mutex);
+    // Reserved + pooled tidak boleh melewati budget, buang arena terbesar dulu
+    while (!pool.empty() && reserved_bytes + pooled > budget) {
+        auto it = std::prev(pool.end());
+        pooled -= it->first;
+        free(it->second);
+        pool.erase(it);
+    }
+}
+
+void KdfExecutor::run_job(KdfJob &job) {
+    job.hash.assign(job.hash.size(), 0);
+
+    argon2_context ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.out = job.hash.data();
+    ctx.outlen = static_cast<uint32_t>(job.hash.size());
+    ctx.pwd = job.pwd.data();
+    ctx.pwdlen = static_cast<uint32_t>(job.pwd.size());
+    ctx.salt = job.salt.data();
+    ctx.saltlen = static_cast<uint32_t>(job.salt.size());
+    ctx.t_cost = job.params.t_cost;
+    ctx.m_cost = job.params.m_cost;
+    ctx.lanes = job.params.parallelism;
+    ctx.threads = job.params.parallelism;
+    ctx.version = ARGON2_VERSION_13;
+    ctx.allocate_cbk = executor_allocate;
+    ctx.free_cbk = executor_free;
+    ctx.flags = ARGON2_DEFAULT_FLAGS;
+
+    const uint64_t started_ns = native_metrics_now_ns();
+    t_current_executor = this;
+    const int rc = argon2_ctx(&ctx, Argon2_id);
+    t_current_executor = nullptr;
+    native_metrics_record(NATIVE_METRICS_KDF, started_ns, job.reserve, rc == 0);
+
+    // Argon2 gagal sebelum alokasi: kembalikan arena yang sudah di-claim ke pool
+    if (t_claimed_arena) {
+        executor_free(t_claimed_arena, t_claimed_size);
+        t_claimed_arena = nullptr;
+        t_claimed_size = 0;
+    }
+
+    job.result = rc == 0 ? KDF_OK : KDF_ERROR_ARGON2;
+    secure_wipe(job.pwd);
+}
+
+void KdfExecutor::worker_loop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        // Admission: hanya kepala antrian yang boleh masuk agar job besar tidak kelaparan
+        work_cv.wait(lock, [this] {
+            if (stopping) return true;
+            if (queue.empty()) return false;
+            return reserved + queue.begin()->second->reserve <= budget;
+        });
+        if (stopping) return;
+
+        auto head = queue.begin();
+        std::shared_ptr<KdfJob> job = head->second;
+        queue.erase(head);
+
+        reserved += job->reserve;
+        running++;
+        job->state = JobState::Running;
+
+        const double wait_ms =
+            std::chrono::duration<double, std::milli>(Clock::now() - job->enqueued).count();
+        last_wait_ms = wait_ms;
+        total_wait_ms += wait_ms;
+        if (wait_ms > max_wait_ms) max_wait_ms = wait_ms;
+
+        const uint64_t reserved_now = reserved;
+        lock.unlock();
+
+        claim_arena(job->reserve);
+        trim_pool(reserved_now);
+        run_job(*job);
+
+        lock.lock();
+        reserved -= job->reserve;
+        running--;
+        completed++;
+        if (job->released) {
+            secure_wipe(job->hash);
+            job->result = KDF_ERROR_CANCELLED;
+        }
+        job->state = JobState::Done;
+        done_cv.notify_all();
+        work_cv.notify_all();
+    }
+}
+
+extern "C" KdfExecutor *kdf_executor_create(uint64_t memory_budget_bytes, uint32_t worker_threads, uint32_t max_queue) {
+    if (memory_budget_bytes == 0) return nullptr;
+    if (worker_threads == 0) {
+        worker_threads = std::thread::hardware_concurrency();
+        if (worker_threads == 0) worker_threads = 2;
+    }
+
+    KdfExecutor *executor = new KdfExecutor();
+    executor->budget = memory_budget_bytes;
+    executor->max_queue = max_queue;
+    for (uint32_t i = 0; i < worker_threads; i++) {
+        executor->workers.emplace_back([executor] { executor->worker_loop(); });
+    }
+    return executor;
+}
+
+extern "C" void kdf_executor_destroy(KdfExecutor *executor) {
+    if (!executor) return;
+    {
+        std::lock_guard<std::mutex> lock(executor->mutex);
+        executor->stopping = true;
+        for (auto &entry : executor->queue) {
+            entry.second->result = KDF_ERROR_SHUTDOWN;
+            entry.second->state = JobState::Done;
+            secure_wipe(entry.second->pwd);
+        }
+        executor->queue.clear();
+    }
+    executor->work_cv.notify_all();
+    executor->done_cv.notify_all();
+    for (auto &worker : executor->workers) {
+        worker.join();
+    }
+    {
+        // Semua job sudah Done; tunggu waiter yang terbangun selesai memakai mutex/cv
+        // sebelum executor di-free, lalu hapus hasil yang tidak pernah diambil
+        std::unique_lock<std::mutex> lock(executor->mutex);
+        executor->done_cv.notify_all();
+        executor->idle_cv.wait(lock, [executor] { return executor->waiters == 0; });
+        for (auto &entry : executor->jobs) {
+            secure_wipe(entry.second->pwd);
+            secure_wipe(entry.second->hash);
+        }
+        executor->jobs.clear();
+    }
+    executor->trim_pool(0);
+    {
+        std::lock_guard<std::mutex> lock(executor->pool_mutex);
+        for (auto &entry : executor->pool) {
+            free(entry.second);
+        }
+        executor->pool.clear();
+    }
+    delete executor;
+}
+
+extern "C" int64_t kdf_executor_submit(KdfExecutor *executor, const KdfParams *params,
+                                       const uint8_t *pwd, size_t pwdlen,
+                                       const uint8_t *salt, size_t saltlen,
+                                       size_t hashlen, int priority) {
+    if (!executor || !params || (!pwd && pwdlen) || !salt || hashlen == 0 ||
+        params->t_cost == 0 || params->parallelism == 0) {
+        return KDF_ERROR_INVALID_INPUT;
+    }
+
+    auto job = std::make_shared<KdfJob>();
+    job->params = *params;
+    job->pwd.assign(pwd, pwd + pwdlen);
+    job->salt.assign(salt, salt + saltlen);
+    job->hash.resize(hashlen);
+    job->reserve = argon2_memory_bytes(*params);
+    job->enqueued = Clock::now();
+
+    std::lock_guard<std::mutex> lock(executor->mutex);
+    if (executor->stopping) {
+        secure_wipe(job->pwd);
+        return KDF_ERROR_SHUTDOWN;
+    }
+    if (job->reserve > executor->budget) {
+        executor->rejected++;
+        secure_wipe(job->pwd);
+        return KDF_ERROR_OVER_BUDGET;
+    }
+    if (executor->max_queue && executor->queue.size() >= executor->max_queue) {
+        executor->rejected++;
+        secure_wipe(job->pwd);
+        return KDF_ERROR_QUEUE_FULL;
+    }
+
+    job->id = executor->next_id++;
+    executor->queue.emplace(std::make_pair(-priority, executor->next_seq++), job);
+    executor->jobs.emplace(job->id, job);
+    executor->work_cv.notify_one();
+    return job->id;
+}
+
+extern "C" int kdf_executor_wait(KdfExecutor *executor, int64_t job_id,
+                                 uint8_t *out, size_t outlen, int32_t timeout_ms) {
+    if (!executor) return KDF_ERROR_INVALID_INPUT;
+
+    std::unique_lock<std::mutex> lock(executor->mutex);
+    auto it = executor->jobs.find(job_id);
+    if (it == executor->jobs.end()) return KDF_ERROR_UNKNOWN_JOB;
+    std::shared_ptr<KdfJob> job = it->second;
+
+    // Dilepas sebelum lock dibuka (dideklarasikan setelah lock)
+    struct WaiterGuard {
+        KdfExecutor *executor;
+        explicit WaiterGuard(KdfExecutor *e) : executor(e) { executor->waiters++; }
+        ~WaiterGuard() {
+            if (--executor->waiters == 0 && executor->stopping) executor->idle_cv.notify_all();
+        }
+    } guard(executor);
+
+    auto done = [&job] { return job->state == JobState::Done; };
+    if (timeout_ms < 0) {
+        executor->done_cv.wait(lock, done);
+    } else if (!executor->done_cv.wait_for(lock, std::chrono::milliseconds(timeout_ms), done)) {
+        return KDF_PENDING;
+    }
+
+    executor->jobs.erase(job_id);
+    const int result = job->result;
+    if (result == KDF_OK) {
+        if (!out || outlen != job->hash.size()) {
+            secure_wipe(job->hash);
+            return KDF_ERROR_INVALID_INPUT;
+        }
+        memcpy(out, job->hash.data(), outlen);
+    }
+    secure_wipe(job->hash);
+    return result;
+}
+
+extern "C" int kdf_executor_release(KdfExecutor *executor, int64_t job_id) {
+    if (!executor) return KDF_ERROR_INVALID_INPUT;
+
+    std::lock_guard<std::mutex> lock(executor->mutex);
+    auto it = executor->jobs.find(job_id);
+    if (it == executor->jobs.end()) return KDF_ERROR_UNKNOWN_JOB;
+    std::shared_ptr<KdfJob> job = it->second;
+    executor->jobs.erase(it);
+
+    switch (job->state) {
+    case JobState::Queued:
+        for (auto q = executor->queue.begin(); q != executor->queue.end(); ++q) {
+            if (q->second == job) {
+                executor->queue.erase(q);
+                break;
+            }
+        }
+        secure_wipe(job->pwd);
+        secure_wipe(job->hash);
+        job->result = KDF_ERROR_CANCELLED;
+        job->state = JobState::Done;
+        // Kepala antrian mungkin berubah, worker perlu cek admission lagi
+        executor->work_cv.notify_all();
+        executor->done_cv.notify_all();
+        break;
+    case JobState::Running:
+        job->released = true;
+        break;
+    case JobState::Done:
+        secure_wipe(job->hash);
+        job->result = KDF_ERROR_CANCELLED;
+        break;
+    }
+    return KDF_OK;
+}
+
+extern "C" int kdf_executor_verify(KdfExecutor *executor, const KdfParams *params,
+                                   const uint8_t *pwd, size_t pwdlen,
+                                   const uint8_t *salt, size_t saltlen,
+                                   const uint8_t *expected, size_t expectedlen, int priority) {
+    if (!expected || expectedlen == 0) return KDF_ERROR_INVALID_INPUT;
+
+    const int64_t id = kdf_executor_submit(executor, params, pwd, pwdlen, salt, saltlen, expectedlen, priority);
+    if (id < 0) return static_cast<int>(id);
+
+    std::vector<uint8_t> hash(expectedlen);
+    const int rc = kdf_executor_wait(executor, id, hash.data(), hash.size(), -1);
+    if (rc != KDF_OK) return rc;
+
+    uint8_t diff = 0;
+    for (size_t i = 0; i < expectedlen; i++) {
+        diff |= hash[i] ^ expected[i];
+    }
+    secure_wipe(hash);
+    return diff == 0 ? 1 : 0;
+}
+
+extern "C" void kdf_executor_get_stats(KdfExecutor *executor, KdfExecutorStats *out) {
+    if (!executor || !out) return;
+
+    std::lock_guard<std::mutex> lock(executor->mutex);
+    out->queue_depth = static_cast<uint32_t>(executor->queue.size());
+    out->running = executor->running;
+    out->memory_budget = executor->budget;
+    out->memory_reserved = executor->reserved;
+    out->completed = executor->completed;
+    out->rejected = executor->rejected;
+    out->last_wait_ms = executor->last_wait_ms;
+    out->avg_wait_ms = executor->completed + executor->running
+                           ? executor->total_wait_ms / (double)(executor->completed + executor->running)
+                           : 0.0;
+    out->max_wait_ms = executor->max_wait_ms;
+
+    std::lock_guard<std::mutex> pool_lock(executor->pool_mutex);
+    out->memory_pooled = executor->pooled;
+    out->arena_reuses = executor->arena_reuses;
+    out->arena_allocations = executor->arena_allocations;
+}
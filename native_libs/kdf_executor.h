@@ -0,0 +1,90 @@
+#ifndef KDF_EXECUTOR_H
+#define KDF_EXECUTOR_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Status code executor (0 = OK, negatif = error, sama seperti konvensi Argon2)
+#define KDF_OK 0
+#define KDF_PENDING 1
+#define KDF_ERROR_INVALID_INPUT -1
+#define KDF_ERROR_OVER_BUDGET -2
+#define KDF_ERROR_QUEUE_FULL -3
+#define KDF_ERROR_UNKNOWN_JOB -4
+#define KDF_ERROR_SHUTDOWN -5
+#define KDF_ERROR_ARGON2 -6
+#define KDF_ERROR_CANCELLED -7
+
+// Prioritas job: login interaktif didahulukan dari verifikasi background
+#define KDF_PRIORITY_BACKGROUND 0
+#define KDF_PRIORITY_NORMAL 1
+#define KDF_PRIORITY_INTERACTIVE 2
+
+typedef struct KdfExecutor KdfExecutor;
+
+typedef struct {
+    uint32_t t_cost;
+    uint32_t m_cost;       // dalam KiB, sama seperti argon2id_hash_raw
+    uint32_t parallelism;
+} KdfParams;
+
+typedef struct {
+    uint32_t queue_depth;
+    uint32_t running;
+    uint64_t memory_budget;
+    uint64_t memory_reserved;
+    uint64_t memory_pooled;
+    uint64_t completed;
+    uint64_t rejected;
+    uint64_t arena_reuses;
+    uint64_t arena_allocations;
+    double last_wait_ms;
+    double avg_wait_ms;
+    double max_wait_ms;
+} KdfExecutorStats;
+
+// memory_budget_bytes = batas total memory Argon2 yang boleh aktif bersamaan.
+// max_queue = 0 berarti antrian tidak dibatasi.
+KdfExecutor *kdf_executor_create(uint64_t memory_budget_bytes, uint32_t worker_threads, uint32_t max_queue);
+
+// Job di antrian dibatalkan (KDF_ERROR_SHUTDOWN), job yang berjalan ditunggu selesai, dan
+// destroy menunggu semua kdf_executor_wait yang sedang berjalan kembali sebelum free.
+// Jangan memanggil kdf_executor_wait baru setelah destroy dimulai.
+void kdf_executor_destroy(KdfExecutor *executor);
+
+// Masukkan job Argon2id ke antrian. Return job id (> 0) atau status error (< 0).
+// Password dan salt di-copy, buffer caller boleh langsung dibersihkan.
+int64_t kdf_executor_submit(KdfExecutor *executor, const KdfParams *params,
+                            const uint8_t *pwd, size_t pwdlen,
+                            const uint8_t *salt, size_t saltlen,
+                            size_t hashlen, int priority);
+
+// Tunggu job selesai (timeout_ms < 0 = tunggu terus, 0 = poll).
+// Return KDF_OK dan hash ditulis ke out, KDF_PENDING jika belum selesai, atau error.
+// Hasil hanya bisa diambil sekali; setelah itu job id tidak dikenal lagi.
+int kdf_executor_wait(KdfExecutor *executor, int64_t job_id,
+                      uint8_t *out, size_t outlen, int32_t timeout_ms);
+
+// Lepas job yang hasilnya tidak akan diambil (mis. wait timeout lalu layar ditutup).
+// Job di antrian dibatalkan, job yang berjalan dibuang begitu selesai, hash job yang
+// sudah selesai dihapus. Wait yang sedang menunggu job ini mendapat KDF_ERROR_CANCELLED.
+// Return KDF_OK atau KDF_ERROR_UNKNOWN_JOB.
+int kdf_executor_release(KdfExecutor *executor, int64_t job_id);
+
+// Hash + bandingkan constant-time dengan expected. Return 1 cocok, 0 tidak cocok, < 0 error.
+int kdf_executor_verify(KdfExecutor *executor, const KdfParams *params,
+                        const uint8_t *pwd, size_t pwdlen,
+                        const uint8_t *salt, size_t saltlen,
+                        const uint8_t *expected, size_t expectedlen, int priority);
+
+void kdf_executor_get_stats(KdfExecutor *executor, KdfExecutorStats *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,207 @@
+#include "keystream_pool.h"
+#include "chacha20_poly1305.h"
+#include "message_aead.h"
+#include "native_metrics.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif !defined(__EMSCRIPTEN__)
+#include <sys/mman.h>
+#endif
+
+namespace {
+
+// Blok counter 0: 32 byte pertama = one-time key Poly1305, sisanya dibuang (RFC 8439)
+constexpr size_t kOtkBlockBytes = CHACHA20_BLOCK_BYTES;
+
+enum SlotState : uint8_t {
+    SLOT_EMPTY = 0,
+    SLOT_FILLING,
+    SLOT_READY,
+    SLOT_IN_USE,
+};
+
+void secure_wipe(void *p, size_t len) {
+    volatile uint8_t *v = static_cast<volatile uint8_t *>(p);
+    for (size_t i = 0; i < len; i++) {
+        v[i] = 0;
+    }
+}
+
+// Memory anonim yang dikunci di RAM; locked = false jika OS menolak (RLIMIT_MEMLOCK dsb)
+uint8_t *locked_alloc(size_t size, bool *locked) {
+    *locked = false;
+#if defined(_WIN32)
+    void *p = VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+    if (!p) return nullptr;
+    *locked = VirtualLock(p, size) != 0;
+    return static_cast<uint8_t *>(p);
+#elif defined(__EMSCRIPTEN__)
+    return static_cast<uint8_t *>(calloc(1, size));
+#else
+    void *p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) return nullptr;
+    *locked = mlock(p, size) == 0;
+#if defined(MADV_DONTDUMP)
+    madvise(p, size, MADV_DONTDUMP);
+#endif
+    return static_cast<uint8_t *>(p);
+#endif
+}
+
+void locked_free(uint8_t *p, size_t size, bool locked) {
+    if (!p) return;
+    secure_wipe(p, size);
+#if defined(_WIN32)
+    if (locked) VirtualUnlock(p, size);
+    VirtualFree(p, 0, MEM_RELEASE);
+#elif defined(__EMSCRIPTEN__)
+    (void)locked;
+    free(p);
+#else
+    if (locked) munlock(p, size);
+    munmap(p, size);
+#endif
+}
+
+}  // namespace
+
+struct KeystreamPool {
+    std::mutex mutex;
+    uint32_t slot_count = 0;
+    uint32_t slot_bytes = 0;     // plaintext maksimal per slot
+    size_t slot_stride = 0;      // blok otk + keystream
+    uint32_t ready = 0;
+
+    // Region terkunci: key 32 byte lalu slot_count * slot_stride
+    uint8_t *memory = nullptr;
+    size_t memory_size = 0;
+    bool locked = false;
+
+    uint8_t nonces[KEYSTREAM_POOL_MAX_SLOTS][KEYSTREAM_POOL_NONCE_BYTES];
+    SlotState states[KEYSTREAM_POOL_MAX_SLOTS];
+
+    const uint8_t *key() const { return memory; }
+    uint8_t *slot(uint32_t index) { return memory + CHACHA20_KEY_BYTES + index * slot_stride; }
+
+    // Dipanggil dengan mutex dipegang
+    int find(SlotState state) const {
+        for (uint32_t i = 0; i < slot_count; i++) {
+            if (states[i] == state) return (int)i;
+        }
+        return -1;
+    }
+};
+
+extern "C" KeystreamPool *keystream_pool_create(const uint8_t key[32], uint32_t slots, uint32_t slot_bytes) {
+    if (!key || slots == 0 || slots > KEYSTREAM_POOL_MAX_SLOTS) return nullptr;
+    if (slot_bytes == 0 || slot_bytes > KEYSTREAM_POOL_MAX_SLOT_BYTES) return nullptr;
+
+    auto *pool = new (std::nothrow) KeystreamPool();
+    if (!pool) return nullptr;
+    pool->slot_count = slots;
+    pool->slot_bytes = (slot_bytes + CHACHA20_BLOCK_BYTES - 1) & ~(uint32_t)(CHACHA20_BLOCK_BYTES - 1);
+    pool->slot_stride = kOtkBlockBytes + pool->slot_bytes;
+    pool->memory_size = CHACHA20_KEY_BYTES + slots * pool->slot_stride;
+    pool->memory = locked_alloc(pool->memory_size, &pool->locked);
+    if (!pool->memory) {
+        delete pool;
+        return nullptr;
+    }
+    // Slot harus bisa dibuka message_aead_open, jadi keystream memakai subkey ChaCha20-nya
+    message_aead_derive_key(MESSAGE_AEAD_CHACHA20_POLY1305, key, pool->memory);
+    memset(pool->nonces, 0, sizeof(pool->nonces));
+    memset(pool->states, SLOT_EMPTY, sizeof(pool->states));
+    return pool;
+}
+
+extern "C" void keystream_pool_destroy(KeystreamPool *pool) {
+    if (!pool) return;
+    {
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        locked_free(pool->memory, pool->memory_size, pool->locked);
+        pool->memory = nullptr;
+    }
+    delete pool;
+}
+
+extern "C" uint32_t keystream_pool_refill(KeystreamPool *pool, const uint8_t *nonces, uint32_t count) {
+    if (!pool || !nonces) return 0;
+
+    uint32_t filled = 0;
+    for (uint32_t n = 0; n < count; n++) {
+        int index;
+        {
+            std::lock_guard<std::mutex> lock(pool->mutex);
+            index = pool->find(SLOT_EMPTY);
+            if (index < 0) break;
+            pool->states[index] = SLOT_FILLING;
+            memcpy(pool->nonces[index], nonces + n * KEYSTREAM_POOL_NONCE_BYTES, KEYSTREAM_POOL_NONCE_BYTES);
+        }
+
+        // Keystream mulai counter 0 di atas buffer nol: blok pertama jadi otk
+        uint8_t *slot = pool->slot(index);
+        memset(slot, 0, pool->slot_stride);
+        chacha20_xor(slot, slot, pool->slot_stride, pool->key(), pool->nonces[index], 0);
+
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        pool->states[index] = SLOT_READY;
+        pool->ready++;
+        filled++;
+    }
+    return filled;
+}
+
+extern "C" uint32_t keystream_pool_ready(KeystreamPool *pool) {
+    if (!pool) return 0;
+    std::lock_guard<std::mutex> lock(pool->mutex);
+    return pool->ready;
+}
+
+extern "C" int keystream_pool_locked(KeystreamPool *pool) {
+    return pool && pool->locked ? 1 : 0;
+}
+
+extern "C" int keystream_pool_seal(KeystreamPool *pool,
+                                   uint8_t *ciphertext, uint8_t tag[KEYSTREAM_POOL_TAG_BYTES],
+                                   uint8_t nonce_out[KEYSTREAM_POOL_NONCE_BYTES],
+                                   const uint8_t *plaintext, size_t plaintext_len,
+                                   const uint8_t *aad, size_t aad_len) {
+    if (!pool || !tag || !nonce_out || (plaintext_len && (!plaintext || !ciphertext)) || (aad_len && !aad)) {
+        return KEYSTREAM_POOL_ERROR_INVALID_INPUT;
+    }
+    if (plaintext_len > pool->slot_bytes) return KEYSTREAM_POOL_ERROR_TOO_LONG;
+
+    const uint64_t started_ns = native_metrics_now_ns();
+    int index;
+    {
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        index = pool->find(SLOT_READY);
+        if (index < 0) return KEYSTREAM_POOL_ERROR_EMPTY;
+        pool->states[index] = SLOT_IN_USE;
+        pool->ready--;
+    }
+
+    uint8_t *slot = pool->slot(index);
+    const uint8_t *keystream = slot + kOtkBlockBytes;
+    for (size_t i = 0; i < plaintext_len; i++) {
+        ciphertext[i] = plaintext[i] ^ keystream[i];
+    }
+    chacha20_poly1305_tag(tag, slot, aad, aad_len, ciphertext, plaintext_len);
+    memcpy(nonce_out, pool->nonces[index], KEYSTREAM_POOL_NONCE_BYTES);
+
+    // Sekali pakai: slot dihapus sebelum bisa diisi ulang dengan nonce baru
+    secure_wipe(slot, pool->slot_stride);
+    {
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        memset(pool->nonces[index], 0, KEYSTREAM_POOL_NONCE_BYTES);
+        pool->states[index] = SLOT_EMPTY;
+    }
+    native_metrics_record(NATIVE_METRICS_CIPHER, started_ns, plaintext_len, 1);
+    return KEYSTREAM_POOL_OK;
+}
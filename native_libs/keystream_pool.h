@@ -0,0 +1,63 @@
+#ifndef KEYSTREAM_POOL_H
+#define KEYSTREAM_POOL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Pool keystream ChaCha20-Poly1305 per key pesan (subkey dari message_aead_derive_key)
+// yang diisi saat idle. Setiap slot berisi
+// nonce 12 byte, one-time key Poly1305 (blok counter 0) dan keystream mulai counter 1,
+// jadi seal saat kirim hanya XOR + Poly1305. Output identik dengan
+// message_aead_seal(MESSAGE_AEAD_CHACHA20_POLY1305, ...) dengan nonce slot, sehingga
+// penerima membuka lewat message_aead_open seperti biasa.
+//
+// Slot sekali pakai: diambil di bawah lock, dihapus (wipe) setelah seal, dan tidak
+// pernah dikembalikan ke status siap tanpa nonce baru dari refill. Memory slot dikunci
+// (mlock/VirtualLock) sebisanya agar keystream tidak ter-swap ke disk.
+//
+// Nonce disuplai pemanggil saat refill (Random.secure di Dart), bukan saat kirim.
+
+#define KEYSTREAM_POOL_NONCE_BYTES 12
+#define KEYSTREAM_POOL_TAG_BYTES 16
+#define KEYSTREAM_POOL_MAX_SLOTS 64
+#define KEYSTREAM_POOL_MAX_SLOT_BYTES 4096
+
+#define KEYSTREAM_POOL_OK 0
+#define KEYSTREAM_POOL_ERROR_INVALID_INPUT -1
+#define KEYSTREAM_POOL_ERROR_EMPTY -2
+#define KEYSTREAM_POOL_ERROR_TOO_LONG -3
+
+typedef struct KeystreamPool KeystreamPool;
+
+// slots <= KEYSTREAM_POOL_MAX_SLOTS, slot_bytes = panjang plaintext maksimal per slot
+// (dibulatkan ke kelipatan 64, maksimal KEYSTREAM_POOL_MAX_SLOT_BYTES).
+KeystreamPool *keystream_pool_create(const uint8_t key[32], uint32_t slots, uint32_t slot_bytes);
+// Wipe key dan seluruh slot, lalu unlock dan bebaskan memory.
+void keystream_pool_destroy(KeystreamPool *pool);
+
+// Isi slot kosong memakai nonce berurutan dari nonces (count * 12 byte).
+// Return jumlah slot yang diisi. Aman dipanggil dari thread lain selama seal berjalan.
+uint32_t keystream_pool_refill(KeystreamPool *pool, const uint8_t *nonces, uint32_t count);
+// Jumlah slot siap pakai
+uint32_t keystream_pool_ready(KeystreamPool *pool);
+// 1 jika memory slot berhasil dikunci
+int keystream_pool_locked(KeystreamPool *pool);
+
+// ciphertext = plaintext_len byte, tag 16 byte, nonce slot ditulis ke nonce_out.
+// EMPTY jika tidak ada slot siap, TOO_LONG jika plaintext melebihi slot_bytes;
+// pemanggil lalu fallback ke message_aead_seal.
+int keystream_pool_seal(KeystreamPool *pool,
+                        uint8_t *ciphertext, uint8_t tag[KEYSTREAM_POOL_TAG_BYTES],
+                        uint8_t nonce_out[KEYSTREAM_POOL_NONCE_BYTES],
+                        const uint8_t *plaintext, size_t plaintext_len,
+                        const uint8_t *aad, size_t aad_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,387 @@
+#include "lazy_decrypt.h"
+#include "legacy_formats.h"
+#include "message_aead.h"
+#include "message_record.h"
+#include "native_metrics.h"
+#include "spsc_ring.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+enum class RowState : uint8_t { Empty, Working, Ready, Failed };
+
+struct Row {
+    std::vector<uint8_t> ciphertext;   // record utuh jika is_record
+    std::vector<uint8_t> iv;
+    std::vector<uint8_t> plaintext;
+    RowState state = RowState::Empty;
+    bool is_record = false;
+};
+
+void secure_wipe(std::vector<uint8_t> &buffer) {
+    volatile uint8_t *p = buffer.data();
+    for (size_t i = 0; i < buffer.size(); i++) {
+        p[i] = 0;
+    }
+    buffer.clear();
+    buffer.shrink_to_fit();
+}
+
+}  // namespace
+
+struct LazyDecryptSession {
+    std::mutex mutex;
+    std::condition_variable work_cv;
+    std::condition_variable ready_cv;
+    std::vector<std::thread> workers;
+    bool stopping = false;
+
+    std::vector<uint8_t> key;
+    std::vector<uint8_t> aead_key;  // hanya diset sebelum row pertama, jadi aman dibaca tanpa lock
+    // deque: referensi row tetap valid saat register menambah row baru
+    std::deque<Row> rows;
+
+    std::vector<uint32_t> work;  // urutan prioritas untuk viewport sekarang
+    size_t cursor = 0;
+
+    uint32_t prefetch_rows = 64;
+    uint64_t cache_budget = 8u * 1024 * 1024;
+    uint64_t cached_bytes = 0;
+
+    uint32_t first_visible = 0;
+    uint32_t last_visible = 0;
+    int32_t direction = 1;
+    bool has_range = false;
+
+    uint32_t ready = 0;
+    uint32_t failed = 0;
+    uint64_t inline_decrypts = 0;
+    uint64_t prefetched = 0;
+    uint64_t prefetch_hits = 0;
+    uint64_t evicted = 0;
+
+    // Plaintext hasil prefetch didorong ke Dart lewat ring; mutex session menjadikan
+    // worker-worker satu producer
+    SpscRing *ring = nullptr;
+    bool ring_dirty = false;
+    uint64_t ring_pushed = 0;
+
+    void worker_loop();
+    // Dipanggil tanpa lock; row harus sudah ditandai Working oleh pemanggil
+    void decrypt_row(Row &row, std::unique_lock<std::mutex> &lock);
+    void rebuild_work_locked();
+    void evict_locked();
+};
+
+void LazyDecryptSession::decrypt_row(Row &row, std::unique_lock<std::mutex> &lock) {
+    lock.unlock();
+    std::vector<uint8_t> plain(row.ciphertext.size());
+    bool ok = false;
+    if (row.is_record) {
+        // message_record_decrypt_all mencatat metrics sendiri
+        MessageRecordPlain result;
+        ok = message_record_decrypt_all(row.ciphertext.data(), row.ciphertext.size(), key.data(), key.size(),
+                                        aead_key.empty() ? nullptr : aead_key.data(), plain.data(), plain.size(),
+                                        &result, 1) == 1 &&
+             legacy_utf8_valid(result.text, result.text_len);
+        if (ok) plain.resize(result.text_len);
+    } else {
+        const uint64_t started_ns = native_metrics_now_ns();
+        ok = legacy_xor_with_iv_decrypt(plain.data(), row.ciphertext.data(), row.ciphertext.size(), key.data(),
+                                        key.size(), row.iv.data(), row.iv.size()) == LEGACY_OK;
+        native_metrics_record(NATIVE_METRICS_CIPHER, started_ns, row.ciphertext.size(), ok);
+    }
+    lock.lock();
+
+    if (ok) {
+        row.plaintext = std::move(plain);
+        row.state = RowState::Ready;
+        cached_bytes += row.plaintext.size();
+        ready++;
+    } else {
+        secure_wipe(plain);
+        row.state = RowState::Failed;
+        failed++;
+    }
+    ready_cv.notify_all();
+}
+
+void LazyDecryptSession::worker_loop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        // Antrian habis = batas batch: publikasikan semua row yang sudah didorong sekaligus
+        if (ring_dirty && cursor >= work.size()) {
+            spsc_ring_flush(ring);
+            ring_dirty = false;
+        }
+        work_cv.wait(lock, [this] { return stopping || cursor < work.size(); });
+        if (stopping) return;
+
+        const uint32_t index = work[cursor++];
+        if (index >= rows.size()) continue;
+        Row &row = rows[index];
+        if (row.state != RowState::Empty) continue;
+
+        row.state = RowState::Working;
+        decrypt_row(row, lock);
+        prefetched++;
+
+        // Ring penuh / row terlalu besar: Dart tetap bisa mengambil lewat lazy_decrypt_get
+        if (ring && row.state == RowState::Ready && row.plaintext.size() <= UINT32_MAX &&
+            spsc_ring_write(ring, index, row.plaintext.data(), static_cast<uint32_t>(row.plaintext.size()), 0) ==
+                SPSC_RING_OK) {
+            ring_dirty = true;
+            ring_pushed++;
+        } else if (ring && row.state == RowState::Failed && index < LAZY_DECRYPT_RING_FAILED_TAG &&
+                   spsc_ring_write(ring, index | LAZY_DECRYPT_RING_FAILED_TAG, nullptr, 0, 0) == SPSC_RING_OK) {
+            ring_dirty = true;
+        }
+
+        if (cached_bytes > cache_budget) {
+            evict_locked();
+        }
+    }
+}
+
+void LazyDecryptSession::rebuild_work_locked() {
+    work.clear();
+    cursor = 0;
+    const uint32_t count = static_cast<uint32_t>(rows.size());
+    if (count == 0 || !has_range) return;
+
+    const uint32_t first = std::min(first_visible, count - 1);
+    const uint32_t last = std::min(last_visible, count - 1);
+    for (uint32_t i = first; i <= last; i++) {
+        work.push_back(i);
+    }
+
+    // Prefetch penuh ke arah scroll, seperempat ke arah sebaliknya
+    const uint32_t behind = prefetch_rows / 4;
+    const uint32_t ahead_up = direction >= 0 ? prefetch_rows : behind;
+    const uint32_t ahead_down = direction >= 0 ? behind : prefetch_rows;
+    const uint32_t reach = std::max(ahead_up, ahead_down);
+    for (uint32_t step = 1; step <= reach; step++) {
+        if (step <= ahead_up && last + step < count) work.push_back(last + step);
+        if (step <= ahead_down && first >= step) work.push_back(first - step);
+    }
+}
+
+// Buang plaintext yang paling jauh dari viewport sampai cache kembali di bawah budget
+void LazyDecryptSession::evict_locked() {
+    const int64_t keep_low = static_cast<int64_t>(first_visible) - prefetch_rows;
+    const int64_t keep_high = static_cast<int64_t>(last_visible) + prefetch_rows;
+
+    std::vector<std::pair<int64_t, uint32_t>> candidates;
+    for (uint32_t i = 0; i < rows.size(); i++) {
+        if (rows[i].state != RowState::Ready) continue;
+        const int64_t distance = i < keep_low ? keep_low - i : (i > keep_high ? i - keep_high : 0);
+        if (distance > 0) candidates.emplace_back(distance, i);
+    }
+    std::sort(candidates.begin(), candidates.end(),
+              [](const std::pair<int64_t, uint32_t> &a, const std::pair<int64_t, uint32_t> &b) { return a.first > b.first; });
+
+    for (const auto &candidate : candidates) {
+        if (cached_bytes <= cache_budget) break;
+        Row &row = rows[candidate.second];
+        cached_bytes -= row.plaintext.size();
+        secure_wipe(row.plaintext);
+        row.state = RowState::Empty;
+        ready--;
+        evicted++;
+    }
+}
+
+extern "C" LazyDecryptSession *lazy_decrypt_create(const uint8_t *key, size_t keylen, uint32_t worker_threads,
+                                                   uint32_t prefetch_rows, uint64_t cache_budget_bytes) {
+    if (!key || keylen == 0) return nullptr;
+
+    LazyDecryptSession *session = new LazyDecryptSession();
+    session->key.assign(key, key + keylen);
+    if (prefetch_rows) session->prefetch_rows = prefetch_rows;
+    if (cache_budget_bytes) session->cache_budget = cache_budget_bytes;
+
+    if (worker_threads == 0) {
+        // Prefetch tidak boleh bersaing dengan UI thread: cukup sebagian kecil core
+        const uint32_t cores = std::thread::hardware_concurrency();
+        worker_threads = cores > 4 ? 2 : 1;
+    }
+    for (uint32_t i = 0; i < worker_threads; i++) {
+        session->workers.emplace_back([session] { session->worker_loop(); });
+    }
+    return session;
+}
+
+extern "C" void lazy_decrypt_destroy(LazyDecryptSession *session) {
+    if (!session) return;
+    {
+        std::lock_guard<std::mutex> lock(session->mutex);
+        session->stopping = true;
+    }
+    session->work_cv.notify_all();
+    session->ready_cv.notify_all();
+    for (auto &worker : session->workers) {
+        worker.join();
+    }
+    for (auto &row : session->rows) {
+        secure_wipe(row.plaintext);
+    }
+    secure_wipe(session->key);
+    secure_wipe(session->aead_key);
+    delete session;
+}
+
+extern "C" int lazy_decrypt_attach_ring(LazyDecryptSession *session, SpscRing *ring) {
+    if (!session) return LAZY_DECRYPT_ERROR_INVALID_INPUT;
+    std::lock_guard<std::mutex> lock(session->mutex);
+    if (session->ring && session->ring_dirty) spsc_ring_flush(session->ring);
+    session->ring = ring;
+    session->ring_dirty = false;
+    return LAZY_DECRYPT_READY;
+}
+
+extern "C" int64_t lazy_decrypt_register(LazyDecryptSession *session,
+                                         const uint8_t *ciphertext, size_t len,
+                                         const uint8_t *iv, size_t ivlen) {
+    if (!session || (!ciphertext && len) || !iv || ivlen == 0) {
+        return LAZY_DECRYPT_ERROR_INVALID_INPUT;
+    }
+
+    Row row;
+    row.ciphertext.assign(ciphertext, ciphertext + len);
+    row.iv.assign(iv, iv + ivlen);
+
+    std::lock_guard<std::mutex> lock(session->mutex);
+    session->rows.push_back(std::move(row));
+    const uint32_t index = static_cast<uint32_t>(session->rows.size() - 1);
+
+    // Pesan baru yang masuk di dalam jangkauan prefetch langsung ikut antrian
+    if (session->has_range && index <= session->last_visible + session->prefetch_rows) {
+        session->work.push_back(index);
+        session->work_cv.notify_one();
+    }
+    return index;
+}
+
+extern "C" int lazy_decrypt_set_aead_key(LazyDecryptSession *session, const uint8_t *key, size_t keylen) {
+    if (!session || !key || keylen != MESSAGE_AEAD_KEY_BYTES) return LAZY_DECRYPT_ERROR_INVALID_INPUT;
+    std::lock_guard<std::mutex> lock(session->mutex);
+    if (!session->rows.empty()) return LAZY_DECRYPT_ERROR_INVALID_INPUT;
+    session->aead_key.assign(key, key + keylen);
+    return LAZY_DECRYPT_READY;
+}
+
+extern "C" int64_t lazy_decrypt_register_records(LazyDecryptSession *session, const uint8_t *buffer, size_t len) {
+    if (!session || (!buffer && len)) return LAZY_DECRYPT_ERROR_INVALID_INPUT;
+    const int32_t count = message_record_index(buffer, len, nullptr, 0);
+    if (count < 0) return LAZY_DECRYPT_ERROR_INVALID_INPUT;
+
+    std::vector<MessageRecordView> views(count);
+    message_record_index(buffer, len, views.data(), static_cast<uint32_t>(count));
+
+    std::lock_guard<std::mutex> lock(session->mutex);
+    const uint32_t first = static_cast<uint32_t>(session->rows.size());
+    for (const MessageRecordView &view : views) {
+        const uint8_t *start = reinterpret_cast<const uint8_t *>(view.header);
+        Row &row = session->rows.emplace_back();
+        row.ciphertext.assign(start, start + view.header->record_len);
+        row.is_record = true;
+    }
+
+    // Sama dengan register: row baru di dalam jangkauan prefetch langsung ikut antrian
+    if (session->has_range) {
+        const uint64_t reach = static_cast<uint64_t>(session->last_visible) + session->prefetch_rows;
+        for (uint32_t index = first; index < session->rows.size() && index <= reach; index++) {
+            session->work.push_back(index);
+        }
+        session->work_cv.notify_all();
+    }
+    return first;
+}
+
+extern "C" int lazy_decrypt_request_range(LazyDecryptSession *session, uint32_t first, uint32_t last) {
+    if (!session || first > last) return LAZY_DECRYPT_ERROR_INVALID_INPUT;
+
+    std::lock_guard<std::mutex> lock(session->mutex);
+    if (session->has_range) {
+        if (first > session->first_visible || last > session->last_visible) {
+            session->direction = 1;
+        } else if (first < session->first_visible || last < session->last_visible) {
+            session->direction = -1;
+        }
+    }
+    session->first_visible = first;
+    session->last_visible = last;
+    session->has_range = true;
+
+    session->rebuild_work_locked();
+    if (session->cached_bytes > session->cache_budget) {
+        session->evict_locked();
+    }
+    session->work_cv.notify_all();
+    return LAZY_DECRYPT_READY;
+}
+
+extern "C" int lazy_decrypt_get(LazyDecryptSession *session, uint32_t index,
+                                uint8_t *out, size_t capacity, size_t *outlen, int wait) {
+    if (!session || !outlen) return LAZY_DECRYPT_ERROR_INVALID_INPUT;
+
+    std::unique_lock<std::mutex> lock(session->mutex);
+    if (index >= session->rows.size()) return LAZY_DECRYPT_ERROR_INVALID_INPUT;
+    Row &row = session->rows[index];
+
+    if (row.state == RowState::Ready) {
+        session->prefetch_hits++;
+    } else if (wait) {
+        if (row.state == RowState::Working) {
+            session->ready_cv.wait(lock, [&row, session] {
+                return session->stopping || row.state != RowState::Working;
+            });
+        }
+        if (row.state == RowState::Empty) {
+            // Prefetch belum sampai ke row ini: decrypt langsung di thread pemanggil
+            row.state = RowState::Working;
+            session->decrypt_row(row, lock);
+            session->inline_decrypts++;
+        }
+    }
+
+    // Sebelum Ready panjang ciphertext (record) menjadi batas atas plaintext
+    *outlen = row.ciphertext.size();
+    switch (row.state) {
+    case RowState::Ready:
+        *outlen = row.plaintext.size();
+        if (!out || capacity < row.plaintext.size()) return LAZY_DECRYPT_ERROR_BUFFER_TOO_SMALL;
+        memcpy(out, row.plaintext.data(), row.plaintext.size());
+        return LAZY_DECRYPT_READY;
+    case RowState::Failed:
+        return LAZY_DECRYPT_ERROR_DECRYPT;
+    default:
+        return LAZY_DECRYPT_PENDING;
+    }
+}
+
+extern "C" void lazy_decrypt_get_stats(LazyDecryptSession *session, LazyDecryptStats *out) {
+    if (!session || !out) return;
+    std::lock_guard<std::mutex> lock(session->mutex);
+    memset(out, 0, sizeof(*out));
+    out->rows = static_cast<uint32_t>(session->rows.size());
+    out->ready = session->ready;
+    out->failed = session->failed;
+    out->first_visible = session->first_visible;
+    out->last_visible = session->last_visible;
+    out->direction = session->direction;
+    out->cached_bytes = session->cached_bytes;
+    out->inline_decrypts = session->inline_decrypts;
+    out->prefetched = session->prefetched;
+    out->prefetch_hits = session->prefetch_hits;
+    out->evicted = session->evicted;
+    out->ring_pushed = session->ring_pushed;
+}
@@ -0,0 +1,85 @@
+#ifndef LAZY_DECRYPT_H
+#define LAZY_DECRYPT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "spsc_ring.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Dekripsi history chat secara lazy: Dart mendaftarkan semua ciphertext (xor_with_iv, atau
+// record message_record.h campuran xor_with_iv/AEAD), lalu melaporkan range index yang terlihat. Range itu didecrypt lebih dulu, kemudian
+// worker background mem-prefetch ke arah scroll. Plaintext yang jauh dari viewport
+// dibuang (di-wipe) jika cache melewati budget.
+
+#define LAZY_DECRYPT_READY 0
+#define LAZY_DECRYPT_PENDING 1
+#define LAZY_DECRYPT_ERROR_INVALID_INPUT -1
+#define LAZY_DECRYPT_ERROR_DECRYPT -2
+#define LAZY_DECRYPT_ERROR_BUFFER_TOO_SMALL -3
+
+// Bit tag record ring untuk row prefetch yang gagal didecrypt (payload kosong)
+#define LAZY_DECRYPT_RING_FAILED_TAG 0x80000000u
+
+typedef struct LazyDecryptSession LazyDecryptSession;
+
+typedef struct {
+    uint32_t rows;
+    uint32_t ready;
+    uint32_t failed;
+    uint32_t first_visible;
+    uint32_t last_visible;
+    int32_t direction;               // 1 = scroll ke index besar, -1 = ke index kecil
+    uint64_t cached_bytes;
+    uint64_t inline_decrypts;        // get() yang harus decrypt sendiri (prefetch terlambat)
+    uint64_t prefetched;             // row yang didecrypt worker background
+    uint64_t prefetch_hits;          // get() yang langsung READY
+    uint64_t evicted;
+    uint64_t ring_pushed;            // row prefetch yang dikirim ke Dart lewat SpscRing
+} LazyDecryptStats;
+
+// key = chat key hasil base64 decode. prefetch_rows = jumlah row di depan viewport yang
+// disiapkan (0 = 64), cache_budget_bytes = batas plaintext di memory (0 = 8 MiB).
+LazyDecryptSession *lazy_decrypt_create(const uint8_t *key, size_t keylen, uint32_t worker_threads,
+                                        uint32_t prefetch_rows, uint64_t cache_budget_bytes);
+void lazy_decrypt_destroy(LazyDecryptSession *session);
+
+// Data di-copy. Return index row (>= 0) atau error.
+int64_t lazy_decrypt_register(LazyDecryptSession *session,
+                              const uint8_t *ciphertext, size_t len,
+                              const uint8_t *iv, size_t ivlen);
+
+// Key AEAD 32 byte untuk row record ber-algoritma AEAD. Harus dipanggil sebelum row
+// pertama didaftarkan; tanpa key row AEAD selalu gagal.
+int lazy_decrypt_set_aead_key(LazyDecryptSession *session, const uint8_t *key, size_t keylen);
+
+// Daftarkan setiap record dalam buffer message_record.h sebagai satu row, berurutan.
+// Data di-copy. Return index row record pertama (record ke-i = index + i), atau error
+// (buffer tidak valid = INVALID_INPUT).
+int64_t lazy_decrypt_register_records(LazyDecryptSession *session, const uint8_t *buffer, size_t len);
+
+// Range terlihat (inklusif). Menyusun ulang antrian: visible, lalu ke depan sesuai arah scroll,
+// lalu sedikit ke belakang.
+int lazy_decrypt_request_range(LazyDecryptSession *session, uint32_t first, uint32_t last);
+
+// Salin plaintext row ke out. wait != 0: jika belum siap, tunggu worker atau decrypt langsung.
+// *outlen selalu diisi panjang plaintext (juga saat BUFFER_TOO_SMALL).
+int lazy_decrypt_get(LazyDecryptSession *session, uint32_t index,
+                     uint8_t *out, size_t capacity, size_t *outlen, int wait);
+
+// Opsional: plaintext hasil prefetch juga ditulis ke ring (tag = index row) dan dipublikasikan
+// setiap antrian prefetch habis. Row yang gagal ditulis sebagai record kosong dengan tag
+// index | LAZY_DECRYPT_RING_FAILED_TAG, jadi Dart tidak perlu polling untuk keduanya. ring NULL = lepas. Ring harus hidup lebih lama dari session
+// atau dilepas dulu.
+int lazy_decrypt_attach_ring(LazyDecryptSession *session, SpscRing *ring);
+
+void lazy_decrypt_get_stats(LazyDecryptSession *session, LazyDecryptStats *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,167 @@
+#include "legacy_formats.h"
+
+#include <vector>
+
+// Keystream xor_with_iv 16 byte per langkah: key berulang + IV + ramp index (semua mod 256)
+#if defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#define LEGACY_SIMD 1
+typedef v128_t vec8;
+#define B_LOAD(p) wasm_v128_load(p)
+#define B_STORE(p, v) wasm_v128_store(p, v)
+#define B_ADD(a, b) wasm_i8x16_add(a, b)
+#define B_XOR(a, b) wasm_v128_xor(a, b)
+#define B_SPLAT(x) wasm_i8x16_splat((int8_t)(x))
+#define B_ANY_HIGH(v) (wasm_i8x16_bitmask(v) != 0)
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define LEGACY_SIMD 1
+typedef __m128i vec8;
+#define B_LOAD(p) _mm_loadu_si128((const __m128i *)(p))
+#define B_STORE(p, v) _mm_storeu_si128((__m128i *)(p), v)
+#define B_ADD(a, b) _mm_add_epi8(a, b)
+#define B_XOR(a, b) _mm_xor_si128(a, b)
+#define B_SPLAT(x) _mm_set1_epi8((char)(x))
+#define B_ANY_HIGH(v) (_mm_movemask_epi8(v) != 0)
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define LEGACY_SIMD 1
+typedef uint8x16_t vec8;
+#define B_LOAD(p) vld1q_u8((const uint8_t *)(p))
+#define B_STORE(p, v) vst1q_u8((uint8_t *)(p), v)
+#define B_ADD(a, b) vaddq_u8(a, b)
+#define B_XOR(a, b) veorq_u8(a, b)
+#define B_SPLAT(x) vdupq_n_u8((uint8_t)(x))
+#define B_ANY_HIGH(v) (vmaxvq_u8(v) >= 0x80)
+#endif
+
+namespace {
+
+// Key diulang sampai lcm(keylen, 16) supaya setiap langkah 16 byte bisa di-load langsung.
+// Key yang sangat panjang (lcm > batas) memakai jalur scalar.
+constexpr size_t kMaxKeyRepeat = 4096;
+
+size_t gcd(size_t a, size_t b) {
+    while (b) {
+        const size_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+struct KeyRepeat {
+    std::vector<uint8_t> bytes;
+
+    KeyRepeat(const uint8_t *key, size_t keylen) {
+        const size_t period = keylen / gcd(keylen, 16) * 16;
+        if (period > kMaxKeyRepeat) return;
+        bytes.resize(period);
+        for (size_t i = 0; i < period; i++) {
+            bytes[i] = key[i % keylen];
+        }
+    }
+};
+
+void xor_with_iv(uint8_t *out, const uint8_t *in, size_t len, const uint8_t *key, size_t keylen,
+                 const KeyRepeat &repeat, const uint8_t *iv, size_t ivlen) {
+    size_t i = 0;
+#ifdef LEGACY_SIMD
+    if (ivlen == 16 && !repeat.bytes.empty()) {
+        static const uint8_t kRamp[16] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+        const vec8 iv_ramp = B_ADD(B_LOAD(iv), B_LOAD(kRamp));
+        const uint8_t *key_bytes = repeat.bytes.data();
+        const size_t period = repeat.bytes.size();
+        size_t key_pos = 0;
+        for (; i + 16 <= len; i += 16) {
+            const vec8 ks = B_ADD(B_ADD(B_LOAD(key_bytes + key_pos), iv_ramp), B_SPLAT(i & 0xFF));
+            B_STORE(out + i, B_XOR(B_LOAD(in + i), ks));
+            key_pos += 16;
+            if (key_pos == period) key_pos = 0;
+        }
+    }
+#else
+    (void)repeat;
+#endif
+    for (; i < len; i++) {
+        out[i] = in[i] ^ static_cast<uint8_t>(key[i % keylen] + iv[i % ivlen] + i);
+    }
+}
+
+}  // namespace
+
+extern "C" int legacy_utf8_valid(const uint8_t *data, size_t len) {
+    size_t i = 0;
+    while (i < len) {
+#ifdef LEGACY_SIMD
+        // Pesan chat kebanyakan ASCII: lewati 16 byte sekaligus
+        if (len - i >= 16 && !B_ANY_HIGH(B_LOAD(data + i))) {
+            i += 16;
+            continue;
+        }
+#endif
+        const uint8_t c = data[i];
+        if (c < 0x80) {
+            i++;
+            continue;
+        }
+        size_t seq;
+        uint32_t cp;
+        if (c >= 0xC2 && c <= 0xDF) {
+            seq = 2;
+            cp = c & 0x1F;
+        } else if (c >= 0xE0 && c <= 0xEF) {
+            seq = 3;
+            cp = c & 0x0F;
+        } else if (c >= 0xF0 && c <= 0xF4) {
+            seq = 4;
+            cp = c & 0x07;
+        } else {
+            return 0;
+        }
+        if (len - i < seq) return 0;
+        for (size_t j = 1; j < seq; j++) {
+            if ((data[i + j] & 0xC0) != 0x80) return 0;
+            cp = (cp << 6) | (data[i + j] & 0x3F);
+        }
+        if ((seq == 3 && cp < 0x800) || (seq == 4 && cp < 0x10000) || cp > 0x10FFFF ||
+            (cp >= 0xD800 && cp <= 0xDFFF)) {
+            return 0;
+        }
+        i += seq;
+    }
+    return 1;
+}
+
+extern "C" int legacy_xor_with_iv_decrypt(uint8_t *out, const uint8_t *in, size_t len,
+                                          const uint8_t *key, size_t keylen,
+                                          const uint8_t *iv, size_t ivlen) {
+    if (!out || (!in && len) || !key || keylen == 0 || !iv || ivlen == 0) {
+        return LEGACY_ERROR_INVALID_INPUT;
+    }
+    const KeyRepeat repeat(key, keylen);
+    xor_with_iv(out, in, len, key, keylen, repeat, iv, ivlen);
+    return legacy_utf8_valid(out, len) ? LEGACY_OK : LEGACY_ERROR_MALFORMED;
+}
+
+extern "C" size_t legacy_xor_with_iv_decrypt_batch(LegacyXorMessage *messages, size_t count,
+                                                   const uint8_t *key, size_t keylen) {
+    if (!messages || !key || keylen == 0) {
+        for (size_t m = 0; messages && m < count; m++) messages[m].status = LEGACY_ERROR_INVALID_INPUT;
+        return 0;
+    }
+
+    const KeyRepeat repeat(key, keylen);
+    size_t decrypted = 0;
+    for (size_t m = 0; m < count; m++) {
+        LegacyXorMessage &message = messages[m];
+        if (!message.out || (!message.in && message.len) || !message.iv || message.iv_len == 0) {
+            message.status = LEGACY_ERROR_INVALID_INPUT;
+            continue;
+        }
+        xor_with_iv(message.out, message.in, message.len, key, keylen, repeat, message.iv, message.iv_len);
+        message.status = legacy_utf8_valid(message.out, message.len) ? LEGACY_OK : LEGACY_ERROR_MALFORMED;
+        if (message.status == LEGACY_OK) decrypted++;
+    }
+    return decrypted;
+}
@@ -0,0 +1,48 @@
+#ifndef LEGACY_FORMATS_H
+#define LEGACY_FORMATS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Decoder native untuk format pesan lama xor_with_iv, byte-per-byte sama dengan
+// EncryptionService di Dart (dipakai LegacyDecoderFFI, chat_cache dan message_record).
+// Format ini tidak punya autentikasi, jadi UTF-8 yang tidak valid dipakai sebagai tanda
+// key salah (sama seperti utf8.decode di Dart yang melempar error).
+
+#define LEGACY_OK 0
+#define LEGACY_ERROR_INVALID_INPUT -1
+#define LEGACY_ERROR_MALFORMED -2
+
+#define LEGACY_IV_BYTES 16
+
+// xor_with_iv: ks[i] = (key[i % keylen] + iv[i % ivlen] + i) mod 256. out boleh sama dengan in.
+int legacy_xor_with_iv_decrypt(uint8_t *out, const uint8_t *in, size_t len,
+                               const uint8_t *key, size_t keylen,
+                               const uint8_t *iv, size_t ivlen);
+
+typedef struct {
+    const uint8_t *in;
+    uint8_t *out;          // boleh sama dengan in
+    size_t len;
+    const uint8_t *iv;
+    size_t iv_len;
+    int32_t status;        // diisi: LEGACY_OK, LEGACY_ERROR_INVALID_INPUT atau LEGACY_ERROR_MALFORMED
+} LegacyXorMessage;
+
+// Decrypt banyak pesan dengan chat key yang sama; key diulang sekali per batch.
+// Return jumlah pesan yang berhasil (status LEGACY_OK).
+size_t legacy_xor_with_iv_decrypt_batch(LegacyXorMessage *messages, size_t count,
+                                        const uint8_t *key, size_t keylen);
+
+// Validasi UTF-8 strict (tanpa overlong, surrogate, atau > U+10FFFF). Return 1 jika valid.
+int legacy_utf8_valid(const uint8_t *data, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,121 @@
+#include "message_aead.h"
+#include "aes_gcm.h"
+#include "ascon.h"
+#include "chacha20_poly1305.h"
+#include "cpu_features.h"
+#include "sha512.h"
+
+#include <cstring>
+
+namespace {
+
+void secure_wipe(void *p, size_t len) {
+    volatile uint8_t *v = static_cast<volatile uint8_t *>(p);
+    for (size_t i = 0; i < len; i++) {
+        v[i] = 0;
+    }
+}
+
+const char *subkey_label(int algorithm) {
+    switch (algorithm) {
+        case MESSAGE_AEAD_CHACHA20_POLY1305:
+            return "message_aead/chacha20_poly1305";
+        case MESSAGE_AEAD_ASCON128A:
+            return "message_aead/ascon128a";
+        case MESSAGE_AEAD_AES256_GCM:
+            return "message_aead/aes256_gcm";
+        default:
+            return nullptr;
+    }
+}
+
+}  // namespace
+
+extern "C" int message_aead_select(void) {
+    const uint32_t features = cpu_features_get();
+    // Device dengan AES hardware adalah device kelas menengah ke atas: ChaCha20 tetap cepat di sana.
+    if (features & CPU_FEATURE_AES) return MESSAGE_AEAD_CHACHA20_POLY1305;
+    // chacha20_poly1305.cpp punya jalur 4 blok paralel untuk SSE2 dan SIMD128
+    if (features & (CPU_FEATURE_SSE2 | CPU_FEATURE_SIMD128)) return MESSAGE_AEAD_CHACHA20_POLY1305;
+    // Core in-order tanpa crypto extension: Ascon bitsliced 64-bit jauh lebih murah per pesan pendek
+    return MESSAGE_AEAD_ASCON128A;
+}
+
+extern "C" uint32_t message_aead_nonce_bytes(int algorithm) {
+    switch (algorithm) {
+        case MESSAGE_AEAD_CHACHA20_POLY1305:
+            return CHACHA20_NONCE_BYTES;
+        case MESSAGE_AEAD_ASCON128A:
+            return ASCON128A_NONCE_BYTES;
+        case MESSAGE_AEAD_AES256_GCM:
+            return AES_GCM_IV_BYTES;
+        default:
+            return 0;
+    }
+}
+
+extern "C" int message_aead_derive_key(int algorithm, const uint8_t key[MESSAGE_AEAD_KEY_BYTES],
+                                       uint8_t subkey[MESSAGE_AEAD_KEY_BYTES]) {
+    const char *label = subkey_label(algorithm);
+    if (!label) return MESSAGE_AEAD_ERROR_UNKNOWN_ALGORITHM;
+    if (!key || !subkey) return MESSAGE_AEAD_ERROR_INVALID_INPUT;
+
+    HMAC_SHA512_CTX ctx;
+    uint8_t mac[SHA512_DIGEST_BYTES];
+    hmac_sha512_init(&ctx, key, MESSAGE_AEAD_KEY_BYTES);
+    hmac_sha512_update(&ctx, reinterpret_cast<const uint8_t *>(label), strlen(label));
+    hmac_sha512_final(mac, &ctx);
+    memcpy(subkey, mac, MESSAGE_AEAD_KEY_BYTES);
+    secure_wipe(mac, sizeof(mac));
+    secure_wipe(&ctx, sizeof(ctx));
+    return MESSAGE_AEAD_OK;
+}
+
+extern "C" int message_aead_seal(int algorithm,
+                                 uint8_t *ciphertext, uint8_t tag[MESSAGE_AEAD_TAG_BYTES],
+                                 const uint8_t *plaintext, size_t plaintext_len,
+                                 const uint8_t *aad, size_t aad_len,
+                                 const uint8_t key[MESSAGE_AEAD_KEY_BYTES],
+                                 const uint8_t *nonce, size_t nonce_len) {
+    const uint32_t expected_nonce = message_aead_nonce_bytes(algorithm);
+    if (expected_nonce == 0) return MESSAGE_AEAD_ERROR_UNKNOWN_ALGORITHM;
+    if (!key || !nonce || nonce_len != expected_nonce) return MESSAGE_AEAD_ERROR_INVALID_INPUT;
+
+    uint8_t subkey[MESSAGE_AEAD_KEY_BYTES];
+    message_aead_derive_key(algorithm, key, subkey);
+    int status;
+    if (algorithm == MESSAGE_AEAD_ASCON128A) {
+        status = ascon128a_encrypt(ciphertext, tag, plaintext, plaintext_len, aad, aad_len, subkey, nonce);
+    } else if (algorithm == MESSAGE_AEAD_AES256_GCM) {
+        status = aes256_gcm_encrypt(ciphertext, tag, plaintext, plaintext_len, aad, aad_len, subkey, nonce);
+    } else {
+        status = chacha20_poly1305_encrypt(ciphertext, tag, plaintext, plaintext_len, aad, aad_len, subkey, nonce);
+    }
+    secure_wipe(subkey, sizeof(subkey));
+    return status;
+}
+
+extern "C" int message_aead_open(int algorithm,
+                                 uint8_t *plaintext,
+                                 const uint8_t *ciphertext, size_t ciphertext_len,
+                                 const uint8_t tag[MESSAGE_AEAD_TAG_BYTES],
+                                 const uint8_t *aad, size_t aad_len,
+                                 const uint8_t key[MESSAGE_AEAD_KEY_BYTES],
+                                 const uint8_t *nonce, size_t nonce_len) {
+    const uint32_t expected_nonce = message_aead_nonce_bytes(algorithm);
+    if (expected_nonce == 0) return MESSAGE_AEAD_ERROR_UNKNOWN_ALGORITHM;
+    if (!key || !nonce || nonce_len != expected_nonce) return MESSAGE_AEAD_ERROR_INVALID_INPUT;
+
+    uint8_t subkey[MESSAGE_AEAD_KEY_BYTES];
+    message_aead_derive_key(algorithm, key, subkey);
+    int status;
+    if (algorithm == MESSAGE_AEAD_ASCON128A) {
+        status = ascon128a_decrypt(plaintext, ciphertext, ciphertext_len, tag, aad, aad_len, subkey, nonce);
+    } else if (algorithm == MESSAGE_AEAD_AES256_GCM) {
+        status = aes256_gcm_decrypt(plaintext, ciphertext, ciphertext_len, tag, aad, aad_len, subkey, nonce);
+    } else {
+        status = chacha20_poly1305_decrypt(plaintext, ciphertext, ciphertext_len, tag, aad, aad_len, subkey, nonce);
+    }
+    secure_wipe(subkey, sizeof(subkey));
+    return status;
+}
@@ -0,0 +1,64 @@
+#ifndef MESSAGE_AEAD_H
+#define MESSAGE_AEAD_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// AEAD pesan chat dengan algoritma dipilih per device lewat cpu_features:
+// ChaCha20-Poly1305 sebagai default, Ascon-128a untuk device tanpa AES hardware dan
+// tanpa SIMD yang dipakai jalur ChaCha20 (mis. Android low-end Cortex-A53/A7).
+// Pengirim memilih, penerima cukup mengikuti id algoritma yang dikirim bersama pesan.
+
+#define MESSAGE_AEAD_CHACHA20_POLY1305 1
+#define MESSAGE_AEAD_ASCON128A 2
+#define MESSAGE_AEAD_AES256_GCM 3    // tidak pernah dipilih otomatis, untuk interop AES-GCM
+
+#define MESSAGE_AEAD_KEY_BYTES 32     // key pesan; setiap algoritma memakai subkey sendiri
+#define MESSAGE_AEAD_TAG_BYTES 16
+#define MESSAGE_AEAD_MAX_NONCE_BYTES 16
+
+// Status sama dengan AEAD_* di chacha20_poly1305.h
+#define MESSAGE_AEAD_OK 0
+#define MESSAGE_AEAD_ERROR_INVALID_INPUT -1
+#define MESSAGE_AEAD_ERROR_AUTH_FAILED -2
+#define MESSAGE_AEAD_ERROR_UNKNOWN_ALGORITHM -3
+
+// Algoritma terbaik untuk device ini (MESSAGE_AEAD_*)
+int message_aead_select(void);
+
+// Panjang nonce untuk algoritma, atau 0 jika tidak dikenal
+uint32_t message_aead_nonce_bytes(int algorithm);
+
+// Subkey algoritma dari key pesan: HMAC-SHA512(key, "message_aead/<algoritma>")[0..32].
+// Label berbeda per algoritma, jadi satu key pesan tidak pernah dipakai langsung oleh dua
+// cipher; Ascon-128a memakai 16 byte pertama subkey-nya. seal/open menurunkan subkey
+// sendiri; dipakai langsung oleh jalur yang memanggil primitive (batch, keystream pool).
+int message_aead_derive_key(int algorithm, const uint8_t key[MESSAGE_AEAD_KEY_BYTES],
+                            uint8_t subkey[MESSAGE_AEAD_KEY_BYTES]);
+
+// ciphertext = plaintext_len byte, tag 16 byte terpisah. nonce_len harus sama dengan
+// message_aead_nonce_bytes(algorithm).
+int message_aead_seal(int algorithm,
+                      uint8_t *ciphertext, uint8_t tag[MESSAGE_AEAD_TAG_BYTES],
+                      const uint8_t *plaintext, size_t plaintext_len,
+                      const uint8_t *aad, size_t aad_len,
+                      const uint8_t key[MESSAGE_AEAD_KEY_BYTES],
+                      const uint8_t *nonce, size_t nonce_len);
+
+int message_aead_open(int algorithm,
+                      uint8_t *plaintext,
+                      const uint8_t *ciphertext, size_t ciphertext_len,
+                      const uint8_t tag[MESSAGE_AEAD_TAG_BYTES],
+                      const uint8_t *aad, size_t aad_len,
+                      const uint8_t key[MESSAGE_AEAD_KEY_BYTES],
+                      const uint8_t *nonce, size_t nonce_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
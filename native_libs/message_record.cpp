@@ -0,0 +1,295 @@
+#include "message_record.h"
+#include "aead_batch.h"
+#include "legacy_formats.h"
+#include "message_aead.h"
+#include "native_metrics.h"
+
+#include <cstring>
+#include <vector>
+
+static_assert(sizeof(MessageRecordHeader) == MESSAGE_RECORD_HEADER_BYTES, "layout header berubah");
+
+namespace {
+
+constexpr uint32_t kMaxVarintBytes = 5;
+
+void secure_wipe(void *p, size_t len) {
+    volatile uint8_t *v = static_cast<volatile uint8_t *>(p);
+    for (size_t i = 0; i < len; i++) {
+        v[i] = 0;
+    }
+}
+
+uint32_t varint_size(uint32_t v) {
+    uint32_t n = 1;
+    while (v >= 0x80) {
+        v >>= 7;
+        n++;
+    }
+    return n;
+}
+
+uint8_t *write_varint(uint8_t *p, uint32_t v) {
+    while (v >= 0x80) {
+        *p++ = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = (uint8_t)v;
+    return p;
+}
+
+// Return false jika varint terpotong, lebih dari 5 byte, atau melebihi uint32
+bool read_varint(const uint8_t *&p, const uint8_t *end, uint32_t &out) {
+    uint64_t v = 0;
+    for (uint32_t i = 0; i < kMaxVarintBytes; i++) {
+        if (p >= end) return false;
+        const uint8_t b = *p++;
+        v |= (uint64_t)(b & 0x7F) << (7 * i);
+        if (!(b & 0x80)) {
+            if (v > 0xFFFFFFFFu) return false;
+            out = (uint32_t)v;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Field body dengan prefix panjang, dibatasi oleh akhir record
+bool read_field(const uint8_t *&p, const uint8_t *end, const uint8_t *&data, uint32_t &len) {
+    if (!read_varint(p, end, len)) return false;
+    if ((size_t)(end - p) < len) return false;
+    data = p;
+    p += len;
+    return true;
+}
+
+bool parse_record(const uint8_t *p, size_t remaining, MessageRecordView &view, uint32_t &record_len) {
+    if (remaining < MESSAGE_RECORD_HEADER_BYTES) return false;
+    MessageRecordHeader header;
+    memcpy(&header, p, sizeof(header));
+    if (header.magic != MESSAGE_RECORD_MAGIC || header.version != MESSAGE_RECORD_VERSION) return false;
+    if (header.record_len < MESSAGE_RECORD_HEADER_BYTES || header.record_len % MESSAGE_RECORD_ALIGN != 0 ||
+        header.record_len > remaining) {
+        return false;
+    }
+    if (header.nonce_len > MESSAGE_RECORD_MAX_NONCE_BYTES) return false;
+    if (header.flags & ~(MESSAGE_RECORD_FLAG_TEXT_ID | MESSAGE_RECORD_FLAG_TEXT_SENDER)) return false;
+
+    const uint8_t *cursor = p + MESSAGE_RECORD_HEADER_BYTES;
+    const uint8_t *end = p + header.record_len;
+    view.header = reinterpret_cast<const MessageRecordHeader *>(p);
+    view.id_text = nullptr;
+    view.id_text_len = 0;
+    view.sender_text = nullptr;
+    view.sender_text_len = 0;
+    if ((header.flags & MESSAGE_RECORD_FLAG_TEXT_ID) && !read_field(cursor, end, view.id_text, view.id_text_len)) {
+        return false;
+    }
+    if ((header.flags & MESSAGE_RECORD_FLAG_TEXT_SENDER) &&
+        !read_field(cursor, end, view.sender_text, view.sender_text_len)) {
+        return false;
+    }
+    if (!read_field(cursor, end, view.ciphertext, view.ciphertext_len)) return false;
+    // Padding harus pas sampai batas 8 byte berikutnya
+    if ((size_t)(end - cursor) >= MESSAGE_RECORD_ALIGN) return false;
+
+    record_len = header.record_len;
+    return true;
+}
+
+bool is_aead(uint8_t algorithm) {
+    return message_aead_nonce_bytes(algorithm) != 0;
+}
+
+}  // namespace
+
+extern "C" uint32_t message_record_size(uint8_t flags, uint32_t id_text_len, uint32_t sender_text_len,
+                                        uint32_t ciphertext_len) {
+    uint64_t size = MESSAGE_RECORD_HEADER_BYTES + varint_size(ciphertext_len) + (uint64_t)ciphertext_len;
+    if (flags & MESSAGE_RECORD_FLAG_TEXT_ID) size += varint_size(id_text_len) + (uint64_t)id_text_len;
+    if (flags & MESSAGE_RECORD_FLAG_TEXT_SENDER) size += varint_size(sender_text_len) + (uint64_t)sender_text_len;
+    size = (size + MESSAGE_RECORD_ALIGN - 1) & ~(uint64_t)(MESSAGE_RECORD_ALIGN - 1);
+    return size > 0xFFFFFFFFu ? 0 : (uint32_t)size;
+}
+
+extern "C" uint32_t message_record_write(uint8_t *out, size_t capacity, const MessageRecordHeader *header,
+                                         const uint8_t *id_text, uint32_t id_text_len,
+                                         const uint8_t *sender_text, uint32_t sender_text_len,
+                                         const uint8_t *ciphertext, uint32_t ciphertext_len) {
+    if (!out || !header || (ciphertext_len && !ciphertext)) return 0;
+    if (header->nonce_len > MESSAGE_RECORD_MAX_NONCE_BYTES) return 0;
+    if (header->flags & ~(MESSAGE_RECORD_FLAG_TEXT_ID | MESSAGE_RECORD_FLAG_TEXT_SENDER)) return 0;
+    const bool text_id = (header->flags & MESSAGE_RECORD_FLAG_TEXT_ID) != 0;
+    const bool text_sender = (header->flags & MESSAGE_RECORD_FLAG_TEXT_SENDER) != 0;
+    if ((text_id && id_text_len && !id_text) || (text_sender && sender_text_len && !sender_text)) return 0;
+    if (!text_id) id_text_len = 0;
+    if (!text_sender) sender_text_len = 0;
+
+    const uint32_t size = message_record_size(header->flags, id_text_len, sender_text_len, ciphertext_len);
+    if (size == 0 || size > capacity) return 0;
+
+    // header boleh menunjuk ke out sendiri (Dart mengisi field langsung di buffer)
+    MessageRecordHeader h;
+    memcpy(&h, header, sizeof(h));
+    h.magic = MESSAGE_RECORD_MAGIC;
+    h.record_len = size;
+    h.version = MESSAGE_RECORD_VERSION;
+    h.reserved = 0;
+    memset(h.nonce + h.nonce_len, 0, MESSAGE_RECORD_MAX_NONCE_BYTES - h.nonce_len);
+    if (text_id) memset(h.id, 0, sizeof(h.id));
+    if (text_sender) memset(h.sender, 0, sizeof(h.sender));
+
+    uint8_t *p = out + MESSAGE_RECORD_HEADER_BYTES;
+    if (text_id) {
+        p = write_varint(p, id_text_len);
+        if (id_text_len) memmove(p, id_text, id_text_len);
+        p += id_text_len;
+    }
+    if (text_sender) {
+        p = write_varint(p, sender_text_len);
+        if (sender_text_len) memmove(p, sender_text, sender_text_len);
+        p += sender_text_len;
+    }
+    p = write_varint(p, ciphertext_len);
+    if (ciphertext_len) memmove(p, ciphertext, ciphertext_len);
+    p += ciphertext_len;
+    memset(p, 0, (size_t)(out + size - p));
+    memcpy(out, &h, sizeof(h));
+    return (uint32_t)size;
+}
+
+extern "C" int32_t message_record_index(const uint8_t *buffer, size_t len,
+                                        MessageRecordView *views, uint32_t capacity) {
+    if (!buffer && len) return MESSAGE_RECORD_ERROR_INVALID_INPUT;
+    int32_t count = 0;
+    size_t offset = 0;
+    while (offset < len) {
+        MessageRecordView view;
+        uint32_t record_len = 0;
+        if (count == INT32_MAX || !parse_record(buffer + offset, len - offset, view, record_len)) {
+            return MESSAGE_RECORD_ERROR_MALFORMED;
+        }
+        if (views && (uint32_t)count < capacity) views[count] = view;
+        count++;
+        offset += record_len;
+    }
+    return count;
+}
+
+extern "C" int32_t message_record_decrypt_all(const uint8_t *buffer, size_t len,
+                                              const uint8_t *chat_key, size_t chat_key_len,
+                                              const uint8_t *aead_key,
+                                              uint8_t *out, size_t out_capacity,
+                                              MessageRecordPlain *plains, uint32_t count) {
+    const int32_t total = message_record_index(buffer, len, nullptr, 0);
+    if (total < 0) return total;
+    if ((uint32_t)total != count || (count && (!plains || !out))) return MESSAGE_RECORD_ERROR_INVALID_INPUT;
+    if (count == 0) return 0;
+    const uint64_t started_ns = native_metrics_now_ns();
+
+    std::vector<MessageRecordView> views(count);
+    message_record_index(buffer, len, views.data(), count);
+
+    // Plaintext berurutan di out; AEAD lebih pendek 16 byte dari ciphertext
+    // Jalur batch memanggil primitive ChaCha20 langsung, jadi subkey-nya diturunkan di sini
+    // sekali untuk semua record; algoritma lain lewat message_aead_open
+    uint8_t chacha_key[MESSAGE_AEAD_KEY_BYTES];
+    if (aead_key) message_aead_derive_key(MESSAGE_AEAD_CHACHA20_POLY1305, aead_key, chacha_key);
+    std::vector<AeadBatchItem> chacha;
+    std::vector<uint32_t> chacha_index;
+    std::vector<LegacyXorMessage> xors;
+    std::vector<uint32_t> xor_index;
+    size_t offset = 0;
+    uint64_t bytes = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        const MessageRecordView &view = views[i];
+        const MessageRecordHeader *h = view.header;
+        MessageRecordPlain &plain = plains[i];
+        plain.text = nullptr;
+        plain.text_len = 0;
+        plain.status = MESSAGE_RECORD_ERROR_INVALID_INPUT;
+
+        const bool aead = is_aead(h->algorithm);
+        if (!aead && h->algorithm != MESSAGE_RECORD_ALG_XOR_WITH_IV) continue;
+        if (aead ? (!aead_key || view.ciphertext_len < MESSAGE_AEAD_TAG_BYTES ||
+                    h->nonce_len != message_aead_nonce_bytes(h->algorithm))
+                 : (!chat_key || !chat_key_len || h->nonce_len == 0)) {
+            continue;
+        }
+        const uint32_t text_len = aead ? view.ciphertext_len - MESSAGE_AEAD_TAG_BYTES : view.ciphertext_len;
+        if (out_capacity - offset < text_len) {
+            secure_wipe(chacha_key, sizeof(chacha_key));
+            return MESSAGE_RECORD_ERROR_BUFFER_TOO_SMALL;
+        }
+        plain.text = out + offset;
+        plain.text_len = text_len;
+        offset += text_len;
+        bytes += text_len;
+
+        if (h->algorithm == MESSAGE_AEAD_CHACHA20_POLY1305) {
+            AeadBatchItem item;
+            item.out = plain.text;
+            item.in = view.ciphertext;
+            item.len = text_len;
+            item.aad = nullptr;
+            item.aad_len = 0;
+            item.key = chacha_key;
+            item.nonce = h->nonce;
+            item.tag = const_cast<uint8_t *>(view.ciphertext + text_len);
+            item.status = AEAD_OK;
+            chacha.push_back(item);
+            chacha_index.push_back(i);
+        } else if (aead) {
+            const int status = message_aead_open(h->algorithm, plain.text, view.ciphertext, text_len,
+                                                 view.ciphertext + text_len, nullptr, 0, aead_key,
+                                                 h->nonce, h->nonce_len);
+            plain.status = status == MESSAGE_AEAD_OK ? MESSAGE_RECORD_OK
+                         : status == MESSAGE_AEAD_ERROR_AUTH_FAILED ? MESSAGE_RECORD_ERROR_AUTH_FAILED
+                         : MESSAGE_RECORD_ERROR_INVALID_INPUT;
+        } else {
+            LegacyXorMessage message;
+            message.in = view.ciphertext;
+            message.out = plain.text;
+            message.len = text_len;
+            message.iv = h->nonce;
+            message.iv_len = h->nonce_len;
+            message.status = LEGACY_OK;
+            xors.push_back(message);
+            xor_index.push_back(i);
+        }
+    }
+
+    if (!chacha.empty()) {
+        chacha20_poly1305_open_batch(chacha.data(), chacha.size());
+        for (size_t j = 0; j < chacha.size(); j++) {
+            const int32_t status = chacha[j].status;
+            plains[chacha_index[j]].status = status == AEAD_OK ? MESSAGE_RECORD_OK
+                                           : status == AEAD_ERROR_AUTH_FAILED ? MESSAGE_RECORD_ERROR_AUTH_FAILED
+                                           : MESSAGE_RECORD_ERROR_INVALID_INPUT;
+        }
+    }
+    secure_wipe(chacha_key, sizeof(chacha_key));
+    if (!xors.empty()) {
+        legacy_xor_with_iv_decrypt_batch(xors.data(), xors.size(), chat_key, chat_key_len);
+        for (size_t j = 0; j < xors.size(); j++) {
+            const int32_t status = xors[j].status;
+            plains[xor_index[j]].status = status == LEGACY_OK ? MESSAGE_RECORD_OK
+                                        : status == LEGACY_ERROR_MALFORMED ? MESSAGE_RECORD_ERROR_MALFORMED
+                                        : MESSAGE_RECORD_ERROR_INVALID_INPUT;
+        }
+    }
+
+    int32_t ok = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        MessageRecordPlain &plain = plains[i];
+        if (plain.status == MESSAGE_RECORD_OK) {
+            ok++;
+        } else if (plain.text) {
+            // Output yang gagal (mis. xor dengan key salah) tidak boleh terbaca pemanggil
+            memset(plain.text, 0, plain.text_len);
+            plain.text_len = 0;
+        }
+    }
+    native_metrics_record(NATIVE_METRICS_CIPHER, started_ns, bytes, ok == (int32_t)count);
+    return ok;
+}
@@ -0,0 +1,108 @@
+#ifndef MESSAGE_RECORD_H
+#define MESSAGE_RECORD_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Format record biner pesan terenkripsi, dipakai bersama oleh store lokal, batch decrypt
+// dan IPC sehingga tidak ada layer yang men-serialize ulang ke Map/base64. Record disusun
+// berurutan dalam satu buffer; setiap record rata 8 byte sehingga header bisa dibaca
+// langsung sebagai struct (Dart: Struct view di atas memori native, tanpa salinan).
+//
+// Layout (little-endian):
+//   MessageRecordHeader (80 byte)
+//   [varint id_len, id]          jika flags & MESSAGE_RECORD_FLAG_TEXT_ID
+//   [varint sender_len, sender]  jika flags & MESSAGE_RECORD_FLAG_TEXT_SENDER
+//   varint ciphertext_len, ciphertext (AEAD: termasuk tag 16 byte)
+//   padding nol sampai kelipatan 8
+// varint = LEB128 unsigned, maksimal 5 byte (uint32).
+
+#define MESSAGE_RECORD_MAGIC 0x3143524Du     // "MRC1"
+#define MESSAGE_RECORD_VERSION 1
+#define MESSAGE_RECORD_HEADER_BYTES 80
+#define MESSAGE_RECORD_ALIGN 8
+#define MESSAGE_RECORD_UUID_BYTES 16
+#define MESSAGE_RECORD_MAX_NONCE_BYTES 24
+
+// algorithm: 0 = xor_with_iv lama, selain itu id MESSAGE_AEAD_* dari message_aead.h
+#define MESSAGE_RECORD_ALG_XOR_WITH_IV 0
+
+// id/sender bukan UUID: disimpan sebagai teks di body, field UUID di header nol
+#define MESSAGE_RECORD_FLAG_TEXT_ID 0x01
+#define MESSAGE_RECORD_FLAG_TEXT_SENDER 0x02
+
+#define MESSAGE_RECORD_OK 0
+#define MESSAGE_RECORD_ERROR_INVALID_INPUT -1
+#define MESSAGE_RECORD_ERROR_MALFORMED -2
+#define MESSAGE_RECORD_ERROR_AUTH_FAILED -3
+#define MESSAGE_RECORD_ERROR_BUFFER_TOO_SMALL -4
+
+typedef struct {
+    uint32_t magic;
+    uint32_t record_len;         // total byte termasuk header dan padding
+    uint8_t version;
+    uint8_t algorithm;
+    uint8_t nonce_len;
+    uint8_t flags;
+    uint32_t reserved;
+    int64_t created_at_us;       // mikrodetik sejak epoch (UTC)
+    uint8_t id[MESSAGE_RECORD_UUID_BYTES];
+    uint8_t sender[MESSAGE_RECORD_UUID_BYTES];
+    uint8_t nonce[MESSAGE_RECORD_MAX_NONCE_BYTES];
+} MessageRecordHeader;
+
+// Pointer ke dalam buffer record (tanpa salinan); teks NULL jika id/sender berupa UUID
+typedef struct {
+    const MessageRecordHeader *header;
+    const uint8_t *id_text;
+    uint32_t id_text_len;
+    const uint8_t *sender_text;
+    uint32_t sender_text_len;
+    const uint8_t *ciphertext;
+    uint32_t ciphertext_len;
+} MessageRecordView;
+
+// Hasil decrypt per record; text menunjuk ke buffer output pemanggil
+typedef struct {
+    uint8_t *text;
+    uint32_t text_len;
+    int32_t status;
+} MessageRecordPlain;
+
+// Ukuran record (termasuk padding); panjang teks hanya dihitung jika flag-nya diset.
+// Return 0 jika record melebihi 4 GiB.
+uint32_t message_record_size(uint8_t flags, uint32_t id_text_len, uint32_t sender_text_len,
+                             uint32_t ciphertext_len);
+
+// Tulis satu record ke out. header menyediakan algorithm/nonce/created_at/id/sender/flags;
+// magic, version dan record_len diisi di sini. Teks id/sender hanya dipakai jika flag-nya
+// diset. Return byte yang ditulis, atau 0 jika input tidak valid atau capacity kurang.
+uint32_t message_record_write(uint8_t *out, size_t capacity, const MessageRecordHeader *header,
+                              const uint8_t *id_text, uint32_t id_text_len,
+                              const uint8_t *sender_text, uint32_t sender_text_len,
+                              const uint8_t *ciphertext, uint32_t ciphertext_len);
+
+// Validasi seluruh buffer (data dari disk/IPC tidak dipercaya) dan isi views[0..capacity).
+// views boleh NULL untuk sekadar menghitung. Return jumlah record, atau MALFORMED.
+int32_t message_record_index(const uint8_t *buffer, size_t len,
+                             MessageRecordView *views, uint32_t capacity);
+
+// Decrypt semua record dalam buffer. chat_key untuk xor_with_iv, aead_key (32 byte) untuk
+// algoritma AEAD; ChaCha20-Poly1305 memakai jalur multi-buffer (aead_batch.h). Plaintext
+// ditulis berurutan ke out (kapasitas minimal total ciphertext_len). plains[count] diisi
+// per record. Return jumlah record yang berhasil, atau error negatif untuk buffer.
+int32_t message_record_decrypt_all(const uint8_t *buffer, size_t len,
+                                   const uint8_t *chat_key, size_t chat_key_len,
+                                   const uint8_t *aead_key,
+                                   uint8_t *out, size_t out_capacity,
+                                   MessageRecordPlain *plains, uint32_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -1,12 +1,7 @@
 #include <cstdint>
 #include <cstring>
 
-// Simple struct untuk SHA3 context
-typedef struct {
-    uint64_t state[25];
-    uint32_t rate;
-    uint32_t pt;
-} SHA3_CTX;
+#include "sha3.h"
 
 // Forward declarations untuk Argon2 functions dari library asli
 extern "C" {
@@ -16,7 +11,58 @@ extern "C" {
                          void *hash, size_t hashlen);
 }
 
-// Simple SHA3 implementation untuk demo
+// SHA3-512 (FIPS 202): Keccak-f[1600], rate 72 byte, padding domain 0x06
+namespace {
+
+const uint64_t kKeccakRoundConstants[24] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL, 0x8000000080008000ULL,
+    0x000000000000808bULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+    0x000000000000008aULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+    0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+    0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800aULL, 0x800000008000000aULL,
+    0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL,
+};
+const unsigned kKeccakRotations[24] = {1, 3, 6, 10, 15, 21, 28, 36, 45, 55, 2, 14,
+                                       27, 41, 56, 8, 25, 43, 62, 18, 39, 61, 20, 44};
+const unsigned kKeccakPi[24] = {10, 7, 11, 17, 18, 3, 5, 16, 8, 21, 24, 4,
+                                15, 23, 19, 13, 12, 2, 20, 14, 22, 9, 6, 1};
+
+inline uint64_t rotl64(uint64_t x, unsigned n) { return (x << n) | (x >> (64 - n)); }
+
+void keccak_f1600(uint64_t st[25]) {
+    uint64_t bc[5];
+    for (int round = 0; round < 24; round++) {
+        for (int i = 0; i < 5; i++) bc[i] = st[i] ^ st[i + 5] ^ st[i + 10] ^ st[i + 15] ^ st[i + 20];
+        for (int i = 0; i < 5; i++) {
+            const uint64_t t = bc[(i + 4) % 5] ^ rotl64(bc[(i + 1) % 5], 1);
+            for (int j = 0; j < 25; j += 5) st[j + i] ^= t;
+        }
+        uint64_t t = st[1];
+        for (int i = 0; i < 24; i++) {
+            const unsigned j = kKeccakPi[i];
+            const uint64_t next = st[j];
+            st[j] = rotl64(t, kKeccakRotations[i]);
+            t = next;
+        }
+        for (int j = 0; j < 25; j += 5) {
+            for (int i = 0; i < 5; i++) bc[i] = st[j + i];
+            for (int i = 0; i < 5; i++) st[j + i] ^= (~bc[(i + 1) % 5]) & bc[(i + 2) % 5];
+        }
+        st[0] ^= kKeccakRoundConstants[round];
+    }
+}
+
+// Byte ke-pos dari state little-endian
+inline void xor_state_byte(SHA3_CTX *ctx, uint32_t pos, uint8_t byte) {
+    ctx->state[pos / 8] ^= static_cast<uint64_t>(byte) << ((pos % 8) * 8);
+}
+
+}  // namespace
+
+extern "C" size_t sha3_512_ctx_size(void) {
+    return sizeof(SHA3_CTX);
+}
+
 extern "C" void sha3_512_init(SHA3_CTX *ctx) {
     memset(ctx->state, 0, sizeof(ctx->state));
     ctx->rate = 72; // 576 bits untuk SHA3-512
@@ -24,15 +70,19 @@ extern "C" void sha3_512_init(SHA3_CTX *ctx) {
 }
 
 extern "C" void sha3_512_update(SHA3_CTX *ctx, const uint8_t *data, size_t len) {
-    // Simple XOR-based implementation untuk demo
     for (size_t i = 0; i < len; i++) {
-        ctx->state[ctx->pt % 25] ^= static_cast<uint64_t>(data[i]) << ((ctx->pt % 8) * 8);
-        ctx->pt = (ctx->pt + 1) % ctx->rate;
+        xor_state_byte(ctx, ctx->pt, data[i]);
+        if (++ctx->pt == ctx->rate) {
+            keccak_f1600(ctx->state);
+            ctx->pt = 0;
+        }
     }
 }
 
 extern "C" void sha3_512_final(uint8_t *digest, SHA3_CTX *ctx) {
-    // Simple finalization - convert state to bytes
+    xor_state_byte(ctx, ctx->pt, 0x06);
+    xor_state_byte(ctx, ctx->rate - 1, 0x80);
+    keccak_f1600(ctx->state);
     for (int i = 0; i < 64; i++) {
         digest[i] = static_cast<uint8_t>((ctx->state[i / 8] >> ((i % 8) * 8)) & 0xFF);
     }
@@ -0,0 +1,318 @@
+#include "native_metrics.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+
+// Satu writer per blok (thread pemilik), jadi cukup load + store relaxed tanpa
+// instruksi lock; snapshot membaca dengan relaxed dan boleh sedikit tertinggal.
+struct Counter {
+    std::atomic<uint64_t> value{0};
+
+    void add(uint64_t delta) {
+        value.store(value.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+    }
+    void raise(uint64_t candidate) {
+        if (candidate > value.load(std::memory_order_relaxed)) {
+            value.store(candidate, std::memory_order_relaxed);
+        }
+    }
+    uint64_t get() const { return value.load(std::memory_order_relaxed); }
+};
+
+struct SubsystemMetrics {
+    Counter operations;
+    Counter errors;
+    Counter bytes;
+    Counter total_ns;
+    Counter max_ns;
+    Counter buckets[NATIVE_METRICS_BUCKETS];
+};
+
+struct ThreadMetrics {
+    SubsystemMetrics subsystems[NATIVE_METRICS_SUBSYSTEM_COUNT];
+    bool in_use = true;
+};
+
+// Blok tidak pernah dibebaskan: saat thread selesai bloknya dipakai ulang thread baru
+// agar total tetap monoton (counter Prometheus tidak boleh turun).
+std::mutex g_registry_mutex;
+std::vector<ThreadMetrics *> g_registry;
+std::atomic<bool> g_enabled{true};
+
+struct ThreadSlot {
+    ThreadMetrics *metrics = nullptr;
+
+    ~ThreadSlot() {
+        if (metrics) {
+            std::lock_guard<std::mutex> lock(g_registry_mutex);
+            metrics->in_use = false;
+        }
+    }
+};
+
+thread_local ThreadSlot t_slot;
+
+ThreadMetrics *thread_metrics() {
+    if (t_slot.metrics) {
+        return t_slot.metrics;
+    }
+    std::lock_guard<std::mutex> lock(g_registry_mutex);
+    for (ThreadMetrics *candidate : g_registry) {
+        if (!candidate->in_use) {
+            candidate->in_use = true;
+            t_slot.metrics = candidate;
+            return candidate;
+        }
+    }
+    ThreadMetrics *created = new ThreadMetrics();
+    g_registry.push_back(created);
+    t_slot.metrics = created;
+    return created;
+}
+
+inline int highest_bit(uint64_t value) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return static_cast<int>(index);
+#else
+    return 63 - __builtin_clzll(value);
+#endif
+}
+
+inline uint32_t bucket_index(uint64_t value) {
+    if (value < 2 * NATIVE_METRICS_SUB_BUCKETS) {
+        return static_cast<uint32_t>(value);
+    }
+    const int shift = highest_bit(value) - 4;
+    const uint64_t index = static_cast<uint64_t>(shift + 1) * NATIVE_METRICS_SUB_BUCKETS +
+                           ((value >> shift) - NATIVE_METRICS_SUB_BUCKETS);
+    return index < NATIVE_METRICS_BUCKETS ? static_cast<uint32_t>(index) : NATIVE_METRICS_BUCKETS - 1;
+}
+
+struct MergedSubsystem {
+    uint64_t operations = 0;
+    uint64_t errors = 0;
+    uint64_t bytes = 0;
+    uint64_t total_ns = 0;
+    uint64_t max_ns = 0;
+    uint64_t buckets[NATIVE_METRICS_BUCKETS] = {};
+};
+
+uint32_t merge(MergedSubsystem *merged) {
+    std::lock_guard<std::mutex> lock(g_registry_mutex);
+    for (const ThreadMetrics *thread : g_registry) {
+        for (int s = 0; s < NATIVE_METRICS_SUBSYSTEM_COUNT; s++) {
+            const SubsystemMetrics &source = thread->subsystems[s];
+            MergedSubsystem &target = merged[s];
+            target.operations += source.operations.get();
+            target.errors += source.errors.get();
+            target.bytes += source.bytes.get();
+            target.total_ns += source.total_ns.get();
+            if (source.max_ns.get() > target.max_ns) {
+                target.max_ns = source.max_ns.get();
+            }
+            for (int b = 0; b < NATIVE_METRICS_BUCKETS; b++) {
+                target.buckets[b] += source.buckets[b].get();
+            }
+        }
+    }
+    return static_cast<uint32_t>(g_registry.size());
+}
+
+// Nilai tertinggi yang setara dengan bucket tempat percentile jatuh, dibatasi max_ns
+uint64_t percentile(const MergedSubsystem &merged, double quantile) {
+    uint64_t total = 0;
+    for (uint64_t count : merged.buckets) {
+        total += count;
+    }
+    if (total == 0) {
+        return 0;
+    }
+    uint64_t rank = static_cast<uint64_t>(quantile * static_cast<double>(total) + 0.5);
+    if (rank < 1) rank = 1;
+
+    uint64_t seen = 0;
+    for (uint32_t b = 0; b < NATIVE_METRICS_BUCKETS; b++) {
+        seen += merged.buckets[b];
+        if (seen >= rank) {
+            const uint64_t upper = b + 1 < NATIVE_METRICS_BUCKETS ? native_metrics_bucket_lower_ns(b + 1) - 1
+                                                                  : merged.max_ns;
+            return upper < merged.max_ns ? upper : merged.max_ns;
+        }
+    }
+    return merged.max_ns;
+}
+
+const char *const kSubsystemNames[NATIVE_METRICS_SUBSYSTEM_COUNT] = {
+    "kdf", "cipher", "stego", "file_io", "cache",
+};
+
+void append(std::string &text, const char *format, ...) {
+    char line[256];
+    va_list args;
+    va_start(args, format);
+    const int written = vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    if (written > 0) {
+        text.append(line, static_cast<size_t>(written) < sizeof(line) ? static_cast<size_t>(written) : sizeof(line) - 1);
+    }
+}
+
+}  // namespace
+
+extern "C" uint64_t native_metrics_now_ns(void) {
+    if (!g_enabled.load(std::memory_order_relaxed)) {
+        return 0;
+    }
+    const auto now = std::chrono::steady_clock::now().time_since_epoch();
+    // +1 agar timestamp valid tidak pernah 0 (0 = metrics mati)
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count()) + 1;
+}
+
+extern "C" void native_metrics_record_latency(int subsystem, uint64_t latency_ns, uint64_t bytes, int ok) {
+    if (subsystem < 0 || subsystem >= NATIVE_METRICS_SUBSYSTEM_COUNT || !g_enabled.load(std::memory_order_relaxed)) {
+        return;
+    }
+    SubsystemMetrics &metrics = thread_metrics()->subsystems[subsystem];
+    metrics.operations.add(1);
+    if (!ok) {
+        metrics.errors.add(1);
+    }
+    metrics.bytes.add(bytes);
+    metrics.total_ns.add(latency_ns);
+    metrics.max_ns.raise(latency_ns);
+    metrics.buckets[bucket_index(latency_ns)].add(1);
+}
+
+extern "C" void native_metrics_record(int subsystem, uint64_t start_ns, uint64_t bytes, int ok) {
+    if (start_ns == 0) {
+        return;
+    }
+    const uint64_t now = native_metrics_now_ns();
+    if (now == 0) {
+        return;
+    }
+    native_metrics_record_latency(subsystem, now > start_ns ? now - start_ns : 0, bytes, ok);
+}
+
+extern "C" void native_metrics_set_enabled(int enabled) {
+    g_enabled.store(enabled != 0, std::memory_order_relaxed);
+}
+
+extern "C" uint64_t native_metrics_bucket_lower_ns(uint32_t bucket) {
+    if (bucket < 2 * NATIVE_METRICS_SUB_BUCKETS) {
+        return bucket;
+    }
+    const uint32_t shift = bucket / NATIVE_METRICS_SUB_BUCKETS - 1;
+    return static_cast<uint64_t>(NATIVE_METRICS_SUB_BUCKETS + bucket % NATIVE_METRICS_SUB_BUCKETS) << shift;
+}
+
+extern "C" int native_metrics_snapshot(NativeMetricsSnapshot *out) {
+    if (!out) {
+        return -1;
+    }
+    std::vector<MergedSubsystem> merged(NATIVE_METRICS_SUBSYSTEM_COUNT);
+    memset(out, 0, sizeof(*out));
+    out->thread_count = merge(merged.data());
+    out->enabled = g_enabled.load(std::memory_order_relaxed) ? 1 : 0;
+
+    for (int s = 0; s < NATIVE_METRICS_SUBSYSTEM_COUNT; s++) {
+        const MergedSubsystem &source = merged[s];
+        NativeMetricsSubsystemSnapshot &target = out->subsystems[s];
+        target.operations = source.operations;
+        target.errors = source.errors;
+        target.bytes = source.bytes;
+        target.total_ns = source.total_ns;
+        target.max_ns = source.max_ns;
+        target.p50_ns = percentile(source, 0.50);
+        target.p90_ns = percentile(source, 0.90);
+        target.p99_ns = percentile(source, 0.99);
+        target.p999_ns = percentile(source, 0.999);
+    }
+    return 0;
+}
+
+extern "C" int native_metrics_histogram(int subsystem, uint64_t *counts, size_t count_len) {
+    if (subsystem < 0 || subsystem >= NATIVE_METRICS_SUBSYSTEM_COUNT || !counts || count_len < NATIVE_METRICS_BUCKETS) {
+        return -1;
+    }
+    std::vector<MergedSubsystem> merged(NATIVE_METRICS_SUBSYSTEM_COUNT);
+    merge(merged.data());
+    memcpy(counts, merged[subsystem].buckets, sizeof(merged[subsystem].buckets));
+    return 0;
+}
+
+extern "C" size_t native_metrics_format_prometheus(char *out, size_t capacity) {
+    std::vector<MergedSubsystem> merged(NATIVE_METRICS_SUBSYSTEM_COUNT);
+    merge(merged.data());
+
+    // Bucket Prometheus dibentuk dari histogram log-linear: bucket internal dihitung
+    // ke "le" jika batas atasnya <= le, jadi akurasi mengikuti presisi histogram (~6%).
+    static const double kLeSeconds[] = {1e-6, 1e-5, 1e-4, 1e-3, 1e-2, 1e-1, 1.0, 10.0};
+
+    std::string text;
+    text.reserve(4096);
+
+    text += "# HELP secret_app_native_operations_total Operations completed by native subsystems.\n";
+    text += "# TYPE secret_app_native_operations_total counter\n";
+    for (int s = 0; s < NATIVE_METRICS_SUBSYSTEM_COUNT; s++) {
+        append(text, "secret_app_native_operations_total{subsystem=\"%s\"} %llu\n", kSubsystemNames[s],
+               static_cast<unsigned long long>(merged[s].operations));
+    }
+
+    text += "# HELP secret_app_native_errors_total Failed native operations.\n";
+    text += "# TYPE secret_app_native_errors_total counter\n";
+    for (int s = 0; s < NATIVE_METRICS_SUBSYSTEM_COUNT; s++) {
+        append(text, "secret_app_native_errors_total{subsystem=\"%s\"} %llu\n", kSubsystemNames[s],
+               static_cast<unsigned long long>(merged[s].errors));
+    }
+
+    text += "# HELP secret_app_native_bytes_total Bytes processed by native subsystems.\n";
+    text += "# TYPE secret_app_native_bytes_total counter\n";
+    for (int s = 0; s < NATIVE_METRICS_SUBSYSTEM_COUNT; s++) {
+        append(text, "secret_app_native_bytes_total{subsystem=\"%s\"} %llu\n", kSubsystemNames[s],
+               static_cast<unsigned long long>(merged[s].bytes));
+    }
+
+    text += "# HELP secret_app_native_latency_seconds Latency of native operations.\n";
+    text += "# TYPE secret_app_native_latency_seconds histogram\n";
+    for (int s = 0; s < NATIVE_METRICS_SUBSYSTEM_COUNT; s++) {
+        const MergedSubsystem &source = merged[s];
+        uint64_t cumulative = 0;
+        uint32_t bucket = 0;
+        for (double le : kLeSeconds) {
+            const uint64_t le_ns = static_cast<uint64_t>(le * 1e9);
+            while (bucket + 1 < NATIVE_METRICS_BUCKETS && native_metrics_bucket_lower_ns(bucket + 1) <= le_ns) {
+                cumulative += source.buckets[bucket++];
+            }
+            append(text, "secret_app_native_latency_seconds_bucket{subsystem=\"%s\",le=\"%g\"} %llu\n",
+                   kSubsystemNames[s], le, static_cast<unsigned long long>(cumulative));
+        }
+        append(text, "secret_app_native_latency_seconds_bucket{subsystem=\"%s\",le=\"+Inf\"} %llu\n",
+               kSubsystemNames[s], static_cast<unsigned long long>(source.operations));
+        append(text, "secret_app_native_latency_seconds_sum{subsystem=\"%s\"} %.9f\n", kSubsystemNames[s],
+               static_cast<double>(source.total_ns) / 1e9);
+        append(text, "secret_app_native_latency_seconds_count{subsystem=\"%s\"} %llu\n", kSubsystemNames[s],
+               static_cast<unsigned long long>(source.operations));
+    }
+
+    if (out && capacity > 0) {
+        const size_t copied = text.size() < capacity - 1 ? text.size() : capacity - 1;
+        memcpy(out, text.data(), copied);
+        out[copied] = '\0';
+    }
+    return text.size();
+}
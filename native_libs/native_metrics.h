@@ -0,0 +1,71 @@
+#ifndef NATIVE_METRICS_H
+#define NATIVE_METRICS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Subsystem native yang dipantau
+#define NATIVE_METRICS_KDF 0
+#define NATIVE_METRICS_CIPHER 1
+#define NATIVE_METRICS_STEGO 2
+#define NATIVE_METRICS_FILE_IO 3
+#define NATIVE_METRICS_CACHE 4
+#define NATIVE_METRICS_SUBSYSTEM_COUNT 5
+
+// Histogram log-linear ala HDR: 16 sub-bucket per pangkat dua (presisi ~6%),
+// nilai dalam nanodetik sampai ~2^43 ns (~2,4 jam), nilai lebih besar masuk bucket terakhir.
+#define NATIVE_METRICS_SUB_BUCKETS 16
+#define NATIVE_METRICS_BUCKETS 640
+
+typedef struct {
+    uint64_t operations;
+    uint64_t errors;
+    uint64_t bytes;
+    uint64_t total_ns;
+    uint64_t max_ns;
+    uint64_t p50_ns;
+    uint64_t p90_ns;
+    uint64_t p99_ns;
+    uint64_t p999_ns;
+} NativeMetricsSubsystemSnapshot;
+
+typedef struct {
+    NativeMetricsSubsystemSnapshot subsystems[NATIVE_METRICS_SUBSYSTEM_COUNT];
+    uint32_t thread_count;   // jumlah blok per-thread yang pernah terdaftar
+    uint32_t enabled;
+} NativeMetricsSnapshot;
+
+// Timestamp monotonic untuk mengukur latency. Return 0 jika metrics dimatikan,
+// sehingga native_metrics_record dengan start 0 tidak mencatat apa-apa.
+uint64_t native_metrics_now_ns(void);
+
+// Catat satu operasi. Lock-free: hanya menulis ke blok milik thread pemanggil.
+void native_metrics_record(int subsystem, uint64_t start_ns, uint64_t bytes, int ok);
+
+// Versi untuk caller yang sudah punya durasi sendiri
+void native_metrics_record_latency(int subsystem, uint64_t latency_ns, uint64_t bytes, int ok);
+
+void native_metrics_set_enabled(int enabled);
+
+// Gabungkan histogram semua thread. Return 0 atau -1 jika out NULL.
+int native_metrics_snapshot(NativeMetricsSnapshot *out);
+
+// Histogram gabungan mentah untuk satu subsystem (counts[NATIVE_METRICS_BUCKETS]).
+int native_metrics_histogram(int subsystem, uint64_t *counts, size_t count_len);
+
+// Batas bawah bucket dalam nanodetik
+uint64_t native_metrics_bucket_lower_ns(uint32_t bucket);
+
+// Format Prometheus text exposition. Seperti snprintf: return panjang yang dibutuhkan
+// (tanpa NUL); output terpotong jika capacity kurang.
+size_t native_metrics_format_prometheus(char *out, size_t capacity);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
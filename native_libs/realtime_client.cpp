@@ -0,0 +1,1114 @@
+#include "realtime_client.h"
+#include "base64.h"
+#include "json_scan.h"
+#include "legacy_formats.h"
+#include "message_aead.h"
+#include "message_record.h"
+#include "spsc_ring.h"
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+static_assert(sizeof(RealtimeMessageHeader) == REALTIME_MESSAGE_HEADER_BYTES, "layout header berubah");
+
+namespace {
+
+// ===============================
+// Socket (POSIX / Winsock)
+// ===============================
+
+#if defined(_WIN32)
+typedef SOCKET socket_t;
+const socket_t kInvalidSocket = INVALID_SOCKET;
+
+bool init_sockets() {
+    static const bool ok = [] {
+        WSADATA data;
+        return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+    }();
+    return ok;
+}
+
+void close_socket(socket_t s) {
+    closesocket(s);
+}
+
+void shutdown_socket(socket_t s) {
+    shutdown(s, SD_BOTH);
+}
+
+bool set_nonblocking(socket_t s, bool enabled) {
+    u_long mode = enabled ? 1 : 0;
+    return ioctlsocket(s, FIONBIO, &mode) == 0;
+}
+
+// > 0 siap, 0 timeout, < 0 error
+int wait_socket(socket_t s, bool write, int timeout_ms) {
+    WSAPOLLFD p;
+    p.fd = s;
+    p.events = write ? POLLWRNORM : POLLRDNORM;
+    p.revents = 0;
+    return WSAPoll(&p, 1, timeout_ms);
+}
+
+bool connect_in_progress() {
+    return WSAGetLastError() == WSAEWOULDBLOCK;
+}
+#else
+typedef int socket_t;
+const socket_t kInvalidSocket = -1;
+
+bool init_sockets() {
+    return true;
+}
+
+void close_socket(socket_t s) {
+    close(s);
+}
+
+void shutdown_socket(socket_t s) {
+    shutdown(s, SHUT_RDWR);
+}
+
+bool set_nonblocking(socket_t s, bool enabled) {
+    const int flags = fcntl(s, F_GETFL, 0);
+    if (flags < 0) return false;
+    return fcntl(s, F_SETFL, enabled ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK)) == 0;
+}
+
+int wait_socket(socket_t s, bool write, int timeout_ms) {
+    struct pollfd p;
+    p.fd = s;
+    p.events = write ? POLLOUT : POLLIN;
+    p.revents = 0;
+    return poll(&p, 1, timeout_ms);
+}
+
+bool connect_in_progress() {
+    return errno == EINPROGRESS;
+}
+#endif
+
+#if defined(MSG_NOSIGNAL)
+constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+constexpr int kSendFlags = 0;
+#endif
+
+bool send_all(socket_t s, const uint8_t *data, size_t len) {
+    while (len > 0) {
+        const int chunk = len > (1u << 30) ? (1 << 30) : (int)len;
+        const int n = (int)send(s, reinterpret_cast<const char *>(data), chunk, kSendFlags);
+        if (n <= 0) return false;
+        data += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+socket_t connect_tcp(const char *host, uint16_t port, int timeout_ms) {
+    if (!init_sockets()) return kInvalidSocket;
+
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    char port_text[8];
+    snprintf(port_text, sizeof(port_text), "%u", (unsigned)port);
+    struct addrinfo *addresses = nullptr;
+    if (getaddrinfo(host, port_text, &hints, &addresses) != 0) return kInvalidSocket;
+
+    socket_t result = kInvalidSocket;
+    for (struct addrinfo *a = addresses; a && result == kInvalidSocket; a = a->ai_next) {
+        socket_t s = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+        if (s == kInvalidSocket) continue;
+        // connect non-blocking supaya timeout berlaku di semua platform
+        bool connected = false;
+        if (set_nonblocking(s, true)) {
+            if (connect(s, a->ai_addr, (int)a->ai_addrlen) == 0) {
+                connected = true;
+            } else if (connect_in_progress() && wait_socket(s, true, timeout_ms) > 0) {
+                int error = 0;
+                socklen_t error_len = sizeof(error);
+                connected = getsockopt(s, SOL_SOCKET, SO_ERROR, reinterpret_cast<char *>(&error), &error_len) == 0 &&
+                            error == 0;
+            }
+        }
+        if (connected && set_nonblocking(s, false)) {
+            result = s;
+        } else {
+            close_socket(s);
+        }
+    }
+    freeaddrinfo(addresses);
+    if (result == kInvalidSocket) return result;
+
+    int one = 1;
+    setsockopt(result, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char *>(&one), sizeof(one));
+#if defined(SO_NOSIGPIPE)
+    setsockopt(result, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+    return result;
+}
+
+// ===============================
+// WebSocket (RFC 6455), sisi client
+// ===============================
+
+constexpr uint8_t kOpContinuation = 0x0;
+constexpr uint8_t kOpText = 0x1;
+constexpr uint8_t kOpBinary = 0x2;
+constexpr uint8_t kOpClose = 0x8;
+constexpr uint8_t kOpPing = 0x9;
+constexpr uint8_t kOpPong = 0xA;
+
+constexpr size_t kMaxMessageBytes = 16u * 1024 * 1024;
+constexpr size_t kMaxHandshakeBytes = 16 * 1024;
+constexpr char kWebSocketGuid[] = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+
+// SHA-1 hanya untuk memverifikasi Sec-WebSocket-Accept (bukan penggunaan kriptografis)
+void sha1(const uint8_t *data, size_t len, uint8_t out[20]) {
+    uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+    std::vector<uint8_t> msg(data, data + len);
+    msg.push_back(0x80);
+    while (msg.size() % 64 != 56) msg.push_back(0);
+    const uint64_t bits = (uint64_t)len * 8;
+    for (int i = 7; i >= 0; i--) msg.push_back((uint8_t)(bits >> (8 * i)));
+
+    for (size_t block = 0; block < msg.size(); block += 64) {
+        uint32_t w[80];
+        for (int i = 0; i < 16; i++) {
+            const uint8_t *p = &msg[block + 4 * i];
+            w[i] = ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+        }
+        for (int i = 16; i < 80; i++) {
+            const uint32_t x = w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16];
+            w[i] = (x << 1) | (x >> 31);
+        }
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+        for (int i = 0; i < 80; i++) {
+            uint32_t f, k;
+            if (i < 20) {
+                f = (b & c) | (~b & d);
+                k = 0x5A827999;
+            } else if (i < 40) {
+                f = b ^ c ^ d;
+                k = 0x6ED9EBA1;
+            } else if (i < 60) {
+                f = (b & c) | (b & d) | (c & d);
+                k = 0x8F1BBCDC;
+            } else {
+                f = b ^ c ^ d;
+                k = 0xCA62C1D6;
+            }
+            const uint32_t t = ((a << 5) | (a >> 27)) + f + e + k + w[i];
+            e = d;
+            d = c;
+            c = (b << 30) | (b >> 2);
+            b = a;
+            a = t;
+        }
+        h[0] += a;
+        h[1] += b;
+        h[2] += c;
+        h[3] += d;
+        h[4] += e;
+    }
+    for (int i = 0; i < 5; i++) {
+        out[4 * i] = (uint8_t)(h[i] >> 24);
+        out[4 * i + 1] = (uint8_t)(h[i] >> 16);
+        out[4 * i + 2] = (uint8_t)(h[i] >> 8);
+        out[4 * i + 3] = (uint8_t)h[i];
+    }
+}
+
+std::string base64_string(const uint8_t *data, size_t len) {
+    std::string out(base64_encoded_length(len), '\0');
+    out.resize(base64_encode(&out[0], data, len));
+    return out;
+}
+
+char lower_ascii(char c) {
+    return c >= 'A' && c <= 'Z' ? (char)(c - 'A' + 'a') : c;
+}
+
+// Nilai header (case-insensitive) dari response handshake, tanpa spasi di sekitarnya
+bool find_header(const std::string &response, const char *name, std::string &value) {
+    const size_t name_len = strlen(name);
+    size_t line = response.find("\r\n");
+    while (line != std::string::npos && line + 2 < response.size()) {
+        const size_t start = line + 2;
+        const size_t end = response.find("\r\n", start);
+        if (end == std::string::npos || end == start) return false;
+        bool match = end - start > name_len && response[start + name_len] == ':';
+        for (size_t i = 0; match && i < name_len; i++) {
+            match = lower_ascii(response[start + i]) == lower_ascii(name[i]);
+        }
+        if (match) {
+            size_t a = start + name_len + 1;
+            size_t b = end;
+            while (a < b && (response[a] == ' ' || response[a] == '\t')) a++;
+            while (b > a && (response[b - 1] == ' ' || response[b - 1] == '\t')) b--;
+            value.assign(response, a, b - a);
+            return true;
+        }
+        line = end;
+    }
+    return false;
+}
+
+// ===============================
+// JSON: builder pesan keluar dan helper token
+// ===============================
+
+void append_json_string(std::string &out, const std::string &value) {
+    out += '"';
+    for (const unsigned char c : value) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += (char)c;
+        } else if (c < 0x20) {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            out += escaped;
+        } else {
+            out += (char)c;
+        }
+    }
+    out += '"';
+}
+
+struct Json {
+    const char *text;
+    const JsonToken *tokens;
+    uint32_t count;
+
+    int32_t find(int32_t object, const char *key) const {
+        if (object < 0) return -1;
+        return json_scan_find(text, tokens, count, (uint32_t)object, key);
+    }
+
+    bool is(int32_t token, uint8_t type) const {
+        return token >= 0 && tokens[token].type == type;
+    }
+
+    // String hasil unescape; false jika bukan string atau escape tidak valid
+    bool string(int32_t token, std::string &out) const {
+        if (!is(token, JSON_TOKEN_STRING)) return false;
+        out.resize(tokens[token].len);
+        const int64_t n = json_scan_unescape(out.empty() ? nullptr : &out[0], text, &tokens[token]);
+        if (n < 0 && !out.empty()) return false;
+        out.resize(n < 0 ? 0 : (size_t)n);
+        return true;
+    }
+
+    bool equals(int32_t token, const char *value) const {
+        std::string s;
+        return string(token, s) && s == value;
+    }
+
+    // Angka dibaca apa adanya (mis. id bigint)
+    bool scalar_text(int32_t token, std::string &out) const {
+        if (is(token, JSON_TOKEN_NUMBER)) {
+            out.assign(text + tokens[token].start, tokens[token].len);
+            return true;
+        }
+        return string(token, out);
+    }
+};
+
+bool utf8_valid(const std::string &s) {
+    return legacy_utf8_valid(reinterpret_cast<const uint8_t *>(s.data()), s.size()) != 0;
+}
+
+bool decode_base64(const std::string &text, std::vector<uint8_t> &out) {
+    out.resize(base64_decoded_max_length(text.size()) + 1);
+    const int64_t n = base64_decode(out.data(), text.data(), text.size());
+    if (n < 0) return false;
+    out.resize((size_t)n);
+    return true;
+}
+
+int64_t days_from_civil(int64_t y, int64_t m, int64_t d) {
+    y -= m <= 2;
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const int64_t yoe = y - era * 400;
+    const int64_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+bool read_digits(const char *&p, const char *end, int count, int64_t &out) {
+    out = 0;
+    for (int i = 0; i < count; i++) {
+        if (p >= end || *p < '0' || *p > '9') return false;
+        out = out * 10 + (*p++ - '0');
+    }
+    return true;
+}
+
+// Timestamp Postgres/ISO 8601: YYYY-MM-DD[T ]HH:MM:SS[.ffffff][Z|+HH[:MM]|-HH[:MM]]
+bool parse_timestamp_us(const std::string &text, int64_t &out) {
+    const char *p = text.data();
+    const char *end = p + text.size();
+    int64_t year, month, day, hour, minute, second;
+    if (!read_digits(p, end, 4, year) || p >= end || *p++ != '-' || !read_digits(p, end, 2, month) ||
+        p >= end || *p++ != '-' || !read_digits(p, end, 2, day) || p >= end || (*p != 'T' && *p != ' ')) {
+        return false;
+    }
+    p++;
+    if (!read_digits(p, end, 2, hour) || p >= end || *p++ != ':' || !read_digits(p, end, 2, minute) ||
+        p >= end || *p++ != ':' || !read_digits(p, end, 2, second)) {
+        return false;
+    }
+    if (month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 60) return false;
+
+    int64_t micros = 0;
+    if (p < end && *p == '.') {
+        p++;
+        int digits = 0;
+        while (p < end && *p >= '0' && *p <= '9') {
+            if (digits < 6) micros = micros * 10 + (*p - '0');
+            digits++;
+            p++;
+        }
+        if (digits == 0) return false;
+        for (; digits < 6; digits++) micros *= 10;
+    }
+
+    int64_t offset_seconds = 0;
+    if (p < end && (*p == 'Z' || *p == 'z')) {
+        p++;
+    } else if (p < end && (*p == '+' || *p == '-')) {
+        const int64_t sign = *p++ == '-' ? -1 : 1;
+        int64_t oh, om = 0;
+        if (!read_digits(p, end, 2, oh)) return false;
+        if (p < end && *p == ':') p++;
+        if (p < end && !read_digits(p, end, 2, om)) return false;
+        offset_seconds = sign * (oh * 3600 + om * 60);
+    }
+    if (p != end) return false;
+
+    const int64_t seconds = days_from_civil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second;
+    out = (seconds - offset_seconds) * 1000000 + micros;
+    return true;
+}
+
+// Nama algoritma di kolom messages.algorithm (lihat MessageAeadFFI.algorithmName);
+// NULL/tidak ada = xor_with_iv lama
+bool algorithm_from_name(const std::string &name, uint8_t &out) {
+    if (name == "chacha20_poly1305") {
+        out = MESSAGE_AEAD_CHACHA20_POLY1305;
+    } else if (name == "ascon128a") {
+        out = MESSAGE_AEAD_ASCON128A;
+    } else if (name == "aes256_gcm") {
+        out = MESSAGE_AEAD_AES256_GCM;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void secure_wipe(void *p, size_t len) {
+    volatile uint8_t *v = static_cast<volatile uint8_t *>(p);
+    for (size_t i = 0; i < len; i++) {
+        v[i] = 0;
+    }
+}
+
+// Pesan INSERT dari satu batch frame, diurutkan sesuai kedatangan
+struct PendingMessage {
+    std::string id;
+    std::string sender;
+    int64_t created_at_us = 0;
+    uint8_t algorithm = MESSAGE_RECORD_ALG_XOR_WITH_IV;
+    int32_t status = MESSAGE_RECORD_OK;   // != OK: baris tidak valid, tidak ikut buffer record
+};
+
+}  // namespace
+
+struct RealtimeClient {
+    std::string topic;
+    std::string schema = "public";
+    std::string table = "messages";
+    std::string filter;
+    std::string access_token;
+    bool has_filter = false;
+    bool has_token = false;
+    std::vector<uint8_t> chat_key;
+    std::vector<uint8_t> aead_key;
+    uint32_t heartbeat_ms = 25000;
+
+    // Ring satu producer: worker, reader dan thread pemanggil bergantian lewat ring_mutex
+    SpscRing *ring = nullptr;
+    std::mutex ring_mutex;
+
+    std::mutex mutex;
+    std::condition_variable work_cv;
+    std::deque<std::string> frames;
+    bool stopping = false;
+    bool started = false;
+    bool external = false;
+    std::thread worker;
+    std::thread reader;
+
+    socket_t sock = kInvalidSocket;
+    std::mutex send_mutex;
+    std::mt19937 mask_rng{std::random_device{}()};
+
+    std::atomic<uint64_t> next_ref{1};
+    std::string join_ref;
+    std::atomic<uint64_t> pending_heartbeat{0};
+    std::atomic<bool> closed_reported{false};
+
+    std::atomic<uint64_t> frames_parsed{0};
+    std::atomic<uint64_t> frame_bytes{0};
+    std::atomic<uint64_t> parse_errors{0};
+    std::atomic<uint64_t> ignored_events{0};
+    std::atomic<uint64_t> inserts{0};
+    std::atomic<uint64_t> decrypted{0};
+    std::atomic<uint64_t> decrypt_failures{0};
+    std::atomic<uint64_t> batches{0};
+    std::atomic<uint64_t> heartbeats{0};
+    std::atomic<uint64_t> dropped{0};
+
+    bool is_stopping() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return stopping;
+    }
+
+    // Tulis ke ring tanpa membuang record: tunggu consumer, kecuali client sedang di-destroy
+    bool write_ring(uint32_t tag, const uint8_t *data, size_t len) {
+        if (len > UINT32_MAX) return false;
+        std::lock_guard<std::mutex> lock(ring_mutex);
+        for (;;) {
+            const int rc = spsc_ring_write(ring, tag, data, (uint32_t)len, 100);
+            if (rc == SPSC_RING_OK) return true;
+            if (rc != SPSC_RING_ERROR_FULL || is_stopping()) {
+                dropped++;
+                return false;
+            }
+        }
+    }
+
+    void flush_ring() {
+        std::lock_guard<std::mutex> lock(ring_mutex);
+        spsc_ring_flush(ring);
+    }
+
+    void report_state(int32_t state, const std::string &detail) {
+        if (state == REALTIME_STATE_CLOSED && closed_reported.exchange(true)) return;
+        std::vector<uint8_t> payload(sizeof(int32_t));
+        memcpy(payload.data(), &state, sizeof(state));
+        payload.insert(payload.end(), detail.begin(), detail.end());
+        write_ring(REALTIME_TAG_STATE, payload.data(), payload.size());
+        flush_ring();
+    }
+
+    bool send_frame(uint8_t opcode, const uint8_t *data, size_t len) {
+        std::lock_guard<std::mutex> lock(send_mutex);
+        if (sock == kInvalidSocket) return false;
+        std::vector<uint8_t> frame;
+        frame.reserve(len + 14);
+        frame.push_back((uint8_t)(0x80 | opcode));
+        if (len < 126) {
+            frame.push_back((uint8_t)(0x80 | len));
+        } else if (len <= 0xFFFF) {
+            frame.push_back(0x80 | 126);
+            frame.push_back((uint8_t)(len >> 8));
+            frame.push_back((uint8_t)len);
+        } else {
+            frame.push_back(0x80 | 127);
+            for (int i = 7; i >= 0; i--) frame.push_back((uint8_t)((uint64_t)len >> (8 * i)));
+        }
+        // Frame dari client wajib di-mask (RFC 6455 5.3)
+        const uint32_t mask = mask_rng();
+        uint8_t mask_bytes[4];
+        memcpy(mask_bytes, &mask, sizeof(mask_bytes));
+        frame.insert(frame.end(), mask_bytes, mask_bytes + 4);
+        const size_t payload = frame.size();
+        frame.resize(payload + len);
+        for (size_t i = 0; i < len; i++) frame[payload + i] = data[i] ^ mask_bytes[i & 3];
+        return send_all(sock, frame.data(), frame.size());
+    }
+
+    // Pesan Phoenix keluar: ke socket sendiri, atau ke ring untuk transport eksternal
+    void send_text(const std::string &text) {
+        const uint8_t *data = reinterpret_cast<const uint8_t *>(text.data());
+        if (external) {
+            write_ring(REALTIME_TAG_OUTBOUND, data, text.size());
+            flush_ring();
+        } else {
+            send_frame(kOpText, data, text.size());
+        }
+    }
+
+    std::string make_ref() {
+        return std::to_string(next_ref.fetch_add(1));
+    }
+
+    void send_join() {
+        join_ref = make_ref();
+        std::string msg = "{\"topic\":";
+        append_json_string(msg, topic);
+        msg += ",\"event\":\"phx_join\",\"payload\":{\"config\":{\"broadcast\":{\"self\":false},"
+               "\"presence\":{\"key\":\"\"},\"postgres_changes\":[{\"event\":\"INSERT\",\"schema\":";
+        append_json_string(msg, schema);
+        msg += ",\"table\":";
+        append_json_string(msg, table);
+        if (has_filter) {
+            msg += ",\"filter\":";
+            append_json_string(msg, filter);
+        }
+        msg += "}]}";
+        if (has_token) {
+            msg += ",\"access_token\":";
+            append_json_string(msg, access_token);
+        }
+        msg += "},\"ref\":";
+        append_json_string(msg, join_ref);
+        msg += ",\"join_ref\":";
+        append_json_string(msg, join_ref);
+        msg += "}";
+        send_text(msg);
+    }
+
+    // Return false jika heartbeat sebelumnya belum dibalas (koneksi dianggap mati)
+    bool send_heartbeat() {
+        const uint64_t ref = next_ref.fetch_add(1);
+        if (pending_heartbeat.exchange(ref) != 0) {
+            report_state(REALTIME_STATE_CLOSED, "heartbeat timeout");
+            return false;
+        }
+        heartbeats++;
+        send_text("{\"topic\":\"phoenix\",\"event\":\"heartbeat\",\"payload\":{},\"ref\":\"" + std::to_string(ref) +
+                  "\"}");
+        return true;
+    }
+
+    void enqueue_frame(std::string frame) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            frames.push_back(std::move(frame));
+        }
+        work_cv.notify_one();
+    }
+
+    void worker_loop();
+    void reader_loop(std::vector<uint8_t> pending);
+    void process_batch(std::deque<std::string> &batch);
+    void handle_frame(const std::string &frame, std::vector<JsonToken> &tokens, std::vector<PendingMessage> &messages,
+                      std::vector<uint8_t> &records);
+    void append_insert(const Json &json, int32_t record, std::vector<PendingMessage> &messages,
+                       std::vector<uint8_t> &records);
+    void deliver(std::vector<PendingMessage> &messages, std::vector<uint8_t> &records);
+};
+
+void RealtimeClient::worker_loop() {
+    using clock = std::chrono::steady_clock;
+    auto next_heartbeat = clock::now() + std::chrono::milliseconds(heartbeat_ms);
+    std::deque<std::string> batch;
+
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (external) {
+                // Transport eksternal: heartbeat dijadwalkan di sini (reader native punya sendiri)
+                work_cv.wait_until(lock, next_heartbeat, [this] { return stopping || !frames.empty(); });
+            } else {
+                work_cv.wait(lock, [this] { return stopping || !frames.empty(); });
+            }
+            if (stopping) return;
+            batch.swap(frames);
+        }
+
+        if (!batch.empty()) process_batch(batch);
+        if (external && !closed_reported && clock::now() >= next_heartbeat) {
+            send_heartbeat();
+            next_heartbeat = clock::now() + std::chrono::milliseconds(heartbeat_ms);
+        }
+    }
+}
+
+// Satu batch = semua frame yang menumpuk sejak batch sebelumnya; seluruh INSERT di
+// dalamnya didecrypt dengan satu message_record_decrypt_all dan dipublikasikan sekali
+void RealtimeClient::process_batch(std::deque<std::string> &batch) {
+    std::vector<JsonToken> tokens(256);
+    std::vector<PendingMessage> messages;
+    std::vector<uint8_t> records;
+
+    for (const std::string &frame : batch) {
+        frames_parsed++;
+        frame_bytes += frame.size();
+        handle_frame(frame, tokens, messages, records);
+    }
+    batch.clear();
+    if (!messages.empty()) deliver(messages, records);
+    secure_wipe(records.data(), records.size());
+}
+
+void RealtimeClient::handle_frame(const std::string &frame, std::vector<JsonToken> &tokens,
+                                  std::vector<PendingMessage> &messages, std::vector<uint8_t> &records) {
+    int32_t count = json_scan_parse(frame.data(), frame.size(), tokens.data(), (uint32_t)tokens.size());
+    if (count == JSON_SCAN_ERROR_TOO_MANY_TOKENS) {
+        // Satu token minimal 2 byte termasuk pemisah, jadi ini batas atas
+        tokens.resize(frame.size() / 2 + 2);
+        count = json_scan_parse(frame.data(), frame.size(), tokens.data(), (uint32_t)tokens.size());
+    }
+    if (count < 0 || tokens[0].type != JSON_TOKEN_OBJECT) {
+        parse_errors++;
+        return;
+    }
+
+    const Json json = {frame.data(), tokens.data(), (uint32_t)count};
+    std::string event, msg_topic, ref;
+    if (!json.string(json.find(0, "event"), event) || !json.string(json.find(0, "topic"), msg_topic)) {
+        parse_errors++;
+        return;
+    }
+    json.string(json.find(0, "ref"), ref);
+    const int32_t payload = json.find(0, "payload");
+
+    if (event == "phx_reply") {
+        if (msg_topic == "phoenix") {
+            if (!ref.empty() && std::to_string(pending_heartbeat.load()) == ref) pending_heartbeat = 0;
+        } else if (msg_topic == topic && ref == join_ref) {
+            if (json.equals(json.find(payload, "status"), "ok")) {
+                report_state(REALTIME_STATE_JOINED, "");
+            } else {
+                const int32_t response = json.find(payload, "response");
+                std::string reason;
+                if (!json.string(json.find(response, "reason"), reason) && response >= 0) {
+                    reason.assign(frame.data() + tokens[response].start, tokens[response].len);
+                }
+                report_state(REALTIME_STATE_JOIN_FAILED, reason);
+            }
+        } else {
+            ignored_events++;
+        }
+        return;
+    }
+    if (msg_topic != topic) {
+        ignored_events++;
+        return;
+    }
+    if (event == "phx_error" || event == "phx_close") {
+        report_state(REALTIME_STATE_CLOSED, event);
+        return;
+    }
+
+    int32_t record = -1;
+    if (event == "postgres_changes") {
+        // Realtime v2: payload.data = {type, schema, table, record, ...}
+        const int32_t data = json.find(payload, "data");
+        if (json.equals(json.find(data, "type"), "INSERT") && json.equals(json.find(data, "table"), table.c_str())) {
+            record = json.find(data, "record");
+        }
+    } else if (event == "INSERT") {
+        // Format lama: event = tipe perubahan, payload = {type, record, ...}
+        record = json.find(payload, "record");
+    }
+    if (!json.is(record, JSON_TOKEN_OBJECT)) {
+        ignored_events++;
+        return;
+    }
+    append_insert(json, record, messages, records);
+}
+
+void RealtimeClient::append_insert(const Json &json, int32_t record, std::vector<PendingMessage> &messages,
+                                   std::vector<uint8_t> &records) {
+    PendingMessage message;
+    if (!json.scalar_text(json.find(record, "id"), message.id) || message.id.empty() || !utf8_valid(message.id)) {
+        parse_errors++;
+        return;
+    }
+    inserts++;
+
+    std::string created_at, algorithm, ciphertext_text, iv_text;
+    std::vector<uint8_t> ciphertext, iv;
+    const int32_t algorithm_token = json.find(record, "algorithm");
+    bool valid = json.scalar_text(json.find(record, "sender_id"), message.sender) && utf8_valid(message.sender) &&
+                 json.string(json.find(record, "created_at"), created_at) &&
+                 parse_timestamp_us(created_at, message.created_at_us) &&
+                 json.string(json.find(record, "encrypted_message"), ciphertext_text) &&
+                 decode_base64(ciphertext_text, ciphertext) && json.string(json.find(record, "iv"), iv_text) &&
+                 decode_base64(iv_text, iv) && iv.size() <= MESSAGE_RECORD_MAX_NONCE_BYTES;
+    if (valid && json.string(algorithm_token, algorithm)) {
+        valid = algorithm_from_name(algorithm, message.algorithm);
+    } else if (valid && algorithm_token >= 0 && !json.is(algorithm_token, JSON_TOKEN_NULL)) {
+        valid = false;
+    }
+    if (!valid) {
+        message.status = MESSAGE_RECORD_ERROR_MALFORMED;
+        messages.push_back(std::move(message));
+        return;
+    }
+
+    MessageRecordHeader header;
+    memset(&header, 0, sizeof(header));
+    header.algorithm = message.algorithm;
+    header.nonce_len = (uint8_t)iv.size();
+    header.flags = MESSAGE_RECORD_FLAG_TEXT_ID | MESSAGE_RECORD_FLAG_TEXT_SENDER;
+    header.created_at_us = message.created_at_us;
+    if (!iv.empty()) memcpy(header.nonce, iv.data(), iv.size());
+
+    const uint32_t size = message_record_size(header.flags, (uint32_t)message.id.size(),
+                                              (uint32_t)message.sender.size(), (uint32_t)ciphertext.size());
+    const size_t offset = records.size();
+    records.resize(offset + size);
+    const uint32_t written = message_record_write(
+        records.data() + offset, size, &header, reinterpret_cast<const uint8_t *>(message.id.data()),
+        (uint32_t)message.id.size(), reinterpret_cast<const uint8_t *>(message.sender.data()),
+        (uint32_t)message.sender.size(), ciphertext.data(), (uint32_t)ciphertext.size());
+    if (size == 0 || written != size) {
+        records.resize(offset);
+        message.status = MESSAGE_RECORD_ERROR_MALFORMED;
+    }
+    messages.push_back(std::move(message));
+}
+
+void RealtimeClient::deliver(std::vector<PendingMessage> &messages, std::vector<uint8_t> &records) {
+    uint32_t record_count = 0;
+    size_t ciphertext_bytes = 0;
+    for (const PendingMessage &m : messages) {
+        if (m.status == MESSAGE_RECORD_OK) record_count++;
+    }
+
+    std::vector<MessageRecordPlain> plains(record_count);
+    std::vector<uint8_t> plaintext;
+    if (record_count > 0) {
+        std::vector<MessageRecordView> views(record_count);
+        message_record_index(records.data(), records.size(), views.data(), record_count);
+        for (const MessageRecordView &view : views) ciphertext_bytes += view.ciphertext_len;
+        plaintext.resize(ciphertext_bytes + 1);
+        batches++;
+        const int32_t rc = message_record_decrypt_all(records.data(), records.size(), chat_key.data(), chat_key.size(),
+                                                      aead_key.empty() ? nullptr : aead_key.data(), plaintext.data(),
+                                                      plaintext.size(), plains.data(), record_count);
+        if (rc < 0) {
+            for (MessageRecordPlain &plain : plains) {
+                plain.text_len = 0;
+                plain.status = rc;
+            }
+        }
+    }
+
+    // Record ke-k di buffer = pesan valid ke-k
+    uint32_t next_record = 0;
+    std::vector<uint8_t> payload;
+    for (const PendingMessage &m : messages) {
+        RealtimeMessageHeader header;
+        memset(&header, 0, sizeof(header));
+        header.created_at_us = m.created_at_us;
+        header.algorithm = m.algorithm;
+        header.status = m.status;
+        const uint8_t *text = nullptr;
+        if (m.status == MESSAGE_RECORD_OK) {
+            const MessageRecordPlain &plain = plains[next_record++];
+            header.status = plain.status;
+            // AEAD tidak memvalidasi UTF-8 (xor_with_iv sudah di legacy decoder)
+            if (plain.status == MESSAGE_RECORD_OK && !legacy_utf8_valid(plain.text, plain.text_len)) {
+                header.status = MESSAGE_RECORD_ERROR_MALFORMED;
+            }
+            if (header.status == MESSAGE_RECORD_OK) {
+                text = plain.text;
+                header.text_len = plain.text_len;
+            }
+        }
+        if (header.status == MESSAGE_RECORD_OK) {
+            decrypted++;
+        } else {
+            decrypt_failures++;
+        }
+        header.id_len = (uint32_t)m.id.size();
+        header.sender_len = (uint32_t)m.sender.size();
+
+        payload.resize(sizeof(header) + header.id_len + header.sender_len + header.text_len);
+        uint8_t *p = payload.data();
+        memcpy(p, &header, sizeof(header));
+        p += sizeof(header);
+        memcpy(p, m.id.data(), header.id_len);
+        p += header.id_len;
+        if (header.sender_len) memcpy(p, m.sender.data(), header.sender_len);
+        p += header.sender_len;
+        if (header.text_len) memcpy(p, text, header.text_len);
+        write_ring(REALTIME_TAG_MESSAGE, payload.data(), payload.size());
+        secure_wipe(payload.data(), payload.size());
+    }
+    flush_ring();
+    secure_wipe(plaintext.data(), plaintext.size());
+}
+
+void RealtimeClient::reader_loop(std::vector<uint8_t> buffer) {
+    using clock = std::chrono::steady_clock;
+    auto next_heartbeat = clock::now() + std::chrono::milliseconds(heartbeat_ms);
+    std::string message;
+    uint8_t message_opcode = 0;
+    bool in_message = false;
+    std::vector<uint8_t> chunk(16 * 1024);
+    bool open = true;
+
+    while (open && !is_stopping()) {
+        const auto now = clock::now();
+        if (now >= next_heartbeat) {
+            if (!send_heartbeat()) break;
+            next_heartbeat = now + std::chrono::milliseconds(heartbeat_ms);
+        }
+        const int timeout_ms =
+            (int)std::chrono::duration_cast<std::chrono::milliseconds>(next_heartbeat - now).count() + 1;
+        const int ready = wait_socket(sock, false, timeout_ms);
+        if (ready < 0) break;
+        if (ready == 0) continue;
+
+        const int n = (int)recv(sock, reinterpret_cast<char *>(chunk.data()), (int)chunk.size(), 0);
+        if (n <= 0) break;
+        buffer.insert(buffer.end(), chunk.begin(), chunk.begin() + n);
+
+        size_t pos = 0;
+        while (open) {
+            const size_t available = buffer.size() - pos;
+            if (available < 2) break;
+            const uint8_t *p = buffer.data() + pos;
+            const bool fin = (p[0] & 0x80) != 0;
+            const uint8_t opcode = p[0] & 0x0F;
+            // Extension tidak dinegosiasikan (RSV harus 0) dan frame server tidak boleh di-mask
+            if ((p[0] & 0x70) || (p[1] & 0x80)) {
+                open = false;
+                break;
+            }
+            size_t header_len = 2;
+            uint64_t len = p[1] & 0x7F;
+            if (len == 126) {
+                if (available < 4) break;
+                len = ((uint64_t)p[2] << 8) | p[3];
+                header_len = 4;
+            } else if (len == 127) {
+                if (available < 10) break;
+                len = 0;
+                for (int i = 0; i < 8; i++) len = (len << 8) | p[2 + i];
+                header_len = 10;
+            }
+            if (len > kMaxMessageBytes || message.size() + len > kMaxMessageBytes) {
+                open = false;
+                break;
+            }
+            if (available - header_len < len) break;
+            const uint8_t *data = p + header_len;
+            pos += header_len + (size_t)len;
+
+            if (opcode >= 0x8) {
+                if (!fin || len > 125) {
+                    open = false;
+                } else if (opcode == kOpClose) {
+                    send_frame(kOpClose, data, len >= 2 ? 2 : 0);
+                    open = false;
+                } else if (opcode == kOpPing) {
+                    send_frame(kOpPong, data, (size_t)len);
+                }
+                continue;
+            }
+            if (opcode == kOpContinuation ? !in_message : (in_message || (opcode != kOpText && opcode != kOpBinary))) {
+                open = false;
+                break;
+            }
+            if (opcode != kOpContinuation) {
+                message_opcode = opcode;
+                in_message = true;
+            }
+            message.append(reinterpret_cast<const char *>(data), (size_t)len);
+            if (fin) {
+                // Serializer JSON Phoenix selalu text frame; binary (serializer v2) diabaikan
+                if (message_opcode == kOpText) {
+                    enqueue_frame(std::move(message));
+                } else {
+                    ignored_events++;
+                }
+                message.clear();
+                in_message = false;
+            }
+        }
+        buffer.erase(buffer.begin(), buffer.begin() + pos);
+    }
+
+    if (!is_stopping()) report_state(REALTIME_STATE_CLOSED, "connection closed");
+}
+
+extern "C" RealtimeClient *realtime_client_create(const RealtimeClientConfig *config, SpscRing *ring) {
+    if (!config || !ring || !config->topic || !config->topic[0] || !config->chat_key || config->chat_key_len == 0) {
+        return nullptr;
+    }
+
+    RealtimeClient *client = new RealtimeClient();
+    client->topic = config->topic;
+    if (config->schema) client->schema = config->schema;
+    if (config->table) client->table = config->table;
+    if (config->filter) {
+        client->filter = config->filter;
+        client->has_filter = true;
+    }
+    if (config->access_token) {
+        client->access_token = config->access_token;
+        client->has_token = true;
+    }
+    client->chat_key.assign(config->chat_key, config->chat_key + config->chat_key_len);
+    if (config->aead_key) client->aead_key.assign(config->aead_key, config->aead_key + MESSAGE_AEAD_KEY_BYTES);
+    if (config->heartbeat_ms) client->heartbeat_ms = config->heartbeat_ms;
+    client->ring = ring;
+    return client;
+}
+
+extern "C" void realtime_client_destroy(RealtimeClient *client) {
+    if (!client) return;
+    {
+        std::lock_guard<std::mutex> lock(client->mutex);
+        client->stopping = true;
+    }
+    client->work_cv.notify_all();
+    if (client->sock != kInvalidSocket) {
+        const uint8_t normal_closure[2] = {0x03, 0xE8};
+        client->send_frame(kOpClose, normal_closure, sizeof(normal_closure));
+        shutdown_socket(client->sock);
+    }
+    if (client->reader.joinable()) client->reader.join();
+    if (client->worker.joinable()) client->worker.join();
+    if (client->sock != kInvalidSocket) close_socket(client->sock);
+
+    secure_wipe(client->chat_key.data(), client->chat_key.size());
+    secure_wipe(client->aead_key.data(), client->aead_key.size());
+    if (!client->access_token.empty()) secure_wipe(&client->access_token[0], client->access_token.size());
+    delete client;
+}
+
+extern "C" int realtime_client_connect(RealtimeClient *client, const char *host, uint16_t port,
+                                       const char *path, int32_t timeout_ms) {
+    if (!client || !host || !path || path[0] != '/') return REALTIME_ERROR_INVALID_INPUT;
+    {
+        std::lock_guard<std::mutex> lock(client->mutex);
+        if (client->started) return REALTIME_ERROR_STATE;
+        client->started = true;
+    }
+    // Gagal sebelum thread berjalan: client boleh mencoba connect lagi
+    auto fail = [client](socket_t sock, int rc) {
+        if (sock != kInvalidSocket) close_socket(sock);
+        std::lock_guard<std::mutex> lock(client->mutex);
+        client->started = false;
+        return rc;
+    };
+    if (timeout_ms <= 0) timeout_ms = 10000;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+
+    const socket_t sock = connect_tcp(host, port, timeout_ms);
+    if (sock == kInvalidSocket) return fail(sock, REALTIME_ERROR_CONNECT);
+
+    uint8_t nonce[16];
+    std::random_device random;
+    for (size_t i = 0; i < sizeof(nonce); i += 4) {
+        const uint32_t r = random();
+        memcpy(nonce + i, &r, 4);
+    }
+    const std::string key = base64_string(nonce, sizeof(nonce));
+    std::string request = "GET ";
+    request += path;
+    request += " HTTP/1.1\r\nHost: ";
+    request += host;
+    request += ":" + std::to_string(port);
+    request += "\r\nUpgrade: websocket\r\nConnection: Upgrade\r\nSec-WebSocket-Key: " + key +
+               "\r\nSec-WebSocket-Version: 13\r\n\r\n";
+    if (!send_all(sock, reinterpret_cast<const uint8_t *>(request.data()), request.size())) {
+        return fail(sock, REALTIME_ERROR_CONNECT);
+    }
+
+    // Response handshake; byte setelah header sudah milik stream frame
+    std::string response;
+    size_t header_end = std::string::npos;
+    char chunk[1024];
+    while (header_end == std::string::npos) {
+        const auto remaining =
+            std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+        if (remaining <= 0 || response.size() > kMaxHandshakeBytes || wait_socket(sock, false, (int)remaining) <= 0) {
+            return fail(sock, REALTIME_ERROR_HANDSHAKE);
+        }
+        const int n = (int)recv(sock, chunk, sizeof(chunk), 0);
+        if (n <= 0) return fail(sock, REALTIME_ERROR_HANDSHAKE);
+        response.append(chunk, (size_t)n);
+        header_end = response.find("\r\n\r\n");
+    }
+
+    const std::string accept_input = key + kWebSocketGuid;
+    uint8_t digest[20];
+    sha1(reinterpret_cast<const uint8_t *>(accept_input.data()), accept_input.size(), digest);
+    std::string accept;
+    if (response.compare(0, 13, "HTTP/1.1 101 ") != 0 ||
+        !find_header(response.substr(0, header_end + 2), "sec-websocket-accept", accept) ||
+        accept != base64_string(digest, sizeof(digest))) {
+        return fail(sock, REALTIME_ERROR_HANDSHAKE);
+    }
+    std::vector<uint8_t> leftover(response.begin() + header_end + 4, response.end());
+
+    client->sock = sock;
+    client->external = false;
+    client->worker = std::thread([client] { client->worker_loop(); });
+    client->send_join();
+    client->reader = std::thread([client, leftover]() mutable { client->reader_loop(std::move(leftover)); });
+    return REALTIME_OK;
+}
+
+extern "C" int realtime_client_start_external(RealtimeClient *client) {
+    if (!client) return REALTIME_ERROR_INVALID_INPUT;
+    {
+        std::lock_guard<std::mutex> lock(client->mutex);
+        if (client->started) return REALTIME_ERROR_STATE;
+        client->started = true;
+        client->external = true;
+    }
+    client->worker = std::thread([client] { client->worker_loop(); });
+    client->send_join();
+    return REALTIME_OK;
+}
+
+extern "C" int realtime_client_feed(RealtimeClient *client, const uint8_t *frame, size_t len) {
+    if (!client || !frame || len == 0 || len > kMaxMessageBytes) return REALTIME_ERROR_INVALID_INPUT;
+    {
+        std::lock_guard<std::mutex> lock(client->mutex);
+        if (!client->started || !client->external || client->stopping) return REALTIME_ERROR_STATE;
+    }
+    client->enqueue_frame(std::string(reinterpret_cast<const char *>(frame), len));
+    return REALTIME_OK;
+}
+
+extern "C" void realtime_client_get_stats(RealtimeClient *client, RealtimeClientStats *out) {
+    if (!client || !out) return;
+    out->frames = client->frames_parsed.load();
+    out->frame_bytes = client->frame_bytes.load();
+    out->parse_errors = client->parse_errors.load();
+    out->ignored_events = client->ignored_events.load();
+    out->inserts = client->inserts.load();
+    out->decrypted = client->decrypted.load();
+    out->decrypt_failures = client->decrypt_failures.load();
+    out->batches = client->batches.load();
+    out->heartbeats = client->heartbeats.load();
+    out->dropped = client->dropped.load();
+}
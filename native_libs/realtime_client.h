@@ -0,0 +1,101 @@
+#ifndef REALTIME_CLIENT_H
+#define REALTIME_CLIENT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "spsc_ring.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Client realtime native (subset protokol channel Phoenix yang dipakai Supabase Realtime,
+// serializer JSON vsn 1.0.0) untuk satu chat. Frame diparse dengan json_scan di thread
+// native, baris INSERT tabel pesan dikumpulkan sebagai record biner (message_record.h)
+// lalu didecrypt sekaligus, dan hanya pesan baru yang sudah didecrypt dikirim ke Dart
+// lewat SpscRing. Kerja per event sebanding dengan perubahannya, bukan dengan isi tabel.
+//
+// Dua transport:
+//   - realtime_client_connect: WebSocket ws:// langsung dari native (TCP tanpa TLS), mis.
+//     server lokal pengganti untuk test atau relay di jaringan yang sama.
+//   - realtime_client_start_external: socket dipegang pemanggil (wss:// lewat Dart). Text
+//     frame yang diterima diteruskan dengan realtime_client_feed; frame keluar (join,
+//     heartbeat) muncul di ring dengan tag REALTIME_TAG_OUTBOUND untuk dikirim pemanggil.
+
+#define REALTIME_OK 0
+#define REALTIME_ERROR_INVALID_INPUT -1
+#define REALTIME_ERROR_CONNECT -2
+#define REALTIME_ERROR_HANDSHAKE -3
+#define REALTIME_ERROR_STATE -4        // sudah start/connect, atau transport tidak cocok
+
+// Tag record di ring
+#define REALTIME_TAG_MESSAGE 1         // RealtimeMessageHeader + id + sender + text
+#define REALTIME_TAG_OUTBOUND 2        // text frame untuk dikirim transport eksternal
+#define REALTIME_TAG_STATE 3           // int32 REALTIME_STATE_* + detail UTF-8
+
+#define REALTIME_STATE_JOINED 1
+#define REALTIME_STATE_JOIN_FAILED 2   // detail = reason dari server
+#define REALTIME_STATE_CLOSED 3        // koneksi putus, phx_close/phx_error, atau heartbeat timeout
+
+#define REALTIME_MESSAGE_HEADER_BYTES 32
+
+typedef struct RealtimeClient RealtimeClient;
+
+typedef struct {
+    const char *topic;                 // mis. "realtime:chat-<id>"
+    const char *schema;                // NULL = "public"
+    const char *table;                 // NULL = "messages"
+    const char *filter;                // mis. "chat_id=eq.<id>", NULL = tanpa filter
+    const char *access_token;          // JWT untuk RLS, NULL = tidak dikirim
+    const uint8_t *chat_key;           // xor_with_iv (hasil base64 decode chat key)
+    size_t chat_key_len;
+    const uint8_t *aead_key;           // 32 byte untuk algoritma AEAD, NULL = hanya xor_with_iv
+    uint32_t heartbeat_ms;             // 0 = 25000
+} RealtimeClientConfig;
+
+// Payload REALTIME_TAG_MESSAGE; id, sender dan text (UTF-8) menyusul tanpa terminator
+typedef struct {
+    int64_t created_at_us;             // mikrodetik sejak epoch (UTC)
+    int32_t status;                    // MESSAGE_RECORD_OK atau MESSAGE_RECORD_ERROR_*
+    uint32_t id_len;
+    uint32_t sender_len;
+    uint32_t text_len;                 // 0 jika status bukan OK
+    uint8_t algorithm;                 // MESSAGE_RECORD_ALG_*
+    uint8_t reserved[7];
+} RealtimeMessageHeader;
+
+typedef struct {
+    uint64_t frames;                   // text frame yang diparse
+    uint64_t frame_bytes;
+    uint64_t parse_errors;
+    uint64_t ignored_events;           // event lain, topic lain, atau baris bukan INSERT
+    uint64_t inserts;
+    uint64_t decrypted;
+    uint64_t decrypt_failures;
+    uint64_t batches;                  // call decrypt batch (satu per antrian frame habis)
+    uint64_t heartbeats;
+    uint64_t dropped;                  // record yang tidak sempat ditulis ke ring saat destroy
+} RealtimeClientStats;
+
+// Ring harus hidup lebih lama dari client. String dan key di config di-copy.
+RealtimeClient *realtime_client_create(const RealtimeClientConfig *config, SpscRing *ring);
+// Tutup koneksi (jika native), hentikan thread, wipe key dan plaintext yang tertunda
+void realtime_client_destroy(RealtimeClient *client);
+
+// Handshake WebSocket secara sinkron (timeout_ms, 0 = 10000) lalu join channel. path
+// termasuk query, mis. "/realtime/v1/websocket?apikey=...&vsn=1.0.0".
+int realtime_client_connect(RealtimeClient *client, const char *host, uint16_t port,
+                            const char *path, int32_t timeout_ms);
+
+int realtime_client_start_external(RealtimeClient *client);
+// Satu text frame utuh dari transport eksternal; di-copy lalu diproses di thread native
+int realtime_client_feed(RealtimeClient *client, const uint8_t *frame, size_t len);
+
+void realtime_client_get_stats(RealtimeClient *client, RealtimeClientStats *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
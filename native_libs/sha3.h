@@ -14,6 +14,9 @@ typedef struct {
     uint32_t pt;
 } SHA3_CTX;
 
+// sizeof(SHA3_CTX) untuk pemanggil yang mengalokasikan context sendiri (mis. wasm)
+size_t sha3_512_ctx_size(void);
+
 void sha3_512_init(SHA3_CTX *ctx);
 void sha3_512_update(SHA3_CTX *ctx, const uint8_t *data, size_t len);
 void sha3_512_final(uint8_t *digest, SHA3_CTX *ctx);
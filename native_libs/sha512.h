@@ -0,0 +1,40 @@
+#ifndef SHA512_H
+#define SHA512_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SHA512_DIGEST_BYTES 64
+#define SHA512_BLOCK_BYTES 128
+
+// SHA-512 (FIPS 180-4) dan HMAC-SHA512, dipakai untuk auth tag format file
+// (FileEncryptionService._generateAuthTag) tanpa bolak-balik ke Dart per chunk.
+typedef struct {
+    uint64_t state[8];
+    uint64_t total_len;
+    uint8_t buffer[SHA512_BLOCK_BYTES];
+    size_t buffered;
+} SHA512_CTX;
+
+typedef struct {
+    SHA512_CTX inner;
+    SHA512_CTX outer;
+} HMAC_SHA512_CTX;
+
+void sha512_init(SHA512_CTX *ctx);
+void sha512_update(SHA512_CTX *ctx, const uint8_t *data, size_t len);
+void sha512_final(uint8_t digest[SHA512_DIGEST_BYTES], SHA512_CTX *ctx);
+
+void hmac_sha512_init(HMAC_SHA512_CTX *ctx, const uint8_t *key, size_t keylen);
+void hmac_sha512_update(HMAC_SHA512_CTX *ctx, const uint8_t *data, size_t len);
+void hmac_sha512_final(uint8_t mac[SHA512_DIGEST_BYTES], HMAC_SHA512_CTX *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
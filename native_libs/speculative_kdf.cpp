@@ -0,0 +1,188 @@
+#include "speculative_kdf.h"
+#include "argon2.h"
+#include "native_metrics.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+enum class SpecState { Empty, Queued, Running, Done, Failed };
+
+void secure_wipe(std::vector<uint8_t> &buffer) {
+    volatile uint8_t *p = buffer.data();
+    for (size_t i = 0; i < buffer.size(); i++) {
+        p[i] = 0;
+    }
+    buffer.clear();
+}
+
+// Panjang boleh bocor, isi tidak: loop selalu sepanjang buffer tersimpan
+bool constant_time_equal(const std::vector<uint8_t> &stored, const uint8_t *input, size_t len) {
+    uint8_t diff = stored.size() == len ? 0 : 1;
+    for (size_t i = 0; i < stored.size(); i++) {
+        diff |= stored[i] ^ (i < len ? input[i] : 0);
+    }
+    return diff == 0;
+}
+
+}  // namespace
+
+struct SpeculativeKdf {
+    std::mutex mutex;
+    std::condition_variable work_cv;
+    std::condition_variable done_cv;
+    std::thread worker;
+    bool shutdown = false;
+
+    // Spekulasi aktif; generation naik di setiap begin/clear supaya hasil basi dibuang
+    uint64_t generation = 0;
+    SpecState state = SpecState::Empty;
+    KdfParams params{};
+    std::vector<uint8_t> pwd;
+    std::vector<uint8_t> salt;
+    std::vector<uint8_t> hash;
+
+    // Dipanggil dengan mutex dipegang
+    void reset() {
+        generation++;
+        state = SpecState::Empty;
+        secure_wipe(pwd);
+        secure_wipe(salt);
+        secure_wipe(hash);
+        done_cv.notify_all();
+    }
+
+    void run();
+};
+
+void SpeculativeKdf::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        work_cv.wait(lock, [this] { return shutdown || state == SpecState::Queued; });
+        if (shutdown) return;
+
+        const uint64_t job_generation = generation;
+        const KdfParams job_params = params;
+        std::vector<uint8_t> job_pwd = pwd;
+        std::vector<uint8_t> job_salt = salt;
+        std::vector<uint8_t> job_hash(hash.size());
+        state = SpecState::Running;
+        lock.unlock();
+
+        const uint64_t started_ns = native_metrics_now_ns();
+        const int rc = argon2id_hash_raw(job_params.t_cost, job_params.m_cost, job_params.parallelism,
+                                         job_pwd.data(), job_pwd.size(), job_salt.data(), job_salt.size(),
+                                         job_hash.data(), job_hash.size());
+        native_metrics_record(NATIVE_METRICS_KDF, started_ns, static_cast<uint64_t>(job_params.m_cost) * 1024,
+                              rc == 0);
+        secure_wipe(job_pwd);
+        secure_wipe(job_salt);
+
+        lock.lock();
+        if (generation == job_generation) {
+            if (rc == 0) {
+                hash.swap(job_hash);
+                state = SpecState::Done;
+            } else {
+                state = SpecState::Failed;
+            }
+            done_cv.notify_all();
+        }
+        secure_wipe(job_hash);
+    }
+}
+
+extern "C" SpeculativeKdf *speculative_kdf_create(void) {
+    auto *spec = new SpeculativeKdf();
+    spec->worker = std::thread([spec] { spec->run(); });
+    return spec;
+}
+
+extern "C" void speculative_kdf_destroy(SpeculativeKdf *spec) {
+    if (!spec) return;
+    {
+        std::lock_guard<std::mutex> lock(spec->mutex);
+        spec->shutdown = true;
+        spec->reset();
+    }
+    spec->work_cv.notify_all();
+    spec->worker.join();
+    delete spec;
+}
+
+extern "C" int speculative_kdf_begin(SpeculativeKdf *spec, const KdfParams *params,
+                                     const uint8_t *pwd, size_t pwdlen,
+                                     const uint8_t *salt, size_t saltlen,
+                                     size_t hashlen) {
+    if (!spec || !params || params->t_cost == 0 || params->parallelism == 0 || (!pwd && pwdlen) || !salt ||
+        saltlen == 0 || hashlen == 0 || hashlen > SPECULATIVE_KDF_MAX_HASH_BYTES) {
+        return SPECULATIVE_KDF_ERROR_INVALID_INPUT;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(spec->mutex);
+        spec->reset();
+        spec->params = *params;
+        spec->pwd.assign(pwd, pwd + pwdlen);
+        spec->salt.assign(salt, salt + saltlen);
+        spec->hash.assign(hashlen, 0);
+        spec->state = SpecState::Queued;
+    }
+    spec->work_cv.notify_one();
+    return SPECULATIVE_KDF_OK;
+}
+
+extern "C" int speculative_kdf_take(SpeculativeKdf *spec, const KdfParams *params,
+                                    const uint8_t *pwd, size_t pwdlen,
+                                    const uint8_t *salt, size_t saltlen,
+                                    uint8_t *out, size_t outlen, int32_t timeout_ms) {
+    if (!spec || !params || (!pwd && pwdlen) || (!salt && saltlen) || !out) {
+        return SPECULATIVE_KDF_ERROR_INVALID_INPUT;
+    }
+
+    std::unique_lock<std::mutex> lock(spec->mutex);
+    if (spec->state == SpecState::Empty) return SPECULATIVE_KDF_MISS;
+
+    // Semua perbandingan dievaluasi (tanpa short-circuit) agar waktu tidak bergantung
+    // pada bagian mana yang berbeda
+    bool match = constant_time_equal(spec->pwd, pwd, pwdlen);
+    match &= constant_time_equal(spec->salt, salt, saltlen);
+    match &= spec->params.t_cost == params->t_cost;
+    match &= spec->params.m_cost == params->m_cost;
+    match &= spec->params.parallelism == params->parallelism;
+    match &= spec->hash.size() == outlen;
+    if (!match) {
+        spec->reset();
+        return SPECULATIVE_KDF_MISS;
+    }
+
+    const uint64_t generation = spec->generation;
+    auto ready = [spec, generation] {
+        return spec->generation != generation ||
+               spec->state == SpecState::Done || spec->state == SpecState::Failed;
+    };
+    if (timeout_ms < 0) {
+        spec->done_cv.wait(lock, ready);
+    } else if (!spec->done_cv.wait_for(lock, std::chrono::milliseconds(timeout_ms), ready)) {
+        return SPECULATIVE_KDF_PENDING;
+    }
+
+    // Diganti/dihapus thread lain selagi menunggu
+    if (spec->generation != generation) return SPECULATIVE_KDF_MISS;
+
+    const bool ok = spec->state == SpecState::Done;
+    if (ok) memcpy(out, spec->hash.data(), outlen);
+    spec->reset();
+    return ok ? SPECULATIVE_KDF_OK : SPECULATIVE_KDF_ERROR_ARGON2;
+}
+
+extern "C" void speculative_kdf_clear(SpeculativeKdf *spec) {
+    if (!spec) return;
+    std::lock_guard<std::mutex> lock(spec->mutex);
+    spec->reset();
+}
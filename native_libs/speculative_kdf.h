@@ -0,0 +1,57 @@
+#ifndef SPECULATIVE_KDF_H
+#define SPECULATIVE_KDF_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "kdf_executor.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Argon2id spekulatif: UI menyerahkan password + salt yang sudah diketahui saat field
+// kehilangan fokus (atau setelah debounce), hashing jalan di thread native sendiri,
+// dan permintaan berikutnya dengan input identik (dibandingkan constant-time) langsung
+// mengambil hasilnya. Hanya satu spekulasi aktif: begin baru, clear, atau take dengan
+// input berbeda menghapus input dan hasil lama. Hasil sekali pakai.
+//
+// Argon2 yang sedang berjalan tidak bisa dibatalkan; hasil spekulasi yang sudah basi
+// langsung dihapus saat selesai.
+
+#define SPECULATIVE_KDF_OK 0
+#define SPECULATIVE_KDF_MISS 1
+#define SPECULATIVE_KDF_PENDING 2
+#define SPECULATIVE_KDF_ERROR_INVALID_INPUT -1
+#define SPECULATIVE_KDF_ERROR_ARGON2 -2
+
+#define SPECULATIVE_KDF_MAX_HASH_BYTES 64
+
+typedef struct SpeculativeKdf SpeculativeKdf;
+
+SpeculativeKdf *speculative_kdf_create(void);
+// Menunggu Argon2 yang sedang berjalan selesai, lalu wipe semuanya
+void speculative_kdf_destroy(SpeculativeKdf *spec);
+
+// Mulai (atau ganti) spekulasi. Input di-copy; buffer caller boleh langsung dibersihkan.
+int speculative_kdf_begin(SpeculativeKdf *spec, const KdfParams *params,
+                          const uint8_t *pwd, size_t pwdlen,
+                          const uint8_t *salt, size_t saltlen,
+                          size_t hashlen);
+
+// Ambil hasil jika input sama persis dengan spekulasi aktif. OK = hash ditulis ke out
+// (lalu spekulasi dihapus), MISS = tidak ada / input berbeda (spekulasi dihapus, caller
+// hash sendiri), PENDING = cocok tapi belum selesai dalam timeout_ms (< 0 = tunggu terus).
+int speculative_kdf_take(SpeculativeKdf *spec, const KdfParams *params,
+                         const uint8_t *pwd, size_t pwdlen,
+                         const uint8_t *salt, size_t saltlen,
+                         uint8_t *out, size_t outlen, int32_t timeout_ms);
+
+// Hapus input dan hasil (mis. password diubah atau layar ditutup)
+void speculative_kdf_clear(SpeculativeKdf *spec);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,210 @@
+#include "spsc_ring.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+constexpr uint32_t kDefaultCapacity = 1u << 20;
+constexpr uint32_t kMinCapacity = 4096;
+constexpr uint32_t kDefaultBatchRecords = 64;
+
+uint32_t round_up_pow2(uint32_t value) {
+    uint32_t capacity = kMinCapacity;
+    while (capacity < value && capacity < (1u << 31)) capacity <<= 1;
+    return capacity;
+}
+
+inline uint32_t align8(uint32_t value) {
+    return (value + 7u) & ~7u;
+}
+
+inline void store_u32(uint8_t *p, uint32_t v) {
+    memcpy(p, &v, sizeof(v));
+}
+
+void secure_wipe(uint8_t *p, size_t len) {
+    volatile uint8_t *v = p;
+    for (size_t i = 0; i < len; i++) {
+        v[i] = 0;
+    }
+}
+
+}  // namespace
+
+struct SpscRing {
+    std::unique_ptr<uint8_t[]> buffer;
+    uint32_t capacity = 0;
+    uint64_t mask = 0;
+    uint32_t batch_records = kDefaultBatchRecords;
+
+    // head ditulis producer, tail ditulis consumer; dipisah cache line supaya tidak false sharing
+    alignas(64) std::atomic<uint64_t> head{0};
+    alignas(64) std::atomic<uint64_t> tail{0};
+    alignas(64) std::atomic<int> armed{0};
+    std::atomic<int> closed{0};
+
+    // Milik producer
+    alignas(64) uint64_t write_pos = 0;
+    uint64_t cached_tail = 0;
+    uint32_t pending_records = 0;
+
+    std::mutex doorbell_mutex;
+    SpscRingDoorbell doorbell = nullptr;
+    int64_t token = 0;
+
+    void publish();
+    void ring_doorbell();
+    bool wait_for_space(uint64_t need, int32_t timeout_ms);
+};
+
+void SpscRing::ring_doorbell() {
+    std::lock_guard<std::mutex> lock(doorbell_mutex);
+    if (doorbell) doorbell(token);
+}
+
+void SpscRing::publish() {
+    pending_records = 0;
+    if (head.load(std::memory_order_relaxed) != write_pos) {
+        // seq_cst berpasangan dengan spsc_ring_arm: salah satu pihak pasti melihat yang lain
+        head.store(write_pos, std::memory_order_seq_cst);
+    }
+    if (armed.load(std::memory_order_seq_cst) && armed.exchange(0, std::memory_order_seq_cst)) {
+        ring_doorbell();
+    }
+}
+
+bool SpscRing::wait_for_space(uint64_t need, int32_t timeout_ms) {
+    if (capacity - (write_pos - cached_tail) >= need) return true;
+    cached_tail = tail.load(std::memory_order_acquire);
+    if (capacity - (write_pos - cached_tail) >= need) return true;
+    if (timeout_ms == 0) {
+        // Publikasikan yang tertunda supaya consumer bisa mengosongkan ring
+        publish();
+        return false;
+    }
+
+    publish();
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    for (uint32_t spin = 0;; spin++) {
+        if (closed.load(std::memory_order_acquire)) return false;
+        cached_tail = tail.load(std::memory_order_acquire);
+        if (capacity - (write_pos - cached_tail) >= need) return true;
+        if (timeout_ms > 0 && std::chrono::steady_clock::now() >= deadline) return false;
+        if (spin < 64) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
+
+extern "C" SpscRing *spsc_ring_create(uint32_t capacity_bytes, uint32_t batch_records) {
+    auto *ring = new SpscRing();
+    ring->capacity = round_up_pow2(capacity_bytes ? capacity_bytes : kDefaultCapacity);
+    ring->mask = ring->capacity - 1;
+    if (batch_records) ring->batch_records = batch_records;
+    ring->buffer.reset(new uint8_t[ring->capacity]());
+    return ring;
+}
+
+extern "C" void spsc_ring_destroy(SpscRing *ring) {
+    if (!ring) return;
+    // Payload bisa berisi plaintext
+    secure_wipe(ring->buffer.get(), ring->capacity);
+    delete ring;
+}
+
+extern "C" void spsc_ring_set_doorbell(SpscRing *ring, SpscRingDoorbell doorbell, int64_t token) {
+    if (!ring) return;
+    std::lock_guard<std::mutex> lock(ring->doorbell_mutex);
+    ring->doorbell = doorbell;
+    ring->token = token;
+}
+
+extern "C" int spsc_ring_write(SpscRing *ring, uint32_t tag, const uint8_t *data, uint32_t len,
+                               int32_t timeout_ms) {
+    if (!ring || (!data && len > 0)) return SPSC_RING_ERROR_INVALID_INPUT;
+    if (ring->closed.load(std::memory_order_acquire)) return SPSC_RING_ERROR_CLOSED;
+
+    const uint64_t record = SPSC_RING_RECORD_HEADER_BYTES + static_cast<uint64_t>(align8(len));
+    if (len > ring->capacity || record > ring->capacity / 2) return SPSC_RING_ERROR_TOO_LARGE;
+
+    // Record tidak pernah terpotong di akhir buffer: sisa ruang diisi record WRAP
+    const uint64_t to_end = ring->capacity - (ring->write_pos & ring->mask);
+    const uint64_t need = record <= to_end ? record : to_end + record;
+    if (!ring->wait_for_space(need, timeout_ms)) {
+        return ring->closed.load(std::memory_order_acquire) ? SPSC_RING_ERROR_CLOSED : SPSC_RING_ERROR_FULL;
+    }
+
+    uint8_t *base = ring->buffer.get();
+    if (record > to_end) {
+        store_u32(base + (ring->write_pos & ring->mask), SPSC_RING_WRAP);
+        ring->write_pos += to_end;
+    }
+
+    uint8_t *slot = base + (ring->write_pos & ring->mask);
+    store_u32(slot, len);
+    store_u32(slot + 4, tag);
+    if (len) memcpy(slot + SPSC_RING_RECORD_HEADER_BYTES, data, len);
+    const uint32_t padding = align8(len) - len;
+    if (padding) memset(slot + SPSC_RING_RECORD_HEADER_BYTES + len, 0, padding);
+    ring->write_pos += record;
+
+    if (++ring->pending_records >= ring->batch_records) ring->publish();
+    return SPSC_RING_OK;
+}
+
+extern "C" void spsc_ring_flush(SpscRing *ring) {
+    if (!ring) return;
+    ring->publish();
+}
+
+extern "C" void spsc_ring_close(SpscRing *ring) {
+    if (!ring) return;
+    ring->closed.store(1, std::memory_order_seq_cst);
+    ring->publish();
+}
+
+extern "C" uint8_t *spsc_ring_data(SpscRing *ring) {
+    return ring ? ring->buffer.get() : nullptr;
+}
+
+extern "C" uint32_t spsc_ring_capacity(SpscRing *ring) {
+    return ring ? ring->capacity : 0;
+}
+
+extern "C" uint32_t spsc_ring_acquire(SpscRing *ring, uint32_t *offset) {
+    if (!ring || !offset) return 0;
+    const uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+    const uint64_t head = ring->head.load(std::memory_order_acquire);
+    if (head == tail) return 0;
+
+    const uint64_t start = tail & ring->mask;
+    const uint64_t contiguous = ring->capacity - start;
+    *offset = static_cast<uint32_t>(start);
+    return static_cast<uint32_t>(head - tail < contiguous ? head - tail : contiguous);
+}
+
+extern "C" void spsc_ring_release(SpscRing *ring, uint32_t bytes) {
+    if (!ring) return;
+    const uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+    const uint64_t head = ring->head.load(std::memory_order_acquire);
+    const uint64_t advance = bytes < head - tail ? bytes : head - tail;
+    ring->tail.store(tail + advance, std::memory_order_release);
+}
+
+extern "C" int spsc_ring_arm(SpscRing *ring) {
+    if (!ring) return 0;
+    ring->armed.store(1, std::memory_order_seq_cst);
+    const bool has_data = ring->head.load(std::memory_order_seq_cst) != ring->tail.load(std::memory_order_relaxed);
+    return has_data || ring->closed.load(std::memory_order_seq_cst) ? 1 : 0;
+}
+
+extern "C" int spsc_ring_is_closed(SpscRing *ring) {
+    return ring && ring->closed.load(std::memory_order_acquire) ? 1 : 0;
+}
@@ -0,0 +1,72 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Ring buffer single-producer/single-consumer di memory native untuk mengalirkan banyak
+// hasil kecil (decrypt batch, hasil scan, search hit) ke Dart tanpa satu port message
+// per item. Dart membaca record langsung lewat asTypedList di atas spsc_ring_data.
+//
+// Producer menulis record lalu mempublikasikan head hanya di batas batch (flush eksplisit
+// atau setiap batch_records record). Doorbell (NativeCallable.listener di Dart) hanya
+// dipanggil saat publish jika consumer sudah menandai dirinya idle lewat spsc_ring_arm,
+// jadi satu wakeup isolate mengantar satu batch penuh.
+//
+// Layout record (8-byte aligned): uint32 len, uint32 tag, payload, padding ke kelipatan 8.
+// len == SPSC_RING_WRAP berarti sisa buffer sampai akhir dilewati.
+//
+// Producer harus satu thread pada satu waktu (beberapa thread boleh bergantian jika
+// diserialisasi oleh mutex milik pemanggil).
+
+#define SPSC_RING_OK 0
+#define SPSC_RING_ERROR_INVALID_INPUT -1
+#define SPSC_RING_ERROR_FULL -2
+#define SPSC_RING_ERROR_TOO_LARGE -3
+#define SPSC_RING_ERROR_CLOSED -4
+
+#define SPSC_RING_RECORD_HEADER_BYTES 8
+#define SPSC_RING_WRAP 0xFFFFFFFFu
+
+typedef struct SpscRing SpscRing;
+
+// Dipanggil dari thread producer; token diteruskan apa adanya.
+typedef void (*SpscRingDoorbell)(int64_t token);
+
+// capacity_bytes dibulatkan ke pangkat dua (0 = 1 MiB). batch_records = publish otomatis
+// setiap N record (0 = 64). Record maksimal capacity/2 byte termasuk header.
+SpscRing *spsc_ring_create(uint32_t capacity_bytes, uint32_t batch_records);
+void spsc_ring_destroy(SpscRing *ring);
+
+// Setelah fungsi ini kembali, doorbell lama dijamin tidak sedang/akan dipanggil.
+void spsc_ring_set_doorbell(SpscRing *ring, SpscRingDoorbell doorbell, int64_t token);
+
+// --- Producer ---
+// timeout_ms: 0 = langsung FULL jika tidak muat, < 0 = tunggu consumer.
+int spsc_ring_write(SpscRing *ring, uint32_t tag, const uint8_t *data, uint32_t len, int32_t timeout_ms);
+// Batas batch: publikasikan record yang tertunda dan bunyikan doorbell jika consumer idle.
+void spsc_ring_flush(SpscRing *ring);
+// Producer selesai (flush + doorbell). Write berikutnya gagal dengan CLOSED.
+void spsc_ring_close(SpscRing *ring);
+
+// --- Consumer ---
+uint8_t *spsc_ring_data(SpscRing *ring);
+uint32_t spsc_ring_capacity(SpscRing *ring);
+// Region record utuh yang siap dibaca: [*offset, *offset + return) di spsc_ring_data.
+// 0 jika kosong. Region tidak pernah melewati akhir buffer.
+uint32_t spsc_ring_acquire(SpscRing *ring, uint32_t *offset);
+// Kembalikan bytes (termasuk record WRAP) ke producer.
+void spsc_ring_release(SpscRing *ring, uint32_t bytes);
+// Tandai consumer idle. Return 1 jika data sudah masuk lagi (baca dulu, jangan tunggu).
+int spsc_ring_arm(SpscRing *ring);
+int spsc_ring_is_closed(SpscRing *ring);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,157 @@
+// KAT Adiantum (XChaCha12 + AES-256 + NH + Poly1305) terhadap model Python independen
+// yang mengikuti paper Crowley & Biggers dan crypto/adiantum.c Linux (AES dari
+// pyca/cryptography, sisanya ditulis ulang dari spesifikasi). AES-256 dari FIPS-197 C.3.
+
+#include "adiantum.h"
+#include "aes.h"
+#include "chacha20_poly1305.h"
+#include "sha512.h"
+#include "test_util.h"
+
+namespace {
+
+using test_util::hex;
+
+std::vector<uint8_t> pattern(size_t len, unsigned mul, unsigned add, unsigned mod) {
+    std::vector<uint8_t> out(len);
+    for (size_t i = 0; i < len; i++) out[i] = static_cast<uint8_t>((i * mul + add) % mod);
+    return out;
+}
+
+std::string sha512_hex(const std::vector<uint8_t> &data) {
+    SHA512_CTX ctx;
+    uint8_t digest[SHA512_DIGEST_BYTES];
+    sha512_init(&ctx);
+    sha512_update(&ctx, data.data(), data.size());
+    sha512_final(digest, &ctx);
+    return test_util::to_hex(digest, sizeof(digest));
+}
+
+std::vector<uint8_t> sequence(uint8_t first, size_t len) {
+    std::vector<uint8_t> out(len);
+    for (size_t i = 0; i < len; i++) out[i] = static_cast<uint8_t>(first + i);
+    return out;
+}
+
+void test_aes256_fips197() {
+    const auto key = sequence(0, 32);
+    const auto plain = hex("00112233445566778899aabbccddeeff");
+    AES256_CTX ctx;
+    aes256_init(&ctx, key.data());
+    uint8_t out[16], back[16];
+    aes256_encrypt_block(&ctx, out, plain.data());
+    test_util::check_bytes("aes256 encrypt", out, hex("8ea2b7ca516745bfeafc49904b496089"));
+    aes256_decrypt_block(&ctx, back, out);
+    test_util::check_bytes("aes256 decrypt", back, plain);
+}
+
+void test_xchacha12_keystream() {
+    const auto key = sequence(0, 32);
+    const auto nonce = sequence(0x50, XCHACHA_NONCE_BYTES);
+    std::vector<uint8_t> stream(80, 0);
+    xchacha12_xor(stream.data(), stream.data(), stream.size(), key.data(), nonce.data());
+    test_util::check_bytes("xchacha12 keystream", stream.data(),
+                           hex("f551e133f5468fde2bd22769a0db04e879fc256ad6b97280d8aea6f3ad60f8b0"
+                               "ff47318f6f4a714dc0338e4e04e451493d5006e6025ac2ce2c8544728f7d0794"
+                               "9b904514527d74a10eaf364656ea9517"));
+}
+
+void test_single_message_vectors() {
+    const auto key = sequence(0, ADIANTUM_KEY_BYTES);
+    const auto tweak = sequence(0x40, ADIANTUM_TWEAK_BYTES);
+    AdiantumKey *k = adiantum_create(key.data());
+    CHECK(k != nullptr);
+    if (!k) return;
+
+    struct Vector {
+        size_t len;
+        const char *cipher;
+    };
+    // Panjang minimum, bulk 1 byte, bulk tidak kelipatan 16, dan bulk > 1 chunk NH
+    const Vector vectors[] = {
+        {16, "9f523add4e946b4c3a0ad44902a53d2d"},
+        {17, "924ed481d1609cbc062e1b7b095966806c"},
+        {31, "aad799525da2801ff675a69489ac7a6a06caae361afc44af7b021f1ca49a87"},
+        {64, "b0c0fcae6235cf20c6a819d69e78b8e1759bf288cc51404c51fa794adace2291"
+             "7f8b9e5246faa843cdf4bddeb2e4772024c35e4ff7ea4dc6d1bbabffb5242296"},
+    };
+    for (const Vector &v : vectors) {
+        const auto plain = pattern(v.len, 7, 3, 251);
+        auto data = plain;
+        CHECK(adiantum_encrypt(k, data.data(), data.size(), tweak.data()) == ADIANTUM_OK);
+        test_util::check_bytes("adiantum encrypt", data.data(), hex(v.cipher));
+        CHECK(adiantum_decrypt(k, data.data(), data.size(), tweak.data()) == ADIANTUM_OK);
+        CHECK(data == plain);
+    }
+
+    // 1064 byte: chunk NH 1024 + sisa 24 (unit terakhir di-pad), dibandingkan lewat SHA-512
+    const auto plain = pattern(1064, 7, 3, 251);
+    auto data = plain;
+    CHECK(adiantum_encrypt(k, data.data(), data.size(), tweak.data()) == ADIANTUM_OK);
+    CHECK(sha512_hex(data) ==
+          "0ae6e96f3bf697827e7a64a1aceea58eb62afb0e7ec662203ed60cb5d6e79429"
+          "aed42db7c99a69b6cd7f056830cb9208dd0511cafe4b22c8fed7f7128fcc8bf6");
+    CHECK(adiantum_decrypt(k, data.data(), data.size(), tweak.data()) == ADIANTUM_OK);
+    CHECK(data == plain);
+
+    // Tweak lain atau satu bit berubah mengacak seluruh pesan, bukan hanya blok itu
+    auto other = plain;
+    auto other_tweak = tweak;
+    other_tweak[31] ^= 1;
+    auto base = plain;
+    adiantum_encrypt(k, base.data(), base.size(), tweak.data());
+    adiantum_encrypt(k, other.data(), other.size(), other_tweak.data());
+    CHECK(memcmp(base.data(), other.data(), 16) != 0);
+    base[1000] ^= 0x80;
+    adiantum_decrypt(k, base.data(), base.size(), tweak.data());
+    CHECK(memcmp(base.data(), plain.data(), 16) != 0);
+
+    CHECK(adiantum_encrypt(k, data.data(), 15, tweak.data()) == ADIANTUM_ERROR_TOO_SHORT);
+    CHECK(adiantum_encrypt(nullptr, data.data(), data.size(), tweak.data()) == ADIANTUM_ERROR_INVALID_INPUT);
+    adiantum_destroy(k);
+}
+
+void test_pages() {
+    const auto key = sequence(0, ADIANTUM_KEY_BYTES);
+    const auto file_id = sequence(0xa0, ADIANTUM_FILE_ID_BYTES);
+    AdiantumKey *k = adiantum_create(key.data());
+    CHECK(k != nullptr);
+    if (!k) return;
+
+    // Dua halaman penuh + sisa 10 byte yang digabung ke halaman kedua (4106 byte)
+    const auto plain = pattern(2 * ADIANTUM_PAGE_BYTES + 10, 13, 1, 256);
+    auto whole = plain;
+    CHECK(adiantum_encrypt_pages(k, whole.data(), whole.size(), file_id.data(), 0) == ADIANTUM_OK);
+    CHECK(sha512_hex(whole) ==
+          "6197313c9d14b647538dc25e436e84117cdaacc6c34d43308d679d8708b821b5"
+          "5e3783f329851aebe027acc6ccf8ec602e8b9c514f0e86fb49b11df29b617a81");
+
+    // Halaman pertama = satu pesan dengan tweak file_id || LE64(0) || 0^8
+    std::vector<uint8_t> tweak(ADIANTUM_TWEAK_BYTES, 0);
+    memcpy(tweak.data(), file_id.data(), file_id.size());
+    std::vector<uint8_t> first(plain.begin(), plain.begin() + ADIANTUM_PAGE_BYTES);
+    adiantum_encrypt(k, first.data(), first.size(), tweak.data());
+    CHECK(memcmp(first.data(), whole.data(), first.size()) == 0);
+
+    // Akses acak: range mulai halaman 1 sama dengan potongan enkripsi utuh
+    std::vector<uint8_t> tail(plain.begin() + ADIANTUM_PAGE_BYTES, plain.end());
+    CHECK(adiantum_encrypt_pages(k, tail.data(), tail.size(), file_id.data(), 1) == ADIANTUM_OK);
+    CHECK(memcmp(tail.data(), whole.data() + ADIANTUM_PAGE_BYTES, tail.size()) == 0);
+    CHECK(adiantum_decrypt_pages(k, tail.data(), tail.size(), file_id.data(), 1) == ADIANTUM_OK);
+    CHECK(memcmp(tail.data(), plain.data() + ADIANTUM_PAGE_BYTES, tail.size()) == 0);
+
+    CHECK(adiantum_decrypt_pages(k, whole.data(), whole.size(), file_id.data(), 0) == ADIANTUM_OK);
+    CHECK(whole == plain);
+    CHECK(adiantum_encrypt_pages(k, whole.data(), 8, file_id.data(), 0) == ADIANTUM_ERROR_TOO_SHORT);
+    adiantum_destroy(k);
+}
+
+}  // namespace
+
+int main() {
+    test_aes256_fips197();
+    test_xchacha12_keystream();
+    test_single_message_vectors();
+    test_pages();
+    return test_util::result("adiantum_test");
+}
@@ -0,0 +1,88 @@
+// KAT AES-256-GCM: test case 13-16 dari spesifikasi GCM (McGrew & Viega) plus satu
+// vektor 200 byte dengan AAD ganjil (lebih dari satu batch 8 blok), dijalankan untuk
+// setiap implementasi: AES-NI, bitsliced x8 (SIMD) dan bitsliced x4 (64-bit scalar).
+
+#include "aes_gcm.h"
+#include "test_util.h"
+
+using test_util::check_bytes;
+using test_util::hex;
+
+namespace {
+
+struct GcmVector {
+    const char *name;
+    std::vector<uint8_t> key;
+    std::vector<uint8_t> iv;
+    std::vector<uint8_t> aad;
+    std::vector<uint8_t> plaintext;
+    std::vector<uint8_t> ciphertext;
+    std::vector<uint8_t> tag;
+};
+
+std::vector<GcmVector> vectors() {
+    const auto key15 = hex("feffe9928665731c6d6a8f9467308308feffe9928665731c6d6a8f9467308308");
+    const auto iv15 = hex("cafebabefacedbaddecaf888");
+    const auto pt15 = hex(
+        "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525"
+        "b16aedf5aa0de657ba637b391aafd255");
+    const auto ct15 = hex(
+        "522dc1f099567d07f47f37a32a84427d643a8cdcbfe5c0c97598a2bd2555d1aa8cb08e48590dbb3da7b08b1056828838"
+        "c5f61e6393ba7a0abcc9f662898015ad");
+
+    std::vector<uint8_t> long_key(32), long_iv(12), long_aad(33), long_pt(200);
+    for (size_t i = 0; i < long_key.size(); i++) long_key[i] = static_cast<uint8_t>(i);
+    for (size_t i = 0; i < long_iv.size(); i++) long_iv[i] = static_cast<uint8_t>(i);
+    for (size_t i = 0; i < long_aad.size(); i++) long_aad[i] = static_cast<uint8_t>(i);
+    for (size_t i = 0; i < long_pt.size(); i++) long_pt[i] = static_cast<uint8_t>(i * 7 + 3);
+
+    return {
+        {"test case 13", std::vector<uint8_t>(32), std::vector<uint8_t>(12), {}, {}, {},
+         hex("530f8afbc74536b9a963b4f1c4cb738b")},
+        {"test case 14", std::vector<uint8_t>(32), std::vector<uint8_t>(12), {}, std::vector<uint8_t>(16),
+         hex("cea7403d4d606b6e074ec5d3baf39d18"), hex("d0d1c8a799996bf0265b98b5d48ab919")},
+        {"test case 15", key15, iv15, {}, pt15, ct15, hex("b094dac5d93471bdec1a502270e3cc6c")},
+        {"test case 16", key15, iv15, hex("feedfacedeadbeeffeedfacedeadbeefabaddad2"),
+         std::vector<uint8_t>(pt15.begin(), pt15.begin() + 60), std::vector<uint8_t>(ct15.begin(), ct15.begin() + 60),
+         hex("76fc6ece0f4e1768cddf8853bb2d551b")},
+        {"200 byte, AAD 33 byte", long_key, long_iv, long_aad, long_pt,
+         hex("4408c703dac3ef2fb603dedbe6b71d01f0ac06bc7fedc2d893d55c45daa7d56ee2fa5f0450c71f8c6f8656ddbfb96d74"
+             "bd0301e535a0de5eb405b3b9bf4d405233f617a20c37cb95e756a37ef8912bc40bb0882a39350e0c968fe74cff7e2c11"
+             "6852e85e1b8705ce45fed742bf8b2473a97d4383ccf318de06ad0eade5881b7238d8915e2b7166e7b3238171ea04a92e"
+             "c50ee23d3a078e6ea76dd137bd9cbcb2f0fdef6d967941ea3cc1744a683e43774e142bca645d8eb86ecdd9e756eb82cf"
+             "5006dba252bbbbbd"),
+         hex("9b8b34b772c41110b374635a0dc6f6d6")},
+    };
+}
+
+void test_vectors(uint32_t features) {
+    for (const GcmVector &v : vectors()) {
+        std::vector<uint8_t> ct(v.plaintext.size() + 1);
+        uint8_t tag[AES_GCM_TAG_BYTES];
+        CHECK(aes256_gcm_encrypt(ct.data(), tag, v.plaintext.data(), v.plaintext.size(), v.aad.data(),
+                                 v.aad.size(), v.key.data(), v.iv.data()) == AES_GCM_OK);
+        bool ok = check_bytes(v.name, ct.data(), v.ciphertext);
+        ok = check_bytes(v.name, tag, v.tag) && ok;
+        if (!ok) fprintf(stderr, "  impl %d, features 0x%x\n", aes256_gcm_impl(), features);
+
+        std::vector<uint8_t> pt(v.ciphertext.size() + 1);
+        CHECK(aes256_gcm_decrypt(pt.data(), v.ciphertext.data(), v.ciphertext.size(), v.tag.data(), v.aad.data(),
+                                 v.aad.size(), v.key.data(), v.iv.data()) == AES_GCM_OK);
+        check_bytes(v.name, pt.data(), v.plaintext);
+
+        // Tag salah: ditolak dan plaintext tidak ditulis
+        std::vector<uint8_t> bad_tag = v.tag;
+        bad_tag[15] ^= 0x80;
+        std::vector<uint8_t> untouched(v.ciphertext.size() + 1, 0xAA);
+        CHECK(aes256_gcm_decrypt(untouched.data(), v.ciphertext.data(), v.ciphertext.size(), bad_tag.data(),
+                                 v.aad.data(), v.aad.size(), v.key.data(), v.iv.data()) == AES_GCM_ERROR_AUTH_FAILED);
+        CHECK(untouched[0] == 0xAA);
+    }
+}
+
+}  // namespace
+
+int main() {
+    test_util::for_each_cpu_mask(test_vectors);
+    return test_util::result("aes_gcm_test");
+}
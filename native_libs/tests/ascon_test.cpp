@@ -0,0 +1,58 @@
+// KAT Ascon-128a v1.2 dalam format LWC_AEAD_KAT_128_128 (Key = Nonce = 00..0F,
+// PT dan AD = 00 01 02 ...). Count = panjang_PT * 33 + panjang_AD + 1.
+
+#include "ascon.h"
+#include "test_util.h"
+
+using test_util::check_bytes;
+using test_util::hex;
+
+namespace {
+
+struct AsconVector {
+    int count;
+    size_t pt_len;
+    size_t ad_len;
+    const char *ct_and_tag;
+};
+
+const AsconVector kVectors[] = {
+    {1, 0, 0, "7A834E6F09210957067B10FD831F0078"},
+    {2, 0, 1, "AF3031B07B129EC84153373DDCABA528"},
+    {33, 0, 32, "2FDEE642B4C31C2F205DCC8B3DAD4542"},
+    {34, 1, 0, "6E652B55BFDC8CAD2EC43815B1666B1A3A"},
+    {35, 1, 1, "E9C2813CC8C6DD2F245F3BB976DA566E9D"},
+    {512, 15, 16, "52499AC9C84323A4AE24EAECCF45C14BB7700C338C95A089F524C515460CC7"},
+    {544, 16, 15, "8DA2ED95D643524AC99A1BBB2294939B73E8824A6FEE53CDBDEE674FF1DAC93D"},
+    {1089, 32, 32, "A55236AC020DBDA74CE6CCD10C68C4D8514450A382BC87C68946D86A921DD88E2ADDDFBBE77D4112830E01960B9D38D5"},
+};
+
+}  // namespace
+
+int main() {
+    uint8_t key[ASCON128A_KEY_BYTES];
+    uint8_t nonce[ASCON128A_NONCE_BYTES];
+    uint8_t data[32];
+    for (int i = 0; i < 16; i++) key[i] = nonce[i] = static_cast<uint8_t>(i);
+    for (int i = 0; i < 32; i++) data[i] = static_cast<uint8_t>(i);
+
+    for (const AsconVector &v : kVectors) {
+        const auto expected = hex(v.ct_and_tag);
+        uint8_t ct[32 + ASCON128A_TAG_BYTES];
+        CHECK(ascon128a_encrypt(ct, ct + v.pt_len, data, v.pt_len, data, v.ad_len, key, nonce) == ASCON_OK);
+        char name[32];
+        snprintf(name, sizeof(name), "ascon128a Count = %d", v.count);
+        check_bytes(name, ct, expected);
+
+        uint8_t pt[32];
+        CHECK(ascon128a_decrypt(pt, expected.data(), v.pt_len, expected.data() + v.pt_len, data, v.ad_len, key,
+                                nonce) == ASCON_OK);
+        CHECK(memcmp(pt, data, v.pt_len) == 0);
+
+        std::vector<uint8_t> forged = expected;
+        forged.back() ^= 1;
+        CHECK(ascon128a_decrypt(pt, forged.data(), v.pt_len, forged.data() + v.pt_len, data, v.ad_len, key,
+                                nonce) == ASCON_ERROR_AUTH_FAILED);
+    }
+    return test_util::result("ascon_test");
+}
@@ -0,0 +1,270 @@
+// Test blob_store: round-trip dan dedup, replay journal setelah reopen (termasuk baris
+// terpotong, blob yatim dan entri tanpa file), urutan eviction LRU/LFU, dan put paralel
+// dengan eviction yang tidak boleh meninggalkan record journal tanpa file, serta put_file.
+
+#include "blob_store.h"
+#include "test_util.h"
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+struct TempDir {
+    fs::path path;
+    TempDir() {
+        static int counter = 0;
+        const auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+        path = fs::temp_directory_path() /
+               ("blob_store_test_" + std::to_string(now) + "_" + std::to_string(counter++));
+        fs::remove_all(path);
+    }
+    ~TempDir() {
+        std::error_code ec;
+        fs::remove_all(path, ec);
+    }
+};
+
+BlobStore *open_store(const fs::path &root, uint64_t budget, int policy) {
+    const std::string root_text = root.string();
+    BlobStoreConfig config;
+    config.root = root_text.c_str();
+    config.byte_budget = budget;
+    config.policy = policy;
+    int status = -99;
+    BlobStore *store = blob_store_open(&config, &status);
+    CHECK(store != nullptr && status == BLOB_STORE_OK);
+    return store;
+}
+
+std::vector<uint8_t> blob(uint8_t fill, size_t len) {
+    std::vector<uint8_t> data(len, fill);
+    data[0] = static_cast<uint8_t>(len);
+    return data;
+}
+
+std::string put(BlobStore *store, const std::vector<uint8_t> &data, const char *name = nullptr, int pin = 0) {
+    char hash[BLOB_STORE_HASH_HEX_BYTES];
+    CHECK(blob_store_put(store, data.data(), data.size(), name, pin, hash) == BLOB_STORE_OK);
+    return hash;
+}
+
+bool has(BlobStore *store, const std::string &hash) {
+    BlobData out;
+    const int status = blob_store_get(store, hash.c_str(), &out);
+    blob_store_free(&out);
+    return status == BLOB_STORE_OK;
+}
+
+BlobStoreStats stats(BlobStore *store) {
+    BlobStoreStats out;
+    blob_store_get_stats(store, &out);
+    return out;
+}
+
+void test_round_trip_and_dedup() {
+    TempDir dir;
+    BlobStore *store = open_store(dir.path, 0, BLOB_STORE_EVICT_LRU);
+    if (!store) return;
+
+    const std::vector<uint8_t> data = test_util::bytes("ciphertext attachment");
+    const std::string hash = put(store, data, "chat/a.bin");
+    // 256 bit pertama SHA-512("ciphertext attachment"), dihitung dengan hashlib Python
+    CHECK(hash == "93a335f83e79f5ebdf2973d747dac98f7190b47643285db88ea049c07c7be501");
+    CHECK(put(store, data, "chat/b.bin") == hash);
+    CHECK(stats(store).blob_count == 1 && stats(store).dedup_hits == 1);
+
+    char looked_up[BLOB_STORE_HASH_HEX_BYTES];
+    CHECK(blob_store_lookup(store, "chat/b.bin", looked_up) == BLOB_STORE_OK && hash == looked_up);
+    CHECK(blob_store_lookup(store, "chat/none.bin", looked_up) == BLOB_STORE_ERROR_NOT_FOUND);
+
+    BlobData out;
+    CHECK(blob_store_get(store, hash.c_str(), &out) == BLOB_STORE_OK);
+    CHECK(out.len == data.size() && memcmp(out.data, data.data(), data.size()) == 0);
+    blob_store_free(&out);
+    CHECK(blob_store_put(store, data.data(), data.size(), "bad\nname", 0, looked_up) == BLOB_STORE_ERROR_INVALID_INPUT);
+    blob_store_close(store);
+}
+
+void test_journal_replay() {
+    TempDir dir;
+    std::string kept, pinned, vanished;
+    {
+        BlobStore *store = open_store(dir.path, 0, BLOB_STORE_EVICT_LRU);
+        if (!store) return;
+        kept = put(store, blob(1, 100), "kept.bin");
+        pinned = put(store, blob(2, 100), nullptr, 1);
+        vanished = put(store, blob(3, 100), "vanished.bin");
+        blob_store_close(store);
+    }
+
+    // File blob hilang di luar store, satu blob yatim tanpa record, dan append terakhir
+    // terpotong crash (tanpa newline)
+    fs::remove(dir.path / "objects" / vanished.substr(0, 2) / vanished);
+    {
+        BlobStore *store = open_store(dir.path, 0, BLOB_STORE_EVICT_LRU);
+        if (!store) return;
+        const std::string orphan = put(store, blob(4, 50));
+        blob_store_close(store);
+        // Hapus semua record tentang orphan dari journal: file tetap ada tanpa record
+        FILE *file = fopen((dir.path / "journal.log").string().c_str(), "rb");
+        CHECK(file != nullptr);
+        if (!file) return;
+        std::string text;
+        char buffer[4096];
+        size_t n;
+        while ((n = fread(buffer, 1, sizeof(buffer), file)) > 0) text.append(buffer, n);
+        fclose(file);
+        std::string filtered;
+        size_t pos = 0;
+        while (pos < text.size()) {
+            const size_t end = text.find('\n', pos);
+            const std::string line = text.substr(pos, end - pos + 1);
+            if (line.find(orphan) == std::string::npos) filtered += line;
+            pos = end + 1;
+        }
+        filtered += "P " + kept.substr(0, 10);
+        file = fopen((dir.path / "journal.log").string().c_str(), "wb");
+        fwrite(filtered.data(), 1, filtered.size(), file);
+        fclose(file);
+    }
+
+    BlobStore *store = open_store(dir.path, 0, BLOB_STORE_EVICT_LRU);
+    if (!store) return;
+    const BlobStoreStats s = stats(store);
+    CHECK(s.blob_count == 3);
+    CHECK(s.recovered_orphans == 1);
+    CHECK(s.pinned_bytes == 100);
+    CHECK(has(store, kept) && has(store, pinned) && !has(store, vanished));
+    char hash[BLOB_STORE_HASH_HEX_BYTES];
+    CHECK(blob_store_lookup(store, "kept.bin", hash) == BLOB_STORE_OK && kept == hash);
+    CHECK(blob_store_lookup(store, "vanished.bin", hash) == BLOB_STORE_ERROR_NOT_FOUND);
+    blob_store_close(store);
+}
+
+void test_lru_eviction() {
+    TempDir dir;
+    BlobStore *store = open_store(dir.path, 300, BLOB_STORE_EVICT_LRU);
+    if (!store) return;
+    const std::string a = put(store, blob(1, 100));
+    const std::string b = put(store, blob(2, 100));
+    const std::string c = put(store, blob(3, 100));
+    CHECK(has(store, a));  // a jadi paling baru diakses
+    const std::string d = put(store, blob(4, 100));
+    CHECK(!has(store, b));
+    CHECK(has(store, a) && has(store, c) && has(store, d));
+
+    // Blob yang di-pin tidak pernah dievict; release membuatnya evictable lagi
+    const std::string p = put(store, blob(5, 250), nullptr, 1);
+    CHECK(has(store, p));
+    CHECK(stats(store).total_bytes <= 300 + 250);
+    CHECK(blob_store_release(store, p.c_str()) == BLOB_STORE_OK);
+    CHECK(stats(store).total_bytes <= 300);
+    blob_store_close(store);
+}
+
+// Blob baru mulai dari rata-rata hits, jadi bukan korban LFU pertama
+void test_lfu_new_blob_not_first_victim() {
+    TempDir dir;
+    BlobStore *store = open_store(dir.path, 300, BLOB_STORE_EVICT_LFU);
+    if (!store) return;
+    const std::string a = put(store, blob(1, 100));
+    const std::string b = put(store, blob(2, 100));
+    for (int i = 0; i < 4; i++) {
+        has(store, a);
+        has(store, b);
+    }
+    const std::string c = put(store, blob(3, 100));
+    const std::string d = put(store, blob(4, 100));
+    // Hits sama, a paling lama diakses di antara yang bersaing
+    CHECK(has(store, c));
+    CHECK(has(store, d));
+    CHECK(stats(store).evictions == 1);
+    CHECK(!has(store, a));
+    blob_store_close(store);
+}
+
+// Put paralel konten yang sama dan berbeda dengan budget kecil: setiap entri yang tercatat
+// harus punya file, yang dibuktikan reopen (entri tanpa file dibuang saat open)
+void test_concurrent_put_and_evict() {
+    TempDir dir;
+    BlobStore *store = open_store(dir.path, 4 * 64, BLOB_STORE_EVICT_LRU);
+    if (!store) return;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([store, t] {
+            for (int i = 0; i < 200; i++) {
+                const std::vector<uint8_t> data = blob(static_cast<uint8_t>((i + t) % 8), 64);
+                char hash[BLOB_STORE_HASH_HEX_BYTES];
+                blob_store_put(store, data.data(), data.size(), nullptr, 0, hash);
+            }
+        });
+    }
+    for (auto &thread : threads) thread.join();
+    const uint64_t before = stats(store).blob_count;
+    CHECK(before > 0 && stats(store).total_bytes <= 4 * 64);
+    blob_store_close(store);
+
+    store = open_store(dir.path, 4 * 64, BLOB_STORE_EVICT_LRU);
+    if (!store) return;
+    CHECK(stats(store).blob_count == before);
+    CHECK(stats(store).recovered_orphans == 0);
+    blob_store_close(store);
+}
+
+}  // namespace
+
+void test_put_file() {
+    TempDir dir;
+    BlobStore *store = open_store(dir.path / "store", 0, BLOB_STORE_EVICT_LRU);
+    if (!store) return;
+
+    // Ciphertext dari file (upload_pipeline cipher_path) sama dengan put dari memory
+    const std::vector<uint8_t> data = blob(0x5A, 200 * 1024 + 7);
+    const fs::path source = dir.path / "upload.cipher";
+    FILE *file = fopen(source.string().c_str(), "wb");
+    CHECK(file != nullptr);
+    if (!file) return;
+    fwrite(data.data(), 1, data.size(), file);
+    fclose(file);
+
+    char hash[BLOB_STORE_HASH_HEX_BYTES];
+    CHECK(blob_store_put_file(store, source.string().c_str(), "uploads/a.bin", 0, hash) == BLOB_STORE_OK);
+    CHECK(!fs::exists(source));
+    char by_name[BLOB_STORE_HASH_HEX_BYTES];
+    CHECK(blob_store_lookup(store, "uploads/a.bin", by_name) == BLOB_STORE_OK && strcmp(by_name, hash) == 0);
+    BlobData out;
+    CHECK(blob_store_get(store, hash, &out) == BLOB_STORE_OK);
+    CHECK(out.len == data.size() && memcmp(out.data, data.data(), data.size()) == 0);
+    blob_store_free(&out);
+    CHECK(put(store, data) == hash);
+
+    // Ciphertext yang sudah ada: dedup, file sumber tetap dihapus
+    file = fopen(source.string().c_str(), "wb");
+    if (file) {
+        fwrite(data.data(), 1, data.size(), file);
+        fclose(file);
+    }
+    CHECK(blob_store_put_file(store, source.string().c_str(), "uploads/b.bin", 0, hash) == BLOB_STORE_OK);
+    CHECK(!fs::exists(source));
+    CHECK(stats(store).blob_count == 1 && stats(store).dedup_hits == 2);
+
+    CHECK(blob_store_put_file(store, source.string().c_str(), nullptr, 0, hash) == BLOB_STORE_ERROR_NOT_FOUND);
+    CHECK(blob_store_put_file(store, "", nullptr, 0, hash) == BLOB_STORE_ERROR_INVALID_INPUT);
+    blob_store_close(store);
+}
+
+int main() {
+    test_round_trip_and_dedup();
+    test_journal_replay();
+    test_lru_eviction();
+    test_lfu_new_blob_not_first_victim();
+    test_concurrent_put_and_evict();
+    test_put_file();
+    return test_util::result("blob_store_test");
+}
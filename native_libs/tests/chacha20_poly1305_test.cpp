@@ -0,0 +1,189 @@
+// KAT ChaCha20, Poly1305 dan AEAD dari RFC 8439 (2.4.2, 2.5.2, 2.8.2), plus
+// chacha20_poly1305_{seal,open}_batch dan keystream_pool yang harus identik dengan
+// jalur satu pesan di setiap implementasi cpu_features.
+
+#include "aead_batch.h"
+#include "chacha20_poly1305.h"
+#include "keystream_pool.h"
+#include "message_aead.h"
+#include "test_util.h"
+
+using test_util::bytes;
+using test_util::check_bytes;
+using test_util::hex;
+
+namespace {
+
+const char kSunscreen[] =
+    "Ladies and Gentlemen of the class of '99: If I could offer you only one tip for the future, "
+    "sunscreen would be it.";
+
+void test_chacha20_rfc8439() {
+    std::vector<uint8_t> key(32);
+    for (int i = 0; i < 32; i++) key[i] = static_cast<uint8_t>(i);
+    const auto nonce = hex("000000000000004a00000000");
+    const auto plaintext = bytes(kSunscreen);
+    const auto expected = hex(
+        "6e2e359a2568f98041ba0728dd0d6981e97e7aec1d4360c20a27afccfd9fae0bf91b65c5524733ab8f593dabcd62b357"
+        "1639d624e65152ab8f530c359f0861d807ca0dbf500d6a6156a38e088a22b65e52bc514d16ccf806818ce91ab7793736"
+        "5af90bbf74a35be6b40b8eedf2785e42874d");
+
+    std::vector<uint8_t> out(plaintext.size());
+    chacha20_xor(out.data(), plaintext.data(), plaintext.size(), key.data(), nonce.data(), 1);
+    check_bytes("RFC 8439 2.4.2 chacha20", out.data(), expected);
+}
+
+void test_poly1305_rfc8439() {
+    const auto key = hex("85d6be7857556d337f4452fe42d506a80103808afb0db2fd4abff6af4149f51b");
+    const auto message = bytes("Cryptographic Forum Research Group");
+
+    uint8_t tag[POLY1305_TAG_BYTES];
+    POLY1305_CTX ctx;
+    poly1305_init(&ctx, key.data());
+    // Dipecah supaya jalur buffer leftover ikut teruji
+    poly1305_update(&ctx, message.data(), 5);
+    poly1305_update(&ctx, message.data() + 5, message.size() - 5);
+    poly1305_final(&ctx, tag);
+    check_bytes("RFC 8439 2.5.2 poly1305", tag, hex("a8061dc1305136c6c22b8baf0c0127a9"));
+}
+
+struct AeadVector {
+    std::vector<uint8_t> key;
+    std::vector<uint8_t> nonce;
+    std::vector<uint8_t> aad;
+    std::vector<uint8_t> plaintext;
+    std::vector<uint8_t> ciphertext;
+    std::vector<uint8_t> tag;
+};
+
+AeadVector rfc8439_aead_vector() {
+    AeadVector v;
+    for (int i = 0; i < 32; i++) v.key.push_back(static_cast<uint8_t>(0x80 + i));
+    v.nonce = hex("070000004041424344454647");
+    v.aad = hex("50515253c0c1c2c3c4c5c6c7");
+    v.plaintext = bytes(kSunscreen);
+    v.ciphertext = hex(
+        "d31a8d34648e60db7b86afbc53ef7ec2a4aded51296e08fea9e2b5a736ee62d63dbea45e8ca9671282fafb69da92728b"
+        "1a71de0a9e060b2905d6a5b67ecd3b3692ddbd7f2d778b8c9803aee328091b58fab324e4fad675945585808b4831d7bc"
+        "3ff4def08e4b7a9de576d26586cec64b6116");
+    v.tag = hex("1ae10b594f09e26a7e902ecbd0600691");
+    return v;
+}
+
+void test_aead_rfc8439() {
+    const AeadVector v = rfc8439_aead_vector();
+    std::vector<uint8_t> ct(v.plaintext.size());
+    uint8_t tag[POLY1305_TAG_BYTES];
+    CHECK(chacha20_poly1305_encrypt(ct.data(), tag, v.plaintext.data(), v.plaintext.size(), v.aad.data(),
+                                    v.aad.size(), v.key.data(), v.nonce.data()) == AEAD_OK);
+    check_bytes("RFC 8439 2.8.2 ciphertext", ct.data(), v.ciphertext);
+    check_bytes("RFC 8439 2.8.2 tag", tag, v.tag);
+
+    std::vector<uint8_t> pt(ct.size());
+    CHECK(chacha20_poly1305_decrypt(pt.data(), ct.data(), ct.size(), tag, v.aad.data(), v.aad.size(),
+                                    v.key.data(), v.nonce.data()) == AEAD_OK);
+    check_bytes("RFC 8439 2.8.2 decrypt", pt.data(), v.plaintext);
+
+    tag[0] ^= 1;
+    CHECK(chacha20_poly1305_decrypt(pt.data(), ct.data(), ct.size(), tag, v.aad.data(), v.aad.size(),
+                                    v.key.data(), v.nonce.data()) == AEAD_ERROR_AUTH_FAILED);
+}
+
+// Batch dengan panjang campuran (lebih dari satu grup lane + sisa) harus sama persis
+// dengan chacha20_poly1305_encrypt per pesan, termasuk item RFC 8439 di tengah batch
+void test_batch_matches_single(uint32_t features) {
+    const AeadVector rfc = rfc8439_aead_vector();
+    const size_t lengths[] = {0, 1, 15, 16, 63, 64, 65, 114, 127, 128, 255, 256, 257, 1000, 3, 40, 500, 2048, 7};
+    const size_t count = sizeof(lengths) / sizeof(lengths[0]);
+
+    std::vector<std::vector<uint8_t>> keys(count), nonces(count), plains(count), outs(count), expected(count);
+    std::vector<std::vector<uint8_t>> tags(count, std::vector<uint8_t>(POLY1305_TAG_BYTES));
+    std::vector<std::vector<uint8_t>> expected_tags(count, std::vector<uint8_t>(POLY1305_TAG_BYTES));
+    std::vector<AeadBatchItem> items(count);
+
+    for (size_t i = 0; i < count; i++) {
+        const bool use_rfc = i == 7;
+        keys[i] = use_rfc ? rfc.key : std::vector<uint8_t>(32, static_cast<uint8_t>(i * 13 + 1));
+        nonces[i] = use_rfc ? rfc.nonce : std::vector<uint8_t>(12, static_cast<uint8_t>(i * 7 + 5));
+        plains[i] = use_rfc ? rfc.plaintext : std::vector<uint8_t>(lengths[i]);
+        if (!use_rfc) {
+            for (size_t j = 0; j < plains[i].size(); j++) plains[i][j] = static_cast<uint8_t>(j * 31 + i);
+        }
+        const std::vector<uint8_t> &aad = use_rfc ? rfc.aad : keys[i];
+        const size_t aad_len = use_rfc ? aad.size() : i % 17;
+
+        outs[i].assign(plains[i].size() + 1, 0);
+        expected[i].assign(plains[i].size() + 1, 0);
+        chacha20_poly1305_encrypt(expected[i].data(), expected_tags[i].data(), plains[i].data(), plains[i].size(),
+                                  aad.data(), aad_len, keys[i].data(), nonces[i].data());
+
+        items[i] = AeadBatchItem{outs[i].data(), plains[i].data(), static_cast<uint32_t>(plains[i].size()),
+                                 aad.data(), static_cast<uint32_t>(aad_len), keys[i].data(), nonces[i].data(),
+                                 tags[i].data(), -99};
+    }
+
+    CHECK(chacha20_poly1305_seal_batch(items.data(), count) == count);
+    for (size_t i = 0; i < count; i++) {
+        CHECK(items[i].status == AEAD_OK);
+        if (!check_bytes("seal_batch ciphertext", outs[i].data(), expected[i])) {
+            fprintf(stderr, "  item %zu, features 0x%x\n", i, features);
+        }
+        check_bytes("seal_batch tag", tags[i].data(), expected_tags[i]);
+    }
+    check_bytes("seal_batch RFC 8439 tag", tags[7].data(), rfc.tag);
+
+    // Open: satu tag dirusak, item lain tetap harus terbuka
+    std::vector<std::vector<uint8_t>> opened(count);
+    for (size_t i = 0; i < count; i++) {
+        opened[i].assign(plains[i].size() + 1, 0);
+        items[i].out = opened[i].data();
+        items[i].in = expected[i].data();
+        items[i].status = -99;
+    }
+    tags[3][5] ^= 0x40;
+    CHECK(chacha20_poly1305_open_batch(items.data(), count) == count - 1);
+    for (size_t i = 0; i < count; i++) {
+        if (i == 3) {
+            CHECK(items[i].status == AEAD_ERROR_AUTH_FAILED);
+            continue;
+        }
+        CHECK(items[i].status == AEAD_OK);
+        check_bytes("open_batch plaintext", opened[i].data(), plains[i]);
+    }
+}
+
+// Slot keystream_pool menghasilkan byte yang sama dengan message_aead_seal (subkey ChaCha20
+// dari key pesan), jadi penerima cukup message_aead_open
+void test_keystream_pool_matches_aead() {
+    const AeadVector v = rfc8439_aead_vector();
+    KeystreamPool *pool = keystream_pool_create(v.key.data(), 2, 256);
+    CHECK(pool != nullptr);
+    if (pool == nullptr) return;
+
+    CHECK(keystream_pool_refill(pool, v.nonce.data(), 1) == 1);
+    std::vector<uint8_t> ct(v.plaintext.size()), expected(v.plaintext.size());
+    uint8_t tag[POLY1305_TAG_BYTES], expected_tag[POLY1305_TAG_BYTES];
+    uint8_t nonce[CHACHA20_NONCE_BYTES];
+    CHECK(keystream_pool_seal(pool, ct.data(), tag, nonce, v.plaintext.data(), v.plaintext.size(),
+                              v.aad.data(), v.aad.size()) == KEYSTREAM_POOL_OK);
+    CHECK(message_aead_seal(MESSAGE_AEAD_CHACHA20_POLY1305, expected.data(), expected_tag, v.plaintext.data(),
+                            v.plaintext.size(), v.aad.data(), v.aad.size(), v.key.data(), v.nonce.data(),
+                            v.nonce.size()) == MESSAGE_AEAD_OK);
+    CHECK(ct == expected);
+    CHECK(memcmp(tag, expected_tag, sizeof(tag)) == 0);
+    check_bytes("keystream_pool nonce", nonce, v.nonce);
+    keystream_pool_destroy(pool);
+}
+
+}  // namespace
+
+int main() {
+    test_chacha20_rfc8439();
+    test_poly1305_rfc8439();
+    test_util::for_each_cpu_mask([](uint32_t features) {
+        test_aead_rfc8439();
+        test_batch_matches_single(features);
+    });
+    test_keystream_pool_matches_aead();
+    return test_util::result("chacha20_poly1305_test");
+}
@@ -0,0 +1,275 @@
+// Test chat_cache: layout halaman (meta/text, penanda gagal decrypt), penggantian halaman,
+// eviksi LRU sesuai byte budget, remove/clear, dan file halaman terenkripsi Adiantum
+// (ciphertext dicocokkan dengan model Python dari adiantum_test).
+
+#include "chat_cache.h"
+#include "sha512.h"
+#include "test_util.h"
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+
+using test_util::bytes;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const std::vector<uint8_t> kKey = bytes("chat-key-dari-base64");
+const std::vector<uint8_t> kIv = test_util::hex("000102030405060708090a0b0c0d0e0f");
+
+std::vector<uint8_t> xor_with_iv(const std::vector<uint8_t> &data) {
+    std::vector<uint8_t> out(data.size());
+    for (size_t i = 0; i < data.size(); i++) {
+        out[i] = static_cast<uint8_t>(data[i] ^ ((kKey[i % kKey.size()] + kIv[i % kIv.size()] + i) % 256));
+    }
+    return out;
+}
+
+struct Source {
+    std::vector<uint8_t> meta;
+    std::vector<uint8_t> ciphertext;
+};
+
+int put_page(ChatCache *cache, const char *chat_id, const std::vector<Source> &sources) {
+    std::vector<ChatCacheMessage> messages(sources.size());
+    for (size_t i = 0; i < sources.size(); i++) {
+        messages[i].meta = sources[i].meta.data();
+        messages[i].meta_len = static_cast<uint32_t>(sources[i].meta.size());
+        messages[i].ciphertext = sources[i].ciphertext.data();
+        messages[i].ciphertext_len = static_cast<uint32_t>(sources[i].ciphertext.size());
+        messages[i].iv = kIv.data();
+        messages[i].iv_len = static_cast<uint32_t>(kIv.size());
+    }
+    return chat_cache_put_xor_page(cache, chat_id, messages.data(), static_cast<uint32_t>(messages.size()),
+                                   kKey.data(), kKey.size());
+}
+
+uint32_t read_u32(const uint8_t *p) {
+    return static_cast<uint32_t>(p[0]) | static_cast<uint32_t>(p[1]) << 8 | static_cast<uint32_t>(p[2]) << 16 |
+           static_cast<uint32_t>(p[3]) << 24;
+}
+
+void test_page_layout() {
+    ChatCache *cache = chat_cache_create(0);
+    // UTF-8 tidak valid setelah decrypt -> ditandai gagal, meta tetap disimpan
+    const std::vector<Source> sources = {
+        {bytes("id-1|alice"), xor_with_iv(bytes("halo"))},
+        {bytes("id-2|bob"), xor_with_iv(test_util::hex("c328"))},
+        {{}, xor_with_iv(bytes("\xC3\xA9 tanpa meta"))},
+    };
+    CHECK(put_page(cache, "chat-1", sources) == 2);
+
+    ChatCachePage page;
+    CHECK(chat_cache_get(cache, "chat-1", &page) == CHAT_CACHE_OK);
+    CHECK(page.count == 3);
+    const char *expected_meta[] = {"id-1|alice", "id-2|bob", ""};
+    const char *expected_text[] = {"halo", nullptr, "\xC3\xA9 tanpa meta"};
+    size_t pos = 0;
+    for (uint32_t i = 0; i < page.count && pos + CHAT_CACHE_RECORD_HEADER_BYTES <= page.len; i++) {
+        const uint32_t meta_len = read_u32(page.data + pos);
+        const uint32_t text_len = read_u32(page.data + pos + 4);
+        pos += CHAT_CACHE_RECORD_HEADER_BYTES;
+        CHECK(meta_len == strlen(expected_meta[i]) && memcmp(page.data + pos, expected_meta[i], meta_len) == 0);
+        pos += meta_len;
+        if (!expected_text[i]) {
+            CHECK(text_len == CHAT_CACHE_DECRYPT_FAILED);
+            continue;
+        }
+        CHECK(text_len == strlen(expected_text[i]) && memcmp(page.data + pos, expected_text[i], text_len) == 0);
+        pos += text_len;
+    }
+    CHECK(pos == page.len);
+    chat_cache_free(&page);
+    CHECK(page.data == nullptr && page.len == 0);
+
+    // put mengganti halaman lama, bukan menambah
+    CHECK(put_page(cache, "chat-1", {{bytes("id-3"), xor_with_iv(bytes("baru"))}}) == 1);
+    CHECK(chat_cache_get(cache, "chat-1", &page) == CHAT_CACHE_OK);
+    CHECK(page.count == 1 && page.len == CHAT_CACHE_RECORD_HEADER_BYTES + 8);
+    chat_cache_free(&page);
+
+    ChatCacheStats stats;
+    chat_cache_get_stats(cache, &stats);
+    CHECK(stats.entries == 1 && stats.total_bytes == CHAT_CACHE_RECORD_HEADER_BYTES + 8);
+    CHECK(stats.hits == 2 && stats.misses == 0);
+    CHECK(stats.messages_decrypted == 3 && stats.decrypt_failures == 1);
+    chat_cache_destroy(cache);
+}
+
+void test_lru_eviction() {
+    // Satu halaman = 8 + 4 + 40 byte; budget muat dua halaman
+    ChatCache *cache = chat_cache_create(2 * 52 + 10);
+    const std::vector<Source> page = {{bytes("meta"), xor_with_iv(std::vector<uint8_t>(40, 'a'))}};
+    CHECK(put_page(cache, "a", page) == 1);
+    CHECK(put_page(cache, "b", page) == 1);
+
+    ChatCachePage out;
+    CHECK(chat_cache_get(cache, "a", &out) == CHAT_CACHE_OK);  // a jadi paling baru
+    chat_cache_free(&out);
+    CHECK(put_page(cache, "c", page) == 1);                     // b dievict
+
+    CHECK(chat_cache_get(cache, "b", &out) == CHAT_CACHE_ERROR_NOT_FOUND && out.data == nullptr);
+    CHECK(chat_cache_get(cache, "a", &out) == CHAT_CACHE_OK);
+    chat_cache_free(&out);
+    CHECK(chat_cache_get(cache, "c", &out) == CHAT_CACHE_OK);
+    chat_cache_free(&out);
+
+    ChatCacheStats stats;
+    chat_cache_get_stats(cache, &stats);
+    CHECK(stats.entries == 2 && stats.total_bytes == 2 * 52 && stats.evictions == 1 && stats.evicted_bytes == 52);
+    CHECK(stats.misses == 1);
+
+    // Halaman yang lebih besar dari budget ditolak tanpa mengganggu isi cache
+    const std::vector<Source> huge = {{{}, xor_with_iv(std::vector<uint8_t>(200, 'x'))}};
+    CHECK(put_page(cache, "d", huge) == CHAT_CACHE_ERROR_TOO_LARGE);
+    chat_cache_get_stats(cache, &stats);
+    CHECK(stats.entries == 2);
+
+    CHECK(chat_cache_remove(cache, "a") == CHAT_CACHE_OK);
+    CHECK(chat_cache_remove(cache, "a") == CHAT_CACHE_ERROR_NOT_FOUND);
+    chat_cache_clear(cache);
+    chat_cache_get_stats(cache, &stats);
+    CHECK(stats.entries == 0 && stats.total_bytes == 0);
+
+    CHECK(chat_cache_put_xor_page(cache, "x", nullptr, 1, kKey.data(), kKey.size()) ==
+          CHAT_CACHE_ERROR_INVALID_INPUT);
+    CHECK(chat_cache_put_xor_page(cache, "x", nullptr, 0, kKey.data(), 0) == CHAT_CACHE_ERROR_INVALID_INPUT);
+    chat_cache_destroy(cache);
+}
+
+struct TempFile {
+    std::string path;
+    TempFile() {
+        static int counter = 0;
+        const auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+        path = (fs::temp_directory_path() /
+                ("chat_cache_test_" + std::to_string(now) + "_" + std::to_string(counter++) + ".page"))
+                   .string();
+    }
+    ~TempFile() {
+        std::error_code ec;
+        fs::remove(path, ec);
+        fs::remove(path + ".tmp", ec);
+    }
+};
+
+std::vector<uint8_t> read_all(const std::string &path) {
+    std::vector<uint8_t> out;
+    FILE *file = fopen(path.c_str(), "rb");
+    if (!file) return out;
+    uint8_t buffer[4096];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), file)) > 0) out.insert(out.end(), buffer, buffer + n);
+    fclose(file);
+    return out;
+}
+
+void write_all(const std::string &path, const std::vector<uint8_t> &data) {
+    FILE *file = fopen(path.c_str(), "wb");
+    if (!file) return;
+    fwrite(data.data(), 1, data.size(), file);
+    fclose(file);
+}
+
+std::string sha512_hex(const std::vector<uint8_t> &data) {
+    SHA512_CTX ctx;
+    uint8_t digest[SHA512_DIGEST_BYTES];
+    sha512_init(&ctx);
+    sha512_update(&ctx, data.data(), data.size());
+    sha512_final(digest, &ctx);
+    return test_util::to_hex(digest, sizeof(digest));
+}
+
+std::vector<uint8_t> page_bytes(ChatCache *cache, const char *chat_id, uint32_t *count) {
+    ChatCachePage page;
+    if (chat_cache_get(cache, chat_id, &page) != CHAT_CACHE_OK) return {};
+    std::vector<uint8_t> out(page.data, page.data + page.len);
+    *count = page.count;
+    chat_cache_free(&page);
+    return out;
+}
+
+void test_file_round_trip() {
+    // Halaman > 4 KiB supaya file terdiri dari dua halaman Adiantum
+    ChatCache *cache = chat_cache_create(0);
+    const std::vector<Source> sources = {
+        {bytes("id-1|alice"), xor_with_iv(bytes("halo"))},
+        {bytes("id-2|bob"), xor_with_iv(test_util::hex("c328"))},
+        {bytes("id-3|alice"), xor_with_iv(std::vector<uint8_t>(5000, 'z'))},
+    };
+    CHECK(put_page(cache, "chat-1", sources) == 2);
+    uint32_t count = 0;
+    const std::vector<uint8_t> original = page_bytes(cache, "chat-1", &count);
+    CHECK(count == 3 && original.size() == 3 * CHAT_CACHE_RECORD_HEADER_BYTES + 28 + 4 + 5000);
+
+    TempFile file;
+    CHECK(chat_cache_save_file(cache, "chat-1", file.path.c_str(), kKey.data(), kKey.size()) == CHAT_CACHE_OK);
+    CHECK(!fs::exists(file.path + ".tmp"));
+    const std::vector<uint8_t> disk = read_all(file.path);
+    CHECK(disk.size() == CHAT_CACHE_FILE_HEADER_BYTES + original.size());
+    CHECK(read_u32(disk.data()) == CHAT_CACHE_FILE_MAGIC && read_u32(disk.data() + 4) == 3);
+    CHECK(read_u32(disk.data() + 8) == original.size() && read_u32(disk.data() + 12) == 0);
+    // Key = HMAC-SHA512(chat key, "chat_cache_file" || chat_id), file_id = SHA-512(chat_id)
+    CHECK(sha512_hex(disk) ==
+          "fde59c86a88f53fafdf6f210c7278c9f1aba67998d1f62080ac3d051cfa5dbb6"
+          "eb294b30b04f48faa4c0d31559148e6ca335d462dbffe986a4f4833ff121dd63");
+    const std::string text(disk.begin(), disk.end());
+    CHECK(text.find("alice") == std::string::npos && text.find("halo") == std::string::npos);
+
+    // Proses baru: cache kosong dimuat dari file
+    ChatCache *restored = chat_cache_create(0);
+    CHECK(chat_cache_load_file(restored, "chat-1", file.path.c_str(), kKey.data(), kKey.size()) == 3);
+    uint32_t restored_count = 0;
+    CHECK(page_bytes(restored, "chat-1", &restored_count) == original && restored_count == 3);
+
+    // Halaman yang sudah ada (dari warm sync) tidak ditimpa file lama
+    CHECK(put_page(restored, "chat-1", {{bytes("id-9"), xor_with_iv(bytes("baru"))}}) == 1);
+    CHECK(chat_cache_load_file(restored, "chat-1", file.path.c_str(), kKey.data(), kKey.size()) == 1);
+
+    // Key, chat_id atau isi yang salah terbaca sebagai layout rusak
+    ChatCache *other = chat_cache_create(0);
+    const std::vector<uint8_t> wrong_key = bytes("chat-key-lain");
+    CHECK(chat_cache_load_file(other, "chat-1", file.path.c_str(), wrong_key.data(), wrong_key.size()) ==
+          CHAT_CACHE_ERROR_CORRUPT);
+    CHECK(chat_cache_load_file(other, "chat-2", file.path.c_str(), kKey.data(), kKey.size()) ==
+          CHAT_CACHE_ERROR_CORRUPT);
+    std::vector<uint8_t> tampered = disk;
+    tampered[CHAT_CACHE_FILE_HEADER_BYTES + 100] ^= 0x01;
+    write_all(file.path, tampered);
+    CHECK(chat_cache_load_file(other, "chat-1", file.path.c_str(), kKey.data(), kKey.size()) ==
+          CHAT_CACHE_ERROR_CORRUPT);
+    write_all(file.path, std::vector<uint8_t>(disk.begin(), disk.end() - 1));
+    CHECK(chat_cache_load_file(other, "chat-1", file.path.c_str(), kKey.data(), kKey.size()) ==
+          CHAT_CACHE_ERROR_CORRUPT);
+    ChatCacheStats stats;
+    chat_cache_get_stats(other, &stats);
+    CHECK(stats.entries == 0);
+
+    // Halaman < 16 byte di-pad nol sampai panjang minimum Adiantum
+    CHECK(put_page(cache, "kecil", {{{}, xor_with_iv(bytes("a"))}}) == 1);
+    CHECK(chat_cache_save_file(cache, "kecil", file.path.c_str(), kKey.data(), kKey.size()) == CHAT_CACHE_OK);
+    CHECK(read_all(file.path).size() == CHAT_CACHE_FILE_HEADER_BYTES + 16);
+    CHECK(chat_cache_load_file(other, "kecil", file.path.c_str(), kKey.data(), kKey.size()) == 1);
+    CHECK(page_bytes(other, "kecil", &count).size() == CHAT_CACHE_RECORD_HEADER_BYTES + 1);
+
+    CHECK(chat_cache_save_file(cache, "tidak-ada", file.path.c_str(), kKey.data(), kKey.size()) ==
+          CHAT_CACHE_ERROR_NOT_FOUND);
+    CHECK(chat_cache_load_file(other, "x", (file.path + ".hilang").c_str(), kKey.data(), kKey.size()) ==
+          CHAT_CACHE_ERROR_NOT_FOUND);
+    CHECK(chat_cache_save_file(cache, "chat-1", "", kKey.data(), kKey.size()) == CHAT_CACHE_ERROR_INVALID_INPUT);
+    chat_cache_destroy(other);
+    chat_cache_destroy(restored);
+    chat_cache_destroy(cache);
+}
+
+}  // namespace
+
+int main() {
+    test_page_layout();
+    test_lru_eviction();
+    test_file_round_trip();
+    return test_util::result("chat_cache_test");
+}
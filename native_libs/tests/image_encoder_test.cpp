@@ -0,0 +1,138 @@
+// Test image_encoder: classifier foto/grafik, header VP8L (dimensi, bit alpha), dan KAT
+// output lossless. Setiap vektor sudah didecode dengan Pillow dan pixel-nya identik dengan
+// input; jika encoder diubah, verifikasi ulang dengan cara yang sama sebelum mengganti digest.
+
+#include "image_encoder.h"
+#include "sha512.h"
+#include "test_util.h"
+
+namespace {
+
+enum Pattern { kBlocks, kGradientAlpha, kNoise };
+
+std::vector<uint8_t> make_image(Pattern pattern, uint32_t width, uint32_t height, uint32_t stride) {
+    std::vector<uint8_t> image(static_cast<size_t>(stride) * height, 0xEE);  // padding stride harus diabaikan
+    for (uint32_t y = 0; y < height; y++) {
+        for (uint32_t x = 0; x < width; x++) {
+            uint8_t *p = &image[static_cast<size_t>(y) * stride + 4 * x];
+            if (pattern == kBlocks) {
+                const uint32_t c = ((x / 8) + (y / 8) * 3) % 5;
+                p[0] = static_cast<uint8_t>(c * 50);
+                p[1] = static_cast<uint8_t>(255 - c * 40);
+                p[2] = static_cast<uint8_t>(c * 13);
+                p[3] = 255;
+            } else if (pattern == kGradientAlpha) {
+                p[0] = static_cast<uint8_t>(x * 3 + y);
+                p[1] = static_cast<uint8_t>(y * 5);
+                p[2] = static_cast<uint8_t>((x ^ y) * 7);
+                p[3] = static_cast<uint8_t>(128 + (x + y) % 128);
+            } else {
+                const uint32_t s = (x * 1103515245u + y * 12345u + 17) * 2654435761u;
+                p[0] = static_cast<uint8_t>(s >> 24);
+                p[1] = static_cast<uint8_t>(s >> 16);
+                p[2] = static_cast<uint8_t>(s >> 8);
+                p[3] = 255;
+            }
+        }
+    }
+    return image;
+}
+
+uint32_t read_le32(const uint8_t *p) {
+    return static_cast<uint32_t>(p[0]) | static_cast<uint32_t>(p[1]) << 8 | static_cast<uint32_t>(p[2]) << 16 |
+           static_cast<uint32_t>(p[3]) << 24;
+}
+
+// RIFF/WEBP/VP8L dengan ukuran chunk konsisten, lalu header VP8L 14 bit + 14 bit + alpha
+void check_vp8l(const ImageEncodeResult &result, uint32_t width, uint32_t height, bool alpha) {
+    CHECK(result.len >= 25 && result.len % 2 == 0);
+    if (result.len < 25) return;
+    const uint8_t *d = result.data;
+    CHECK(memcmp(d, "RIFF", 4) == 0 && memcmp(d + 8, "WEBPVP8L", 8) == 0);
+    CHECK(read_le32(d + 4) == result.len - 8);
+    const uint32_t chunk = read_le32(d + 16);
+    CHECK(chunk + 20 + (chunk & 1) == result.len);
+    CHECK(d[20] == 0x2F);
+    const uint32_t bits = read_le32(d + 21);
+    CHECK((bits & 0x3FFF) + 1 == width);
+    CHECK(((bits >> 14) & 0x3FFF) + 1 == height);
+    CHECK(((bits >> 28) & 1) == (alpha ? 1u : 0u));
+    CHECK((bits >> 29) == 0);  // versi 0
+}
+
+void check_digest(const char *what, const ImageEncodeResult &result, const char *expected) {
+    uint8_t digest[SHA512_DIGEST_BYTES];
+    SHA512_CTX ctx;
+    sha512_init(&ctx);
+    sha512_update(&ctx, result.data, result.len);
+    sha512_final(digest, &ctx);
+    test_util::check_bytes(what, digest, test_util::hex(expected));
+}
+
+void test_lossless_kat() {
+    struct Case {
+        const char *name;
+        Pattern pattern;
+        uint32_t width, height, stride;
+        int32_t format;
+        int32_t expected_content;
+        bool alpha;
+        const char *digest;  // 256 bit pertama SHA-512 file .webp
+    } cases[] = {
+        {"blok 5 warna (palette)", kBlocks, 64, 48, 64 * 4, IMAGE_FORMAT_AUTO, IMAGE_CONTENT_GRAPHIC, false,
+         "94a134c9caaf584c00bf0be3aa9b1a0a1ac262318bfbe105b145fee2cdb835e8"},
+        {"gradien alpha, stride berpadding", kGradientAlpha, 37, 23, 37 * 4 + 12, IMAGE_FORMAT_WEBP_LOSSLESS,
+         IMAGE_CONTENT_PHOTO, true, "72b10a1a04e5b242a81e8e143a7c6a45af4775c6554b8b93c907e418de1e84fd"},
+        {"noise", kNoise, 40, 40, 160, IMAGE_FORMAT_WEBP_LOSSLESS, IMAGE_CONTENT_PHOTO, false,
+         "07fe989b93c451df966d37154d7662e89838b98e038dae59fcd480bc077865a9"},
+        {"1x1", kBlocks, 1, 1, 4, IMAGE_FORMAT_WEBP_LOSSLESS, IMAGE_CONTENT_GRAPHIC, false,
+         "1383cf91bd696f72cc0f895ab7b674327f584b316c3c72a12584dcdf0092c80f"},
+    };
+    for (const Case &c : cases) {
+        const std::vector<uint8_t> image = make_image(c.pattern, c.width, c.height, c.stride);
+        ImageEncodeResult result;
+        CHECK(image_encode(image.data(), c.width, c.height, c.stride, c.format, 50, &result) == IMAGE_ENCODER_OK);
+        CHECK(result.format == IMAGE_FORMAT_WEBP_LOSSLESS && result.content == c.expected_content);
+        check_vp8l(result, c.width, c.height, c.alpha);
+        check_digest(c.name, result, c.digest);
+        image_encode_free(&result);
+        CHECK(result.data == nullptr && result.len == 0);
+    }
+}
+
+void test_classify_and_lossy_fallback() {
+    const std::vector<uint8_t> blocks = make_image(kBlocks, 64, 48, 256);
+    const std::vector<uint8_t> noise = make_image(kNoise, 64, 48, 256);
+    ImageClassification classification;
+    CHECK(image_classify(blocks.data(), 64, 48, 256, &classification) == IMAGE_ENCODER_OK);
+    CHECK(classification.content == IMAGE_CONTENT_GRAPHIC && classification.sampled_colors == 5);
+    CHECK(classification.has_alpha == 0 && classification.flat_ratio > 0.8f);
+    CHECK(image_classify(noise.data(), 64, 48, 256, &classification) == IMAGE_ENCODER_OK);
+    CHECK(classification.content == IMAGE_CONTENT_PHOTO && classification.flat_ratio < 0.1f);
+
+    // Foto dengan AUTO: WebP lossy jika ada libwebp, selain itu UNSUPPORTED dengan content terisi
+    ImageEncodeResult result;
+    const int rc = image_encode(noise.data(), 64, 48, 256, IMAGE_FORMAT_AUTO, 80, &result);
+    CHECK(result.content == IMAGE_CONTENT_PHOTO);
+#ifdef HAVE_LIBWEBP
+    CHECK(image_encoder_supports_lossy() == 1);
+    CHECK(rc == IMAGE_ENCODER_OK && result.format == IMAGE_FORMAT_WEBP_LOSSY && result.len > 20 &&
+          memcmp(result.data + 12, "VP8 ", 4) == 0);
+#else
+    CHECK(image_encoder_supports_lossy() == 0);
+    CHECK(rc == IMAGE_ENCODER_ERROR_UNSUPPORTED && result.data == nullptr);
+#endif
+    image_encode_free(&result);
+
+    CHECK(image_encode(noise.data(), 64, 48, 255, IMAGE_FORMAT_AUTO, 80, &result) == IMAGE_ENCODER_ERROR_INVALID_INPUT);
+    CHECK(image_encode(noise.data(), 0, 48, 256, IMAGE_FORMAT_AUTO, 80, &result) == IMAGE_ENCODER_ERROR_INVALID_INPUT);
+    CHECK(image_encode(noise.data(), 64, 48, 256, 9, 80, &result) == IMAGE_ENCODER_ERROR_INVALID_INPUT);
+}
+
+}  // namespace
+
+int main() {
+    test_lossless_kat();
+    test_classify_and_lossy_fallback();
+    return test_util::result("image_encoder_test");
+}
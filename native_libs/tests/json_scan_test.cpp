@@ -0,0 +1,103 @@
+// Test json_scan: tape token untuk dokumen valid (termasuk string yang melewati batas blok
+// 64 byte dan escape berderet), penolakan dokumen rusak, find/unescape. Dijalankan untuk
+// classify SIMD dan scalar lewat cpu_features_set_mask.
+
+#include "json_scan.h"
+#include "test_util.h"
+
+#include <string>
+
+namespace {
+
+int32_t parse(const std::string &json, std::vector<JsonToken> &tokens) {
+    tokens.assign(256, JsonToken());
+    return json_scan_parse(json.data(), json.size(), tokens.data(), static_cast<uint32_t>(tokens.size()));
+}
+
+std::string unescaped(const std::string &json, const JsonToken &token) {
+    std::string out(token.len, '\0');
+    const int64_t n = json_scan_unescape(out.empty() ? nullptr : &out[0], json.data(), &token);
+    if (n < 0) return "<invalid>";
+    out.resize(static_cast<size_t>(n));
+    return out;
+}
+
+void test_tape(uint32_t features) {
+    const bool simd = (features & (CPU_FEATURE_SSE2 | CPU_FEATURE_NEON | CPU_FEATURE_SIMD128)) != 0;
+    // SIMD hanya jika backend-nya ikut dikompilasi untuk target ini
+    if (!simd) CHECK(json_scan_impl() == JSON_SCAN_IMPL_SCALAR);
+
+    const std::string json =
+        " {\"event\":\"INSERT\",\"n\":[1,-2.5e3,true,false,null],\"e\":{},\"s\":\"a\\\"b\\\\\\\\\\u00e9\\ud83d\\ude00\"} ";
+    std::vector<JsonToken> tokens;
+    const int32_t count = parse(json, tokens);
+    CHECK(count == 14);
+    if (count != 14) return;
+
+    CHECK(tokens[0].type == JSON_TOKEN_OBJECT && tokens[0].start == 1 && tokens[0].len == json.size() - 2 &&
+          tokens[0].next == 14);
+    CHECK(tokens[1].type == JSON_TOKEN_STRING && json.compare(tokens[1].start, tokens[1].len, "event") == 0);
+    CHECK(tokens[2].type == JSON_TOKEN_STRING && tokens[2].escaped == 0 && tokens[2].next == 3);
+    CHECK(tokens[4].type == JSON_TOKEN_ARRAY && tokens[4].next == 10);
+    CHECK(tokens[5].type == JSON_TOKEN_NUMBER && json.compare(tokens[5].start, tokens[5].len, "1") == 0);
+    CHECK(tokens[6].type == JSON_TOKEN_NUMBER && json.compare(tokens[6].start, tokens[6].len, "-2.5e3") == 0);
+    CHECK(tokens[7].type == JSON_TOKEN_TRUE && tokens[8].type == JSON_TOKEN_FALSE && tokens[9].type == JSON_TOKEN_NULL);
+    CHECK(tokens[11].type == JSON_TOKEN_OBJECT && tokens[11].len == 2 && tokens[11].next == 12);
+    CHECK(tokens[13].type == JSON_TOKEN_STRING && tokens[13].escaped == 1);
+
+    CHECK(json_scan_find(json.data(), tokens.data(), count, 0, "n") == 4);
+    CHECK(json_scan_find(json.data(), tokens.data(), count, 0, "s") == 13);
+    CHECK(json_scan_find(json.data(), tokens.data(), count, 0, "missing") == -1);
+    CHECK(json_scan_find(json.data(), tokens.data(), count, 4, "n") == -1);  // bukan object
+    CHECK(unescaped(json, tokens[13]) == "a\"b\\\\\xC3\xA9\xF0\x9F\x98\x80");
+
+    // Quote ter-escape dan backslash berderet tepat di batas blok 64 byte
+    for (size_t pad = 50; pad < 80; pad++) {
+        const std::string doc = "{\"k\":\"" + std::string(pad, 'x') + "\\\\\\\"}\\\\\",\"z\":[\"]\"]}";
+        const int32_t n = parse(doc, tokens);
+        if (n != 6 || unescaped(doc, tokens[2]) != std::string(pad, 'x') + "\\\"}\\" ||
+            json_scan_find(doc.data(), tokens.data(), n, 0, "z") != 4) {
+            fprintf(stderr, "FAIL batas blok pad=%zu simd=%d\n", pad, simd ? 1 : 0);
+            test_util::failures()++;
+        }
+    }
+}
+
+void test_rejects_malformed() {
+    const char *bad[] = {
+        "",        "{",          "}",           "{\"a\":}",     "{\"a\" 1}",    "{\"a\":1,}", "[1,]",
+        "[1 2]",   "{1:2}",      "\"abc",       "\"a\\x\"",     "tru",          "nulls",     "01",
+        "-",       "1.",         "1e",          "{\"a\":1}x",   "[]]",          "\"\x01\"",  "{\"a\":1}{}",
+    };
+    std::vector<JsonToken> tokens;
+    for (const char *doc : bad) {
+        const int32_t n = parse(doc, tokens);
+        const bool rejected = n == JSON_SCAN_ERROR_MALFORMED || (doc[0] == '\0' && n == JSON_SCAN_ERROR_INVALID_INPUT);
+        if (!rejected) {
+            fprintf(stderr, "FAIL dokumen rusak diterima: '%s' -> %d\n", doc, n);
+            test_util::failures()++;
+        }
+    }
+
+    CHECK(parse(std::string(JSON_SCAN_MAX_DEPTH, '[') + std::string(JSON_SCAN_MAX_DEPTH, ']'), tokens) ==
+          JSON_SCAN_MAX_DEPTH);
+    CHECK(parse(std::string(JSON_SCAN_MAX_DEPTH + 1, '[') + std::string(JSON_SCAN_MAX_DEPTH + 1, ']'), tokens) ==
+          JSON_SCAN_ERROR_TOO_DEEP);
+
+    const std::string many = "[1,2,3,4,5]";
+    JsonToken small[3];
+    CHECK(json_scan_parse(many.data(), many.size(), small, 3) == JSON_SCAN_ERROR_TOO_MANY_TOKENS);
+    CHECK(json_scan_parse(many.data(), many.size(), nullptr, 3) == JSON_SCAN_ERROR_INVALID_INPUT);
+
+    // Surrogate tidak berpasangan sudah ditolak saat parse, bukan baru saat unescape
+    CHECK(parse("\"\\ud83d\"", tokens) == JSON_SCAN_ERROR_MALFORMED);
+    CHECK(parse("\"\\ude00\"", tokens) == JSON_SCAN_ERROR_MALFORMED);
+}
+
+}  // namespace
+
+int main() {
+    test_util::for_each_cpu_mask([](uint32_t features) { test_tape(features); });
+    test_util::for_each_cpu_mask([](uint32_t) { test_rejects_malformed(); });
+    return test_util::result("json_scan_test");
+}
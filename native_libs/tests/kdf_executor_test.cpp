@@ -0,0 +1,171 @@
+// Concurrency test kdf_executor dengan argon2_ctx palsu (lambat dan deterministik):
+// destroy saat banyak thread masih di kdf_executor_wait, dan kdf_executor_release untuk
+// job di antrian, sedang berjalan dan sudah selesai. Paling berguna dijalankan dengan
+// -fsanitize=address atau thread.
+
+#include "argon2.h"
+#include "kdf_executor.h"
+#include "test_util.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace {
+
+// Hash palsu: out[i] = pwd[i % pwdlen] ^ salt[0] ^ i. t_cost = durasi dalam ms.
+// Password diawali '!' mensimulasikan Argon2 gagal.
+int fake_argon2_ctx(argon2_context *ctx) {
+    uint8_t *memory = nullptr;
+    const size_t bytes = static_cast<size_t>(ctx->m_cost) * 1024;
+    if (ctx->allocate_cbk(&memory, bytes) != 0) return -22;
+    memory[0] = 1;
+    std::this_thread::sleep_for(std::chrono::milliseconds(ctx->t_cost));
+    const bool fail = ctx->pwdlen > 0 && ctx->pwd[0] == '!';
+    for (uint32_t i = 0; i < ctx->outlen; i++) {
+        ctx->out[i] = static_cast<uint8_t>((ctx->pwdlen ? ctx->pwd[i % ctx->pwdlen] : 0) ^ ctx->salt[0] ^ i);
+    }
+    memset(memory, 0, bytes);
+    ctx->free_cbk(memory, bytes);
+    return fail ? -1 : 0;
+}
+
+const uint8_t kSalt[16] = {0x5a};
+
+int64_t submit(KdfExecutor *executor, const char *pwd, uint32_t duration_ms, int priority = KDF_PRIORITY_NORMAL) {
+    KdfParams params{duration_ms, 64, 1};
+    return kdf_executor_submit(executor, &params, reinterpret_cast<const uint8_t *>(pwd), strlen(pwd), kSalt,
+                               sizeof(kSalt), 32, priority);
+}
+
+bool expected_hash(const char *pwd, const uint8_t *hash) {
+    const size_t len = strlen(pwd);
+    for (uint32_t i = 0; i < 32; i++) {
+        if (hash[i] != static_cast<uint8_t>(pwd[i % len] ^ kSalt[0] ^ i)) return false;
+    }
+    return true;
+}
+
+void test_submit_and_wait() {
+    KdfExecutor *executor = kdf_executor_create(1 << 20, 2, 0);
+    CHECK(executor != nullptr);
+
+    const int64_t ok = submit(executor, "password", 1);
+    const int64_t failing = submit(executor, "!broken", 1);
+    CHECK(ok > 0 && failing > 0);
+
+    uint8_t hash[32];
+    CHECK(kdf_executor_wait(executor, ok, hash, sizeof(hash), -1) == KDF_OK);
+    CHECK(expected_hash("password", hash));
+    CHECK(kdf_executor_wait(executor, ok, hash, sizeof(hash), 0) == KDF_ERROR_UNKNOWN_JOB);
+    CHECK(kdf_executor_wait(executor, failing, hash, sizeof(hash), -1) == KDF_ERROR_ARGON2);
+
+    KdfExecutorStats stats{};
+    kdf_executor_get_stats(executor, &stats);
+    CHECK(stats.completed == 2);
+    CHECK(stats.memory_reserved == 0);
+    kdf_executor_destroy(executor);
+}
+
+// Destroy sementara thread lain masih menunggu job yang berjalan dan yang di antrian.
+// Sebelumnya executor di-free saat waiter masih bangun dari done_cv (use-after-free).
+void test_destroy_with_waiters() {
+    for (int round = 0; round < 200; round++) {
+        KdfExecutor *executor = kdf_executor_create(1 << 20, 1, 0);
+        std::vector<int64_t> ids;
+        ids.push_back(submit(executor, "running", 1));
+        for (int i = 0; i < 24; i++) ids.push_back(submit(executor, "queued", 1));
+
+        std::atomic<int> started{0};
+        std::atomic<int> finished{0};
+        std::atomic<int> unexpected{0};
+        std::vector<std::thread> waiters;
+        for (size_t i = 0; i < ids.size(); i++) {
+            waiters.emplace_back([&, i] {
+                uint8_t hash[32];
+                started++;
+                const int rc = kdf_executor_wait(executor, ids[i], hash, sizeof(hash), -1);
+                if (rc != KDF_OK && rc != KDF_ERROR_SHUTDOWN) unexpected++;
+                if (rc == KDF_OK && !expected_hash(i == 0 ? "running" : "queued", hash)) unexpected++;
+                finished++;
+            });
+        }
+        while (started.load() < static_cast<int>(waiters.size())) std::this_thread::yield();
+        std::this_thread::sleep_for(std::chrono::milliseconds(round % 3));
+
+        kdf_executor_destroy(executor);
+        for (auto &waiter : waiters) waiter.join();
+        CHECK(finished.load() == static_cast<int>(waiters.size()));
+        CHECK(unexpected.load() == 0);
+    }
+}
+
+void test_release() {
+    KdfExecutor *executor = kdf_executor_create(1 << 20, 1, 0);
+    uint8_t hash[32];
+
+    // Done: hasil dibuang, id tidak dikenal lagi
+    const int64_t done = submit(executor, "done", 1);
+    KdfExecutorStats stats{};
+    do {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        kdf_executor_get_stats(executor, &stats);
+    } while (stats.completed < 1);
+    CHECK(kdf_executor_release(executor, done) == KDF_OK);
+    CHECK(kdf_executor_wait(executor, done, hash, sizeof(hash), 0) == KDF_ERROR_UNKNOWN_JOB);
+    CHECK(kdf_executor_release(executor, done) == KDF_ERROR_UNKNOWN_JOB);
+
+    // Running + queued: job di antrian dibatalkan untuk waiter yang sedang menunggu
+    const int64_t running = submit(executor, "running", 30);
+    const int64_t queued = submit(executor, "queued", 30);
+    const int64_t after = submit(executor, "after", 1);
+    do {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        kdf_executor_get_stats(executor, &stats);
+    } while (stats.running == 0);
+
+    std::atomic<int> queued_rc{1};
+    std::thread waiter([&] {
+        uint8_t out[32];
+        queued_rc = kdf_executor_wait(executor, queued, out, sizeof(out), -1);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    CHECK(kdf_executor_release(executor, queued) == KDF_OK);
+    waiter.join();
+    CHECK(queued_rc.load() == KDF_ERROR_CANCELLED);
+
+    CHECK(kdf_executor_release(executor, running) == KDF_OK);
+    CHECK(kdf_executor_wait(executor, running, hash, sizeof(hash), 0) == KDF_ERROR_UNKNOWN_JOB);
+
+    // Job berikutnya tetap jalan; job yang dibatalkan tidak pernah dieksekusi
+    CHECK(kdf_executor_wait(executor, after, hash, sizeof(hash), 1000) == KDF_OK);
+    CHECK(expected_hash("after", hash));
+    kdf_executor_get_stats(executor, &stats);
+    CHECK(stats.completed == 3);
+    CHECK(stats.queue_depth == 0);
+    CHECK(stats.running == 0);
+    kdf_executor_destroy(executor);
+}
+
+// Job yang tidak pernah diambil ikut dibersihkan destroy (dicek LeakSanitizer)
+void test_destroy_unclaimed() {
+    KdfExecutor *executor = kdf_executor_create(1 << 20, 2, 0);
+    for (int i = 0; i < 8; i++) submit(executor, "unclaimed", 1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    kdf_executor_destroy(executor);
+}
+
+}  // namespace
+
+extern "C" int argon2_ctx(argon2_context *context, argon2_type type) {
+    (void)type;
+    return fake_argon2_ctx(context);
+}
+
+int main() {
+    test_submit_and_wait();
+    test_destroy_with_waiters();
+    test_release();
+    test_destroy_unclaimed();
+    return test_util::result("kdf_executor_test");
+}
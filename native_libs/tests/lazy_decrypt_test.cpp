@@ -0,0 +1,183 @@
+// Test lazy_decrypt: prefetch worker mengirim row yang siap dan row yang gagal lewat
+// SpscRing (tag index | LAZY_DECRYPT_RING_FAILED_TAG), sehingga Dart bisa memakai
+// lazy_decrypt_get tanpa wait dan membangun ulang row saat ring berbunyi. Row juga bisa
+// berupa record message_record.h campuran xor_with_iv dan AEAD.
+
+#include "lazy_decrypt.h"
+#include "message_aead.h"
+#include "message_record.h"
+#include "spsc_ring.h"
+#include "test_util.h"
+
+#include <chrono>
+#include <map>
+#include <thread>
+
+using test_util::bytes;
+
+namespace {
+
+const uint8_t kKey[] = "01234567890123456789012345678901";
+const size_t kKeyLen = 32;
+
+// Formula xor_with_iv EncryptionService (Dart): (key[i % kl] + iv[i % il] + i) % 256
+std::vector<uint8_t> xor_with_iv(const std::vector<uint8_t> &data, const std::vector<uint8_t> &iv) {
+    std::vector<uint8_t> out(data.size());
+    for (size_t i = 0; i < data.size(); i++) {
+        out[i] = static_cast<uint8_t>(data[i] ^ ((kKey[i % kKeyLen] + iv[i % iv.size()] + i) % 256));
+    }
+    return out;
+}
+
+struct Delivered {
+    std::map<uint32_t, std::string> ready;
+    std::vector<uint32_t> failed;
+};
+
+// Baca semua record yang sudah dipublikasikan sampai [expected] row terkirim
+Delivered drain(SpscRing *ring, size_t expected) {
+    Delivered delivered;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (delivered.ready.size() + delivered.failed.size() < expected &&
+           std::chrono::steady_clock::now() < deadline) {
+        uint32_t offset = 0;
+        const uint32_t region = spsc_ring_acquire(ring, &offset);
+        if (region == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+        const uint8_t *data = spsc_ring_data(ring) + offset;
+        uint32_t consumed = 0;
+        while (consumed < region) {
+            uint32_t len = 0, tag = 0;
+            memcpy(&len, data + consumed, 4);
+            memcpy(&tag, data + consumed + 4, 4);
+            if (len == SPSC_RING_WRAP) {
+                consumed = region;
+                break;
+            }
+            if (tag & LAZY_DECRYPT_RING_FAILED_TAG) {
+                CHECK(len == 0);
+                delivered.failed.push_back(tag & ~LAZY_DECRYPT_RING_FAILED_TAG);
+            } else {
+                const char *payload = reinterpret_cast<const char *>(data + consumed + SPSC_RING_RECORD_HEADER_BYTES);
+                delivered.ready[tag] = std::string(payload, len);
+            }
+            consumed += SPSC_RING_RECORD_HEADER_BYTES + ((len + 7u) & ~7u);
+        }
+        spsc_ring_release(ring, consumed);
+    }
+    return delivered;
+}
+
+void test_ring_delivers_ready_and_failed_rows() {
+    LazyDecryptSession *session = lazy_decrypt_create(kKey, kKeyLen, 1, 16, 0);
+    SpscRing *ring = spsc_ring_create(0, 0);
+    CHECK(session != nullptr && ring != nullptr);
+    if (!session || !ring) return;
+    CHECK(lazy_decrypt_attach_ring(session, ring) == LAZY_DECRYPT_READY);
+
+    const std::vector<uint8_t> iv = {9, 8, 7, 6, 5, 4, 3, 2, 1, 0, 1, 2, 3, 4, 5, 6};
+    const char *texts[] = {"halo", "apa kabar?", nullptr, "pesan terakhir"};
+    for (const char *text : texts) {
+        // nullptr: plaintext bukan UTF-8 valid, decrypt gagal
+        const std::vector<uint8_t> plain = text ? bytes(text) : std::vector<uint8_t>{0xff, 0xfe, 0x41};
+        const std::vector<uint8_t> ct = xor_with_iv(plain, iv);
+        CHECK(lazy_decrypt_register(session, ct.data(), ct.size(), iv.data(), iv.size()) >= 0);
+    }
+
+    // Tanpa wait row yang belum disentuh worker masih PENDING
+    uint8_t out[64];
+    size_t outlen = 0;
+    CHECK(lazy_decrypt_get(session, 3, out, sizeof(out), &outlen, 0) != LAZY_DECRYPT_ERROR_INVALID_INPUT);
+
+    CHECK(lazy_decrypt_request_range(session, 0, 3) == LAZY_DECRYPT_READY);
+    const Delivered delivered = drain(ring, 4);
+    CHECK(delivered.ready.size() == 3);
+    CHECK(delivered.failed.size() == 1 && delivered.failed[0] == 2);
+    CHECK(delivered.ready.count(0) && delivered.ready.at(0) == "halo");
+    CHECK(delivered.ready.count(3) && delivered.ready.at(3) == "pesan terakhir");
+
+    // Setelah ring berbunyi, get tanpa wait langsung final
+    CHECK(lazy_decrypt_get(session, 1, out, sizeof(out), &outlen, 0) == LAZY_DECRYPT_READY);
+    CHECK(outlen == 10 && memcmp(out, "apa kabar?", 10) == 0);
+    CHECK(lazy_decrypt_get(session, 2, out, sizeof(out), &outlen, 0) == LAZY_DECRYPT_ERROR_DECRYPT);
+
+    lazy_decrypt_destroy(session);
+    spsc_ring_destroy(ring);
+}
+
+void append_record(std::vector<uint8_t> &buffer, uint8_t algorithm, const std::vector<uint8_t> &nonce,
+                   const std::vector<uint8_t> &ciphertext) {
+    MessageRecordHeader header;
+    memset(&header, 0, sizeof(header));
+    header.algorithm = algorithm;
+    header.nonce_len = static_cast<uint8_t>(nonce.size());
+    memcpy(header.nonce, nonce.data(), nonce.size());
+    header.created_at_us = 1714557600000000LL + static_cast<int64_t>(buffer.size());
+
+    const uint32_t size = message_record_size(0, 0, 0, static_cast<uint32_t>(ciphertext.size()));
+    const size_t offset = buffer.size();
+    buffer.resize(offset + size);
+    CHECK(message_record_write(buffer.data() + offset, size, &header, nullptr, 0, nullptr, 0, ciphertext.data(),
+                               static_cast<uint32_t>(ciphertext.size())) == size);
+}
+
+std::vector<uint8_t> aead_seal(const std::vector<uint8_t> &aead_key, const std::vector<uint8_t> &nonce,
+                               const char *text) {
+    const std::vector<uint8_t> plain = bytes(text);
+    std::vector<uint8_t> sealed(plain.size() + MESSAGE_AEAD_TAG_BYTES);
+    CHECK(message_aead_seal(MESSAGE_AEAD_CHACHA20_POLY1305, sealed.data(), sealed.data() + plain.size(), plain.data(),
+                            plain.size(), nullptr, 0, aead_key.data(), nonce.data(), nonce.size()) == MESSAGE_AEAD_OK);
+    return sealed;
+}
+
+// Record xor_with_iv dan ChaCha20-Poly1305 dalam satu buffer; satu tag AEAD dirusak
+void test_records_mixed_algorithms() {
+    const std::vector<uint8_t> aead_key(MESSAGE_AEAD_KEY_BYTES, 0x42);
+    const std::vector<uint8_t> iv = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16};
+    const std::vector<uint8_t> nonce(message_aead_nonce_bytes(MESSAGE_AEAD_CHACHA20_POLY1305), 0x24);
+
+    std::vector<uint8_t> buffer;
+    append_record(buffer, MESSAGE_RECORD_ALG_XOR_WITH_IV, iv, xor_with_iv(bytes("pesan lama"), iv));
+    append_record(buffer, MESSAGE_AEAD_CHACHA20_POLY1305, nonce, aead_seal(aead_key, nonce, "pesan aead"));
+    std::vector<uint8_t> tampered = aead_seal(aead_key, nonce, "dirusak");
+    tampered.back() ^= 1;
+    append_record(buffer, MESSAGE_AEAD_CHACHA20_POLY1305, nonce, tampered);
+
+    LazyDecryptSession *session = lazy_decrypt_create(kKey, kKeyLen, 1, 16, 0);
+    CHECK(session != nullptr);
+    if (!session) return;
+    CHECK(lazy_decrypt_set_aead_key(session, aead_key.data(), aead_key.size()) == LAZY_DECRYPT_READY);
+
+    // Satu row xor biasa dulu: index record harus melanjutkan
+    const std::vector<uint8_t> plain = bytes("row biasa");
+    const std::vector<uint8_t> ct = xor_with_iv(plain, iv);
+    CHECK(lazy_decrypt_register(session, ct.data(), ct.size(), iv.data(), iv.size()) == 0);
+    CHECK(lazy_decrypt_register_records(session, buffer.data(), buffer.size()) == 1);
+    // Key AEAD tidak boleh diganti setelah ada row
+    CHECK(lazy_decrypt_set_aead_key(session, aead_key.data(), aead_key.size()) == LAZY_DECRYPT_ERROR_INVALID_INPUT);
+    // Buffer rusak ditolak utuh
+    CHECK(lazy_decrypt_register_records(session, buffer.data(), buffer.size() - 1) == LAZY_DECRYPT_ERROR_INVALID_INPUT);
+
+    uint8_t out[64];
+    size_t outlen = 0;
+    CHECK(lazy_decrypt_get(session, 1, out, sizeof(out), &outlen, 1) == LAZY_DECRYPT_READY);
+    CHECK(outlen == 10 && memcmp(out, "pesan lama", 10) == 0);
+    CHECK(lazy_decrypt_get(session, 2, out, sizeof(out), &outlen, 1) == LAZY_DECRYPT_READY);
+    CHECK(outlen == 10 && memcmp(out, "pesan aead", 10) == 0);
+    CHECK(lazy_decrypt_get(session, 3, out, sizeof(out), &outlen, 1) == LAZY_DECRYPT_ERROR_DECRYPT);
+
+    LazyDecryptStats stats;
+    lazy_decrypt_get_stats(session, &stats);
+    CHECK(stats.rows == 4);
+    lazy_decrypt_destroy(session);
+}
+
+}  // namespace
+
+int main() {
+    test_ring_delivers_ready_and_failed_rows();
+    test_records_mixed_algorithms();
+    return test_util::result("lazy_decrypt_test");
+}
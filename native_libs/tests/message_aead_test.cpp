@@ -0,0 +1,92 @@
+// Test message_aead: subkey per algoritma (HMAC-SHA512 dengan label berbeda) dan
+// kesetaraan seal/open dengan primitive yang dipanggil memakai subkey tersebut.
+// Nilai subkey dihitung dengan hmac/hashlib Python untuk key 00..1F.
+
+#include "aes_gcm.h"
+#include "ascon.h"
+#include "chacha20_poly1305.h"
+#include "message_aead.h"
+#include "test_util.h"
+
+using test_util::bytes;
+using test_util::check_bytes;
+using test_util::hex;
+
+namespace {
+
+std::vector<uint8_t> sequential_key() {
+    std::vector<uint8_t> key(MESSAGE_AEAD_KEY_BYTES);
+    for (size_t i = 0; i < key.size(); i++) key[i] = static_cast<uint8_t>(i);
+    return key;
+}
+
+void test_subkey_kat() {
+    const std::vector<uint8_t> key = sequential_key();
+    struct {
+        int algorithm;
+        const char *subkey;
+    } const vectors[] = {
+        {MESSAGE_AEAD_CHACHA20_POLY1305, "a0a10afff1a13659e80e9944f6a4677306c70f82f537fb25c24894400f884234"},
+        {MESSAGE_AEAD_ASCON128A, "a0fb5a7d7e2268cab8ba05df9721f9c18875ca7a30d7e60f96e05ba98a2be3fa"},
+        {MESSAGE_AEAD_AES256_GCM, "a43a2f3a649a09ab7016f25364b6059ad2f7aafbb4869c9bdb5792cf1b25030d"},
+    };
+    for (const auto &v : vectors) {
+        uint8_t subkey[MESSAGE_AEAD_KEY_BYTES];
+        CHECK(message_aead_derive_key(v.algorithm, key.data(), subkey) == MESSAGE_AEAD_OK);
+        check_bytes("subkey", subkey, hex(v.subkey));
+    }
+
+    uint8_t subkey[MESSAGE_AEAD_KEY_BYTES];
+    CHECK(message_aead_derive_key(99, key.data(), subkey) == MESSAGE_AEAD_ERROR_UNKNOWN_ALGORITHM);
+}
+
+// seal memakai subkey, bukan key pesan: hasilnya sama dengan primitive + subkey dan
+// berbeda dengan primitive + key mentah
+void test_seal_uses_subkey() {
+    const std::vector<uint8_t> key = sequential_key();
+    const std::vector<uint8_t> plain = bytes("satu key, tiga cipher");
+    const std::vector<uint8_t> nonce(MESSAGE_AEAD_MAX_NONCE_BYTES, 0x5a);
+
+    for (int algorithm : {MESSAGE_AEAD_CHACHA20_POLY1305, MESSAGE_AEAD_ASCON128A, MESSAGE_AEAD_AES256_GCM}) {
+        const size_t nonce_len = message_aead_nonce_bytes(algorithm);
+        uint8_t subkey[MESSAGE_AEAD_KEY_BYTES];
+        message_aead_derive_key(algorithm, key.data(), subkey);
+
+        std::vector<uint8_t> sealed(plain.size()), expected(plain.size()), raw(plain.size());
+        uint8_t tag[MESSAGE_AEAD_TAG_BYTES], expected_tag[MESSAGE_AEAD_TAG_BYTES], raw_tag[MESSAGE_AEAD_TAG_BYTES];
+        CHECK(message_aead_seal(algorithm, sealed.data(), tag, plain.data(), plain.size(), nullptr, 0, key.data(),
+                                nonce.data(), nonce_len) == MESSAGE_AEAD_OK);
+        if (algorithm == MESSAGE_AEAD_CHACHA20_POLY1305) {
+            chacha20_poly1305_encrypt(expected.data(), expected_tag, plain.data(), plain.size(), nullptr, 0, subkey,
+                                      nonce.data());
+            chacha20_poly1305_encrypt(raw.data(), raw_tag, plain.data(), plain.size(), nullptr, 0, key.data(),
+                                      nonce.data());
+        } else if (algorithm == MESSAGE_AEAD_ASCON128A) {
+            ascon128a_encrypt(expected.data(), expected_tag, plain.data(), plain.size(), nullptr, 0, subkey,
+                              nonce.data());
+            ascon128a_encrypt(raw.data(), raw_tag, plain.data(), plain.size(), nullptr, 0, key.data(), nonce.data());
+        } else {
+            aes256_gcm_encrypt(expected.data(), expected_tag, plain.data(), plain.size(), nullptr, 0, subkey,
+                               nonce.data());
+            aes256_gcm_encrypt(raw.data(), raw_tag, plain.data(), plain.size(), nullptr, 0, key.data(), nonce.data());
+        }
+        CHECK(sealed == expected && memcmp(tag, expected_tag, sizeof(tag)) == 0);
+        CHECK(memcmp(tag, raw_tag, sizeof(tag)) != 0);
+
+        std::vector<uint8_t> opened(plain.size());
+        CHECK(message_aead_open(algorithm, opened.data(), sealed.data(), sealed.size(), tag, nullptr, 0, key.data(),
+                                nonce.data(), nonce_len) == MESSAGE_AEAD_OK);
+        CHECK(opened == plain);
+        tag[0] ^= 1;
+        CHECK(message_aead_open(algorithm, opened.data(), sealed.data(), sealed.size(), tag, nullptr, 0, key.data(),
+                                nonce.data(), nonce_len) == MESSAGE_AEAD_ERROR_AUTH_FAILED);
+    }
+}
+
+}  // namespace
+
+int main() {
+    test_subkey_kat();
+    test_seal_uses_subkey();
+    return test_util::result("message_aead_test");
+}
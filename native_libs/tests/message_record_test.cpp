@@ -0,0 +1,202 @@
+// Test message_record: write/index round-trip (id/sender UUID dan teks), penolakan buffer
+// rusak dari disk/IPC, dan decrypt_all untuk record campuran xor_with_iv dan AEAD.
+
+#include "message_aead.h"
+#include "message_record.h"
+#include "test_util.h"
+
+using test_util::bytes;
+
+namespace {
+
+MessageRecordHeader make_header(uint8_t algorithm, uint8_t nonce_len, uint8_t flags) {
+    MessageRecordHeader header;
+    memset(&header, 0, sizeof(header));
+    header.algorithm = algorithm;
+    header.nonce_len = nonce_len;
+    header.flags = flags;
+    header.created_at_us = 1714557600123456LL;
+    for (uint8_t i = 0; i < MESSAGE_RECORD_UUID_BYTES; i++) {
+        header.id[i] = i;
+        header.sender[i] = static_cast<uint8_t>(0xA0 + i);
+    }
+    for (uint8_t i = 0; i < nonce_len; i++) header.nonce[i] = static_cast<uint8_t>(0x10 + i);
+    return header;
+}
+
+void append(std::vector<uint8_t> &buffer, const MessageRecordHeader &header, const char *id, const char *sender,
+            const std::vector<uint8_t> &ciphertext) {
+    const uint32_t id_len = id ? static_cast<uint32_t>(strlen(id)) : 0;
+    const uint32_t sender_len = sender ? static_cast<uint32_t>(strlen(sender)) : 0;
+    const uint32_t size =
+        message_record_size(header.flags, id_len, sender_len, static_cast<uint32_t>(ciphertext.size()));
+    const size_t offset = buffer.size();
+    buffer.resize(offset + size);
+    CHECK(message_record_write(buffer.data() + offset, size, &header, reinterpret_cast<const uint8_t *>(id), id_len,
+                               reinterpret_cast<const uint8_t *>(sender), sender_len, ciphertext.data(),
+                               static_cast<uint32_t>(ciphertext.size())) == size);
+}
+
+void test_round_trip() {
+    std::vector<uint8_t> buffer;
+    const std::vector<uint8_t> ct1 = bytes("ciphertext pertama");
+    std::vector<uint8_t> ct2(300, 0x7E);  // varint panjang 2 byte
+    append(buffer, make_header(MESSAGE_RECORD_ALG_XOR_WITH_IV, 16, 0), nullptr, nullptr, ct1);
+    append(buffer, make_header(MESSAGE_AEAD_CHACHA20_POLY1305, 12,
+                               MESSAGE_RECORD_FLAG_TEXT_ID | MESSAGE_RECORD_FLAG_TEXT_SENDER),
+           "42", "user-bukan-uuid", ct2);
+    CHECK(buffer.size() % MESSAGE_RECORD_ALIGN == 0);
+    // 80 + varint(18) + 18 = 99 -> 104
+    CHECK(message_record_size(0, 0, 0, 18) == 104);
+
+    CHECK(message_record_index(buffer.data(), buffer.size(), nullptr, 0) == 2);
+    MessageRecordView views[2];
+    CHECK(message_record_index(buffer.data(), buffer.size(), views, 2) == 2);
+
+    const MessageRecordHeader *h0 = views[0].header;
+    CHECK(h0->magic == MESSAGE_RECORD_MAGIC && h0->version == MESSAGE_RECORD_VERSION);
+    CHECK(h0->record_len == 104 && h0->algorithm == MESSAGE_RECORD_ALG_XOR_WITH_IV && h0->nonce_len == 16);
+    CHECK(h0->created_at_us == 1714557600123456LL && h0->id[15] == 15 && h0->sender[0] == 0xA0);
+    CHECK(h0->nonce[15] == 0x1F && h0->nonce[16] == 0);
+    CHECK(views[0].id_text == nullptr && views[0].sender_text == nullptr);
+    CHECK(views[0].ciphertext_len == ct1.size() && memcmp(views[0].ciphertext, ct1.data(), ct1.size()) == 0);
+
+    // Field UUID dinolkan jika id/sender disimpan sebagai teks
+    const MessageRecordHeader *h1 = views[1].header;
+    CHECK(h1->id[15] == 0 && h1->sender[0] == 0 && h1->nonce[12] == 0);
+    CHECK(views[1].id_text_len == 2 && memcmp(views[1].id_text, "42", 2) == 0);
+    CHECK(views[1].sender_text_len == 15 && memcmp(views[1].sender_text, "user-bukan-uuid", 15) == 0);
+    CHECK(views[1].ciphertext_len == 300 && views[1].ciphertext[299] == 0x7E);
+
+    CHECK(message_record_index(buffer.data(), 0, nullptr, 0) == 0);
+    // Capacity kurang dan flag tidak dikenal ditolak saat write
+    MessageRecordHeader bad = make_header(0, 16, 0x80);
+    uint8_t out[256];
+    CHECK(message_record_write(out, sizeof(out), &bad, nullptr, 0, nullptr, 0, ct1.data(), 18) == 0);
+    MessageRecordHeader ok = make_header(0, 16, 0);
+    CHECK(message_record_write(out, 100, &ok, nullptr, 0, nullptr, 0, ct1.data(), 18) == 0);
+}
+
+void test_rejects_malformed() {
+    std::vector<uint8_t> good;
+    append(good, make_header(MESSAGE_RECORD_ALG_XOR_WITH_IV, 16, MESSAGE_RECORD_FLAG_TEXT_ID), "id-1", nullptr,
+           bytes("isi"));
+    CHECK(message_record_index(good.data(), good.size(), nullptr, 0) == 1);
+
+    auto expect_malformed = [&](const char *what, std::vector<uint8_t> buffer) {
+        if (message_record_index(buffer.data(), buffer.size(), nullptr, 0) != MESSAGE_RECORD_ERROR_MALFORMED) {
+            fprintf(stderr, "FAIL malformed buffer diterima: %s\n", what);
+            test_util::failures()++;
+        }
+    };
+    auto with_header = [&](void (*edit)(MessageRecordHeader &)) {
+        std::vector<uint8_t> buffer = good;
+        MessageRecordHeader h;
+        memcpy(&h, buffer.data(), sizeof(h));
+        edit(h);
+        memcpy(buffer.data(), &h, sizeof(h));
+        return buffer;
+    };
+
+    expect_malformed("magic", with_header([](MessageRecordHeader &h) { h.magic ^= 1; }));
+    expect_malformed("version", with_header([](MessageRecordHeader &h) { h.version = 2; }));
+    expect_malformed("record_len tidak rata 8", with_header([](MessageRecordHeader &h) { h.record_len -= 1; }));
+    expect_malformed("record_len melewati buffer", with_header([](MessageRecordHeader &h) { h.record_len += 8; }));
+    expect_malformed("record_len di bawah header", with_header([](MessageRecordHeader &h) { h.record_len = 72; }));
+    expect_malformed("nonce_len", with_header([](MessageRecordHeader &h) { h.nonce_len = 25; }));
+    expect_malformed("flag tidak dikenal", with_header([](MessageRecordHeader &h) { h.flags |= 0x04; }));
+    expect_malformed("terpotong", std::vector<uint8_t>(good.begin(), good.end() - 8));
+    expect_malformed("header terpotong", std::vector<uint8_t>(good.begin(), good.begin() + 40));
+
+    // Panjang id melewati akhir record
+    std::vector<uint8_t> long_field = good;
+    long_field[MESSAGE_RECORD_HEADER_BYTES] = 0x7F;
+    expect_malformed("panjang field", long_field);
+    // Varint 6 byte
+    std::vector<uint8_t> varint = good;
+    memset(varint.data() + MESSAGE_RECORD_HEADER_BYTES, 0x80, 5);
+    varint[MESSAGE_RECORD_HEADER_BYTES + 5] = 0x01;
+    expect_malformed("varint terlalu panjang", varint);
+    // Padding 8 byte ekstra: record_len tidak lagi pas dengan isi
+    std::vector<uint8_t> padded = with_header([](MessageRecordHeader &h) { h.record_len += 8; });
+    padded.resize(padded.size() + 8, 0);
+    expect_malformed("padding berlebih", padded);
+    // Record valid diikuti sampah
+    std::vector<uint8_t> trailing = good;
+    trailing.resize(trailing.size() + 8, 0xAB);
+    expect_malformed("sampah setelah record", trailing);
+}
+
+// Formula xor_with_iv EncryptionService (Dart): (key[i % kl] + iv[i % il] + i) % 256
+std::vector<uint8_t> xor_with_iv(const std::vector<uint8_t> &data, const std::vector<uint8_t> &key,
+                                 const uint8_t *iv, size_t iv_len) {
+    std::vector<uint8_t> out(data.size());
+    for (size_t i = 0; i < data.size(); i++) {
+        out[i] = static_cast<uint8_t>(data[i] ^ ((key[i % key.size()] + iv[i % iv_len] + i) % 256));
+    }
+    return out;
+}
+
+std::vector<uint8_t> seal(int algorithm, const std::vector<uint8_t> &key, const MessageRecordHeader &header,
+                          const char *text) {
+    const std::vector<uint8_t> plain = bytes(text);
+    std::vector<uint8_t> sealed(plain.size() + MESSAGE_AEAD_TAG_BYTES);
+    CHECK(message_aead_seal(algorithm, sealed.data(), sealed.data() + plain.size(), plain.data(), plain.size(), nullptr,
+                            0, key.data(), header.nonce, header.nonce_len) == MESSAGE_AEAD_OK);
+    return sealed;
+}
+
+void test_decrypt_all_mixed() {
+    const std::vector<uint8_t> chat_key = bytes("kunci chat lama base64-decoded!!");
+    const std::vector<uint8_t> aead_key(MESSAGE_AEAD_KEY_BYTES, 0x33);
+
+    std::vector<uint8_t> buffer;
+    const MessageRecordHeader xor_header = make_header(MESSAGE_RECORD_ALG_XOR_WITH_IV, 16, 0);
+    append(buffer, xor_header, nullptr, nullptr, xor_with_iv(bytes("halo lama"), chat_key, xor_header.nonce, 16));
+    const int algorithms[] = {MESSAGE_AEAD_CHACHA20_POLY1305, MESSAGE_AEAD_ASCON128A, MESSAGE_AEAD_AES256_GCM};
+    const char *texts[] = {"halo chacha", "halo ascon", "halo gcm"};
+    for (int i = 0; i < 3; i++) {
+        const MessageRecordHeader h =
+            make_header(static_cast<uint8_t>(algorithms[i]), static_cast<uint8_t>(message_aead_nonce_bytes(algorithms[i])), 0);
+        append(buffer, h, nullptr, nullptr, seal(algorithms[i], aead_key, h, texts[i]));
+    }
+    // ChaCha20 dengan tag rusak dan algoritma tidak dikenal
+    const MessageRecordHeader tampered_header = make_header(MESSAGE_AEAD_CHACHA20_POLY1305, 12, 0);
+    std::vector<uint8_t> tampered = seal(MESSAGE_AEAD_CHACHA20_POLY1305, aead_key, tampered_header, "rusak");
+    tampered.back() ^= 1;
+    append(buffer, tampered_header, nullptr, nullptr, tampered);
+    append(buffer, make_header(77, 12, 0), nullptr, nullptr, std::vector<uint8_t>(20, 1));
+
+    const uint32_t count = 6;
+    std::vector<uint8_t> out(256);
+    MessageRecordPlain plains[count];
+    CHECK(message_record_decrypt_all(buffer.data(), buffer.size(), chat_key.data(), chat_key.size(), aead_key.data(),
+                                     out.data(), out.size(), plains, count) == 4);
+    CHECK(plains[0].status == MESSAGE_RECORD_OK && plains[0].text_len == 9 &&
+          memcmp(plains[0].text, "halo lama", 9) == 0);
+    for (int i = 0; i < 3; i++) {
+        const size_t len = strlen(texts[i]);
+        CHECK(plains[i + 1].status == MESSAGE_RECORD_OK && plains[i + 1].text_len == len &&
+              memcmp(plains[i + 1].text, texts[i], len) == 0);
+    }
+    CHECK(plains[4].status == MESSAGE_RECORD_ERROR_AUTH_FAILED && plains[4].text_len == 0);
+    CHECK(plains[5].status == MESSAGE_RECORD_ERROR_INVALID_INPUT && plains[5].text == nullptr);
+
+    // Jumlah record harus cocok dan output harus cukup
+    CHECK(message_record_decrypt_all(buffer.data(), buffer.size(), chat_key.data(), chat_key.size(), aead_key.data(),
+                                     out.data(), out.size(), plains, count - 1) == MESSAGE_RECORD_ERROR_INVALID_INPUT);
+    CHECK(message_record_decrypt_all(buffer.data(), buffer.size(), chat_key.data(), chat_key.size(), aead_key.data(),
+                                     out.data(), 12, plains, count) == MESSAGE_RECORD_ERROR_BUFFER_TOO_SMALL);
+    // Tanpa aead_key record AEAD tidak didecrypt, xor tetap jalan
+    CHECK(message_record_decrypt_all(buffer.data(), buffer.size(), chat_key.data(), chat_key.size(), nullptr,
+                                     out.data(), out.size(), plains, count) == 1);
+}
+
+}  // namespace
+
+int main() {
+    test_round_trip();
+    test_rejects_malformed();
+    test_decrypt_all_mixed();
+    return test_util::result("message_record_test");
+}
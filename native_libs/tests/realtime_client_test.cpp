@@ -0,0 +1,193 @@
+// Test realtime_client lewat transport eksternal: frame join keluar di ring, phx_reply
+// menghasilkan state JOINED, dan frame postgres_changes/INSERT (xor_with_iv lama dan AEAD)
+// menjadi pesan terdecrypt. Frame rusak, topic lain dan baris tidak valid tidak boleh
+// menghentikan client.
+
+#include "base64.h"
+#include "json_scan.h"
+#include "message_aead.h"
+#include "message_record.h"
+#include "realtime_client.h"
+#include "spsc_ring.h"
+#include "test_util.h"
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+using test_util::bytes;
+
+namespace {
+
+struct RingRecord {
+    uint32_t tag;
+    std::vector<uint8_t> payload;
+};
+
+// Baca record berikutnya; polling cukup untuk test (doorbell diuji di spsc_ring_test)
+bool next_record(SpscRing *ring, RingRecord &out) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    const uint8_t *data = spsc_ring_data(ring);
+    while (std::chrono::steady_clock::now() < deadline) {
+        uint32_t offset = 0;
+        if (spsc_ring_acquire(ring, &offset) == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+        uint32_t len = 0;
+        memcpy(&len, data + offset, 4);
+        const uint32_t padded = (SPSC_RING_RECORD_HEADER_BYTES + (len == SPSC_RING_WRAP ? 0 : len) + 7) & ~7u;
+        if (len == SPSC_RING_WRAP) {
+            spsc_ring_release(ring, spsc_ring_capacity(ring) - offset);
+            continue;
+        }
+        memcpy(&out.tag, data + offset + 4, 4);
+        out.payload.assign(data + offset + SPSC_RING_RECORD_HEADER_BYTES,
+                           data + offset + SPSC_RING_RECORD_HEADER_BYTES + len);
+        spsc_ring_release(ring, padded);
+        return true;
+    }
+    return false;
+}
+
+std::string base64(const std::vector<uint8_t> &data) {
+    std::string out(base64_encoded_length(data.size()), '\0');
+    out.resize(base64_encode(&out[0], data.data(), data.size()));
+    return out;
+}
+
+std::string insert_frame(const std::string &topic, const std::string &id, const std::string &algorithm,
+                         const std::vector<uint8_t> &ciphertext, const std::vector<uint8_t> &iv) {
+    std::string record = "{\"id\":" + id + ",\"sender_id\":\"5f0c1c8e-0000-4000-8000-000000000001\"," +
+                         "\"created_at\":\"2024-05-01T10:00:00.123456+00:00\",\"encrypted_message\":\"" +
+                         base64(ciphertext) + "\",\"iv\":\"" + base64(iv) + "\"";
+    if (!algorithm.empty()) record += ",\"algorithm\":\"" + algorithm + "\"";
+    record += "}";
+    return "{\"topic\":\"" + topic + "\",\"event\":\"postgres_changes\",\"payload\":{\"data\":{\"type\":\"INSERT\"," +
+           "\"schema\":\"public\",\"table\":\"messages\",\"record\":" + record + "}},\"ref\":null}";
+}
+
+void feed(RealtimeClient *client, const std::string &frame) {
+    CHECK(realtime_client_feed(client, reinterpret_cast<const uint8_t *>(frame.data()), frame.size()) == REALTIME_OK);
+}
+
+struct Message {
+    RealtimeMessageHeader header;
+    std::string id, sender, text;
+};
+
+bool read_message(SpscRing *ring, Message &out) {
+    RingRecord record;
+    while (next_record(ring, record)) {
+        if (record.tag != REALTIME_TAG_MESSAGE) continue;  // heartbeat keluar diabaikan
+        if (record.payload.size() < sizeof(RealtimeMessageHeader)) return false;
+        memcpy(&out.header, record.payload.data(), sizeof(out.header));
+        const char *p = reinterpret_cast<const char *>(record.payload.data()) + sizeof(out.header);
+        out.id.assign(p, out.header.id_len);
+        out.sender.assign(p + out.header.id_len, out.header.sender_len);
+        out.text.assign(p + out.header.id_len + out.header.sender_len, out.header.text_len);
+        return true;
+    }
+    return false;
+}
+
+void test_external_transport() {
+    const std::string topic = "realtime:chat-7";
+    const std::vector<uint8_t> chat_key = bytes("kunci-chat-lama");
+    const std::vector<uint8_t> aead_key(MESSAGE_AEAD_KEY_BYTES, 0x5A);
+
+    SpscRing *ring = spsc_ring_create(64 * 1024, 1);
+    RealtimeClientConfig config;
+    memset(&config, 0, sizeof(config));
+    config.topic = topic.c_str();
+    config.filter = "chat_id=eq.7";
+    config.access_token = "jwt\"token";
+    config.chat_key = chat_key.data();
+    config.chat_key_len = chat_key.size();
+    config.aead_key = aead_key.data();
+    RealtimeClient *client = realtime_client_create(&config, ring);
+    CHECK(client != nullptr);
+    if (!client) return;
+    CHECK(realtime_client_feed(client, reinterpret_cast<const uint8_t *>("{}"), 2) == REALTIME_ERROR_STATE);
+    CHECK(realtime_client_start_external(client) == REALTIME_OK);
+    CHECK(realtime_client_start_external(client) == REALTIME_ERROR_STATE);
+
+    // Frame join: JSON valid dengan filter dan access_token ter-escape
+    RingRecord join;
+    CHECK(next_record(ring, join) && join.tag == REALTIME_TAG_OUTBOUND);
+    const std::string join_text(join.payload.begin(), join.payload.end());
+    std::vector<JsonToken> tokens(128);
+    const int32_t count = json_scan_parse(join_text.data(), join_text.size(), tokens.data(), 128);
+    CHECK(count > 0);
+    if (count <= 0) {
+        realtime_client_destroy(client);
+        spsc_ring_destroy(ring);
+        return;
+    }
+    const int32_t ref = json_scan_find(join_text.data(), tokens.data(), count, 0, "ref");
+    const int32_t event = json_scan_find(join_text.data(), tokens.data(), count, 0, "event");
+    CHECK(ref > 0 && event > 0 && join_text.compare(tokens[event].start, tokens[event].len, "phx_join") == 0);
+    CHECK(join_text.find("\"filter\":\"chat_id=eq.7\"") != std::string::npos);
+    CHECK(join_text.find("\"access_token\":\"jwt\\\"token\"") != std::string::npos);
+    const std::string join_ref = join_text.substr(tokens[ref].start, tokens[ref].len);
+
+    feed(client, "{\"topic\":\"" + topic + "\",\"event\":\"phx_reply\",\"payload\":{\"status\":\"ok\",\"response\":{}},"
+                 "\"ref\":\"" + join_ref + "\"}");
+    RingRecord state;
+    int32_t state_code = 0;
+    CHECK(next_record(ring, state) && state.tag == REALTIME_TAG_STATE && state.payload.size() >= 4);
+    if (state.payload.size() >= 4) memcpy(&state_code, state.payload.data(), 4);
+    CHECK(state_code == REALTIME_STATE_JOINED);
+
+    // xor_with_iv lama: (key[i % kl] + iv[i % il] + i) % 256
+    const std::vector<uint8_t> iv(16, 0x21);
+    std::vector<uint8_t> xor_ct = bytes("halo dari realtime");
+    for (size_t i = 0; i < xor_ct.size(); i++) {
+        xor_ct[i] ^= static_cast<uint8_t>((chat_key[i % chat_key.size()] + iv[i % iv.size()] + i) % 256);
+    }
+    const std::vector<uint8_t> nonce(12, 0x42);
+    const std::vector<uint8_t> plain = bytes("halo aead");
+    std::vector<uint8_t> aead_ct(plain.size() + MESSAGE_AEAD_TAG_BYTES);
+    CHECK(message_aead_seal(MESSAGE_AEAD_CHACHA20_POLY1305, aead_ct.data(), aead_ct.data() + plain.size(),
+                            plain.data(), plain.size(), nullptr, 0, aead_key.data(), nonce.data(),
+                            nonce.size()) == MESSAGE_AEAD_OK);
+    std::vector<uint8_t> tampered = aead_ct;
+    tampered[0] ^= 1;
+
+    feed(client, "{\"topic\":");                                                   // rusak
+    feed(client, insert_frame("realtime:chat-lain", "1", "", xor_ct, iv));           // topic lain
+    feed(client, insert_frame(topic, "101", "", xor_ct, iv));
+    feed(client, insert_frame(topic, "\"uuid-102\"", "chacha20_poly1305", aead_ct, nonce));
+    feed(client, insert_frame(topic, "103", "chacha20_poly1305", tampered, nonce));
+    feed(client, insert_frame(topic, "104", "rot13", aead_ct, nonce));                // algoritma tidak dikenal
+
+    Message m;
+    CHECK(read_message(ring, m) && m.id == "101" && m.header.status == MESSAGE_RECORD_OK &&
+          m.header.algorithm == MESSAGE_RECORD_ALG_XOR_WITH_IV && m.text == "halo dari realtime");
+    CHECK(m.header.created_at_us == 1714557600123456LL && m.sender == "5f0c1c8e-0000-4000-8000-000000000001");
+    CHECK(read_message(ring, m) && m.id == "uuid-102" && m.header.status == MESSAGE_RECORD_OK &&
+          m.header.algorithm == MESSAGE_AEAD_CHACHA20_POLY1305 && m.text == "halo aead");
+    CHECK(read_message(ring, m) && m.id == "103" && m.header.status == MESSAGE_RECORD_ERROR_AUTH_FAILED &&
+          m.header.text_len == 0);
+    CHECK(read_message(ring, m) && m.id == "104" && m.header.status == MESSAGE_RECORD_ERROR_MALFORMED);
+
+    RealtimeClientStats stats;
+    realtime_client_get_stats(client, &stats);
+    CHECK(stats.parse_errors == 1 && stats.ignored_events == 1 && stats.inserts == 4);
+    CHECK(stats.decrypted == 2 && stats.decrypt_failures == 2);
+
+    feed(client, "{\"topic\":\"" + topic + "\",\"event\":\"phx_close\",\"payload\":{},\"ref\":null}");
+    CHECK(next_record(ring, state) && state.tag == REALTIME_TAG_STATE);
+    if (state.payload.size() >= 4) memcpy(&state_code, state.payload.data(), 4);
+    CHECK(state_code == REALTIME_STATE_CLOSED);
+
+    realtime_client_destroy(client);
+    spsc_ring_destroy(ring);
+}
+
+}  // namespace
+
+int main() {
+    test_external_transport();
+    return test_util::result("realtime_client_test");
+}
@@ -0,0 +1,57 @@
+// KAT SHA3-512 (FIPS 202) dari native_crypto.cpp: pesan kosong, "abc", 200 byte 0xa3
+// (lebih dari satu blok rate 72), update per potongan tidak sejajar sama dengan sekali
+// jalan. argon2id_hash_raw disediakan palsu karena wrapper-nya ikut dikompilasi.
+
+#include "sha3.h"
+#include "test_util.h"
+
+#include <string>
+
+extern "C" int argon2id_hash_raw(uint32_t, uint32_t, uint32_t, const void *, size_t, const void *, size_t, void *,
+                                 size_t) {
+    return -1;
+}
+
+namespace {
+
+std::string sha3_512_hex(const std::vector<uint8_t> &data, size_t step) {
+    SHA3_CTX ctx;
+    uint8_t digest[64];
+    sha3_512_init(&ctx);
+    for (size_t offset = 0; offset < data.size(); offset += step) {
+        sha3_512_update(&ctx, data.data() + offset, std::min(step, data.size() - offset));
+    }
+    sha3_512_final(digest, &ctx);
+    return test_util::to_hex(digest, sizeof(digest));
+}
+
+void test_vectors() {
+    CHECK(sha3_512_hex({}, 1) ==
+          "a69f73cca23a9ac5c8b567dc185a756e97c982164fe25859e0d1dcc1475c80a6"
+          "15b2123af1f5f94c11e3e9402c3ac558f500199d95b6d3e301758586281dcd26");
+    CHECK(sha3_512_hex(test_util::bytes("abc"), 3) ==
+          "b751850b1a57168a5693cd924b6b096e08f621827444f70d884f5d0240d2712e"
+          "10e116e9192af3c91a7ec57647e3934057340b4cf408d5a56592f8274eec53f0");
+
+    const std::vector<uint8_t> a3(200, 0xa3);
+    const char *expected =
+        "e76dfad22084a8b1467fcf2ffa58361bec7628edf5f3fdc0e4805dc48caeeca8"
+        "1b7c13c30adf52a3659584739a2df46be589c51ca1a4a8416df6545a1ce8ba00";
+    CHECK(sha3_512_hex(a3, a3.size()) == expected);
+    CHECK(sha3_512_hex(a3, 7) == expected);
+    CHECK(sha3_512_hex(a3, 72) == expected);
+}
+
+void test_ctx_size() {
+    // wasm_smoke.mjs dan Dart (calloc<SHA3_CTX>) mengalokasikan ukuran yang sama
+    CHECK(sha3_512_ctx_size() == sizeof(SHA3_CTX));
+    CHECK(sha3_512_ctx_size() == 208);
+}
+
+}  // namespace
+
+int main() {
+    test_vectors();
+    test_ctx_size();
+    return test_util::result("sha3_test");
+}
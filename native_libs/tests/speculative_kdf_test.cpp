@@ -0,0 +1,145 @@
+// Test speculative_kdf dengan argon2id_hash_raw palsu (lambat dan deterministik): hasil
+// sekali pakai untuk input identik, MISS untuk input berbeda, PENDING saat masih berjalan,
+// hasil basi dibuang setelah begin/clear, dan destroy saat Argon2 masih berjalan.
+
+#include "argon2.h"
+#include "speculative_kdf.h"
+#include "test_util.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace {
+
+std::atomic<int> g_calls{0};
+
+// Hash palsu: out[i] = pwd[i % pwdlen] ^ salt[0] ^ i. t_cost = durasi dalam ms.
+// Password diawali '!' mensimulasikan Argon2 gagal.
+int fake_argon2id_hash_raw(uint32_t t_cost, const uint8_t *pwd, size_t pwdlen, const uint8_t *salt, uint8_t *out,
+                           size_t outlen) {
+    g_calls++;
+    std::this_thread::sleep_for(std::chrono::milliseconds(t_cost));
+    for (size_t i = 0; i < outlen; i++) {
+        out[i] = static_cast<uint8_t>((pwdlen ? pwd[i % pwdlen] : 0) ^ salt[0] ^ i);
+    }
+    return pwdlen > 0 && pwd[0] == '!' ? -1 : 0;
+}
+
+const uint8_t kSalt[16] = {0x3c};
+
+int begin(SpeculativeKdf *spec, const char *pwd, uint32_t duration_ms) {
+    KdfParams params{duration_ms, 64, 1};
+    return speculative_kdf_begin(spec, &params, reinterpret_cast<const uint8_t *>(pwd), strlen(pwd), kSalt,
+                                 sizeof(kSalt), 32);
+}
+
+int take(SpeculativeKdf *spec, const char *pwd, uint32_t duration_ms, uint8_t *out, int32_t timeout_ms) {
+    KdfParams params{duration_ms, 64, 1};
+    return speculative_kdf_take(spec, &params, reinterpret_cast<const uint8_t *>(pwd), strlen(pwd), kSalt,
+                                sizeof(kSalt), out, 32, timeout_ms);
+}
+
+bool expected_hash(const char *pwd, const uint8_t *hash) {
+    const size_t len = strlen(pwd);
+    for (uint32_t i = 0; i < 32; i++) {
+        if (hash[i] != static_cast<uint8_t>(pwd[i % len] ^ kSalt[0] ^ i)) return false;
+    }
+    return true;
+}
+
+void test_hit_is_single_use() {
+    SpeculativeKdf *spec = speculative_kdf_create();
+    uint8_t hash[32];
+    CHECK(take(spec, "rahasia", 1, hash, 0) == SPECULATIVE_KDF_MISS);
+
+    CHECK(begin(spec, "rahasia", 1) == SPECULATIVE_KDF_OK);
+    CHECK(take(spec, "rahasia", 1, hash, -1) == SPECULATIVE_KDF_OK);
+    CHECK(expected_hash("rahasia", hash));
+    CHECK(take(spec, "rahasia", 1, hash, -1) == SPECULATIVE_KDF_MISS);
+
+    // Parameter atau panjang output berbeda juga MISS, dan spekulasi dihapus
+    CHECK(begin(spec, "rahasia", 1) == SPECULATIVE_KDF_OK);
+    CHECK(take(spec, "rahasia", 2, hash, -1) == SPECULATIVE_KDF_MISS);
+    CHECK(take(spec, "rahasia", 1, hash, -1) == SPECULATIVE_KDF_MISS);
+
+    CHECK(begin(spec, "!gagal", 1) == SPECULATIVE_KDF_OK);
+    CHECK(take(spec, "!gagal", 1, hash, -1) == SPECULATIVE_KDF_ERROR_ARGON2);
+
+    KdfParams params{1, 64, 1};
+    CHECK(speculative_kdf_begin(spec, &params, nullptr, 0, kSalt, 0, 32) == SPECULATIVE_KDF_ERROR_INVALID_INPUT);
+    CHECK(speculative_kdf_begin(spec, &params, nullptr, 0, kSalt, sizeof(kSalt), SPECULATIVE_KDF_MAX_HASH_BYTES + 1) ==
+          SPECULATIVE_KDF_ERROR_INVALID_INPUT);
+    speculative_kdf_destroy(spec);
+}
+
+void test_mismatch_and_pending() {
+    SpeculativeKdf *spec = speculative_kdf_create();
+    uint8_t hash[32];
+
+    // Password diketik ulang setelah field kehilangan fokus: spekulasi lama tidak dipakai
+    CHECK(begin(spec, "password-lama", 1) == SPECULATIVE_KDF_OK);
+    CHECK(take(spec, "password-baru", 1, hash, -1) == SPECULATIVE_KDF_MISS);
+    CHECK(take(spec, "password-lama", 1, hash, -1) == SPECULATIVE_KDF_MISS);
+
+    CHECK(begin(spec, "lambat", 300) == SPECULATIVE_KDF_OK);
+    CHECK(take(spec, "lambat", 300, hash, 0) == SPECULATIVE_KDF_PENDING);
+    CHECK(take(spec, "lambat", 300, hash, -1) == SPECULATIVE_KDF_OK);
+    CHECK(expected_hash("lambat", hash));
+    speculative_kdf_destroy(spec);
+}
+
+void test_stale_result_discarded() {
+    SpeculativeKdf *spec = speculative_kdf_create();
+    uint8_t hash[32];
+
+    // begin kedua saat yang pertama masih berjalan: hasil pertama basi
+    CHECK(begin(spec, "pertama", 150) == SPECULATIVE_KDF_OK);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    CHECK(begin(spec, "kedua", 1) == SPECULATIVE_KDF_OK);
+    CHECK(take(spec, "kedua", 1, hash, -1) == SPECULATIVE_KDF_OK);
+    CHECK(expected_hash("kedua", hash));
+    CHECK(take(spec, "pertama", 150, hash, 0) == SPECULATIVE_KDF_MISS);
+
+    // Thread yang menunggu mendapat MISS jika spekulasi dihapus di tengah jalan
+    CHECK(begin(spec, "ditunggu", 200) == SPECULATIVE_KDF_OK);
+    std::atomic<int> waited{-99};
+    std::thread waiter([&] {
+        uint8_t out[32];
+        waited = take(spec, "ditunggu", 200, out, -1);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    speculative_kdf_clear(spec);
+    waiter.join();
+    CHECK(waited == SPECULATIVE_KDF_MISS);
+    speculative_kdf_destroy(spec);
+}
+
+void test_destroy_while_running() {
+    SpeculativeKdf *spec = speculative_kdf_create();
+    const int calls_before = g_calls;
+    CHECK(begin(spec, "ditinggal", 100) == SPECULATIVE_KDF_OK);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    speculative_kdf_destroy(spec);
+    CHECK(g_calls == calls_before + 1);
+}
+
+}  // namespace
+
+// Pengganti Argon2 reference (ARGON2_DIR tidak dibutuhkan untuk test ini)
+extern "C" int argon2id_hash_raw(uint32_t t_cost, uint32_t m_cost, uint32_t parallelism, const void *pwd,
+                                 size_t pwdlen, const void *salt, size_t saltlen, void *hash, size_t hashlen) {
+    (void)m_cost;
+    (void)parallelism;
+    (void)saltlen;
+    return fake_argon2id_hash_raw(t_cost, static_cast<const uint8_t *>(pwd), pwdlen,
+                                  static_cast<const uint8_t *>(salt), static_cast<uint8_t *>(hash), hashlen);
+}
+
+int main() {
+    test_hit_is_single_use();
+    test_mismatch_and_pending();
+    test_stale_result_discarded();
+    test_destroy_while_running();
+    return test_util::result("speculative_kdf_test");
+}
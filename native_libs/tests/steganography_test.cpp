@@ -0,0 +1,260 @@
+// Test library steganography (C): filter scanline PNG dan estimator biayanya, urutan
+// embedding PNG (region dengan residual tertinggi lebih dulu), round-trip encode/decode
+// untuk carrier mentah dan PNG, encode_lsb_png_multi identik dengan encode per penerima,
+// serta steganalisis (chunked = satu pass, embedding penuh terdeteksi, cover bersih tidak).
+// Dengan STEGANOGRAPHY_NATIVE_METRICS, latency encode terbaca dari native_metrics libargon2.
+
+extern "C" {
+#include "png_filter.h"
+#include "steganalysis.h"
+#include "steganography.h"
+}
+
+#include "native_metrics.h"
+#include "test_util.h"
+
+#include <cmath>
+#include <string>
+
+namespace {
+
+uint32_t g_rng = 12345;
+uint8_t next_random() {
+    g_rng = g_rng * 1664525u + 1013904223u;
+    return static_cast<uint8_t>(g_rng >> 24);
+}
+
+// Cover mirip foto: gradien halus setelah kurva gamma (histogram tidak rata seperti
+// keluaran kamera) + noise kecil, 3 channel
+std::vector<uint8_t> smooth_cover(uint32_t width, uint32_t height) {
+    std::vector<uint8_t> pixels(static_cast<size_t>(width) * height * 3);
+    for (uint32_t y = 0; y < height; y++) {
+        for (uint32_t x = 0; x < width; x++) {
+            for (uint32_t c = 0; c < 3; c++) {
+                const double t = (x * (c + 1) + y * 2.0) / ((width + height) * 3.0);
+                const int base = static_cast<int>(230 * std::pow(t, 2.2)) + 10;
+                const int noise = (next_random() % 3 + next_random() % 3) / 2 - 1;
+                pixels[(static_cast<size_t>(y) * width + x) * 3 + c] = static_cast<uint8_t>(base + noise);
+            }
+        }
+    }
+    return pixels;
+}
+
+// Kebalikan filter PNG (RFC 2083 6.6), dihitung terpisah dari png_filter.c
+std::vector<uint8_t> unfilter(const uint8_t *filtered, uint32_t width, uint32_t height, uint32_t bpp) {
+    const size_t row_len = static_cast<size_t>(width) * bpp;
+    std::vector<uint8_t> out(row_len * height);
+    for (uint32_t y = 0; y < height; y++) {
+        const uint8_t filter = filtered[y * (row_len + 1)];
+        const uint8_t *in = filtered + y * (row_len + 1) + 1;
+        uint8_t *row = out.data() + y * row_len;
+        const uint8_t *prev = y ? row - row_len : nullptr;
+        for (size_t i = 0; i < row_len; i++) {
+            const int a = i >= bpp ? row[i - bpp] : 0;
+            const int b = prev ? prev[i] : 0;
+            const int c = prev && i >= bpp ? prev[i - bpp] : 0;
+            int predicted = 0;
+            if (filter == PNG_FILTER_SUB) predicted = a;
+            if (filter == PNG_FILTER_UP) predicted = b;
+            if (filter == PNG_FILTER_AVERAGE) predicted = (a + b) / 2;
+            if (filter == PNG_FILTER_PAETH) {
+                const int p = a + b - c, pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+                predicted = pa <= pb && pa <= pc ? a : (pb <= pc ? b : c);
+            }
+            row[i] = static_cast<uint8_t>(in[i] + predicted);
+        }
+    }
+    return out;
+}
+
+void test_png_filter() {
+    PngCostTable table;
+    png_cost_table_init(&table);
+    CHECK(table.bits[0] == 1 && table.bits[1] == 2 && table.bits[255] == 2);
+    CHECK(table.bits[127] == 8 && table.bits[128] == 9 && table.bits[129] == 8);
+
+    // Baris = baris sebelumnya: UP memberi residual nol
+    std::vector<uint8_t> prev(48), row(48);
+    for (size_t i = 0; i < prev.size(); i++) prev[i] = next_random();
+    row = prev;
+    uint64_t cost = 0;
+    CHECK(png_best_filter(&table, row.data(), prev.data(), 0, row.size(), 3, 0xFF, &cost) == PNG_FILTER_UP);
+    CHECK(cost == row.size());
+    // Ramp horizontal per channel di atas baris acak: SUB
+    for (size_t i = 0; i < row.size(); i++) row[i] = static_cast<uint8_t>(10 + (i / 3) * 2);
+    CHECK(png_best_filter(&table, row.data(), prev.data(), 0, row.size(), 3, 0xFF, nullptr) == PNG_FILTER_SUB);
+    // Baris pertama (tanpa prev) dengan ramp yang sama tetap SUB
+    CHECK(png_best_filter(&table, row.data(), nullptr, 0, row.size(), 3, 0xFF, nullptr) == PNG_FILTER_SUB);
+
+    // Dengan mask 0xFE biaya tidak berubah saat LSB dibalik (urutan embedding stabil)
+    std::vector<uint8_t> flipped = row;
+    for (size_t i = 0; i < flipped.size(); i += 2) flipped[i] ^= 1;
+    for (int f = PNG_FILTER_NONE; f < PNG_FILTER_COUNT; f++) {
+        CHECK(png_row_cost(&table, row.data(), prev.data(), 0, row.size(), 3, f, 0xFE) ==
+              png_row_cost(&table, flipped.data(), prev.data(), 0, row.size(), 3, f, 0xFE));
+    }
+
+    // Setiap filter dapat dibalik
+    const uint32_t width = 33, height = 9, bpp = 4;
+    std::vector<uint8_t> pixels(width * height * bpp);
+    for (uint8_t &p : pixels) p = next_random();
+    for (int f = PNG_FILTER_NONE; f < PNG_FILTER_COUNT; f++) {
+        std::vector<uint8_t> filtered(height * (width * bpp + 1));
+        for (uint32_t y = 0; y < height; y++) {
+            const uint8_t *r = pixels.data() + y * width * bpp;
+            filtered[y * (width * bpp + 1)] = static_cast<uint8_t>(f);
+            png_apply_filter(filtered.data() + y * (width * bpp + 1) + 1, r, y ? r - width * bpp : nullptr,
+                             width * bpp, bpp, f);
+        }
+        if (unfilter(filtered.data(), width, height, bpp) != pixels) {
+            fprintf(stderr, "FAIL png_apply_filter filter %d tidak dapat dibalik\n", f);
+            test_util::failures()++;
+        }
+    }
+
+    // png_filter_scanlines: satu byte tipe per baris (filter terbaik), lalu residual
+    const std::vector<uint8_t> cover = smooth_cover(40, 20);
+    SteganographyResult scanlines = png_filter_scanlines(cover.data(), cover.size(), 40, 20, 3);
+    CHECK(scanlines.success && scanlines.data_length == 20 * (40 * 3 + 1));
+    if (scanlines.success) {
+        CHECK(unfilter(scanlines.data, 40, 20, 3) == cover);
+        for (uint32_t y = 0; y < 20; y++) {
+            const uint8_t *r = cover.data() + y * 120;
+            CHECK(scanlines.data[y * 121] ==
+                  png_best_filter(&table, r, y ? r - 120 : nullptr, 0, 120, 3, 0xFF, nullptr));
+        }
+    }
+    free_steganography_result(&scanlines);
+    scanlines = png_filter_scanlines(cover.data(), cover.size() - 1, 40, 20, 3);
+    CHECK(!scanlines.success && scanlines.error_message != nullptr);
+    free_steganography_result(&scanlines);
+}
+
+void test_png_embedding_order() {
+    // Separuh atas datar, separuh bawah noise: pesan pendek hanya boleh mengubah bagian bawah
+    const uint32_t width = 128, height = 64, channels = 3;
+    std::vector<uint8_t> pixels(width * height * channels, 0x80);
+    for (size_t i = pixels.size() / 2; i < pixels.size(); i++) pixels[i] = next_random();
+    const std::string message = "pesan rahasia di area ramai";
+
+    SteganographyResult stego =
+        encode_lsb_png(pixels.data(), pixels.size(), width, height, channels,
+                       reinterpret_cast<const uint8_t *>(message.data()), message.size(), "kata-sandi");
+    CHECK(stego.success && stego.data_length == pixels.size() && stego.width == 128 && stego.height == 64);
+    if (!stego.success) return;
+    size_t changed_top = 0, changed_bottom = 0;
+    for (size_t i = 0; i < pixels.size(); i++) {
+        CHECK((stego.data[i] & 0xFE) == (pixels[i] & 0xFE));
+        if (stego.data[i] != pixels[i]) (i < pixels.size() / 2 ? changed_top : changed_bottom)++;
+    }
+    CHECK(changed_top == 0 && changed_bottom > 0);
+
+    SteganographyResult decoded = decode_lsb_png(stego.data, stego.data_length, width, height, channels, "kata-sandi");
+    CHECK(decoded.success && decoded.data_length == message.size() &&
+          memcmp(decoded.data, message.data(), message.size()) == 0);
+    free_steganography_result(&decoded);
+    decoded = decode_lsb_png(stego.data, stego.data_length, width, height, channels, "salah");
+    CHECK(!decoded.success || decoded.data_length != message.size() ||
+          memcmp(decoded.data, message.data(), message.size()) != 0);
+    free_steganography_result(&decoded);
+
+    // Multi: setiap output identik dengan encode_lsb_png untuk penerima yang sama
+    const SteganographyRecipient recipients[] = {
+        {reinterpret_cast<const uint8_t *>(message.data()), message.size(), "kata-sandi"},
+        {reinterpret_cast<const uint8_t *>("b"), 1, "penerima-2"},
+        {reinterpret_cast<const uint8_t *>("terlalu besar"), pixels.size(), "penerima-3"},
+    };
+    SteganographyResult results[3];
+    CHECK(encode_lsb_png_multi(pixels.data(), pixels.size(), width, height, channels, recipients, 3, 2, results) == 2);
+    CHECK(results[0].success && results[0].data_length == stego.data_length &&
+          memcmp(results[0].data, stego.data, stego.data_length) == 0);
+    SteganographyResult single = encode_lsb_png(pixels.data(), pixels.size(), width, height, channels,
+                                                recipients[1].message, 1, "penerima-2");
+    CHECK(results[1].success && single.success && memcmp(results[1].data, single.data, single.data_length) == 0);
+    CHECK(!results[2].success && results[2].error_message != nullptr);
+    free_steganography_result(&single);
+    for (SteganographyResult &r : results) free_steganography_result(&r);
+    free_steganography_result(&stego);
+}
+
+uint64_t stego_operations() {
+    NativeMetricsSnapshot snapshot;
+    native_metrics_snapshot(&snapshot);
+    return snapshot.subsystems[NATIVE_METRICS_STEGO].operations;
+}
+
+void test_raw_round_trip() {
+    const std::vector<uint8_t> cover = smooth_cover(64, 64);
+    const std::string message = "halo \xF0\x9F\x91\x8B";
+    const uint64_t operations_before = stego_operations();
+    SteganographyResult stego = encode_lsb_dct(cover.data(), cover.size(),
+                                               reinterpret_cast<const uint8_t *>(message.data()), message.size(), "pw");
+    CHECK(stego.success && stego.data_length == cover.size());
+#ifdef STEGANOGRAPHY_NATIVE_METRICS
+    CHECK(stego_operations() > operations_before);
+#else
+    CHECK(stego_operations() == operations_before);
+#endif
+    if (!stego.success) return;
+    SteganographyResult decoded = decode_lsb_dct(stego.data, stego.data_length, "pw");
+    CHECK(decoded.success && decoded.data_length == message.size() &&
+          memcmp(decoded.data, message.data(), message.size()) == 0);
+    free_steganography_result(&decoded);
+    free_steganography_result(&stego);
+
+    const size_t capacity = get_max_capacity(cover.data(), cover.size());
+    std::vector<uint8_t> too_big(capacity);
+    stego = encode_lsb_dct(cover.data(), cover.size(), too_big.data(), too_big.size(), "pw");
+    CHECK(!stego.success && stego.data == nullptr && stego.error_message != nullptr);
+    free_steganography_result(&stego);
+}
+
+void test_steganalysis() {
+    const std::vector<uint8_t> cover = smooth_cover(96, 96);
+
+    // Akumulasi per chunk (batas tidak sejajar) sama dengan satu pass
+    SteganalysisAccumulator chunked;
+    steganalysis_reset(&chunked);
+    for (size_t begin = 0; begin < cover.size(); begin += 1000) {
+        steganalysis_accumulate(&chunked, cover.data(), begin, std::min(cover.size(), begin + 1000));
+    }
+    SteganalysisReport from_chunks;
+    steganalysis_finish(&chunked, &from_chunks);
+    const SteganalysisReport clean = analyze_steganalysis(cover.data(), cover.size());
+    CHECK(from_chunks.chi_square == clean.chi_square && from_chunks.rs_estimate == clean.rs_estimate &&
+          from_chunks.spa_estimate == clean.spa_estimate && from_chunks.detection_score == clean.detection_score);
+
+    // LSB semua sample diganti bit acak: embedding rate 1
+    std::vector<uint8_t> embedded = cover;
+    for (uint8_t &v : embedded) v = static_cast<uint8_t>((v & 0xFE) | (next_random() & 1));
+    const SteganalysisReport full = analyze_steganalysis(embedded.data(), embedded.size());
+    CHECK(clean.detection_score < 0.2);
+    CHECK(full.detection_score > 0.6 && full.detection_score > clean.detection_score + 0.4);
+
+    // Self-check: pesan sebesar kapasitas dengan threshold ketat beralih ke LSB matching
+    std::vector<uint8_t> message(get_max_capacity(cover.data(), cover.size()) - 8);
+    for (uint8_t &v : message) v = next_random();
+    SteganalysisReport report;
+    SteganographyResult checked =
+        encode_lsb_dct_checked(cover.data(), cover.size(), message.data(), message.size(), "pw", 0.3, &report);
+    CHECK(report.lsb_matching_used);
+    CHECK(checked.success == (report.detection_score <= 0.3));
+    if (checked.success) {
+        SteganographyResult decoded = decode_lsb_dct(checked.data, checked.data_length, "pw");
+        CHECK(decoded.success && decoded.data_length == message.size() &&
+              memcmp(decoded.data, message.data(), message.size()) == 0);
+        free_steganography_result(&decoded);
+    }
+    free_steganography_result(&checked);
+}
+
+}  // namespace
+
+int main() {
+    test_png_filter();
+    test_png_embedding_order();
+    test_raw_round_trip();
+    test_steganalysis();
+    return test_util::result("steganography_test");
+}
@@ -0,0 +1,87 @@
+#ifndef NATIVE_TEST_UTIL_H
+#define NATIVE_TEST_UTIL_H
+
+// Helper minimal untuk test native (tanpa framework): CHECK mencatat kegagalan dan
+// lanjut, main() mengembalikan test_result() supaya ctest menandai gagal.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "cpu_features.h"
+
+namespace test_util {
+
+inline int &failures() {
+    static int count = 0;
+    return count;
+}
+
+inline std::vector<uint8_t> hex(const char *text) {
+    std::vector<uint8_t> out;
+    size_t len = strlen(text);
+    for (size_t i = 0; i + 1 < len; i += 2) {
+        unsigned value = 0;
+        sscanf(text + i, "%2x", &value);
+        out.push_back(static_cast<uint8_t>(value));
+    }
+    return out;
+}
+
+inline std::string to_hex(const uint8_t *data, size_t len) {
+    static const char digits[] = "0123456789abcdef";
+    std::string out;
+    for (size_t i = 0; i < len; i++) {
+        out += digits[data[i] >> 4];
+        out += digits[data[i] & 0x0f];
+    }
+    return out;
+}
+
+inline std::vector<uint8_t> bytes(const char *text) {
+    return std::vector<uint8_t>(text, text + strlen(text));
+}
+
+inline bool check_bytes(const char *what, const uint8_t *actual, const std::vector<uint8_t> &expected) {
+    if (memcmp(actual, expected.data(), expected.size()) == 0) return true;
+    fprintf(stderr, "FAIL %s\n  expected %s\n  actual   %s\n", what,
+            to_hex(expected.data(), expected.size()).c_str(), to_hex(actual, expected.size()).c_str());
+    failures()++;
+    return false;
+}
+
+// Jalankan body untuk deteksi penuh dan untuk jalur portable (mask 0), supaya setiap
+// implementasi yang dipilih cpu_features ikut diuji
+template <typename Body>
+void for_each_cpu_mask(Body body) {
+    const uint32_t masks[] = {0xFFFFFFFFu, CPU_FEATURE_64BIT | CPU_FEATURE_SSE2 | CPU_FEATURE_NEON | CPU_FEATURE_SIMD128,
+                              CPU_FEATURE_64BIT, 0};
+    for (uint32_t mask : masks) {
+        cpu_features_set_mask(mask);
+        body(cpu_features_get());
+    }
+    cpu_features_set_mask(0xFFFFFFFFu);
+}
+
+inline int result(const char *name) {
+    if (failures() == 0) {
+        printf("%s: OK\n", name);
+        return 0;
+    }
+    fprintf(stderr, "%s: %d failure(s)\n", name, failures());
+    return 1;
+}
+
+}  // namespace test_util
+
+#define CHECK(cond)                                                          \
+    do {                                                                     \
+        if (!(cond)) {                                                       \
+            fprintf(stderr, "FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);  \
+            test_util::failures()++;                                         \
+        }                                                                    \
+    } while (0)
+
+#endif
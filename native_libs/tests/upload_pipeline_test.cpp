@@ -0,0 +1,260 @@
+// Test upload_pipeline: ciphertext dan tag sama dengan format FileEncryptionService
+// (ChaCha20 counter = offset / 64, HMAC-SHA512 atas nonce || len LE64 || ciphertext),
+// juga setelah rewind di tengah upload dan saat resume dari offset server yang tidak
+// sejajar blok. Vektor dihitung dengan pyca/cryptography + hmac Python. Consumer
+// non-blocking (doorbell + try_finish) dan salinan ciphertext di cipher_path.
+
+#include "sha512.h"
+#include "test_util.h"
+#include "upload_pipeline.h"
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// SHA-512 seluruh ciphertext dan tag untuk plaintext (i * 7 + 3) % 251, 1000 byte,
+// key 00..1f, nonce RFC 8439 2.4.2, hmac key "upload-hmac-key"
+const char *kCiphertextSha512 =
+    "4d20a45fe9646915e244a976b0e4277bc386f07c79ff07ed8b444bb05e7d9d13"
+    "42fb0a774d64b702d45b5a748f17f396b9e0b439ddd895ddaec03aa7345962a7";
+const char *kTag =
+    "7c5ea1a029f9e7cfcf7b26877645256771226451b37caad46b8fbf0eb697c669"
+    "6c4f1a7faff4bdffdbb3f1292c36220383318fb98ed2fee07d940b5c76e701c3";
+constexpr size_t kFileBytes = 1000;
+
+struct TempFile {
+    fs::path path;
+    TempFile() {
+        static int counter = 0;
+        const auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+        path = fs::temp_directory_path() /
+               ("upload_pipeline_test_" + std::to_string(now) + "_" + std::to_string(counter++));
+        std::ofstream out(path, std::ios::binary);
+        for (size_t i = 0; i < kFileBytes; i++) out.put(static_cast<char>((i * 7 + 3) % 251));
+    }
+    ~TempFile() {
+        std::error_code ec;
+        fs::remove(path, ec);
+    }
+};
+
+const std::vector<uint8_t> kKey = test_util::hex("000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f");
+const std::vector<uint8_t> kNonce = test_util::hex("000000090000004a00000000");
+const std::vector<uint8_t> kHmacKey = test_util::bytes("upload-hmac-key");
+
+UploadPipeline *open_pipeline(const std::string &path, uint32_t segment_size, uint32_t read_ahead,
+                              uint64_t resume_offset, int *status, const char *cipher_path = nullptr) {
+    UploadPipelineConfig config;
+    memset(&config, 0, sizeof(config));
+    config.source_path = path.c_str();
+    config.key = kKey.data();
+    config.nonce = kNonce.data();
+    config.hmac_key = kHmacKey.data();
+    config.hmac_key_len = kHmacKey.size();
+    config.segment_size = segment_size;
+    config.read_ahead = read_ahead;
+    config.resume_offset = resume_offset;
+    config.cipher_path = cipher_path;
+    return upload_pipeline_open(&config, status);
+}
+
+// Ambil segmen sampai DONE dan tulis ke ciphertext sesuai offset-nya (seperti server)
+void drain(UploadPipeline *pipeline, std::vector<uint8_t> &ciphertext, uint64_t expect_offset) {
+    UploadSegment segment;
+    int rc;
+    while ((rc = upload_pipeline_next(pipeline, &segment, 1)) == UPLOAD_PIPELINE_OK) {
+        CHECK(segment.offset == expect_offset);
+        CHECK(segment.offset + segment.len <= ciphertext.size());
+        if (segment.offset + segment.len > ciphertext.size()) return;
+        memcpy(ciphertext.data() + segment.offset, segment.data, segment.len);
+        expect_offset += segment.len;
+        CHECK(segment.last == (expect_offset == kFileBytes ? 1 : 0));
+        upload_pipeline_release(pipeline, expect_offset);
+    }
+    CHECK(rc == UPLOAD_PIPELINE_DONE && expect_offset == kFileBytes);
+}
+
+void check_result(UploadPipeline *pipeline, const std::vector<uint8_t> &ciphertext) {
+    uint8_t digest[SHA512_DIGEST_BYTES];
+    SHA512_CTX ctx;
+    sha512_init(&ctx);
+    sha512_update(&ctx, ciphertext.data(), ciphertext.size());
+    sha512_final(digest, &ctx);
+    test_util::check_bytes("ciphertext", digest, test_util::hex(kCiphertextSha512));
+
+    uint8_t tag[UPLOAD_PIPELINE_TAG_BYTES];
+    CHECK(upload_pipeline_finish(pipeline, tag) == UPLOAD_PIPELINE_OK);
+    test_util::check_bytes("tag", tag, test_util::hex(kTag));
+}
+
+void test_format_parity() {
+    TempFile file;
+    int status = -99;
+    UploadPipeline *pipeline = open_pipeline(file.path.string(), 256, 2, 0, &status);
+    CHECK(pipeline != nullptr && status == UPLOAD_PIPELINE_OK);
+    if (!pipeline) return;
+    CHECK(upload_pipeline_total_bytes(pipeline) == kFileBytes);
+
+    std::vector<uint8_t> ciphertext(kFileBytes);
+    drain(pipeline, ciphertext, 0);
+    check_result(pipeline, ciphertext);
+    upload_pipeline_close(pipeline);
+}
+
+void test_rewind_hashes_once() {
+    TempFile file;
+    UploadPipeline *pipeline = open_pipeline(file.path.string(), 256, 2, 0, nullptr);
+    CHECK(pipeline != nullptr);
+    if (!pipeline) return;
+
+    // Dua segmen terkirim, koneksi putus, server hanya menerima sampai 320
+    std::vector<uint8_t> ciphertext(kFileBytes);
+    UploadSegment segment;
+    for (int i = 0; i < 2; i++) {
+        CHECK(upload_pipeline_next(pipeline, &segment, 1) == UPLOAD_PIPELINE_OK);
+        memcpy(ciphertext.data() + segment.offset, segment.data, segment.len);
+    }
+    CHECK(upload_pipeline_rewind(pipeline, kFileBytes + 1) == UPLOAD_PIPELINE_ERROR_INVALID_INPUT);
+    CHECK(upload_pipeline_rewind(pipeline, 320) == UPLOAD_PIPELINE_OK);
+    drain(pipeline, ciphertext, 320);
+    check_result(pipeline, ciphertext);
+
+    UploadPipelineStats stats;
+    upload_pipeline_get_stats(pipeline, &stats);
+    CHECK(stats.total_bytes == kFileBytes && stats.hashed_offset == kFileBytes);
+    CHECK(stats.bytes_reproduced > 0 && stats.bytes_reproduced <= 512 - 320 + 256);
+    upload_pipeline_close(pipeline);
+}
+
+void test_resume_unaligned() {
+    TempFile file;
+    int status = -99;
+    UploadPipeline *pipeline = open_pipeline(file.path.string(), 128, 0, 500, &status);
+    CHECK(pipeline != nullptr && status == UPLOAD_PIPELINE_OK);
+    if (!pipeline) return;
+
+    // Bagian sebelum 500 sudah ada di server dari sesi lama; tag tetap mencakupnya
+    UploadPipeline *full = open_pipeline(file.path.string(), 0, 0, 0, nullptr);
+    std::vector<uint8_t> ciphertext(kFileBytes);
+    drain(full, ciphertext, 0);
+    upload_pipeline_close(full);
+    std::fill(ciphertext.begin() + 500, ciphertext.end(), 0);
+
+    drain(pipeline, ciphertext, 500);
+    check_result(pipeline, ciphertext);
+    upload_pipeline_close(pipeline);
+}
+
+std::atomic<int> g_rings{0};
+std::atomic<int64_t> g_token{0};
+
+void ring(int64_t token) {
+    g_token = token;
+    g_rings++;
+}
+
+// Tunggu doorbell seperti Completer di Dart: arm, lalu tidur sampai ring berikutnya
+void wait_for_ring(UploadPipeline *pipeline, int for_finish) {
+    const int before = g_rings;
+    if (upload_pipeline_arm(pipeline, for_finish)) return;
+    while (g_rings == before) std::this_thread::yield();
+}
+
+void test_doorbell_consumer() {
+    TempFile file;
+    const std::string cipher_path = file.path.string() + ".enc";
+    int status = -99;
+    UploadPipeline *pipeline = open_pipeline(file.path.string(), 128, 2, 0, &status, cipher_path.c_str());
+    CHECK(pipeline != nullptr && status == UPLOAD_PIPELINE_OK);
+    if (!pipeline) return;
+    upload_pipeline_set_doorbell(pipeline, ring, 42);
+
+    // Sama seperti EncryptingFileSource: next(wait = 0), tidak pernah blok di condvar
+    std::vector<uint8_t> ciphertext(kFileBytes);
+    UploadSegment segment;
+    uint64_t expect_offset = 0;
+    for (;;) {
+        const int rc = upload_pipeline_next(pipeline, &segment, 0);
+        if (rc == UPLOAD_PIPELINE_PENDING) {
+            wait_for_ring(pipeline, 0);
+            continue;
+        }
+        if (rc != UPLOAD_PIPELINE_OK) {
+            CHECK(rc == UPLOAD_PIPELINE_DONE);
+            break;
+        }
+        CHECK(segment.offset == expect_offset);
+        memcpy(ciphertext.data() + segment.offset, segment.data, segment.len);
+        expect_offset += segment.len;
+        upload_pipeline_release(pipeline, expect_offset);
+    }
+    CHECK(expect_offset == kFileBytes);
+
+    uint8_t tag[UPLOAD_PIPELINE_TAG_BYTES];
+    int rc;
+    while ((rc = upload_pipeline_try_finish(pipeline, tag)) == UPLOAD_PIPELINE_PENDING) wait_for_ring(pipeline, 1);
+    CHECK(rc == UPLOAD_PIPELINE_OK);
+    check_result(pipeline, ciphertext);
+    CHECK(g_rings == 0 || g_token == 42);
+
+    // Setelah doorbell dilepas, arm tidak lagi membunyikan apa pun
+    upload_pipeline_set_doorbell(pipeline, nullptr, 0);
+    upload_pipeline_close(pipeline);
+
+    std::ifstream in(cipher_path, std::ios::binary);
+    std::vector<uint8_t> stored((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+    CHECK(stored == ciphertext);
+    std::error_code ec;
+    fs::remove(cipher_path, ec);
+}
+
+void test_try_finish_stuck() {
+    TempFile file;
+    UploadPipeline *pipeline = open_pipeline(file.path.string(), 128, 1, 0, nullptr);
+    CHECK(pipeline != nullptr);
+    if (!pipeline) return;
+
+    // Read-ahead 1 penuh dan segmen tidak pernah diambil: tag tidak akan selesai
+    uint8_t tag[UPLOAD_PIPELINE_TAG_BYTES];
+    int rc;
+    while ((rc = upload_pipeline_try_finish(pipeline, tag)) == UPLOAD_PIPELINE_PENDING) std::this_thread::yield();
+    CHECK(rc == UPLOAD_PIPELINE_ERROR_INVALID_INPUT);
+    CHECK(upload_pipeline_arm(pipeline, 1) == 1);
+    CHECK(upload_pipeline_arm(pipeline, 0) == 1);
+    upload_pipeline_close(pipeline);
+}
+
+void test_rejects_invalid_config() {
+    TempFile file;
+    int status = 0;
+    CHECK(open_pipeline(file.path.string(), 100, 0, 0, &status) == nullptr &&
+          status == UPLOAD_PIPELINE_ERROR_INVALID_INPUT);
+    CHECK(open_pipeline(file.path.string(), 0, 0, kFileBytes + 1, &status) == nullptr &&
+          status == UPLOAD_PIPELINE_ERROR_INVALID_INPUT);
+    CHECK(open_pipeline((file.path.string() + ".tidak-ada"), 0, 0, 0, &status) == nullptr &&
+          status == UPLOAD_PIPELINE_ERROR_IO);
+    const std::string bad_cipher = (file.path.parent_path() / "tidak-ada" / "x.enc").string();
+    CHECK(open_pipeline(file.path.string(), 0, 0, 0, &status, bad_cipher.c_str()) == nullptr &&
+          status == UPLOAD_PIPELINE_ERROR_IO);
+}
+
+}  // namespace
+
+int main() {
+    test_format_parity();
+    test_rewind_hashes_once();
+    test_resume_unaligned();
+    test_doorbell_consumer();
+    test_try_finish_stuck();
+    test_rejects_invalid_config();
+    return test_util::result("upload_pipeline_test");
+}
@@ -0,0 +1,401 @@
+#include "upload_pipeline.h"
+#include "chacha20_poly1305.h"
+#include "native_metrics.h"
+#include "sha512.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr uint32_t kDefaultSegmentSize = 1u << 20;
+constexpr uint32_t kDefaultReadAhead = 3;
+
+struct Segment {
+    uint64_t offset = 0;
+    std::vector<uint8_t> data;
+};
+
+void secure_wipe(uint8_t *p, size_t len) {
+    volatile uint8_t *v = p;
+    for (size_t i = 0; i < len; i++) {
+        v[i] = 0;
+    }
+}
+
+int seek_file(FILE *file, uint64_t offset) {
+#if defined(_WIN32)
+    return _fseeki64(file, static_cast<int64_t>(offset), SEEK_SET);
+#else
+    return fseeko(file, static_cast<off_t>(offset), SEEK_SET);
+#endif
+}
+
+bool file_size(FILE *file, uint64_t *size) {
+#if defined(_WIN32)
+    if (_fseeki64(file, 0, SEEK_END) != 0) return false;
+    const int64_t end = _ftelli64(file);
+#else
+    if (fseeko(file, 0, SEEK_END) != 0) return false;
+    const off_t end = ftello(file);
+#endif
+    if (end < 0) return false;
+    *size = static_cast<uint64_t>(end);
+    return true;
+}
+
+}  // namespace
+
+struct UploadPipeline {
+    std::mutex mutex;
+    std::condition_variable work_cv;
+    std::condition_variable ready_cv;
+    std::thread worker;
+    bool stopping = false;
+    int error = UPLOAD_PIPELINE_OK;
+
+    FILE *file = nullptr;
+    FILE *cipher_file = nullptr;    // hanya ditulis worker
+    uint8_t key[UPLOAD_PIPELINE_KEY_BYTES];
+    uint8_t nonce[UPLOAD_PIPELINE_NONCE_BYTES];
+    uint32_t segment_size = kDefaultSegmentSize;
+    uint32_t read_ahead = kDefaultReadAhead;
+    uint64_t total = 0;
+
+    // Hanya disentuh worker; hashed_offset dibaca pihak lain di bawah mutex
+    HMAC_SHA512_CTX hmac;
+    uint64_t hashed_offset = 0;
+
+    uint64_t produce_offset = 0;
+    uint64_t generation = 0;
+    bool producing = false;
+    uint64_t high_watermark = 0;
+    std::deque<std::unique_ptr<Segment>> ready;
+    std::deque<std::unique_ptr<Segment>> in_flight;
+
+    uint64_t segments_produced = 0;
+    uint64_t bytes_reproduced = 0;
+    uint64_t producer_stalls = 0;
+    uint64_t consumer_waits = 0;
+
+    UploadPipelineDoorbell doorbell = nullptr;
+    int64_t doorbell_token = 0;
+    bool armed = false;
+
+    // Predikat di bawah mutex
+    bool finished() const { return ready.empty() && !producing && produce_offset >= total; }
+    bool hashed_all() const { return hashed_offset >= total && !producing; }
+    bool read_ahead_full() const { return ready.size() + in_flight.size() >= read_ahead && produce_offset < total; }
+    bool next_ready() const { return error != UPLOAD_PIPELINE_OK || !ready.empty() || finished(); }
+    bool finish_ready() const { return error != UPLOAD_PIPELINE_OK || hashed_all() || read_ahead_full(); }
+
+    // Kemajuan worker, dipanggil dengan mutex dipegang. Doorbell hanya jika consumer armed.
+    void signal() {
+        ready_cv.notify_all();
+        if (armed && doorbell) {
+            armed = false;
+            doorbell(doorbell_token);
+        }
+    }
+
+    void worker_loop();
+    bool write_cipher(uint64_t offset, const uint8_t *data, size_t len);
+    // Baca dan enkripsi [offset, offset + len); dipanggil tanpa lock
+    bool encrypt_range(uint64_t offset, size_t len, std::vector<uint8_t> &out);
+    bool hash_range(uint64_t from, uint64_t to);
+};
+
+bool UploadPipeline::encrypt_range(uint64_t offset, size_t len, std::vector<uint8_t> &out) {
+    // Keystream per blok 64 byte: offset yang tidak sejajar (resume di tengah blok) dibaca dari awal blok
+    const uint64_t aligned = offset & ~static_cast<uint64_t>(CHACHA20_BLOCK_BYTES - 1);
+    const size_t prefix = static_cast<size_t>(offset - aligned);
+    std::vector<uint8_t> buffer(prefix + len);
+    if (seek_file(file, aligned) != 0 || fread(buffer.data(), 1, buffer.size(), file) != buffer.size()) {
+        return false;
+    }
+
+    const uint64_t started_ns = native_metrics_now_ns();
+    chacha20_xor(buffer.data(), buffer.data(), buffer.size(), key, nonce,
+                 static_cast<uint32_t>(aligned / CHACHA20_BLOCK_BYTES));
+    native_metrics_record(NATIVE_METRICS_CIPHER, started_ns, buffer.size(), 1);
+
+    out.assign(buffer.begin() + prefix, buffer.end());
+    return true;
+}
+
+// Ciphertext deterministik per offset, jadi segmen yang dibuat ulang setelah rewind
+// menimpa byte yang sama
+bool UploadPipeline::write_cipher(uint64_t offset, const uint8_t *data, size_t len) {
+    if (!cipher_file) return true;
+    return seek_file(cipher_file, offset) == 0 && fwrite(data, 1, len, cipher_file) == len &&
+           fflush(cipher_file) == 0;
+}
+
+bool UploadPipeline::hash_range(uint64_t from, uint64_t to) {
+    std::vector<uint8_t> chunk;
+    while (from < to) {
+        const size_t len = static_cast<size_t>(std::min<uint64_t>(segment_size, to - from));
+        if (!encrypt_range(from, len, chunk) || !write_cipher(from, chunk.data(), chunk.size())) return false;
+        hmac_sha512_update(&hmac, chunk.data(), chunk.size());
+        from += len;
+    }
+    return true;
+}
+
+void UploadPipeline::worker_loop() {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    // Resume: ciphertext sebelum resume_offset tidak dikirim ulang, tapi tetap masuk tag
+    if (hashed_offset < produce_offset) {
+        const uint64_t target = produce_offset;
+        producing = true;
+        lock.unlock();
+        const bool ok = hash_range(hashed_offset, target);
+        lock.lock();
+        producing = false;
+        if (ok) hashed_offset = target;
+        else error = UPLOAD_PIPELINE_ERROR_IO;
+        signal();
+    }
+
+    for (;;) {
+        auto can_produce = [this] {
+            return produce_offset < total && ready.size() + in_flight.size() < read_ahead;
+        };
+        if (!stopping && error == UPLOAD_PIPELINE_OK && produce_offset < total && !can_produce()) {
+            producer_stalls++;
+        }
+        work_cv.wait(lock, [&] { return stopping || (error == UPLOAD_PIPELINE_OK && can_produce()); });
+        if (stopping) return;
+
+        const uint64_t offset = produce_offset;
+        const size_t len = static_cast<size_t>(
+            std::min<uint64_t>(segment_size - offset % segment_size, total - offset));
+        const uint64_t segment_generation = generation;
+        uint64_t hashed = hashed_offset;
+        produce_offset += len;
+        producing = true;
+        lock.unlock();
+
+        // Rewind tidak pernah melewati offset yang sudah di-hash; jaga-jaga tetap ditutup
+        bool ok = hashed >= offset || hash_range(hashed, offset);
+        if (hashed < offset) hashed = offset;
+
+        auto segment = std::make_unique<Segment>();
+        segment->offset = offset;
+        ok = ok && encrypt_range(offset, len, segment->data) &&
+             write_cipher(offset, segment->data.data(), segment->data.size());
+        if (ok && hashed < offset + len) {
+            hmac_sha512_update(&hmac, segment->data.data() + (hashed - offset), static_cast<size_t>(offset + len - hashed));
+            hashed = offset + len;
+        }
+
+        lock.lock();
+        producing = false;
+        if (!ok) {
+            error = UPLOAD_PIPELINE_ERROR_IO;
+            signal();
+            continue;
+        }
+        hashed_offset = hashed;
+        if (segment_generation != generation) {
+            // Rewind terjadi selama enkripsi: segmen ini tidak lagi berurutan
+            signal();
+            continue;
+        }
+        if (offset < high_watermark) {
+            bytes_reproduced += std::min<uint64_t>(len, high_watermark - offset);
+        }
+        high_watermark = std::max(high_watermark, offset + len);
+        segments_produced++;
+        ready.push_back(std::move(segment));
+        signal();
+    }
+}
+
+extern "C" UploadPipeline *upload_pipeline_open(const UploadPipelineConfig *config, int *status) {
+    int local_status = UPLOAD_PIPELINE_OK;
+    if (!status) status = &local_status;
+    if (!config || !config->source_path || !config->key || !config->nonce || !config->hmac_key ||
+        (config->segment_size % CHACHA20_BLOCK_BYTES) != 0) {
+        *status = UPLOAD_PIPELINE_ERROR_INVALID_INPUT;
+        return nullptr;
+    }
+
+    FILE *file = fopen(config->source_path, "rb");
+    uint64_t total = 0;
+    if (!file || !file_size(file, &total)) {
+        if (file) fclose(file);
+        *status = UPLOAD_PIPELINE_ERROR_IO;
+        return nullptr;
+    }
+    if (config->resume_offset > total) {
+        fclose(file);
+        *status = UPLOAD_PIPELINE_ERROR_INVALID_INPUT;
+        return nullptr;
+    }
+    FILE *cipher_file = nullptr;
+    if (config->cipher_path && !(cipher_file = fopen(config->cipher_path, "wb"))) {
+        fclose(file);
+        *status = UPLOAD_PIPELINE_ERROR_IO;
+        return nullptr;
+    }
+
+    UploadPipeline *pipeline = new UploadPipeline();
+    pipeline->file = file;
+    pipeline->cipher_file = cipher_file;
+    pipeline->total = total;
+    memcpy(pipeline->key, config->key, UPLOAD_PIPELINE_KEY_BYTES);
+    memcpy(pipeline->nonce, config->nonce, UPLOAD_PIPELINE_NONCE_BYTES);
+    if (config->segment_size) pipeline->segment_size = config->segment_size;
+    if (config->read_ahead) pipeline->read_ahead = config->read_ahead;
+    pipeline->produce_offset = config->resume_offset;
+    pipeline->high_watermark = config->resume_offset;
+
+    // Tag sama dengan FileEncryptionService._generateAuthTag: nonce || fileSize LE64 || ciphertext
+    uint8_t length_le[8];
+    for (int i = 0; i < 8; i++) length_le[i] = static_cast<uint8_t>(total >> (8 * i));
+    hmac_sha512_init(&pipeline->hmac, config->hmac_key, config->hmac_key_len);
+    hmac_sha512_update(&pipeline->hmac, pipeline->nonce, UPLOAD_PIPELINE_NONCE_BYTES);
+    hmac_sha512_update(&pipeline->hmac, length_le, sizeof(length_le));
+
+    pipeline->worker = std::thread([pipeline] { pipeline->worker_loop(); });
+    *status = UPLOAD_PIPELINE_OK;
+    return pipeline;
+}
+
+extern "C" void upload_pipeline_close(UploadPipeline *pipeline) {
+    if (!pipeline) return;
+    {
+        std::lock_guard<std::mutex> lock(pipeline->mutex);
+        pipeline->stopping = true;
+    }
+    pipeline->work_cv.notify_all();
+    pipeline->ready_cv.notify_all();
+    pipeline->worker.join();
+    fclose(pipeline->file);
+    if (pipeline->cipher_file) fclose(pipeline->cipher_file);
+    secure_wipe(pipeline->key, sizeof(pipeline->key));
+    secure_wipe(reinterpret_cast<uint8_t *>(&pipeline->hmac), sizeof(pipeline->hmac));
+    delete pipeline;
+}
+
+extern "C" int upload_pipeline_next(UploadPipeline *pipeline, UploadSegment *out, int wait) {
+    if (!pipeline || !out) return UPLOAD_PIPELINE_ERROR_INVALID_INPUT;
+
+    std::unique_lock<std::mutex> lock(pipeline->mutex);
+    if (!pipeline->next_ready()) {
+        pipeline->consumer_waits++;
+        if (!wait) return UPLOAD_PIPELINE_PENDING;
+        pipeline->ready_cv.wait(lock, [pipeline] { return pipeline->stopping || pipeline->next_ready(); });
+    }
+    if (pipeline->error != UPLOAD_PIPELINE_OK) return pipeline->error;
+    if (pipeline->ready.empty()) return UPLOAD_PIPELINE_DONE;
+
+    std::unique_ptr<Segment> segment = std::move(pipeline->ready.front());
+    pipeline->ready.pop_front();
+    out->offset = segment->offset;
+    out->data = segment->data.data();
+    out->len = segment->data.size();
+    out->last = segment->offset + segment->data.size() == pipeline->total ? 1 : 0;
+    pipeline->in_flight.push_back(std::move(segment));
+    return UPLOAD_PIPELINE_OK;
+}
+
+extern "C" void upload_pipeline_release(UploadPipeline *pipeline, uint64_t acked_offset) {
+    if (!pipeline) return;
+    {
+        std::lock_guard<std::mutex> lock(pipeline->mutex);
+        auto &in_flight = pipeline->in_flight;
+        in_flight.erase(std::remove_if(in_flight.begin(), in_flight.end(),
+                                       [acked_offset](const std::unique_ptr<Segment> &segment) {
+                                           return segment->offset + segment->data.size() <= acked_offset;
+                                       }),
+                        in_flight.end());
+    }
+    pipeline->work_cv.notify_all();
+}
+
+extern "C" int upload_pipeline_rewind(UploadPipeline *pipeline, uint64_t offset) {
+    if (!pipeline) return UPLOAD_PIPELINE_ERROR_INVALID_INPUT;
+    {
+        std::lock_guard<std::mutex> lock(pipeline->mutex);
+        if (offset > pipeline->total) return UPLOAD_PIPELINE_ERROR_INVALID_INPUT;
+        pipeline->generation++;
+        pipeline->ready.clear();
+        pipeline->in_flight.clear();
+        pipeline->produce_offset = offset;
+    }
+    pipeline->work_cv.notify_all();
+    return UPLOAD_PIPELINE_OK;
+}
+
+extern "C" uint64_t upload_pipeline_total_bytes(UploadPipeline *pipeline) {
+    if (!pipeline) return 0;
+    return pipeline->total;
+}
+
+extern "C" int upload_pipeline_finish(UploadPipeline *pipeline, uint8_t tag[UPLOAD_PIPELINE_TAG_BYTES]) {
+    if (!pipeline || !tag) return UPLOAD_PIPELINE_ERROR_INVALID_INPUT;
+
+    std::unique_lock<std::mutex> lock(pipeline->mutex);
+    // Segmen terakhir harus sudah diambil dengan next(); worker lalu selesai meng-hash sisanya
+    pipeline->ready_cv.wait(lock, [pipeline] { return pipeline->finish_ready(); });
+    if (pipeline->error != UPLOAD_PIPELINE_OK) return pipeline->error;
+    if (!pipeline->hashed_all()) return UPLOAD_PIPELINE_PENDING;
+
+    HMAC_SHA512_CTX copy = pipeline->hmac;
+    hmac_sha512_final(tag, &copy);
+    return UPLOAD_PIPELINE_OK;
+}
+
+extern "C" int upload_pipeline_try_finish(UploadPipeline *pipeline, uint8_t tag[UPLOAD_PIPELINE_TAG_BYTES]) {
+    if (!pipeline || !tag) return UPLOAD_PIPELINE_ERROR_INVALID_INPUT;
+
+    std::lock_guard<std::mutex> lock(pipeline->mutex);
+    if (pipeline->error != UPLOAD_PIPELINE_OK) return pipeline->error;
+    if (!pipeline->hashed_all()) {
+        return pipeline->read_ahead_full() ? UPLOAD_PIPELINE_ERROR_INVALID_INPUT : UPLOAD_PIPELINE_PENDING;
+    }
+
+    HMAC_SHA512_CTX copy = pipeline->hmac;
+    hmac_sha512_final(tag, &copy);
+    return UPLOAD_PIPELINE_OK;
+}
+
+extern "C" void upload_pipeline_set_doorbell(UploadPipeline *pipeline, UploadPipelineDoorbell doorbell,
+                                             int64_t token) {
+    if (!pipeline) return;
+    // Doorbell hanya dipanggil di bawah mutex, jadi setelah ini doorbell lama tidak berjalan
+    std::lock_guard<std::mutex> lock(pipeline->mutex);
+    pipeline->doorbell = doorbell;
+    pipeline->doorbell_token = token;
+    pipeline->armed = false;
+}
+
+extern "C" int upload_pipeline_arm(UploadPipeline *pipeline, int for_finish) {
+    if (!pipeline) return 1;
+    std::lock_guard<std::mutex> lock(pipeline->mutex);
+    if (for_finish ? pipeline->finish_ready() : pipeline->next_ready()) return 1;
+    pipeline->armed = true;
+    return 0;
+}
+
+extern "C" void upload_pipeline_get_stats(UploadPipeline *pipeline, UploadPipelineStats *out) {
+    if (!pipeline || !out) return;
+    std::lock_guard<std::mutex> lock(pipeline->mutex);
+    out->total_bytes = pipeline->total;
+    out->produced_offset = pipeline->produce_offset;
+    out->hashed_offset = pipeline->hashed_offset;
+    out->segments_produced = pipeline->segments_produced;
+    out->bytes_reproduced = pipeline->bytes_reproduced;
+    out->producer_stalls = pipeline->producer_stalls;
+    out->consumer_waits = pipeline->consumer_waits;
+}
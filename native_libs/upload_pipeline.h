@@ -0,0 +1,101 @@
+#ifndef UPLOAD_PIPELINE_H
+#define UPLOAD_PIPELINE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Encrypt-sambil-upload untuk attachment. Worker native membaca file per segmen,
+// mengenkripsi (format FileEncryptionService: ChaCha20 counter = offset / 64) dan
+// menghitung HMAC-SHA512 tag, sementara Dart mengirim segmen sebelumnya ke server
+// (PATCH bergaya tus dengan Upload-Offset). Setelah koneksi putus, rewind ke offset yang
+// dilaporkan server: hanya segmen yang belum diterima yang dikirim ulang, tag tetap
+// dihitung tepat satu kali atas seluruh ciphertext.
+//
+// Consumer di isolate UI tidak boleh blok: next(wait = 0) dan try_finish mengembalikan
+// PENDING, consumer memanggil upload_pipeline_arm lalu menunggu doorbell
+// (NativeCallable.listener, sama seperti spsc_ring) yang dibunyikan worker saat ada
+// kemajuan. Jika cipher_path diisi, worker juga menulis seluruh ciphertext ke file itu
+// (untuk blob_store_put_file setelah upload selesai).
+
+#define UPLOAD_PIPELINE_OK 0
+#define UPLOAD_PIPELINE_DONE 1
+#define UPLOAD_PIPELINE_PENDING 2
+#define UPLOAD_PIPELINE_ERROR_INVALID_INPUT -1
+#define UPLOAD_PIPELINE_ERROR_IO -2
+
+#define UPLOAD_PIPELINE_KEY_BYTES 32
+#define UPLOAD_PIPELINE_NONCE_BYTES 12
+#define UPLOAD_PIPELINE_TAG_BYTES 64
+
+typedef struct UploadPipeline UploadPipeline;
+
+typedef struct {
+    const char *source_path;        // file plaintext (UTF-8)
+    const uint8_t *key;             // chacha_key 32 byte
+    const uint8_t *nonce;           // 12 byte
+    const uint8_t *hmac_key;
+    size_t hmac_key_len;
+    uint32_t segment_size;          // kelipatan 64 (0 = 1 MiB)
+    uint32_t read_ahead;            // segmen yang disiapkan di depan upload (0 = 3)
+    uint64_t resume_offset;         // offset dari server (HEAD) saat melanjutkan upload lama
+    const char *cipher_path;        // NULL = tidak disimpan; lengkap setelah finish OK
+} UploadPipelineConfig;
+
+typedef struct {
+    uint64_t offset;
+    const uint8_t *data;            // valid sampai upload_pipeline_release / rewind
+    size_t len;
+    int32_t last;
+} UploadSegment;
+
+typedef struct {
+    uint64_t total_bytes;
+    uint64_t produced_offset;
+    uint64_t hashed_offset;
+    uint64_t segments_produced;
+    uint64_t bytes_reproduced;      // ciphertext yang dibuat ulang setelah rewind
+    uint64_t producer_stalls;       // worker menunggu karena read-ahead penuh (network lebih lambat)
+    uint64_t consumer_waits;        // next() harus menunggu worker (enkripsi/disk lebih lambat)
+} UploadPipelineStats;
+
+// Dipanggil dari thread worker; token diteruskan apa adanya.
+typedef void (*UploadPipelineDoorbell)(int64_t token);
+
+UploadPipeline *upload_pipeline_open(const UploadPipelineConfig *config, int *status);
+void upload_pipeline_close(UploadPipeline *pipeline);
+
+// Segmen berikutnya secara berurutan. wait = 0: PENDING jika belum siap. DONE jika habis.
+int upload_pipeline_next(UploadPipeline *pipeline, UploadSegment *out, int wait);
+
+// Server sudah menerima sampai acked_offset: buffer segmen di bawahnya dilepas.
+void upload_pipeline_release(UploadPipeline *pipeline, uint64_t acked_offset);
+
+// Mulai ulang produksi dari offset (Upload-Offset terakhir dari server).
+int upload_pipeline_rewind(UploadPipeline *pipeline, uint64_t offset);
+
+uint64_t upload_pipeline_total_bytes(UploadPipeline *pipeline);
+
+// Tunggu seluruh ciphertext ter-hash lalu isi tag HMAC-SHA512 (nonce || len LE64 || ciphertext).
+int upload_pipeline_finish(UploadPipeline *pipeline, uint8_t tag[UPLOAD_PIPELINE_TAG_BYTES]);
+// Seperti finish tanpa menunggu: PENDING selama worker masih meng-hash. INVALID_INPUT jika
+// tag tidak akan pernah selesai karena segmen belum diambil/di-release (read-ahead penuh).
+int upload_pipeline_try_finish(UploadPipeline *pipeline, uint8_t tag[UPLOAD_PIPELINE_TAG_BYTES]);
+
+// Setelah fungsi ini kembali, doorbell lama dijamin tidak sedang/akan dipanggil.
+void upload_pipeline_set_doorbell(UploadPipeline *pipeline, UploadPipelineDoorbell doorbell, int64_t token);
+// Tandai consumer menunggu; doorbell berbunyi sekali pada kemajuan worker berikutnya.
+// for_finish = 0: segmen siap untuk next(); 1: tag siap untuk try_finish. Return 1 jika
+// kondisi itu sudah terpenuhi (jangan tunggu).
+int upload_pipeline_arm(UploadPipeline *pipeline, int for_finish);
+
+void upload_pipeline_get_stats(UploadPipeline *pipeline, UploadPipelineStats *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
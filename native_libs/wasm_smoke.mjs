@@ -0,0 +1,88 @@
+// Smoke test headless untuk build WebAssembly: node wasm_smoke.mjs path/ke/native_crypto.mjs
+import { pathToFileURL } from 'node:url';
+import { resolve } from 'node:path';
+
+const modulePath = resolve(process.argv[2] ?? '../web/native/native_crypto.mjs');
+const { default: createNativeCrypto } = await import(pathToFileURL(modulePath).href);
+const m = await createNativeCrypto();
+
+const hex = (bytes) => Buffer.from(bytes).toString('hex');
+const alloc = (bytes) => {
+  const ptr = m._malloc(Math.max(bytes.length, 1));
+  m.HEAPU8.set(bytes, ptr);
+  return ptr;
+};
+const read = (ptr, len) => m.HEAPU8.slice(ptr, ptr + len);
+
+let failures = 0;
+const check = (name, ok) => {
+  console.log(`${ok ? '✅' : '❌'} ${name}`);
+  if (!ok) failures++;
+};
+
+// RFC 8439 section 2.8.2
+{
+  const key = Uint8Array.from({ length: 32 }, (_, i) => 0x80 + i);
+  const nonce = Uint8Array.from([0x07, 0, 0, 0, 0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47]);
+  const aad = Uint8Array.from([0x50, 0x51, 0x52, 0x53, 0xc0, 0xc1, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7]);
+  const pt = new TextEncoder().encode(
+    "Ladies and Gentlemen of the class of '99: If I could offer you only one tip for the future, sunscreen would be it.");
+
+  const [kP, nP, aP, pP] = [key, nonce, aad, pt].map(alloc);
+  const cP = m._malloc(pt.length);
+  const tP = m._malloc(16);
+  m._chacha20_poly1305_encrypt(cP, tP, pP, pt.length, aP, aad.length, kP, nP);
+  check('ChaCha20-Poly1305 tag (RFC 8439)', hex(read(tP, 16)) === '1ae10b594f09e26a7e902ecbd0600691');
+
+  const dP = m._malloc(pt.length);
+  const rc = m._chacha20_poly1305_decrypt(dP, cP, pt.length, tP, aP, aad.length, kP, nP);
+  check('ChaCha20-Poly1305 roundtrip', rc === 0 && hex(read(dP, pt.length)) === hex(pt));
+  [kP, nP, aP, pP, cP, tP, dP].forEach((p) => m._free(p));
+}
+
+// base64 harus identik dengan dart:convert
+{
+  const data = new TextEncoder().encode('secret_app wasm');
+  const inP = alloc(data);
+  const outP = m._malloc(m._base64_encoded_length(data.length));
+  const len = m._base64_encode(outP, inP, data.length);
+  const encoded = new TextDecoder().decode(read(outP, len));
+  check('base64 encode', encoded === Buffer.from(data).toString('base64'));
+  [inP, outP].forEach((p) => m._free(p));
+}
+
+// Argon2id v1.3 KAT dari test.c phc-winner-argon2 (t=2, m=64 MiB, p=1)
+{
+  const pwd = alloc(new TextEncoder().encode('password'));
+  const salt = alloc(new TextEncoder().encode('somesalt'));
+  const hash = m._malloc(32);
+  const start = performance.now();
+  const rc = m._argon2id_hash_raw_wrapper(2, 65536, 1, pwd, 8, salt, 8, hash, 32);
+  const elapsed = performance.now() - start;
+  check(`Argon2id t=2 m=64MiB p=1 (${elapsed.toFixed(1)} ms)`,
+    rc === 0 && hex(read(hash, 32)) === '09316115d5cf24ed5a15a31a3ba326e5cf32edc24702987c02b6566f61913cf7');
+  [pwd, salt, hash].forEach((p) => m._free(p));
+}
+
+// SHA3-512 FIPS 202: "abc" dan 200 byte 0xa3 (lebih dari satu blok), context seukuran SHA3_CTX
+{
+  const sha3 = (bytes) => {
+    const ctx = m._malloc(m._sha3_512_ctx_size());
+    const data = alloc(bytes);
+    const digest = m._malloc(64);
+    m._sha3_512_init(ctx);
+    m._sha3_512_update(ctx, data, bytes.length);
+    m._sha3_512_final(digest, ctx);
+    const out = hex(read(digest, 64));
+    [ctx, data, digest].forEach((p) => m._free(p));
+    return out;
+  };
+  check('SHA3-512 "abc"', sha3(new TextEncoder().encode('abc')) ===
+    'b751850b1a57168a5693cd924b6b096e08f621827444f70d884f5d0240d2712e' +
+    '10e116e9192af3c91a7ec57647e3934057340b4cf408d5a56592f8274eec53f0');
+  check('SHA3-512 0xa3 x 200', sha3(new Uint8Array(200).fill(0xa3)) ===
+    'e76dfad22084a8b1467fcf2ffa58361bec7628edf5f3fdc0e4805dc48caeeca8' +
+    '1b7c13c30adf52a3659584739a2df46be589c51ca1a4a8416df6545a1ce8ba00');
+}
+
+process.exit(failures === 0 ? 0 : 1);
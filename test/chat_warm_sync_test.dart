@@ -0,0 +1,203 @@
+// Test warm sync multi-chat terhadap backend PostgREST lokal.
+//
+// Stand-in menahan setiap GET /rest/v1/messages beberapa milidetik dan mencatat jumlah
+// request yang berjalan bersamaan; coordinator tidak boleh melewati batas parallelism,
+// semua chat harus masuk cache, dan isi halaman harus sama dengan pesan aslinya.
+// Halaman yang disimpan ke pageDirectory harus bisa di-restore tanpa jaringan.
+//
+// Butuh native_libs/chat_cache.cpp di libargon2, lihat test/support/loopback_stand_in.dart.
+import 'dart:convert';
+import 'dart:io';
+
+import 'package:flutter_test/flutter_test.dart';
+import 'package:secret_app/services/chat_page_cache_ffi.dart';
+import 'package:secret_app/services/chat_warm_sync.dart';
+import 'package:secret_app/services/encryption_service.dart';
+
+import 'support/loopback_stand_in.dart';
+
+const int _chatCount = 12;
+const int _messagesPerChat = 30;
+
+/// Tabel messages minimal: filter chat_id=eq., order created_at.desc, limit.
+class _PostgrestStandIn extends LoopbackStandIn {
+  final Map<String, List<Map<String, dynamic>>> rows;
+  final Duration delay;
+  int inFlight = 0;
+  int maxInFlight = 0;
+  int requests = 0;
+
+  _PostgrestStandIn._(this.rows, this.delay);
+
+  static Future<_PostgrestStandIn> start(
+      Map<String, List<Map<String, dynamic>>> rows, Duration delay) async {
+    final server = _PostgrestStandIn._(rows, delay);
+    await server.bind();
+    return server;
+  }
+
+  Uri get endpoint => resolve('/rest/v1/');
+
+  @override
+  Future<void> handle(HttpRequest request) async {
+    requests++;
+    inFlight++;
+    if (inFlight > maxInFlight) maxInFlight = inFlight;
+    await Future.delayed(delay);
+
+    final response = request.response;
+    final query = request.uri.queryParameters;
+    final chatId = (query['chat_id'] ?? '').replaceFirst('eq.', '');
+    final limit = int.tryParse(query['limit'] ?? '') ?? 1000;
+    final table = rows[chatId];
+
+    if (request.uri.pathSegments.last != 'messages' || table == null) {
+      response.statusCode = HttpStatus.notFound;
+    } else {
+      final page = table.reversed.take(limit).toList();
+      response.headers.contentType = ContentType.json;
+      response.write(jsonEncode(page));
+    }
+    inFlight--;
+    await response.close();
+  }
+}
+
+void main() {
+  final cache = ChatPageCacheFFI();
+  final skip = nativeSkip(cache.isAvailable, 'chat cache');
+
+  test('warms every chat with bounded parallelism', () async {
+    final encryptionService = EncryptionService();
+    final chats = <WarmChat>[];
+    final rows = <String, List<Map<String, dynamic>>>{};
+    final plaintexts = <String, List<String>>{};
+
+    for (int c = 0; c < _chatCount; c++) {
+      final chatId = 'warm_chat_$c';
+      final key = EncryptionService.generateChatKey('10000$c', '2000$c');
+      chats.add(WarmChat(chatId, key));
+      rows[chatId] = [];
+      plaintexts[chatId] = [];
+      for (int m = 0; m < _messagesPerChat; m++) {
+        final text = 'chat $c message $m 🔥';
+        final encrypted = await encryptionService.encryptMessage(text, key);
+        rows[chatId]!.add({
+          'id': '$chatId-$m',
+          'sender_id': m.isEven ? 'me' : 'other',
+          'encrypted_message': encrypted['encrypted_message'],
+          'iv': encrypted['iv'],
+          'created_at': DateTime.utc(2024, 1, 1, 0, m).toIso8601String(),
+        });
+        plaintexts[chatId]!.add(text);
+      }
+    }
+
+    final server = await _PostgrestStandIn.start(rows, const Duration(milliseconds: 40));
+    final source = PostgrestChatPageSource(server.endpoint);
+
+    try {
+      cache.clear();
+      final result = await ChatWarmSync(source, parallelism: 4, pageSize: 20).warm(chats);
+
+      expect(result.warmed, _chatCount);
+      expect(result.failed, 0);
+      expect(result.messages, _chatCount * 20);
+      expect(server.requests, _chatCount);
+      expect(server.maxInFlight, greaterThan(1));
+      expect(server.maxInFlight, lessThanOrEqualTo(4));
+
+      for (final chat in chats) {
+        final page = cache.page(chat.chatId)!;
+        // 20 pesan terbaru, urut naik seperti ChatScreen
+        expect(page.map((m) => m['message']), plaintexts[chat.chatId]!.sublist(_messagesPerChat - 20));
+        expect(page.first['id'], '${chat.chatId}-${_messagesPerChat - 20}');
+      }
+      expect(cache.stats()['decrypt_failures'], 0);
+    } finally {
+      cache.clear();
+      source.close();
+      await server.close();
+    }
+  }, skip: skip);
+
+  test('a failing chat does not stop the others', () async {
+    final key = EncryptionService.generateChatKey('111111', '222222');
+    final encrypted = await EncryptionService().encryptMessage('hello', key);
+    final rows = {
+      'ok_chat': [
+        {
+          'id': 'm1',
+          'sender_id': 'me',
+          'encrypted_message': encrypted['encrypted_message'],
+          'iv': encrypted['iv'],
+          'created_at': '2024-01-01T00:00:00Z',
+        }
+      ],
+    };
+    final server = await _PostgrestStandIn.start(rows, Duration.zero);
+    final source = PostgrestChatPageSource(server.endpoint);
+
+    try {
+      cache.clear();
+      final result = await ChatWarmSync(source, parallelism: 2)
+          .warm([WarmChat('missing_chat', key), WarmChat('ok_chat', key)]);
+
+      expect(result.warmed, 1);
+      expect(result.failed, 1);
+      expect(cache.page('missing_chat'), isNull);
+      expect(cache.page('ok_chat')!.single['message'], 'hello');
+    } finally {
+      cache.clear();
+      source.close();
+      await server.close();
+    }
+  }, skip: skip);
+
+  test('pages survive a restart through encrypted files', () async {
+    final key = EncryptionService.generateChatKey('333333', '444444');
+    final encrypted = await EncryptionService().encryptMessage('rahasia di disk', key);
+    final rows = {
+      'disk_chat': [
+        {
+          'id': 'm1',
+          'sender_id': 'me',
+          'encrypted_message': encrypted['encrypted_message'],
+          'iv': encrypted['iv'],
+          'created_at': '2024-01-01T00:00:00Z',
+        }
+      ],
+    };
+    final server = await _PostgrestStandIn.start(rows, Duration.zero);
+    final source = PostgrestChatPageSource(server.endpoint);
+    final dir = await Directory.systemTemp.createTemp('chat_pages_test');
+
+    try {
+      cache.clear();
+      final chats = [WarmChat('disk_chat', key)];
+      await ChatWarmSync(source, pageDirectory: dir.path).warm(chats);
+      final files = dir.listSync().whereType<File>().toList();
+      expect(files, hasLength(1));
+      expect(utf8.decode(files.single.readAsBytesSync(), allowMalformed: true), isNot(contains('rahasia')));
+
+      // "Restart": cache kosong, tanpa request ke server
+      cache.clear();
+      final requests = server.requests;
+      final restored = await ChatWarmSync(source, pageDirectory: dir.path).restore(chats);
+      expect(restored, 1);
+      expect(server.requests, requests);
+      expect(cache.page('disk_chat')!.single['message'], 'rahasia di disk');
+
+      // Key lain (PIN berbeda) tidak bisa membaca file yang sama
+      cache.clear();
+      final otherKey = EncryptionService.generateChatKey('333333', '555555');
+      expect(await ChatWarmSync(source, pageDirectory: dir.path).restore([WarmChat('disk_chat', otherKey)]), 0);
+      expect(cache.page('disk_chat'), isNull);
+    } finally {
+      cache.clear();
+      source.close();
+      await server.close();
+      await dir.delete(recursive: true);
+    }
+  }, skip: skip);
+}
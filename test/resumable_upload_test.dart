@@ -0,0 +1,229 @@
+// Test encrypt-sambil-upload terhadap server tus lokal.
+//
+// Server stand-in memutus koneksi di tengah PATCH; upload harus lanjut dari offset
+// yang dilaporkan HEAD, hanya mengirim byte yang belum diterima, dan tag HMAC harus
+// sama dengan format FileEncryptionService.decryptFile.
+//
+// Butuh native_libs/upload_pipeline.cpp di libargon2, lihat test/support/loopback_stand_in.dart.
+import 'dart:convert';
+import 'dart:io';
+import 'dart:math';
+import 'dart:typed_data';
+
+import 'package:crypto/crypto.dart';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:secret_app/services/file_encryption_service.dart';
+import 'package:secret_app/services/resumable_upload_service.dart';
+import 'package:secret_app/services/upload_pipeline_ffi.dart';
+
+import 'support/loopback_stand_in.dart';
+
+const String _key = 'resumable_upload_test_key';
+const String _chatId = 'resumable_chat';
+const int _segmentSize = 64 * 1024;
+
+/// Server tus minimal: satu sesi per POST, HEAD/PATCH dengan Upload-Offset.
+class _TusStandIn extends LoopbackStandIn {
+  final Map<String, BytesBuilder> uploads = {};
+  final Map<String, int> lengths = {};
+  final List<int> patchOffsets = [];
+  int bodyBytesReceived = 0;
+
+  /// PATCH ke-n (1-based) yang koneksinya diputus setelah setengah body disimpan.
+  final int dropOnPatch;
+  int _patches = 0;
+
+  _TusStandIn._(this.dropOnPatch);
+
+  static Future<_TusStandIn> start({int dropOnPatch = 0}) async {
+    final server = _TusStandIn._(dropOnPatch);
+    await server.bind();
+    return server;
+  }
+
+  Uri get endpoint => resolve('/files/');
+
+  @override
+  Future<void> handle(HttpRequest request) async {
+    final response = request.response;
+    response.headers.set('Tus-Resumable', '1.0.0');
+
+    if (request.method == 'POST') {
+      final id = '${uploads.length + 1}';
+      uploads[id] = BytesBuilder();
+      lengths[id] = int.parse(request.headers.value('upload-length')!);
+      await request.drain<void>();
+      response.statusCode = HttpStatus.created;
+      response.headers.set(HttpHeaders.locationHeader, '/files/$id');
+      await response.close();
+      return;
+    }
+
+    final id = request.uri.pathSegments.last;
+    final stored = uploads[id];
+    if (stored == null) {
+      await request.drain<void>();
+      response.statusCode = HttpStatus.notFound;
+      await response.close();
+      return;
+    }
+
+    if (request.method == 'HEAD') {
+      response.headers.set('Upload-Offset', '${stored.length}');
+      response.headers.set('Upload-Length', '${lengths[id]}');
+      await response.close();
+      return;
+    }
+
+    final offset = int.parse(request.headers.value('upload-offset')!);
+    patchOffsets.add(offset);
+    final body = BytesBuilder();
+    await for (final chunk in request) {
+      body.add(chunk);
+    }
+    bodyBytesReceived += body.length;
+
+    if (offset != stored.length) {
+      response.statusCode = HttpStatus.conflict;
+      await response.close();
+      return;
+    }
+
+    final data = body.takeBytes();
+    if (++_patches == dropOnPatch) {
+      // Simulasi koneksi putus: sebagian body sudah tersimpan, client tidak dapat respons
+      stored.add(data.sublist(0, data.length ~/ 2));
+      final socket = await response.detachSocket(writeHeaders: false);
+      socket.destroy();
+      return;
+    }
+
+    stored.add(data);
+    response.statusCode = HttpStatus.noContent;
+    response.headers.set('Upload-Offset', '${stored.length}');
+    await response.close();
+  }
+}
+
+Future<File> _writeRandomFile(Directory dir, int length) async {
+  final random = Random(42);
+  final data = Uint8List.fromList(List.generate(length, (_) => random.nextInt(256)));
+  final file = File('${dir.path}/plain.bin');
+  await file.writeAsBytes(data);
+  return file;
+}
+
+void main() {
+  final skip = nativeSkip(UploadPipelineFFI().isAvailable, 'upload pipeline');
+
+  late Directory tempDir;
+
+  setUp(() async {
+    tempDir = await Directory.systemTemp.createTemp('resumable_upload_test');
+  });
+
+  tearDown(() async {
+    await tempDir.delete(recursive: true);
+  });
+
+  test('resumes after a dropped PATCH and re-sends only missing bytes', () async {
+    final server = await _TusStandIn.start(dropOnPatch: 3);
+    final transport = TusHttpTransport(server.endpoint);
+    // Panjang tidak sejajar segmen/blok supaya resume terjadi di tengah blok ChaCha20
+    final file = await _writeRandomFile(tempDir, 5 * _segmentSize + 1234);
+    final plain = await file.readAsBytes();
+
+    try {
+      final result = await FileEncryptionService().encryptAndUploadFile(
+        file: file,
+        encryptionKey: _key,
+        chatId: _chatId,
+        fileName: 'plain.bin',
+        transport: transport,
+        segmentSize: _segmentSize,
+      );
+
+      expect(result, isNotNull);
+      final uploaded = server.uploads.values.single.toBytes();
+      expect(uploaded.length, plain.length);
+
+      // Segmen ke-3 terputus setelah setengah tersimpan: PATCH berikutnya mulai dari sana
+      final half = _segmentSize ~/ 2;
+      expect(server.patchOffsets.take(4), [0, _segmentSize, 2 * _segmentSize, 2 * _segmentSize + half]);
+      expect(server.bodyBytesReceived, plain.length + (_segmentSize - half));
+
+      final decrypted = await FileEncryptionService().decryptFile(
+        encryptedData: uploaded,
+        nonce: result!.nonce,
+        authTag: result.authTag,
+        encryptionKey: _key,
+        chatId: _chatId,
+      );
+      expect(decrypted, plain);
+    } finally {
+      transport.close();
+      await server.close();
+    }
+  }, skip: skip);
+
+  test('continues an upload session from a previous run', () async {
+    final server = await _TusStandIn.start(dropOnPatch: 2);
+    final transport = TusHttpTransport(server.endpoint);
+    final file = await _writeRandomFile(tempDir, 3 * _segmentSize + 77);
+    final plain = await file.readAsBytes();
+    // Derivasi sama dengan FileEncryptionService._deriveKeysStandard
+    final material = sha512.convert(utf8.encode('$_key::$_chatId::file_encryption_2024')).bytes;
+    final keys = {
+      'chacha_key': Uint8List.fromList(material.sublist(0, 32)),
+      'hmac_key': Uint8List.fromList(material.sublist(32, 64)),
+    };
+    final nonce = Uint8List.fromList(List.generate(12, (i) => i * 7));
+
+    try {
+      // Run pertama berhenti total (maxRetries 0) setelah koneksi putus
+      final first = UploadPipelineFFI().open(
+        file: file,
+        chachaKey: keys['chacha_key']!,
+        nonce: nonce,
+        hmacKey: keys['hmac_key']!,
+        segmentSize: _segmentSize,
+      );
+      await expectLater(
+        ResumableUploader(transport, maxRetries: 0).upload(first),
+        throwsA(isA<IOException>()),
+      );
+      first.close();
+
+      final uploadUrl = server.endpoint.resolve('/files/1');
+      final resumeOffset = await transport.queryOffset(uploadUrl);
+      expect(resumeOffset, _segmentSize + _segmentSize ~/ 2);
+
+      // Run kedua (misalnya setelah app restart) melanjutkan sesi yang sama
+      final second = UploadPipelineFFI().open(
+        file: file,
+        chachaKey: keys['chacha_key']!,
+        nonce: nonce,
+        hmacKey: keys['hmac_key']!,
+        segmentSize: _segmentSize,
+        resumeOffset: resumeOffset,
+      );
+      final result = await ResumableUploader(transport).upload(second, resumeUrl: uploadUrl);
+      second.close();
+
+      expect(server.patchOffsets.first, 0);
+      expect(server.patchOffsets.skip(2).first, resumeOffset);
+
+      final decrypted = await FileEncryptionService().decryptFile(
+        encryptedData: server.uploads['1']!.toBytes(),
+        nonce: nonce,
+        authTag: result.authTag,
+        encryptionKey: _key,
+        chatId: _chatId,
+      );
+      expect(decrypted, plain);
+    } finally {
+      transport.close();
+      await server.close();
+    }
+  }, skip: skip);
+}
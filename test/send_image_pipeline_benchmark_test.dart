@@ -0,0 +1,264 @@
+// Benchmark end-to-end alur "kirim gambar rahasia":
+//   pick → compressImage → steganography encode → encryptFile → uploadEncryptedFile
+//
+// Setiap stage memakai service yang sama dengan aplikasi; upload dikirim ke
+// HttpServer lokal yang meniru endpoint Supabase Storage (POST /storage/v1/object/<bucket>/<path>)
+// sehingga benchmark tidak butuh jaringan maupun project Supabase.
+//
+// Jalankan dengan:
+//   flutter test test/send_image_pipeline_benchmark_test.dart
+//   PIPELINE_SAMPLE_IMAGES=path/ke/folder PIPELINE_BENCH_RUNS=5 flutter test ...
+@Tags(['benchmark'])
+library;
+
+import 'dart:convert';
+import 'dart:io';
+import 'dart:math';
+import 'dart:typed_data';
+
+import 'package:flutter/foundation.dart';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:image/image.dart' as img;
+import 'package:secret_app/services/file_encryption_service.dart';
+import 'package:secret_app/services/steganography_service.dart';
+import 'package:secret_app/services/supabase_service.dart';
+
+import 'support/loopback_stand_in.dart';
+
+const List<String> _stages = ['pick', 'compress', 'stego', 'encrypt', 'upload'];
+
+class _StageSample {
+  final Duration elapsed;
+  final int bytesIn;
+  final int bytesOut;
+  final int rssAfter;
+
+  _StageSample(this.elapsed, this.bytesIn, this.bytesOut, this.rssAfter);
+}
+
+class _PipelineRun {
+  final Map<String, _StageSample> stages = {};
+
+  Duration get total => stages.values.fold(Duration.zero, (sum, s) => sum + s.elapsed);
+}
+
+/// Stand-in lokal untuk Supabase Storage: menerima upload biner dan hanya menghitung byte.
+class _LocalStorageServer extends LoopbackStandIn {
+  int bytesReceived = 0;
+  int uploads = 0;
+
+  Uri get baseUri => resolve('/');
+
+  @override
+  Future<void> handle(HttpRequest request) async {
+    final segments = request.uri.pathSegments;
+    if (request.method != 'POST' || segments.length < 4 || segments[0] != 'storage' || segments[2] != 'object') {
+      request.response.statusCode = HttpStatus.notFound;
+      await request.response.close();
+      return;
+    }
+    int received = 0;
+    await for (final chunk in request) {
+      received += chunk.length;
+    }
+    bytesReceived += received;
+    uploads++;
+    request.response.headers.contentType = ContentType.json;
+    request.response.write(jsonEncode({'Key': segments.sublist(3).join('/')}));
+    await request.response.close();
+  }
+}
+
+/// Upload dengan bentuk request yang sama seperti storage.from(bucket).uploadBinary().
+Future<String> _uploadToStandIn(HttpClient client, Uri baseUri, Uint8List data, String fileName) async {
+  final filePath = '${DateTime.now().millisecondsSinceEpoch}_$fileName';
+  final request = await client.postUrl(baseUri.resolve('/storage/v1/object/encrypted_files/$filePath'));
+  request.headers.set(HttpHeaders.authorizationHeader, 'Bearer benchmark-anon-key');
+  request.headers.set(HttpHeaders.contentTypeHeader, 'application/octet-stream');
+  request.headers.set('x-upsert', 'false');
+  request.contentLength = data.length;
+  request.add(data);
+  final response = await request.close();
+  await response.drain<void>();
+  if (response.statusCode != HttpStatus.ok) {
+    throw HttpException('Upload failed: ${response.statusCode}');
+  }
+  return filePath;
+}
+
+/// Gambar sintetis: gradien + noise agar kompresi JPEG tidak terlalu optimistis.
+Uint8List _syntheticPhoto(int width, int height, int seed) {
+  final random = Random(seed);
+  final image = img.Image(width: width, height: height);
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      final noise = random.nextInt(24);
+      image.setPixelRgb(
+        x,
+        y,
+        (x * 255 ~/ width + noise) & 0xFF,
+        (y * 255 ~/ height + noise) & 0xFF,
+        ((x + y) * 127 ~/ (width + height) + noise) & 0xFF,
+      );
+    }
+  }
+  return Uint8List.fromList(img.encodeJpg(image, quality: 95));
+}
+
+Future<_PipelineRun> _runPipeline({
+  required File source,
+  required Directory workDir,
+  required HttpClient client,
+  required Uri storageUri,
+  required int runIndex,
+}) async {
+  final run = _PipelineRun();
+  final stopwatch = Stopwatch();
+
+  void record(String stage, int bytesIn, int bytesOut) {
+    stopwatch.stop();
+    run.stages[stage] = _StageSample(stopwatch.elapsed, bytesIn, bytesOut, ProcessInfo.currentRss);
+    stopwatch.reset();
+  }
+
+  // pick: FilePicker dengan withData: true membaca seluruh file ke memory
+  stopwatch.start();
+  final picked = await source.readAsBytes();
+  record('pick', picked.length, picked.length);
+
+  stopwatch.start();
+  final compressed = (await SupabaseService().compressImage(picked)).data;
+  record('compress', picked.length, compressed.length);
+
+  stopwatch.start();
+  final stego = await SteganographyService().encodeMessage(
+    imageData: compressed,
+    message: 'Pesan rahasia benchmark #$runIndex',
+    password: 'benchmark-password',
+  );
+  expect(stego.success, isTrue, reason: stego.errorMessage);
+  record('stego', compressed.length, stego.data.length);
+
+  // encryptFile membaca dari File, jadi hasil stego ditulis ke temp file seperti di aplikasi
+  stopwatch.start();
+  final stegoFile = File('${workDir.path}/stego_$runIndex.jpg');
+  await stegoFile.writeAsBytes(stego.data, flush: true);
+  final encrypted = await FileEncryptionService().encryptFile(
+    file: stegoFile,
+    encryptionKey: 'benchmark-chat-key-0123456789abcdef',
+    chatId: 'benchmark-chat',
+    fileName: 'stego_$runIndex.jpg',
+  );
+  record('encrypt', stego.data.length, encrypted.encryptedData.length);
+
+  stopwatch.start();
+  await _uploadToStandIn(client, storageUri, encrypted.encryptedData, 'stego_$runIndex.jpg.enc');
+  record('upload', encrypted.encryptedData.length, encrypted.encryptedData.length);
+
+  return run;
+}
+
+Duration _median(List<Duration> values) {
+  final sorted = [...values]..sort();
+  return sorted[sorted.length ~/ 2];
+}
+
+String _ms(Duration d) => (d.inMicroseconds / 1000).toStringAsFixed(1).padLeft(9);
+
+String _mb(int bytes) => (bytes / (1024 * 1024)).toStringAsFixed(2);
+
+void _printReport(String label, List<_PipelineRun> runs, int peakRss) {
+  // ignore: avoid_print
+  void out(String line) => print(line);
+
+  out('📊 Pipeline "$label" (${runs.length} runs, median)');
+  out('   stage        latency ms    bytes in   bytes out   RSS after MB');
+  for (final stage in _stages) {
+    final samples = runs.map((r) => r.stages[stage]!).toList();
+    final latency = _median(samples.map((s) => s.elapsed).toList());
+    final last = samples.last;
+    out('   ${stage.padRight(10)} ${_ms(latency)}  ${last.bytesIn.toString().padLeft(10)}  '
+        '${last.bytesOut.toString().padLeft(10)}  ${_mb(last.rssAfter).padLeft(12)}');
+  }
+  final totals = runs.map((r) => r.total).toList();
+  out('   total      ${_ms(_median(totals))}   (min ${_ms(totals.reduce((a, b) => a < b ? a : b)).trim()} ms, '
+      'max ${_ms(totals.reduce((a, b) => a > b ? a : b)).trim()} ms)');
+  out('   peak RSS   ${_mb(peakRss)} MB');
+}
+
+void main() {
+  final runs = int.tryParse(Platform.environment['PIPELINE_BENCH_RUNS'] ?? '') ?? 3;
+  final sampleDir = Platform.environment['PIPELINE_SAMPLE_IMAGES'];
+
+  late Directory workDir;
+  late _LocalStorageServer storage;
+  late HttpClient client;
+  late DebugPrintCallback originalDebugPrint;
+
+  setUpAll(() async {
+    workDir = await Directory.systemTemp.createTemp('send_image_bench');
+    storage = _LocalStorageServer();
+    await storage.bind();
+    client = HttpClient();
+    // Service mencetak banyak log debug; matikan agar tidak ikut terukur
+    originalDebugPrint = debugPrint;
+    debugPrint = (String? message, {int? wrapWidth}) {};
+  });
+
+  tearDownAll(() async {
+    debugPrint = originalDebugPrint;
+    client.close(force: true);
+    await storage.close();
+    await workDir.delete(recursive: true);
+  });
+
+  Future<void> benchmark(String label, File source) async {
+    // Satu run pemanasan agar JIT dan cache file sistem tidak ikut dihitung
+    await _runPipeline(source: source, workDir: workDir, client: client, storageUri: storage.baseUri, runIndex: -1);
+
+    final results = <_PipelineRun>[];
+    for (int i = 0; i < runs; i++) {
+      results.add(await _runPipeline(
+        source: source,
+        workDir: workDir,
+        client: client,
+        storageUri: storage.baseUri,
+        runIndex: i,
+      ));
+    }
+    _printReport(label, results, ProcessInfo.maxRss);
+
+    final uploaded = results.last.stages['upload']!.bytesOut;
+    expect(uploaded, greaterThan(0));
+  }
+
+  group('send secret image pipeline', () {
+    const sizes = {
+      'synthetic 640x480': [640, 480],
+      'synthetic 1920x1080': [1920, 1080],
+      'synthetic 4000x3000': [4000, 3000],
+    };
+
+    for (final entry in sizes.entries) {
+      test(entry.key, () async {
+        final source = File('${workDir.path}/${entry.value[0]}x${entry.value[1]}.jpg');
+        await source.writeAsBytes(_syntheticPhoto(entry.value[0], entry.value[1], entry.value[0]));
+        await benchmark(entry.key, source);
+      }, timeout: const Timeout(Duration(minutes: 10)));
+    }
+
+    test('sample images', () async {
+      final images = Directory(sampleDir!)
+          .listSync()
+          .whereType<File>()
+          .where((f) => RegExp(r'\.(jpe?g|png)$', caseSensitive: false).hasMatch(f.path))
+          .toList()
+        ..sort((a, b) => a.path.compareTo(b.path));
+      for (final image in images) {
+        await benchmark(image.uri.pathSegments.last, image);
+      }
+    },
+        skip: sampleDir == null ? 'Set PIPELINE_SAMPLE_IMAGES to benchmark real photos' : false,
+        timeout: const Timeout(Duration(minutes: 30)));
+  });
+}
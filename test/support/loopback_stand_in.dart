@@ -0,0 +1,27 @@
+// Stand-in HTTP lokal untuk test yang meniru backend (tus, PostgREST, Supabase Storage),
+// sehingga test tidak butuh jaringan maupun project Supabase.
+//
+// Test yang memakai modul native dijalankan dengan libargon2 (build native_libs) di library path:
+//   LD_LIBRARY_PATH=build flutter test test/<nama>_test.dart
+// dan di-skip lewat [nativeSkip] jika modulnya tidak ditemukan.
+import 'dart:io';
+
+/// HttpServer di 127.0.0.1 dengan port acak; subclass cukup mengimplementasikan [handle].
+abstract class LoopbackStandIn {
+  late final HttpServer _server;
+
+  Future<void> bind() async {
+    _server = await HttpServer.bind(InternetAddress.loopbackIPv4, 0);
+    _server.listen(handle);
+  }
+
+  /// Uri absolut ke [path] di server ini, mis. resolve('/files/').
+  Uri resolve(String path) => Uri.parse('http://${_server.address.host}:${_server.port}').resolve(path);
+
+  Future<void> handle(HttpRequest request);
+
+  Future<void> close() => _server.close(force: true);
+}
+
+/// Nilai `skip:` untuk test yang butuh modul native [module] dari libargon2.
+Object nativeSkip(bool available, String module) => available ? false : 'native $module not found';